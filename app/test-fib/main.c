@@ -44,6 +44,7 @@
 #define FIB_TYPE_MASK		(FIB_RIB_TYPE|FIB_V4_DIR_TYPE|FIB_V6_TRIE_TYPE)
 #define SHUFFLE_FLAG		(1 << 7)
 #define DRY_RUN_FLAG		(1 << 8)
+#define TXN_FLAG		(1 << 9)
 
 static char *distrib_string;
 static char line[LINE_MAX];
@@ -627,6 +628,8 @@ print_usage(void)
 		"[-c <do comparison with LPM library>]\n"
 		"[-6 <do tests with ipv6 (default ipv4)>]\n"
 		"[-s <shuffle randomly generated routes>]\n"
+		"[-x <use transactions for FIB route updates"
+		"(not valid with rib fib type)>]\n"
 		"[-a <check nexthops for all ipv4 address space"
 		"(only valid with -c)>]\n"
 		"[-b <fib algorithm>]\n\tavailable options for ipv4\n"
@@ -642,9 +645,9 @@ print_usage(void)
 		"[-w <path to the file to dump routing table>]\n"
 		"[-u <path to the file to dump ip's for lookup>]\n"
 		"[-v <type of lookup function:"
-		"\ts1, s2, s3 (3 types of scalar), v (vector) -"
-		" for DIR24_8 based FIB\n"
-		"\ts, v - for TRIE based ipv6 FIB>]\n",
+		"\ts1, s2, s3 (3 types of scalar), v (AVX512 vector),"
+		" v2 (AVX2 vector), n (NEON vector) - for DIR24_8 based FIB\n"
+		"\ts, v, v2 - for TRIE based ipv6 FIB>]\n",
 		config.prgname);
 }
 
@@ -678,6 +681,12 @@ check_config(void)
 		printf("-e 1 is valid only for ipv4\n");
 		return -1;
 	}
+
+	if ((config.flags & TXN_FLAG) &&
+			((config.flags & FIB_TYPE_MASK) == FIB_RIB_TYPE)) {
+		printf("-x flag is not valid for rib fib type\n");
+		return -1;
+	}
 	return 0;
 }
 
@@ -687,7 +696,7 @@ parse_opts(int argc, char **argv)
 	int opt;
 	char *endptr;
 
-	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:")) !=
+	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sxv:")) !=
 			-1) {
 		switch (opt) {
 		case 'f':
@@ -741,6 +750,9 @@ parse_opts(int argc, char **argv)
 		case 's':
 			config.flags |= SHUFFLE_FLAG;
 			break;
+		case 'x':
+			config.flags |= TXN_FLAG;
+			break;
 		case 'c':
 			config.flags |= CMP_FLAG;
 			break;
@@ -793,6 +805,12 @@ parse_opts(int argc, char **argv)
 			} else if (strcmp(optarg, "s3") == 0) {
 				config.lookup_fn = 4;
 				break;
+			} else if (strcmp(optarg, "v2") == 0) {
+				config.lookup_fn = 5;
+				break;
+			} else if (strcmp(optarg, "n") == 0) {
+				config.lookup_fn = 6;
+				break;
 			}
 			print_usage();
 			rte_exit(-EINVAL, "Invalid option -v %s\n", optarg);
@@ -887,6 +905,12 @@ run_v4(void)
 		else if (config.lookup_fn == 4)
 			ret = rte_fib_select_lookup(fib,
 				RTE_FIB_LOOKUP_DIR24_8_SCALAR_UNI);
+		else if (config.lookup_fn == 5)
+			ret = rte_fib_select_lookup(fib,
+				RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX2);
+		else if (config.lookup_fn == 6)
+			ret = rte_fib_select_lookup(fib,
+				RTE_FIB_LOOKUP_DIR24_8_VECTOR_NEON);
 		else
 			ret = -EINVAL;
 		if (ret != 0) {
@@ -897,6 +921,8 @@ run_v4(void)
 
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
+		if (config.flags & TXN_FLAG)
+			rte_fib_txn_begin(fib);
 		for (j = 0; j < (config.nb_routes - i) / k; j++) {
 			ret = rte_fib_add(fib, rt[i + j].addr, rt[i + j].depth,
 				rt[i + j].nh);
@@ -906,6 +932,14 @@ run_v4(void)
 				return -ret;
 			}
 		}
+		if (config.flags & TXN_FLAG) {
+			ret = rte_fib_txn_commit(fib);
+			if (unlikely(ret != 0)) {
+				printf("Can not commit FIB routes, err %d\n",
+					ret);
+				return -ret;
+			}
+		}
 		printf("AVG FIB add %"PRIu64"\n",
 			(rte_rdtsc_precise() - start) / j);
 		i += j;
@@ -985,9 +1019,13 @@ run_v4(void)
 
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
+		if (config.flags & TXN_FLAG)
+			rte_fib_txn_begin(fib);
 		for (j = 0; j < (config.nb_routes - i) / k; j++)
 			rte_fib_delete(fib, rt[i + j].addr, rt[i + j].depth);
 
+		if (config.flags & TXN_FLAG)
+			rte_fib_txn_commit(fib);
 		printf("AVG FIB delete %"PRIu64"\n",
 			(rte_rdtsc_precise() - start) / j);
 		i += j;
@@ -1082,6 +1120,9 @@ run_v6(void)
 		else if (config.lookup_fn == 2)
 			ret = rte_fib6_select_lookup(fib,
 				RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512);
+		else if (config.lookup_fn == 5)
+			ret = rte_fib6_select_lookup(fib,
+				RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX2);
 		else
 			ret = -EINVAL;
 		if (ret != 0) {
@@ -1092,6 +1133,8 @@ run_v6(void)
 
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
+		if (config.flags & TXN_FLAG)
+			rte_fib6_txn_begin(fib);
 		for (j = 0; j < (config.nb_routes - i) / k; j++) {
 			ret = rte_fib6_add(fib, rt[i + j].addr,
 				rt[i + j].depth, rt[i + j].nh);
@@ -1101,6 +1144,14 @@ run_v6(void)
 				return -ret;
 			}
 		}
+		if (config.flags & TXN_FLAG) {
+			ret = rte_fib6_txn_commit(fib);
+			if (unlikely(ret != 0)) {
+				printf("Can not commit FIB routes, err %d\n",
+					ret);
+				return -ret;
+			}
+		}
 		printf("AVG FIB add %"PRIu64"\n",
 			(rte_rdtsc_precise() - start) / j);
 		i += j;
@@ -1184,9 +1235,13 @@ run_v6(void)
 
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
+		if (config.flags & TXN_FLAG)
+			rte_fib6_txn_begin(fib);
 		for (j = 0; j < (config.nb_routes - i) / k; j++)
 			rte_fib6_delete(fib, rt[i + j].addr, rt[i + j].depth);
 
+		if (config.flags & TXN_FLAG)
+			rte_fib6_txn_commit(fib);
 		printf("AVG FIB delete %"PRIu64"\n",
 			(rte_rdtsc_precise() - start) / j);
 		i += j;
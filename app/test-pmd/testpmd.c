@@ -1712,7 +1712,8 @@ init_config(void)
 
 #ifdef RTE_LIB_GSO
 	gso_types = RTE_ETH_TX_OFFLOAD_TCP_TSO | RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO |
-		RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO | RTE_ETH_TX_OFFLOAD_UDP_TSO;
+		RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO | RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO |
+		RTE_ETH_TX_OFFLOAD_UDP_TSO;
 #endif
 	/*
 	 * Records which Mbuf pool to use by each logical core, if needed.
@@ -1739,7 +1740,7 @@ init_config(void)
 
 #ifdef RTE_LIB_GRO
 	/* create a gro context for each lcore */
-	gro_param.gro_types = RTE_GRO_TCP_IPV4;
+	gro_param.gro_types = RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6;
 	gro_param.max_flow_num = GRO_MAX_FLUSH_CYCLES;
 	gro_param.max_item_per_flow = MAX_PKT_BURST;
 	for (lc_id = 0; lc_id < nb_lcores; lc_id++) {
@@ -28,6 +28,7 @@ test_distributor(void)
 #define ITER_POWER 20 /* log 2 of how many iterations we do when timing. */
 #define BURST 32
 #define BIG_BATCH 1024
+#define WORKER_BURST 8 /* packets given to a worker at once */
 
 typedef uint32_t seq_dynfield_t;
 static int seq_dynfield_offset = -1;
@@ -728,6 +729,143 @@ sanity_mark_test(struct worker_params *wp, struct rte_mempool *p)
 	return 0;
 }
 
+static volatile int zero_release; /**< thr0 may go on after stalling */
+
+/* worker function for the work stealing test. Worker 0 stalls with its
+ * first packets until released, all other workers behave as handle_work.
+ */
+static int
+handle_work_with_stall(void *arg)
+{
+	struct rte_mbuf *buf[8] __rte_cache_aligned;
+	struct worker_params *wp = arg;
+	struct rte_distributor *db = wp->dist;
+	unsigned int num;
+	unsigned int id = __atomic_fetch_add(&worker_idx, 1, __ATOMIC_RELAXED);
+
+	num = rte_distributor_get_pkt(db, id, buf, NULL, 0);
+	if (id == 0) {
+		__atomic_store_n(&zero_sleep, 1, __ATOMIC_RELEASE);
+		while (!__atomic_load_n(&zero_release, __ATOMIC_ACQUIRE))
+			rte_pause();
+		__atomic_store_n(&zero_sleep, 0, __ATOMIC_RELEASE);
+	}
+	while (!quit) {
+		__atomic_fetch_add(&worker_stats[id].handled_packets, num,
+				__ATOMIC_RELAXED);
+		num = rte_distributor_get_pkt(db, id,
+				buf, buf, num);
+	}
+	__atomic_fetch_add(&worker_stats[id].handled_packets, num,
+			__ATOMIC_RELAXED);
+	rte_distributor_return_pkt(db, id, buf, num);
+	return 0;
+}
+
+/* Test that with work stealing enabled, the packets queued for a stalled
+ * worker are handled by the other workers, and that the distributor does
+ * not wait for the stalled worker.
+ */
+static int
+sanity_test_with_work_stealing(struct worker_params *wp,
+		struct rte_mempool *p)
+{
+	struct rte_distributor *d = wp->dist;
+	struct rte_mbuf *bufs[BIG_BATCH];
+	struct rte_mbuf *returns[BIG_BATCH];
+	unsigned int i, count = 0, processed;
+	unsigned int retries;
+
+	printf("=== Work stealing test (%s) ===\n", wp->name);
+	clear_packet_count();
+
+	if (rte_distributor_work_stealing_set(d, 1) != 0) {
+		printf("line %d: Error enabling work stealing\n", __LINE__);
+		return -1;
+	}
+
+	if (rte_mempool_get_bulk(p, (void *)bufs, BIG_BATCH) != 0) {
+		printf("line %d: Error getting mbufs from pool\n", __LINE__);
+		return -1;
+	}
+	for (i = 0; i < BIG_BATCH; i++)
+		bufs[i]->hash.usr = i << 1;
+
+	/* Send packets until worker 0 got some and stalls with them */
+	processed = 0;
+	while (!__atomic_load_n(&zero_sleep, __ATOMIC_ACQUIRE)) {
+		if (processed < BIG_BATCH)
+			processed += rte_distributor_process(d,
+					&bufs[processed], 1);
+		else
+			rte_distributor_process(d, NULL, 0);
+		count += rte_distributor_returned_pkts(d, &returns[count],
+				BIG_BATCH - count);
+	}
+
+	/* All other packets must get through while worker 0 is stalled.
+	 * rte_distributor_flush() cannot be used here, as it waits for
+	 * the packets held by worker 0.
+	 */
+	while (processed < BIG_BATCH) {
+		processed += rte_distributor_process(d, &bufs[processed],
+				RTE_MIN((unsigned int)BURST,
+					BIG_BATCH - processed));
+		count += rte_distributor_returned_pkts(d, &returns[count],
+				BIG_BATCH - count);
+	}
+	/* Worker 0 holds at most one burst */
+	retries = 0;
+	while (count + WORKER_BURST < BIG_BATCH && retries++ < 10000) {
+		rte_distributor_process(d, NULL, 0);
+		count += rte_distributor_returned_pkts(d, &returns[count],
+				BIG_BATCH - count);
+		rte_delay_ms(1);
+	}
+	if (count + WORKER_BURST < BIG_BATCH) {
+		printf("line %d: Only %u of %u packets returned while worker 0 stalls\n",
+				__LINE__, count, BIG_BATCH);
+		goto err;
+	}
+
+	__atomic_store_n(&zero_release, 1, __ATOMIC_RELEASE);
+	retries = 0;
+	do {
+		rte_distributor_flush(d);
+		count += rte_distributor_returned_pkts(d, &returns[count],
+				BIG_BATCH - count);
+		retries++;
+	} while (count < BIG_BATCH && retries < 100);
+
+	for (i = 0; i < rte_lcore_count() - 1; i++)
+		printf("Worker %u handled %u packets\n", i,
+			__atomic_load_n(&worker_stats[i].handled_packets,
+					__ATOMIC_RELAXED));
+
+	if (count != BIG_BATCH) {
+		printf("line %d: Missing packets, expected %d, got %u\n",
+				__LINE__, BIG_BATCH, count);
+		goto err;
+	}
+	if (__atomic_load_n(&worker_stats[0].handled_packets,
+			__ATOMIC_RELAXED) > WORKER_BURST) {
+		printf("line %d: Stalled worker handled more than one burst\n",
+				__LINE__);
+		goto err;
+	}
+
+	rte_mempool_put_bulk(p, (void *)bufs, BIG_BATCH);
+	rte_distributor_work_stealing_set(d, 0);
+	printf("Work stealing test passed\n\n");
+	return 0;
+
+err:
+	__atomic_store_n(&zero_release, 1, __ATOMIC_RELEASE);
+	rte_mempool_put_bulk(p, (void *)bufs, BIG_BATCH);
+	rte_distributor_work_stealing_set(d, 0);
+	return -1;
+}
+
 static
 int test_error_distributor_create_name(void)
 {
@@ -817,6 +955,7 @@ quit_workers(struct worker_params *wp, struct rte_mempool *p)
 	zero_idx = RTE_MAX_LCORE;
 	zero_quit = 0;
 	zero_sleep = 0;
+	zero_release = 0;
 }
 
 static int
@@ -824,7 +963,7 @@ test_distributor(void)
 {
 	static struct rte_distributor *ds;
 	static struct rte_distributor *db;
-	static struct rte_distributor *dist[2];
+	static struct rte_distributor *dist[3];
 	static struct rte_mempool *p;
 	int i;
 
@@ -885,16 +1024,22 @@ test_distributor(void)
 
 	dist[0] = ds;
 	dist[1] = db;
+	dist[2] = db;
 
-	for (i = 0; i < 2; i++) {
+	for (i = 0; i < 3; i++) {
 
 		worker_params.dist = dist[i];
-		if (i)
+		if (i == 2)
+			strlcpy(worker_params.name, "burst work stealing",
+					sizeof(worker_params.name));
+		else if (i)
 			strlcpy(worker_params.name, "burst",
 					sizeof(worker_params.name));
 		else
 			strlcpy(worker_params.name, "single",
 					sizeof(worker_params.name));
+		if (i)
+			rte_distributor_work_stealing_set(db, i == 2);
 
 		rte_eal_mp_remote_launch(handle_work,
 				&worker_params, SKIP_MAIN);
@@ -936,6 +1081,25 @@ test_distributor(void)
 		}
 
 	}
+	rte_distributor_work_stealing_set(db, 0);
+
+	if (rte_lcore_count() > 2) {
+		worker_params.dist = db;
+		strlcpy(worker_params.name, "burst",
+				sizeof(worker_params.name));
+		rte_eal_mp_remote_launch(handle_work_with_stall,
+				&worker_params, SKIP_MAIN);
+		if (sanity_test_with_work_stealing(&worker_params, p) < 0)
+			goto err;
+		quit_workers(&worker_params, p);
+
+		if (rte_distributor_work_stealing_set(ds, 1) != -ENOTSUP) {
+			printf("Work stealing enabled on single distributor\n");
+			return -1;
+		}
+	} else {
+		printf("Too few cores to run work stealing test\n");
+	}
 
 	if (test_error_distributor_create_numworkers() == -1 ||
 			test_error_distributor_create_name() == -1) {
@@ -947,6 +1111,7 @@ test_distributor(void)
 
 err:
 	quit_workers(&worker_params, p);
+	rte_distributor_work_stealing_set(db, 0);
 	return -1;
 }
 
@@ -9,6 +9,8 @@
 
 #include <rte_ip.h>
 #include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
 
 #include "test.h"
 
@@ -30,6 +32,7 @@ test_slow_fib(void)
 #else
 
 #include <rte_fib.h>
+#include <rte_rib.h>
 
 typedef int32_t (*rte_fib_test)(void);
 
@@ -39,9 +42,17 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_invalid_rcu(void);
+static int32_t test_fib_rcu_sync_rw(void);
+static int32_t test_txn(void);
+static int32_t test_txn_bulk_cmp(void);
+static int32_t test_txn_tbl8_pool(void);
+static int32_t test_txn_rollback(void);
+static int32_t test_lookup_fn_cmp(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
+#define TXN_ROUTES	1024
 
 /*
  * Check that rte_fib_create fails gracefully for incorrect user input
@@ -394,6 +405,642 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * rte_fib_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to FIB
+ *  - Add another RCU QSBR variable to FIB
+ *  - Check returns
+ */
+int32_t
+test_invalid_rcu(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	uint64_t def_nh = 100;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+
+	/* Call rte_fib_rcu_qsbr_add without fib or config */
+	status = rte_fib_rcu_qsbr_add(NULL, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL, "RCU added without fib\n");
+	status = rte_fib_rcu_qsbr_add(fib, NULL);
+	RTE_TEST_ASSERT(status == -EINVAL, "RCU added without config\n");
+
+	/* Invalid FIB type */
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -ENOTSUP,
+		"RCU added for the DUMMY FIB type\n");
+	rte_fib_free(fib);
+
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Call rte_fib_rcu_qsbr_add without RCU QSBR variable */
+	rcu_cfg.v = NULL;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL,
+		"RCU added without QSBR variable\n");
+
+	rcu_cfg.v = qsv;
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL, "RCU added with incorrect mode\n");
+
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB */
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Create and attach another RCU QSBR to FIB */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv2 != NULL, "Can not allocate memory for RCU\n");
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_SYNC;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EEXIST, "Secondary RCU was mistakenly attached\n");
+
+	rte_fib_free(fib);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * rte_fib_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create FIB which supports 64 tbl8 groups at max
+ *  - Add RCU QSBR variable to FIB
+ *  - Add 64 rules with depth=28 (> 24), one per /24
+ *  - Register a reader thread (not a real thread)
+ *  - Reader lookup existing rule
+ *  - Writer delete the rule
+ *  - Reader lookup the rule
+ *  - Writer re-add the rule (no available tbl8 group)
+ *  - Reader report quiescent state
+ *  - Writer re-add the rule
+ *  - Reader lookup the rule
+ */
+int32_t
+test_fib_rcu_sync_rw(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	size_t sz;
+	int32_t status;
+	uint32_t ip, i;
+	uint8_t depth = 28;
+	uint64_t next_hop = 1, next_hop_return;
+	uint64_t def_nh = 100;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = 64;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB table */
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Use up all the tbl8 groups */
+	for (i = 0; i < 64; i++) {
+		ip = RTE_IPV4(192, 0, i, 100);
+		status = rte_fib_add(fib, ip, depth, next_hop);
+		RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+	}
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "RCU thread registration failed\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	ip = RTE_IPV4(192, 0, 0, 100);
+	status = rte_fib_lookup_bulk(fib, &ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT(status == 0, "FIB lookup failed\n");
+	RTE_TEST_ASSERT(next_hop_return == next_hop, "FIB lookup mismatch\n");
+
+	/* Writer update */
+	status = rte_fib_delete(fib, ip, depth);
+	RTE_TEST_ASSERT(status == 0, "Failed to delete a route\n");
+
+	status = rte_fib_lookup_bulk(fib, &ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT(status == 0, "FIB lookup failed\n");
+	RTE_TEST_ASSERT(next_hop_return == def_nh,
+		"Route was not deleted from FIB\n");
+
+	/* The only free tbl8 is still in the defer queue */
+	status = rte_fib_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status != 0, "tbl8 was reused too early\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_fib_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "RCU thread unregistration failed\n");
+
+	status = rte_fib_lookup_bulk(fib, &ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT(status == 0, "FIB lookup failed\n");
+	RTE_TEST_ASSERT(next_hop_return == next_hop,
+		"Failed to find the re-added route\n");
+
+	rte_fib_free(fib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that routes modified within a transaction are not visible
+ * to lookups until the transaction is committed.
+ */
+int32_t
+test_txn(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	uint32_t ip[2] = {RTE_IPV4(10, 0, 0, 1), RTE_IPV4(10, 0, 1, 1)};
+	uint8_t depth[2] = {16, 28};
+	uint64_t nh[2] = {1, 2};
+	uint64_t nh_ret[2];
+	uint64_t def_nh = 100;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == -ENOTSUP,
+		"Transaction opened on DUMMY type\n");
+	ret = rte_fib_add_bulk(fib, ip, depth, nh, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	rte_fib_free(fib);
+
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = 16;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib_txn_begin(NULL);
+	RTE_TEST_ASSERT(ret < 0, "Transaction opened on NULL FIB\n");
+	ret = rte_fib_txn_commit(fib);
+	RTE_TEST_ASSERT(ret < 0, "Commit without transaction succeeded\n");
+	ret = rte_fib_add_bulk(NULL, ip, depth, nh, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret < 0, "Bulk add to NULL FIB succeeded\n");
+	ret = rte_fib_add_bulk(fib, ip, depth, NULL, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret < 0, "Bulk add without next hops succeeded\n");
+
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == -EBUSY, "Transaction opened twice\n");
+
+	ret = rte_fib_add_bulk(fib, ip, depth, nh, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	ret = rte_fib_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == def_nh) &&
+		(nh_ret[1] == def_nh), "Uncommitted routes are visible\n");
+
+	ret = rte_fib_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+	ret = rte_fib_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == nh[0]) &&
+		(nh_ret[1] == nh[1]), "Committed routes are not visible\n");
+
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	ret = rte_fib_delete(fib, ip[0], depth[0]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	ret = rte_fib_add(fib, ip[1], depth[1], nh[0]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == nh[0]) &&
+		(nh_ret[1] == nh[1]), "Uncommitted changes are visible\n");
+
+	ret = rte_fib_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+	ret = rte_fib_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == def_nh) &&
+		(nh_ret[1] == nh[0]), "Committed changes are not visible\n");
+
+	ret = rte_fib_delete_bulk(fib, &ip[1], &depth[1], 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk delete routes\n");
+	ret = rte_fib_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == def_nh) &&
+		(nh_ret[1] == def_nh), "Deleted routes are visible\n");
+
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+static int
+cmp_fib(struct rte_fib *fib1, struct rte_fib *fib2, uint32_t *ips,
+	unsigned int n)
+{
+	uint64_t nh1[TXN_ROUTES], nh2[TXN_ROUTES];
+	unsigned int i;
+
+	rte_fib_lookup_bulk(fib1, ips, nh1, n);
+	rte_fib_lookup_bulk(fib2, ips, nh2, n);
+	for (i = 0; i < n; i++)
+		if (nh1[i] != nh2[i])
+			return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Build two FIBs from the same set of overlapping routes, one route
+ * at a time and using transactions, and check that lookups match.
+ */
+int32_t
+test_txn_bulk_cmp(void)
+{
+	struct rte_fib *fib1, *fib2;
+	struct rte_fib_conf config;
+	static uint32_t ips[TXN_ROUTES], lookup_ips[TXN_ROUTES];
+	static uint8_t depths[TXN_ROUTES];
+	static uint64_t nhs[TXN_ROUTES];
+	unsigned int i, j, n;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 0;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_2B;
+	config.dir24_8.num_tbl8 = 2 * TXN_ROUTES;
+
+	fib1 = rte_fib_create("txn_fib1", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib1 != NULL, "Failed to create FIB\n");
+	fib2 = rte_fib_create("txn_fib2", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib2 != NULL, "Failed to create FIB\n");
+
+	/* unique routes packed into 10.0.0.0/14 to get a lot of nesting */
+	for (n = 0; n < TXN_ROUTES; ) {
+		depths[n] = 14 + rte_rand_max(RTE_FIB_MAXDEPTH - 13);
+		ips[n] = (RTE_IPV4(10, 0, 0, 0) | rte_rand_max(1 << 18)) &
+			(uint32_t)(UINT64_MAX << (32 - depths[n]));
+		nhs[n] = 1 + rte_rand_max(1000);
+		for (j = 0; j < n; j++)
+			if ((ips[j] == ips[n]) && (depths[j] == depths[n]))
+				break;
+		if (j == n)
+			n++;
+	}
+	for (i = 0; i < TXN_ROUTES; i++)
+		lookup_ips[i] = ips[i] |
+			((uint32_t)rte_rand() >> depths[i]);
+
+	for (i = 0; i < TXN_ROUTES; i++) {
+		ret = rte_fib_add(fib1, ips[i], depths[i], nhs[i]);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = rte_fib_add_bulk(fib2, ips, depths, nhs, TXN_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	RTE_TEST_ASSERT(cmp_fib(fib1, fib2, ips, TXN_ROUTES) == 0 &&
+		cmp_fib(fib1, fib2, lookup_ips, TXN_ROUTES) == 0,
+		"Lookup mismatch after bulk add\n");
+
+	/* modify next hops of some routes and delete half of them */
+	ret = rte_fib_txn_begin(fib2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	for (i = 0; i < TXN_ROUTES / 2; i++) {
+		ret = rte_fib_add(fib1, ips[i], depths[i], nhs[i] + 1);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = rte_fib_add(fib2, ips[i], depths[i], nhs[i] + 1);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	for (i = TXN_ROUTES / 4; i < 3 * TXN_ROUTES / 4; i++) {
+		ret = rte_fib_delete(fib1, ips[i], depths[i]);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	ret = rte_fib_delete_bulk(fib2, &ips[TXN_ROUTES / 4],
+		&depths[TXN_ROUTES / 4], TXN_ROUTES / 2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk delete routes\n");
+	ret = rte_fib_txn_commit(fib2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+	RTE_TEST_ASSERT(cmp_fib(fib1, fib2, ips, TXN_ROUTES) == 0 &&
+		cmp_fib(fib1, fib2, lookup_ips, TXN_ROUTES) == 0,
+		"Lookup mismatch after transaction commit\n");
+
+	rte_fib_free(fib1);
+	rte_fib_free(fib2);
+
+	return TEST_SUCCESS;
+}
+
+#define TXN_TBL8S	64	/* dir24_8 rounds the pool up to 64 */
+
+/*
+ * Fill the tbl8 pool and check that a transaction deleting routes
+ * in some /24s and adding routes in other /24s fits in it.
+ */
+int32_t
+test_txn_tbl8_pool(void)
+{
+	struct rte_fib *fib;
+	struct rte_fib_conf config;
+	uint32_t ips[TXN_TBL8S + 1];
+	uint8_t depths[TXN_TBL8S + 1];
+	uint64_t nhs[TXN_TBL8S + 1];
+	uint64_t nh_ret[TXN_TBL8S + 1];
+	uint64_t def_nh = 100;
+	unsigned int i;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = TXN_TBL8S;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* one /28 per /24, the first one does not fit */
+	for (i = 0; i <= TXN_TBL8S; i++) {
+		ips[i] = RTE_IPV4(10, 0, i, 16);
+		depths[i] = 28;
+		nhs[i] = i + 1;
+	}
+	ret = rte_fib_add_bulk(fib, &ips[1], &depths[1], &nhs[1], TXN_TBL8S);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	ret = rte_fib_add_bulk(fib, ips, depths, nhs, 1);
+	RTE_TEST_ASSERT(ret == -ENOSPC, "Route added beyond tbl8 pool\n");
+	/* bulk transaction is closed despite the failure */
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed bulk add left transaction open\n");
+	ret = rte_fib_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+
+	/*
+	 * Delete the /28 of the highest /24 and add one in a lower /24,
+	 * which the commit installs first, along with a covering route.
+	 */
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	ret = rte_fib_delete(fib, ips[TXN_TBL8S], depths[TXN_TBL8S]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	ret = rte_fib_add(fib, ips[0], depths[0], nhs[0]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib_add(fib, ips[0], 16, def_nh + 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+
+	ret = rte_fib_lookup_bulk(fib, ips, nh_ret, TXN_TBL8S + 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+	for (i = 0; i < TXN_TBL8S; i++)
+		RTE_TEST_ASSERT(nh_ret[i] == nhs[i],
+			"Wrong next hop after commit\n");
+	RTE_TEST_ASSERT(nh_ret[TXN_TBL8S] == def_nh + 1,
+		"Wrong next hop after commit\n");
+
+	/* every tbl8 has been given back once the long routes are gone */
+	ret = rte_fib_delete_bulk(fib, ips, depths, TXN_TBL8S);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk delete routes\n");
+	for (i = 0; i < TXN_TBL8S; i++) {
+		ret = rte_fib_add(fib, RTE_IPV4(10, 1, i, 0), 28, 1);
+		RTE_TEST_ASSERT(ret == 0, "tbl8 leaked by a transaction\n");
+	}
+
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Fill the tbl8 pool and make a commit fail, then check that the RIB
+ * and the lookups are back to their state before the transaction.
+ */
+int32_t
+test_txn_rollback(void)
+{
+	struct rte_fib *fib;
+	struct rte_fib_conf config;
+	struct rte_rib *rib;
+	uint32_t ips[TXN_TBL8S + 1];
+	uint8_t depths[TXN_TBL8S + 1];
+	uint64_t nhs[TXN_TBL8S + 1];
+	uint64_t nh_ret[TXN_TBL8S + 1];
+	uint32_t ip_gap = RTE_IPV4(10, 0, 0, 32);
+	uint64_t def_nh = 100;
+	uint64_t nh;
+	unsigned int i;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = TXN_TBL8S;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	rib = rte_fib_get_rib(fib);
+
+	/* one /28 per /24, the first one is only added by the transaction */
+	for (i = 0; i <= TXN_TBL8S; i++) {
+		ips[i] = RTE_IPV4(10, 0, i, 16);
+		depths[i] = 28;
+		nhs[i] = i + 1;
+	}
+	ips[0] = RTE_IPV4(10, 0, 0, 0);
+	ret = rte_fib_add_bulk(fib, &ips[1], &depths[1], &nhs[1], TXN_TBL8S);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+
+	/*
+	 * Free a single tbl8 and add a covering route whose rebuild
+	 * needs two at once, the first one ending in the middle of a /24.
+	 */
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	ret = rte_fib_delete(fib, ips[TXN_TBL8S], depths[TXN_TBL8S]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	ret = rte_fib_add(fib, ips[0], depths[0], nhs[0]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib_add(fib, ips[1], depths[1], def_nh + 2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to modify a route\n");
+	ret = rte_fib_add(fib, ips[0], 16, def_nh + 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == -ENOSPC, "Commit beyond tbl8 pool succeeded\n");
+
+	/* the transaction is closed and rolled back */
+	ret = rte_fib_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed commit left transaction open\n");
+	ret = rte_fib_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+
+	RTE_TEST_ASSERT(rte_rib_lookup_exact(rib, ips[0], 16) == NULL,
+		"Added route left in the RIB\n");
+	RTE_TEST_ASSERT(rte_rib_lookup_exact(rib, ips[0], depths[0]) == NULL,
+		"Added route left in the RIB\n");
+	for (i = 1; i <= TXN_TBL8S; i++) {
+		ret = rte_rib_get_nh(rte_rib_lookup_exact(rib, ips[i],
+			depths[i]), &nh);
+		RTE_TEST_ASSERT((ret == 0) && (nh == nhs[i]),
+			"Route not restored in the RIB\n");
+	}
+
+	ret = rte_fib_lookup_bulk(fib, ips, nh_ret, TXN_TBL8S + 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+	RTE_TEST_ASSERT(nh_ret[0] == def_nh, "Wrong next hop after rollback\n");
+	for (i = 1; i <= TXN_TBL8S; i++)
+		RTE_TEST_ASSERT(nh_ret[i] == nhs[i],
+			"Wrong next hop after rollback\n");
+	ret = rte_fib_lookup_bulk(fib, &ip_gap, nh_ret, 1);
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == def_nh),
+		"Wrong next hop after rollback\n");
+
+	/* every tbl8 is still in the pool */
+	ret = rte_fib_delete_bulk(fib, &ips[1], &depths[1], TXN_TBL8S);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk delete routes\n");
+	for (i = 0; i < TXN_TBL8S; i++) {
+		ret = rte_fib_add(fib, RTE_IPV4(10, 1, i, 0), 28, 1);
+		RTE_TEST_ASSERT(ret == 0, "tbl8 leaked by a rollback\n");
+	}
+
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that every available lookup function returns
+ * the same next hops as the scalar one.
+ */
+int32_t
+test_lookup_fn_cmp(void)
+{
+	struct rte_fib *fib;
+	struct rte_fib_conf config;
+	static uint32_t ips[TXN_ROUTES], lookup_ips[TXN_ROUTES];
+	static uint64_t nh_ref[TXN_ROUTES], nh[TXN_ROUTES];
+	const enum rte_fib_lookup_type types[] = {
+		RTE_FIB_LOOKUP_DIR24_8_SCALAR_INLINE,
+		RTE_FIB_LOOKUP_DIR24_8_SCALAR_UNI,
+		RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512,
+		RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX2,
+		RTE_FIB_LOOKUP_DIR24_8_VECTOR_NEON,
+	};
+	enum rte_fib_dir24_8_nh_sz nh_sz;
+	uint8_t depth;
+	unsigned int i, j;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 0;
+	config.type = RTE_FIB_DIR24_8;
+	/* max number of tbl8 for 1 byte next hops */
+	config.dir24_8.num_tbl8 = 127;
+
+	for (nh_sz = RTE_FIB_DIR24_8_1B; nh_sz <= RTE_FIB_DIR24_8_8B;
+			nh_sz++) {
+		config.dir24_8.nh_sz = nh_sz;
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+		/* half of the routes go to tbl8, 64 tbl8 groups at most */
+		for (i = 0; i < TXN_ROUTES; i++) {
+			depth = 16 + rte_rand_max(RTE_FIB_MAXDEPTH - 15);
+			ips[i] = (RTE_IPV4(10, 0, 0, 0) |
+				rte_rand_max(1 << 14)) &
+				(uint32_t)(UINT64_MAX << (32 - depth));
+			ret = rte_fib_add(fib, ips[i], depth,
+				rte_rand_max(RTE_MIN(UINT8_MAX >> 1, 1000)));
+			RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+			lookup_ips[i] = ips[i] |
+				((uint32_t)rte_rand() >> depth);
+		}
+		/* miss some routes on purpose */
+		for (i = 0; i < TXN_ROUTES; i += 4)
+			lookup_ips[i] = (uint32_t)rte_rand();
+
+		ret = rte_fib_select_lookup(fib,
+			RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO);
+		RTE_TEST_ASSERT(ret == 0, "Failed to select lookup\n");
+		/* odd number of ips to check the scalar tail */
+		rte_fib_lookup_bulk(fib, lookup_ips, nh_ref, TXN_ROUTES - 1);
+
+		for (j = 0; j < RTE_DIM(types); j++) {
+			/* skip functions not supported by the platform */
+			if (rte_fib_select_lookup(fib, types[j]) != 0)
+				continue;
+			memset(nh, 0, sizeof(nh));
+			rte_fib_lookup_bulk(fib, lookup_ips, nh,
+				TXN_ROUTES - 1);
+			for (i = 0; i < TXN_ROUTES - 1; i++)
+				RTE_TEST_ASSERT(nh[i] == nh_ref[i],
+					"Lookup type %d mismatch for nh_sz %d\n",
+					types[j], nh_sz);
+		}
+		rte_fib_free(fib);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib_fast_tests = {
 	.suite_name = "fib autotest",
 	.setup = NULL,
@@ -404,6 +1051,13 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_invalid_rcu),
+	TEST_CASE(test_fib_rcu_sync_rw),
+	TEST_CASE(test_txn),
+	TEST_CASE(test_txn_bulk_cmp),
+	TEST_CASE(test_txn_tbl8_pool),
+	TEST_CASE(test_txn_rollback),
+	TEST_CASE(test_lookup_fn_cmp),
 	TEST_CASES_END()
 	}
 };
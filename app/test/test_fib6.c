@@ -9,6 +9,8 @@
 
 #include <rte_memory.h>
 #include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
 
 #include "test.h"
 
@@ -40,10 +42,17 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_invalid_rcu(void);
+static int32_t test_fib_rcu_sync_rw(void);
+static int32_t test_txn(void);
+static int32_t test_txn_bulk_cmp(void);
+static int32_t test_txn_tbl8_pool(void);
+static int32_t test_lookup_fn_cmp(void);
 
 #define MAX_ROUTES	(1 << 16)
 /** Maximum number of tbl8 for 2-byte entries */
 #define MAX_TBL8	(1 << 15)
+#define TXN_ROUTES	512
 
 /*
  * Check that rte_fib6_create fails gracefully for incorrect user input
@@ -403,6 +412,557 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * rte_fib6_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to FIB
+ *  - Add another RCU QSBR variable to FIB
+ *  - Check returns
+ */
+int32_t
+test_invalid_rcu(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_fib6_rcu_config rcu_cfg = {0};
+	uint64_t def_nh = 100;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB6_DUMMY;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+
+	/* Call rte_fib6_rcu_qsbr_add without fib or config */
+	status = rte_fib6_rcu_qsbr_add(NULL, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL, "RCU added without fib\n");
+	status = rte_fib6_rcu_qsbr_add(fib, NULL);
+	RTE_TEST_ASSERT(status == -EINVAL, "RCU added without config\n");
+
+	/* Invalid FIB type */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -ENOTSUP,
+		"RCU added for the DUMMY FIB type\n");
+	rte_fib6_free(fib);
+
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = MAX_TBL8;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Call rte_fib6_rcu_qsbr_add without RCU QSBR variable */
+	rcu_cfg.v = NULL;
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL,
+		"RCU added without QSBR variable\n");
+
+	rcu_cfg.v = qsv;
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL, "RCU added with incorrect mode\n");
+
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Create and attach another RCU QSBR to FIB */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv2 != NULL, "Can not allocate memory for RCU\n");
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_SYNC;
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EEXIST, "Secondary RCU was mistakenly attached\n");
+
+	rte_fib6_free(fib);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * rte_fib6_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create FIB which supports 3 tbl8 groups at max
+ *  - Add RCU QSBR variable to FIB
+ *  - Register a reader thread (not a real thread)
+ *  - Add a rule with depth=32 (> 24)
+ *  - Reader lookup existing rule
+ *  - Writer delete the rule, which releases all the tbl8 groups
+ *  - Reader lookup the rule
+ *  - Writer re-add the rule (no available tbl8 group)
+ *  - Reader report quiescent state
+ *  - Writer re-add the rule
+ *  - Reader lookup the rule
+ */
+int32_t
+test_fib_rcu_sync_rw(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	size_t sz;
+	int32_t status;
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0x20, 0x01, 0x0d, 0xb8, };
+	uint8_t depth = 32;
+	uint64_t next_hop = 1, next_hop_return;
+	uint64_t def_nh = 100;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_fib6_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = 3;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB table */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "RCU thread registration failed\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	status = rte_fib6_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+
+	status = rte_fib6_lookup_bulk(fib, &ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT(status == 0, "FIB lookup failed\n");
+	RTE_TEST_ASSERT(next_hop_return == next_hop, "FIB lookup mismatch\n");
+
+	/* Writer update */
+	status = rte_fib6_delete(fib, ip, depth);
+	RTE_TEST_ASSERT(status == 0, "Failed to delete a route\n");
+
+	status = rte_fib6_lookup_bulk(fib, &ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT(status == 0, "FIB lookup failed\n");
+	RTE_TEST_ASSERT(next_hop_return == def_nh,
+		"Route was not deleted from FIB\n");
+
+	/* Released tbl8 groups are still in the defer queue */
+	status = rte_fib6_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status != 0, "tbl8 was reused too early\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_fib6_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "RCU thread unregistration failed\n");
+
+	status = rte_fib6_lookup_bulk(fib, &ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT(status == 0, "FIB lookup failed\n");
+	RTE_TEST_ASSERT(next_hop_return == next_hop,
+		"Failed to find the re-added route\n");
+
+	rte_fib6_free(fib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that routes modified within a transaction are not visible
+ * to lookups until the transaction is committed.
+ */
+int32_t
+test_txn(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	uint8_t ip[2][RTE_FIB6_IPV6_ADDR_SIZE] = {
+		{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 1, },
+		{0x20, 0x01, 0x0d, 0xb8, 0, 1, 0, 1, },
+	};
+	uint8_t depth[2] = {32, 64};
+	uint64_t nh[2] = {1, 2};
+	uint64_t nh_ret[2];
+	uint64_t def_nh = 100;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB6_DUMMY;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib6_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == -ENOTSUP,
+		"Transaction opened on DUMMY type\n");
+	ret = rte_fib6_add_bulk(fib, ip, depth, nh, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	rte_fib6_free(fib);
+
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = 32;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib6_txn_begin(NULL);
+	RTE_TEST_ASSERT(ret < 0, "Transaction opened on NULL FIB\n");
+	ret = rte_fib6_txn_commit(fib);
+	RTE_TEST_ASSERT(ret < 0, "Commit without transaction succeeded\n");
+	ret = rte_fib6_add_bulk(NULL, ip, depth, nh, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret < 0, "Bulk add to NULL FIB succeeded\n");
+	ret = rte_fib6_add_bulk(fib, ip, depth, NULL, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret < 0, "Bulk add without next hops succeeded\n");
+
+	ret = rte_fib6_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	ret = rte_fib6_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == -EBUSY, "Transaction opened twice\n");
+
+	ret = rte_fib6_add_bulk(fib, ip, depth, nh, RTE_DIM(ip));
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	ret = rte_fib6_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == def_nh) &&
+		(nh_ret[1] == def_nh), "Uncommitted routes are visible\n");
+
+	ret = rte_fib6_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+	ret = rte_fib6_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == nh[0]) &&
+		(nh_ret[1] == nh[1]), "Committed routes are not visible\n");
+
+	ret = rte_fib6_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	ret = rte_fib6_delete(fib, ip[0], depth[0]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	ret = rte_fib6_add(fib, ip[1], depth[1], nh[0]);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib6_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == nh[0]) &&
+		(nh_ret[1] == nh[1]), "Uncommitted changes are visible\n");
+
+	ret = rte_fib6_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+	ret = rte_fib6_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == def_nh) &&
+		(nh_ret[1] == nh[0]), "Committed changes are not visible\n");
+
+	ret = rte_fib6_delete_bulk(fib, &ip[1], &depth[1], 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk delete routes\n");
+	ret = rte_fib6_lookup_bulk(fib, ip, nh_ret, RTE_DIM(ip));
+	RTE_TEST_ASSERT((ret == 0) && (nh_ret[0] == def_nh) &&
+		(nh_ret[1] == def_nh), "Deleted routes are visible\n");
+
+	rte_fib6_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+static int
+cmp_fib(struct rte_fib6 *fib1, struct rte_fib6 *fib2,
+	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], unsigned int n)
+{
+	uint64_t nh1[TXN_ROUTES], nh2[TXN_ROUTES];
+	unsigned int i;
+
+	rte_fib6_lookup_bulk(fib1, ips, nh1, n);
+	rte_fib6_lookup_bulk(fib2, ips, nh2, n);
+	for (i = 0; i < n; i++)
+		if (nh1[i] != nh2[i])
+			return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Build two FIBs from the same set of overlapping routes, one route
+ * at a time and using transactions, and check that lookups match.
+ */
+int32_t
+test_txn_bulk_cmp(void)
+{
+	struct rte_fib6 *fib1, *fib2;
+	struct rte_fib6_conf config;
+	static uint8_t ips[TXN_ROUTES][RTE_FIB6_IPV6_ADDR_SIZE];
+	static uint8_t lookup_ips[TXN_ROUTES][RTE_FIB6_IPV6_ADDR_SIZE];
+	static uint8_t depths[TXN_ROUTES];
+	static uint64_t nhs[TXN_ROUTES];
+	unsigned int i, j, k, n;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_2B;
+	config.trie.num_tbl8 = MAX_TBL8 / 2;
+
+	fib1 = rte_fib6_create("txn_fib1", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib1 != NULL, "Failed to create FIB\n");
+	fib2 = rte_fib6_create("txn_fib2", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib2 != NULL, "Failed to create FIB\n");
+
+	/*
+	 * unique routes within 2001:db8::/32 with few random bits
+	 * to get a lot of nesting
+	 */
+	for (n = 0; n < TXN_ROUTES; ) {
+		memset(ips[n], 0, RTE_FIB6_IPV6_ADDR_SIZE);
+		ips[n][0] = 0x20;
+		ips[n][1] = 0x01;
+		ips[n][2] = 0x0d;
+		ips[n][3] = 0xb8;
+		ips[n][4] = rte_rand_max(4);
+		ips[n][5] = rte_rand();
+		ips[n][15] = rte_rand();
+		depths[n] = 32 + rte_rand_max(RTE_FIB6_MAXDEPTH - 31);
+		for (k = 0; k < RTE_FIB6_IPV6_ADDR_SIZE; k++)
+			ips[n][k] &= get_msk_part(depths[n], k);
+		nhs[n] = 1 + rte_rand_max(1000);
+		for (j = 0; j < n; j++)
+			if ((depths[j] == depths[n]) &&
+					rte_rib6_is_equal(ips[j], ips[n]))
+				break;
+		if (j == n)
+			n++;
+	}
+	for (i = 0; i < TXN_ROUTES; i++)
+		for (k = 0; k < RTE_FIB6_IPV6_ADDR_SIZE; k++)
+			lookup_ips[i][k] = ips[i][k] |
+				(rte_rand() & ~get_msk_part(depths[i], k));
+
+	for (i = 0; i < TXN_ROUTES; i++) {
+		ret = rte_fib6_add(fib1, ips[i], depths[i], nhs[i]);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = rte_fib6_add_bulk(fib2, ips, depths, nhs, TXN_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	RTE_TEST_ASSERT(cmp_fib(fib1, fib2, ips, TXN_ROUTES) == 0 &&
+		cmp_fib(fib1, fib2, lookup_ips, TXN_ROUTES) == 0,
+		"Lookup mismatch after bulk add\n");
+
+	/* modify next hops of some routes and delete half of them */
+	ret = rte_fib6_txn_begin(fib2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+	for (i = 0; i < TXN_ROUTES / 2; i++) {
+		ret = rte_fib6_add(fib1, ips[i], depths[i], nhs[i] + 1);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = rte_fib6_add(fib2, ips[i], depths[i], nhs[i] + 1);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	for (i = TXN_ROUTES / 4; i < 3 * TXN_ROUTES / 4; i++) {
+		ret = rte_fib6_delete(fib1, ips[i], depths[i]);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	ret = rte_fib6_delete_bulk(fib2, &ips[TXN_ROUTES / 4],
+		&depths[TXN_ROUTES / 4], TXN_ROUTES / 2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk delete routes\n");
+	ret = rte_fib6_txn_commit(fib2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+	RTE_TEST_ASSERT(cmp_fib(fib1, fib2, ips, TXN_ROUTES) == 0 &&
+		cmp_fib(fib1, fib2, lookup_ips, TXN_ROUTES) == 0,
+		"Lookup mismatch after transaction commit\n");
+
+	rte_fib6_free(fib1);
+	rte_fib6_free(fib2);
+
+	return TEST_SUCCESS;
+}
+
+#define TXN_TBL8S	4
+
+/*
+ * Fill the tbl8 pool and check that transactions deleting a route
+ * in one /24 and adding a route in another /24 keep fitting in it.
+ */
+int32_t
+test_txn_tbl8_pool(void)
+{
+	struct rte_fib6 *fib;
+	struct rte_fib6_conf config;
+	uint8_t ips[TXN_TBL8S + 1][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t depths[TXN_TBL8S + 1];
+	uint64_t nhs[TXN_TBL8S + 1];
+	uint64_t nh_ret[TXN_TBL8S + 1];
+	uint64_t def_nh = 100;
+	unsigned int i, free_idx, round;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	/* the reservation check keeps one tbl8 spare */
+	config.trie.num_tbl8 = TXN_TBL8S + 1;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* one /32 per /24, the first one does not fit */
+	for (i = 0; i <= TXN_TBL8S; i++) {
+		memset(ips[i], 0, RTE_FIB6_IPV6_ADDR_SIZE);
+		ips[i][0] = 0x20;
+		ips[i][1] = 0x01;
+		ips[i][2] = i;
+		ips[i][3] = 0xb8;
+		depths[i] = 32;
+		nhs[i] = i + 1;
+	}
+	ret = rte_fib6_add_bulk(fib, &ips[1], &depths[1], &nhs[1], TXN_TBL8S);
+	RTE_TEST_ASSERT(ret == 0, "Failed to bulk add routes\n");
+	ret = rte_fib6_add_bulk(fib, ips, depths, nhs, 1);
+	RTE_TEST_ASSERT(ret == -ENOSPC, "Route added beyond tbl8 pool\n");
+	/* bulk transaction is closed despite the failure */
+	ret = rte_fib6_txn_begin(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed bulk add left transaction open\n");
+	ret = rte_fib6_txn_commit(fib);
+	RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+
+	/*
+	 * Move the free /24 around, so that the added route is installed
+	 * before the deleted one is removed, along with a covering route.
+	 * A leaked tbl8 would make the following rounds run out of them.
+	 */
+	for (round = 0, free_idx = 0; round < 2 * (TXN_TBL8S + 1); round++) {
+		i = (free_idx + 1) % (TXN_TBL8S + 1);
+		ret = rte_fib6_txn_begin(fib);
+		RTE_TEST_ASSERT(ret == 0, "Failed to open a transaction\n");
+		ret = rte_fib6_delete(fib, ips[i], depths[i]);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+		ret = rte_fib6_add(fib, ips[free_idx], depths[free_idx],
+			nhs[free_idx]);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = rte_fib6_add(fib, ips[0], 16, def_nh + 1 + round);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = rte_fib6_txn_commit(fib);
+		RTE_TEST_ASSERT(ret == 0, "Failed to commit a transaction\n");
+		free_idx = i;
+
+		ret = rte_fib6_lookup_bulk(fib, ips, nh_ret, TXN_TBL8S + 1);
+		RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+		for (i = 0; i <= TXN_TBL8S; i++)
+			RTE_TEST_ASSERT(nh_ret[i] == ((i == free_idx) ?
+				def_nh + 1 + round : nhs[i]),
+				"Wrong next hop after commit\n");
+	}
+
+	rte_fib6_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that every available lookup function returns
+ * the same next hops as the scalar one.
+ */
+int32_t
+test_lookup_fn_cmp(void)
+{
+	struct rte_fib6 *fib;
+	struct rte_fib6_conf config;
+	static uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	static uint8_t lookup_ips[TXN_ROUTES][RTE_FIB6_IPV6_ADDR_SIZE];
+	static uint64_t nh_ref[TXN_ROUTES], nh[TXN_ROUTES];
+	const enum rte_fib6_lookup_type types[] = {
+		RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512,
+		RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX2,
+	};
+	enum rte_fib_trie_nh_sz nh_sz;
+	uint8_t depth;
+	unsigned int i, j, k;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.rib_ext_sz = 0;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.num_tbl8 = MAX_TBL8 / 2;
+
+	for (nh_sz = RTE_FIB6_TRIE_2B; nh_sz <= RTE_FIB6_TRIE_8B; nh_sz++) {
+		config.trie.nh_sz = nh_sz;
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+		for (i = 0; i < TXN_ROUTES; i++) {
+			memset(ip, 0, sizeof(ip));
+			ip[0] = 0x20;
+			ip[1] = 0x01;
+			ip[4] = rte_rand();
+			ip[15] = rte_rand();
+			depth = 16 + rte_rand_max(RTE_FIB6_MAXDEPTH - 15);
+			for (k = 0; k < RTE_FIB6_IPV6_ADDR_SIZE; k++) {
+				ip[k] &= get_msk_part(depth, k);
+				lookup_ips[i][k] = ip[k] |
+					(rte_rand() & ~get_msk_part(depth, k));
+			}
+			ret = rte_fib6_add(fib, ip, depth,
+				rte_rand_max(1000));
+			RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		}
+		/* miss some routes on purpose */
+		for (i = 0; i < TXN_ROUTES; i += 4)
+			lookup_ips[i][0] = 0x30;
+
+		ret = rte_fib6_select_lookup(fib, RTE_FIB6_LOOKUP_TRIE_SCALAR);
+		RTE_TEST_ASSERT(ret == 0, "Failed to select lookup\n");
+		/* odd number of ips to check the scalar tail */
+		rte_fib6_lookup_bulk(fib, lookup_ips, nh_ref, TXN_ROUTES - 1);
+
+		for (j = 0; j < RTE_DIM(types); j++) {
+			/* skip functions not supported by the platform */
+			if (rte_fib6_select_lookup(fib, types[j]) != 0)
+				continue;
+			memset(nh, 0, sizeof(nh));
+			rte_fib6_lookup_bulk(fib, lookup_ips, nh,
+				TXN_ROUTES - 1);
+			for (i = 0; i < TXN_ROUTES - 1; i++)
+				RTE_TEST_ASSERT(nh[i] == nh_ref[i],
+					"Lookup type %d mismatch for nh_sz %d\n",
+					types[j], nh_sz);
+		}
+		rte_fib6_free(fib);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib6_fast_tests = {
 	.suite_name = "fib6 autotest",
 	.setup = NULL,
@@ -413,6 +973,12 @@ static struct unit_test_suite fib6_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_invalid_rcu),
+	TEST_CASE(test_fib_rcu_sync_rw),
+	TEST_CASE(test_txn),
+	TEST_CASE(test_txn_bulk_cmp),
+	TEST_CASE(test_txn_tbl8_pool),
+	TEST_CASE(test_lookup_fn_cmp),
 	TEST_CASES_END()
 	}
 };
@@ -8,6 +8,7 @@
 #include <inttypes.h>
 #include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -23,10 +24,14 @@ test_node_list_dump(void)
 
 #else
 
+#include <rte_ether.h>
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_lpm6.h>
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
+#include <rte_node_ip6_api.h>
 #include <rte_random.h>
 
 static uint16_t test_node_worker_source(struct rte_graph *graph,
@@ -49,6 +54,38 @@ static uint16_t test_node3_worker(struct rte_graph *graph,
 				  struct rte_node *node, void **objs,
 				  uint16_t nb_objs);
 
+static uint16_t test_dispatch_source(struct rte_graph *graph,
+				     struct rte_node *node, void **objs,
+				     uint16_t nb_objs);
+
+static uint16_t test_dispatch_worker(struct rte_graph *graph,
+				     struct rte_node *node, void **objs,
+				     uint16_t nb_objs);
+
+static uint16_t test_dispatch_sink(struct rte_graph *graph,
+				   struct rte_node *node, void **objs,
+				   uint16_t nb_objs);
+
+static uint16_t test_profile_source(struct rte_graph *graph,
+				    struct rte_node *node, void **objs,
+				    uint16_t nb_objs);
+
+static uint16_t test_profile_worker(struct rte_graph *graph,
+				    struct rte_node *node, void **objs,
+				    uint16_t nb_objs);
+
+static uint16_t test_profile_sink(struct rte_graph *graph,
+				  struct rte_node *node, void **objs,
+				  uint16_t nb_objs);
+
+static uint16_t test_ip6_source(struct rte_graph *graph,
+				struct rte_node *node, void **objs,
+				uint16_t nb_objs);
+
+static uint16_t test_ip6_sink(struct rte_graph *graph,
+			      struct rte_node *node, void **objs,
+			      uint16_t nb_objs);
+
 #define MBUFF_SIZE 512
 #define MAX_NODES  4
 
@@ -68,6 +105,43 @@ static rte_graph_t graph_id;
 static uint64_t obj_stats[MAX_NODES + 1];
 static uint64_t fn_calls[MAX_NODES + 1];
 
+#define DISPATCH_NODES 3
+#define DISPATCH_WALKS 8
+
+#define PROFILE_WALKS 4
+#define PROFILE_SAMPLE_RATE 16
+
+#define IP6_PKTS 30 /* not a multiple of 4, to cover the tail loop */
+#define IP6_REWRITE_NH 1
+#define IP6_DROP_NH 2
+
+static const char *dispatch_node_names[DISPATCH_NODES] = {
+	"test_dispatch_source",
+	"test_dispatch_worker",
+	"test_dispatch_sink",
+};
+
+/* Edges of ip6_lookup, swapped with the test sinks during the test */
+static const char *ip6_lookup_edges[RTE_NODE_IP6_LOOKUP_NEXT_MAX] = {
+	[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE] = "ip6_rewrite",
+	[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP] = "pkt_drop",
+};
+
+static const char *ip6_sink_names[RTE_NODE_IP6_LOOKUP_NEXT_MAX] = {
+	[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE] = "test_ip6_rewrite",
+	[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP] = "test_ip6_drop",
+};
+
+static struct rte_mbuf *ip6_pkts[IP6_PKTS];
+static uint16_t ip6_nb_pkts;
+static uint64_t ip6_objs[RTE_NODE_IP6_LOOKUP_NEXT_MAX];
+static uint64_t ip6_bad_nh;
+static int ip6_priv1_offset = -1;
+
+static unsigned int dispatch_lcore;
+static uint64_t dispatch_objs[DISPATCH_NODES];
+static uint64_t dispatch_bad_lcore;
+
 const char *node_patterns[] = {
 	"test_node_source1",	   "test_node00",
 	"test_node00-test_node11", "test_node00-test_node22",
@@ -165,6 +239,191 @@ static struct rte_node_register test_node0 = {
 };
 RTE_NODE_REGISTER(test_node0);
 
+static struct rte_node_register test_dispatch_source_node = {
+	.name = "test_dispatch_source",
+	.process = test_dispatch_source,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_dispatch_worker"},
+};
+RTE_NODE_REGISTER(test_dispatch_source_node);
+
+static struct rte_node_register test_dispatch_worker_node = {
+	.name = "test_dispatch_worker",
+	.process = test_dispatch_worker,
+	.nb_edges = 1,
+	.next_nodes = {"test_dispatch_sink"},
+};
+RTE_NODE_REGISTER(test_dispatch_worker_node);
+
+static struct rte_node_register test_dispatch_sink_node = {
+	.name = "test_dispatch_sink",
+	.process = test_dispatch_sink,
+};
+RTE_NODE_REGISTER(test_dispatch_sink_node);
+
+static struct rte_node_register test_profile_source_node = {
+	.name = "test_profile_source",
+	.process = test_profile_source,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 2,
+	.next_nodes = {"test_profile_worker", "test_profile_sink"},
+};
+RTE_NODE_REGISTER(test_profile_source_node);
+
+static struct rte_node_register test_profile_worker_node = {
+	.name = "test_profile_worker",
+	.process = test_profile_worker,
+	.nb_edges = 1,
+	.next_nodes = {"test_profile_sink"},
+};
+RTE_NODE_REGISTER(test_profile_worker_node);
+
+static struct rte_node_register test_profile_sink_node = {
+	.name = "test_profile_sink",
+	.process = test_profile_sink,
+};
+RTE_NODE_REGISTER(test_profile_sink_node);
+
+static struct rte_node_register test_ip6_source_node = {
+	.name = "test_ip6_source",
+	.process = test_ip6_source,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"ip6_lookup"},
+};
+RTE_NODE_REGISTER(test_ip6_source_node);
+
+static struct rte_node_register test_ip6_rewrite_node = {
+	.name = "test_ip6_rewrite",
+	.process = test_ip6_sink,
+};
+RTE_NODE_REGISTER(test_ip6_rewrite_node);
+
+static struct rte_node_register test_ip6_drop_node = {
+	.name = "test_ip6_drop",
+	.process = test_ip6_sink,
+};
+RTE_NODE_REGISTER(test_ip6_drop_node);
+
+uint16_t
+test_dispatch_source(struct rte_graph *graph, struct rte_node *node,
+		     void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+	nb_objs = RTE_GRAPH_BURST_SIZE;
+
+	rte_node_enqueue(graph, node, 0, mbuf_p[0], nb_objs);
+	dispatch_objs[0] += nb_objs;
+	return nb_objs;
+}
+
+uint16_t
+test_dispatch_worker(struct rte_graph *graph, struct rte_node *node,
+		     void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+
+	/* Affined node, must run on its lcore only */
+	if (rte_lcore_id() != dispatch_lcore)
+		dispatch_bad_lcore++;
+
+	rte_node_next_stream_move(graph, node, 0);
+	dispatch_objs[1] += nb_objs;
+	return nb_objs;
+}
+
+uint16_t
+test_dispatch_sink(struct rte_graph *graph, struct rte_node *node,
+		   void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+
+	/* Node without affinity runs where its stream is produced */
+	if (rte_lcore_id() != dispatch_lcore)
+		dispatch_bad_lcore++;
+
+	dispatch_objs[2] += nb_objs;
+	return nb_objs;
+}
+
+/* Half of the burst reaches the sink through the worker, half directly */
+uint16_t
+test_profile_source(struct rte_graph *graph, struct rte_node *node,
+		    void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+	nb_objs = RTE_GRAPH_BURST_SIZE;
+
+	rte_node_enqueue(graph, node, 0, mbuf_p[0], nb_objs / 2);
+	rte_node_enqueue(graph, node, 1, &mbuf_p[0][nb_objs / 2],
+			 nb_objs / 2);
+	return nb_objs;
+}
+
+uint16_t
+test_profile_worker(struct rte_graph *graph, struct rte_node *node,
+		    void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+
+	rte_node_next_stream_move(graph, node, 0);
+	return nb_objs;
+}
+
+uint16_t
+test_profile_sink(struct rte_graph *graph, struct rte_node *node,
+		  void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+
+	return nb_objs;
+}
+
+uint16_t
+test_ip6_source(struct rte_graph *graph, struct rte_node *node,
+		void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+
+	/* The packets are sent once, on the first walk */
+	nb_objs = ip6_nb_pkts;
+	if (nb_objs != 0)
+		rte_node_enqueue(graph, node, 0, (void **)ip6_pkts, nb_objs);
+	ip6_nb_pkts = 0;
+	return nb_objs;
+}
+
+uint16_t
+test_ip6_sink(struct rte_graph *graph, struct rte_node *node,
+	      void **objs, uint16_t nb_objs)
+{
+	unsigned int next = RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP;
+	uint16_t i, nh;
+
+	RTE_SET_USED(graph);
+
+	if (node->id == rte_node_from_name(ip6_sink_names[0]))
+		next = RTE_NODE_IP6_LOOKUP_NEXT_REWRITE;
+
+	/* ip6_lookup stores the next hop in the first priv1 field */
+	for (i = 0; i < nb_objs; i++) {
+		nh = *RTE_MBUF_DYNFIELD((struct rte_mbuf *)objs[i],
+					ip6_priv1_offset, uint16_t *);
+		if (next == RTE_NODE_IP6_LOOKUP_NEXT_REWRITE &&
+		    nh != IP6_REWRITE_NH)
+			ip6_bad_nh++;
+	}
+
+	ip6_objs[next] += nb_objs;
+	rte_pktmbuf_free_bulk((struct rte_mbuf **)objs, nb_objs);
+	return nb_objs;
+}
+
 uint16_t
 test_node_worker_source(struct rte_graph *graph, struct rte_node *node,
 			void **objs, uint16_t nb_objs)
@@ -789,6 +1048,425 @@ test_print_stats(void)
 	return 0;
 }
 
+static int
+graph_dispatch_stats_cb(bool is_first, bool is_last, void *cookie,
+			const struct rte_graph_cluster_node_stats *st)
+{
+	int i;
+
+	RTE_SET_USED(is_first);
+	RTE_SET_USED(is_last);
+
+	for (i = 0; i < DISPATCH_NODES; i++) {
+		if (rte_node_from_name(dispatch_node_names[i]) != st->id)
+			continue;
+		if (dispatch_objs[i] != st->objs) {
+			printf("Obj count miss match for node = %s expected = %"PRId64", got=%"PRId64"\n",
+			       dispatch_node_names[i], dispatch_objs[i],
+			       st->objs);
+			*(int *)cookie = -1;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int
+graph_dispatch_walk(void *arg)
+{
+	rte_graph_walk(arg);
+	return 0;
+}
+
+static int
+test_graph_dispatch(void)
+{
+	static const char *patterns[] = {"test_dispatch_*"};
+	struct rte_graph_param gconf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = 1,
+		.node_patterns = patterns,
+		.model = RTE_GRAPH_MODEL_DISPATCH,
+	};
+	struct rte_graph_cluster_stats_param s_param;
+	struct rte_graph_cluster_stats *stats;
+	char clone_name[RTE_GRAPH_NAMESIZE];
+	const char *pattern = "dispatch";
+	struct rte_graph *graph, *clone;
+	int i, stats_rc = 0, rc = -1;
+	rte_node_t worker;
+	rte_graph_t id;
+
+	dispatch_lcore = rte_get_next_lcore(-1, 1, 0);
+	if (dispatch_lcore >= RTE_MAX_LCORE) {
+		printf("No worker lcore, skipping dispatch test\n");
+		return TEST_SKIPPED;
+	}
+
+	worker = rte_node_from_name("test_dispatch_worker");
+	if (rte_node_lcore_affinity_set(worker, dispatch_lcore)) {
+		printf("Failed to affine node to lcore %u\n", dispatch_lcore);
+		return -1;
+	}
+
+	id = rte_graph_create("dispatch", &gconf);
+	if (id == RTE_GRAPH_ID_INVALID) {
+		printf("Dispatch graph creation failed with error = %d\n",
+		       rte_errno);
+		goto affinity_reset;
+	}
+
+	/* Main lcore walks the graph itself, worker lcore walks its clone */
+	snprintf(clone_name, sizeof(clone_name), "dispatch-%u", dispatch_lcore);
+	graph = rte_graph_lcore_lookup("dispatch", rte_lcore_id());
+	clone = rte_graph_lcore_lookup("dispatch", dispatch_lcore);
+	if (graph == NULL || graph != rte_graph_lookup("dispatch") ||
+	    clone == NULL || clone != rte_graph_lookup(clone_name)) {
+		printf("Dispatch graph lookup failed\n");
+		goto graph_destroy;
+	}
+
+	if (rte_graph_destroy(rte_graph_from_name(clone_name)) != -EPERM) {
+		printf("Graph clone destroyed without its parent\n");
+		goto graph_destroy;
+	}
+
+	if (rte_node_lcore_affinity_set(worker, RTE_MAX_LCORE) != -EBUSY) {
+		printf("Affinity of a node in use changed\n");
+		goto graph_destroy;
+	}
+
+	memset(dispatch_objs, 0, sizeof(dispatch_objs));
+	dispatch_bad_lcore = 0;
+	for (i = 0; i < DISPATCH_WALKS; i++) {
+		rte_graph_walk(graph);
+		rte_eal_remote_launch(graph_dispatch_walk, clone,
+				      dispatch_lcore);
+		rte_eal_wait_lcore(dispatch_lcore);
+	}
+
+	for (i = 0; i < DISPATCH_NODES; i++) {
+		if (dispatch_objs[i] != DISPATCH_WALKS * RTE_GRAPH_BURST_SIZE) {
+			printf("Node %s processed %"PRIu64" objs, expected %d\n",
+			       dispatch_node_names[i], dispatch_objs[i],
+			       DISPATCH_WALKS * RTE_GRAPH_BURST_SIZE);
+			goto graph_destroy;
+		}
+	}
+
+	if (dispatch_bad_lcore) {
+		printf("Nodes ran %"PRIu64" times on the wrong lcore\n",
+		       dispatch_bad_lcore);
+		goto graph_destroy;
+	}
+
+	if (rte_graph_has_stats_feature()) {
+		/* Stats of the clone are aggregated with the parent ones */
+		memset(&s_param, 0, sizeof(s_param));
+		s_param.socket_id = SOCKET_ID_ANY;
+		s_param.graph_patterns = &pattern;
+		s_param.nb_graph_patterns = 1;
+		s_param.fn = graph_dispatch_stats_cb;
+		s_param.cookie = &stats_rc;
+
+		stats = rte_graph_cluster_stats_create(&s_param);
+		if (stats == NULL) {
+			printf("Unable to get dispatch stats\n");
+			goto graph_destroy;
+		}
+		rte_graph_cluster_stats_get(stats, 0);
+		rte_graph_cluster_stats_destroy(stats);
+		if (stats_rc)
+			goto graph_destroy;
+	}
+
+	rc = 0;
+graph_destroy:
+	if (rte_graph_destroy(id)) {
+		printf("Dispatch graph destroy failed\n");
+		rc = -1;
+	}
+	if (rte_graph_from_name(clone_name) != RTE_GRAPH_ID_INVALID) {
+		printf("Dispatch graph clone not destroyed\n");
+		rc = -1;
+	}
+affinity_reset:
+	rte_node_lcore_affinity_set(worker, RTE_MAX_LCORE);
+	return rc;
+}
+
+static int
+test_graph_profile(void)
+{
+	static const char *patterns[] = {"test_profile_*"};
+	struct rte_graph_param gconf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = 1,
+		.node_patterns = patterns,
+	};
+	struct rte_graph_pkt_trace_record *recs = NULL;
+	const int walk_samples = RTE_GRAPH_BURST_SIZE / PROFILE_SAMPLE_RATE;
+	const int nb_samples = PROFILE_WALKS * walk_samples;
+	const int burst_bucket = rte_fls_u32(RTE_GRAPH_BURST_SIZE / 2);
+	rte_node_t source_id, worker_id, sink_id;
+	int i, n, via_worker = 0, rc = -1;
+	struct rte_graph *graph;
+	struct rte_node *worker;
+	uint64_t calls = 0;
+	uint64_t last_seq;
+	rte_graph_t id;
+
+	if (!rte_graph_has_stats_feature())
+		return TEST_SKIPPED;
+
+	id = rte_graph_create("profile", &gconf);
+	if (id == RTE_GRAPH_ID_INVALID) {
+		printf("Profile graph creation failed with error = %d\n",
+		       rte_errno);
+		return -1;
+	}
+
+	graph = rte_graph_lookup("profile");
+	worker = rte_graph_node_get_by_name("profile", "test_profile_worker");
+	source_id = rte_node_from_name("test_profile_source");
+	worker_id = rte_node_from_name("test_profile_worker");
+	sink_id = rte_node_from_name("test_profile_sink");
+	recs = malloc(sizeof(*recs) * RTE_GRAPH_PKT_TRACE_RECORDS);
+	if (graph == NULL || worker == NULL || recs == NULL) {
+		printf("Profile graph setup failed\n");
+		goto graph_destroy;
+	}
+
+	if (rte_graph_node_hist_enable(id) ||
+	    rte_graph_pkt_trace_enable(id, PROFILE_SAMPLE_RATE)) {
+		printf("Failed to enable profiling\n");
+		goto graph_destroy;
+	}
+
+	for (i = 0; i < PROFILE_WALKS; i++)
+		rte_graph_walk(graph);
+
+	/* Each call of the worker processes half a burst */
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++)
+		calls += worker->hist_objs[i];
+	if (calls != PROFILE_WALKS ||
+	    worker->hist_objs[burst_bucket] != PROFILE_WALKS) {
+		printf("Worker objs histogram has %"PRIu64" calls, expected %d in bucket %d\n",
+		       calls, PROFILE_WALKS, burst_bucket);
+		goto graph_destroy;
+	}
+
+	/* The sink is fed by the source too, packets are sampled once */
+	n = rte_graph_pkt_trace_records_get(id, recs,
+					    RTE_GRAPH_PKT_TRACE_RECORDS);
+	if (n != nb_samples) {
+		printf("Got %d packet traces, expected %d\n", n, nb_samples);
+		goto graph_destroy;
+	}
+
+	/* Sampled at the source output, then seen by the sink */
+	for (i = 0; i < n; i++) {
+		if (recs[i].nb_hops == 3 &&
+		    recs[i].hops[1].node == worker_id)
+			via_worker++;
+		else if (recs[i].nb_hops != 2)
+			break;
+		if (recs[i].hops[0].node != source_id ||
+		    recs[i].hops[recs[i].nb_hops - 1].node != sink_id ||
+		    recs[i].hops[recs[i].nb_hops - 1].tsc <
+		    recs[i].hops[0].tsc)
+			break;
+	}
+	if (i != n || via_worker != nb_samples / 2) {
+		printf("Packet trace %"PRIu64" is invalid\n",
+		       i < n ? recs[i].seq : 0);
+		goto graph_destroy;
+	}
+	last_seq = recs[n - 1].seq;
+
+	if (rte_graph_node_hist_disable(id) ||
+	    rte_graph_pkt_trace_disable(id)) {
+		printf("Failed to disable profiling\n");
+		goto graph_destroy;
+	}
+
+	/* Nothing is collected once disabled */
+	rte_graph_walk(graph);
+	if (worker->hist_objs[burst_bucket] != PROFILE_WALKS ||
+	    rte_graph_pkt_trace_records_get(id, recs,
+			RTE_GRAPH_PKT_TRACE_RECORDS) != nb_samples) {
+		printf("Profiling still collected once disabled\n");
+		goto graph_destroy;
+	}
+
+	/* Records start over when enabled again, sequence numbers do not */
+	if (rte_graph_pkt_trace_enable(id, PROFILE_SAMPLE_RATE)) {
+		printf("Failed to enable packet tracer again\n");
+		goto graph_destroy;
+	}
+	rte_graph_walk(graph);
+	n = rte_graph_pkt_trace_records_get(id, recs,
+					    RTE_GRAPH_PKT_TRACE_RECORDS);
+	if (n != walk_samples || recs[0].seq <= last_seq) {
+		printf("Packet tracer not restarted, %d traces from seq %"PRIu64"\n",
+		       n, n > 0 ? recs[0].seq : 0);
+		goto graph_destroy;
+	}
+
+	rc = 0;
+graph_destroy:
+	free(recs);
+	if (rte_graph_destroy(id)) {
+		printf("Profile graph destroy failed\n");
+		rc = -1;
+	}
+	return rc;
+}
+
+/*
+ * Packets to 2001:db8::/32 are routed to the rewrite edge, packets to
+ * 2001:db8:1::/48 to the drop edge, and packets matching no route are
+ * dropped too.
+ */
+static int
+ip6_pkts_alloc(struct rte_mempool *mp)
+{
+	static const uint8_t dst[][RTE_LPM6_IPV6_ADDR_SIZE] = {
+		{0x20, 0x01, 0x0d, 0xb8, [15] = 1},
+		{0x20, 0x01, 0x0d, 0xb8, 0x00, 0x01, [15] = 1},
+		{0x20, 0x02, [15] = 1},
+	};
+	struct rte_ipv6_hdr *ip6;
+	unsigned int i;
+	char *data;
+
+	if (rte_pktmbuf_alloc_bulk(mp, ip6_pkts, IP6_PKTS) != 0)
+		return -1;
+	ip6_nb_pkts = IP6_PKTS;
+
+	for (i = 0; i < IP6_PKTS; i++) {
+		data = rte_pktmbuf_append(ip6_pkts[i],
+					  sizeof(struct rte_ether_hdr) +
+					  sizeof(*ip6));
+		if (data == NULL)
+			return -1;
+		memset(data, 0, sizeof(struct rte_ether_hdr) + sizeof(*ip6));
+		ip6 = (struct rte_ipv6_hdr *)
+			(data + sizeof(struct rte_ether_hdr));
+		ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ip6->proto = IPPROTO_UDP;
+		ip6->hop_limits = 64;
+		memcpy(ip6->dst_addr, dst[i % RTE_DIM(dst)],
+		       sizeof(ip6->dst_addr));
+	}
+
+	return 0;
+}
+
+static int
+test_ip6_lookup(void)
+{
+	static const uint8_t rewrite_prefix[RTE_LPM6_IPV6_ADDR_SIZE] = {
+		0x20, 0x01, 0x0d, 0xb8,
+	};
+	static const uint8_t drop_prefix[RTE_LPM6_IPV6_ADDR_SIZE] = {
+		0x20, 0x01, 0x0d, 0xb8, 0x00, 0x01,
+	};
+	static const char *patterns[] = {"test_ip6_*"};
+	struct rte_graph_param gconf = {
+		.socket_id = rte_socket_id(),
+		.nb_node_patterns = 1,
+		.node_patterns = patterns,
+	};
+	const uint64_t nb_rewrite = (IP6_PKTS + 2) / 3;
+	struct rte_mempool *mp;
+	struct rte_graph *graph;
+	rte_node_t lookup;
+	int rc = -1;
+	rte_graph_t id;
+
+	lookup = rte_node_from_name("ip6_lookup");
+	if (rte_node_is_invalid(lookup))
+		return TEST_SKIPPED;
+
+	mp = rte_pktmbuf_pool_create("test_ip6_lookup", 2 * IP6_PKTS, 0, 0,
+				     RTE_MBUF_DEFAULT_BUF_SIZE,
+				     rte_socket_id());
+	if (mp == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return -1;
+	}
+
+	/* Collect the lookup results in the test sinks */
+	if (rte_node_edge_update(lookup, 0, ip6_sink_names,
+				 RTE_NODE_IP6_LOOKUP_NEXT_MAX) !=
+	    RTE_NODE_IP6_LOOKUP_NEXT_MAX) {
+		printf("Failed to update ip6_lookup edges\n");
+		goto pool_free;
+	}
+
+	id = rte_graph_create("ip6_lookup", &gconf);
+	if (id == RTE_GRAPH_ID_INVALID) {
+		printf("IPv6 lookup graph creation failed with error = %d\n",
+		       rte_errno);
+		goto edges_reset;
+	}
+
+	/* The LPM tables are created by the node init */
+	if (rte_node_ip6_route_add(rewrite_prefix, 32, IP6_REWRITE_NH,
+				   RTE_NODE_IP6_LOOKUP_NEXT_REWRITE) < 0 ||
+	    rte_node_ip6_route_add(drop_prefix, 48, IP6_DROP_NH,
+				   RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP) < 0) {
+		printf("Failed to add IPv6 routes\n");
+		goto graph_destroy;
+	}
+
+	ip6_priv1_offset = rte_mbuf_dynfield_lookup("rte_node_dynfield_priv1",
+						    NULL);
+	if (ip6_priv1_offset < 0 || ip6_pkts_alloc(mp) < 0) {
+		printf("Failed to set up IPv6 packets\n");
+		goto graph_destroy;
+	}
+
+	memset(ip6_objs, 0, sizeof(ip6_objs));
+	ip6_bad_nh = 0;
+	graph = rte_graph_lookup("ip6_lookup");
+	rte_graph_walk(graph);
+	rte_graph_walk(graph);
+
+	if (ip6_objs[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE] != nb_rewrite ||
+	    ip6_objs[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP] !=
+	    IP6_PKTS - nb_rewrite) {
+		printf("Routed %"PRIu64" packets to rewrite and %"PRIu64" to drop, expected %"PRIu64" and %"PRIu64"\n",
+		       ip6_objs[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE],
+		       ip6_objs[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP],
+		       nb_rewrite, IP6_PKTS - nb_rewrite);
+		goto graph_destroy;
+	}
+
+	if (ip6_bad_nh) {
+		printf("%"PRIu64" packets routed with a wrong next hop\n",
+		       ip6_bad_nh);
+		goto graph_destroy;
+	}
+
+	rc = 0;
+graph_destroy:
+	/* Packets not sent are still owned by the source */
+	rte_pktmbuf_free_bulk(ip6_pkts, ip6_nb_pkts);
+	ip6_nb_pkts = 0;
+	if (rte_graph_destroy(id)) {
+		printf("IPv6 lookup graph destroy failed\n");
+		rc = -1;
+	}
+edges_reset:
+	rte_node_edge_update(lookup, 0, ip6_lookup_edges,
+			     RTE_NODE_IP6_LOOKUP_NEXT_MAX);
+pool_free:
+	rte_mempool_free(mp);
+	return rc;
+}
+
 static int
 graph_setup(void)
 {
@@ -840,6 +1518,9 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
 		TEST_CASE(test_print_stats),
+		TEST_CASE(test_graph_dispatch),
+		TEST_CASE(test_graph_profile),
+		TEST_CASE(test_ip6_lookup),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
@@ -572,6 +572,7 @@ graph_init(const char *gname, uint8_t nb_srcs, uint8_t nb_sinks,
 	}
 
 	/* Create a Graph */
+	memset(&gconf, 0, sizeof(gconf));
 	gconf.socket_id = SOCKET_ID_ANY;
 	gconf.nb_node_patterns = graph_data->nb_nodes;
 	gconf.node_patterns = (const char **)(uintptr_t)node_patterns;
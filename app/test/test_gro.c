@@ -0,0 +1,600 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_gro.h>
+#include <rte_gso.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+
+#include "test.h"
+
+#define NB_MBUF 512
+#define NB_PKTS 8
+#define PAYLOAD_LEN 100
+#define SEQ_BASE 1000
+#define EXT_HDR_LEN 8
+#define UDP6_NB_FRAGS 4
+#define UDP6_FRAG_LEN 200
+
+#define TCP6_HDR_LEN(ext) (sizeof(struct rte_ether_hdr) + \
+		sizeof(struct rte_ipv6_hdr) + ((ext) ? EXT_HDR_LEN : 0) + \
+		sizeof(struct rte_tcp_hdr))
+#define TCP6_PKT_LEN(ext) (TCP6_HDR_LEN(ext) + PAYLOAD_LEN)
+#define UDP6_HDR_LEN (sizeof(struct rte_ether_hdr) + \
+		sizeof(struct rte_ipv6_hdr) + sizeof(struct rte_udp_hdr))
+#define VXLAN_OUTER_LEN (sizeof(struct rte_ether_hdr) + \
+		sizeof(struct rte_ipv4_hdr) + sizeof(struct rte_udp_hdr) + \
+		sizeof(struct rte_vxlan_hdr))
+
+static struct rte_mempool *pkt_pool;
+
+/*
+ * Writes an Ethernet/IPv6/TCP packet of the flow, with a hop-by-hop
+ * extension header if ext is set, carrying len bytes of the TCP stream
+ * from offset off. A stream byte is its offset modulo 256.
+ */
+static void
+build_tcp6(char *p, uint16_t flow, uint32_t off, uint16_t len, int ext)
+{
+	struct rte_ether_hdr *eth = (struct rte_ether_hdr *)p;
+	struct rte_ipv6_hdr *ip6 = (struct rte_ipv6_hdr *)(eth + 1);
+	struct rte_tcp_hdr *tcp;
+	uint8_t *payload;
+	uint16_t l3_len;
+	uint32_t i;
+
+	l3_len = sizeof(*ip6) + (ext ? EXT_HDR_LEN : 0);
+
+	memset(p, 0, sizeof(*eth) + l3_len + sizeof(*tcp));
+	memset(&eth->dst_addr, 0x02, sizeof(eth->dst_addr));
+	memset(&eth->src_addr, 0x04, sizeof(eth->src_addr));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+
+	ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip6->payload_len = rte_cpu_to_be_16(l3_len - sizeof(*ip6) +
+			sizeof(*tcp) + len);
+	ip6->hop_limits = 64;
+	ip6->src_addr[15] = 1;
+	ip6->dst_addr[15] = 2;
+	if (ext) {
+		/* empty hop-by-hop options header */
+		ip6->proto = IPPROTO_HOPOPTS;
+		((uint8_t *)(ip6 + 1))[0] = IPPROTO_TCP;
+	} else {
+		ip6->proto = IPPROTO_TCP;
+	}
+
+	tcp = (struct rte_tcp_hdr *)((char *)ip6 + l3_len);
+	tcp->src_port = rte_cpu_to_be_16(1024 + flow);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(SEQ_BASE + off);
+	tcp->recv_ack = rte_cpu_to_be_32(1);
+	tcp->data_off = (sizeof(*tcp) / 4) << 4;
+	tcp->tcp_flags = RTE_TCP_ACK_FLAG;
+	tcp->rx_win = rte_cpu_to_be_16(0xffff);
+
+	payload = (uint8_t *)(tcp + 1);
+	for (i = 0; i < len; i++)
+		payload[i] = off + i;
+}
+
+/* Writes the outer Ethernet/IPv4/UDP/VxLAN headers of an inner packet */
+static void
+build_vxlan(char *p, uint16_t inner_len)
+{
+	struct rte_ether_hdr *eth = (struct rte_ether_hdr *)p;
+	struct rte_ipv4_hdr *ip = (struct rte_ipv4_hdr *)(eth + 1);
+	struct rte_udp_hdr *udp = (struct rte_udp_hdr *)(ip + 1);
+	struct rte_vxlan_hdr *vxlan = (struct rte_vxlan_hdr *)(udp + 1);
+
+	memset(p, 0, sizeof(*eth) + sizeof(*ip) + sizeof(*udp) +
+			sizeof(*vxlan));
+	memset(&eth->dst_addr, 0x06, sizeof(eth->dst_addr));
+	memset(&eth->src_addr, 0x08, sizeof(eth->src_addr));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + sizeof(*udp) +
+			sizeof(*vxlan) + inner_len);
+	ip->fragment_offset = rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2));
+
+	udp->src_port = rte_cpu_to_be_16(5000);
+	udp->dst_port = rte_cpu_to_be_16(RTE_VXLAN_DEFAULT_PORT);
+	udp->dgram_len = rte_cpu_to_be_16(sizeof(*udp) + sizeof(*vxlan) +
+			inner_len);
+
+	vxlan->vx_flags = rte_cpu_to_be_32(0x08000000);
+	vxlan->vx_vni = rte_cpu_to_be_32(42 << 8);
+}
+
+static struct rte_mbuf *
+make_pkt(uint16_t flow, uint32_t off, uint16_t len, int ext, int vxlan)
+{
+	struct rte_mbuf *m;
+	uint16_t outer_len = 0;
+	uint16_t inner_len;
+	char *p;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	if (vxlan)
+		outer_len = VXLAN_OUTER_LEN;
+	inner_len = TCP6_HDR_LEN(ext) + len;
+	p = rte_pktmbuf_append(m, outer_len + inner_len);
+	if (p == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+
+	build_tcp6(p + outer_len, flow, off, len, ext);
+	m->l2_len = sizeof(struct rte_ether_hdr);
+	m->l3_len = sizeof(struct rte_ipv6_hdr) + (ext ? EXT_HDR_LEN : 0);
+	m->l4_len = sizeof(struct rte_tcp_hdr);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L4_TCP |
+		(ext ? RTE_PTYPE_L3_IPV6_EXT : RTE_PTYPE_L3_IPV6);
+
+	if (vxlan) {
+		build_vxlan(p, inner_len);
+		m->outer_l2_len = sizeof(struct rte_ether_hdr);
+		m->outer_l3_len = sizeof(struct rte_ipv4_hdr);
+		m->l2_len += sizeof(struct rte_udp_hdr) +
+			sizeof(struct rte_vxlan_hdr);
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+			RTE_PTYPE_L4_UDP | RTE_PTYPE_TUNNEL_VXLAN |
+			RTE_PTYPE_INNER_L2_ETHER | RTE_PTYPE_INNER_L4_TCP |
+			(ext ? RTE_PTYPE_INNER_L3_IPV6_EXT :
+			 RTE_PTYPE_INNER_L3_IPV6);
+	}
+
+	return m;
+}
+
+/* Makes an Ethernet/IPv6/UDP datagram of len payload bytes */
+static struct rte_mbuf *
+make_udp6(uint16_t len)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_udp_hdr *udp;
+	struct rte_mbuf *m;
+	uint8_t *payload;
+	uint32_t i;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+			UDP6_HDR_LEN + len);
+	if (eth == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	ip6 = (struct rte_ipv6_hdr *)(eth + 1);
+	udp = (struct rte_udp_hdr *)(ip6 + 1);
+
+	memset(eth, 0, UDP6_HDR_LEN);
+	memset(&eth->dst_addr, 0x02, sizeof(eth->dst_addr));
+	memset(&eth->src_addr, 0x04, sizeof(eth->src_addr));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+
+	ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip6->payload_len = rte_cpu_to_be_16(sizeof(*udp) + len);
+	ip6->proto = IPPROTO_UDP;
+	ip6->hop_limits = 64;
+	ip6->src_addr[15] = 1;
+	ip6->dst_addr[15] = 2;
+
+	udp->src_port = rte_cpu_to_be_16(1024);
+	udp->dst_port = rte_cpu_to_be_16(4789);
+	udp->dgram_len = rte_cpu_to_be_16(sizeof(*udp) + len);
+
+	payload = (uint8_t *)(udp + 1);
+	for (i = 0; i < len; i++)
+		payload[i] = i;
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip6);
+	m->l4_len = sizeof(*udp);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6 |
+		RTE_PTYPE_L4_UDP;
+
+	return m;
+}
+
+/*
+ * Checks that a packet of the flow holds len bytes of the TCP stream
+ * from offset off, and that its length fields are updated.
+ */
+static int
+check_tcp6(struct rte_mbuf *m, uint16_t flow, uint32_t off, uint32_t len,
+		int vxlan)
+{
+	uint8_t payload[NB_PKTS * PAYLOAD_LEN];
+	const struct rte_ipv4_hdr *ip;
+	const struct rte_ipv6_hdr *ip6;
+	const struct rte_udp_hdr *udp;
+	const struct rte_tcp_hdr *tcp;
+	const uint8_t *data;
+	uint16_t outer_len = 0;
+	uint32_t i;
+
+	if (vxlan)
+		outer_len = VXLAN_OUTER_LEN;
+
+	TEST_ASSERT_EQUAL(m->pkt_len, outer_len + TCP6_HDR_LEN(0) + len,
+			"Wrong packet length");
+
+	ip6 = rte_pktmbuf_mtod_offset(m, const struct rte_ipv6_hdr *,
+			outer_len + sizeof(struct rte_ether_hdr));
+	tcp = (const struct rte_tcp_hdr *)(ip6 + 1);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip6->payload_len),
+			sizeof(*tcp) + len, "Wrong IPv6 payload length");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(tcp->src_port), 1024 + flow,
+			"Wrong flow");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_32(tcp->sent_seq), SEQ_BASE + off,
+			"Wrong TCP sequence number");
+
+	if (vxlan) {
+		ip = rte_pktmbuf_mtod_offset(m, const struct rte_ipv4_hdr *,
+				sizeof(struct rte_ether_hdr));
+		udp = (const struct rte_udp_hdr *)(ip + 1);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length),
+				m->pkt_len - sizeof(struct rte_ether_hdr),
+				"Wrong outer IPv4 length");
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(udp->dgram_len),
+				m->pkt_len - sizeof(struct rte_ether_hdr) -
+				sizeof(*ip), "Wrong outer UDP length");
+	}
+
+	data = rte_pktmbuf_read(m, m->pkt_len - len, len, payload);
+	TEST_ASSERT_NOT_NULL(data, "Cannot read payload");
+	for (i = 0; i < len; i++)
+		TEST_ASSERT_EQUAL(data[i], (uint8_t)(off + i),
+				"Wrong payload byte %u", i);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Checks that a packet holds nb_segs consecutive payloads of the flow
+ * starting at stream offset 0, and that its length fields are updated.
+ */
+static int
+check_pkt(struct rte_mbuf *m, uint16_t flow, uint16_t nb_segs, int vxlan)
+{
+	TEST_ASSERT_EQUAL(m->nb_segs, nb_segs, "Wrong number of segments");
+
+	return check_tcp6(m, flow, 0, nb_segs * PAYLOAD_LEN, vxlan);
+}
+
+/*
+ * Merges two interleaved flows, the second one received in reverse
+ * order, and checks that each flow is merged into a single packet.
+ */
+static int
+test_gro_merge(int vxlan)
+{
+	struct rte_gro_param param = {
+		.gro_types = vxlan ? RTE_GRO_IPV4_VXLAN_TCP_IPV6 :
+			RTE_GRO_TCP_IPV6,
+		.max_flow_num = 4,
+		.max_item_per_flow = NB_PKTS,
+	};
+	struct rte_mbuf *pkts[2 * NB_PKTS];
+	uint16_t nb_pkts;
+	uint32_t i;
+	int ret = TEST_SUCCESS;
+
+	for (i = 0; i < NB_PKTS; i++) {
+		pkts[2 * i] = make_pkt(0, i * PAYLOAD_LEN, PAYLOAD_LEN, 0,
+				vxlan);
+		pkts[2 * i + 1] = make_pkt(1, (NB_PKTS - 1 - i) * PAYLOAD_LEN,
+				PAYLOAD_LEN, 0, vxlan);
+		if (pkts[2 * i] == NULL || pkts[2 * i + 1] == NULL) {
+			rte_pktmbuf_free(pkts[2 * i]);
+			rte_pktmbuf_free(pkts[2 * i + 1]);
+			rte_pktmbuf_free_bulk(pkts, 2 * i);
+			return TEST_FAILED;
+		}
+	}
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, 2 * NB_PKTS, &param);
+	if (nb_pkts != 2) {
+		printf("%u packets after GRO, expected 2\n", nb_pkts);
+		ret = TEST_FAILED;
+	}
+
+	/* the flows are flushed in the order they were inserted */
+	for (i = 0; i < nb_pkts && ret == TEST_SUCCESS; i++)
+		ret = check_pkt(pkts[i], i, NB_PKTS, vxlan);
+
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+	return ret;
+}
+
+/*
+ * Packets with IPv6 extension headers must be left unchanged, since
+ * the extension headers are not part of the flow key.
+ */
+static int
+test_gro_ext_hdr(int vxlan)
+{
+	struct rte_gro_param param = {
+		.gro_types = vxlan ? RTE_GRO_IPV4_VXLAN_TCP_IPV6 :
+			RTE_GRO_TCP_IPV6,
+		.max_flow_num = 4,
+		.max_item_per_flow = NB_PKTS,
+	};
+	struct rte_mbuf *pkts[NB_PKTS];
+	uint16_t nb_pkts;
+	uint32_t i;
+	int ret = TEST_SUCCESS;
+
+	for (i = 0; i < NB_PKTS; i++) {
+		pkts[i] = make_pkt(0, i * PAYLOAD_LEN, PAYLOAD_LEN, 1, vxlan);
+		if (pkts[i] == NULL) {
+			rte_pktmbuf_free_bulk(pkts, i);
+			return TEST_FAILED;
+		}
+	}
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, NB_PKTS, &param);
+	if (nb_pkts != NB_PKTS) {
+		printf("%u packets after GRO, expected %u\n", nb_pkts,
+				NB_PKTS);
+		ret = TEST_FAILED;
+	}
+
+	for (i = 0; i < nb_pkts && ret == TEST_SUCCESS; i++)
+		if (pkts[i]->nb_segs != 1 ||
+				pkts[i]->pkt_len != (vxlan ? VXLAN_OUTER_LEN :
+					0) + TCP6_PKT_LEN(1)) {
+			printf("Packet %u was merged\n", i);
+			ret = TEST_FAILED;
+		}
+
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+	return ret;
+}
+
+/*
+ * Segments a packet of NB_PKTS payloads with GSO and checks each
+ * segment, then merges the segments back into one packet with GRO.
+ */
+static int
+test_gso_gro(int vxlan)
+{
+	struct rte_gso_ctx gso_ctx = {
+		.direct_pool = pkt_pool,
+		.indirect_pool = pkt_pool,
+		.gso_types = vxlan ? RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO :
+			RTE_ETH_TX_OFFLOAD_TCP_TSO,
+		.gso_size = (vxlan ? VXLAN_OUTER_LEN : 0) + TCP6_PKT_LEN(0),
+	};
+	struct rte_gro_param param = {
+		.gro_types = vxlan ? RTE_GRO_IPV4_VXLAN_TCP_IPV6 :
+			RTE_GRO_TCP_IPV6,
+		.max_flow_num = 4,
+		.max_item_per_flow = NB_PKTS,
+	};
+	struct rte_mbuf *segs[NB_PKTS];
+	struct rte_mbuf *m;
+	uint16_t nb_pkts;
+	int nb_segs, i;
+	int ret = TEST_SUCCESS;
+
+	m = make_pkt(0, 0, NB_PKTS * PAYLOAD_LEN, 0, vxlan);
+	if (m == NULL)
+		return TEST_FAILED;
+	m->ol_flags |= RTE_MBUF_F_TX_IPV6 | RTE_MBUF_F_TX_TCP_SEG;
+	if (vxlan)
+		m->ol_flags |= RTE_MBUF_F_TX_OUTER_IPV4 |
+			RTE_MBUF_F_TX_TUNNEL_VXLAN;
+
+	nb_segs = rte_gso_segment(m, &gso_ctx, segs, NB_PKTS);
+	/* the segments keep a reference to the input packet */
+	rte_pktmbuf_free(m);
+	if (nb_segs != NB_PKTS) {
+		printf("%d segments after GSO, expected %u\n", nb_segs,
+				NB_PKTS);
+		if (nb_segs > 0)
+			rte_pktmbuf_free_bulk(segs, nb_segs);
+		return TEST_FAILED;
+	}
+
+	for (i = 0; i < nb_segs && ret == TEST_SUCCESS; i++)
+		ret = check_tcp6(segs[i], 0, i * PAYLOAD_LEN, PAYLOAD_LEN,
+				vxlan);
+	if (ret != TEST_SUCCESS) {
+		rte_pktmbuf_free_bulk(segs, nb_segs);
+		return ret;
+	}
+
+	nb_pkts = rte_gro_reassemble_burst(segs, nb_segs, &param);
+	if (nb_pkts != 1) {
+		printf("%u packets after GRO, expected 1\n", nb_pkts);
+		ret = TEST_FAILED;
+	} else {
+		ret = check_tcp6(segs[0], 0, 0, NB_PKTS * PAYLOAD_LEN, vxlan);
+	}
+
+	rte_pktmbuf_free_bulk(segs, nb_pkts);
+	return ret;
+}
+
+/*
+ * Fragments a UDP/IPv6 datagram of UDP6_NB_FRAGS times UDP6_FRAG_LEN
+ * bytes with GSO, and checks the fragment header and data of each
+ * fragment.
+ */
+static int
+test_gso_udp6(void)
+{
+	struct rte_gso_ctx gso_ctx = {
+		.direct_pool = pkt_pool,
+		.indirect_pool = pkt_pool,
+		.gso_types = RTE_ETH_TX_OFFLOAD_UDP_TSO,
+		.gso_size = UDP6_HDR_LEN - sizeof(struct rte_udp_hdr) +
+			RTE_IPV6_FRAG_HDR_SIZE + UDP6_FRAG_LEN,
+	};
+	const uint16_t l3_off = sizeof(struct rte_ether_hdr);
+	const uint16_t data_off = l3_off + sizeof(struct rte_ipv6_hdr);
+	const struct rte_ipv6_fragment_ext *frag;
+	struct rte_mbuf *segs[UDP6_NB_FRAGS];
+	uint8_t buf[UDP6_FRAG_LEN];
+	const struct rte_ipv6_hdr *ip6;
+	const uint8_t *data;
+	struct rte_mbuf *m;
+	uint16_t frag_data;
+	rte_be32_t id = 0;
+	int nb_segs, i;
+	int ret = TEST_FAILED;
+
+	m = make_udp6(UDP6_NB_FRAGS * UDP6_FRAG_LEN -
+			sizeof(struct rte_udp_hdr));
+	if (m == NULL)
+		return TEST_FAILED;
+	m->ol_flags |= RTE_MBUF_F_TX_IPV6 | RTE_MBUF_F_TX_UDP_SEG;
+
+	nb_segs = rte_gso_segment(m, &gso_ctx, segs, UDP6_NB_FRAGS);
+	if (nb_segs != UDP6_NB_FRAGS) {
+		printf("%d fragments after GSO, expected %u\n", nb_segs,
+				UDP6_NB_FRAGS);
+		goto out;
+	}
+
+	for (i = 0; i < nb_segs; i++) {
+		ip6 = rte_pktmbuf_mtod_offset(segs[i],
+				const struct rte_ipv6_hdr *, l3_off);
+		frag = (const struct rte_ipv6_fragment_ext *)(ip6 + 1);
+		frag_data = rte_be_to_cpu_16(frag->frag_data);
+		if (i == 0)
+			id = frag->id;
+		data = rte_pktmbuf_read(segs[i],
+				data_off + RTE_IPV6_FRAG_HDR_SIZE,
+				UDP6_FRAG_LEN, buf);
+
+		if (segs[i]->pkt_len != gso_ctx.gso_size ||
+				rte_be_to_cpu_16(ip6->payload_len) !=
+				RTE_IPV6_FRAG_HDR_SIZE + UDP6_FRAG_LEN ||
+				ip6->proto != IPPROTO_FRAGMENT ||
+				frag->next_header != IPPROTO_UDP) {
+			printf("Wrong headers in fragment %d\n", i);
+			goto out;
+		}
+		if ((frag_data & RTE_IPV6_EHDR_FO_MASK) != i * UDP6_FRAG_LEN ||
+				RTE_IPV6_GET_MF(frag_data) != (i < nb_segs - 1) ||
+				frag->id != id) {
+			printf("Wrong fragment header in fragment %d\n", i);
+			goto out;
+		}
+		if (data == NULL || memcmp(data, rte_pktmbuf_mtod_offset(m,
+				const uint8_t *, data_off + i * UDP6_FRAG_LEN),
+				UDP6_FRAG_LEN) != 0) {
+			printf("Wrong data in fragment %d\n", i);
+			goto out;
+		}
+	}
+
+	ret = TEST_SUCCESS;
+out:
+	if (nb_segs > 0)
+		rte_pktmbuf_free_bulk(segs, nb_segs);
+	rte_pktmbuf_free(m);
+	return ret;
+}
+
+static int
+test_gro_tcp6(void)
+{
+	return test_gro_merge(0);
+}
+
+static int
+test_gro_tcp6_ext_hdr(void)
+{
+	return test_gro_ext_hdr(0);
+}
+
+static int
+test_gro_vxlan_tcp6(void)
+{
+	return test_gro_merge(1);
+}
+
+static int
+test_gro_vxlan_tcp6_ext_hdr(void)
+{
+	return test_gro_ext_hdr(1);
+}
+
+static int
+test_gso_gro_tcp6(void)
+{
+	return test_gso_gro(0);
+}
+
+static int
+test_gso_gro_vxlan_tcp6(void)
+{
+	return test_gso_gro(1);
+}
+
+static int
+test_gro_setup(void)
+{
+	pkt_pool = rte_pktmbuf_pool_create("test_gro_pool", NB_MBUF, 0, 0,
+			RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (pkt_pool == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+test_gro_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+static struct unit_test_suite gro_tests = {
+	.suite_name = "gro autotest",
+	.setup = test_gro_setup,
+	.teardown = test_gro_teardown,
+	.unit_test_cases = {
+	TEST_CASE(test_gro_tcp6),
+	TEST_CASE(test_gro_tcp6_ext_hdr),
+	TEST_CASE(test_gro_vxlan_tcp6),
+	TEST_CASE(test_gro_vxlan_tcp6_ext_hdr),
+	TEST_CASE(test_gso_gro_tcp6),
+	TEST_CASE(test_gso_gro_vxlan_tcp6),
+	TEST_CASE(test_gso_udp6),
+	TEST_CASES_END()
+	}
+};
+
+static int
+test_gro(void)
+{
+	return unit_test_suite_runner(&gro_tests);
+}
+
+REGISTER_TEST_COMMAND(gro_autotest, test_gro);
@@ -4,6 +4,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
@@ -1001,6 +1002,349 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * Add and delete keys in bursts, checking the per-key positions against
+ * the ones seen by lookups, including duplicate keys within one burst,
+ * missing keys and a table running out of space.
+ */
+static int test_add_delete_bulk(void)
+{
+	struct rte_hash_parameters params_pseudo_hash = {
+		.name = "test_bulk",
+		.entries = 64,
+		.key_len = sizeof(struct flow_key),
+		.hash_func = pseudo_hash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE |
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY
+	};
+	struct rte_hash *handle;
+	const void *key_array[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t pos[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t expected_pos[RTE_HASH_LOOKUP_BULK_MAX];
+	struct flow_key rand_keys[RTE_HASH_LOOKUP_BULK_MAX + 1];
+	void *ret_data;
+	unsigned int i;
+	int ret;
+
+	memset(rand_keys, 0, sizeof(rand_keys));
+	for (i = 0; i < RTE_DIM(rand_keys); i++) {
+		rand_keys[i].port_dst = i;
+		rand_keys[i].port_src = i + 1;
+	}
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		key_array[i] = &rand_keys[i];
+		data[i] = (void *)((uintptr_t)i + 1);
+	}
+
+	handle = rte_hash_create(&params_pseudo_hash);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* Invalid bursts */
+	ret = rte_hash_add_key_bulk_data(handle, key_array, data, 0, pos);
+	RETURN_IF_ERROR(ret != -EINVAL, "empty burst accepted (ret=%d)", ret);
+	ret = rte_hash_add_key_bulk_data(handle, key_array, data,
+			RTE_HASH_LOOKUP_BULK_MAX + 1, pos);
+	RETURN_IF_ERROR(ret != -EINVAL, "oversized burst accepted (ret=%d)",
+			ret);
+	ret = rte_hash_del_key_bulk(handle, key_array, 0, pos);
+	RETURN_IF_ERROR(ret != -EINVAL, "empty burst accepted (ret=%d)", ret);
+
+	/* All keys share a bucket, so most of them go to the ext table */
+	ret = rte_hash_add_key_bulk_data(handle, key_array, data,
+			RTE_HASH_LOOKUP_BULK_MAX, pos);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX,
+			"failed to add keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		RETURN_IF_ERROR(pos[i] < 0,
+			"failed to add key (pos[%u]=%d)", i, pos[i]);
+		expected_pos[i] = pos[i];
+		ret = rte_hash_lookup_data(handle, key_array[i], &ret_data);
+		RETURN_IF_ERROR(ret != expected_pos[i] || ret_data != data[i],
+			"failed to find key (pos[%u]=%d)", i, ret);
+	}
+
+	/* Update, with the same key twice in the burst: the last one wins */
+	key_array[1] = &rand_keys[0];
+	ret = rte_hash_add_key_bulk_data(handle, key_array, NULL, 2, pos);
+	RETURN_IF_ERROR(ret != 2 || pos[0] != expected_pos[0] ||
+			pos[1] != expected_pos[0],
+			"failed to update keys (pos=%d,%d)", pos[0], pos[1]);
+	ret = rte_hash_lookup_data(handle, key_array[0], &ret_data);
+	RETURN_IF_ERROR(ret != expected_pos[0] || ret_data != NULL,
+			"failed to find updated key (pos=%d)", ret);
+	key_array[1] = &rand_keys[1];
+
+	/* No room left for one more key */
+	key_array[0] = &rand_keys[RTE_HASH_LOOKUP_BULK_MAX];
+	ret = rte_hash_add_key_bulk_data(handle, key_array, NULL, 1, pos);
+	RETURN_IF_ERROR(ret != 0 || pos[0] != -ENOSPC,
+			"added key to a full table (pos=%d)", pos[0]);
+	key_array[0] = &rand_keys[0];
+
+	/* Delete, with a missing key in the burst */
+	key_array[3] = &rand_keys[RTE_HASH_LOOKUP_BULK_MAX];
+	ret = rte_hash_del_key_bulk(handle, key_array,
+			RTE_HASH_LOOKUP_BULK_MAX, pos);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX - 1,
+			"failed to delete keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		if (i == 3) {
+			RETURN_IF_ERROR(pos[i] != -ENOENT,
+				"deleted non-existent key (pos=%d)", pos[i]);
+			continue;
+		}
+		RETURN_IF_ERROR(pos[i] != expected_pos[i],
+			"failed to delete key (pos[%u]=%d)", i, pos[i]);
+		ret = rte_hash_lookup(handle, key_array[i]);
+		RETURN_IF_ERROR(ret != -ENOENT,
+			"found deleted key (pos[%u]=%d)", i, ret);
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != 1,
+			"unexpected key count %d", rte_hash_count(handle));
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+/*
+ * Test the resizable table: grow from 64 entries while adding keys,
+ * with both the configured hash function and caller provided signatures.
+ */
+#define RESIZE_TEST_KEYS 4096
+static int test_resizable(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resizable",
+		.entries = 64,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	struct rte_hash *handle;
+	static uint32_t keys[RESIZE_TEST_KEYS];
+	static int32_t positions[RESIZE_TEST_KEYS];
+	const void *key_array[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	const void *next_key;
+	void *ret_data;
+	uint64_t hit_mask;
+	uint32_t iter = 0;
+	unsigned int i, j;
+	int ret;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		keys[i] = i;
+		ret = rte_hash_add_key_data(handle, &keys[i],
+				(void *)((uintptr_t)i + 1));
+		RETURN_IF_ERROR(ret != 0, "failed to add key %u (ret=%d)", i,
+				ret);
+		positions[i] = rte_hash_lookup(handle, &keys[i]);
+		RETURN_IF_ERROR(positions[i] < 0,
+				"failed to find key %u (ret=%d)", i, positions[i]);
+
+		/* Earlier keys must stay visible while buckets migrate */
+		if ((i & 63) != 63)
+			continue;
+		for (j = 0; j <= i; j++) {
+			ret = rte_hash_lookup_data(handle, &keys[j], &ret_data);
+			RETURN_IF_ERROR(ret != positions[j] ||
+					ret_data != (void *)((uintptr_t)j + 1),
+					"failed to find key %u (ret=%d)", j, ret);
+		}
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != RESIZE_TEST_KEYS,
+			"unexpected key count %d", rte_hash_count(handle));
+	RETURN_IF_ERROR(rte_hash_max_key_id(handle) < RESIZE_TEST_KEYS,
+			"unexpected max key id %d",
+			rte_hash_max_key_id(handle));
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i += RTE_HASH_LOOKUP_BULK_MAX) {
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			key_array[j] = &keys[i + j];
+		ret = rte_hash_lookup_bulk_data(handle, key_array,
+				RTE_HASH_LOOKUP_BULK_MAX, &hit_mask, data);
+		RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX,
+				"bulk lookup missed keys (ret=%d)", ret);
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			RETURN_IF_ERROR(data[j] !=
+					(void *)((uintptr_t)i + j + 1),
+					"wrong data for key %u", i + j);
+	}
+
+	j = 0;
+	while (rte_hash_iterate(handle, &next_key, &ret_data, &iter) >= 0)
+		j++;
+	RETURN_IF_ERROR(j != RESIZE_TEST_KEYS,
+			"iterated over %u keys", j);
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i += 2) {
+		ret = rte_hash_del_key(handle, &keys[i]);
+		RETURN_IF_ERROR(ret != positions[i],
+				"failed to delete key %u (ret=%d)", i, ret);
+	}
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		ret = rte_hash_lookup(handle, &keys[i]);
+		RETURN_IF_ERROR((i & 1) ? ret != positions[i] : ret != -ENOENT,
+				"unexpected lookup of key %u (ret=%d)", i, ret);
+	}
+
+	/* Signatures provided by the caller are kept across migrations */
+	rte_hash_reset(handle);
+	RETURN_IF_ERROR(rte_hash_count(handle) != 0,
+			"unexpected key count %d after reset",
+			rte_hash_count(handle));
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		positions[i] = rte_hash_add_key_with_hash(handle, &keys[i],
+				i * 2654435761u);
+		RETURN_IF_ERROR(positions[i] < 0,
+				"failed to add key %u (ret=%d)", i, positions[i]);
+	}
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		ret = rte_hash_lookup_with_hash(handle, &keys[i],
+				i * 2654435761u);
+		RETURN_IF_ERROR(ret != positions[i],
+				"failed to find key %u (ret=%d)", i, ret);
+	}
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+/*
+ * Test the key expiry: keys with expiry times spread over all the levels
+ * of the timer wheel must be returned once, and only once expired.
+ */
+#define EXPIRY_TEST_KEYS 1024
+#define EXPIRY_TEST_TICK 10
+#define EXPIRY_TEST_START 1000000
+static int test_hash_expiry(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_expiry",
+		.entries = EXPIRY_TEST_KEYS * 2,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+	};
+	struct rte_hash_expiry_config cfg = {
+		.tick = EXPIRY_TEST_TICK,
+		.now = EXPIRY_TEST_START,
+	};
+	static uint32_t keys[EXPIRY_TEST_KEYS];
+	static uint64_t expire[EXPIRY_TEST_KEYS];
+	static int32_t positions[EXPIRY_TEST_KEYS];
+	static uint8_t expired[EXPIRY_TEST_KEYS];
+	const void *ret_keys[8];
+	void *ret_data[8];
+	int32_t ret_pos[8];
+	struct rte_hash *handle;
+	uint64_t now, prev = 0;
+	unsigned int i, k, nb_expired = 0;
+	int ret;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	ret = rte_hash_expiry_set(handle, 0, EXPIRY_TEST_START);
+	RETURN_IF_ERROR(ret != -EINVAL, "expiry set before enable (ret=%d)",
+			ret);
+	ret = rte_hash_expiry_enable(handle, &cfg);
+	RETURN_IF_ERROR(ret != 0, "failed to enable expiry (ret=%d)", ret);
+	ret = rte_hash_expiry_enable(handle, &cfg);
+	RETURN_IF_ERROR(ret != -EEXIST, "expiry enabled twice (ret=%d)", ret);
+
+	/* Spread from the past to beyond the span of the wheel */
+	for (i = 0; i < EXPIRY_TEST_KEYS; i++) {
+		keys[i] = i;
+		expire[i] = EXPIRY_TEST_START - 100 + (uint64_t)i * i * i * 17;
+		ret = rte_hash_add_key_data(handle, &keys[i],
+				(void *)((uintptr_t)i + 1));
+		RETURN_IF_ERROR(ret != 0, "failed to add key %u (ret=%d)", i,
+				ret);
+		positions[i] = rte_hash_lookup(handle, &keys[i]);
+		ret = rte_hash_expiry_set(handle, positions[i], expire[i]);
+		RETURN_IF_ERROR(ret != 0, "failed to set expiry of key %u", i);
+	}
+
+	/* Deleted or cancelled keys never expire, updated ones expire later */
+	for (i = 1; i < EXPIRY_TEST_KEYS; i += 7) {
+		ret = rte_hash_del_key(handle, &keys[i]);
+		RETURN_IF_ERROR(ret != positions[i], "failed to delete key %u",
+				i);
+		expired[i] = 1;
+		nb_expired++;
+	}
+	for (i = 2; i < EXPIRY_TEST_KEYS; i += 7) {
+		ret = rte_hash_expiry_cancel(handle, positions[i]);
+		RETURN_IF_ERROR(ret != 0, "failed to cancel expiry of key %u",
+				i);
+		expired[i] = 1;
+		nb_expired++;
+	}
+	ret = rte_hash_expiry_cancel(handle, positions[2]);
+	RETURN_IF_ERROR(ret != -ENOENT, "cancelled expiry twice (ret=%d)",
+			ret);
+	for (i = 3; i < EXPIRY_TEST_KEYS; i += 7) {
+		expire[i] += 12345;
+		ret = rte_hash_expiry_set(handle, positions[i], expire[i]);
+		RETURN_IF_ERROR(ret != 0, "failed to set expiry of key %u", i);
+	}
+
+	/* Time goes on with growing steps */
+	for (now = EXPIRY_TEST_START; prev <= expire[EXPIRY_TEST_KEYS - 1];
+			now += (now - EXPIRY_TEST_START) / 8 + 3) {
+		do {
+			ret = rte_hash_expire(handle, now, ret_keys, ret_data,
+					ret_pos, RTE_DIM(ret_pos));
+			RETURN_IF_ERROR(ret < 0, "expire failed (ret=%d)", ret);
+			for (k = 0; k < (unsigned int)ret; k++) {
+				i = *(const uint32_t *)ret_keys[k];
+				RETURN_IF_ERROR(i >= EXPIRY_TEST_KEYS ||
+						expired[i] ||
+						ret_pos[k] != positions[i] ||
+						ret_data[k] !=
+						(void *)((uintptr_t)i + 1),
+						"unexpected expired key %u", i);
+				RETURN_IF_ERROR(expire[i] > now,
+					"key %u expired early at %"PRIu64, i,
+					now);
+				RETURN_IF_ERROR(expire[i] + EXPIRY_TEST_TICK <=
+					prev, "key %u expired late at %"PRIu64,
+					i, now);
+				expired[i] = 1;
+				nb_expired++;
+			}
+		} while (ret == (int)RTE_DIM(ret_pos));
+		prev = now;
+	}
+
+	RETURN_IF_ERROR(nb_expired != EXPIRY_TEST_KEYS,
+			"only %u keys expired", nb_expired);
+
+	/* The keys are not removed by the expiry */
+	RETURN_IF_ERROR(rte_hash_count(handle) != EXPIRY_TEST_KEYS -
+			(EXPIRY_TEST_KEYS + 5) / 7,
+			"unexpected key count %d", rte_hash_count(handle));
+	ret = rte_hash_expire(handle, UINT64_MAX, ret_keys, NULL, ret_pos,
+			RTE_DIM(ret_pos));
+	RETURN_IF_ERROR(ret != 0, "keys expired twice (ret=%d)", ret);
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -1388,6 +1732,17 @@ static int test_hash_creation_with_bad_parameters(void)
 		return -1;
 	}
 
+	memcpy(&params, &ut_params, sizeof(params));
+	params.name = "creation_with_bad_parameters_5";
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE |
+				RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	if (handle != NULL) {
+		rte_hash_free(handle);
+		printf("Impossible creating resizable hash successfully with extendable buckets\n");
+		return -1;
+	}
+
 	/* test with same name should fail */
 	memcpy(&params, &ut_params, sizeof(params));
 	params.name = "same_name";
@@ -2184,6 +2539,134 @@ test_hash_rcu_qsbr_sync_mode(uint8_t ext_bkt)
 
 }
 
+#define RESIZE_LF_READER_KEYS 32
+static uint32_t g_resize_keys[RESIZE_TEST_KEYS];
+static uint32_t g_resize_reader_misses;
+
+/*
+ * Reader thread looking up keys added before the table starts growing.
+ */
+static int
+test_hash_resizable_lf_reader(void *arg)
+{
+	uint32_t i;
+
+	RTE_SET_USED(arg);
+	(void)rte_rcu_qsbr_thread_register(g_qsv, 0);
+	rte_rcu_qsbr_thread_online(g_qsv, 0);
+
+	do {
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i++)
+			if (rte_hash_lookup(g_handle, &g_resize_keys[i %
+					RESIZE_LF_READER_KEYS]) < 0)
+				g_resize_reader_misses++;
+
+		rte_rcu_qsbr_quiescent(g_qsv, 0);
+	} while (!writer_done);
+
+	rte_rcu_qsbr_thread_offline(g_qsv, 0);
+	(void)rte_rcu_qsbr_thread_unregister(g_qsv, 0);
+
+	return 0;
+}
+
+/*
+ * Resizable table with lock free readers.
+ *  - Without a RCU QSBR variable the table cannot grow.
+ *  - Attach RCU QSBR variable and launch a reader thread which keeps
+ *    looking up keys added first.
+ *  - Writer grows the table, the reader must never miss a key.
+ */
+static int
+test_hash_resizable_lf(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_resizable_lf",
+		.entries = 64,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE |
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	unsigned int i, added;
+	int32_t status;
+	size_t sz;
+	int ret;
+
+	printf("\n# Running resizable table with lock free readers test\n");
+
+	g_qsv = NULL;
+	g_handle = rte_hash_create(&params);
+	RETURN_IF_ERROR_RCU_QSBR(g_handle == NULL, "Hash creation failed");
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i++)
+		g_resize_keys[i] = i;
+
+	for (added = 0; added < RESIZE_TEST_KEYS; added++) {
+		ret = rte_hash_add_key(g_handle, &g_resize_keys[added]);
+		if (ret < 0)
+			break;
+	}
+	RETURN_IF_ERROR_RCU_QSBR(ret != -ENOSPC || added > 2 * params.entries,
+				 "table grew without RCU (added %u keys)", added);
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	g_qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RETURN_IF_ERROR_RCU_QSBR(g_qsv == NULL,
+				 "RCU QSBR variable creation failed");
+	status = rte_rcu_qsbr_init(g_qsv, RTE_MAX_LCORE);
+	RETURN_IF_ERROR_RCU_QSBR(status != 0,
+				 "RCU QSBR variable initialization failed");
+	rcu_cfg.v = g_qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC;
+	status = rte_hash_rcu_qsbr_add(g_handle, &rcu_cfg);
+	RETURN_IF_ERROR_RCU_QSBR(status != 0,
+				 "Attach RCU QSBR to hash table failed");
+
+	g_resize_reader_misses = 0;
+	writer_done = 0;
+	rte_eal_remote_launch(test_hash_resizable_lf_reader, NULL,
+				rte_get_next_lcore(-1, 1, 0));
+
+	/*
+	 * New key slots are handed out only once the reader went through
+	 * a quiescent state, retry while they are held back.
+	 */
+	for (i = added; i < RESIZE_TEST_KEYS; i++) {
+		do {
+			ret = rte_hash_add_key(g_handle, &g_resize_keys[i]);
+		} while (ret == -ENOSPC);
+		if (ret < 0)
+			break;
+	}
+
+	writer_done = 1;
+	rte_eal_mp_wait_lcore();
+
+	RETURN_IF_ERROR_RCU_QSBR(ret < 0, "failed to add key %u (ret=%d)",
+				 i, ret);
+	RETURN_IF_ERROR_RCU_QSBR(g_resize_reader_misses != 0,
+				 "reader missed %u lookups",
+				 g_resize_reader_misses);
+	RETURN_IF_ERROR_RCU_QSBR(rte_hash_count(g_handle) != RESIZE_TEST_KEYS,
+				 "unexpected key count %d",
+				 rte_hash_count(g_handle));
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		ret = rte_hash_lookup(g_handle, &g_resize_keys[i]);
+		RETURN_IF_ERROR_RCU_QSBR(ret < 0,
+				 "failed to find key %u (ret=%d)", i, ret);
+	}
+
+	rte_hash_free(g_handle);
+	rte_free(g_qsv);
+
+	return 0;
+}
+
 /*
  * Do all unit and performance tests.
  */
@@ -2220,6 +2703,12 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_add_delete_bulk() < 0)
+		return -1;
+	if (test_resizable() < 0)
+		return -1;
+	if (test_hash_expiry() < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
@@ -2261,6 +2750,8 @@ test_hash(void)
 
 	if (test_hash_rcu_qsbr_sync_mode(1) < 0)
 		return -1;
+	if (test_hash_resizable_lf() < 0)
+		return -1;
 
 	return 0;
 }
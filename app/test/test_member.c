@@ -676,6 +676,104 @@ test_member_loadfactor(void)
 	return 0;
 }
 
+/*
+ * Sketch test, with a stream of keys of skewed frequencies spread over
+ * two sketches, as done with per-lcore sketches:
+ *  - counts are never under-estimated, and stay within the error bound
+ *  - the heavy hitters are the most frequent keys, once the sketches
+ *    are merged
+ */
+#define SKETCH_KEYS 1024
+#define SKETCH_TOP_K 8
+#define SKETCH_MAX_COUNT 1000
+static int
+test_member_sketch(void)
+{
+	struct rte_member_setsum *sketch[2];
+	struct rte_member_parameters sketch_params = {
+		.name = "test_member_sketch",
+		.type = RTE_MEMBER_TYPE_SKETCH,
+		.num_keys = SKETCH_TOP_K,
+		.key_len = KEY_SIZE,
+		.false_positive_rate = 0.001,
+		.prim_hash_seed = 1,
+		.sec_hash_seed = 11,
+		.socket_id = 0
+	};
+	void *hh_keys[SKETCH_TOP_K];
+	uint64_t hh_counts[SKETCH_TOP_K];
+	uint64_t count, total = 0;
+	member_set_t set_id;
+	unsigned int i, r, n = 0;
+	int ret;
+
+	sketch[0] = rte_member_create(&sketch_params);
+	sketch_params.name = "test_member_sketch_1";
+	sketch[1] = rte_member_create(&sketch_params);
+	if (sketch[0] == NULL || sketch[1] == NULL) {
+		printf("Creation of sketch fail\n");
+		rte_member_free(sketch[0]);
+		rte_member_free(sketch[1]);
+		return -1;
+	}
+
+	/* Key i occurs SKETCH_MAX_COUNT / (i + 1) times */
+	for (r = 0; r < SKETCH_MAX_COUNT; r++) {
+		for (i = 0; i < SKETCH_KEYS &&
+				r < SKETCH_MAX_COUNT / (i + 1); i++) {
+			ret = rte_member_add(sketch[n++ & 1],
+					&generated_keys[i], 1);
+			TEST_ASSERT(ret == 0, "sketch insert error");
+			total++;
+		}
+	}
+
+	TEST_ASSERT(rte_member_lookup(sketch[0], &generated_keys[0],
+			&set_id) == -EINVAL, "lookup succeeded on sketch");
+	TEST_ASSERT(rte_member_merge(sketch[0], setsum_ht) == -EINVAL,
+			"merge of different types succeeded");
+	ret = rte_member_merge(sketch[0], sketch[1]);
+	TEST_ASSERT(ret == 0, "sketch merge error");
+
+	for (i = 0; i < SKETCH_KEYS; i++) {
+		ret = rte_member_query_count(sketch[0], &generated_keys[i],
+				&count);
+		TEST_ASSERT(ret == 0, "sketch query error");
+		TEST_ASSERT(count >= SKETCH_MAX_COUNT / (i + 1) &&
+				count <= SKETCH_MAX_COUNT / (i + 1) +
+				2 * sketch_params.false_positive_rate * total,
+				"wrong count %"PRIu64" for key %u", count, i);
+	}
+
+	ret = rte_member_report_heavyhitter(sketch[0], hh_keys, hh_counts);
+	TEST_ASSERT(ret == SKETCH_TOP_K, "wrong heavy hitter count %d", ret);
+	for (i = 0; i < SKETCH_TOP_K; i++)
+		TEST_ASSERT(memcmp(hh_keys[i], &generated_keys[i],
+				KEY_SIZE) == 0, "wrong heavy hitter %u", i);
+
+	/* A single big weighted add makes a new top heavy hitter */
+	ret = rte_member_add_byte_count(sketch[0],
+			&generated_keys[SKETCH_KEYS], 2 * SKETCH_MAX_COUNT);
+	TEST_ASSERT(ret == 0, "sketch weighted insert error");
+	ret = rte_member_report_heavyhitter(sketch[0], hh_keys, hh_counts);
+	TEST_ASSERT(ret == SKETCH_TOP_K &&
+			memcmp(hh_keys[0], &generated_keys[SKETCH_KEYS],
+				KEY_SIZE) == 0 &&
+			hh_counts[0] >= 2 * SKETCH_MAX_COUNT,
+			"weighted key is not the top heavy hitter");
+
+	rte_member_reset(sketch[0]);
+	ret = rte_member_query_count(sketch[0], &generated_keys[0], &count);
+	TEST_ASSERT(ret == 0 && count == 0, "sketch reset error");
+	ret = rte_member_report_heavyhitter(sketch[0], hh_keys, hh_counts);
+	TEST_ASSERT(ret == 0, "heavy hitters left after reset");
+
+	rte_member_free(sketch[0]);
+	rte_member_free(sketch[1]);
+	printf("sketch test success\n");
+	return 0;
+}
+
 static void
 perform_free(void)
 {
@@ -718,6 +816,11 @@ test_member(void)
 		rte_member_free(setsum_cache);
 		return -1;
 	}
+	if (test_member_sketch() < 0) {
+		rte_member_free(setsum_ht);
+		rte_member_free(setsum_cache);
+		return -1;
+	}
 
 	perform_free();
 	return 0;
@@ -835,6 +835,63 @@ test_mempool_flag_non_io_unset_when_populated_with_valid_iova(void)
 	return ret;
 }
 
+static int
+test_mempool_flag_shared_cache(void)
+{
+	struct rte_mempool_shared_cache *sc;
+	struct rte_mempool *mp = NULL;
+	void **objs = NULL;
+	unsigned int i, n = MEMPOOL_SIZE;
+	int ret;
+
+	/* a shared cache requires per-lcore caches */
+	mp = rte_mempool_create("test_shared_cache", n, MEMPOOL_ELT_SIZE,
+				0, 0, NULL, NULL, my_obj_init, NULL,
+				SOCKET_ID_ANY, RTE_MEMPOOL_F_SHARED_CACHE);
+	RTE_TEST_ASSERT(mp == NULL && rte_errno == EINVAL,
+			"Mempool with a shared cache and no cache created");
+
+	mp = rte_mempool_create("test_shared_cache", n, MEMPOOL_ELT_SIZE,
+				RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+				NULL, NULL, my_obj_init, NULL,
+				SOCKET_ID_ANY, RTE_MEMPOOL_F_SHARED_CACHE);
+	RTE_TEST_ASSERT_NOT_NULL(mp, "Cannot create mempool: %s",
+				 rte_strerror(rte_errno));
+	sc = rte_mempool_shared_cache_local(mp);
+	RTE_TEST_ASSERT_NOT_NULL(sc, "No shared cache on the local socket");
+
+	objs = rte_calloc("test_shared_cache", n, sizeof(void *), 0);
+	RTE_TEST_ASSERT_NOT_NULL(objs, "Cannot allocate object table");
+
+	/* get every object, then put them back to fill the shared cache */
+	for (i = 0; i < n; i++)
+		RTE_TEST_ASSERT_SUCCESS(rte_mempool_get(mp, &objs[i]),
+					"Cannot get object %u", i);
+	RTE_TEST_ASSERT(rte_mempool_empty(mp), "Mempool is not empty");
+	for (i = 0; i < n; i++)
+		rte_mempool_put(mp, objs[i]);
+	RTE_TEST_ASSERT(sc->len > 0, "Shared cache is empty after flush");
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), n,
+			      "Objects lost in the shared cache");
+
+	/* objects kept in the shared cache can all be got again */
+	for (i = 0; i < n; i++)
+		RTE_TEST_ASSERT_SUCCESS(rte_mempool_get(mp, &objs[i]),
+					"Cannot get object %u again", i);
+	RTE_TEST_ASSERT_EQUAL(sc->len, 0, "Shared cache is not drained");
+	rte_mempool_put_bulk(mp, objs, n);
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), n,
+			      "Objects lost in the shared cache");
+	rte_mempool_audit(mp);
+
+	ret = TEST_SUCCESS;
+
+exit:
+	rte_free(objs);
+	rte_mempool_free(mp);
+	return ret;
+}
+
 #pragma pop_macro("RTE_TEST_TRACE_FAILURE")
 
 static int
@@ -1028,6 +1085,10 @@ test_mempool(void)
 	if (test_mempool_flag_non_io_unset_when_populated_with_valid_iova() < 0)
 		GOTO_ERR(ret, err);
 
+	/* test the shared cache */
+	if (test_mempool_flag_shared_cache() < 0)
+		GOTO_ERR(ret, err);
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -26,6 +26,7 @@
 #include <rte_spinlock.h>
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
+#include <rte_ring.h>
 
 #include "test.h"
 
@@ -63,6 +64,12 @@
  *      - 32
  *      - 128
  *      - 512
+ *
+ *    The asymmetric test pairs the cores: one core of each pair gets
+ *    objects per bulk of *n_get_bulk* and passes them through a ring to
+ *    the other core, which puts them back per bulk of *n_put_bulk*.
+ *    It is done with a cache, with and without a shared cache, on two
+ *    cores and on max. cores.
  */
 
 #define N 65536
@@ -224,6 +231,171 @@ per_lcore_mempool_test(void *arg)
 	return ret;
 }
 
+#define ASYM_RING_SIZE 512
+
+/* role of an lcore in the asymmetric test */
+struct asym_lcore_conf {
+	struct rte_mempool *mp;
+	struct rte_ring *ring;  /**< from the getting to the putting lcore */
+	uint32_t *get_done;     /**< set when the getting lcore stops */
+	int get;                /**< getting or putting lcore */
+};
+
+static struct asym_lcore_conf asym_conf[RTE_MAX_LCORE];
+static uint32_t asym_get_done[RTE_MAX_LCORE];
+
+static int
+per_lcore_asym_test(void *arg)
+{
+	struct asym_lcore_conf *conf = arg;
+	struct rte_mempool *mp = conf->mp;
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_mempool_cache *cache;
+	void *obj_table[MAX_KEEP] __rte_cache_aligned;
+	uint64_t start_cycles, hz = rte_get_timer_hz();
+	unsigned int n;
+
+	cache = rte_mempool_default_cache(mp, lcore_id);
+	stats[lcore_id].enq_count = 0;
+
+	/* wait synchro for workers */
+	if (lcore_id != rte_get_main_lcore())
+		rte_wait_until_equal_32(&synchro, 1, __ATOMIC_RELAXED);
+
+	start_cycles = rte_get_timer_cycles();
+
+	if (conf->get) {
+		while ((rte_get_timer_cycles() - start_cycles) / hz < TIME_S) {
+			if (rte_mempool_generic_get(mp, obj_table, n_get_bulk,
+					cache) < 0) {
+				rte_pause();
+				continue;
+			}
+			while (rte_ring_sp_enqueue_bulk(conf->ring, obj_table,
+					n_get_bulk, NULL) == 0)
+				rte_pause();
+		}
+		__atomic_store_n(conf->get_done, 1, __ATOMIC_RELEASE);
+		return 0;
+	}
+
+	for (;;) {
+		n = rte_ring_sc_dequeue_burst(conf->ring, obj_table,
+				n_put_bulk, NULL);
+		if (n == 0) {
+			if (__atomic_load_n(conf->get_done, __ATOMIC_ACQUIRE) &&
+					rte_ring_empty(conf->ring))
+				break;
+			rte_pause();
+			continue;
+		}
+		rte_mempool_generic_put(mp, obj_table, n, cache);
+		stats[lcore_id].enq_count += n;
+	}
+
+	return 0;
+}
+
+/* launch the asymmetric test on pairs of lcores, and display the result */
+static int
+launch_asym_cores(struct rte_mempool *mp, unsigned int cores)
+{
+	struct rte_ring *rings[RTE_MAX_LCORE / 2] = { NULL };
+	char ring_name[RTE_RING_NAMESIZE];
+	unsigned int lcore_id, idx, main_lcore = rte_get_main_lcore();
+	uint64_t rate;
+	int ret = 0;
+
+	__atomic_store_n(&synchro, 0, __ATOMIC_RELAXED);
+	memset(stats, 0, sizeof(stats));
+	memset(asym_get_done, 0, sizeof(asym_get_done));
+
+	printf("mempool_autotest cache=%u cores=%u n_get_bulk=%u "
+	       "n_put_bulk=%u asymmetric shared_cache=%u ",
+	       (unsigned int)mp->cache_size, cores, n_get_bulk, n_put_bulk,
+	       !!(mp->flags & RTE_MEMPOOL_F_SHARED_CACHE));
+
+	if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE) {
+		printf("mempool is not full\n");
+		return -1;
+	}
+
+	/* the main lcore gets objects for the first worker */
+	idx = 0;
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (idx == cores)
+			break;
+		if (idx % 2 == 0) {
+			snprintf(ring_name, sizeof(ring_name),
+				 "perf_asym_%u", idx / 2);
+			rings[idx / 2] = rte_ring_create(ring_name,
+					ASYM_RING_SIZE, SOCKET_ID_ANY,
+					RING_F_SP_ENQ | RING_F_SC_DEQ);
+			if (rings[idx / 2] == NULL)
+				GOTO_ERR(ret, out);
+		}
+		asym_conf[lcore_id].mp = mp;
+		asym_conf[lcore_id].ring = rings[idx / 2];
+		asym_conf[lcore_id].get_done = &asym_get_done[idx / 2];
+		asym_conf[lcore_id].get = (idx % 2 == 0);
+		idx++;
+	}
+
+	idx = 0;
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (idx++ == cores)
+			break;
+		if (lcore_id != main_lcore)
+			rte_eal_remote_launch(per_lcore_asym_test,
+					      &asym_conf[lcore_id], lcore_id);
+	}
+
+	/* start synchro and launch test on main */
+	__atomic_store_n(&synchro, 1, __ATOMIC_RELAXED);
+
+	ret = per_lcore_asym_test(&asym_conf[main_lcore]);
+
+	idx = 0;
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (idx++ == cores)
+			break;
+		if (lcore_id != main_lcore && rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+	}
+
+	if (ret < 0) {
+		printf("per-lcore test returned -1\n");
+		goto out;
+	}
+
+	rate = 0;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		rate += (stats[lcore_id].enq_count / TIME_S);
+
+	printf("rate_persec=%" PRIu64 "\n", rate);
+
+out:
+	for (idx = 0; idx < RTE_DIM(rings); idx++)
+		rte_ring_free(rings[idx]);
+	return ret;
+}
+
+/* for a given number of core, launch the asymmetric test cases */
+static int
+do_one_asym_mempool_test(struct rte_mempool *mp, unsigned int cores)
+{
+	unsigned int bulk_tab[] = { 1, CACHE_LINE_BURST, 32, 0 };
+	unsigned int *bulk_ptr;
+
+	for (bulk_ptr = bulk_tab; *bulk_ptr; bulk_ptr++) {
+		n_get_bulk = *bulk_ptr;
+		n_put_bulk = *bulk_ptr;
+		if (launch_asym_cores(mp, cores) < 0)
+			return -1;
+	}
+	return 0;
+}
+
 /* launch all the per-lcore test, and display the result */
 static int
 launch_cores(struct rte_mempool *mp, unsigned int cores)
@@ -326,6 +498,7 @@ static int
 test_mempool_perf(void)
 {
 	struct rte_mempool *mp_cache = NULL;
+	struct rte_mempool *mp_shared_cache = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
 	const char *default_pool_ops;
@@ -350,6 +523,18 @@ test_mempool_perf(void)
 	if (mp_cache == NULL)
 		goto err;
 
+	/* create a mempool (with cache shared by the lcores of a socket) */
+	mp_shared_cache = rte_mempool_create("perf_test_shared_cache",
+				      MEMPOOL_SIZE,
+				      MEMPOOL_ELT_SIZE,
+				      RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+				      NULL, NULL,
+				      my_obj_init, NULL,
+				      SOCKET_ID_ANY,
+				      RTE_MEMPOOL_F_SHARED_CACHE);
+	if (mp_shared_cache == NULL)
+		goto err;
+
 	default_pool_ops = rte_mbuf_best_mempool_ops();
 	/* Create a mempool based on Default handler */
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -426,12 +611,36 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_nocache, rte_lcore_count()) < 0)
 		goto err;
 
+	/* asymmetric performance test with 2 and max cores */
+	if (rte_lcore_count() >= 2) {
+		unsigned int max_cores = rte_lcore_count() & ~1u;
+
+		printf("start asymmetric performance test (with cache)\n");
+
+		if (do_one_asym_mempool_test(mp_cache, 2) < 0)
+			goto err;
+
+		if (max_cores > 2 && do_one_asym_mempool_test(mp_cache,
+				max_cores) < 0)
+			goto err;
+
+		printf("start asymmetric performance test (with shared cache)\n");
+
+		if (do_one_asym_mempool_test(mp_shared_cache, 2) < 0)
+			goto err;
+
+		if (max_cores > 2 && do_one_asym_mempool_test(mp_shared_cache,
+				max_cores) < 0)
+			goto err;
+	}
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
 
 err:
 	rte_mempool_free(mp_cache);
+	rte_mempool_free(mp_shared_cache);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
 	return ret;
@@ -2,16 +2,21 @@
  * Copyright (c) 2021 Microsoft Corporation
  */
 
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_mempool.h>
 #include <rte_net.h>
 #include <rte_pcapng.h>
+#include <rte_port_pcapng.h>
+#include <rte_time.h>
 
 #include <pcap/pcap.h>
 
@@ -237,6 +242,307 @@ test_validate(void)
 	return ret;
 }
 
+/* Read back the packets with the pcapng reader */
+static int
+test_read_packets(void)
+{
+	struct rte_mbuf *pkts[NUM_PACKETS + 1];
+	struct dummy_mbuf mbfs;
+	struct rte_mempool *rd_mp;
+	rte_pcapng_reader_t *rd;
+	uint64_t ts_flag, prev_ts = 0, ts;
+	unsigned int i;
+	uint16_t nb;
+	int fd, ts_offset, ret = -1;
+
+	/* The packets only refer to the file, no data room needed */
+	rd_mp = rte_pktmbuf_pool_create("pcapng_read_pool", NUM_PACKETS + 1,
+					0, 0, 0, SOCKET_ID_ANY);
+	if (rd_mp == NULL) {
+		fprintf(stderr, "Cannot create mempool\n");
+		return -1;
+	}
+
+	fd = open(file_name, O_RDONLY);
+	if (fd < 0) {
+		perror("open");
+		goto fail_pool;
+	}
+
+	rd = rte_pcapng_reader_fdopen(fd);
+	if (rd == NULL) {
+		fprintf(stderr, "rte_pcapng_reader_fdopen failed\n");
+		close(fd);
+		goto fail_pool;
+	}
+
+	if (rte_mbuf_dyn_rx_timestamp_register(&ts_offset, &ts_flag) < 0) {
+		fprintf(stderr, "Cannot find timestamp field\n");
+		goto fail;
+	}
+
+	/* Same content as the written packets, except the random source */
+	mbuf1_prepare(&mbfs, pkt_len);
+
+	nb = rte_pcapng_read_packets(rd, rd_mp, pkts, RTE_DIM(pkts));
+	if (nb != NUM_PACKETS || !rte_pcapng_reader_eof(rd)) {
+		fprintf(stderr, "Read %u packets instead of %u\n",
+			nb, NUM_PACKETS);
+		rte_pktmbuf_free_bulk(pkts, nb);
+		goto fail;
+	}
+
+	for (i = 0; i < nb; i++) {
+		ts = *RTE_MBUF_DYNFIELD(pkts[i], ts_offset,
+					rte_mbuf_timestamp_t *);
+		if (!RTE_MBUF_HAS_EXTBUF(pkts[i]) ||
+		    rte_pktmbuf_pkt_len(pkts[i]) != pkt_len ||
+		    memcmp(rte_pktmbuf_mtod(pkts[i], void *),
+			   rte_pktmbuf_mtod(mbfs.mb, void *),
+			   RTE_ETHER_ADDR_LEN) != 0 ||
+		    memcmp(rte_pktmbuf_mtod_offset(pkts[i], void *,
+						   2 * RTE_ETHER_ADDR_LEN),
+			   rte_pktmbuf_mtod_offset(mbfs.mb, void *,
+						   2 * RTE_ETHER_ADDR_LEN),
+			   pkt_len - 2 * RTE_ETHER_ADDR_LEN) != 0 ||
+		    !(pkts[i]->ol_flags & ts_flag) || ts < prev_ts) {
+			fprintf(stderr, "Packet %u read is different\n", i);
+			rte_pktmbuf_free_bulk(pkts, nb);
+			goto fail;
+		}
+		prev_ts = ts;
+	}
+
+	/* Packets stay valid after the reader is closed */
+	rte_pcapng_reader_close(rd);
+	rd = NULL;
+	if (rte_pktmbuf_pkt_len(pkts[nb - 1]) != pkt_len) {
+		rte_pktmbuf_free_bulk(pkts, nb);
+		goto fail;
+	}
+	rte_pktmbuf_free_bulk(pkts, nb);
+
+	ret = 0;
+fail:
+	if (rd != NULL)
+		rte_pcapng_reader_close(rd);
+fail_pool:
+	rte_mempool_free(rd_mp);
+	return ret;
+}
+
+/* Replay slowed down so much that only the first packet is due */
+static int
+test_replay_speed(void)
+{
+	struct rte_mbuf *pkts[NUM_PACKETS];
+	struct rte_mempool *rd_mp;
+	rte_pcapng_reader_t *rd;
+	uint16_t nb, total;
+	int fd, ret = -1;
+
+	rd_mp = rte_pktmbuf_pool_create("pcapng_replay_pool", NUM_PACKETS,
+					0, 0, 0, SOCKET_ID_ANY);
+	if (rd_mp == NULL) {
+		fprintf(stderr, "Cannot create mempool\n");
+		return -1;
+	}
+
+	fd = open(file_name, O_RDONLY);
+	if (fd < 0) {
+		perror("open");
+		goto fail_pool;
+	}
+
+	rd = rte_pcapng_reader_fdopen(fd);
+	if (rd == NULL) {
+		fprintf(stderr, "rte_pcapng_reader_fdopen failed\n");
+		close(fd);
+		goto fail_pool;
+	}
+
+	if (rte_pcapng_reader_set_speed(rd, -1) == 0 ||
+	    rte_pcapng_reader_set_speed(rd, 1e-9) != 0)
+		goto fail;
+
+	/* 1ns in the capture lasts 1s of replay */
+	total = rte_pcapng_read_packets(rd, rd_mp, pkts, NUM_PACKETS);
+	rte_pktmbuf_free_bulk(pkts, total);
+	if (total != 1) {
+		fprintf(stderr, "Replay returned %u packets at once\n", total);
+		goto fail;
+	}
+
+	/* Remaining packets with pacing disabled */
+	rte_pcapng_reader_set_speed(rd, 0);
+	nb = rte_pcapng_read_packets(rd, rd_mp, pkts, NUM_PACKETS);
+	rte_pktmbuf_free_bulk(pkts, nb);
+	total += nb;
+	if (total != NUM_PACKETS || !rte_pcapng_reader_eof(rd))
+		goto fail;
+
+	/* Read it all again */
+	rte_pcapng_reader_rewind(rd);
+	nb = rte_pcapng_read_packets(rd, rd_mp, pkts, NUM_PACKETS);
+	rte_pktmbuf_free_bulk(pkts, nb);
+	if (nb != NUM_PACKETS)
+		goto fail;
+
+	ret = 0;
+fail:
+	rte_pcapng_reader_close(rd);
+fail_pool:
+	rte_mempool_free(rd_mp);
+	return ret;
+}
+
+/* Replay the capture twice through a pcapng_reader port */
+static int
+test_replay_port(void)
+{
+	struct rte_port_pcapng_reader_params params = {
+		.file_name = file_name,
+		.n_loops = 2,
+	};
+	struct rte_mbuf *pkts[NUM_PACKETS];
+	struct rte_mempool *rd_mp;
+	unsigned int total = 0;
+	void *port;
+	int nb, ret = -1;
+
+	rd_mp = rte_pktmbuf_pool_create("pcapng_port_pool", NUM_PACKETS,
+					0, 0, 0, SOCKET_ID_ANY);
+	if (rd_mp == NULL) {
+		fprintf(stderr, "Cannot create mempool\n");
+		return -1;
+	}
+
+	params.mempool = rd_mp;
+	port = rte_port_pcapng_reader_ops.f_create(&params, SOCKET_ID_ANY);
+	if (port == NULL) {
+		fprintf(stderr, "Cannot create pcapng reader port\n");
+		goto fail_pool;
+	}
+
+	/* Odd burst size, so that each loop ends with a short burst */
+	do {
+		nb = rte_port_pcapng_reader_ops.f_rx(port, pkts, 3);
+		rte_pktmbuf_free_bulk(pkts, nb);
+		total += nb;
+	} while (nb > 0 && total <= 2 * NUM_PACKETS);
+
+	if (total != 2 * NUM_PACKETS) {
+		fprintf(stderr, "Port replayed %u packets instead of %u\n",
+			total, 2 * NUM_PACKETS);
+		goto fail;
+	}
+
+	/* Nothing more after the last loop */
+	if (rte_port_pcapng_reader_ops.f_rx(port, pkts, 3) != 0)
+		goto fail;
+
+	ret = 0;
+fail:
+	rte_port_pcapng_reader_ops.f_free(port);
+fail_pool:
+	rte_mempool_free(rd_mp);
+	return ret;
+}
+
+/*
+ * Hand made capture: an interface with 2^-40 s timestamp resolution
+ * and a 64 bytes snapshot length, an enhanced packet 3.5 s after the
+ * epoch and a simple packet longer than the snapshot length.
+ * Written as little endian words.
+ */
+static const uint32_t handmade_pcapng[] = {
+	/* section header */
+	0x0A0D0D0A, 28, 0x1A2B3C4D, 1, UINT32_MAX, UINT32_MAX, 28,
+	/* interface, ethernet link, tsresol option */
+	1, 32, 1, 64, (1 << 16) | 9, 0x80 | 40, 0, 32,
+	/* enhanced packet */
+	6, 48, 0, 0x380, 0, 16, 16, 0, 0, 0, 0, 48,
+	/* simple packet of 128 bytes */
+	3, 144, 128,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	144,
+};
+
+/* Read a capture using features rte_pcapng does not write */
+static int
+test_read_handmade(void)
+{
+	char hm_file_name[] = "/tmp/pcapng_hm_XXXXXX.pcapng";
+	uint32_t buf[RTE_DIM(handmade_pcapng)];
+	struct rte_mbuf *pkts[3];
+	struct rte_mempool *rd_mp;
+	rte_pcapng_reader_t *rd = NULL;
+	uint64_t ts_flag, ts;
+	uint16_t nb = 0;
+	unsigned int i;
+	int fd, ts_offset, ret = -1;
+
+	for (i = 0; i < RTE_DIM(buf); i++)
+		buf[i] = rte_cpu_to_le_32(handmade_pcapng[i]);
+
+	rd_mp = rte_pktmbuf_pool_create("pcapng_hm_pool", RTE_DIM(pkts),
+					0, 0, 0, SOCKET_ID_ANY);
+	if (rd_mp == NULL) {
+		fprintf(stderr, "Cannot create mempool\n");
+		return -1;
+	}
+
+	fd = mkstemps(hm_file_name, strlen(".pcapng"));
+	if (fd < 0) {
+		perror("mkstemps");
+		goto fail;
+	}
+	unlink(hm_file_name);
+	if (write(fd, buf, sizeof(buf)) != sizeof(buf)) {
+		perror("write");
+		close(fd);
+		goto fail;
+	}
+
+	rd = rte_pcapng_reader_fdopen(fd);
+	if (rd == NULL) {
+		fprintf(stderr, "rte_pcapng_reader_fdopen failed\n");
+		close(fd);
+		goto fail;
+	}
+
+	if (rte_mbuf_dyn_rx_timestamp_register(&ts_offset, &ts_flag) < 0) {
+		fprintf(stderr, "Cannot find timestamp field\n");
+		goto fail;
+	}
+
+	nb = rte_pcapng_read_packets(rd, rd_mp, pkts, RTE_DIM(pkts));
+	if (nb != 2) {
+		fprintf(stderr, "Read %u packets instead of 2\n", nb);
+		goto fail;
+	}
+
+	ts = *RTE_MBUF_DYNFIELD(pkts[0], ts_offset, rte_mbuf_timestamp_t *);
+	if (ts != 3 * NSEC_PER_SEC + NSEC_PER_SEC / 2) {
+		fprintf(stderr, "Wrong timestamp %"PRIu64"\n", ts);
+		goto fail;
+	}
+
+	if (rte_pktmbuf_pkt_len(pkts[1]) != 64) {
+		fprintf(stderr, "Simple packet not truncated to snaplen\n");
+		goto fail;
+	}
+
+	ret = 0;
+fail:
+	rte_pktmbuf_free_bulk(pkts, nb);
+	if (rd != NULL)
+		rte_pcapng_reader_close(rd);
+	rte_mempool_free(rd_mp);
+	return ret;
+}
+
 static void
 test_cleanup(void)
 {
@@ -256,6 +562,10 @@ unit_test_suite test_pcapng_suite  = {
 		TEST_CASE(test_write_packets),
 		TEST_CASE(test_write_stats),
 		TEST_CASE(test_validate),
+		TEST_CASE(test_read_packets),
+		TEST_CASE(test_replay_speed),
+		TEST_CASE(test_replay_port),
+		TEST_CASE(test_read_handmade),
 		TEST_CASES_END()
 	}
 };
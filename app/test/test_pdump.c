@@ -52,6 +52,11 @@ run_pdump_client_tests(void)
 	struct rte_mempool *mp = NULL;
 	struct rte_eth_dev *eth_dev = NULL;
 	char poolname[] = "mbuf_pool_client";
+	const struct rte_pdump_sampling sampling = {
+		.ratio = 4,
+		.rate = 1000,
+		.burst = 32,
+	};
 
 	ret = test_get_mempool(&mp, poolname);
 	if (ret < 0)
@@ -103,6 +108,38 @@ run_pdump_client_tests(void)
 		}
 		printf("pdump_disable_by_deviceid success\n");
 
+		ret = rte_pdump_enable_sampled(portid, QUEUE_ID,
+					       flags | RTE_PDUMP_FLAG_ZEROCOPY,
+					       0, ring_client, mp, NULL,
+					       &sampling);
+		if (ret < 0) {
+			printf("rte_pdump_enable_sampled failed\n");
+			return -1;
+		}
+		printf("pdump_enable_sampled success\n");
+
+		ret = rte_pdump_disable(portid, QUEUE_ID, flags);
+		if (ret < 0) {
+			printf("rte_pdump_disable failed\n");
+			return -1;
+		}
+
+		ret = rte_pdump_enable_sampled_by_deviceid(deviceid, QUEUE_ID,
+							   flags, 0,
+							   ring_client, mp,
+							   NULL, &sampling);
+		if (ret < 0) {
+			printf("rte_pdump_enable_sampled_by_deviceid failed\n");
+			return -1;
+		}
+		printf("pdump_enable_sampled_by_deviceid success\n");
+
+		ret = rte_pdump_disable_by_deviceid(deviceid, QUEUE_ID, flags);
+		if (ret < 0) {
+			printf("rte_pdump_disable_by_deviceid failed\n");
+			return -1;
+		}
+
 		if (itr == 0) {
 			flags = RTE_PDUMP_FLAG_RX;
 			printf("\n***** flags = RTE_PDUMP_FLAG_RX *****\n");
@@ -0,0 +1,284 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+#include "test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+
+#define AF_PACKET_V3_NAME "net_af_packet_v3_test"
+#define AF_PACKET_V3_ARGS "iface=lo,tpacket_v3=1,blocktmo=1"
+#define AF_PACKET_V3_QUEUES_ARGS "iface=lo,qpairs=2,tpacket_v3=1," \
+	"blocksz=[65536,131072],framecnt=[512,1024],blocktmo=[1,2]"
+#define AF_PACKET_V3_BAD_QUEUES_ARGS "iface=lo,qpairs=2,tpacket_v3=1," \
+	"blocksz=[65536]"
+
+#define RING_SIZE 256
+#define NB_MBUF 1024
+#define NB_PKTS 32
+#define PKT_LEN 64
+#define RX_TIMEOUT_MS 1000
+#define TEST_ETHER_TYPE 0x88b5 /* local experimental */
+
+static struct rte_mempool *mp;
+
+static int
+af_packet_port_setup(uint16_t port, uint16_t nb_queues)
+{
+	struct rte_eth_conf null_conf;
+	uint16_t q;
+
+	memset(&null_conf, 0, sizeof(null_conf));
+
+	if (rte_eth_dev_configure(port, nb_queues, nb_queues,
+				  &null_conf) < 0) {
+		printf("Configure failed for port %u\n", port);
+		return -1;
+	}
+
+	for (q = 0; q < nb_queues; q++) {
+		if (rte_eth_tx_queue_setup(port, q, RING_SIZE, SOCKET_ID_ANY,
+					   NULL) < 0) {
+			printf("TX queue setup failed for port %u\n", port);
+			return -1;
+		}
+
+		if (rte_eth_rx_queue_setup(port, q, RING_SIZE, SOCKET_ID_ANY,
+					   NULL, mp) < 0) {
+			printf("RX queue setup failed for port %u\n", port);
+			return -1;
+		}
+	}
+
+	if (rte_eth_dev_start(port) < 0) {
+		printf("Error starting port %u\n", port);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+af_packet_send(uint16_t port)
+{
+	struct rte_mbuf *bufs[NB_PKTS];
+	struct rte_ether_hdr *eth;
+	uint8_t *payload;
+	uint16_t nb_tx;
+	unsigned int i;
+
+	if (rte_pktmbuf_alloc_bulk(mp, bufs, NB_PKTS) != 0) {
+		printf("Failed to allocate mbufs\n");
+		return -1;
+	}
+
+	for (i = 0; i < NB_PKTS; i++) {
+		eth = (struct rte_ether_hdr *)rte_pktmbuf_append(bufs[i],
+								 PKT_LEN);
+		memset(&eth->dst_addr, 0xff, sizeof(eth->dst_addr));
+		rte_eth_random_addr(eth->src_addr.addr_bytes);
+		eth->ether_type = rte_cpu_to_be_16(TEST_ETHER_TYPE);
+		payload = (uint8_t *)(eth + 1);
+		memset(payload, i, PKT_LEN - sizeof(*eth));
+	}
+
+	nb_tx = rte_eth_tx_burst(port, 0, bufs, NB_PKTS);
+	if (nb_tx < NB_PKTS) {
+		rte_pktmbuf_free_bulk(&bufs[nb_tx], NB_PKTS - nb_tx);
+		printf("Sent %u of %u packets\n", nb_tx, NB_PKTS);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* a packet of af_packet_send() carries its index in its payload */
+static int
+af_packet_check(const struct rte_mbuf *m)
+{
+	const struct rte_ether_hdr *eth;
+	const uint8_t *payload;
+	unsigned int i;
+
+	if (rte_pktmbuf_data_len(m) != PKT_LEN)
+		return -1;
+
+	eth = rte_pktmbuf_mtod(m, const struct rte_ether_hdr *);
+	if (eth->ether_type != rte_cpu_to_be_16(TEST_ETHER_TYPE))
+		return -1;
+
+	payload = (const uint8_t *)(eth + 1);
+	for (i = 1; i < PKT_LEN - sizeof(*eth); i++)
+		if (payload[i] != payload[0])
+			return -1;
+
+	return payload[0];
+}
+
+/*
+ * Receives the packets sent on the loopback interface as mbufs
+ * attached to the TPACKET_V3 ring, and checks that they stay valid
+ * after the port they were received on is closed.
+ */
+static int
+test_af_packet_v3_close(void)
+{
+	struct rte_mbuf *held[NB_PKTS];
+	struct rte_mbuf *bufs[NB_PKTS];
+	unsigned int nb_held = 0;
+	unsigned int timeout;
+	uint16_t nb_rx;
+	uint16_t port;
+	unsigned int i;
+	int ret = TEST_FAILED;
+
+	if (rte_vdev_init(AF_PACKET_V3_NAME, AF_PACKET_V3_ARGS) != 0) {
+		printf("Cannot create %s, skipping\n", AF_PACKET_V3_NAME);
+		return TEST_SKIPPED;
+	}
+
+	if (rte_eth_dev_get_port_by_name(AF_PACKET_V3_NAME, &port) != 0) {
+		printf("Cannot find port of %s\n", AF_PACKET_V3_NAME);
+		goto out;
+	}
+
+	if (af_packet_port_setup(port, 1) < 0 || af_packet_send(port) < 0)
+		goto out;
+
+	/* outgoing packets are seen twice on lo, keep one of each */
+	for (timeout = 0; nb_held < NB_PKTS && timeout < RX_TIMEOUT_MS;
+	     timeout++) {
+		nb_rx = rte_eth_rx_burst(port, 0, bufs, NB_PKTS);
+		for (i = 0; i < nb_rx; i++) {
+			if (nb_held < NB_PKTS &&
+			    RTE_MBUF_HAS_EXTBUF(bufs[i]) &&
+			    af_packet_check(bufs[i]) == (int)nb_held)
+				held[nb_held++] = bufs[i];
+			else
+				rte_pktmbuf_free(bufs[i]);
+		}
+		if (nb_rx == 0)
+			rte_delay_ms(1);
+	}
+
+	if (nb_held < NB_PKTS) {
+		printf("Received %u of %u packets\n", nb_held, NB_PKTS);
+		goto out;
+	}
+
+	rte_eth_dev_stop(port);
+	if (rte_eth_dev_close(port) != 0) {
+		printf("Error closing port %u\n", port);
+		goto out;
+	}
+
+	/* the ring is still mapped, the packets must be unchanged */
+	for (i = 0; i < nb_held; i++) {
+		if (af_packet_check(held[i]) != (int)i) {
+			printf("Packet %u changed after port close\n", i);
+			goto out;
+		}
+	}
+
+	ret = TEST_SUCCESS;
+out:
+	/* the last freed mbuf unmaps the ring */
+	rte_pktmbuf_free_bulk(held, nb_held);
+	rte_vdev_uninit(AF_PACKET_V3_NAME);
+	return ret;
+}
+
+/*
+ * Receives the packets sent on the loopback interface on two queues
+ * whose TPACKET_V3 rings are set up with different parameters, and
+ * checks that a list of parameters not matching the queues is refused.
+ */
+static int
+test_af_packet_v3_queues(void)
+{
+	struct rte_mbuf *bufs[NB_PKTS];
+	uint64_t received = 0;
+	unsigned int timeout;
+	uint16_t nb_rx, q;
+	uint16_t port;
+	unsigned int i;
+	int ret = TEST_FAILED;
+	int idx;
+
+	if (rte_vdev_init(AF_PACKET_V3_NAME, AF_PACKET_V3_QUEUES_ARGS) != 0) {
+		printf("Cannot create %s, skipping\n", AF_PACKET_V3_NAME);
+		return TEST_SKIPPED;
+	}
+
+	if (rte_eth_dev_get_port_by_name(AF_PACKET_V3_NAME, &port) != 0) {
+		printf("Cannot find port of %s\n", AF_PACKET_V3_NAME);
+		goto out;
+	}
+
+	if (af_packet_port_setup(port, 2) < 0 || af_packet_send(port) < 0)
+		goto out;
+
+	/* the packets are spread over the queues by the fanout hash */
+	for (timeout = 0; received != RTE_LEN2MASK(NB_PKTS, uint64_t) &&
+	     timeout < RX_TIMEOUT_MS; timeout++) {
+		for (q = 0; q < 2; q++) {
+			nb_rx = rte_eth_rx_burst(port, q, bufs, NB_PKTS);
+			for (i = 0; i < nb_rx; i++) {
+				idx = af_packet_check(bufs[i]);
+				if (idx >= 0 && idx < NB_PKTS)
+					received |= RTE_BIT64(idx);
+			}
+			rte_pktmbuf_free_bulk(bufs, nb_rx);
+		}
+		rte_delay_ms(1);
+	}
+
+	if (received != RTE_LEN2MASK(NB_PKTS, uint64_t)) {
+		printf("Missing packets: 0x%" PRIx64 "\n",
+		       ~received & RTE_LEN2MASK(NB_PKTS, uint64_t));
+		goto out;
+	}
+
+	rte_eth_dev_stop(port);
+	rte_eth_dev_close(port);
+	rte_vdev_uninit(AF_PACKET_V3_NAME);
+
+	if (rte_vdev_init(AF_PACKET_V3_NAME,
+			  AF_PACKET_V3_BAD_QUEUES_ARGS) == 0) {
+		printf("Parameters of a single queue accepted for 2 queues\n");
+		goto out;
+	}
+
+	return TEST_SUCCESS;
+out:
+	rte_vdev_uninit(AF_PACKET_V3_NAME);
+	return ret;
+}
+
+static int
+test_pmd_af_packet(void)
+{
+	int ret;
+
+	mp = rte_pktmbuf_pool_create("mbuf_af_packet", NB_MBUF, 32, 0,
+				     RTE_MBUF_DEFAULT_BUF_SIZE,
+				     SOCKET_ID_ANY);
+	if (mp == NULL)
+		return TEST_FAILED;
+
+	ret = test_af_packet_v3_close();
+	if (ret == TEST_SUCCESS)
+		ret = test_af_packet_v3_queues();
+
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(af_packet_pmd_autotest, test_pmd_af_packet);
@@ -297,6 +297,19 @@ static const struct {
 			.felem = rte_ring_dequeue_bulk_elem,
 		},
 	},
+	{
+		.desc = "MP_TICKET/MC_TICKET sync mode",
+		.api_type = TEST_RING_ELEM_BULK | TEST_RING_THREAD_DEF,
+		.create_flags = RING_F_MT_TICKET,
+		.enq = {
+			.flegacy = rte_ring_enqueue_bulk,
+			.felem = rte_ring_enqueue_bulk_elem,
+		},
+		.deq = {
+			.flegacy = rte_ring_dequeue_bulk,
+			.felem = rte_ring_dequeue_bulk_elem,
+		},
+	},
 	{
 		.desc = "MP/MC sync mode",
 		.api_type = TEST_RING_ELEM_BURST | TEST_RING_THREAD_DEF,
@@ -362,6 +375,19 @@ static const struct {
 			.felem = rte_ring_dequeue_burst_elem,
 		},
 	},
+	{
+		.desc = "MP_TICKET/MC_TICKET sync mode",
+		.api_type = TEST_RING_ELEM_BURST | TEST_RING_THREAD_DEF,
+		.create_flags = RING_F_MT_TICKET,
+		.enq = {
+			.flegacy = rte_ring_enqueue_burst,
+			.felem = rte_ring_enqueue_burst_elem,
+		},
+		.deq = {
+			.flegacy = rte_ring_dequeue_burst,
+			.felem = rte_ring_dequeue_burst_elem,
+		},
+	},
 	{
 		.desc = "SP/SC sync mode (ZC)",
 		.api_type = TEST_RING_ELEM_BULK | TEST_RING_THREAD_SPSC,
@@ -569,7 +595,29 @@ test_ring_negative_tests(void)
 
 		rte_ring_free(rp);
 		rp = NULL;
+
+		/* Ticket mode can't be mixed with other sync modes */
+		rp = test_ring_create("test_ring_ticket", esize[i], RING_SIZE,
+					SOCKET_ID_ANY,
+					RING_F_MT_TICKET | RING_F_SP_ENQ);
+		if (rp != NULL) {
+			printf("Test failed to detect invalid ticket flags\n");
+			goto test_fail;
+		}
+	}
+
+	/* Ticket mode needs the element size, not available at ring init */
+	rp = rte_zmalloc(NULL, rte_ring_get_memsize(RING_SIZE), 0);
+	if (rp == NULL)
+		goto test_fail;
+	if (rte_ring_init(rp, "test_ring_ticket", RING_SIZE,
+			RING_F_MT_TICKET) == 0) {
+		printf("Test failed to reject ticket mode at ring init\n");
+		rte_free(rp);
+		rp = NULL;
+		goto test_fail;
 	}
+	rte_free(rp);
 
 	return 0;
 
@@ -1190,6 +1238,82 @@ test_ring_with_exact_size(void)
 	return -1;
 }
 
+/*
+ * Ticket sync mode keeps per-slot state, check that reset restores it
+ * wherever the previous operations left the ring.
+ */
+static int
+test_ring_ticket_reset(void)
+{
+	struct rte_ring *r = NULL;
+	void **src = NULL, **dst = NULL;
+	const unsigned int ring_sz = 64;
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < RTE_DIM(esize); i++) {
+		test_ring_print_test_string("Test ticket ring reset",
+				TEST_RING_IGNORE_API_TYPE, esize[i]);
+
+		r = test_ring_create("ticket_reset", esize[i], ring_sz,
+				rte_socket_id(), RING_F_MT_TICKET);
+		if (r == NULL) {
+			printf("%s: error, can't create ring\n", __func__);
+			goto test_fail;
+		}
+
+		src = test_ring_calloc(ring_sz, esize[i]);
+		dst = test_ring_calloc(ring_sz, esize[i]);
+		if (src == NULL || dst == NULL)
+			goto test_fail;
+		test_ring_mem_init(src, ring_sz, esize[i]);
+
+		/* leave the ring in the middle of the second lap */
+		ret = test_ring_enqueue(r, src, esize[i], ring_sz - 1,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK);
+		TEST_RING_VERIFY(ret == (int)ring_sz - 1, r, goto test_fail);
+		ret = test_ring_dequeue(r, dst, esize[i], ring_sz / 2,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK);
+		TEST_RING_VERIFY(ret == (int)ring_sz / 2, r, goto test_fail);
+		ret = test_ring_enqueue(r, src, esize[i], 7,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK);
+		TEST_RING_VERIFY(ret == 7, r, goto test_fail);
+
+		rte_ring_reset(r);
+		TEST_RING_VERIFY(rte_ring_empty(r), r, goto test_fail);
+		TEST_RING_VERIFY(rte_ring_free_count(r) == ring_sz - 1, r,
+				goto test_fail);
+
+		/* a full lap after reset must not block on stale slots */
+		ret = test_ring_enqueue(r, src, esize[i], ring_sz,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BURST);
+		TEST_RING_VERIFY(ret == (int)ring_sz - 1, r, goto test_fail);
+		TEST_RING_VERIFY(rte_ring_full(r), r, goto test_fail);
+		ret = test_ring_dequeue(r, dst, esize[i], ring_sz,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BURST);
+		TEST_RING_VERIFY(ret == (int)ring_sz - 1, r, goto test_fail);
+		TEST_RING_VERIFY(test_ring_mem_cmp(src, dst,
+				(ring_sz - 1) * (esize[i] == -1 ?
+				sizeof(void *) : (size_t)esize[i])) == 0,
+				r, goto test_fail);
+
+		rte_free(src);
+		rte_free(dst);
+		rte_ring_free(r);
+		src = NULL;
+		dst = NULL;
+		r = NULL;
+	}
+
+	return 0;
+
+test_fail:
+	rte_free(src);
+	rte_free(dst);
+	rte_ring_free(r);
+	return -1;
+}
+
 static int
 test_ring(void)
 {
@@ -1207,6 +1331,9 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	if (test_ring_ticket_reset() < 0)
+		goto test_fail;
+
 	/* Burst and bulk operations with sp/sc, mp/mc and default.
 	 * The test cases are split into smaller test cases to
 	 * help clang compile faster.
@@ -420,6 +420,180 @@ run_on_all_cores(struct rte_ring *r, const int esize)
 	return 0;
 }
 
+#define FAN_IN_MAX_PRODUCERS 64
+
+static uint32_t fan_in_stop;
+
+/*
+ * Fan-in producer: enqueue bulks with the default sync mode of the ring
+ * till the consumer asks to stop. Counts the objects enqueued.
+ */
+static __rte_always_inline int
+fan_in_producer_helper(struct thread_params *p, const int esize)
+{
+	uint64_t lcount = 0;
+	const unsigned int lcore = rte_lcore_id();
+	void *burst = NULL;
+
+	burst = test_ring_calloc(MAX_BURST, esize);
+	if (burst == NULL)
+		return -1;
+
+	rte_wait_until_equal_32(&synchro, 1, __ATOMIC_RELAXED);
+
+	while (__atomic_load_n(&fan_in_stop, __ATOMIC_RELAXED) == 0) {
+		if (test_ring_enqueue(p->r, burst, esize, p->size,
+				TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK) != 0)
+			lcount += p->size;
+		else
+			rte_pause();
+	}
+	queue_count[lcore] = lcount;
+
+	rte_free(burst);
+
+	return 0;
+}
+
+static int
+fan_in_producer(void *p)
+{
+	return fan_in_producer_helper(p, -1);
+}
+
+static int
+fan_in_producer_16B(void *p)
+{
+	return fan_in_producer_helper(p, 16);
+}
+
+/*
+ * Run *nb_prod* producers against a single consumer on the main lcore,
+ * returns the consumer cost in cycles per object, or a negative value
+ * if the number of dequeued objects doesn't match the enqueued ones.
+ */
+static double
+fan_in_run(struct rte_ring *r, const int esize, unsigned int nb_prod)
+{
+	struct thread_params param;
+	lcore_function_t *lcore_f;
+	uint64_t begin, start, end, enq, deq, n;
+	const uint64_t hz = rte_get_timer_hz();
+	void *burst = NULL;
+	unsigned int c, i;
+
+	burst = test_ring_calloc(MAX_BURST, esize);
+	if (burst == NULL)
+		return -1;
+
+	if (esize == -1)
+		lcore_f = fan_in_producer;
+	else
+		lcore_f = fan_in_producer_16B;
+
+	memset(&param, 0, sizeof(param));
+	param.r = r;
+	param.size = bulk_sizes[0];
+
+	__atomic_store_n(&synchro, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&fan_in_stop, 0, __ATOMIC_RELAXED);
+
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(c) {
+		if (i++ == nb_prod)
+			break;
+		queue_count[c] = 0;
+		if (rte_eal_remote_launch(lcore_f, &param, c) < 0) {
+			/* release producers that are already running */
+			__atomic_store_n(&fan_in_stop, 1, __ATOMIC_RELAXED);
+			__atomic_store_n(&synchro, 1, __ATOMIC_RELAXED);
+			rte_eal_mp_wait_lcore();
+			rte_free(burst);
+			return -1;
+		}
+	}
+
+	deq = 0;
+	begin = rte_get_timer_cycles();
+	start = rte_rdtsc();
+	__atomic_store_n(&synchro, 1, __ATOMIC_RELAXED);
+	while (rte_get_timer_cycles() - begin < hz * TIME_MS / 1000)
+		deq += test_ring_dequeue(r, burst, esize, MAX_BURST,
+			TEST_RING_THREAD_DEF | TEST_RING_ELEM_BURST);
+	end = rte_rdtsc();
+
+	__atomic_store_n(&fan_in_stop, 1, __ATOMIC_RELAXED);
+	rte_eal_mp_wait_lcore();
+
+	/* drain what producers managed to put after the measurement */
+	n = deq;
+	while (rte_ring_count(r) != 0)
+		n += test_ring_dequeue(r, burst, esize, MAX_BURST,
+			TEST_RING_THREAD_DEF | TEST_RING_ELEM_BURST);
+
+	enq = 0;
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(c) {
+		if (i++ == nb_prod)
+			break;
+		enq += queue_count[c];
+	}
+
+	rte_free(burst);
+
+	if (enq != n) {
+		printf("%s: enqueued %"PRIu64" objects, dequeued %"PRIu64"\n",
+			__func__, enq, n);
+		return -1;
+	}
+
+	return (deq == 0) ? 0 : (double)(end - start) / deq;
+}
+
+/*
+ * Fan-in test: 1 to 64 producers enqueue into the same ring, while one
+ * consumer drains it. Compares sync modes as the number of producers grows.
+ */
+static int
+run_fan_in(const int esize)
+{
+	static const struct {
+		const char *desc;
+		uint32_t flags;
+	} modes[] = {
+		{ "MP/MC", 0 },
+		{ "MP_RTS/MC_RTS", RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ },
+		{ "MP_HTS/MC_HTS", RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ },
+		{ "MP_TICKET/MC_TICKET", RING_F_MT_TICKET },
+	};
+	struct rte_ring *r;
+	unsigned int i, nb_prod;
+	double cycles;
+
+	for (nb_prod = 1; nb_prod <= FAN_IN_MAX_PRODUCERS &&
+			nb_prod < rte_lcore_count(); nb_prod <<= 1) {
+		printf("\nFan-in with %u producer(s), bulk size %u\n",
+			nb_prod, bulk_sizes[0]);
+
+		for (i = 0; i != RTE_DIM(modes); i++) {
+			r = test_ring_create(RING_NAME "_FAN_IN", esize,
+				RING_SIZE, rte_socket_id(), modes[i].flags);
+			if (r == NULL)
+				return -1;
+
+			cycles = fan_in_run(r, esize, nb_prod);
+			rte_ring_free(r);
+			if (cycles < 0)
+				return -1;
+
+			printf("%s: consumer cycles per object: %.2F\n",
+				modes[i].desc, cycles);
+		}
+	}
+
+	return 0;
+}
+
 /*
  * Test function that determines how long an enqueue + dequeue of a single item
  * takes on a single lcore. Result is for comparison with the bulk enq+deq.
@@ -556,6 +730,10 @@ test_ring_perf_esize(const int esize)
 	if (run_on_all_cores(r, esize) < 0)
 		goto test_fail;
 
+	printf("\n### Testing fan-in from multiple producers ###\n");
+	if (run_fan_in(esize) < 0)
+		goto test_fail;
+
 	rte_ring_free(r);
 
 	return 0;
@@ -436,6 +436,126 @@ service_lcore_attr_get(void)
 	return unregister_all();
 }
 
+static int32_t dummy_idle_cb(void *args)
+{
+	uint32_t *calls = args;
+
+	/* every other call has nothing to do */
+	if ((*calls)++ & 1)
+		return -EAGAIN;
+	rte_delay_us(10);
+	return 0;
+}
+
+/* verify per lcore service statistics */
+static int
+service_lcore_service_attr_get(void)
+{
+	/* ensure all services unregistered so statistics are zero */
+	unregister_all();
+
+	uint32_t calls = 0;
+	struct rte_service_spec service;
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = dummy_idle_cb;
+	service.callback_userdata = &calls;
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	uint32_t id;
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of  service failed");
+	rte_service_component_runstate_set(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Error: Service start returned non-zero");
+	rte_service_set_stats_enable(id, 1);
+
+	uint64_t attr_value = 0xdead;
+	uint64_t hist[RTE_SERVICE_CYCLES_HIST_BUCKETS];
+	uint32_t attr_id = UINT32_MAX;
+	uint32_t lcore = rte_lcore_id();
+	uint64_t sum;
+	uint32_t i;
+
+	/* check error return values */
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_service_attr_get(lcore,
+			id, attr_id, &attr_value),
+			"Invalid attr_id didn't return -EINVAL");
+	attr_id = RTE_SERVICE_LCORE_SERVICE_ATTR_CALL_COUNT;
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_service_attr_get(
+			RTE_MAX_LCORE, id, attr_id, &attr_value),
+			"Invalid lcore didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_service_attr_get(lcore,
+			UINT32_MAX, attr_id, &attr_value),
+			"Invalid service id didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_service_attr_get(lcore,
+			id, attr_id, NULL),
+			"Invalid attr_value pointer didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_lcore_service_cycles_hist_get(
+			lcore, id, NULL),
+			"Invalid hist pointer didn't return -EINVAL");
+
+	/* run the service on the app lcore, half of the calls are idle */
+	for (i = 0; i < 10; i++)
+		TEST_ASSERT_EQUAL(0, rte_service_run_iter_on_app_lcore(id, 1),
+				"Failed to run service on app lcore");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_service_attr_get(lcore, id,
+			RTE_SERVICE_LCORE_SERVICE_ATTR_CALL_COUNT, &attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(10, attr_value, "Wrong call count");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_service_attr_get(lcore, id,
+			RTE_SERVICE_LCORE_SERVICE_ATTR_IDLE_CALL_COUNT,
+			&attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(5, attr_value, "Wrong idle call count");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_service_attr_get(lcore, id,
+			RTE_SERVICE_LCORE_SERVICE_ATTR_BUSY_CYCLES, &attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT(attr_value > 0, "Busy cycles not counted");
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id,
+			RTE_SERVICE_ATTR_IDLE_CALL_COUNT, &attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(5, attr_value, "Wrong service idle call count");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_service_cycles_hist_get(lcore,
+			id, hist),
+			"Valid hist_get() call didn't return success");
+	for (i = 0, sum = 0; i < RTE_SERVICE_CYCLES_HIST_BUCKETS; i++)
+		sum += hist[i];
+	TEST_ASSERT_EQUAL(5, sum, "Histogram doesn't count busy calls");
+
+	/* run the service on a service core */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+
+	/* wait for the service lcore to run */
+	rte_delay_ms(200);
+
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 0),
+			"Disabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_service_attr_get(slcore_id, id,
+			RTE_SERVICE_LCORE_SERVICE_ATTR_IDLE_CALL_COUNT,
+			&attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT(attr_value > 0, "Service core idle calls not counted");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_reset_all(slcore_id),
+			"Valid lcore_attr_reset_all() didn't return success");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_service_attr_get(slcore_id, id,
+			RTE_SERVICE_LCORE_SERVICE_ATTR_CALL_COUNT, &attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(0, attr_value, "Call count not reset");
+
+	return unregister_all();
+}
+
 /* verify service dump */
 static int
 service_dump(void)
@@ -1002,6 +1122,138 @@ service_active_two_cores(void)
 	return unregister_all();
 }
 
+static int32_t dummy_load_cb(void *args)
+{
+	uint32_t *busy_us = args;
+
+	if (__atomic_load_n(busy_us, __ATOMIC_RELAXED) == 0)
+		return -EAGAIN;
+	rte_delay_us(__atomic_load_n(busy_us, __ATOMIC_RELAXED));
+	return 0;
+}
+
+/* verify services are spread when over budget, and gathered when idle */
+static int
+service_balance(void)
+{
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	unregister_all();
+
+	static uint32_t busy_us;
+	struct rte_service_balance_conf conf = {
+		.min_lcores = 1,
+		.max_lcores = 2,
+		.latency_budget_us = 300,
+		.low_util = 20,
+	};
+	struct rte_service_spec service;
+	uint32_t ids[2];
+	uint32_t i;
+	int j;
+
+	uint32_t slcore_1 = rte_get_next_lcore(/* start core */ -1,
+					       /* skip main */ 1,
+					       /* wrap */ 0);
+	uint32_t slcore_2 = rte_get_next_lcore(/* start core */ slcore_1,
+					       /* skip main */ 1,
+					       /* wrap */ 0);
+
+	TEST_ASSERT_EQUAL(-ENOTSUP, rte_service_balance(),
+			"Balancing not enabled didn't return -ENOTSUP");
+	conf.min_lcores = 0;
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_balance_conf_set(&conf),
+			"Invalid min_lcores didn't return -EINVAL");
+	conf.min_lcores = 1;
+	TEST_ASSERT_EQUAL(0, rte_service_balance_conf_set(&conf),
+			"Valid balance conf failed");
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_1),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_2),
+			"Service core add did not return zero");
+
+	/* two services, each busy 200us per call, on the first lcore */
+	busy_us = 200;
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = dummy_load_cb;
+	service.callback_userdata = &busy_us;
+	for (i = 0; i < RTE_DIM(ids); i++) {
+		snprintf(service.name, sizeof(service.name),
+				DUMMY_SERVICE_NAME "_%u", i);
+		TEST_ASSERT_EQUAL(0, rte_service_component_register(&service,
+				&ids[i]), "Register of service failed");
+		rte_service_component_runstate_set(ids[i], 1);
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(ids[i], 1),
+				"Error: Service start returned non-zero");
+		rte_service_set_stats_enable(ids[i], 1);
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(ids[i],
+				slcore_1, 1),
+				"Enabling valid service and core failed");
+	}
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_1),
+			"Starting service core failed");
+
+	/* first call only measures */
+	TEST_ASSERT_EQUAL(0, rte_service_balance(),
+			"Balancing moved services without measurements");
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(1, rte_service_balance(),
+			"Balancing didn't move a service over budget");
+	TEST_ASSERT_EQUAL(1, rte_service_map_lcore_get(ids[0], slcore_2) +
+			rte_service_map_lcore_get(ids[1], slcore_2),
+			"No service moved to the second lcore");
+	TEST_ASSERT_EQUAL(1, rte_service_lcore_may_be_active(slcore_2),
+			"Second service lcore not started");
+
+	/* idle services are gathered on a single lcore */
+	__atomic_store_n(&busy_us, 0, __ATOMIC_RELAXED);
+	rte_service_balance();
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(1, rte_service_balance(),
+			"Balancing didn't gather the idle services");
+	TEST_ASSERT_EQUAL(1, rte_service_map_lcore_get(ids[0], slcore_1) +
+			rte_service_map_lcore_get(ids[0], slcore_2),
+			"Service mapped to more than one lcore");
+	TEST_ASSERT_EQUAL(rte_service_map_lcore_get(ids[0], slcore_1),
+			rte_service_map_lcore_get(ids[1], slcore_1),
+			"Services not gathered on the same lcore");
+
+	/* no lcore is stopped below min_lcores */
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(0, rte_service_balance(),
+			"Balancing moved services below min_lcores");
+
+	TEST_ASSERT_EQUAL(0, rte_service_balance_conf_set(NULL),
+			"Disabling balancing failed");
+
+	/* stop the services and their lcores before unregistering them */
+	for (i = 0; i < RTE_DIM(ids); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(ids[i], 0),
+				"Error: Service stop returned non-zero");
+
+	/* give the services 100ms to stop running */
+	for (i = 0; i < RTE_DIM(ids); i++) {
+		for (j = 0; j < 100; j++) {
+			if (!rte_service_may_be_active(ids[i]))
+				break;
+			rte_delay_ms(SERVICE_DELAY);
+		}
+		TEST_ASSERT_EQUAL(0, rte_service_may_be_active(ids[i]),
+				"Error: Service not stopped after 100ms");
+	}
+
+	/* the lcore left without service may already be stopped */
+	rte_service_lcore_stop(slcore_1);
+	rte_service_lcore_stop(slcore_2);
+	wait_slcore_inactive(slcore_1);
+	wait_slcore_inactive(slcore_2);
+
+	return unregister_all();
+}
+
 static struct unit_test_suite service_tests  = {
 	.suite_name = "service core test suite",
 	.setup = testsuite_setup,
@@ -1013,6 +1265,8 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_dump),
 		TEST_CASE_ST(dummy_register, NULL, service_attr_get),
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_attr_get),
+		TEST_CASE_ST(dummy_register, NULL,
+				service_lcore_service_attr_get),
 		TEST_CASE_ST(dummy_register, NULL, service_probe_capability),
 		TEST_CASE_ST(dummy_register, NULL, service_start_stop),
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_add_del),
@@ -1024,6 +1278,7 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_app_lcore_mt_unsafe),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
 		TEST_CASE_ST(dummy_register, NULL, service_active_two_cores),
+		TEST_CASE_ST(dummy_register, NULL, service_balance),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
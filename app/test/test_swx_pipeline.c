@@ -0,0 +1,702 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_mbuf.h>
+#include <rte_ring.h>
+#include <rte_swx_ctl.h>
+#include <rte_swx_pipeline.h>
+#include <rte_swx_port_ring.h>
+
+#include "test.h"
+
+/*
+ * Runs the same packets through the SWX pipeline built with and without
+ * the JIT and checks that every output port gets the same packets, in
+ * the same order. The perf test reports the cycles per packet of both.
+ *
+ * The shared object library built with gcc takes precedence over the
+ * JIT, so RTE_INSTALL_DIR is unset while the pipelines are built.
+ */
+
+#define N_PORTS_OUT 4
+#define RING_SIZE 1024
+#define BURST_SIZE 32
+#define NB_MBUF 4096
+#define PKT_LEN 64
+#define N_PKTS 512
+#define N_PERF_ITERS 20000
+#define N_PERF_REPEAT 5
+
+enum swx_mode {
+	SWX_MODE_INTERPRETER,
+	SWX_MODE_JIT,
+	SWX_MODE_MAX,
+};
+
+static const char * const swx_mode_names[SWX_MODE_MAX] = {
+	[SWX_MODE_INTERPRETER] = "interpreter",
+	[SWX_MODE_JIT] = "jit",
+};
+
+struct swx_test_spec {
+	const char *name;
+	const char *spec;
+	int (*setup)(struct rte_swx_ctl_pipeline *ctl);
+};
+
+struct swx_test_out {
+	uint32_t n_pkts[N_PORTS_OUT];
+	uint8_t data[N_PORTS_OUT][N_PKTS][PKT_LEN];
+	uint16_t len[N_PORTS_OUT][N_PKTS];
+};
+
+struct swx_test_pipeline {
+	struct rte_swx_pipeline *p;
+	struct rte_ring *in;
+	struct rte_ring *out[N_PORTS_OUT];
+};
+
+static struct rte_mempool *pkt_pool;
+
+#define SWX_TEST_HEADERS \
+	"struct ethernet_h {\n" \
+	"	bit<48> dst_addr\n" \
+	"	bit<48> src_addr\n" \
+	"	bit<16> ethertype\n" \
+	"}\n" \
+	"\n" \
+	"struct ipv4_h {\n" \
+	"	bit<8> ver_ihl\n" \
+	"	bit<8> diffserv\n" \
+	"	bit<16> total_len\n" \
+	"	bit<16> identification\n" \
+	"	bit<16> flags_offset\n" \
+	"	bit<8> ttl\n" \
+	"	bit<8> protocol\n" \
+	"	bit<16> hdr_checksum\n" \
+	"	bit<32> src_addr\n" \
+	"	bit<32> dst_addr\n" \
+	"}\n" \
+	"\n" \
+	"header ethernet instanceof ethernet_h\n" \
+	"header ipv4 instanceof ipv4_h\n"
+
+/* Exercises the instructions that the JIT encodes natively. */
+static const char swx_spec_jmp[] =
+	SWX_TEST_HEADERS
+	"\n"
+	"struct metadata_t {\n"
+	"	bit<32> port_in\n"
+	"	bit<32> port_out\n"
+	"	bit<16> ethertype\n"
+	"	bit<32> src_addr\n"
+	"}\n"
+	"\n"
+	"metadata instanceof metadata_t\n"
+	"\n"
+	"struct fwd_args_t {\n"
+	"	bit<48> dst_addr\n"
+	"	bit<32> port_out\n"
+	"}\n"
+	"\n"
+	"action fwd args instanceof fwd_args_t {\n"
+	"	mov h.ethernet.dst_addr t.dst_addr\n"
+	"	mov m.port_out t.port_out\n"
+	"	jmpgt LABEL_TTL h.ipv4.ttl 1\n"
+	"	mov m.port_out 3\n"
+	"	return\n"
+	"	LABEL_TTL : sub h.ipv4.ttl 1\n"
+	"	mov m.src_addr h.ipv4.src_addr\n"
+	"	jmplt LABEL_END m.src_addr 0x80000000\n"
+	"	mov h.ethernet.src_addr h.ethernet.dst_addr\n"
+	"	LABEL_END : return\n"
+	"}\n"
+	"\n"
+	"action miss args none {\n"
+	"	mov m.port_out 2\n"
+	"	invalidate h.ipv4\n"
+	"	return\n"
+	"}\n"
+	"\n"
+	"table fwd_table {\n"
+	"	key {\n"
+	"		h.ipv4.dst_addr exact\n"
+	"	}\n"
+	"	actions {\n"
+	"		fwd\n"
+	"		miss\n"
+	"	}\n"
+	"	default_action miss args none\n"
+	"	size 64\n"
+	"}\n"
+	"\n"
+	"apply {\n"
+	"	rx m.port_in\n"
+	"	extract h.ethernet\n"
+	"	mov m.ethertype h.ethernet.ethertype\n"
+	"	jmpeq LABEL_IPV4 m.ethertype 0x0800\n"
+	"	mov m.port_out 1\n"
+	"	jmp LABEL_TX\n"
+	"	LABEL_IPV4 : extract h.ipv4\n"
+	"	table fwd_table\n"
+	"	jmpa LABEL_FWD fwd\n"
+	"	jmpv LABEL_TX h.ipv4\n"
+	"	mov h.ethernet.ethertype 0x86dd\n"
+	"	jmp LABEL_TX\n"
+	"	LABEL_FWD : jmph LABEL_HIT\n"
+	"	mov m.port_out 0\n"
+	"	LABEL_HIT : jmpneq LABEL_TX h.ipv4.protocol 17\n"
+	"	validate h.ipv4\n"
+	"	mov h.ipv4.identification m.port_out\n"
+	"	LABEL_TX : emit h.ethernet\n"
+	"	emit h.ipv4\n"
+	"	tx m.port_out\n"
+	"}\n";
+
+static int
+swx_setup_jmp(struct rte_swx_ctl_pipeline *ctl)
+{
+	struct rte_swx_table_entry *entry;
+	char line[128];
+	uint32_t i;
+	int blank, status;
+
+	for (i = 0; i < N_PORTS_OUT; i++) {
+		snprintf(line, sizeof(line),
+			 "match 0x0a00000%u action fwd "
+			 "dst_addr 0xa0a1a2a3a4a%u port_out %u", i, i, i);
+
+		entry = rte_swx_ctl_pipeline_table_entry_read(ctl, "fwd_table",
+							      line, &blank);
+		if (entry == NULL)
+			return -EINVAL;
+
+		status = rte_swx_ctl_pipeline_table_entry_add(ctl, "fwd_table",
+							      entry);
+		free(entry->key);
+		free(entry->key_mask);
+		free(entry->action_data);
+		free(entry);
+		if (status)
+			return status;
+	}
+
+	return 0;
+}
+
+/* The learn instruction runs from within the action of a learner table. */
+static const char swx_spec_learner[] =
+	SWX_TEST_HEADERS
+	"\n"
+	"struct metadata_t {\n"
+	"	bit<32> port_in\n"
+	"	bit<32> port_out\n"
+	"	bit<32> fwd_action_arg_port_out\n"
+	"}\n"
+	"\n"
+	"metadata instanceof metadata_t\n"
+	"\n"
+	"regarray counter size 1 initval 0\n"
+	"\n"
+	"struct fwd_action_args_t {\n"
+	"	bit<32> port_out\n"
+	"}\n"
+	"\n"
+	"action fwd_action args instanceof fwd_action_args_t {\n"
+	"	mov m.port_out t.port_out\n"
+	"	return\n"
+	"}\n"
+	"\n"
+	"action learn_action args none {\n"
+	"	regrd m.fwd_action_arg_port_out counter 0\n"
+	"	regadd counter 0 1\n"
+	"	and m.fwd_action_arg_port_out 3\n"
+	"	learn fwd_action m.fwd_action_arg_port_out\n"
+	"	mov m.port_out m.fwd_action_arg_port_out\n"
+	"	return\n"
+	"}\n"
+	"\n"
+	"learner fwd_table {\n"
+	"	key {\n"
+	"		h.ipv4.dst_addr\n"
+	"	}\n"
+	"	actions {\n"
+	"		fwd_action\n"
+	"		learn_action\n"
+	"	}\n"
+	"	default_action learn_action args none\n"
+	"	size 1024\n"
+	"	timeout 120\n"
+	"}\n"
+	"\n"
+	"apply {\n"
+	"	rx m.port_in\n"
+	"	extract h.ethernet\n"
+	"	extract h.ipv4\n"
+	"	table fwd_table\n"
+	"	emit h.ethernet\n"
+	"	emit h.ipv4\n"
+	"	tx m.port_out\n"
+	"}\n";
+
+/* Has no action, only pipeline instructions around the selector. */
+static const char swx_spec_selector[] =
+	SWX_TEST_HEADERS
+	"\n"
+	"struct metadata_t {\n"
+	"	bit<32> port_in\n"
+	"	bit<32> port_out\n"
+	"	bit<32> group_id\n"
+	"}\n"
+	"\n"
+	"metadata instanceof metadata_t\n"
+	"\n"
+	"selector s {\n"
+	"	group_id m.group_id\n"
+	"	selector {\n"
+	"		h.ipv4.protocol\n"
+	"		h.ipv4.src_addr\n"
+	"		h.ipv4.dst_addr\n"
+	"	}\n"
+	"	member_id m.port_out\n"
+	"	n_groups_max 4\n"
+	"	n_members_per_group_max 16\n"
+	"}\n"
+	"\n"
+	"apply {\n"
+	"	rx m.port_in\n"
+	"	extract h.ethernet\n"
+	"	extract h.ipv4\n"
+	"	mov m.group_id h.ethernet.dst_addr\n"
+	"	table s\n"
+	"	emit h.ethernet\n"
+	"	emit h.ipv4\n"
+	"	tx m.port_out\n"
+	"}\n";
+
+static int
+swx_setup_selector(struct rte_swx_ctl_pipeline *ctl)
+{
+	uint32_t group_id, i;
+	int status;
+
+	for (i = 0; i < 2; i++) {
+		status = rte_swx_ctl_pipeline_selector_group_add(ctl, "s",
+								 &group_id);
+		if (status)
+			return status;
+	}
+
+	/* group 0: members 0 to 3 with weights 1, 1, 2 and 4. */
+	for (i = 0; i < N_PORTS_OUT; i++) {
+		status = rte_swx_ctl_pipeline_selector_group_member_add(ctl,
+				"s", 0, i, i < 2 ? 1 : 2 * (i - 1));
+		if (status)
+			return status;
+	}
+
+	/* group 1: members 1 and 2. */
+	for (i = 1; i < 3; i++) {
+		status = rte_swx_ctl_pipeline_selector_group_member_add(ctl,
+				"s", 1, i, 1);
+		if (status)
+			return status;
+	}
+
+	return 0;
+}
+
+static const struct swx_test_spec swx_specs[] = {
+	{ "jmp", swx_spec_jmp, swx_setup_jmp },
+	{ "learner", swx_spec_learner, NULL },
+	{ "selector", swx_spec_selector, swx_setup_selector },
+};
+
+/*
+ * Packet i of the test: IPv4 over Ethernet, except for one out of eight,
+ * with the fields matched by the specs above varying with i.
+ */
+static void
+swx_pkt_gen(uint32_t i, uint8_t *d)
+{
+	uint32_t src_addr = i * 0x9e3779b9;
+
+	memset(d, 0, PKT_LEN);
+
+	/* Ethernet: dst_addr selects the selector group. */
+	d[5] = i & 1;
+	d[6] = 0x02;
+	d[11] = i;
+	d[12] = (i % 8 == 7) ? 0x86 : 0x08;
+	d[13] = (i % 8 == 7) ? 0xdd : 0x00;
+
+	/* IPv4: dst_addr 10.0.0.0 to 10.0.0.5, only the first four match. */
+	d[14] = 0x45;
+	d[17] = PKT_LEN - 14;
+	d[22] = i % 4;
+	d[23] = (i % 3) ? 17 : 6;
+	d[26] = src_addr >> 24;
+	d[27] = src_addr >> 16;
+	d[28] = src_addr >> 8;
+	d[29] = src_addr;
+	d[30] = 10;
+	d[33] = i % 6;
+}
+
+static void
+swx_pipeline_free(struct swx_test_pipeline *sp)
+{
+	uint32_t i;
+
+	rte_swx_pipeline_free(sp->p);
+	rte_ring_free(sp->in);
+	for (i = 0; i < N_PORTS_OUT; i++)
+		rte_ring_free(sp->out[i]);
+	memset(sp, 0, sizeof(*sp));
+}
+
+static int
+swx_pipeline_create(struct swx_test_pipeline *sp,
+		    const struct swx_test_spec *s, enum swx_mode mode)
+{
+	struct rte_swx_port_ring_reader_params in_params;
+	struct rte_swx_port_ring_writer_params out_params;
+	struct rte_swx_ctl_pipeline *ctl;
+	char *install_dir = NULL;
+	const char *err_msg;
+	char name[RTE_RING_NAMESIZE];
+	uint32_t err_line, i;
+	FILE *f;
+	int status;
+
+	memset(sp, 0, sizeof(*sp));
+
+	sp->in = rte_ring_create("swx_test_in", RING_SIZE, SOCKET_ID_ANY,
+				 RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (sp->in == NULL)
+		goto error;
+
+	for (i = 0; i < N_PORTS_OUT; i++) {
+		snprintf(name, sizeof(name), "swx_test_out%u", i);
+		sp->out[i] = rte_ring_create(name, RING_SIZE, SOCKET_ID_ANY,
+					     RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (sp->out[i] == NULL)
+			goto error;
+	}
+
+	if (rte_swx_pipeline_config(&sp->p, SOCKET_ID_ANY))
+		goto error;
+
+	in_params.name = "swx_test_in";
+	in_params.burst_size = BURST_SIZE;
+	if (rte_swx_pipeline_port_in_config(sp->p, 0, "ring", &in_params))
+		goto error;
+
+	for (i = 0; i < N_PORTS_OUT; i++) {
+		out_params.name = sp->out[i]->name;
+		out_params.burst_size = BURST_SIZE;
+		if (rte_swx_pipeline_port_out_config(sp->p, i, "ring",
+						     &out_params))
+			goto error;
+	}
+
+	f = fmemopen((void *)(uintptr_t)s->spec, strlen(s->spec), "r");
+	if (f == NULL)
+		goto error;
+
+	if (getenv("RTE_INSTALL_DIR") != NULL) {
+		install_dir = strdup(getenv("RTE_INSTALL_DIR"));
+		unsetenv("RTE_INSTALL_DIR");
+	}
+	setenv("RTE_SWX_PIPELINE_JIT", mode == SWX_MODE_JIT ? "1" : "0", 1);
+
+	status = rte_swx_pipeline_build_from_spec(sp->p, f, &err_line,
+						  &err_msg);
+
+	unsetenv("RTE_SWX_PIPELINE_JIT");
+	if (install_dir != NULL) {
+		setenv("RTE_INSTALL_DIR", install_dir, 1);
+		free(install_dir);
+	}
+	fclose(f);
+
+	if (status) {
+		printf("%s: spec line %u: %s\n", s->name, err_line, err_msg);
+		goto error;
+	}
+
+	if (s->setup != NULL) {
+		ctl = rte_swx_ctl_pipeline_create(sp->p);
+		if (ctl == NULL)
+			goto error;
+
+		status = s->setup(ctl);
+		if (!status)
+			status = rte_swx_ctl_pipeline_commit(ctl, 1);
+		rte_swx_ctl_pipeline_free(ctl);
+		if (status) {
+			printf("%s: table setup failed\n", s->name);
+			goto error;
+		}
+	}
+
+	return 0;
+
+error:
+	swx_pipeline_free(sp);
+	return -1;
+}
+
+static int
+swx_pkts_send(struct swx_test_pipeline *sp, uint32_t first, uint32_t n)
+{
+	struct rte_mbuf *pkts[BURST_SIZE];
+	uint32_t i;
+
+	if (rte_pktmbuf_alloc_bulk(pkt_pool, pkts, n))
+		return -1;
+
+	for (i = 0; i < n; i++)
+		swx_pkt_gen(first + i,
+			    (uint8_t *)rte_pktmbuf_append(pkts[i], PKT_LEN));
+
+	if (rte_ring_enqueue_burst(sp->in, (void **)pkts, n, NULL) != n) {
+		rte_pktmbuf_free_bulk(pkts, n);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Runs the pipeline until all the packets sent are out. */
+static void
+swx_pipeline_drain(struct swx_test_pipeline *sp)
+{
+	uint32_t i;
+
+	while (rte_ring_count(sp->in))
+		rte_swx_pipeline_run(sp->p, BURST_SIZE);
+
+	/* the packets still owned by the pipeline threads */
+	for (i = 0; i < 16; i++)
+		rte_swx_pipeline_run(sp->p, BURST_SIZE);
+
+	rte_swx_pipeline_flush(sp->p);
+}
+
+static void
+swx_pkts_recv(struct swx_test_pipeline *sp, struct swx_test_out *out)
+{
+	struct rte_mbuf *pkts[BURST_SIZE];
+	uint32_t port, n, i, k;
+
+	for (port = 0; port < N_PORTS_OUT; port++) {
+		while ((n = rte_ring_dequeue_burst(sp->out[port], (void **)pkts,
+						   BURST_SIZE, NULL)) != 0) {
+			for (i = 0; out != NULL && i < n; i++) {
+				k = out->n_pkts[port]++;
+				if (k >= N_PKTS)
+					continue;
+				out->len[port][k] = RTE_MIN(pkts[i]->pkt_len,
+							    (uint32_t)PKT_LEN);
+				rte_pktmbuf_read(pkts[i], 0, out->len[port][k],
+						 out->data[port][k]);
+			}
+			rte_pktmbuf_free_bulk(pkts, n);
+		}
+	}
+}
+
+static int
+swx_run(const struct swx_test_spec *s, enum swx_mode mode,
+	struct swx_test_out *out)
+{
+	struct swx_test_pipeline sp;
+	uint32_t i;
+
+	if (swx_pipeline_create(&sp, s, mode))
+		return -1;
+
+	memset(out, 0, sizeof(*out));
+	for (i = 0; i < N_PKTS; i += BURST_SIZE) {
+		if (swx_pkts_send(&sp, i, BURST_SIZE)) {
+			swx_pipeline_free(&sp);
+			return -1;
+		}
+		swx_pipeline_drain(&sp);
+		swx_pkts_recv(&sp, out);
+	}
+
+	swx_pipeline_free(&sp);
+	return 0;
+}
+
+static int
+test_swx_pipeline_jit(const struct swx_test_spec *s)
+{
+	struct swx_test_out *out[SWX_MODE_MAX];
+	uint32_t port, k, n_pkts = 0;
+	int mode, ret = TEST_FAILED;
+
+	out[SWX_MODE_INTERPRETER] = malloc(sizeof(struct swx_test_out));
+	out[SWX_MODE_JIT] = malloc(sizeof(struct swx_test_out));
+	if (out[SWX_MODE_INTERPRETER] == NULL || out[SWX_MODE_JIT] == NULL)
+		goto free;
+
+	for (mode = 0; mode < SWX_MODE_MAX; mode++)
+		if (swx_run(s, mode, out[mode])) {
+			printf("%s: %s run failed\n", s->name,
+			       swx_mode_names[mode]);
+			goto free;
+		}
+
+	for (port = 0; port < N_PORTS_OUT; port++) {
+		const struct swx_test_out *a = out[SWX_MODE_INTERPRETER];
+		const struct swx_test_out *b = out[SWX_MODE_JIT];
+
+		if (a->n_pkts[port] != b->n_pkts[port]) {
+			printf("%s: port %u: %u packets, %u with the JIT\n",
+			       s->name, port, a->n_pkts[port], b->n_pkts[port]);
+			goto free;
+		}
+
+		for (k = 0; k < a->n_pkts[port] && k < N_PKTS; k++)
+			if (a->len[port][k] != b->len[port][k] ||
+			    memcmp(a->data[port][k], b->data[port][k],
+				   a->len[port][k])) {
+				printf("%s: port %u: packet %u differs\n",
+				       s->name, port, k);
+				goto free;
+			}
+
+		n_pkts += a->n_pkts[port];
+	}
+
+	if (n_pkts != N_PKTS) {
+		printf("%s: %u packets out of %u\n", s->name, n_pkts, N_PKTS);
+		goto free;
+	}
+
+	ret = TEST_SUCCESS;
+free:
+	free(out[SWX_MODE_INTERPRETER]);
+	free(out[SWX_MODE_JIT]);
+	return ret;
+}
+
+/* Returns the cycles per packet of the pipeline run, I/O included. */
+static double
+swx_perf_run(const struct swx_test_spec *s, enum swx_mode mode)
+{
+	struct swx_test_pipeline sp;
+	uint64_t cycles = 0, start;
+	uint32_t i;
+
+	if (swx_pipeline_create(&sp, s, mode))
+		return -1;
+
+	for (i = 0; i < N_PERF_ITERS; i++) {
+		if (swx_pkts_send(&sp, i * BURST_SIZE, BURST_SIZE)) {
+			swx_pipeline_free(&sp);
+			return -1;
+		}
+
+		/* the pipeline threads keep the last packets until next time */
+		start = rte_rdtsc();
+		while (rte_ring_count(sp.in))
+			rte_swx_pipeline_run(sp.p, BURST_SIZE);
+		rte_swx_pipeline_flush(sp.p);
+		cycles += rte_rdtsc() - start;
+
+		swx_pkts_recv(&sp, NULL);
+	}
+
+	swx_pipeline_drain(&sp);
+	swx_pkts_recv(&sp, NULL);
+	swx_pipeline_free(&sp);
+	return (double)cycles / (N_PERF_ITERS * BURST_SIZE);
+}
+
+static int
+test_swx_pipeline_setup(void)
+{
+	pkt_pool = rte_pktmbuf_pool_create("swx_test_pool", NB_MBUF, 0, 0,
+					   RTE_MBUF_DEFAULT_BUF_SIZE,
+					   SOCKET_ID_ANY);
+	if (pkt_pool == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void
+test_swx_pipeline_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+static int
+test_swx_pipeline(void)
+{
+	uint32_t i;
+	int ret = TEST_SUCCESS;
+
+	if (test_swx_pipeline_setup())
+		return TEST_FAILED;
+
+	for (i = 0; i < RTE_DIM(swx_specs) && ret == TEST_SUCCESS; i++)
+		ret = test_swx_pipeline_jit(&swx_specs[i]);
+
+	test_swx_pipeline_teardown();
+	return ret;
+}
+
+static int
+test_swx_pipeline_perf(void)
+{
+	double best[SWX_MODE_MAX], cycles;
+	uint32_t i, r;
+	int mode;
+
+	if (test_swx_pipeline_setup())
+		return TEST_FAILED;
+
+	printf("Cycles per packet, best of %u runs of %u packets\n",
+	       N_PERF_REPEAT, N_PERF_ITERS * BURST_SIZE);
+
+	for (i = 0; i < RTE_DIM(swx_specs); i++) {
+		/* interleave the modes, so that noise hits both */
+		for (mode = 0; mode < SWX_MODE_MAX; mode++)
+			best[mode] = -1;
+		for (r = 0; r < N_PERF_REPEAT; r++)
+			for (mode = 0; mode < SWX_MODE_MAX; mode++) {
+				cycles = swx_perf_run(&swx_specs[i], mode);
+				if (cycles < 0) {
+					test_swx_pipeline_teardown();
+					return TEST_FAILED;
+				}
+				if (best[mode] < 0 || cycles < best[mode])
+					best[mode] = cycles;
+			}
+
+		printf("%-10s %s %6.1f, %s %6.1f\n", swx_specs[i].name,
+		       swx_mode_names[SWX_MODE_INTERPRETER],
+		       best[SWX_MODE_INTERPRETER],
+		       swx_mode_names[SWX_MODE_JIT], best[SWX_MODE_JIT]);
+	}
+
+	test_swx_pipeline_teardown();
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(swx_pipeline_autotest, test_swx_pipeline);
+REGISTER_TEST_COMMAND(swx_pipeline_perf_autotest, test_swx_pipeline_perf);
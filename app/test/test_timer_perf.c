@@ -16,15 +16,54 @@
 #include <rte_pause.h>
 
 #define MAX_ITERATIONS 1000000
+#define WHEEL_MAX_ITERATIONS 10000000
+#define WHEEL_TICKS_PER_SECOND 10000
 
 int outstanding_count = 0;
 
+/* timer data instance with a timer wheel, or the default one if zero */
+static uint32_t wheel_data_id;
+static uint64_t wheel_tick_cycles;
+
 static void
 timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 {
 	outstanding_count--;
 }
 
+static void
+wheel_manage_cb(struct rte_timer *tim)
+{
+	tim->f(tim, tim->arg);
+}
+
+static int
+perf_timer_reset(struct rte_timer *tim, uint64_t ticks, unsigned int lcore_id)
+{
+	if (wheel_tick_cycles != 0)
+		return rte_timer_alt_reset(wheel_data_id, tim, ticks, SINGLE,
+				lcore_id, timer_cb, NULL);
+	return rte_timer_reset(tim, ticks, SINGLE, lcore_id, timer_cb, NULL);
+}
+
+static void
+perf_timer_stop(struct rte_timer *tim)
+{
+	if (wheel_tick_cycles != 0)
+		rte_timer_alt_stop(wheel_data_id, tim);
+	else
+		rte_timer_stop(tim);
+}
+
+static void
+perf_timer_manage(void)
+{
+	if (wheel_tick_cycles != 0)
+		rte_timer_alt_manage(wheel_data_id, NULL, 0, wheel_manage_cb);
+	else
+		rte_timer_manage();
+}
+
 #define DELAY_SECONDS 1
 
 #ifdef RTE_EXEC_ENV_LINUX
@@ -34,7 +73,7 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #endif
 
 static int
-test_timer_perf(void)
+timer_perf_run(unsigned int max_iterations)
 {
 	unsigned iterations = 100;
 	unsigned i;
@@ -42,22 +81,26 @@ test_timer_perf(void)
 	uint64_t start_tsc, end_tsc, delay_start;
 	unsigned lcore_id = rte_lcore_id();
 
-	tms = rte_malloc(NULL, sizeof(*tms) * MAX_ITERATIONS, 0);
+	tms = rte_malloc(NULL, sizeof(*tms) * max_iterations, 0);
+	if (tms == NULL) {
+		printf("Not enough memory for %u timers, skipping\n",
+				max_iterations);
+		return 0;
+	}
 
-	for (i = 0; i < MAX_ITERATIONS; i++)
+	for (i = 0; i < max_iterations; i++)
 		rte_timer_init(&tms[i]);
 
 	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
 	const uint64_t ticks_per_ms = rte_get_tsc_hz()/1000;
 	const uint64_t ticks_per_us = ticks_per_ms/1000;
 
-	while (iterations <= MAX_ITERATIONS) {
+	while (iterations <= max_iterations) {
 
 		printf("Appending %u timers\n", iterations);
 		start_tsc = rte_rdtsc();
 		for (i = 0; i < iterations; i++)
-			rte_timer_reset(&tms[i], ticks, SINGLE, lcore_id,
-					timer_cb, NULL);
+			perf_timer_reset(&tms[i], ticks, lcore_id);
 		end_tsc = rte_rdtsc();
 		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
 				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
@@ -71,7 +114,7 @@ test_timer_perf(void)
 
 		start_tsc = rte_rdtsc();
 		while (outstanding_count)
-			rte_timer_manage();
+			perf_timer_manage();
 		end_tsc = rte_rdtsc();
 		printf("Time for %u callbacks: %"PRIu64" (%"PRIu64"ms), ", iterations,
 				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
@@ -82,8 +125,7 @@ test_timer_perf(void)
 		printf("Resetting %u timers\n", iterations);
 		start_tsc = rte_rdtsc();
 		for (i = 0; i < iterations; i++)
-			rte_timer_reset(&tms[i], rte_rand() % ticks, SINGLE, lcore_id,
-					timer_cb, NULL);
+			perf_timer_reset(&tms[i], rte_rand() % ticks, lcore_id);
 		end_tsc = rte_rdtsc();
 		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
 				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
@@ -92,11 +134,13 @@ test_timer_perf(void)
 				((end_tsc-start_tsc)/iterations+ticks_per_us/2)/(ticks_per_us));
 		outstanding_count = iterations;
 
+		/* timers of a wheel expire up to one tick late */
 		delay_start = rte_get_timer_cycles();
-		while (rte_get_timer_cycles() < delay_start + ticks)
+		while (rte_get_timer_cycles() <
+				delay_start + ticks + wheel_tick_cycles)
 			do_delay();
 
-		rte_timer_manage();
+		perf_timer_manage();
 		if (outstanding_count != 0) {
 			printf("Error: outstanding callback count = %d\n", outstanding_count);
 			return -1;
@@ -111,24 +155,52 @@ test_timer_perf(void)
 	/* measure time to poll an empty timer list */
 	start_tsc = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_timer_manage();
+		perf_timer_manage();
 	end_tsc = rte_rdtsc();
 	printf("\nTime per rte_timer_manage with zero timers: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
 	/* measure time to poll a timer list with timers, but without
 	 * calling any callbacks */
-	rte_timer_reset(&tms[0], ticks * 100, SINGLE, lcore_id,
-			timer_cb, NULL);
+	perf_timer_reset(&tms[0], ticks * 100, lcore_id);
 	start_tsc = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_timer_manage();
+		perf_timer_manage();
 	end_tsc = rte_rdtsc();
 	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
+	perf_timer_stop(&tms[0]);
 	rte_free(tms);
 	return 0;
 }
 
+static int
+test_timer_perf(void)
+{
+	int ret;
+
+	printf("Timers in skiplist\n");
+	ret = timer_perf_run(MAX_ITERATIONS);
+	if (ret != 0)
+		return ret;
+
+	printf("\nTimers in timer wheel\n");
+	ret = rte_timer_data_alloc_wheel(&wheel_data_id,
+			rte_get_timer_hz() / WHEEL_TICKS_PER_SECOND);
+	if (ret != 0) {
+		printf("Cannot allocate timer wheel: %d\n", ret);
+		return -1;
+	}
+	/* the wheel rounds its tick down to a power of 2 */
+	wheel_tick_cycles = rte_align64prevpow2(
+			rte_get_timer_hz() / WHEEL_TICKS_PER_SECOND);
+
+	ret = timer_perf_run(WHEEL_MAX_ITERATIONS);
+
+	rte_timer_data_dealloc(wheel_data_id);
+	wheel_tick_cycles = 0;
+	return ret;
+}
+
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
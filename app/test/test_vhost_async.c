@@ -0,0 +1,323 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_cycles.h>
+#include <rte_dmadev.h>
+#include <rte_eal.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+#include <rte_vhost.h>
+#include <rte_vhost_async.h>
+
+#define DMA_NAME "dma_skeleton"
+#define VIRTIO_USER_NAME "net_virtio_user_async_test"
+#define VIRTIO_TXQ 1 /* vhost queue the virtio Tx queue maps to */
+
+#define RING_SIZE 256
+#define NB_MBUF 2048
+#define NB_PKTS 16
+#define PKT_LEN 64
+#define TIMEOUT_MS 2000
+#define TEST_ETHER_TYPE 0x88b5 /* local experimental */
+
+static struct rte_mempool *mp;
+static char sock_path[PATH_MAX];
+static volatile int vhost_vid = -1;
+static int16_t dma_id = -1;
+
+static int
+new_device(int vid)
+{
+	if (rte_vhost_async_channel_register(vid, VIRTIO_TXQ) < 0) {
+		printf("Cannot register async channel on vid %d\n", vid);
+		return -1;
+	}
+
+	vhost_vid = vid;
+	return 0;
+}
+
+static void
+destroy_device(int vid)
+{
+	rte_vhost_async_channel_unregister(vid, VIRTIO_TXQ);
+	vhost_vid = -1;
+}
+
+static const struct rte_vhost_device_ops vhost_async_ops = {
+	.new_device = new_device,
+	.destroy_device = destroy_device,
+};
+
+static int
+dma_setup(void)
+{
+	struct rte_dma_conf dev_conf = { .nb_vchans = 1 };
+	struct rte_dma_vchan_conf qconf = {
+		.direction = RTE_DMA_DIR_MEM_TO_MEM,
+		.nb_desc = 1024,
+	};
+
+	/* ignore errors due to an instance being already present */
+	rte_vdev_init(DMA_NAME, NULL);
+	dma_id = rte_dma_get_dev_id_by_name(DMA_NAME);
+	if (dma_id < 0)
+		return -1;
+
+	if (rte_dma_configure(dma_id, &dev_conf) != 0 ||
+	    rte_dma_vchan_setup(dma_id, 0, &qconf) != 0 ||
+	    rte_dma_start(dma_id) != 0) {
+		printf("Cannot set up %s\n", DMA_NAME);
+		return -1;
+	}
+
+	if (rte_vhost_async_dma_configure(dma_id, 0) < 0) {
+		printf("Cannot use %s for vhost async copies\n", DMA_NAME);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+vhost_setup(void)
+{
+	snprintf(sock_path, sizeof(sock_path), "/tmp/vhost_async_test.%d",
+		 getpid());
+	unlink(sock_path);
+
+	if (rte_vhost_driver_register(sock_path,
+				      RTE_VHOST_USER_ASYNC_COPY) != 0) {
+		printf("Cannot register vhost socket %s\n", sock_path);
+		return -1;
+	}
+
+	if (rte_vhost_driver_callback_register(sock_path,
+					       &vhost_async_ops) != 0 ||
+	    rte_vhost_driver_start(sock_path) != 0) {
+		printf("Cannot start vhost socket %s\n", sock_path);
+		rte_vhost_driver_unregister(sock_path);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+virtio_user_setup(int packed, uint16_t *port)
+{
+	struct rte_eth_conf null_conf;
+	char args[PATH_MAX + 64];
+	unsigned int timeout;
+
+	memset(&null_conf, 0, sizeof(null_conf));
+	snprintf(args, sizeof(args), "path=%s,queues=1,queue_size=%u,packed_vq=%d",
+		 sock_path, RING_SIZE, packed);
+
+	if (rte_vdev_init(VIRTIO_USER_NAME, args) != 0) {
+		printf("Cannot create %s\n", VIRTIO_USER_NAME);
+		return -1;
+	}
+
+	if (rte_eth_dev_get_port_by_name(VIRTIO_USER_NAME, port) != 0 ||
+	    rte_eth_dev_configure(*port, 1, 1, &null_conf) < 0 ||
+	    rte_eth_tx_queue_setup(*port, 0, RING_SIZE, SOCKET_ID_ANY,
+				   NULL) < 0 ||
+	    rte_eth_rx_queue_setup(*port, 0, RING_SIZE, SOCKET_ID_ANY,
+				   NULL, mp) < 0 ||
+	    rte_eth_dev_start(*port) < 0) {
+		printf("Cannot start %s\n", VIRTIO_USER_NAME);
+		return -1;
+	}
+
+	/* the vhost device is ready once the driver is */
+	for (timeout = 0; vhost_vid < 0 && timeout < TIMEOUT_MS; timeout++)
+		rte_delay_ms(1);
+	if (vhost_vid < 0) {
+		printf("vhost device not ready\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Sends NB_PKTS packets carrying their index in their payload, with an
+ * empty packet in the middle, which the virtio driver sends as a single
+ * header-only descriptor.
+ */
+static int
+virtio_user_send(uint16_t port)
+{
+	struct rte_mbuf *bufs[NB_PKTS + 1];
+	struct rte_ether_hdr *eth;
+	unsigned int i, idx = 0;
+	uint16_t nb_tx;
+
+	if (rte_pktmbuf_alloc_bulk(mp, bufs, NB_PKTS + 1) != 0) {
+		printf("Failed to allocate mbufs\n");
+		return -1;
+	}
+
+	for (i = 0; i < NB_PKTS + 1; i++) {
+		if (i == NB_PKTS / 2)
+			continue;
+		eth = (struct rte_ether_hdr *)rte_pktmbuf_append(bufs[i],
+								 PKT_LEN);
+		memset(&eth->dst_addr, 0xff, sizeof(eth->dst_addr));
+		rte_eth_random_addr(eth->src_addr.addr_bytes);
+		eth->ether_type = rte_cpu_to_be_16(TEST_ETHER_TYPE);
+		memset(eth + 1, idx++, PKT_LEN - sizeof(*eth));
+	}
+
+	nb_tx = rte_eth_tx_burst(port, 0, bufs, NB_PKTS + 1);
+	if (nb_tx < NB_PKTS + 1) {
+		rte_pktmbuf_free_bulk(&bufs[nb_tx], NB_PKTS + 1 - nb_tx);
+		printf("Sent %u of %u packets\n", nb_tx, NB_PKTS + 1);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* a packet of virtio_user_send() carries its index in its payload */
+static int
+vhost_async_check(const struct rte_mbuf *m)
+{
+	const struct rte_ether_hdr *eth;
+	const uint8_t *payload;
+	unsigned int i;
+
+	if (rte_pktmbuf_pkt_len(m) != PKT_LEN || m->nb_segs != 1)
+		return -1;
+
+	eth = rte_pktmbuf_mtod(m, const struct rte_ether_hdr *);
+	if (eth->ether_type != rte_cpu_to_be_16(TEST_ETHER_TYPE))
+		return -1;
+
+	payload = (const uint8_t *)(eth + 1);
+	for (i = 1; i < PKT_LEN - sizeof(*eth); i++)
+		if (payload[i] != payload[0])
+			return -1;
+
+	return payload[0];
+}
+
+/*
+ * Dequeues the packets sent by virtio-user through the skeleton DMA
+ * device; the header-only descriptor must be consumed and dropped
+ * without stalling the packets queued after it.
+ */
+static int
+vhost_async_dequeue(void)
+{
+	struct rte_mbuf *bufs[NB_PKTS + 1];
+	unsigned int nb_rx = 0, timeout;
+	int nr_inflight = 0;
+	uint16_t n = 0, i;
+	int ret = -1;
+
+	for (timeout = 0; timeout < TIMEOUT_MS; timeout++) {
+		n = rte_vhost_async_try_dequeue_burst(vhost_vid, VIRTIO_TXQ, mp,
+				bufs, NB_PKTS + 1, &nr_inflight, dma_id, 0);
+		for (i = 0; i < n; i++) {
+			if (nb_rx < NB_PKTS &&
+			    vhost_async_check(bufs[i]) == (int)nb_rx) {
+				nb_rx++;
+			} else {
+				printf("Unexpected packet after %u packets\n",
+				       nb_rx);
+				goto out;
+			}
+		}
+		rte_pktmbuf_free_bulk(bufs, n);
+		n = 0;
+		if (nb_rx == NB_PKTS && nr_inflight == 0)
+			break;
+		rte_delay_ms(1);
+	}
+
+	if (nb_rx < NB_PKTS || nr_inflight != 0) {
+		printf("Dequeued %u of %u packets, %d in flight\n",
+		       nb_rx, NB_PKTS, nr_inflight);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	rte_pktmbuf_free_bulk(bufs, n);
+	return ret;
+}
+
+static int
+test_vhost_async_dequeue(int packed)
+{
+	uint16_t port = RTE_MAX_ETHPORTS;
+	int ret = TEST_FAILED;
+
+	printf("Async dequeue on %s ring\n", packed ? "packed" : "split");
+
+	if (vhost_setup() < 0)
+		return TEST_FAILED;
+
+	if (virtio_user_setup(packed, &port) < 0)
+		goto out;
+
+	if (virtio_user_send(port) < 0 || vhost_async_dequeue() < 0)
+		goto out;
+
+	ret = TEST_SUCCESS;
+out:
+	if (port != RTE_MAX_ETHPORTS) {
+		rte_eth_dev_stop(port);
+		rte_eth_dev_close(port);
+	}
+	rte_vdev_uninit(VIRTIO_USER_NAME);
+	rte_vhost_driver_unregister(sock_path);
+	unlink(sock_path);
+	return ret;
+}
+
+static int
+test_vhost_async(void)
+{
+	int ret;
+
+	/* the skeleton DMA device copies between virtual addresses */
+	if (rte_eal_iova_mode() != RTE_IOVA_VA) {
+		printf("IOVA as VA is required, skipping\n");
+		return TEST_SKIPPED;
+	}
+
+	if (dma_setup() < 0) {
+		printf("No %s device, skipping\n", DMA_NAME);
+		return TEST_SKIPPED;
+	}
+
+	mp = rte_pktmbuf_pool_create("mbuf_vhost_async", NB_MBUF, 32, 0,
+				     RTE_MBUF_DEFAULT_BUF_SIZE,
+				     SOCKET_ID_ANY);
+	if (mp == NULL) {
+		ret = TEST_FAILED;
+		goto out;
+	}
+
+	ret = test_vhost_async_dequeue(0);
+	if (ret == TEST_SUCCESS)
+		ret = test_vhost_async_dequeue(1);
+
+	rte_mempool_free(mp);
+out:
+	rte_dma_stop(dma_id);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(vhost_async_autotest, test_vhost_async);
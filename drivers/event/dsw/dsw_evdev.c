@@ -4,9 +4,12 @@
 
 #include <stdbool.h>
 
+#include <stdlib.h>
+
 #include <rte_cycles.h>
 #include <eventdev_pmd.h>
 #include <eventdev_pmd_vdev.h>
+#include <rte_kvargs.h>
 #include <rte_random.h>
 #include <rte_ring_elem.h>
 
@@ -14,6 +17,13 @@
 
 #define EVENTDEV_NAME_DSW_PMD event_dsw
 
+#define MIGRATION_INTERVAL_ARG "migration_interval"
+#define LOAD_UPDATE_INTERVAL_ARG "load_update_interval"
+#define MIN_SOURCE_LOAD_ARG "min_source_load"
+#define MAX_TARGET_LOAD_ARG "max_target_load"
+#define REBALANCE_THRESHOLD_ARG "rebalance_threshold"
+#define MAX_FLOWS_PER_MIGRATION_ARG "max_flows_per_migration"
+
 static int
 dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	       const struct rte_event_port_conf *conf)
@@ -61,12 +71,6 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	port->in_ring = in_ring;
 	port->ctl_in_ring = ctl_in_ring;
 
-	port->load_update_interval =
-		(DSW_LOAD_UPDATE_INTERVAL * rte_get_timer_hz()) / US_PER_S;
-
-	port->migration_interval =
-		(DSW_MIGRATION_INTERVAL * rte_get_timer_hz()) / US_PER_S;
-
 	dev->data->ports[port_id] = port;
 
 	return 0;
@@ -278,8 +282,20 @@ dsw_start(struct rte_eventdev *dev)
 
 	now = rte_get_timer_cycles();
 	for (i = 0; i < dsw->num_ports; i++) {
-		dsw->ports[i].measurement_start = now;
-		dsw->ports[i].busy_start = now;
+		struct dsw_port *port = &dsw->ports[i];
+
+		port->measurement_start = now;
+		port->busy_start = now;
+
+		/* The migration policy may have changed since the
+		 * port was set up.
+		 */
+		port->load_update_interval =
+			(dsw->policy.conf.load_update_interval *
+			 rte_get_timer_hz()) / US_PER_S;
+		port->migration_interval =
+			(dsw->policy.conf.migration_interval *
+			 rte_get_timer_hz()) / US_PER_S;
 	}
 
 	return 0;
@@ -417,18 +433,189 @@ static struct eventdev_ops dsw_evdev_ops = {
 	.crypto_adapter_caps_get = dsw_crypto_adapter_caps_get,
 	.xstats_get = dsw_xstats_get,
 	.xstats_get_names = dsw_xstats_get_names,
-	.xstats_get_by_name = dsw_xstats_get_by_name
+	.xstats_get_by_name = dsw_xstats_get_by_name,
+	.dev_selftest = test_dsw_eventdev
 };
 
+static bool
+dsw_migration_policy_valid(const struct rte_pmd_dsw_migration_policy *policy)
+{
+	return policy->migration_interval > 0 &&
+		policy->load_update_interval > 0 &&
+		policy->min_source_load <= 100 &&
+		policy->max_target_load <= 100 &&
+		policy->rebalance_threshold <= 100 &&
+		policy->max_flows_per_migration > 0 &&
+		policy->max_flows_per_migration <= DSW_MAX_FLOWS_PER_MIGRATION;
+}
+
+static void
+dsw_migration_policy_store(struct dsw_evdev *dsw,
+			   const struct rte_pmd_dsw_migration_policy *policy)
+{
+	dsw->policy = (struct dsw_migration_policy) {
+		.conf = *policy,
+		.min_source_load =
+			DSW_LOAD_FROM_PERCENT(policy->min_source_load),
+		.max_target_load =
+			DSW_LOAD_FROM_PERCENT(policy->max_target_load),
+		.rebalance_threshold =
+			DSW_LOAD_FROM_PERCENT(policy->rebalance_threshold)
+	};
+}
+
+static struct rte_eventdev *
+dsw_get_dev(uint8_t dev_id)
+{
+	struct rte_eventdev *dev;
+
+	if (!rte_event_pmd_is_valid_dev(dev_id))
+		return NULL;
+
+	dev = &rte_eventdevs[dev_id];
+	if (dev->dev_ops != &dsw_evdev_ops)
+		return NULL;
+
+	return dev;
+}
+
+int
+rte_pmd_dsw_migration_policy_get(uint8_t dev_id,
+				 struct rte_pmd_dsw_migration_policy *policy)
+{
+	struct rte_eventdev *dev = dsw_get_dev(dev_id);
+	struct dsw_evdev *dsw;
+
+	if (dev == NULL || policy == NULL)
+		return -EINVAL;
+
+	dsw = dsw_pmd_priv(dev);
+
+	*policy = dsw->policy.conf;
+
+	return 0;
+}
+
+int
+rte_pmd_dsw_migration_policy_set(uint8_t dev_id,
+			const struct rte_pmd_dsw_migration_policy *policy)
+{
+	struct rte_eventdev *dev = dsw_get_dev(dev_id);
+
+	if (dev == NULL || policy == NULL ||
+	    !dsw_migration_policy_valid(policy))
+		return -EINVAL;
+
+	if (dev->data->dev_started)
+		return -EBUSY;
+
+	dsw_migration_policy_store(dsw_pmd_priv(dev), policy);
+
+	return 0;
+}
+
+static int
+dsw_parse_uint(const char *key __rte_unused, const char *value, void *opaque)
+{
+	uint32_t *result = opaque;
+	unsigned long v;
+	char *end;
+
+	errno = 0;
+	v = strtoul(value, &end, 0);
+	if (errno != 0 || *value == '\0' || *end != '\0' || v > UINT32_MAX)
+		return -EINVAL;
+
+	*result = v;
+
+	return 0;
+}
+
+static int
+dsw_parse_args(const char *name, const char *params,
+	       struct rte_pmd_dsw_migration_policy *policy)
+{
+	static const char * const args[] = {
+		MIGRATION_INTERVAL_ARG,
+		LOAD_UPDATE_INTERVAL_ARG,
+		MIN_SOURCE_LOAD_ARG,
+		MAX_TARGET_LOAD_ARG,
+		REBALANCE_THRESHOLD_ARG,
+		MAX_FLOWS_PER_MIGRATION_ARG,
+		NULL
+	};
+	uint32_t values[RTE_DIM(args) - 1] = {
+		policy->migration_interval,
+		policy->load_update_interval,
+		policy->min_source_load,
+		policy->max_target_load,
+		policy->rebalance_threshold,
+		policy->max_flows_per_migration
+	};
+	struct rte_kvargs *kvlist;
+	unsigned int i;
+
+	if (params == NULL || params[0] == '\0')
+		return 0;
+
+	kvlist = rte_kvargs_parse(params, args);
+	if (kvlist == NULL) {
+		RTE_EDEV_LOG_ERR("%s: invalid parameters '%s'", name, params);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < RTE_DIM(values); i++) {
+		if (rte_kvargs_process(kvlist, args[i], dsw_parse_uint,
+				       &values[i]) != 0 ||
+		    (i >= 2 && values[i] > UINT8_MAX)) {
+			RTE_EDEV_LOG_ERR("%s: invalid %s value", name,
+					 args[i]);
+			rte_kvargs_free(kvlist);
+			return -EINVAL;
+		}
+	}
+
+	rte_kvargs_free(kvlist);
+
+	*policy = (struct rte_pmd_dsw_migration_policy) {
+		.migration_interval = values[0],
+		.load_update_interval = values[1],
+		.min_source_load = values[2],
+		.max_target_load = values[3],
+		.rebalance_threshold = values[4],
+		.max_flows_per_migration = values[5]
+	};
+
+	if (!dsw_migration_policy_valid(policy)) {
+		RTE_EDEV_LOG_ERR("%s: invalid migration policy", name);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static int
 dsw_probe(struct rte_vdev_device *vdev)
 {
 	const char *name;
 	struct rte_eventdev *dev;
 	struct dsw_evdev *dsw;
+	struct rte_pmd_dsw_migration_policy policy = {
+		.migration_interval = DSW_MIGRATION_INTERVAL,
+		.load_update_interval = DSW_LOAD_UPDATE_INTERVAL,
+		.min_source_load = DSW_MIN_SOURCE_LOAD_FOR_MIGRATION,
+		.max_target_load = DSW_MAX_TARGET_LOAD_FOR_MIGRATION,
+		.rebalance_threshold = DSW_REBALANCE_THRESHOLD,
+		.max_flows_per_migration = DSW_MAX_FLOWS_PER_MIGRATION
+	};
+	int rc;
 
 	name = rte_vdev_device_name(vdev);
 
+	rc = dsw_parse_args(name, rte_vdev_device_args(vdev), &policy);
+	if (rc != 0)
+		return rc;
+
 	dev = rte_event_pmd_vdev_init(name, sizeof(struct dsw_evdev),
 				      rte_socket_id());
 	if (dev == NULL)
@@ -449,6 +636,8 @@ dsw_probe(struct rte_vdev_device *vdev)
 	dsw = dev->data->dev_private;
 	dsw->data = dev->data;
 
+	dsw_migration_policy_store(dsw, &policy);
+
 	event_dev_probing_finish(dev);
 	return 0;
 }
@@ -471,3 +660,9 @@ static struct rte_vdev_driver evdev_dsw_pmd_drv = {
 };
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_DSW_PMD, evdev_dsw_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(event_dsw, MIGRATION_INTERVAL_ARG "=<us> "
+		LOAD_UPDATE_INTERVAL_ARG "=<us> "
+		MIN_SOURCE_LOAD_ARG "=<percent> "
+		MAX_TARGET_LOAD_ARG "=<percent> "
+		REBALANCE_THRESHOLD_ARG "=<percent> "
+		MAX_FLOWS_PER_MIGRATION_ARG "=<int>");
@@ -10,6 +10,8 @@
 #include <rte_event_ring.h>
 #include <rte_eventdev.h>
 
+#include "rte_pmd_dsw.h"
+
 #define DSW_PMD_NAME RTE_STR(event_dsw)
 
 #define DSW_MAX_PORTS (64)
@@ -76,7 +78,10 @@
 #define DSW_LOAD_FROM_PERCENT(x) ((int16_t)(((x)*DSW_MAX_LOAD)/100))
 #define DSW_LOAD_TO_PERCENT(x) ((100*x)/DSW_MAX_LOAD)
 
-/* The thought behind keeping the load update interval shorter than
+/* The defaults below may be overridden per device, using devargs or
+ * rte_pmd_dsw_migration_policy_set().
+ *
+ * The thought behind keeping the load update interval shorter than
  * the migration interval is that the load from newly migrated flows
  * should 'show up' on the load measurement before new migrations are
  * considered. This is to avoid having too many flows, from too many
@@ -93,14 +98,22 @@
  * an event burst.
  */
 #define DSW_MIGRATION_INTERVAL (1000)
-#define DSW_MIN_SOURCE_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(70))
-#define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(95))
-#define DSW_REBALANCE_THRESHOLD (DSW_LOAD_FROM_PERCENT(3))
+/* Load thresholds, in percent. */
+#define DSW_MIN_SOURCE_LOAD_FOR_MIGRATION (70)
+#define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (95)
+#define DSW_REBALANCE_THRESHOLD (3)
 
 #define DSW_MAX_EVENTS_RECORDED (128)
 
 #define DSW_MAX_FLOWS_PER_MIGRATION (8)
 
+/* Flow migration latencies are recorded in a histogram with
+ * power-of-two buckets, in us. Bucket 0 counts migrations taking less
+ * than 1 us, bucket n those taking [2^(n-1), 2^n) us, and the last
+ * bucket all the slower ones.
+ */
+#define DSW_MIGRATION_LATENCY_BUCKETS (16)
+
 /* Only one outstanding migration per port is allowed */
 #define DSW_MAX_PAUSED_FLOWS (DSW_MAX_PORTS*DSW_MAX_FLOWS_PER_MIGRATION)
 
@@ -174,6 +187,13 @@ struct dsw_port {
 	uint64_t emigration_start;
 	uint64_t emigrations;
 	uint64_t emigration_latency;
+	uint64_t emigration_latency_hist[DSW_MIGRATION_LATENCY_BUCKETS];
+	uint64_t emigration_rounds;
+
+	/* Reasons for not starting an emigration, when considered. */
+	uint64_t emigration_low_load;
+	uint64_t emigration_single_flow;
+	uint64_t emigration_no_target;
 
 	uint8_t emigration_target_port_ids[DSW_MAX_FLOWS_PER_MIGRATION];
 	struct dsw_queue_flow
@@ -234,9 +254,19 @@ struct dsw_queue {
 	uint8_t flow_to_port_map[DSW_MAX_FLOWS] __rte_cache_aligned;
 };
 
+struct dsw_migration_policy {
+	struct rte_pmd_dsw_migration_policy conf;
+	/* The load thresholds of conf, in DSW load units. */
+	int16_t min_source_load;
+	int16_t max_target_load;
+	int16_t rebalance_threshold;
+};
+
 struct dsw_evdev {
 	struct rte_eventdev_data *data;
 
+	struct dsw_migration_policy policy;
+
 	struct dsw_port ports[DSW_MAX_PORTS];
 	uint16_t num_ports;
 	struct dsw_queue queues[DSW_MAX_QUEUES];
@@ -284,6 +314,8 @@ int dsw_xstats_get(const struct rte_eventdev *dev,
 uint64_t dsw_xstats_get_by_name(const struct rte_eventdev *dev,
 				const char *name, unsigned int *id);
 
+int test_dsw_eventdev(void);
+
 static inline struct dsw_evdev *
 dsw_pmd_priv(const struct rte_eventdev *eventdev)
 {
@@ -0,0 +1,284 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Ericsson AB
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_cycles.h>
+#include <rte_eventdev.h>
+
+#include "dsw_evdev.h"
+#include "rte_pmd_dsw.h"
+
+#define DSW_TEST_NAME "event_dsw_selftest"
+#define DSW_TEST_ARGS "migration_interval=100,load_update_interval=50," \
+	"min_source_load=100,max_target_load=90,rebalance_threshold=10," \
+	"max_flows_per_migration=2"
+
+#define DSW_TEST_NUM_PORTS (2)
+#define DSW_TEST_BURST (32)
+#define DSW_TEST_ROUNDS (400)
+#define DSW_TEST_IDLE_US (10)
+
+static const struct rte_pmd_dsw_migration_policy dsw_test_policy = {
+	.migration_interval = 100,
+	.load_update_interval = 50,
+	.min_source_load = 100,
+	.max_target_load = 90,
+	.rebalance_threshold = 10,
+	.max_flows_per_migration = 2
+};
+
+static int
+dsw_test_setup(uint8_t dev_id)
+{
+	struct rte_event_dev_config config = {
+		.nb_event_queues = 1,
+		.nb_event_ports = DSW_TEST_NUM_PORTS,
+		.nb_events_limit = 4096,
+		.nb_event_queue_flows = 1024,
+		.nb_event_port_dequeue_depth = DSW_TEST_BURST,
+		.nb_event_port_enqueue_depth = DSW_TEST_BURST,
+	};
+	struct rte_event_queue_conf queue_conf = {
+		.schedule_type = RTE_SCHED_TYPE_ATOMIC,
+		.nb_atomic_flows = 1024,
+		.nb_atomic_order_sequences = 1024,
+	};
+	struct rte_event_port_conf port_conf;
+	uint8_t port_id;
+
+	if (rte_event_dev_configure(dev_id, &config) < 0 ||
+	    rte_event_queue_setup(dev_id, 0, &queue_conf) < 0 ||
+	    rte_event_port_default_conf_get(dev_id, 0, &port_conf) < 0) {
+		printf("%d: Error configuring device\n", __LINE__);
+		return -1;
+	}
+
+	for (port_id = 0; port_id < DSW_TEST_NUM_PORTS; port_id++) {
+		if (rte_event_port_setup(dev_id, port_id, &port_conf) < 0 ||
+		    rte_event_port_link(dev_id, port_id, NULL, NULL, 0) != 1) {
+			printf("%d: Error setting up port %u\n", __LINE__,
+			       port_id);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static uint64_t
+dsw_test_port_xstat(uint8_t dev_id, const char *stat)
+{
+	char name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
+	uint64_t sum = 0;
+	unsigned int id;
+	uint8_t port_id;
+
+	for (port_id = 0; port_id < DSW_TEST_NUM_PORTS; port_id++) {
+		snprintf(name, sizeof(name), "port_%u_%s", port_id, stat);
+		sum += rte_event_dev_xstats_by_name_get(dev_id, name, &id);
+	}
+
+	return sum;
+}
+
+/* Dequeues from all ports until they are all empty */
+static unsigned int
+dsw_test_drain(uint8_t dev_id)
+{
+	struct rte_event events[DSW_TEST_BURST];
+	unsigned int dequeued = 0;
+	unsigned int idle = 0;
+	uint8_t port_id;
+	uint16_t n;
+
+	while (idle < 2) {
+		idle++;
+		for (port_id = 0; port_id < DSW_TEST_NUM_PORTS; port_id++) {
+			n = rte_event_dequeue_burst(dev_id, port_id, events,
+						    DSW_TEST_BURST, 0);
+			if (n > 0)
+				idle = 0;
+			dequeued += n;
+		}
+	}
+
+	return dequeued;
+}
+
+/*
+ * Sends events of nb_flows flows through the device, with idle periods
+ * in between so that the port loads stay low, and lets the ports consider
+ * flow emigrations on the way.
+ */
+static int
+dsw_test_run(uint8_t dev_id, uint32_t nb_flows)
+{
+	struct rte_event events[DSW_TEST_BURST];
+	unsigned int sent = 0, received = 0;
+	unsigned int round;
+	uint16_t i, n;
+
+	if (rte_event_dev_start(dev_id) < 0) {
+		printf("%d: Error starting device\n", __LINE__);
+		return -1;
+	}
+
+	for (round = 0; round < DSW_TEST_ROUNDS; round++) {
+		for (i = 0; i < DSW_TEST_BURST; i++)
+			events[i] = (struct rte_event) {
+				.op = RTE_EVENT_OP_NEW,
+				.queue_id = 0,
+				.sched_type = RTE_SCHED_TYPE_ATOMIC,
+				.flow_id = (sent + i) % nb_flows,
+				.u64 = sent + i,
+			};
+
+		n = rte_event_enqueue_new_burst(dev_id, 0, events,
+						DSW_TEST_BURST);
+		sent += n;
+		received += dsw_test_drain(dev_id);
+
+		rte_delay_us(DSW_TEST_IDLE_US);
+	}
+	received += dsw_test_drain(dev_id);
+
+	rte_event_dev_stop(dev_id);
+
+	if (sent == 0 || received != sent) {
+		printf("%d: Sent %u events, received %u\n", __LINE__, sent,
+		       received);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+dsw_test_policy_set(uint8_t dev_id, uint8_t min_source_load,
+		    uint8_t max_target_load)
+{
+	struct rte_pmd_dsw_migration_policy policy = dsw_test_policy;
+
+	policy.min_source_load = min_source_load;
+	policy.max_target_load = max_target_load;
+
+	return rte_pmd_dsw_migration_policy_set(dev_id, &policy);
+}
+
+/*
+ * Checks that the device arguments set the migration policy, and that
+ * the emigration xstats count the reasons for not migrating any flow.
+ */
+static int
+test_migration_policy(uint8_t dev_id)
+{
+	struct rte_pmd_dsw_migration_policy policy;
+	char name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
+	uint64_t low_load, single_flow, no_target;
+	unsigned int id;
+
+	if (rte_pmd_dsw_migration_policy_get(dev_id, &policy) != 0 ||
+	    memcmp(&policy, &dsw_test_policy, sizeof(policy)) != 0) {
+		printf("%d: Policy does not match the device arguments\n",
+		       __LINE__);
+		return -1;
+	}
+
+	policy.max_flows_per_migration = 0;
+	if (rte_pmd_dsw_migration_policy_set(dev_id, &policy) != -EINVAL) {
+		printf("%d: Invalid policy accepted\n", __LINE__);
+		return -1;
+	}
+
+	if (dsw_test_setup(dev_id) < 0)
+		return -1;
+
+	snprintf(name, sizeof(name), "port_0_migration_latency_hist_%u",
+		 DSW_MIGRATION_LATENCY_BUCKETS - 1);
+	rte_event_dev_xstats_by_name_get(dev_id, name, &id);
+	if (id == (unsigned int)-1) {
+		printf("%d: No %s xstat\n", __LINE__, name);
+		return -1;
+	}
+
+	/* No port is loaded enough to be a source */
+	if (dsw_test_run(dev_id, 64) < 0)
+		return -1;
+	low_load = dsw_test_port_xstat(dev_id, "emigration_low_load");
+	if (low_load == 0) {
+		printf("%d: No emigration denied for low load\n", __LINE__);
+		return -1;
+	}
+
+	/* Any port is a source, but a single flow cannot be moved */
+	if (dsw_test_policy_set(dev_id, 0, 100) != 0 ||
+	    dsw_test_run(dev_id, 1) < 0)
+		return -1;
+	single_flow = dsw_test_port_xstat(dev_id, "emigration_single_flow");
+	if (single_flow == 0) {
+		printf("%d: No emigration denied for a single flow\n",
+		       __LINE__);
+		return -1;
+	}
+
+	/* Any port is a source, no port can be a target */
+	if (dsw_test_policy_set(dev_id, 0, 0) != 0 ||
+	    dsw_test_run(dev_id, 64) < 0)
+		return -1;
+	no_target = dsw_test_port_xstat(dev_id, "emigration_no_target");
+	if (no_target == 0) {
+		printf("%d: No emigration denied for lack of target\n",
+		       __LINE__);
+		return -1;
+	}
+
+	if (dsw_test_port_xstat(dev_id, "emigration_low_load") != low_load ||
+	    dsw_test_port_xstat(dev_id, "emigration_single_flow") !=
+	    single_flow ||
+	    dsw_test_port_xstat(dev_id, "emigrations") != 0 ||
+	    dsw_test_port_xstat(dev_id, "emigration_rounds") != 0) {
+		printf("%d: Unexpected emigration xstats\n", __LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+test_dsw_eventdev(void)
+{
+	int dev_id;
+	int ret;
+
+	if (rte_vdev_init(DSW_TEST_NAME, "min_source_load=101") == 0) {
+		printf("%d: Invalid device arguments accepted\n", __LINE__);
+		rte_vdev_uninit(DSW_TEST_NAME);
+		return -1;
+	}
+
+	if (rte_vdev_init(DSW_TEST_NAME, DSW_TEST_ARGS) < 0) {
+		printf("%d: Error creating %s\n", __LINE__, DSW_TEST_NAME);
+		return -1;
+	}
+	dev_id = rte_event_dev_get_dev_id(DSW_TEST_NAME);
+	if (dev_id < 0) {
+		printf("%d: Error finding %s\n", __LINE__, DSW_TEST_NAME);
+		rte_vdev_uninit(DSW_TEST_NAME);
+		return -1;
+	}
+
+	printf("*** Running Migration Policy test...\n");
+	ret = test_migration_policy(dev_id);
+	if (ret != 0)
+		printf("ERROR - Migration Policy test FAILED.\n");
+
+	rte_event_dev_close(dev_id);
+	rte_vdev_uninit(DSW_TEST_NAME);
+
+	return ret;
+}
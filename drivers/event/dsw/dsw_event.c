@@ -394,18 +394,18 @@ dsw_flow_load(uint16_t num_events, int16_t port_load)
 }
 
 static int16_t
-dsw_evaluate_migration(int16_t source_load, int16_t target_load,
-		       int16_t flow_load)
+dsw_evaluate_migration(struct dsw_evdev *dsw, int16_t source_load,
+		       int16_t target_load, int16_t flow_load)
 {
 	int32_t res_target_load;
 	int32_t imbalance;
 
-	if (target_load > DSW_MAX_TARGET_LOAD_FOR_MIGRATION)
+	if (target_load > dsw->policy.max_target_load)
 		return -1;
 
 	imbalance = source_load - target_load;
 
-	if (imbalance < DSW_REBALANCE_THRESHOLD)
+	if (imbalance < dsw->policy.rebalance_threshold)
 		return -1;
 
 	res_target_load = target_load + flow_load;
@@ -453,7 +453,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 	int16_t candidate_flow_load = -1;
 	uint16_t i;
 
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION)
+	if (source_port_load < dsw->policy.min_source_load)
 		return false;
 
 	for (i = 0; i < num_bursts; i++) {
@@ -477,7 +477,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 			if (!dsw_is_serving_port(dsw, port_id, qf->queue_id))
 				continue;
 
-			weight = dsw_evaluate_migration(source_port_load,
+			weight = dsw_evaluate_migration(dsw, source_port_load,
 							port_loads[port_id],
 							flow_load);
 
@@ -524,7 +524,7 @@ dsw_select_emigration_targets(struct dsw_evdev *dsw,
 	uint8_t *targets_len = &source_port->emigration_targets_len;
 	uint16_t i;
 
-	for (i = 0; i < DSW_MAX_FLOWS_PER_MIGRATION; i++) {
+	for (i = 0; i < dsw->policy.conf.max_flows_per_migration; i++) {
 		bool found;
 
 		found = dsw_select_emigration_target(dsw, bursts, num_bursts,
@@ -720,11 +720,18 @@ static void
 dsw_port_emigration_stats(struct dsw_port *port, uint8_t finished)
 {
 	uint64_t flow_migration_latency;
+	uint64_t latency_us;
+	unsigned int bucket;
 
 	flow_migration_latency =
 		(rte_get_timer_cycles() - port->emigration_start);
 	port->emigration_latency += (flow_migration_latency * finished);
 	port->emigrations += finished;
+
+	latency_us = (flow_migration_latency * US_PER_S) / rte_get_timer_hz();
+	bucket = latency_us == 0 ? 0 : rte_fls_u64(latency_us);
+	bucket = RTE_MIN(bucket, DSW_MIGRATION_LATENCY_BUCKETS - 1u);
+	port->emigration_latency_hist[bucket] += finished;
 }
 
 static void
@@ -857,11 +864,12 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 
 	source_port_load =
 		__atomic_load_n(&source_port->load, __ATOMIC_RELAXED);
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION) {
+	if (source_port_load < dsw->policy.min_source_load) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 		      "Load %d is below threshold level %d.\n",
 		      DSW_LOAD_TO_PERCENT(source_port_load),
-		      DSW_LOAD_TO_PERCENT(DSW_MIN_SOURCE_LOAD_FOR_MIGRATION));
+		      DSW_LOAD_TO_PERCENT(dsw->policy.min_source_load));
+		source_port->emigration_low_load++;
 		return;
 	}
 
@@ -870,11 +878,12 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	 */
 	any_port_below_limit =
 		dsw_retrieve_port_loads(dsw, port_loads,
-					DSW_MAX_TARGET_LOAD_FOR_MIGRATION);
+					dsw->policy.max_target_load);
 	if (!any_port_below_limit) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 				"Candidate target ports are all too highly "
 				"loaded.\n");
+		source_port->emigration_no_target++;
 		return;
 	}
 
@@ -889,17 +898,21 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 				"queue_id %d flow_hash %d has been seen.\n",
 				bursts[0].queue_flow.queue_id,
 				bursts[0].queue_flow.flow_hash);
+		source_port->emigration_single_flow++;
 		return;
 	}
 
 	dsw_select_emigration_targets(dsw, source_port, bursts, num_bursts,
 				      port_loads);
 
-	if (source_port->emigration_targets_len == 0)
+	if (source_port->emigration_targets_len == 0) {
+		source_port->emigration_no_target++;
 		return;
+	}
 
 	source_port->migration_state = DSW_MIGRATION_STATE_PAUSING;
 	source_port->emigration_start = rte_get_timer_cycles();
+	source_port->emigration_rounds++;
 
 	/* No need to go through the whole pause procedure for
 	 * parallel queues, since atomic/ordered semantics need not to
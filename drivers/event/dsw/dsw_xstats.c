@@ -43,6 +43,8 @@ struct dsw_xstats_port {
 	const char *name_fmt;
 	dsw_xstats_port_get_value_fn get_value_fn;
 	bool per_queue;
+	/* one value per migration latency histogram bucket */
+	bool per_bucket;
 };
 
 static uint64_t
@@ -85,6 +87,10 @@ dsw_xstats_port_get_queue_dequeued(struct dsw_evdev *dsw, uint8_t port_id,
 }
 
 DSW_GEN_PORT_ACCESS_FN(emigrations)
+DSW_GEN_PORT_ACCESS_FN(emigration_rounds)
+DSW_GEN_PORT_ACCESS_FN(emigration_low_load)
+DSW_GEN_PORT_ACCESS_FN(emigration_single_flow)
+DSW_GEN_PORT_ACCESS_FN(emigration_no_target)
 DSW_GEN_PORT_ACCESS_FN(immigrations)
 
 static uint64_t
@@ -97,6 +103,13 @@ dsw_xstats_port_get_migration_latency(struct dsw_evdev *dsw, uint8_t port_id,
 	return num_emigrations > 0 ? total_latency / num_emigrations : 0;
 }
 
+static uint64_t
+dsw_xstats_port_get_migration_latency_hist(struct dsw_evdev *dsw,
+					   uint8_t port_id, uint8_t bucket)
+{
+	return dsw->ports[port_id].emigration_latency_hist[bucket];
+}
+
 static uint64_t
 dsw_xstats_port_get_event_proc_latency(struct dsw_evdev *dsw, uint8_t port_id,
 				       uint8_t queue_id __rte_unused)
@@ -148,8 +161,18 @@ static struct dsw_xstats_port dsw_port_xstats[] = {
 	  true },
 	{ "port_%u_emigrations", dsw_xstats_port_get_emigrations,
 	  false },
+	{ "port_%u_emigration_rounds", dsw_xstats_port_get_emigration_rounds,
+	  false },
+	{ "port_%u_emigration_low_load",
+	  dsw_xstats_port_get_emigration_low_load, false },
+	{ "port_%u_emigration_single_flow",
+	  dsw_xstats_port_get_emigration_single_flow, false },
+	{ "port_%u_emigration_no_target",
+	  dsw_xstats_port_get_emigration_no_target, false },
 	{ "port_%u_migration_latency", dsw_xstats_port_get_migration_latency,
 	  false },
+	{ "port_%u_migration_latency_hist_%u",
+	  dsw_xstats_port_get_migration_latency_hist, false, true },
 	{ "port_%u_immigrations", dsw_xstats_port_get_immigrations,
 	  false },
 	{ "port_%u_event_proc_latency", dsw_xstats_port_get_event_proc_latency,
@@ -186,21 +209,27 @@ static void
 dsw_xstats_port_foreach(struct dsw_evdev *dsw, uint8_t port_id,
 			dsw_xstats_foreach_fn fn, void *fn_data)
 {
-	uint8_t queue_id;
+	uint8_t param;
 	unsigned int stat_idx;
 
-	for (stat_idx = 0, queue_id = 0;
+	for (stat_idx = 0, param = 0;
 	     stat_idx < RTE_DIM(dsw_port_xstats);) {
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
 		char xstats_name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
 		unsigned int xstats_id;
+		unsigned int num_params = 0;
+
+		if (xstat->per_queue)
+			num_params = dsw->num_queues;
+		else if (xstat->per_bucket)
+			num_params = DSW_MIGRATION_LATENCY_BUCKETS;
 
-		if (xstat->per_queue) {
-			xstats_id = DSW_XSTATS_ID_CREATE(stat_idx, queue_id);
+		if (xstat->per_queue || xstat->per_bucket) {
+			xstats_id = DSW_XSTATS_ID_CREATE(stat_idx, param);
 			snprintf(xstats_name, sizeof(xstats_name),
 				 dsw_port_xstats[stat_idx].name_fmt, port_id,
-				 queue_id);
-			queue_id++;
+				 param);
+			param++;
 		} else {
 			xstats_id = stat_idx;
 			snprintf(xstats_name, sizeof(xstats_name),
@@ -210,9 +239,9 @@ dsw_xstats_port_foreach(struct dsw_evdev *dsw, uint8_t port_id,
 		fn(xstats_name, RTE_EVENT_DEV_XSTATS_PORT, port_id,
 		   xstats_id, fn_data);
 
-		if (!(xstat->per_queue && queue_id < dsw->num_queues)) {
+		if (param >= num_params) {
 			stat_idx++;
-			queue_id = 0;
+			param = 0;
 		}
 	}
 }
@@ -300,12 +329,12 @@ dsw_xstats_port_get(const struct rte_eventdev *dev, uint8_t port_id,
 		unsigned int id = ids[i];
 		unsigned int stat_idx = DSW_XSTATS_ID_GET_STAT(id);
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
-		uint8_t queue_id = 0;
+		uint8_t param = 0;
 
-		if (xstat->per_queue)
-			queue_id = DSW_XSTATS_ID_GET_PARAM(id);
+		if (xstat->per_queue || xstat->per_bucket)
+			param = DSW_XSTATS_ID_GET_PARAM(id);
 
-		values[i] = xstat->get_value_fn(dsw, port_id, queue_id);
+		values[i] = xstat->get_value_fn(dsw, port_id, param);
 	}
 	return n;
 }
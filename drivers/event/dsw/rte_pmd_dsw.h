@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Ericsson AB
+ */
+
+/**
+ * @file rte_pmd_dsw.h
+ *
+ * DSW PMD-specific functions
+ */
+
+#ifndef _RTE_PMD_DSW_H_
+#define _RTE_PMD_DSW_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change, or be removed, without prior
+ * notice
+ *
+ * Flow migration policy of a DSW event device.
+ *
+ * Loads are port loads, expressed as the percentage of time the lcore
+ * using the port spends processing events.
+ */
+struct rte_pmd_dsw_migration_policy {
+	/** Minimum time between two flow migrations from a port, in us. */
+	uint32_t migration_interval;
+	/** Port load measurement interval, in us. Should be shorter
+	 * than the migration interval, so that the load of migrated
+	 * flows shows up before further migrations are considered.
+	 */
+	uint32_t load_update_interval;
+	/** Load below which a port does not migrate any of its flows. */
+	uint8_t min_source_load;
+	/** Load above which a port does not receive any migrated flow. */
+	uint8_t max_target_load;
+	/** Minimum load difference between the source and target ports. */
+	uint8_t rebalance_threshold;
+	/** Maximum number of flows moved in a single migration, i.e. in
+	 * one pause/unpause round between the ports.
+	 */
+	uint8_t max_flows_per_migration;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Get the flow migration policy of a DSW event device.
+ *
+ * @param dev_id
+ *   The identifier of the event device.
+ * @param policy
+ *   Filled with the current migration policy.
+ *
+ * @return
+ * - 0: Success
+ * - -EINVAL: Invalid dev_id, not a DSW device, or policy is NULL
+ */
+__rte_experimental
+int
+rte_pmd_dsw_migration_policy_get(uint8_t dev_id,
+				 struct rte_pmd_dsw_migration_policy *policy);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Set the flow migration policy of a DSW event device. The policy
+ * initially comes from the device arguments, or the driver defaults.
+ * The device must not be started.
+ *
+ * @param dev_id
+ *   The identifier of the event device.
+ * @param policy
+ *   The new migration policy.
+ *
+ * @return
+ * - 0: Success
+ * - -EINVAL: Invalid dev_id, not a DSW device, or invalid policy
+ * - -EBUSY: The device is started
+ */
+__rte_experimental
+int
+rte_pmd_dsw_migration_policy_set(uint8_t dev_id,
+			const struct rte_pmd_dsw_migration_policy *policy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_PMD_DSW_H_ */
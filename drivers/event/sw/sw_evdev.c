@@ -23,6 +23,7 @@
 #define MIN_BURST_SIZE_ARG "min_burst"
 #define DEQ_BURST_SIZE_ARG "deq_burst"
 #define REFIL_ONCE_ARG "refill_once"
+#define SCHED_LCORES_ARG "sched_lcores"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
@@ -60,6 +61,15 @@ sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 		if (j < q->cq_num_mapped_cqs)
 			continue;
 
+		/* the schedulers are assigned at start, and a directed QID
+		 * must be scheduled by the scheduler of its port
+		 */
+		if (sw->started && q->type == SW_SCHED_TYPE_DIRECT &&
+				q->sched_id != p->sched_id) {
+			rte_errno = EINVAL;
+			break;
+		}
+
 		if (q->type == SW_SCHED_TYPE_DIRECT) {
 			/* check directed qids only map to one port */
 			if (p->num_qids_mapped > 0) {
@@ -200,6 +210,27 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	}
 	sw->cq_ring_space[port_id] = conf->dequeue_depth;
 
+	/* with several schedulers, the other ones hand off the events they
+	 * schedule to this port through a ring large enough for all the
+	 * events of the device
+	 */
+	snprintf(buf, sizeof(buf), "sw%d_p%u_%s", dev->data->dev_id,
+			port_id, "handoff_ring");
+	rte_ring_free(rte_ring_lookup(buf));
+	if (sw->sched_count > 1) {
+		p->handoff_ring = rte_ring_create_elem(buf,
+				sizeof(struct sw_handoff),
+				rte_align32pow2(sw->nb_events_limit + 1),
+				dev->data->socket_id, RING_F_SC_DEQ);
+		if (p->handoff_ring == NULL) {
+			rte_event_ring_free(p->rx_worker_ring);
+			rte_event_ring_free(p->cq_worker_ring);
+			SW_LOG_ERR("Error creating handoff ring for port %d\n",
+					port_id);
+			return -1;
+		}
+	}
+
 	/* set hist list contents to empty */
 	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
 		p->hist_list[i].fid = -1;
@@ -221,6 +252,7 @@ sw_port_release(void *port)
 
 	rte_event_ring_free(p->rx_worker_ring);
 	rte_event_ring_free(p->cq_worker_ring);
+	rte_ring_free(p->handoff_ring);
 	memset(p, 0, sizeof(*p));
 }
 
@@ -363,7 +395,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(&sw->scheds[qid->sched_id], &qid->iq[j]);
 	}
 }
 
@@ -379,6 +411,23 @@ sw_qids_empty(struct sw_evdev *sw)
 		}
 	}
 
+	/* events sent by a scheduler to another one */
+	for (i = 0; i < sw->sched_count; i++) {
+		struct sw_sched *sched = &sw->scheds[i];
+
+		if (sched->xfer_ring != NULL &&
+				rte_event_ring_count(sched->xfer_ring))
+			return 0;
+		if (sched->cmpl_ring != NULL &&
+				rte_ring_count(sched->cmpl_ring))
+			return 0;
+		for (j = 0; j < sw->sched_count; j++)
+			if (sched->xfer_count[j] || sched->cmpl_count[j])
+				return 0;
+		if (sched->handoff_ports)
+			return 0;
+	}
+
 	return 1;
 }
 
@@ -391,6 +440,9 @@ sw_ports_empty(struct sw_evdev *sw)
 		if ((rte_event_ring_count(sw->ports[i].rx_worker_ring)) ||
 		     rte_event_ring_count(sw->ports[i].cq_worker_ring))
 			return 0;
+		if (sw->ports[i].handoff_ring != NULL &&
+				rte_ring_count(sw->ports[i].handoff_ring))
+			return 0;
 	}
 
 	return 1;
@@ -423,9 +475,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_sched *sched,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -437,7 +489,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(sched, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -451,8 +503,11 @@ sw_drain_queues(struct rte_eventdev *dev)
 	unsigned int i, j;
 
 	for (i = 0; i < sw->qid_count; i++) {
+		struct sw_qid *qid = &sw->qids[i];
+
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, &sw->scheds[qid->sched_id],
+					&qid->iq[j]);
 	}
 }
 
@@ -469,7 +524,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(&sw->scheds[qid->sched_id],
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -511,16 +567,19 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	const struct rte_eventdev_data *data = dev->data;
 	const struct rte_event_dev_config *conf = &data->dev_conf;
-	int num_chunks, i;
+	int num_chunks;
+	uint32_t i;
 
 	sw->qid_count = conf->nb_event_queues;
 	sw->port_count = conf->nb_event_ports;
 	sw->nb_events_limit = conf->nb_events_limit;
 	rte_atomic32_set(&sw->inflights, 0);
 
-	/* Number of chunks sized for worst-case spread of events across IQs */
-	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
-			sw->qid_count*SW_IQS_MAX*2;
+	/* Number of chunks sized for worst-case spread of events across IQs,
+	 * all the events may be in the IQs of any scheduler
+	 */
+	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) *
+			sw->sched_count + sw->qid_count*SW_IQS_MAX*2;
 
 	/* If this is a reconfiguration, free the previous IQ allocation. All
 	 * IQ chunk references were cleaned out of the QIDs in sw_stop(), and
@@ -535,14 +594,44 @@ sw_dev_configure(const struct rte_eventdev *dev)
 				       sw->data->socket_id);
 	if (!sw->chunks)
 		return -ENOMEM;
-
-	sw->chunk_list_head = NULL;
-	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+	/* the chunks are given to the schedulers in sw_start() */
+	sw->num_chunks = num_chunks;
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
 
+	/* rings for the events and completions sent by a scheduler to
+	 * another one, large enough for all the events of the device
+	 */
+	for (i = 0; i < sw->sched_count && sw->sched_count > 1; i++) {
+		struct sw_sched *sched = &sw->scheds[i];
+		char buf[RTE_RING_NAMESIZE];
+
+		rte_event_ring_free(sched->xfer_ring);
+		snprintf(buf, sizeof(buf), "sw%d_sched_%u",
+				data->dev_id, i);
+		sched->xfer_ring = rte_event_ring_create(buf,
+				rte_align32pow2(sw->nb_events_limit + 1),
+				data->socket_id, RING_F_SC_DEQ);
+		if (sched->xfer_ring == NULL) {
+			SW_LOG_ERR("Error creating scheduler %u ring\n", i);
+			return -ENOMEM;
+		}
+
+		rte_ring_free(sched->cmpl_ring);
+		snprintf(buf, sizeof(buf), "sw%d_sched_%u_cmpl",
+				data->dev_id, i);
+		sched->cmpl_ring = rte_ring_create_elem(buf,
+				sizeof(struct sw_cmpl),
+				rte_align32pow2(sw->nb_events_limit + 1),
+				data->socket_id, RING_F_SC_DEQ);
+		if (sched->cmpl_ring == NULL) {
+			SW_LOG_ERR("Error creating scheduler %u completion ring\n",
+					i);
+			return -ENOMEM;
+		}
+	}
+
 	return 0;
 }
 
@@ -627,12 +716,23 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	fprintf(f, "EventDev %s: ports %d, qids %d\n", "todo-fix-name",
 			sw->port_count, sw->qid_count);
 
-	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+	for (i = 0; i < sw->sched_count; i++) {
+		const struct sw_sched *sched = &sw->scheds[i];
+
+		if (sw->sched_count > 1)
+			fprintf(f, "  Scheduler %d: ports %d, qids %d\n", i,
+					sched->port_count, sched->qid_count);
+		fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
+			sched->stats.rx_pkts, sched->stats.rx_dropped,
+			sched->stats.tx_pkts);
+		fprintf(f, "\tsched calls: %"PRIu64"\n", sched->sched_called);
+		fprintf(f, "\tsched cq/qid call: %"PRIu64"\n",
+				sched->sched_cq_qid_called);
+		fprintf(f, "\tsched no IQ enq: %"PRIu64"\n",
+				sched->sched_no_iq_enqueues);
+		fprintf(f, "\tsched no CQ enq: %"PRIu64"\n",
+				sched->sched_no_cq_enqueues);
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -762,19 +862,112 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	}
 }
 
+/*
+ * Partition the ports and the QIDs between the schedulers. The ports are
+ * spread round-robin, and a directed QID goes with its port. The
+ * load-balanced QIDs are given one by one to the least loaded scheduler,
+ * by number of linked ports, starting with the most linked ones. A QID may
+ * thus be linked to ports of any scheduler.
+ */
+static void
+sw_sched_assign(struct sw_evdev *sw)
+{
+	uint8_t assigned[RTE_EVENT_MAX_QUEUES_PER_DEV] = {0};
+	uint32_t load[SW_SCHED_MAX] = {0};
+	uint32_t i, j, qidx, chunk = 0;
+
+	for (i = 0; i < sw->sched_count; i++) {
+		sw->scheds[i].port_count = 0;
+		sw->scheds[i].qid_count = 0;
+	}
+
+	for (i = 0; i < sw->port_count; i++) {
+		struct sw_sched *sched = &sw->scheds[i % sw->sched_count];
+
+		sw->ports[i].sched_id = sched->id;
+		sched->ports[sched->port_count++] = i;
+	}
+
+	for (i = 0; i < sw->qid_count; i++) {
+		struct sw_qid *qid = &sw->qids[i];
+
+		if (qid->type != SW_SCHED_TYPE_DIRECT)
+			continue;
+		qid->sched_id = sw->ports[qid->cq_map[0]].sched_id;
+		load[qid->sched_id]++;
+		assigned[i] = 1;
+	}
+
+	for (;;) {
+		uint32_t max_qid = sw->qid_count, min_sched = 0;
+
+		for (i = 0; i < sw->qid_count; i++)
+			if (!assigned[i] && (max_qid == sw->qid_count ||
+					sw->qids[i].cq_num_mapped_cqs >
+					sw->qids[max_qid].cq_num_mapped_cqs))
+				max_qid = i;
+		if (max_qid == sw->qid_count)
+			break;
+		for (i = 1; i < sw->sched_count; i++)
+			if (load[i] < load[min_sched])
+				min_sched = i;
+
+		sw->qids[max_qid].sched_id = min_sched;
+		load[min_sched] += sw->qids[max_qid].cq_num_mapped_cqs;
+		assigned[max_qid] = 1;
+	}
+
+	/* build up our prioritized array of qids */
+	/* We don't use qsort here, as if all/multiple entries have the same
+	 * priority, the result is non-deterministic. From "man 3 qsort":
+	 * "If two members compare as equal, their order in the sorted
+	 * array is undefined."
+	 */
+	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
+		for (i = 0; i < sw->qid_count; i++) {
+			if (sw->qids[i].priority == j) {
+				struct sw_sched *sched =
+					&sw->scheds[sw->qids[i].sched_id];
+
+				qidx = sched->qid_count++;
+				sched->qids_prioritized[qidx] = &sw->qids[i];
+			}
+		}
+	}
+
+	/* give each scheduler the chunks for its IQs and for all the events
+	 * of the device
+	 */
+	for (i = 0; i < sw->sched_count; i++) {
+		struct sw_sched *sched = &sw->scheds[i];
+		uint32_t count = (SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1 +
+				sched->qid_count*SW_IQS_MAX*2;
+
+		sched->chunk_list_head = NULL;
+		for (j = 0; j < count && chunk < sw->num_chunks; j++)
+			iq_free_chunk(sched, &sw->chunks[chunk++]);
+	}
+	while (chunk < sw->num_chunks)
+		iq_free_chunk(&sw->scheds[0], &sw->chunks[chunk++]);
+}
+
 static int
 sw_start(struct rte_eventdev *dev)
 {
-	unsigned int i, j;
+	unsigned int i;
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 
-	rte_service_component_runstate_set(sw->service_id, 1);
+	for (i = 0; i < sw->sched_count; i++) {
+		struct sw_sched *sched = &sw->scheds[i];
+
+		rte_service_component_runstate_set(sched->service_id, 1);
 
-	/* check a service core is mapped to this service */
-	if (!rte_service_runstate_get(sw->service_id)) {
-		SW_LOG_ERR("Warning: No Service core enabled on service %s\n",
-				sw->service_name);
-		return -ENOENT;
+		/* check a service core is mapped to this service */
+		if (!rte_service_runstate_get(sched->service_id)) {
+			SW_LOG_ERR("Warning: No Service core enabled on service %s\n",
+					sched->service_name);
+			return -ENOENT;
+		}
 	}
 
 	/* check all ports are set up */
@@ -792,22 +985,7 @@ sw_start(struct rte_eventdev *dev)
 			return -ENOLINK;
 		}
 
-	/* build up our prioritized array of qids */
-	/* We don't use qsort here, as if all/multiple entries have the same
-	 * priority, the result is non-deterministic. From "man 3 qsort":
-	 * "If two members compare as equal, their order in the sorted
-	 * array is undefined."
-	 */
-	uint32_t qidx = 0;
-	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
-		for (i = 0; i < sw->qid_count; i++) {
-			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
-			}
-		}
-	}
-
+	sw_sched_assign(sw);
 	sw_init_qid_iqs(sw);
 
 	if (sw_xstats_init(sw) < 0)
@@ -823,15 +1001,19 @@ static void
 sw_stop(struct rte_eventdev *dev)
 {
 	struct sw_evdev *sw = sw_pmd_priv(dev);
-	int32_t runstate;
+	int32_t runstate[SW_SCHED_MAX];
+	uint32_t i;
 
-	/* Stop the scheduler if it's running */
-	runstate = rte_service_runstate_get(sw->service_id);
-	if (runstate == 1)
-		rte_service_runstate_set(sw->service_id, 0);
+	/* Stop the schedulers if they're running */
+	for (i = 0; i < sw->sched_count; i++) {
+		runstate[i] = rte_service_runstate_get(sw->scheds[i].service_id);
+		if (runstate[i] == 1)
+			rte_service_runstate_set(sw->scheds[i].service_id, 0);
+	}
 
-	while (rte_service_may_be_active(sw->service_id))
-		rte_pause();
+	for (i = 0; i < sw->sched_count; i++)
+		while (rte_service_may_be_active(sw->scheds[i].service_id))
+			rte_pause();
 
 	/* Flush all events out of the device */
 	while (!(sw_qids_empty(sw) && sw_ports_empty(sw))) {
@@ -845,8 +1027,9 @@ sw_stop(struct rte_eventdev *dev)
 	sw->started = 0;
 	rte_smp_wmb();
 
-	if (runstate == 1)
-		rte_service_runstate_set(sw->service_id, 1);
+	for (i = 0; i < sw->sched_count; i++)
+		if (runstate[i] == 1)
+			rte_service_runstate_set(sw->scheds[i].service_id, 1);
 }
 
 static int
@@ -863,11 +1046,19 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->sched_count; i++) {
+		struct sw_sched *sched = &sw->scheds[i];
+
+		memset(&sched->stats, 0, sizeof(sched->stats));
+		sched->sched_called = 0;
+		sched->sched_no_iq_enqueues = 0;
+		sched->sched_no_cq_enqueues = 0;
+		sched->sched_cq_qid_called = 0;
+		rte_event_ring_free(sched->xfer_ring);
+		sched->xfer_ring = NULL;
+		rte_ring_free(sched->cmpl_ring);
+		sched->cmpl_ring = NULL;
+	}
 
 	return 0;
 }
@@ -932,10 +1123,20 @@ set_refill_once(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_lcores(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *sched_lcores = opaque;
+	*sched_lcores = atoi(value);
+	if (*sched_lcores < 1 || *sched_lcores > SW_SCHED_MAX)
+		return -1;
+	return 0;
+}
+
 static int32_t sw_sched_service_func(void *args)
 {
-	struct rte_eventdev *dev = args;
-	sw_event_schedule(dev);
+	struct sw_sched *sched = args;
+	sw_sched_schedule(sched);
 	return 0;
 }
 
@@ -981,6 +1182,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		MIN_BURST_SIZE_ARG,
 		DEQ_BURST_SIZE_ARG,
 		REFIL_ONCE_ARG,
+		SCHED_LCORES_ARG,
 		NULL
 	};
 	const char *name;
@@ -993,6 +1195,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	int min_burst_size = 1;
 	int deq_burst_size = SCHED_DEQUEUE_DEFAULT_BURST_SIZE;
 	int refill_once = 0;
+	int sched_lcores = 1;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1064,6 +1267,16 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_LCORES_ARG,
+					set_sched_lcores, &sched_lcores);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing scheduler lcores parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
@@ -1071,9 +1284,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	SW_LOG_INFO(
 			"Creating eventdev sw device %s, numa_node=%d, "
 			"sched_quanta=%d, credit_quanta=%d "
-			"min_burst=%d, deq_burst=%d, refill_once=%d\n",
+			"min_burst=%d, deq_burst=%d, refill_once=%d, "
+			"sched_lcores=%d\n",
 			name, socket_id, sched_quanta, credit_quanta,
-			min_burst_size, deq_burst_size, refill_once);
+			min_burst_size, deq_burst_size, refill_once,
+			sched_lcores);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1101,25 +1316,42 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->sched_min_burst_size = min_burst_size;
 	sw->sched_deq_burst_size = deq_burst_size;
 	sw->refill_once_per_iter = refill_once;
+	sw->sched_count = sched_lcores;
 
-	/* register service with EAL */
-	struct rte_service_spec service;
-	memset(&service, 0, sizeof(struct rte_service_spec));
-	snprintf(service.name, sizeof(service.name), "%s_service", name);
-	snprintf(sw->service_name, sizeof(sw->service_name), "%s_service",
-			name);
-	service.socket_id = socket_id;
-	service.callback = sw_sched_service_func;
-	service.callback_userdata = (void *)dev;
-
-	int32_t ret = rte_service_component_register(&service, &sw->service_id);
-	if (ret) {
-		SW_LOG_ERR("service register() failed");
-		return -ENOEXEC;
+	/* register a service with EAL per scheduler, the first one keeps the
+	 * name used by a single scheduler device
+	 */
+	uint32_t i;
+	for (i = 0; i < sw->sched_count; i++) {
+		struct sw_sched *sched = &sw->scheds[i];
+		struct rte_service_spec service;
+
+		sched->sw = sw;
+		sched->id = i;
+
+		memset(&service, 0, sizeof(struct rte_service_spec));
+		if (i == 0)
+			snprintf(service.name, sizeof(service.name),
+					"%s_service", name);
+		else
+			snprintf(service.name, sizeof(service.name),
+					"%s_service_%u", name, i);
+		strlcpy(sched->service_name, service.name,
+				sizeof(sched->service_name));
+		service.socket_id = socket_id;
+		service.callback = sw_sched_service_func;
+		service.callback_userdata = (void *)sched;
+
+		int32_t ret = rte_service_component_register(&service,
+				&sched->service_id);
+		if (ret) {
+			SW_LOG_ERR("service register() failed");
+			return -ENOEXEC;
+		}
 	}
 
 	dev->data->service_inited = 1;
-	dev->data->service_id = sw->service_id;
+	dev->data->service_id = sw->scheds[0].service_id;
 
 	event_dev_probing_finish(dev);
 
@@ -1149,5 +1381,5 @@ RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
 		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
 		MIN_BURST_SIZE_ARG "=<int>" DEQ_BURST_SIZE_ARG "=<int>"
-		REFIL_ONCE_ARG "=<int>");
+		REFIL_ONCE_ARG "=<int>" SCHED_LCORES_ARG "=<int>");
 RTE_LOG_REGISTER_DEFAULT(eventdev_sw_log_level, NOTICE);
@@ -36,6 +36,13 @@
 /* Flush the pipeline after this many no enq to cq */
 #define SCHED_NO_ENQ_CYCLE_FLUSH 256
 
+/* max number of schedulers, each run by its own service */
+#define SW_SCHED_MAX 8
+/* events buffered for another scheduler before being sent to it */
+#define SW_SCHED_XFER_BURST 32
+/* events buffered for a port of another scheduler before being sent to it */
+#define SW_SCHED_HANDOFF_BURST 8
+
 
 #define SW_PORT_HIST_LIST (MAX_SW_PROD_Q_DEPTH) /* size of our history list */
 #define NUM_SAMPLES 64 /* how many data points use for average stats */
@@ -126,6 +133,9 @@ struct sw_qid {
 	/* Track flow ids for atomic load balancing */
 	struct sw_fid_t fids[SW_QID_NUM_FIDS];
 
+	/* The scheduler this QID is scheduled by */
+	uint8_t sched_id;
+
 	/* Track packet order for reordering when needed */
 	struct reorder_buffer_entry *reorder_buffer; /*< pkts await reorder */
 	struct rob_ring *reorder_buffer_freelist; /* available reorder slots */
@@ -141,6 +151,22 @@ struct sw_hist_list_entry {
 	struct reorder_buffer_entry *rob_entry;
 };
 
+/* An event scheduled to a port of another scheduler */
+struct sw_handoff {
+	struct rte_event ev;
+	struct reorder_buffer_entry *rob_entry;
+};
+
+/* An event of a QID of another scheduler completed on a port */
+struct sw_cmpl {
+	struct rte_event ev;
+	struct reorder_buffer_entry *rob_entry;
+	uint16_t qid;
+	uint16_t fid;
+	uint8_t eop;
+	uint8_t valid; /* ev is forwarded, to be reordered */
+};
+
 struct sw_evdev;
 
 struct sw_port {
@@ -153,6 +179,8 @@ struct sw_port {
 	uint8_t initialized;
 	/* A numeric ID for the port */
 	uint8_t id;
+	/* The scheduler pulling from and pushing to this port */
+	uint8_t sched_id;
 
 	/* An atomic counter for when the port has been unlinked, and the
 	 * scheduler has not yet acked this unlink - hence there may still be
@@ -173,6 +201,8 @@ struct sw_port {
 	struct rte_event_ring *rx_worker_ring __rte_cache_aligned;
 	/** Ring and buffer for pushing packets to workers after scheduling */
 	struct rte_event_ring *cq_worker_ring;
+	/** Ring for the events scheduled to this port by other schedulers */
+	struct rte_ring *handoff_ring;
 
 	/* hole */
 
@@ -209,6 +239,68 @@ struct sw_port {
 	uint8_t num_qids_mapped;
 };
 
+/*
+ * A scheduler runs on its own service, and schedules a partition of the
+ * QIDs to any port. It also owns a partition of the ports: it pulls the
+ * events enqueued to them, and is the only one pushing events to their CQ
+ * and tracking them in their history list.
+ *
+ * Events enqueued to a QID of another scheduler are sent to it through its
+ * xfer ring. Events scheduled to a port of another scheduler are sent
+ * through the handoff ring of the port, and their completion is sent back
+ * to the scheduler of their QID through its cmpl ring.
+ */
+struct sw_sched {
+	struct sw_evdev *sw;
+	uint8_t id;
+
+	/* Ports owned and QIDs scheduled by this scheduler */
+	uint32_t port_count;
+	uint8_t ports[SW_PORTS_MAX];
+	uint32_t qid_count;
+	/* Array of pointers to load-balanced QIDs sorted by priority level */
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Free IQ chunks of the QIDs of this scheduler */
+	struct sw_queue_chunk *chunk_list_head;
+
+	/* Events sent to the QIDs of this scheduler by the other ones */
+	struct rte_event_ring *xfer_ring;
+	uint16_t xfer_count[SW_SCHED_MAX];
+	struct rte_event xfer_buf[SW_SCHED_MAX][SW_SCHED_XFER_BURST];
+
+	/* Completions of the events of this scheduler's QIDs done on the
+	 * ports of the other ones
+	 */
+	struct rte_ring *cmpl_ring;
+	uint16_t cmpl_count[SW_SCHED_MAX];
+	struct sw_cmpl cmpl_buf[SW_SCHED_MAX][SW_SCHED_XFER_BURST];
+
+	/* Events scheduled to the ports of the other schedulers */
+	uint64_t handoff_ports; /* bitmask of ports with buffered events */
+	uint16_t handoff_count[SW_PORTS_MAX];
+	struct sw_handoff handoff_buf[SW_PORTS_MAX][SW_SCHED_HANDOFF_BURST];
+
+	/* Current values */
+	uint32_t sched_flush_count;
+	uint32_t sched_min_burst;
+
+	/* Stats */
+	struct sw_point_stats stats __rte_cache_aligned;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+	uint64_t sched_last_iter_bitmask;
+	uint8_t sched_progress_last_iter;
+
+	/* Reorder entry updated on completion of events not reordered */
+	struct reorder_buffer_entry dummy_rob;
+
+	uint32_t service_id;
+	char service_name[SW_PMD_NAME_MAX];
+} __rte_cache_aligned;
+
 struct sw_evdev {
 	struct rte_eventdev_data *data;
 
@@ -226,9 +318,6 @@ struct sw_evdev {
 	uint32_t sched_deq_burst_size;
 	/* Refill pp buffers only once per scheduler call*/
 	uint32_t refill_once_per_iter;
-	/* Current values */
-	uint32_t sched_flush_count;
-	uint32_t sched_min_burst;
 
 	/* Contains all ports - load balanced and directed */
 	struct sw_port ports[SW_PORTS_MAX] __rte_cache_aligned;
@@ -243,24 +332,13 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV] __rte_cache_aligned;
-	struct sw_queue_chunk *chunk_list_head;
 	struct sw_queue_chunk *chunks;
+	uint32_t num_chunks;
 
 	/* Cache how many packets are in each cq */
 	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
 
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
-
-	/* Stats */
-	struct sw_point_stats stats __rte_cache_aligned;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
-	uint64_t sched_last_iter_bitmask;
-	uint8_t sched_progress_last_iter;
 
 	uint8_t started;
 	uint32_t credit_update_quanta;
@@ -272,8 +350,9 @@ struct sw_evdev {
 	uint16_t xstats_count_per_qid[RTE_EVENT_MAX_QUEUES_PER_DEV];
 	uint16_t xstats_offset_for_qid[RTE_EVENT_MAX_QUEUES_PER_DEV];
 
-	uint32_t service_id;
-	char service_name[SW_PMD_NAME_MAX];
+	/* Schedulers, the first one runs on the eventdev service */
+	uint32_t sched_count;
+	struct sw_sched scheds[SW_SCHED_MAX];
 };
 
 static inline struct sw_evdev *
@@ -296,6 +375,7 @@ uint16_t sw_event_dequeue(void *port, struct rte_event *ev, uint64_t wait);
 uint16_t sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 			uint64_t wait);
 void sw_event_schedule(struct rte_eventdev *dev);
+void sw_sched_schedule(struct sw_sched *sched);
 int sw_xstats_init(struct sw_evdev *dev);
 int sw_xstats_uninit(struct sw_evdev *dev);
 int sw_xstats_get_names(const struct rte_eventdev *dev,
@@ -27,10 +27,90 @@
 /* use cheap bit mixing, we only need to lose a few bits */
 #define SW_HASH_FLOWID(f) (((f) ^ (f >> 10)) & FLOWID_MASK)
 
+/* Room left in the CQ of a port of another scheduler, taking into account
+ * the events handed off to it and not yet pushed to the CQ
+ */
+static __rte_always_inline uint32_t
+sw_handoff_space(const struct sw_sched *sched, const struct sw_port *p)
+{
+	uint32_t space = rte_event_ring_free_count(p->cq_worker_ring);
+	uint32_t pending = rte_ring_count(p->handoff_ring) +
+			sched->handoff_count[p->id];
+
+	return space > pending ? space - pending : 0;
+}
+
+static __rte_always_inline uint32_t
+sw_cq_space(const struct sw_evdev *sw, const struct sw_sched *sched,
+		uint32_t cq)
+{
+	const struct sw_port *p = &sw->ports[cq];
+
+	if (likely(p->sched_id == sched->id))
+		return sw->cq_ring_space[cq];
+	return sw_handoff_space(sched, p);
+}
+
+/* Send the events buffered for a port of another scheduler */
+static void
+sw_sched_handoff_flush(struct sw_sched *sched, struct sw_port *p)
+{
+	uint16_t count = sched->handoff_count[p->id];
+	uint16_t sent;
+
+	sent = rte_ring_enqueue_burst_elem(p->handoff_ring,
+			sched->handoff_buf[p->id], sizeof(struct sw_handoff),
+			count, NULL);
+	if (unlikely(sent != count))
+		memmove(sched->handoff_buf[p->id],
+				&sched->handoff_buf[p->id][sent],
+				(count - sent) * sizeof(struct sw_handoff));
+	sched->handoff_count[p->id] = count - sent;
+	if (count == sent)
+		sched->handoff_ports &= ~(UINT64_C(1) << p->id);
+}
+
+static void
+sw_sched_handoff_flush_all(struct sw_evdev *sw, struct sw_sched *sched)
+{
+	uint64_t ports = sched->handoff_ports;
+
+	while (ports) {
+		uint32_t port_id = __builtin_ctzll(ports);
+
+		ports &= ports - 1;
+		sw_sched_handoff_flush(sched, &sw->ports[port_id]);
+	}
+}
+
+/* Buffer an event scheduled to a port of another scheduler. The handoff
+ * rings can hold all the events of the device, and the callers check
+ * sw_handoff_space(), so they are never full.
+ */
+static __rte_always_inline void
+sw_sched_handoff(struct sw_sched *sched, struct sw_port *p,
+		const struct rte_event *qe,
+		struct reorder_buffer_entry *rob_entry)
+{
+	struct sw_handoff *h;
+
+	if (unlikely(sched->handoff_count[p->id] == SW_SCHED_HANDOFF_BURST)) {
+		sw_sched_handoff_flush(sched, p);
+		if (sched->handoff_count[p->id] == SW_SCHED_HANDOFF_BURST) {
+			sched->stats.rx_dropped++;
+			return;
+		}
+	}
+	h = &sched->handoff_buf[p->id][sched->handoff_count[p->id]++];
+	h->ev = *qe;
+	h->rob_entry = rob_entry;
+	sched->handoff_ports |= UINT64_C(1) << p->id;
+}
+
 
 static inline uint32_t
-sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count)
+sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_sched *sched,
+		struct sw_qid * const qid, uint32_t iq_num, unsigned int count)
 {
 	struct rte_event qes[MAX_PER_IQ_DEQUEUE]; /* count <= MAX */
 	struct rte_event blocked_qes[MAX_PER_IQ_DEQUEUE];
@@ -45,7 +125,7 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	 */
 	uint32_t qid_id = qid->id;
 
-	iq_dequeue_burst(sw, &qid->iq[iq_num], qes, count);
+	iq_dequeue_burst(sched, &qid->iq[iq_num], qes, count);
 	for (i = 0; i < count; i++) {
 		const struct rte_event *qe = &qes[i];
 		const uint16_t flow_id = SW_HASH_FLOWID(qes[i].flow_id);
@@ -61,11 +141,12 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			cq = qid->cq_map[cq_idx];
 
 			/* find least used */
-			int cq_free_cnt = sw->cq_ring_space[cq];
+			int cq_free_cnt = sw_cq_space(sw, sched, cq);
 			for (cq_idx = 0; cq_idx < qid->cq_num_mapped_cqs;
 					cq_idx++) {
 				int test_cq = qid->cq_map[cq_idx];
-				int test_cq_free = sw->cq_ring_space[test_cq];
+				int test_cq_free = sw_cq_space(sw, sched,
+						test_cq);
 				if (test_cq_free > cq_free_cnt) {
 					cq = test_cq;
 					cq_free_cnt = test_cq_free;
@@ -75,6 +156,19 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			fid->cq = cq; /* this pins early */
 		}
 
+		if (unlikely(sw->ports[cq].sched_id != sched->id)) {
+			if (sw_handoff_space(sched, &sw->ports[cq]) == 0) {
+				blocked_qes[nb_blocked++] = *qe;
+				continue;
+			}
+
+			fid->pcount++;
+			sw_sched_handoff(sched, &sw->ports[cq], qe, NULL);
+			qid->stats.tx_pkts++;
+			qid->to_port[cq]++;
+			continue;
+		}
+
 		if (sw->cq_ring_space[cq] == 0 ||
 				sw->ports[cq].inflights == SW_PORT_HIST_LIST) {
 			blocked_qes[nb_blocked++] = *qe;
@@ -106,14 +200,15 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			p->cq_buf_count = 0;
 		}
 	}
-	iq_put_back(sw, &qid->iq[iq_num], blocked_qes, nb_blocked);
+	iq_put_back(sched, &qid->iq[iq_num], blocked_qes, nb_blocked);
 
 	return count - nb_blocked;
 }
 
 static inline uint32_t
-sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count, int keep_order)
+sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_sched *sched,
+		struct sw_qid * const qid, uint32_t iq_num, unsigned int count,
+		int keep_order)
 {
 	uint32_t i;
 	uint32_t cq_idx = qid->cq_next_tx;
@@ -153,6 +248,21 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 					sw->ports[cq].cq_worker_ring) == 0);
 
 		struct sw_port *p = &sw->ports[cq];
+		if (unlikely(p->sched_id != sched->id)) {
+			struct reorder_buffer_entry *rob_entry = NULL;
+
+			if (sw_handoff_space(sched, p) == 0)
+				break;
+
+			qid->stats.tx_pkts++;
+			if (keep_order)
+				rob_ring_dequeue(qid->reorder_buffer_freelist,
+						(void *)&rob_entry);
+			sw_sched_handoff(sched, p, qe, rob_entry);
+			iq_pop(sched, &qid->iq[iq_num]);
+			continue;
+		}
+
 		if (sw->cq_ring_space[cq] == 0 ||
 				p->inflights == SW_PORT_HIST_LIST)
 			break;
@@ -170,7 +280,7 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 					(void *)&p->hist_list[head].rob_entry);
 
 		sw->ports[cq].cq_buf[sw->ports[cq].cq_buf_count++] = *qe;
-		iq_pop(sw, &qid->iq[iq_num]);
+		iq_pop(sched, &qid->iq[iq_num]);
 
 		rte_compiler_barrier();
 		p->inflights++;
@@ -183,8 +293,9 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 }
 
 static uint32_t
-sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count __rte_unused)
+sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_sched *sched,
+		struct sw_qid * const qid, uint32_t iq_num,
+		unsigned int count __rte_unused)
 {
 	uint32_t cq_id = qid->cq_map[0];
 	struct sw_port *port = &sw->ports[cq_id];
@@ -196,7 +307,7 @@ sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 
 	/* burst dequeue from the QID IQ ring */
 	struct sw_iq *iq = &qid->iq[iq_num];
-	uint32_t ret = iq_dequeue_burst(sw, iq,
+	uint32_t ret = iq_dequeue_burst(sched, iq,
 			&port->cq_buf[port->cq_buf_count], count_free);
 	port->cq_buf_count += ret;
 
@@ -211,15 +322,15 @@ sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 }
 
 static uint32_t
-sw_schedule_qid_to_cq(struct sw_evdev *sw)
+sw_schedule_qid_to_cq(struct sw_evdev *sw, struct sw_sched *sched)
 {
 	uint32_t pkts = 0;
 	uint32_t qid_idx;
 
-	sw->sched_cq_qid_called++;
+	sched->sched_cq_qid_called++;
 
-	for (qid_idx = 0; qid_idx < sw->qid_count; qid_idx++) {
-		struct sw_qid *qid = sw->qids_prioritized[qid_idx];
+	for (qid_idx = 0; qid_idx < sched->qid_count; qid_idx++) {
+		struct sw_qid *qid = sched->qids_prioritized[qid_idx];
 
 		int type = qid->type;
 		int iq_num = PKT_MASK_TO_IQ(qid->iq_pkt_mask);
@@ -231,16 +342,16 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 		uint32_t pkts_done = 0;
 		uint32_t count = iq_count(&qid->iq[iq_num]);
 
-		if (count >= sw->sched_min_burst) {
+		if (count >= sched->sched_min_burst) {
 			if (type == SW_SCHED_TYPE_DIRECT)
-				pkts_done += sw_schedule_dir_to_cq(sw, qid,
-						iq_num, count);
+				pkts_done += sw_schedule_dir_to_cq(sw, sched,
+						qid, iq_num, count);
 			else if (type == RTE_SCHED_TYPE_ATOMIC)
-				pkts_done += sw_schedule_atomic_to_cq(sw, qid,
-						iq_num, count);
+				pkts_done += sw_schedule_atomic_to_cq(sw, sched,
+						qid, iq_num, count);
 			else
-				pkts_done += sw_schedule_parallel_to_cq(sw, qid,
-						iq_num, count,
+				pkts_done += sw_schedule_parallel_to_cq(sw,
+						sched, qid, iq_num, count,
 						type == RTE_SCHED_TYPE_ORDERED);
 		}
 
@@ -256,12 +367,228 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 	return pkts;
 }
 
+/* Push the events scheduled to the ports of this scheduler by the other
+ * ones to their CQ buffer, tracking them in the port history lists.
+ */
+static uint32_t
+sw_schedule_handoff_to_cq(struct sw_evdev *sw, struct sw_sched *sched)
+{
+	struct sw_handoff hs[MAX_SW_CONS_Q_DEPTH];
+	uint32_t i, j, n, space, pkts = 0;
+
+	for (i = 0; i < sched->port_count; i++) {
+		uint32_t port_id = sched->ports[i];
+		struct sw_port *p = &sw->ports[port_id];
+
+		space = RTE_MIN(sw->cq_ring_space[port_id],
+				SW_PORT_HIST_LIST - p->inflights);
+		if (space == 0)
+			continue;
+
+		n = rte_ring_sc_dequeue_burst_elem(p->handoff_ring, hs,
+				sizeof(hs[0]), RTE_MIN(space, RTE_DIM(hs)),
+				NULL);
+		for (j = 0; j < n; j++) {
+			const int head = (p->hist_head++ &
+					(SW_PORT_HIST_LIST - 1));
+
+			p->hist_list[head].fid =
+				SW_HASH_FLOWID(hs[j].ev.flow_id);
+			p->hist_list[head].qid = hs[j].ev.queue_id;
+			p->hist_list[head].rob_entry = hs[j].rob_entry;
+			p->cq_buf[p->cq_buf_count++] = hs[j].ev;
+		}
+		p->inflights += n;
+		p->stats.tx_pkts += n;
+		sw->cq_ring_space[port_id] -= n;
+		pkts += n;
+	}
+
+	return pkts;
+}
+
+/* Send the buffered events to the scheduler of their QID */
+static void
+sw_sched_xfer_flush(struct sw_evdev *sw, struct sw_sched *sched,
+		uint32_t dst)
+{
+	uint16_t count = sched->xfer_count[dst];
+	uint16_t sent;
+
+	sent = rte_event_ring_enqueue_burst(sw->scheds[dst].xfer_ring,
+			sched->xfer_buf[dst], count, NULL);
+	if (unlikely(sent != count))
+		memmove(sched->xfer_buf[dst], &sched->xfer_buf[dst][sent],
+				(count - sent) * sizeof(struct rte_event));
+	sched->xfer_count[dst] = count - sent;
+}
+
+static void
+sw_sched_xfer_flush_all(struct sw_evdev *sw, struct sw_sched *sched)
+{
+	uint32_t i;
+
+	for (i = 0; i < sw->sched_count; i++)
+		if (sched->xfer_count[i] != 0)
+			sw_sched_xfer_flush(sw, sched, i);
+}
+
+/* Buffer an event enqueued to a QID of another scheduler. The xfer rings
+ * can hold all the events of the device, so they are never full.
+ */
+static __rte_always_inline void
+sw_sched_xfer(struct sw_evdev *sw, struct sw_sched *sched,
+		const struct sw_qid *qid, const struct rte_event *qe)
+{
+	uint32_t dst = qid->sched_id;
+
+	if (unlikely(sched->xfer_count[dst] == SW_SCHED_XFER_BURST)) {
+		sw_sched_xfer_flush(sw, sched, dst);
+		if (sched->xfer_count[dst] == SW_SCHED_XFER_BURST) {
+			sched->stats.rx_dropped++;
+			return;
+		}
+	}
+	sched->xfer_buf[dst][sched->xfer_count[dst]++] = *qe;
+}
+
+/* Send the buffered completions to the scheduler of their QID */
+static void
+sw_sched_cmpl_flush(struct sw_evdev *sw, struct sw_sched *sched,
+		uint32_t dst)
+{
+	uint16_t count = sched->cmpl_count[dst];
+	uint16_t sent;
+
+	sent = rte_ring_enqueue_burst_elem(sw->scheds[dst].cmpl_ring,
+			sched->cmpl_buf[dst], sizeof(struct sw_cmpl), count,
+			NULL);
+	if (unlikely(sent != count))
+		memmove(sched->cmpl_buf[dst], &sched->cmpl_buf[dst][sent],
+				(count - sent) * sizeof(struct sw_cmpl));
+	sched->cmpl_count[dst] = count - sent;
+}
+
+static void
+sw_sched_cmpl_flush_all(struct sw_evdev *sw, struct sw_sched *sched)
+{
+	uint32_t i;
+
+	for (i = 0; i < sw->sched_count; i++)
+		if (sched->cmpl_count[i] != 0)
+			sw_sched_cmpl_flush(sw, sched, i);
+}
+
+/* Buffer the completion of an event of a QID of another scheduler. Returns
+ * -1 if it cannot be buffered, the port is then pulled again later.
+ */
+static __rte_always_inline int
+sw_sched_cmpl(struct sw_evdev *sw, struct sw_sched *sched,
+		const struct sw_qid *qid, uint32_t fid,
+		struct reorder_buffer_entry *rob_entry,
+		const struct rte_event *qe, uint8_t eop, uint8_t valid)
+{
+	uint32_t dst = qid->sched_id;
+	struct sw_cmpl *c;
+
+	if (unlikely(sched->cmpl_count[dst] == SW_SCHED_XFER_BURST)) {
+		/* the events forwarded before are sent first */
+		sw_sched_xfer_flush_all(sw, sched);
+		sw_sched_cmpl_flush(sw, sched, dst);
+		if (sched->cmpl_count[dst] == SW_SCHED_XFER_BURST)
+			return -1;
+	}
+	c = &sched->cmpl_buf[dst][sched->cmpl_count[dst]++];
+	c->ev = *qe;
+	c->rob_entry = rob_entry;
+	c->qid = qid->id;
+	c->fid = fid;
+	c->eop = eop;
+	c->valid = valid;
+	return 0;
+}
+
+/* Apply the completion of an event of a QID of this scheduler, done on a
+ * port of another scheduler
+ */
+static __rte_always_inline void
+sw_sched_complete(struct sw_evdev *sw, struct sw_sched *sched,
+		const struct sw_cmpl *c)
+{
+	struct sw_qid *qid = &sw->qids[c->qid];
+	struct reorder_buffer_entry *rob_entry = c->rob_entry;
+
+	if (qid->type == RTE_SCHED_TYPE_ATOMIC) {
+		struct sw_fid_t *fid = &qid->fids[c->fid];
+
+		fid->pcount -= c->eop;
+		if (fid->pcount == 0)
+			fid->cq = -1;
+	}
+
+	if (rob_entry == NULL)
+		return;
+
+	rob_entry->ready = c->eop;
+	if (c->valid) {
+		if (rob_entry->num_fragments == SW_FRAGMENTS_MAX)
+			sched->stats.rx_dropped++;
+		else
+			rob_entry->fragments[rob_entry->num_fragments++] =
+				c->ev;
+	}
+}
+
+/*
+ * Enqueue the events sent by the other schedulers to the QID IQs, and
+ * apply the completions sent by them. A port forwards an event before
+ * sending the completion of the event it comes from: the completions are
+ * dequeued first, so that an atomic flow is not released before all the
+ * events forwarded from it are in the IQs.
+ */
+static uint32_t
+sw_schedule_pull_xfer(struct sw_evdev *sw, struct sw_sched *sched)
+{
+	struct rte_event qes[SCHED_DEQUEUE_MAX_BURST_SIZE];
+	struct sw_cmpl cmpls[SCHED_DEQUEUE_MAX_BURST_SIZE];
+	uint32_t i, n, count, nb_cmpls, pkts = 0;
+
+	nb_cmpls = rte_ring_sc_dequeue_burst_elem(sched->cmpl_ring, cmpls,
+			sizeof(cmpls[0]), sw->sched_deq_burst_size, NULL);
+
+	count = rte_event_ring_count(sched->xfer_ring);
+	while (count > 0) {
+		n = rte_event_ring_dequeue_burst(sched->xfer_ring, qes,
+				RTE_MIN(count, sw->sched_deq_burst_size), NULL);
+		for (i = 0; i < n; i++) {
+			const struct rte_event *qe = &qes[i];
+			uint32_t iq_num = PRIO_TO_IQ(qe->priority);
+			struct sw_qid *qid = &sw->qids[qe->queue_id];
+
+			qid->iq_pkt_mask |= (1 << (iq_num));
+			iq_enqueue(sched, &qid->iq[iq_num], qe);
+			qid->iq_pkt_count[iq_num]++;
+			qid->stats.rx_pkts++;
+		}
+		if (n == 0)
+			break;
+		count -= n;
+		pkts += n;
+	}
+
+	for (i = 0; i < nb_cmpls; i++)
+		sw_sched_complete(sw, sched, &cmpls[i]);
+
+	return pkts;
+}
+
 /* This function will perform re-ordering of packets, and injecting into
  * the appropriate QID IQ. As LB and DIR QIDs are in the same array, but *NOT*
  * contiguous in that array, this function accepts a "range" of QIDs to scan.
  */
 static uint16_t
-sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
+sw_schedule_reorder(struct sw_evdev *sw, struct sw_sched *sched,
+		int qid_start, int qid_end)
 {
 	/* Perform egress reordering */
 	struct rte_event *qe;
@@ -271,13 +598,14 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 		struct sw_qid *qid = &sw->qids[qid_start];
 		unsigned int i, num_entries_in_use;
 
-		if (qid->type != RTE_SCHED_TYPE_ORDERED)
+		if (qid->type != RTE_SCHED_TYPE_ORDERED ||
+				qid->sched_id != sched->id)
 			continue;
 
 		num_entries_in_use = rob_ring_free_count(
 					qid->reorder_buffer_freelist);
 
-		if (num_entries_in_use < sw->sched_min_burst)
+		if (num_entries_in_use < sched->sched_min_burst)
 			num_entries_in_use = 0;
 
 		for (i = 0; i < num_entries_in_use; i++) {
@@ -300,7 +628,7 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 				dest_iq  = PRIO_TO_IQ(qe->priority);
 
 				if (dest_qid >= sw->qid_count) {
-					sw->stats.rx_dropped++;
+					sched->stats.rx_dropped++;
 					continue;
 				}
 
@@ -309,10 +637,15 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 				struct sw_qid *q = &sw->qids[dest_qid];
 				struct sw_iq *iq = &q->iq[dest_iq];
 
+				if (q->sched_id != sched->id) {
+					sw_sched_xfer(sw, sched, q, qe);
+					continue;
+				}
+
 				/* we checked for space above, so enqueue must
 				 * succeed
 				 */
-				iq_enqueue(sw, iq, qe);
+				iq_enqueue(sched, iq, qe);
 				q->iq_pkt_mask |= (1 << (dest_iq));
 				q->iq_pkt_count[dest_iq]++;
 				q->stats.rx_pkts++;
@@ -348,14 +681,17 @@ sw_refill_pp_buf(struct sw_evdev *sw, struct sw_port *port)
 }
 
 static __rte_always_inline uint32_t
-__pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
+__pull_port_lb(struct sw_evdev *sw, struct sw_sched *sched, uint32_t port_id,
+		int allow_reorder)
 {
-	static struct reorder_buffer_entry dummy_rob;
 	uint32_t pkts_iter = 0;
 	struct sw_port *port = &sw->ports[port_id];
 
-	/* If shadow ring has 0 pkts, pull from worker ring */
-	if (!sw->refill_once_per_iter && port->pp_buf_count == 0)
+	/* If shadow ring has 0 pkts, pull from worker ring. With several
+	 * schedulers, it is pulled before the events of the other ones.
+	 */
+	if (!sw->refill_once_per_iter && sw->sched_count == 1 &&
+			port->pp_buf_count == 0)
 		sw_refill_pp_buf(sw, port);
 
 	while (port->pp_buf_count) {
@@ -390,6 +726,34 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 			const uint32_t hist_qid = hist_entry->qid;
 			const uint32_t hist_fid = hist_entry->fid;
 
+			/* the event of a QID of another scheduler is completed
+			 * by it, and reordered by it when needed
+			 */
+			if (unlikely(sw->qids[hist_qid].sched_id !=
+					sched->id)) {
+				struct sw_qid *hq = &sw->qids[hist_qid];
+				struct reorder_buffer_entry *rob_entry =
+					allow_reorder ?
+					hist_entry->rob_entry : NULL;
+
+				if ((hq->type == RTE_SCHED_TYPE_ATOMIC ||
+						rob_entry != NULL) &&
+						sw_sched_cmpl(sw, sched, hq,
+						hist_fid, rob_entry, qe, eop,
+						!!(flags & QE_FLAG_VALID)) < 0)
+					break;
+
+				port->inflights -= eop;
+				port->hist_tail += eop;
+				if (rob_entry != NULL) {
+					hist_entry->rob_entry = NULL;
+					port->stats.rx_pkts +=
+						!!(flags & QE_FLAG_VALID);
+					goto end_qe;
+				}
+				goto forward;
+			}
+
 			struct sw_fid_t *fid =
 				&sw->qids[hist_qid].fids[hist_fid];
 			fid->pcount -= eop;
@@ -402,8 +766,8 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 					(uintptr_t)hist_entry->rob_entry;
 				const uintptr_t valid = (rob_ptr != 0);
 				needs_reorder = valid;
-				rob_ptr |=
-					((valid - 1) & (uintptr_t)&dummy_rob);
+				rob_ptr |= ((valid - 1) &
+					(uintptr_t)&sched->dummy_rob);
 				struct reorder_buffer_entry *tmp_rob_ptr =
 					(struct reorder_buffer_entry *)rob_ptr;
 				tmp_rob_ptr->ready = eop * needs_reorder;
@@ -412,6 +776,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 			port->inflights -= eop;
 			port->hist_tail += eop;
 		}
+forward:
 		if (flags & QE_FLAG_VALID) {
 			port->stats.rx_pkts++;
 
@@ -427,7 +792,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				 */
 				int num_frag = rob_entry->num_fragments;
 				if (num_frag == SW_FRAGMENTS_MAX)
-					sw->stats.rx_dropped++;
+					sched->stats.rx_dropped++;
 				else {
 					int idx = rob_entry->num_fragments++;
 					rob_entry->fragments[idx] = *qe;
@@ -435,15 +800,20 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				goto end_qe;
 			}
 
+			pkts_iter++;
+			if (qid->sched_id != sched->id) {
+				sw_sched_xfer(sw, sched, qid, qe);
+				goto end_qe;
+			}
+
 			/* Use the iq_num from above to push the QE
 			 * into the qid at the right priority
 			 */
 
 			qid->iq_pkt_mask |= (1 << (iq_num));
-			iq_enqueue(sw, &qid->iq[iq_num], qe);
+			iq_enqueue(sched, &qid->iq[iq_num], qe);
 			qid->iq_pkt_count[iq_num]++;
 			qid->stats.rx_pkts++;
-			pkts_iter++;
 		}
 
 end_qe:
@@ -455,25 +825,31 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 }
 
 static uint32_t
-sw_schedule_pull_port_lb(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_lb(struct sw_evdev *sw, struct sw_sched *sched,
+		uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 1);
+	return __pull_port_lb(sw, sched, port_id, 1);
 }
 
 static uint32_t
-sw_schedule_pull_port_no_reorder(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_no_reorder(struct sw_evdev *sw, struct sw_sched *sched,
+		uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 0);
+	return __pull_port_lb(sw, sched, port_id, 0);
 }
 
 static uint32_t
-sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_dir(struct sw_evdev *sw, struct sw_sched *sched,
+		uint32_t port_id)
 {
 	uint32_t pkts_iter = 0;
 	struct sw_port *port = &sw->ports[port_id];
 
-	/* If shadow ring has 0 pkts, pull from worker ring */
-	if (!sw->refill_once_per_iter && port->pp_buf_count == 0)
+	/* If shadow ring has 0 pkts, pull from worker ring. With several
+	 * schedulers, it is pulled before the events of the other ones.
+	 */
+	if (!sw->refill_once_per_iter && sw->sched_count == 1 &&
+			port->pp_buf_count == 0)
 		sw_refill_pp_buf(sw, port);
 
 	while (port->pp_buf_count) {
@@ -488,15 +864,19 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 		struct sw_iq *iq = &qid->iq[iq_num];
 
 		port->stats.rx_pkts++;
+		pkts_iter++;
+		if (qid->sched_id != sched->id) {
+			sw_sched_xfer(sw, sched, qid, qe);
+			goto end_qe;
+		}
 
 		/* Use the iq_num from above to push the QE
 		 * into the qid at the right priority
 		 */
 		qid->iq_pkt_mask |= (1 << (iq_num));
-		iq_enqueue(sw, iq, qe);
+		iq_enqueue(sched, iq, qe);
 		qid->iq_pkt_count[iq_num]++;
 		qid->stats.rx_pkts++;
-		pkts_iter++;
 
 end_qe:
 		port->pp_buf_start++;
@@ -507,15 +887,15 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 }
 
 void
-sw_event_schedule(struct rte_eventdev *dev)
+sw_sched_schedule(struct sw_sched *sched)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_evdev *sw = sched->sw;
 	uint32_t in_pkts, out_pkts;
 	uint32_t out_pkts_total = 0, in_pkts_total = 0;
 	int32_t sched_quanta = sw->sched_quanta;
 	uint32_t i;
 
-	sw->sched_called++;
+	sched->sched_called++;
 	if (unlikely(!sw->started))
 		return;
 
@@ -525,27 +905,68 @@ sw_event_schedule(struct rte_eventdev *dev)
 		/* Pull from rx_ring for ports */
 		do {
 			in_pkts = 0;
-			for (i = 0; i < sw->port_count; i++) {
-				/* ack the unlinks in progress as done */
-				if (sw->ports[i].unlinks_in_progress)
-					sw->ports[i].unlinks_in_progress = 0;
-
-				if (sw->ports[i].is_directed)
-					in_pkts += sw_schedule_pull_port_dir(sw, i);
-				else if (sw->ports[i].num_ordered_qids > 0)
-					in_pkts += sw_schedule_pull_port_lb(sw, i);
+			if (sw->sched_count > 1) {
+				/* an event enqueued to a port may have been
+				 * forwarded after the events sent by the other
+				 * schedulers, pull it first
+				 */
+				for (i = 0; !sw->refill_once_per_iter &&
+						i < sched->port_count; i++) {
+					struct sw_port *port =
+						&sw->ports[sched->ports[i]];
+
+					if (port->pp_buf_count == 0)
+						sw_refill_pp_buf(sw, port);
+				}
+				in_pkts += sw_schedule_pull_xfer(sw, sched);
+			}
+
+			for (i = 0; i < sched->port_count; i++) {
+				uint32_t port_id = sched->ports[i];
+				struct sw_port *port = &sw->ports[port_id];
+
+				/* ack the unlinks in progress as done, once
+				 * the events handed off to the port by the
+				 * other schedulers are in its CQ
+				 */
+				if (port->unlinks_in_progress &&
+						(port->handoff_ring == NULL ||
+						rte_ring_empty(
+							port->handoff_ring)))
+					port->unlinks_in_progress = 0;
+
+				if (port->is_directed)
+					in_pkts += sw_schedule_pull_port_dir(sw,
+							sched, port_id);
+				else if (port->num_ordered_qids > 0)
+					in_pkts += sw_schedule_pull_port_lb(sw,
+							sched, port_id);
 				else
-					in_pkts += sw_schedule_pull_port_no_reorder(sw, i);
+					in_pkts += sw_schedule_pull_port_no_reorder(
+							sw, sched, port_id);
 			}
 
 			/* QID scan for re-ordered */
-			in_pkts += sw_schedule_reorder(sw, 0,
+			in_pkts += sw_schedule_reorder(sw, sched, 0,
 					sw->qid_count);
+
+			/* send events to the other schedulers, before the
+			 * completions of the events they were forwarded from
+			 */
+			if (sw->sched_count > 1) {
+				sw_sched_xfer_flush_all(sw, sched);
+				sw_sched_cmpl_flush_all(sw, sched);
+			}
+
 			in_pkts_this_iteration += in_pkts;
 		} while (in_pkts > 4 &&
 				(int)in_pkts_this_iteration < sched_quanta);
 
-		out_pkts = sw_schedule_qid_to_cq(sw);
+		out_pkts = sw_schedule_qid_to_cq(sw, sched);
+		if (sw->sched_count > 1) {
+			sw_sched_handoff_flush_all(sw, sched);
+			sw_schedule_handoff_to_cq(sw, sched);
+		}
 		out_pkts_total += out_pkts;
 		in_pkts_total += in_pkts_this_iteration;
 
@@ -553,14 +974,14 @@ sw_event_schedule(struct rte_eventdev *dev)
 			break;
 	} while ((int)out_pkts_total < sched_quanta);
 
-	sw->stats.tx_pkts += out_pkts_total;
-	sw->stats.rx_pkts += in_pkts_total;
+	sched->stats.tx_pkts += out_pkts_total;
+	sched->stats.rx_pkts += in_pkts_total;
 
-	sw->sched_no_iq_enqueues += (in_pkts_total == 0);
-	sw->sched_no_cq_enqueues += (out_pkts_total == 0);
+	sched->sched_no_iq_enqueues += (in_pkts_total == 0);
+	sched->sched_no_cq_enqueues += (out_pkts_total == 0);
 
 	uint64_t work_done = (in_pkts_total + out_pkts_total) != 0;
-	sw->sched_progress_last_iter = work_done;
+	sched->sched_progress_last_iter = work_done;
 
 	uint64_t cqs_scheds_last_iter = 0;
 
@@ -568,46 +989,58 @@ sw_event_schedule(struct rte_eventdev *dev)
 	 * worker cores: aka, do the ring transfers batched.
 	 */
 	int no_enq = 1;
-	for (i = 0; i < sw->port_count; i++) {
-		struct sw_port *port = &sw->ports[i];
+	for (i = 0; i < sched->port_count; i++) {
+		uint32_t port_id = sched->ports[i];
+		struct sw_port *port = &sw->ports[port_id];
 		struct rte_event_ring *worker = port->cq_worker_ring;
 
 		/* If shadow ring has 0 pkts, pull from worker ring */
 		if (sw->refill_once_per_iter && port->pp_buf_count == 0)
 			sw_refill_pp_buf(sw, port);
 
-		if (port->cq_buf_count >= sw->sched_min_burst) {
+		if (port->cq_buf_count >= sched->sched_min_burst) {
 			rte_event_ring_enqueue_burst(worker,
 					port->cq_buf,
 					port->cq_buf_count,
-					&sw->cq_ring_space[i]);
+					&sw->cq_ring_space[port_id]);
 			port->cq_buf_count = 0;
 			no_enq = 0;
-			cqs_scheds_last_iter |= (1ULL << i);
+			cqs_scheds_last_iter |= (1ULL << (port_id & 63));
 		} else {
-			sw->cq_ring_space[i] =
+			sw->cq_ring_space[port_id] =
 					rte_event_ring_free_count(worker) -
 					port->cq_buf_count;
 		}
 	}
 
 	if (no_enq) {
-		if (unlikely(sw->sched_flush_count > SCHED_NO_ENQ_CYCLE_FLUSH))
-			sw->sched_min_burst = 1;
+		if (unlikely(sched->sched_flush_count >
+				SCHED_NO_ENQ_CYCLE_FLUSH))
+			sched->sched_min_burst = 1;
 		else
-			sw->sched_flush_count++;
+			sched->sched_flush_count++;
 	} else {
-		if (sw->sched_flush_count)
-			sw->sched_flush_count--;
+		if (sched->sched_flush_count)
+			sched->sched_flush_count--;
 		else
-			sw->sched_min_burst = sw->sched_min_burst_size;
+			sched->sched_min_burst = sw->sched_min_burst_size;
 	}
 
 	/* Provide stats on what eventdev ports were scheduled to this
 	 * iteration. If more than 64 ports are active, always report that
 	 * all Eventdev ports have been scheduled events.
 	 */
-	sw->sched_last_iter_bitmask = cqs_scheds_last_iter;
+	sched->sched_last_iter_bitmask = cqs_scheds_last_iter;
 	if (unlikely(sw->port_count >= 64))
-		sw->sched_last_iter_bitmask = UINT64_MAX;
+		sched->sched_last_iter_bitmask = UINT64_MAX;
+}
+
+void
+sw_event_schedule(struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	uint32_t i;
+
+	for (i = 0; i < sw->sched_count; i++)
+		sw_sched_schedule(&sw->scheds[i]);
 }
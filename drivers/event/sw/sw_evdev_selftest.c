@@ -2962,6 +2962,161 @@ dev_stop_flush(struct test *t) /* test to check we can properly flush events */
 	return -1;
 }
 
+static int
+parallel_schedulers(struct test *t)
+{
+	/* Two schedulers and two worker ports linked to both queues: the
+	 * ports and the queues are spread over the schedulers, so events are
+	 * handed off to the ports of the other scheduler and completed by the
+	 * scheduler of their queue. Events of the ordered q0 are forwarded to
+	 * the atomic q1, and must leave q1 in order for each flow.
+	 */
+	const char *eventdev_name = "event_sw_mt";
+	const unsigned int total = 256;
+	const unsigned int nb_flows = 4;
+	uint32_t next_seq[4] = {0};
+	uint32_t service[2];
+	unsigned int i, sent = 0, received = 0;
+	struct rte_event ev[32];
+	int saved_evdev = evdev;
+	char name[RTE_SERVICE_NAME_MAX];
+	const struct sw_evdev *sw;
+	int32_t service_id;
+	int p;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "sched_lcores=2") < 0) {
+			printf("%d: Error creating eventdev\n", __LINE__);
+			evdev = saved_evdev;
+			return -1;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+		if (evdev < 0) {
+			printf("%d: Error finding eventdev\n", __LINE__);
+			evdev = saved_evdev;
+			return -1;
+		}
+	}
+	sw = rte_eventdevs[evdev].data->dev_private;
+
+	if (rte_event_dev_service_id_get(evdev, &service[0]) < 0) {
+		printf("%d: Error getting service ID\n", __LINE__);
+		goto err;
+	}
+	snprintf(name, sizeof(name), "%s_service_1", eventdev_name);
+	service_id = rte_service_get_by_name(name, &service[1]);
+	if (service_id < 0) {
+		printf("%d: Error getting second scheduler service\n",
+				__LINE__);
+		goto err;
+	}
+	for (i = 0; i < RTE_DIM(service); i++) {
+		rte_service_runstate_set(service[i], 1);
+		rte_service_set_runstate_mapped_check(service[i], 0);
+	}
+
+	if (init(t, 2, 3) < 0 ||
+			create_ports(t, 3) < 0 ||
+			create_ordered_qids(t, 1) < 0 ||
+			create_atomic_qids(t, 1) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		goto err;
+	}
+	for (p = 1; p <= 2; p++) {
+		if (rte_event_port_link(evdev, t->port[p], NULL, NULL, 0)
+				!= 2) {
+			printf("%d: Error linking queues to ports\n",
+					__LINE__);
+			goto err;
+		}
+	}
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto err;
+	}
+
+	for (i = 0; i < 1000 && received < total; i++) {
+		uint16_t n, j;
+
+		for (; sent < total; sent++) {
+			struct rte_event new_ev = {
+				.op = RTE_EVENT_OP_NEW,
+				.queue_id = t->qid[0],
+				.sched_type = RTE_SCHED_TYPE_ORDERED,
+				.flow_id = sent % nb_flows,
+				.u64 = sent / nb_flows,
+			};
+
+			if (rte_event_enqueue_burst(evdev, t->port[0],
+					&new_ev, 1) != 1)
+				break;
+		}
+
+		rte_service_run_iter_on_app_lcore(service[0], 1);
+		rte_service_run_iter_on_app_lcore(service[1], 1);
+
+		/* the last port first, for q0 events to be reordered */
+		for (p = 2; p >= 1; p--) {
+			n = rte_event_dequeue_burst(evdev, t->port[p], ev,
+					RTE_DIM(ev), 0);
+			for (j = 0; j < n; j++) {
+				if (ev[j].queue_id == t->qid[0]) {
+					ev[j].op = RTE_EVENT_OP_FORWARD;
+					ev[j].queue_id = t->qid[1];
+					ev[j].sched_type =
+						RTE_SCHED_TYPE_ATOMIC;
+					continue;
+				}
+				if (ev[j].flow_id >= nb_flows ||
+						ev[j].u64 !=
+						next_seq[ev[j].flow_id]) {
+					printf("%d: Unexpected event q %u flow %u seq %"
+							PRIu64"\n", __LINE__,
+							ev[j].queue_id,
+							ev[j].flow_id,
+							ev[j].u64);
+					goto err;
+				}
+				next_seq[ev[j].flow_id]++;
+				ev[j].op = RTE_EVENT_OP_RELEASE;
+				received++;
+			}
+			if (rte_event_enqueue_burst(evdev, t->port[p], ev, n)
+					!= n) {
+				printf("%d: Error forwarding events\n",
+						__LINE__);
+				goto err;
+			}
+		}
+	}
+	if (received != total) {
+		printf("%d: Received %u events, expected %u\n", __LINE__,
+				received, total);
+		goto err;
+	}
+
+	/* both schedulers have scheduled events */
+	for (i = 0; i < RTE_DIM(service); i++) {
+		if (sw->scheds[i].qid_count == 0 ||
+				sw->scheds[i].port_count == 0 ||
+				sw->scheds[i].stats.tx_pkts == 0) {
+			printf("%d: Scheduler %u did not schedule events\n",
+					__LINE__, i);
+			goto err;
+		}
+	}
+
+	cleanup(t);
+	evdev = saved_evdev;
+	return 0;
+err:
+	rte_event_dev_dump(evdev, stdout);
+	cleanup(t);
+	evdev = saved_evdev;
+	return -1;
+}
+
 static int
 worker_loopback_worker_fn(void *arg)
 {
@@ -3391,6 +3546,12 @@ test_sw_eventdev(void)
 		printf("ERROR - Stop Flush test FAILED.\n");
 		goto test_fail;
 	}
+	printf("*** Running Parallel Schedulers test...\n");
+	ret = parallel_schedulers(t);
+	if (ret != 0) {
+		printf("ERROR - Parallel Schedulers test FAILED.\n");
+		goto test_fail;
+	}
 	if (rte_lcore_count() >= 3) {
 		printf("*** Running Worker loopback test...\n");
 		ret = worker_loopback(t, 0);
@@ -15,6 +15,8 @@
 #include <rte_bus_vdev.h>
 
 #include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
 #include <linux/if_ether.h>
 #include <linux/if_packet.h>
 #include <arpa/inet.h>
@@ -34,18 +36,54 @@
 #define ETH_AF_PACKET_FRAMESIZE_ARG	"framesz"
 #define ETH_AF_PACKET_FRAMECOUNT_ARG	"framecnt"
 #define ETH_AF_PACKET_QDISC_BYPASS_ARG	"qdisc_bypass"
+#define ETH_AF_PACKET_TPACKET_V3_ARG	"tpacket_v3"
+#define ETH_AF_PACKET_BLOCK_TMO_ARG	"blocktmo"
 
 #define DFLT_FRAME_SIZE		(1 << 11)
 #define DFLT_FRAME_COUNT	(1 << 9)
+#define DFLT_V3_BLOCK_SIZE	(1 << 16)
+
+struct pkt_block_ring;
+
+/* TPACKET_V3 block shared by the mbufs of its packets */
+struct pkt_block {
+	struct rte_mbuf_ext_shared_info shinfo;
+	struct tpacket_block_desc *pbd;
+	struct pkt_block_ring *ring;
+	uint32_t held;			/* not yet returned to the kernel */
+};
+
+/*
+ * TPACKET_V3 Rx ring, which outlives the port
+ * as long as mbufs are attached to its blocks.
+ */
+struct pkt_block_ring {
+	uint8_t *map;
+	size_t map_size;
+	uint32_t refcnt;		/* held blocks, plus one for the port */
+	struct pkt_block blocks[];
+};
 
 struct pkt_rx_queue {
 	int sockfd;
 
 	struct iovec *rd;
 	uint8_t *map;
+	size_t map_size;
 	unsigned int framecount;
 	unsigned int framenum;
 
+	/*
+	 * With TPACKET_V3, rd points to the blocks of the ring.
+	 * The packets of a block are attached to mbufs as external buffers,
+	 * the block is returned to the kernel when all of them are freed.
+	 */
+	unsigned int blockcount;
+	unsigned int blocknum;
+	unsigned int block_pkts;	/* packets left in current block */
+	struct tpacket3_hdr *next_ppd;	/* next packet in current block */
+	struct pkt_block_ring *ring;
+
 	struct rte_mempool *mb_pool;
 	uint16_t in_port;
 	uint8_t vlan_strip;
@@ -60,6 +98,7 @@ struct pkt_tx_queue {
 
 	struct iovec *rd;
 	uint8_t *map;
+	size_t map_size;	/* non zero if not part of the Rx mapping */
 	unsigned int framecount;
 	unsigned int framenum;
 
@@ -75,7 +114,8 @@ struct pmd_internals {
 	char *if_name;
 	struct rte_ether_addr eth_addr;
 
-	struct tpacket_req req;
+	unsigned int framesize;
+	unsigned int tpacket_v3;
 
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
@@ -89,6 +129,8 @@ static const char *valid_arguments[] = {
 	ETH_AF_PACKET_FRAMESIZE_ARG,
 	ETH_AF_PACKET_FRAMECOUNT_ARG,
 	ETH_AF_PACKET_QDISC_BYPASS_ARG,
+	ETH_AF_PACKET_TPACKET_V3_ARG,
+	ETH_AF_PACKET_BLOCK_TMO_ARG,
 	NULL
 };
 
@@ -172,6 +214,179 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Drop a reference on a TPACKET_V3 ring, unmapping it with the last one
+ */
+static void
+eth_af_packet_ring_put(struct pkt_block_ring *ring)
+{
+	if (__atomic_sub_fetch(&ring->refcnt, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+
+	munmap(ring->map, ring->map_size);
+	rte_free(ring);
+}
+
+/*
+ * Called when the last mbuf of a TPACKET_V3 block is freed
+ */
+static void
+eth_af_packet_block_release(void *addr __rte_unused, void *opaque)
+{
+	struct pkt_block *block = opaque;
+	struct pkt_block_ring *ring = block->ring;
+
+	__atomic_store_n(&block->pbd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+			 __ATOMIC_RELEASE);
+	/* the status seen once the block is no longer held is the kernel's */
+	__atomic_store_n(&block->held, 0, __ATOMIC_RELEASE);
+	eth_af_packet_ring_put(ring);
+}
+
+/*
+ * Insert the VLAN tag stripped by the kernel in the headroom of a packet
+ * attached to a block, which is no longer used by the kernel.
+ * rte_vlan_insert() does not write into external buffers.
+ */
+static int
+eth_af_packet_vlan_reinsert(struct rte_mbuf *mbuf)
+{
+	struct rte_ether_hdr *oh, *nh;
+	struct rte_vlan_hdr *vh;
+
+	if (rte_pktmbuf_data_len(mbuf) < 2 * RTE_ETHER_ADDR_LEN)
+		return -EINVAL;
+
+	oh = rte_pktmbuf_mtod(mbuf, struct rte_ether_hdr *);
+	nh = (struct rte_ether_hdr *)(void *)
+		rte_pktmbuf_prepend(mbuf, sizeof(struct rte_vlan_hdr));
+	if (nh == NULL)
+		return -ENOSPC;
+
+	memmove(nh, oh, 2 * RTE_ETHER_ADDR_LEN);
+	nh->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_VLAN);
+
+	vh = (struct rte_vlan_hdr *)(nh + 1);
+	vh->vlan_tci = rte_cpu_to_be_16(mbuf->vlan_tci);
+
+	mbuf->ol_flags &= ~RTE_MBUF_F_RX_VLAN_STRIPPED;
+	return 0;
+}
+
+static uint16_t
+eth_af_packet_rx_v3(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pkt_rx_queue *pkt_q = queue;
+	struct pkt_block *block;
+	struct tpacket_block_desc *pbd;
+	struct tpacket3_hdr *ppd;
+	struct rte_mbuf *mbuf;
+	uint16_t num_rx = 0;
+	unsigned long num_rx_bytes = 0;
+	unsigned int nb_bufs;
+	rte_iova_t iova;
+
+	/*
+	 * Hands out the packets of the blocks retired by the kernel,
+	 * without copying them. The queue holds a reference on the block
+	 * until all its packets are received.
+	 */
+	while (num_rx < nb_pkts) {
+		block = &pkt_q->ring->blocks[pkt_q->blocknum];
+		pbd = block->pbd;
+
+		if (pkt_q->next_ppd == NULL) {
+			/* mbufs of the previous round still use the block */
+			if (__atomic_load_n(&block->held, __ATOMIC_ACQUIRE))
+				break;
+			if ((__atomic_load_n(&pbd->hdr.bh1.block_status,
+					     __ATOMIC_ACQUIRE) &
+			     TP_STATUS_USER) == 0)
+				break;
+
+			block->held = 1;
+			__atomic_add_fetch(&pkt_q->ring->refcnt, 1,
+					   __ATOMIC_RELAXED);
+			rte_mbuf_ext_refcnt_set(&block->shinfo, 1);
+			pkt_q->block_pkts = pbd->hdr.bh1.num_pkts;
+			pkt_q->next_ppd = (struct tpacket3_hdr *)
+				((uint8_t *)pbd +
+				 pbd->hdr.bh1.offset_to_first_pkt);
+		}
+
+		/* only allocate the mbufs the block can fill */
+		nb_bufs = RTE_MIN(pkt_q->block_pkts,
+				  (unsigned int)(nb_pkts - num_rx));
+		if (unlikely(rte_pktmbuf_alloc_bulk(pkt_q->mb_pool,
+						    &bufs[num_rx], nb_bufs)))
+			break;
+		nb_bufs += num_rx;
+
+		while (pkt_q->block_pkts > 0 && num_rx < nb_bufs) {
+			ppd = pkt_q->next_ppd;
+			pkt_q->next_ppd = (struct tpacket3_hdr *)
+				((uint8_t *)ppd + ppd->tp_next_offset);
+			pkt_q->block_pkts--;
+
+			/* the frame header becomes the headroom */
+			if (unlikely(ppd->tp_mac + ppd->tp_snaplen >
+				     UINT16_MAX))
+				continue;
+
+			if (rte_eal_iova_mode() == RTE_IOVA_VA)
+				iova = (uintptr_t)ppd;
+			else
+				iova = RTE_BAD_IOVA;
+
+			mbuf = bufs[num_rx];
+			rte_mbuf_ext_refcnt_update(&block->shinfo, 1);
+			rte_pktmbuf_attach_extbuf(mbuf, ppd, iova,
+						  ppd->tp_mac + ppd->tp_snaplen,
+						  &block->shinfo);
+			mbuf->data_off = ppd->tp_mac;
+			rte_pktmbuf_pkt_len(mbuf) = rte_pktmbuf_data_len(mbuf) =
+				ppd->tp_snaplen;
+
+			mbuf->hash.rss = ppd->hv1.tp_rxhash;
+			mbuf->ol_flags |= RTE_MBUF_F_RX_RSS_HASH;
+
+			/* check for vlan info */
+			if (ppd->tp_status & TP_STATUS_VLAN_VALID) {
+				mbuf->vlan_tci = ppd->hv1.tp_vlan_tci;
+				mbuf->ol_flags |= (RTE_MBUF_F_RX_VLAN |
+						   RTE_MBUF_F_RX_VLAN_STRIPPED);
+
+				if (!pkt_q->vlan_strip &&
+				    eth_af_packet_vlan_reinsert(mbuf))
+					PMD_LOG(ERR,
+						"Failed to reinsert VLAN tag");
+			}
+			mbuf->port = pkt_q->in_port;
+
+			bufs[num_rx++] = mbuf;
+			num_rx_bytes += mbuf->pkt_len;
+		}
+
+		/* mbufs left by skipped packets */
+		if (num_rx < nb_bufs)
+			rte_pktmbuf_free_bulk(&bufs[num_rx], nb_bufs - num_rx);
+
+		if (pkt_q->block_pkts != 0)
+			break;
+
+		/* all packets of the block received, drop queue reference */
+		if (rte_mbuf_ext_refcnt_update(&block->shinfo, -1) == 0)
+			eth_af_packet_block_release(NULL, block);
+		pkt_q->next_ppd = NULL;
+		if (++pkt_q->blocknum >= pkt_q->blockcount)
+			pkt_q->blocknum = 0;
+	}
+
+	pkt_q->rx_pkts += num_rx;
+	pkt_q->rx_bytes += num_rx_bytes;
+	return num_rx;
+}
+
 /*
  * Check if there is an available frame in the ring
  */
@@ -371,6 +586,8 @@ eth_dev_info(struct rte_eth_dev *dev, struct rte_eth_dev_info *dev_info)
 	dev_info->tx_offload_capa = RTE_ETH_TX_OFFLOAD_MULTI_SEGS |
 		RTE_ETH_TX_OFFLOAD_VLAN_INSERT;
 	dev_info->rx_offload_capa = RTE_ETH_RX_OFFLOAD_VLAN_STRIP;
+	if (internals->tpacket_v3)
+		dev_info->rx_offload_capa |= RTE_ETH_RX_OFFLOAD_RSS_HASH;
 
 	return 0;
 }
@@ -434,7 +651,8 @@ static int
 eth_dev_close(struct rte_eth_dev *dev)
 {
 	struct pmd_internals *internals;
-	struct tpacket_req *req;
+	struct pkt_rx_queue *rx_queue;
+	struct pkt_block *block;
 	unsigned int q;
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
@@ -444,11 +662,25 @@ eth_dev_close(struct rte_eth_dev *dev)
 		rte_socket_id());
 
 	internals = dev->data->dev_private;
-	req = &internals->req;
 	for (q = 0; q < internals->nb_queues; q++) {
-		munmap(internals->rx_queue[q].map,
-			2 * req->tp_block_size * req->tp_block_nr);
-		rte_free(internals->rx_queue[q].rd);
+		rx_queue = &internals->rx_queue[q];
+		if (rx_queue->ring != NULL) {
+			/*
+			 * The TPACKET_V3 ring stays mapped
+			 * until the received mbufs are freed.
+			 */
+			block = &rx_queue->ring->blocks[rx_queue->blocknum];
+			if (rx_queue->next_ppd != NULL &&
+			    rte_mbuf_ext_refcnt_update(&block->shinfo, -1) == 0)
+				eth_af_packet_block_release(NULL, block);
+			eth_af_packet_ring_put(rx_queue->ring);
+		} else {
+			munmap(rx_queue->map, rx_queue->map_size);
+		}
+		if (internals->tx_queue[q].map_size != 0)
+			munmap(internals->tx_queue[q].map,
+			       internals->tx_queue[q].map_size);
+		rte_free(rx_queue->rd);
 		rte_free(internals->tx_queue[q].rd);
 	}
 	free(internals->if_name);
@@ -481,10 +713,14 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 
 	pkt_q->mb_pool = mb_pool;
 
+	/* Packets are not copied to the mbufs with TPACKET_V3 */
+	if (internals->tpacket_v3)
+		goto done;
+
 	/* Now get the space available for data in the mbuf */
 	buf_size = rte_pktmbuf_data_room_size(pkt_q->mb_pool) -
 		RTE_PKTMBUF_HEADROOM;
-	data_size = internals->req.tp_frame_size;
+	data_size = internals->framesize;
 	data_size -= TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
 
 	if (data_size > buf_size) {
@@ -494,6 +730,7 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 		return -ENOMEM;
 	}
 
+done:
 	dev->data->rx_queues[rx_queue_id] = pkt_q;
 	pkt_q->in_port = dev->data->port_id;
 	pkt_q->vlan_strip = internals->vlan_strip;
@@ -522,8 +759,7 @@ eth_dev_mtu_set(struct rte_eth_dev *dev, uint16_t mtu)
 	struct ifreq ifr = { .ifr_mtu = mtu };
 	int ret;
 	int s;
-	unsigned int data_size = internals->req.tp_frame_size -
-				 TPACKET2_HDRLEN;
+	unsigned int data_size = internals->framesize - TPACKET2_HDRLEN;
 
 	if (mtu > data_size)
 		return -EINVAL;
@@ -648,15 +884,91 @@ open_packet_iface(const char *key __rte_unused,
 	return 0;
 }
 
+/*
+ * Opens an AF_PACKET socket with a TPACKET_V2 Tx ring,
+ * which does not receive any packet.
+ */
+static int
+open_packet_tx_socket(const char *name, const char *if_name,
+		      struct tpacket_req *req, unsigned int qdisc_bypass,
+		      int if_index)
+{
+	struct sockaddr_ll sockaddr = {
+		.sll_family = AF_PACKET,
+		.sll_protocol = 0,
+		.sll_ifindex = if_index,
+	};
+	int sockfd, rc, tpver, discard;
+
+	sockfd = socket(AF_PACKET, SOCK_RAW, 0);
+	if (sockfd == -1) {
+		PMD_LOG_ERRNO(ERR, "%s: could not open AF_PACKET socket",
+			      name);
+		return -1;
+	}
+
+	tpver = TPACKET_V2;
+	rc = setsockopt(sockfd, SOL_PACKET, PACKET_VERSION,
+			&tpver, sizeof(tpver));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_VERSION on AF_PACKET socket for %s",
+			name, if_name);
+		goto error;
+	}
+
+	discard = 1;
+	rc = setsockopt(sockfd, SOL_PACKET, PACKET_LOSS,
+			&discard, sizeof(discard));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_LOSS on AF_PACKET socket for %s",
+			name, if_name);
+		goto error;
+	}
+
+	if (qdisc_bypass) {
+#if defined(PACKET_QDISC_BYPASS)
+		rc = setsockopt(sockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
+				&qdisc_bypass, sizeof(qdisc_bypass));
+		if (rc == -1) {
+			PMD_LOG_ERRNO(ERR,
+				"%s: could not set PACKET_QDISC_BYPASS on AF_PACKET socket for %s",
+				name, if_name);
+			goto error;
+		}
+#endif
+	}
+
+	rc = setsockopt(sockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_TX_RING on AF_PACKET "
+			"socket for %s", name, if_name);
+		goto error;
+	}
+
+	rc = bind(sockfd, (const struct sockaddr *)&sockaddr, sizeof(sockaddr));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR, "%s: could not bind AF_PACKET socket to %s",
+			      name, if_name);
+		goto error;
+	}
+
+	return sockfd;
+
+error:
+	close(sockfd);
+	return -1;
+}
+
 static int
 rte_pmd_init_internals(struct rte_vdev_device *dev,
                        const int sockfd,
                        const unsigned nb_queues,
-                       unsigned int blocksize,
-                       unsigned int blockcnt,
-                       unsigned int framesize,
-                       unsigned int framecnt,
+		       const struct tpacket_req3 *reqs,
 		       unsigned int qdisc_bypass,
+		       unsigned int tpacket_v3,
                        struct pmd_internals **internals,
                        struct rte_eth_dev **eth_dev,
                        struct rte_kvargs *kvlist)
@@ -669,9 +981,11 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	size_t ifnamelen;
 	unsigned k_idx;
 	struct sockaddr_ll sockaddr;
-	struct tpacket_req *req;
+	struct tpacket_req queue_req;
+	struct tpacket_req *req = &queue_req;
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
+	struct pkt_block *block;
 	int rc, tpver, discard;
 	int qsockfd = -1;
 	unsigned int i, q, rdsize;
@@ -720,13 +1034,6 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		(*internals)->tx_queue[q].sockfd = -1;
 	}
 
-	req = &((*internals)->req);
-
-	req->tp_block_size = blocksize;
-	req->tp_block_nr = blockcnt;
-	req->tp_frame_size = framesize;
-	req->tp_frame_nr = framecnt;
-
 	ifnamelen = strlen(pair->value);
 	if (ifnamelen < sizeof(ifr.ifr_name)) {
 		memcpy(ifr.ifr_name, pair->value, ifnamelen);
@@ -766,6 +1073,12 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 #endif
 
 	for (q = 0; q < nb_queues; q++) {
+		/* The rings of each queue pair have their own geometry */
+		req->tp_block_size = reqs[q].tp_block_size;
+		req->tp_block_nr = reqs[q].tp_block_nr;
+		req->tp_frame_size = reqs[q].tp_frame_size;
+		req->tp_frame_nr = reqs[q].tp_frame_nr;
+
 		/* Open an AF_PACKET socket for this queue... */
 		qsockfd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
 		if (qsockfd == -1) {
@@ -775,7 +1088,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		tpver = TPACKET_V2;
+		tpver = tpacket_v3 ? TPACKET_V3 : TPACKET_V2;
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
 				&tpver, sizeof(tpver));
 		if (rc == -1) {
@@ -785,86 +1098,174 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		discard = 1;
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_LOSS,
-				&discard, sizeof(discard));
-		if (rc == -1) {
-			PMD_LOG_ERRNO(ERR,
-				"%s: could not set PACKET_LOSS on AF_PACKET socket for %s",
-				name, pair->value);
-			goto error;
-		}
+		rx_queue = &((*internals)->rx_queue[q]);
+		tx_queue = &((*internals)->tx_queue[q]);
 
-		if (qdisc_bypass) {
-#if defined(PACKET_QDISC_BYPASS)
-			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
-					&qdisc_bypass, sizeof(qdisc_bypass));
+		if (tpacket_v3) {
+			/*
+			 * The Rx ring is made of blocks, retired by the kernel
+			 * when full or after the timeout.
+			 * The Tx ring keeps TPACKET_V2 frames on its own socket.
+			 */
+			struct tpacket_req3 req3 = reqs[q];
+
+			req3.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					&req3, sizeof(req3));
 			if (rc == -1) {
 				PMD_LOG_ERRNO(ERR,
-					"%s: could not set PACKET_QDISC_BYPASS on AF_PACKET socket for %s",
+					"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
 					name, pair->value);
 				goto error;
 			}
+
+			rx_queue->map_size = (size_t)req->tp_block_size *
+				req->tp_block_nr;
+			rx_queue->map = mmap(NULL, rx_queue->map_size,
+					    PROT_READ | PROT_WRITE,
+					    MAP_SHARED | MAP_LOCKED,
+					    qsockfd, 0);
+			if (rx_queue->map == MAP_FAILED) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: call to mmap failed on AF_PACKET socket for %s",
+					name, pair->value);
+				goto error;
+			}
+
+			rx_queue->blockcount = req->tp_block_nr;
+			rx_queue->rd = rte_zmalloc_socket(name,
+				req->tp_block_nr * sizeof(*(rx_queue->rd)),
+				0, numa_node);
+			rx_queue->ring = rte_zmalloc_socket(name,
+				sizeof(*rx_queue->ring) + req->tp_block_nr *
+				sizeof(rx_queue->ring->blocks[0]),
+				0, numa_node);
+			if (rx_queue->rd == NULL || rx_queue->ring == NULL)
+				goto error;
+			rx_queue->ring->map = rx_queue->map;
+			rx_queue->ring->map_size = rx_queue->map_size;
+			rx_queue->ring->refcnt = 1;
+			for (i = 0; i < req->tp_block_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					i * req->tp_block_size;
+				rx_queue->rd[i].iov_len = req->tp_block_size;
+				block = &rx_queue->ring->blocks[i];
+				block->pbd = rx_queue->rd[i].iov_base;
+				block->ring = rx_queue->ring;
+				block->shinfo.free_cb =
+					eth_af_packet_block_release;
+				block->shinfo.fcb_opaque = block;
+			}
+
+			tx_queue->sockfd = open_packet_tx_socket(name,
+					pair->value, req, qdisc_bypass,
+					(*internals)->if_index);
+			if (tx_queue->sockfd == -1)
+				goto error;
+
+			tx_queue->map_size = (size_t)req->tp_block_size *
+				req->tp_block_nr;
+			tx_queue->map = mmap(NULL, tx_queue->map_size,
+					    PROT_READ | PROT_WRITE,
+					    MAP_SHARED | MAP_LOCKED,
+					    tx_queue->sockfd, 0);
+			if (tx_queue->map == MAP_FAILED) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: call to mmap failed on AF_PACKET socket for %s",
+					name, pair->value);
+				tx_queue->map_size = 0;
+				goto error;
+			}
+		} else {
+			discard = 1;
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_LOSS,
+					&discard, sizeof(discard));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not set PACKET_LOSS on AF_PACKET socket for %s",
+					name, pair->value);
+				goto error;
+			}
+
+			if (qdisc_bypass) {
+#if defined(PACKET_QDISC_BYPASS)
+				rc = setsockopt(qsockfd, SOL_PACKET,
+						PACKET_QDISC_BYPASS,
+						&qdisc_bypass,
+						sizeof(qdisc_bypass));
+				if (rc == -1) {
+					PMD_LOG_ERRNO(ERR,
+						"%s: could not set PACKET_QDISC_BYPASS on AF_PACKET socket for %s",
+						name, pair->value);
+					goto error;
+				}
 #endif
-		}
+			}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, sizeof(*req));
-		if (rc == -1) {
-			PMD_LOG_ERRNO(ERR,
-				"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
-				name, pair->value);
-			goto error;
-		}
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					req, sizeof(*req));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
+					name, pair->value);
+				goto error;
+			}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
-		if (rc == -1) {
-			PMD_LOG_ERRNO(ERR,
-				"%s: could not set PACKET_TX_RING on AF_PACKET "
-				"socket for %s", name, pair->value);
-			goto error;
-		}
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING,
+					req, sizeof(*req));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not set PACKET_TX_RING on AF_PACKET "
+					"socket for %s", name, pair->value);
+				goto error;
+			}
 
-		rx_queue = &((*internals)->rx_queue[q]);
-		rx_queue->framecount = req->tp_frame_nr;
+			rx_queue->framecount = req->tp_frame_nr;
 
-		rx_queue->map = mmap(NULL, 2 * req->tp_block_size * req->tp_block_nr,
-				    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
-				    qsockfd, 0);
-		if (rx_queue->map == MAP_FAILED) {
-			PMD_LOG_ERRNO(ERR,
-				"%s: call to mmap failed on AF_PACKET socket for %s",
-				name, pair->value);
-			goto error;
-		}
+			rx_queue->map_size = 2 * (size_t)req->tp_block_size *
+				req->tp_block_nr;
+			rx_queue->map = mmap(NULL, rx_queue->map_size,
+					    PROT_READ | PROT_WRITE,
+					    MAP_SHARED | MAP_LOCKED,
+					    qsockfd, 0);
+			if (rx_queue->map == MAP_FAILED) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: call to mmap failed on AF_PACKET socket for %s",
+					name, pair->value);
+				goto error;
+			}
 
-		/* rdsize is same for both Tx and Rx */
-		rdsize = req->tp_frame_nr * sizeof(*(rx_queue->rd));
+			rx_queue->rd = rte_zmalloc_socket(name,
+				req->tp_frame_nr * sizeof(*(rx_queue->rd)),
+				0, numa_node);
+			if (rx_queue->rd == NULL)
+				goto error;
+			for (i = 0; i < req->tp_frame_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * req->tp_frame_size);
+				rx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
 
-		rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
-		if (rx_queue->rd == NULL)
-			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
-			rx_queue->rd[i].iov_len = req->tp_frame_size;
+			tx_queue->sockfd = qsockfd;
+			tx_queue->map = rx_queue->map +
+				req->tp_block_size * req->tp_block_nr;
 		}
 		rx_queue->sockfd = qsockfd;
 
-		tx_queue = &((*internals)->tx_queue[q]);
 		tx_queue->framecount = req->tp_frame_nr;
 		tx_queue->frame_data_size = req->tp_frame_size;
 		tx_queue->frame_data_size -= TPACKET2_HDRLEN -
 			sizeof(struct sockaddr_ll);
 
-		tx_queue->map = rx_queue->map + req->tp_block_size * req->tp_block_nr;
-
+		rdsize = req->tp_frame_nr * sizeof(*(tx_queue->rd));
 		tx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (tx_queue->rd == NULL)
 			goto error;
 		for (i = 0; i < req->tp_frame_nr; ++i) {
-			tx_queue->rd[i].iov_base = tx_queue->map + (i * framesize);
+			tx_queue->rd[i].iov_base = tx_queue->map +
+				(i * req->tp_frame_size);
 			tx_queue->rd[i].iov_len = req->tp_frame_size;
 		}
-		tx_queue->sockfd = qsockfd;
 
 		rc = bind(qsockfd, (const struct sockaddr*)&sockaddr, sizeof(sockaddr));
 		if (rc == -1) {
@@ -900,6 +1301,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	 */
 
 	(*internals)->nb_queues = nb_queues;
+	(*internals)->framesize = reqs[0].tp_frame_size;
+	(*internals)->tpacket_v3 = tpacket_v3;
 
 	data = (*eth_dev)->data;
 	data->dev_private = *internals;
@@ -919,13 +1322,20 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	for (q = 0; q < nb_queues; q++) {
 		if ((*internals)->rx_queue[q].map != MAP_FAILED)
 			munmap((*internals)->rx_queue[q].map,
-			       2 * req->tp_block_size * req->tp_block_nr);
+			       (*internals)->rx_queue[q].map_size);
+		if ((*internals)->tx_queue[q].map_size != 0)
+			munmap((*internals)->tx_queue[q].map,
+			       (*internals)->tx_queue[q].map_size);
 
 		rte_free((*internals)->rx_queue[q].rd);
+		rte_free((*internals)->rx_queue[q].ring);
 		rte_free((*internals)->tx_queue[q].rd);
 		if (((*internals)->rx_queue[q].sockfd >= 0) &&
 			((*internals)->rx_queue[q].sockfd != qsockfd))
 			close((*internals)->rx_queue[q].sockfd);
+		/* Tx has its own socket with TPACKET_V3 */
+		if (tpacket_v3 && (*internals)->tx_queue[q].sockfd >= 0)
+			close((*internals)->tx_queue[q].sockfd);
 	}
 free_internals:
 	rte_free((*internals)->rx_queue);
@@ -935,6 +1345,48 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	return -1;
 }
 
+/*
+ * Parses the value of a per queue pair argument: either a single value
+ * for all the queue pairs, or a list of one value per queue pair,
+ * e.g. "[65536,131072]".
+ */
+static int
+parse_queue_values(const char *name, const char *arg, const char *value,
+		   unsigned int nb_queues, unsigned int *values)
+{
+	unsigned long v;
+	const char *p;
+	char *end;
+	unsigned int q;
+
+	if (value[0] != '[') {
+		v = strtoul(value, &end, 10);
+		if (end == value || *end != '\0' || v > UINT_MAX)
+			goto invalid;
+		for (q = 0; q < nb_queues; q++)
+			values[q] = v;
+		return 0;
+	}
+
+	p = value + 1;
+	for (q = 0; q < nb_queues; q++) {
+		v = strtoul(p, &end, 10);
+		if (end == p || v > UINT_MAX)
+			goto invalid;
+		values[q] = v;
+		if (*end != (q + 1 < nb_queues ? ',' : ']'))
+			goto invalid;
+		p = end + 1;
+	}
+	if (*p == '\0')
+		return 0;
+
+invalid:
+	PMD_LOG(ERR, "%s: invalid %s value, expected a value or a list of %u",
+		name, arg, nb_queues);
+	return -1;
+}
+
 static int
 rte_eth_from_packet(struct rte_vdev_device *dev,
                     int const *sockfd,
@@ -944,13 +1396,20 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	struct pmd_internals *internals = NULL;
 	struct rte_eth_dev *eth_dev = NULL;
 	struct rte_kvargs_pair *pair = NULL;
+	struct tpacket_req3 *reqs = NULL;
+	unsigned int *values = NULL;
+	const char *blocksize_arg = NULL;
+	const char *framecount_arg = NULL;
+	const char *blocktmo_arg = NULL;
 	unsigned k_idx;
-	unsigned int blockcount;
 	unsigned int blocksize;
 	unsigned int framesize = DFLT_FRAME_SIZE;
 	unsigned int framecount = DFLT_FRAME_COUNT;
 	unsigned int qpairs = 1;
 	unsigned int qdisc_bypass = 1;
+	unsigned int tpacket_v3 = 0;
+	unsigned int q;
+	int ret = -1;
 
 	/* do some parameter checking */
 	if (*sockfd < 0)
@@ -973,14 +1432,9 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		/* The ring geometry is parsed once the queue count is known */
 		if (strstr(pair->key, ETH_AF_PACKET_BLOCKSIZE_ARG) != NULL) {
-			blocksize = atoi(pair->value);
-			if (!blocksize) {
-				PMD_LOG(ERR,
-					"%s: invalid blocksize value",
-				        name);
-				return -1;
-			}
+			blocksize_arg = pair->value;
 			continue;
 		}
 		if (strstr(pair->key, ETH_AF_PACKET_FRAMESIZE_ARG) != NULL) {
@@ -994,13 +1448,7 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			continue;
 		}
 		if (strstr(pair->key, ETH_AF_PACKET_FRAMECOUNT_ARG) != NULL) {
-			framecount = atoi(pair->value);
-			if (!framecount) {
-				PMD_LOG(ERR,
-					"%s: invalid framecount value",
-				        name);
-				return -1;
-			}
+			framecount_arg = pair->value;
 			continue;
 		}
 		if (strstr(pair->key, ETH_AF_PACKET_QDISC_BYPASS_ARG) != NULL) {
@@ -1013,41 +1461,116 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		if (strstr(pair->key, ETH_AF_PACKET_TPACKET_V3_ARG) != NULL) {
+			tpacket_v3 = atoi(pair->value);
+			if (tpacket_v3 > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid tpacket_v3 value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_BLOCK_TMO_ARG) != NULL) {
+			blocktmo_arg = pair->value;
+			continue;
+		}
 	}
 
-	if (framesize > blocksize) {
-		PMD_LOG(ERR,
-			"%s: AF_PACKET MMAP frame size exceeds block size!",
-		        name);
-		return -1;
+	/* Blocks of TPACKET_V3 hold many packets */
+	if (tpacket_v3)
+		blocksize = DFLT_V3_BLOCK_SIZE;
+
+	reqs = calloc(qpairs, sizeof(*reqs));
+	values = calloc(qpairs, sizeof(*values));
+	if (reqs == NULL || values == NULL)
+		goto exit;
+
+	for (q = 0; q < qpairs; q++) {
+		reqs[q].tp_block_size = blocksize;
+		reqs[q].tp_frame_size = framesize;
+		reqs[q].tp_frame_nr = framecount;
 	}
 
-	blockcount = framecount / (blocksize / framesize);
-	if (!blockcount) {
-		PMD_LOG(ERR,
-			"%s: invalid AF_PACKET MMAP parameters", name);
-		return -1;
+	if (blocksize_arg != NULL) {
+		if (parse_queue_values(name, ETH_AF_PACKET_BLOCKSIZE_ARG,
+				       blocksize_arg, qpairs, values) < 0)
+			goto exit;
+		for (q = 0; q < qpairs; q++)
+			reqs[q].tp_block_size = values[q];
+	}
+	if (framecount_arg != NULL) {
+		if (parse_queue_values(name, ETH_AF_PACKET_FRAMECOUNT_ARG,
+				       framecount_arg, qpairs, values) < 0)
+			goto exit;
+		for (q = 0; q < qpairs; q++)
+			reqs[q].tp_frame_nr = values[q];
+	}
+	if (blocktmo_arg != NULL) {
+		if (parse_queue_values(name, ETH_AF_PACKET_BLOCK_TMO_ARG,
+				       blocktmo_arg, qpairs, values) < 0)
+			goto exit;
+		for (q = 0; q < qpairs; q++)
+			reqs[q].tp_retire_blk_tov = values[q];
 	}
 
 	PMD_LOG(INFO, "%s: AF_PACKET MMAP parameters:", name);
-	PMD_LOG(INFO, "%s:\tblock size %d", name, blocksize);
-	PMD_LOG(INFO, "%s:\tblock count %d", name, blockcount);
 	PMD_LOG(INFO, "%s:\tframe size %d", name, framesize);
-	PMD_LOG(INFO, "%s:\tframe count %d", name, framecount);
 
-	if (rte_pmd_init_internals(dev, *sockfd, qpairs,
-				   blocksize, blockcount,
-				   framesize, framecount,
-				   qdisc_bypass,
+	for (q = 0; q < qpairs; q++) {
+		if (!reqs[q].tp_block_size || !reqs[q].tp_frame_nr) {
+			PMD_LOG(ERR,
+				"%s: invalid AF_PACKET MMAP parameters for queue %u",
+				name, q);
+			goto exit;
+		}
+
+		if (framesize > reqs[q].tp_block_size) {
+			PMD_LOG(ERR,
+				"%s: AF_PACKET MMAP frame size exceeds block size of queue %u!",
+				name, q);
+			goto exit;
+		}
+
+		reqs[q].tp_block_nr = reqs[q].tp_frame_nr /
+			(reqs[q].tp_block_size / framesize);
+		if (!reqs[q].tp_block_nr) {
+			PMD_LOG(ERR,
+				"%s: invalid AF_PACKET MMAP parameters for queue %u",
+				name, q);
+			goto exit;
+		}
+
+		PMD_LOG(INFO, "%s:\tqueue %u block size %u",
+			name, q, reqs[q].tp_block_size);
+		PMD_LOG(INFO, "%s:\tqueue %u block count %u",
+			name, q, reqs[q].tp_block_nr);
+		PMD_LOG(INFO, "%s:\tqueue %u frame count %u",
+			name, q, reqs[q].tp_frame_nr);
+		if (tpacket_v3)
+			PMD_LOG(INFO,
+				"%s:\tqueue %u TPACKET_V3 block timeout %u ms",
+				name, q, reqs[q].tp_retire_blk_tov);
+	}
+
+	if (rte_pmd_init_internals(dev, *sockfd, qpairs, reqs,
+				   qdisc_bypass, tpacket_v3,
 				   &internals, &eth_dev,
 				   kvlist) < 0)
-		return -1;
+		goto exit;
 
-	eth_dev->rx_pkt_burst = eth_af_packet_rx;
+	if (tpacket_v3)
+		eth_dev->rx_pkt_burst = eth_af_packet_rx_v3;
+	else
+		eth_dev->rx_pkt_burst = eth_af_packet_rx;
 	eth_dev->tx_pkt_burst = eth_af_packet_tx;
 
 	rte_eth_dev_probing_finish(eth_dev);
-	return 0;
+	ret = 0;
+exit:
+	free(values);
+	free(reqs);
+	return ret;
 }
 
 static int
@@ -1135,4 +1658,6 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_packet,
 	"blocksz=<int> "
 	"framesz=<int> "
 	"framecnt=<int> "
-	"qdisc_bypass=<0|1>");
+	"qdisc_bypass=<0|1> "
+	"tpacket_v3=<0|1> "
+	"blocktmo=<int>");
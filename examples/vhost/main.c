@@ -225,6 +225,7 @@ open_dma(const char *value)
 	char *ptrs[2];
 	char *start, *end, *substr;
 	int64_t vid;
+	int qid;
 
 	struct rte_dma_info info;
 	struct rte_dma_conf dev_config = { .nb_vchans = 1 };
@@ -270,10 +271,17 @@ open_dma(const char *value)
 			goto out;
 		}
 
+		/* txd is the guest Rx ring (enqueue), rxd the guest Tx ring (dequeue) */
 		start = strstr(ptrs[0], "txd");
-		if (start == NULL) {
-			ret = -1;
-			goto out;
+		if (start != NULL) {
+			qid = VIRTIO_RXQ;
+		} else {
+			start = strstr(ptrs[0], "rxd");
+			if (start == NULL) {
+				ret = -1;
+				goto out;
+			}
+			qid = VIRTIO_TXQ;
 		}
 
 		start += 3;
@@ -338,7 +346,7 @@ open_dma(const char *value)
 		dmas_id[dma_count++] = dev_id;
 
 done:
-		(dma_info + vid)->dmas[VIRTIO_RXQ].dev_id = dev_id;
+		(dma_info + vid)->dmas[qid].dev_id = dev_id;
 		i++;
 	}
 out:
@@ -1400,6 +1408,16 @@ drain_virtio_tx(struct vhost_dev *vdev)
 	if (builtin_net_driver) {
 		count = vs_dequeue_pkts(vdev, VIRTIO_TXQ, mbuf_pool,
 					pkts, MAX_PKT_BURST);
+	} else if (dma_bind[vdev->vid].dmas[VIRTIO_TXQ].async_enabled) {
+		int16_t dma_id = dma_bind[vdev->vid].dmas[VIRTIO_TXQ].dev_id;
+		int nr_inflight;
+
+		count = rte_vhost_async_try_dequeue_burst(vdev->vid, VIRTIO_TXQ,
+					mbuf_pool, pkts, MAX_PKT_BURST,
+					&nr_inflight, dma_id, 0);
+		if (likely(nr_inflight != -1))
+			__atomic_store_n(&vdev->pkts_deq_inflight, nr_inflight,
+					__ATOMIC_SEQ_CST);
 	} else {
 		count = rte_vhost_dequeue_burst(vdev->vid, VIRTIO_TXQ,
 					mbuf_pool, pkts, MAX_PKT_BURST);
@@ -1482,6 +1500,21 @@ switch_worker(void *arg __rte_unused)
 	return 0;
 }
 
+static void
+vhost_clear_deq_inflight(struct vhost_dev *vdev)
+{
+	uint16_t n_pkt = 0;
+	int16_t dma_id = dma_bind[vdev->vid].dmas[VIRTIO_TXQ].dev_id;
+	struct rte_mbuf *m_cpl[MAX_PKT_BURST];
+
+	while (vdev->pkts_deq_inflight) {
+		n_pkt = rte_vhost_clear_queue_thread_unsafe(vdev->vid, VIRTIO_TXQ,
+					m_cpl, MAX_PKT_BURST, dma_id, 0);
+		free_pkts(m_cpl, n_pkt);
+		__atomic_sub_fetch(&vdev->pkts_deq_inflight, n_pkt, __ATOMIC_SEQ_CST);
+	}
+}
+
 /*
  * Remove a device from the specific data core linked list and from the
  * main linked list. Synchronization  occurs through the use of the
@@ -1554,6 +1587,12 @@ destroy_device(int vid)
 		dma_bind[vid].dmas[VIRTIO_RXQ].async_enabled = false;
 	}
 
+	if (dma_bind[vid].dmas[VIRTIO_TXQ].async_enabled) {
+		vhost_clear_deq_inflight(vdev);
+		rte_vhost_async_channel_unregister(vid, VIRTIO_TXQ);
+		dma_bind[vid].dmas[VIRTIO_TXQ].async_enabled = false;
+	}
+
 	rte_free(vdev);
 }
 
@@ -1625,9 +1664,18 @@ new_device(int vid)
 		int ret;
 
 		ret = rte_vhost_async_channel_register(vid, VIRTIO_RXQ);
-		if (ret == 0)
-			dma_bind[vid].dmas[VIRTIO_RXQ].async_enabled = true;
-		return ret;
+		if (ret != 0)
+			return ret;
+		dma_bind[vid].dmas[VIRTIO_RXQ].async_enabled = true;
+	}
+
+	if (dma_bind[vid].dmas[VIRTIO_TXQ].dev_id != INVALID_DMA_ID) {
+		int ret;
+
+		ret = rte_vhost_async_channel_register(vid, VIRTIO_TXQ);
+		if (ret != 0)
+			return ret;
+		dma_bind[vid].dmas[VIRTIO_TXQ].async_enabled = true;
 	}
 
 	return 0;
@@ -1645,6 +1693,12 @@ vring_state_changed(int vid, uint16_t queue_id, int enable)
 	if (!vdev)
 		return -1;
 
+	if (queue_id == VIRTIO_TXQ) {
+		if (dma_bind[vid].dmas[queue_id].async_enabled && !enable)
+			vhost_clear_deq_inflight(vdev);
+		return 0;
+	}
+
 	if (queue_id != VIRTIO_RXQ)
 		return 0;
 
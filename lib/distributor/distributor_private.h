@@ -154,6 +154,8 @@ struct rte_distributor {
 
 	uint8_t active[RTE_DISTRIB_MAX_WORKERS];
 	uint8_t activesum;
+
+	uint8_t work_stealing; /**< idle workers take busy workers backlog */
 };
 
 void
@@ -435,6 +435,118 @@ release(struct rte_distributor *d, unsigned int wkr)
 
 }
 
+/* Check if the worker has taken its last burst, so a new one can be sent */
+static inline int
+worker_ready(struct rte_distributor *d, unsigned int wkr)
+{
+	/* Sync with worker on GET_BUF flag. */
+	return !!(__atomic_load_n(&(d->bufs[wkr].bufptr64[0]),
+		__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF);
+}
+
+/*
+ * Move the backlog packets of a busy worker to the empty backlog of an
+ * idle worker, except the packets of the flows in flight on the busy
+ * worker. All the packets of a flow are moved together and keep their
+ * order, so the flow pinning done by the matching is preserved.
+ */
+static unsigned int
+steal_backlog(struct rte_distributor *d, unsigned int victim,
+		unsigned int thief)
+{
+	struct rte_distributor_backlog *vbl = &d->backlog[victim];
+	struct rte_distributor_backlog *tbl = &d->backlog[thief];
+	unsigned int i, w, kept = 0, stolen;
+
+	for (i = 0; i < vbl->count; i++) {
+		uint16_t tag = vbl->tags[i];
+
+		for (w = 0; w < RTE_DIST_BURST_SIZE; w++)
+			if (d->in_flight_tags[victim][w] == tag)
+				break;
+
+		if (w < RTE_DIST_BURST_SIZE) {
+			vbl->tags[kept] = tag;
+			vbl->pkts[kept++] = vbl->pkts[i];
+		} else {
+			tbl->tags[tbl->count] = tag;
+			tbl->pkts[tbl->count++] = vbl->pkts[i];
+		}
+	}
+
+	stolen = vbl->count - kept;
+	vbl->count = kept;
+
+	/* Stolen flows must no longer match the busy worker */
+	for (i = kept; i < RTE_DIST_BURST_SIZE; i++)
+		vbl->tags[i] = 0;
+
+	return stolen;
+}
+
+/*
+ * Called when an idle worker has no backlog, to take the backlog of the
+ * busy worker with the most packets waiting.
+ */
+static void
+steal_work(struct rte_distributor *d, unsigned int thief)
+{
+	unsigned int wkr, victim = 0, max_count = 0;
+
+	for (wkr = 0; wkr < d->num_workers; wkr++)
+		if (wkr != thief && d->active[wkr] &&
+				d->backlog[wkr].count > max_count &&
+				!worker_ready(d, wkr)) {
+			victim = wkr;
+			max_count = d->backlog[wkr].count;
+		}
+
+	if (max_count > 0)
+		steal_backlog(d, victim, thief);
+}
+
+/*
+ * Called when the backlog of a worker is full, instead of waiting for
+ * the worker to take its last burst. The backlog is given to the first
+ * idle worker found.
+ * Returns 1 when packets were moved, the flows must then be matched
+ * again, 0 when the worker is ready or inactive, or all its backlog is
+ * pinned to it.
+ */
+static int
+steal_from_busy(struct rte_distributor *d, unsigned int wkr)
+{
+	unsigned int thief;
+
+	while (!worker_ready(d, wkr)) {
+		handle_returns(d, wkr);
+		if (unlikely(!d->active[wkr]))
+			return 0;
+
+		for (thief = 0; thief < d->num_workers; thief++) {
+			if (thief == wkr)
+				continue;
+			handle_returns(d, thief);
+			if (!d->active[thief] || !worker_ready(d, thief))
+				continue;
+
+			/* Nobody else releases the backlog of a ready worker */
+			if (d->backlog[thief].count) {
+				release(d, thief);
+				continue;
+			}
+
+			if (steal_backlog(d, wkr, thief) == 0)
+				return 0;
+			release(d, thief);
+			return 1;
+		}
+		rte_pause();
+	}
+
+	return 0;
+}
+
 
 /* process a set of packets to distribute them to workers */
 int
@@ -464,6 +576,10 @@ rte_distributor_process(struct rte_distributor *d,
 			/* Sync with worker on GET_BUF flag. */
 			if (__atomic_load_n(&(d->bufs[wid].bufptr64[0]),
 				__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF) {
+				if (d->work_stealing &&
+						d->backlog[wid].count == 0 &&
+						d->active[wid])
+					steal_work(d, wid);
 				d->bufs[wid].count = 0;
 				release(d, wid);
 				handle_returns(d, wid);
@@ -542,6 +658,14 @@ rte_distributor_process(struct rte_distributor *d,
 						&d->backlog[matches[j]-1];
 				if (unlikely(bl->count ==
 						RTE_DIST_BURST_SIZE)) {
+					if (d->work_stealing &&
+						steal_from_busy(d,
+							matches[j]-1)) {
+						j--;
+						next_idx--;
+						matching_required = 1;
+						continue;
+					}
 					release(d, matches[j]-1);
 					if (!d->active[matches[j]-1]) {
 						j--;
@@ -566,6 +690,13 @@ rte_distributor_process(struct rte_distributor *d,
 
 				if (unlikely(bl->count ==
 						RTE_DIST_BURST_SIZE)) {
+					if (d->work_stealing &&
+						steal_from_busy(d, wkr)) {
+						j--;
+						next_idx--;
+						matching_required = 1;
+						continue;
+					}
 					release(d, wkr);
 					if (!d->active[wkr]) {
 						j--;
@@ -599,6 +730,9 @@ rte_distributor_process(struct rte_distributor *d,
 		/* Sync with worker on GET_BUF flag. */
 		if ((__atomic_load_n(&(d->bufs[wid].bufptr64[0]),
 			__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF)) {
+			if (d->work_stealing && d->backlog[wid].count == 0 &&
+					d->active[wid])
+				steal_work(d, wid);
 			d->bufs[wid].count = 0;
 			release(d, wid);
 		}
@@ -684,6 +818,20 @@ rte_distributor_flush(struct rte_distributor *d)
 	return flushed;
 }
 
+int
+rte_distributor_work_stealing_set(struct rte_distributor *d, int enable)
+{
+	if (d == NULL)
+		return -EINVAL;
+
+	if (d->alg_type == RTE_DIST_ALG_SINGLE)
+		return -ENOTSUP;
+
+	d->work_stealing = !!enable;
+
+	return 0;
+}
+
 /* clears the internal returns array in the distributor */
 void
 rte_distributor_clear_returns(struct rte_distributor *d)
@@ -774,6 +922,7 @@ rte_distributor_create(const char *name,
 
 	memset(d->active, 0, sizeof(d->active));
 	d->activesum = 0;
+	d->work_stealing = 0;
 
 	dist_burst_list = RTE_TAILQ_CAST(rte_dist_burst_tailq.head,
 					  rte_dist_burst_list);
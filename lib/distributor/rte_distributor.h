@@ -17,6 +17,8 @@
 extern "C" {
 #endif
 
+#include <rte_compat.h>
+
 /* Type of distribution (burst/single) */
 enum rte_distributor_alg_type {
 	RTE_DIST_ALG_BURST = 0,
@@ -132,6 +134,40 @@ rte_distributor_flush(struct rte_distributor *d);
 void
 rte_distributor_clear_returns(struct rte_distributor *d);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Enable or disable work stealing on a burst distributor.
+ *
+ * Without work stealing, the packets assigned to a worker wait in its
+ * backlog until the worker asks for more packets, even when the worker
+ * is stalled and other workers are idle. With work stealing, a worker
+ * which asks for packets and has none waiting takes the backlog of a
+ * worker which has not yet taken its previous burst.
+ *
+ * Only the packets of flows which are not in flight on the busy worker
+ * are moved, and all the waiting packets of a flow are moved together,
+ * so the packets of a flow are still processed in order, as when
+ * work stealing is disabled.
+ *
+ * Work stealing is disabled by default.
+ *
+ * This should only be called on the same lcore as rte_distributor_process()
+ *
+ * @param d
+ *   The distributor instance to be used
+ * @param enable
+ *   Non-zero to enable work stealing, zero to disable it
+ * @return
+ *   - 0 on success
+ *   - -EINVAL if the distributor is NULL
+ *   - -ENOTSUP if the distributor uses the legacy single packet API
+ */
+__rte_experimental
+int
+rte_distributor_work_stealing_set(struct rte_distributor *d, int enable);
+
 /*  *** APIS to be called on the worker lcores ***  */
 /*
  * The following APIs are the public APIs which are designed for use on
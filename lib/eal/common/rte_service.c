@@ -15,6 +15,9 @@
 #include <rte_atomic.h>
 #include <rte_malloc.h>
 #include <rte_spinlock.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <rte_telemetry.h>
+#endif
 
 #include "eal_private.h"
 
@@ -51,9 +54,18 @@ struct rte_service_spec_impl {
 	 */
 	uint32_t num_mapped_cores;
 	uint64_t calls;
+	uint64_t idle_calls;
 	uint64_t cycles_spent;
 } __rte_cache_aligned;
 
+/* statistics of a service on one lcore */
+struct service_stats {
+	uint64_t calls;
+	uint64_t idle_calls;
+	uint64_t busy_cycles;
+	uint64_t cycles_hist[RTE_SERVICE_CYCLES_HIST_BUCKETS];
+};
+
 /* the internal values of a service core */
 struct core_state {
 	/* map of services IDs are run on this core */
@@ -63,7 +75,7 @@ struct core_state {
 	uint8_t is_service_core; /* set if core is currently a service core */
 	uint8_t service_active_on_lcore[RTE_SERVICE_NUM_MAX];
 	uint64_t loops;
-	uint64_t calls_per_service[RTE_SERVICE_NUM_MAX];
+	struct service_stats service_stats[RTE_SERVICE_NUM_MAX];
 } __rte_cache_aligned;
 
 static uint32_t rte_service_count;
@@ -71,6 +83,21 @@ static struct rte_service_spec_impl *rte_services;
 static struct core_state *lcore_states;
 static uint32_t rte_service_library_initialized;
 
+/* statistics of a service lcore at the previous balancing */
+struct balance_lcore {
+	uint64_t tsc;
+	uint64_t loops;
+	uint64_t busy_cycles[RTE_SERVICE_NUM_MAX];
+	/* derived from the statistics since the previous balancing */
+	uint64_t loop_cycles; /* cycles per loop of the lcore */
+	uint64_t cost[RTE_SERVICE_NUM_MAX]; /* busy cycles per loop */
+	uint8_t util; /* busy percentage */
+	uint8_t measured;
+};
+
+static struct rte_service_balance_conf balance_conf;
+static struct balance_lcore *balance_lcores;
+
 int32_t
 rte_service_init(void)
 {
@@ -127,6 +154,8 @@ rte_service_finalize(void)
 
 	rte_free(rte_services);
 	rte_free(lcore_states);
+	rte_free(balance_lcores);
+	balance_lcores = NULL;
 
 	rte_service_library_initialized = 0;
 }
@@ -353,6 +382,16 @@ rte_service_runstate_get(uint32_t id)
 
 }
 
+/* histogram bucket of a call which took the given number of cycles */
+static inline unsigned int
+service_cycles_hist_bucket(uint64_t cycles)
+{
+	int bucket = (int)rte_fls_u64(cycles) - RTE_SERVICE_CYCLES_HIST_SHIFT;
+
+	return RTE_MIN((unsigned int)RTE_MAX(bucket, 0),
+			RTE_SERVICE_CYCLES_HIST_BUCKETS - 1u);
+}
+
 static inline void
 service_runner_do_callback(struct rte_service_spec_impl *s,
 			   struct core_state *cs, uint32_t service_idx)
@@ -360,12 +399,22 @@ service_runner_do_callback(struct rte_service_spec_impl *s,
 	void *userdata = s->spec.callback_userdata;
 
 	if (service_stats_enabled(s)) {
+		struct service_stats *stats = &cs->service_stats[service_idx];
 		uint64_t start = rte_rdtsc();
-		s->spec.callback(userdata);
+		int32_t ret = s->spec.callback(userdata);
 		uint64_t end = rte_rdtsc();
-		s->cycles_spent += end - start;
-		cs->calls_per_service[service_idx]++;
+		uint64_t cycles = end - start;
+
+		s->cycles_spent += cycles;
 		s->calls++;
+		stats->calls++;
+		if (ret == -EAGAIN) {
+			s->idle_calls++;
+			stats->idle_calls++;
+		} else {
+			stats->busy_cycles += cycles;
+			stats->cycles_hist[service_cycles_hist_bucket(cycles)]++;
+		}
 	} else
 		s->spec.callback(userdata);
 }
@@ -472,6 +521,14 @@ service_runner_func(void *arg)
 		cs->loops++;
 	}
 
+	/* The services may have been moved away before the lcore was
+	 * stopped, e.g. by rte_service_balance(): switch them off on this
+	 * lcore so that rte_service_may_be_active() does not see it as
+	 * still running them.
+	 */
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++)
+		cs->service_active_on_lcore[i] = 0;
+
 	/* Use SEQ CST memory ordering to avoid any re-ordering around
 	 * this store, ensuring that once this store is visible, the service
 	 * lcore thread really is done in service cores code.
@@ -799,6 +856,9 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CALL_COUNT:
 		*attr_value = s->calls;
 		return 0;
+	case RTE_SERVICE_ATTR_IDLE_CALL_COUNT:
+		*attr_value = s->idle_calls;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -834,6 +894,7 @@ rte_service_attr_reset_all(uint32_t id)
 
 	s->cycles_spent = 0;
 	s->calls = 0;
+	s->idle_calls = 0;
 	return 0;
 }
 
@@ -850,10 +911,330 @@ rte_service_lcore_attr_reset_all(uint32_t lcore)
 		return -ENOTSUP;
 
 	cs->loops = 0;
+	memset(cs->service_stats, 0, sizeof(cs->service_stats));
+
+	return 0;
+}
+
+int32_t
+rte_service_lcore_service_attr_get(uint32_t lcore, uint32_t id,
+				   uint32_t attr_id, uint64_t *attr_value)
+{
+	struct rte_service_spec_impl *s;
+	struct service_stats *stats;
+
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+	RTE_SET_USED(s);
+
+	if (lcore >= RTE_MAX_LCORE || !attr_value)
+		return -EINVAL;
+
+	stats = &lcore_states[lcore].service_stats[id];
+
+	switch (attr_id) {
+	case RTE_SERVICE_LCORE_SERVICE_ATTR_CALL_COUNT:
+		*attr_value = stats->calls;
+		return 0;
+	case RTE_SERVICE_LCORE_SERVICE_ATTR_IDLE_CALL_COUNT:
+		*attr_value = stats->idle_calls;
+		return 0;
+	case RTE_SERVICE_LCORE_SERVICE_ATTR_BUSY_CYCLES:
+		*attr_value = stats->busy_cycles;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+int32_t
+rte_service_lcore_service_cycles_hist_get(uint32_t lcore, uint32_t id,
+		uint64_t hist[RTE_SERVICE_CYCLES_HIST_BUCKETS])
+{
+	struct rte_service_spec_impl *s;
+	struct service_stats *stats;
+
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+	RTE_SET_USED(s);
+
+	if (lcore >= RTE_MAX_LCORE || !hist)
+		return -EINVAL;
+
+	stats = &lcore_states[lcore].service_stats[id];
+	memcpy(hist, stats->cycles_hist, sizeof(stats->cycles_hist));
 
 	return 0;
 }
 
+int32_t
+rte_service_balance_conf_set(const struct rte_service_balance_conf *conf)
+{
+	if (!rte_service_library_initialized)
+		return -ENOTSUP;
+
+	if (conf == NULL) {
+		rte_free(balance_lcores);
+		balance_lcores = NULL;
+		return 0;
+	}
+
+	if (conf->min_lcores == 0 || conf->min_lcores > conf->max_lcores ||
+			conf->latency_budget_us == 0 || conf->low_util > 100)
+		return -EINVAL;
+
+	if (balance_lcores == NULL) {
+		balance_lcores = rte_calloc("rte_service_balance",
+				RTE_MAX_LCORE, sizeof(struct balance_lcore),
+				RTE_CACHE_LINE_SIZE);
+		if (balance_lcores == NULL)
+			return -ENOMEM;
+	}
+	balance_conf = *conf;
+
+	return 0;
+}
+
+static inline int
+balance_lcore_running(uint32_t lcore)
+{
+	return lcore_states[lcore].is_service_core &&
+		__atomic_load_n(&lcore_states[lcore].runstate,
+			__ATOMIC_ACQUIRE) == RUNSTATE_RUNNING;
+}
+
+/* a service may be moved if it runs on this lcore only */
+static inline int
+balance_service_movable(uint32_t lcore, uint32_t id)
+{
+	return service_valid(id) && service_stats_enabled(&rte_services[id]) &&
+		(lcore_states[lcore].service_mask & (UINT64_C(1) << id)) &&
+		__atomic_load_n(&rte_services[id].num_mapped_cores,
+			__ATOMIC_RELAXED) == 1;
+}
+
+/* update the statistics of a service lcore since the previous balancing */
+static void
+balance_measure(uint32_t lcore, uint64_t now)
+{
+	struct balance_lcore *bl = &balance_lcores[lcore];
+	struct core_state *cs = &lcore_states[lcore];
+	uint64_t loops = cs->loops;
+	uint64_t busy = 0;
+	uint64_t elapsed;
+	uint64_t nb_loops;
+	uint32_t i;
+
+	elapsed = now - bl->tsc;
+	nb_loops = loops - bl->loops;
+	/* no loop, or counters reset: only take a new reference */
+	bl->measured = bl->tsc != 0 && loops > bl->loops && elapsed > 0;
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		uint64_t cycles = cs->service_stats[i].busy_cycles;
+
+		if (bl->measured && cycles >= bl->busy_cycles[i]) {
+			bl->cost[i] = (cycles - bl->busy_cycles[i]) / nb_loops;
+			busy += cycles - bl->busy_cycles[i];
+		} else
+			bl->cost[i] = 0;
+		bl->busy_cycles[i] = cycles;
+	}
+
+	if (bl->measured) {
+		bl->loop_cycles = elapsed / nb_loops;
+		bl->util = RTE_MIN(busy * 100 / elapsed, UINT64_C(100));
+	}
+	bl->tsc = now;
+	bl->loops = loops;
+}
+
+static void
+balance_move(uint32_t id, uint32_t src, uint32_t dst)
+{
+	/* map on the new lcore first, so that the service keeps running.
+	 * MT unsafe services are serialized by their execute lock meanwhile.
+	 */
+	rte_service_map_lcore_set(id, dst, 1);
+	rte_service_map_lcore_set(id, src, 0);
+
+	balance_lcores[src].loop_cycles -= RTE_MIN(balance_lcores[src].cost[id],
+			balance_lcores[src].loop_cycles);
+	balance_lcores[dst].loop_cycles += balance_lcores[src].cost[id];
+	balance_lcores[dst].cost[id] = balance_lcores[src].cost[id];
+	balance_lcores[src].cost[id] = 0;
+
+	RTE_LOG(DEBUG, EAL, "service %s moved from lcore %u to lcore %u\n",
+			rte_services[id].spec.name, src, dst);
+}
+
+/* running lcore, other than the given one, with the shortest loop */
+static int32_t
+balance_least_loaded(uint32_t skip)
+{
+	int32_t best = -1;
+	uint32_t i;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		if (i == skip || !balance_lcore_running(i) ||
+				!balance_lcores[i].measured)
+			continue;
+		if (best < 0 || balance_lcores[i].loop_cycles <
+				balance_lcores[best].loop_cycles)
+			best = i;
+	}
+
+	return best;
+}
+
+/* start a stopped service lcore, returns its id or -1 */
+static int32_t
+balance_grow(uint64_t now)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		if (!lcore_states[i].is_service_core || balance_lcore_running(i))
+			continue;
+		if (rte_service_lcore_start(i) != 0)
+			continue;
+
+		/* measured from now on, starting with no load */
+		balance_measure(i, now);
+		balance_lcores[i].loop_cycles = 0;
+		balance_lcores[i].measured = 1;
+		return i;
+	}
+
+	return -1;
+}
+
+/* move a service away from an lcore which loops slower than the budget */
+static int
+balance_offload(uint32_t lcore, uint64_t budget, uint32_t *nb_running,
+		uint64_t now)
+{
+	struct balance_lcore *bl = &balance_lcores[lcore];
+	uint32_t i, nb_services = 0;
+	int32_t id = -1;
+	int32_t dst;
+
+	/* move the heaviest service, to free as many cycles as possible */
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		if (!(lcore_states[lcore].service_mask & (UINT64_C(1) << i)) ||
+				!service_valid(i))
+			continue;
+		nb_services++;
+		if (balance_service_movable(lcore, i) &&
+				(id < 0 || bl->cost[i] > bl->cost[id]))
+			id = i;
+	}
+	/* a single service over budget cannot be helped by moving it */
+	if (id < 0 || nb_services < 2)
+		return 0;
+
+	dst = balance_least_loaded(lcore);
+	if (dst < 0 || balance_lcores[dst].loop_cycles + bl->cost[id] > budget) {
+		if (*nb_running >= balance_conf.max_lcores)
+			return 0;
+		dst = balance_grow(now);
+		if (dst < 0)
+			return 0;
+		(*nb_running)++;
+	}
+
+	balance_move(id, lcore, dst);
+	return 1;
+}
+
+/* move all services away from an lcore and stop it, if they fit */
+static int
+balance_shrink(uint32_t lcore, uint64_t budget)
+{
+	struct balance_lcore *bl = &balance_lcores[lcore];
+	uint64_t extra[RTE_MAX_LCORE] = {0};
+	int32_t dst[RTE_SERVICE_NUM_MAX];
+	uint32_t i, j;
+	int moves = 0;
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		dst[i] = -1;
+		if (!(lcore_states[lcore].service_mask & (UINT64_C(1) << i)))
+			continue;
+		if (!balance_service_movable(lcore, i))
+			return 0;
+
+		for (j = 0; j < RTE_MAX_LCORE; j++) {
+			if (j == lcore || !balance_lcore_running(j) ||
+					!balance_lcores[j].measured)
+				continue;
+			if (balance_lcores[j].loop_cycles + extra[j] +
+					bl->cost[i] <= budget)
+				break;
+		}
+		if (j == RTE_MAX_LCORE)
+			return 0;
+		dst[i] = j;
+		extra[j] += bl->cost[i];
+	}
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		if (dst[i] < 0)
+			continue;
+		balance_move(i, lcore, dst[i]);
+		moves++;
+	}
+	rte_service_lcore_stop(lcore);
+	bl->measured = 0;
+	bl->tsc = 0;
+
+	RTE_LOG(DEBUG, EAL, "service lcore %u stopped\n", lcore);
+	return moves;
+}
+
+int32_t
+rte_service_balance(void)
+{
+	uint64_t now = rte_rdtsc();
+	uint64_t budget;
+	uint32_t nb_running = 0;
+	int32_t idle = -1;
+	int moves = 0;
+	uint32_t i;
+
+	if (!rte_service_library_initialized || balance_lcores == NULL)
+		return -ENOTSUP;
+
+	budget = balance_conf.latency_budget_us * rte_get_tsc_hz() / US_PER_S;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		if (!balance_lcore_running(i)) {
+			balance_lcores[i].tsc = 0;
+			balance_lcores[i].measured = 0;
+			continue;
+		}
+		balance_measure(i, now);
+		nb_running++;
+	}
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		struct balance_lcore *bl = &balance_lcores[i];
+
+		if (!balance_lcore_running(i) || !bl->measured)
+			continue;
+
+		if (bl->loop_cycles > budget)
+			moves += balance_offload(i, budget, &nb_running, now);
+		else if (bl->util < balance_conf.low_util && (idle < 0 ||
+				bl->util < balance_lcores[idle].util))
+			idle = i;
+	}
+
+	/* stop at most one lcore at a time, when no lcore is overloaded */
+	if (moves == 0 && idle >= 0 && nb_running > balance_conf.min_lcores)
+		moves = balance_shrink(idle, budget);
+
+	return moves;
+}
+
 static void
 service_dump_one(FILE *f, struct rte_service_spec_impl *s)
 {
@@ -862,10 +1243,10 @@ service_dump_one(FILE *f, struct rte_service_spec_impl *s)
 
 	if (s->calls != 0)
 		calls = s->calls;
-	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tcycles %"
-			PRIu64"\tavg: %"PRIu64"\n",
+	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tidle %"PRIu64
+			"\tcycles %"PRIu64"\tavg: %"PRIu64"\n",
 			s->spec.name, service_stats_enabled(s), s->calls,
-			s->cycles_spent, s->cycles_spent / calls);
+			s->idle_calls, s->cycles_spent, s->cycles_spent / calls);
 }
 
 static void
@@ -878,7 +1259,7 @@ service_dump_calls_per_lcore(FILE *f, uint32_t lcore)
 	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
 		if (!service_valid(i))
 			continue;
-		fprintf(f, "%"PRIu64"\t", cs->calls_per_service[i]);
+		fprintf(f, "%"PRIu64"\t", cs->service_stats[i].calls);
 	}
 	fprintf(f, "\n");
 }
@@ -916,3 +1297,190 @@ rte_service_dump(FILE *f, uint32_t id)
 
 	return 0;
 }
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+#define EAL_SERVICE_LIST_REQ		"/eal/service_list"
+#define EAL_SERVICE_INFO_REQ		"/eal/service_info"
+#define EAL_SERVICE_LCORE_LIST_REQ	"/eal/service_lcore_list"
+#define EAL_SERVICE_LCORE_STATS_REQ	"/eal/service_lcore_stats"
+#define EAL_SERVICE_LCORE_HIST_REQ	"/eal/service_lcore_cycles_hist"
+
+/* Telemetry callback handler to list the registered services. */
+static int
+handle_service_list_request(const char *cmd __rte_unused,
+			    const char *params __rte_unused,
+			    struct rte_tel_data *d)
+{
+	uint32_t i;
+
+	if (!rte_service_library_initialized)
+		return -EINVAL;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++)
+		if (service_valid(i))
+			rte_tel_data_add_array_int(d, i);
+
+	return 0;
+}
+
+/* Telemetry callback handler to return the statistics of a service. */
+static int
+handle_service_info_request(const char *cmd __rte_unused,
+			    const char *params, struct rte_tel_data *d)
+{
+	struct rte_service_spec_impl *s;
+	uint32_t id;
+
+	if (!rte_service_library_initialized)
+		return -EINVAL;
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	id = strtoul(params, NULL, 10);
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "id", id);
+	rte_tel_data_add_dict_string(d, "name", s->spec.name);
+	rte_tel_data_add_dict_int(d, "stats_enabled",
+			service_stats_enabled(s));
+	rte_tel_data_add_dict_int(d, "mapped_lcores",
+			__atomic_load_n(&s->num_mapped_cores,
+				__ATOMIC_RELAXED));
+	rte_tel_data_add_dict_u64(d, "calls", s->calls);
+	rte_tel_data_add_dict_u64(d, "idle_calls", s->idle_calls);
+	rte_tel_data_add_dict_u64(d, "cycles", s->cycles_spent);
+
+	return 0;
+}
+
+/* Telemetry callback handler to list the service lcores. */
+static int
+handle_service_lcore_list_request(const char *cmd __rte_unused,
+				  const char *params __rte_unused,
+				  struct rte_tel_data *d)
+{
+	uint32_t i;
+
+	if (!rte_service_library_initialized)
+		return -EINVAL;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		if (lcore_states[i].is_service_core)
+			rte_tel_data_add_array_int(d, i);
+
+	return 0;
+}
+
+static int
+service_lcore_params(const char *params, uint32_t *lcore)
+{
+	if (!rte_service_library_initialized)
+		return -EINVAL;
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	*lcore = strtoul(params, NULL, 10);
+	if (*lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	return 0;
+}
+
+/* Telemetry callback handler to return the statistics of the services
+ * run by an lcore, keyed by service name.
+ */
+static int
+handle_service_lcore_stats_request(const char *cmd __rte_unused,
+				   const char *params, struct rte_tel_data *d)
+{
+	struct core_state *cs;
+	uint32_t lcore, i;
+
+	if (service_lcore_params(params, &lcore) < 0)
+		return -EINVAL;
+	cs = &lcore_states[lcore];
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "lcore", lcore);
+	rte_tel_data_add_dict_int(d, "service_core", cs->is_service_core);
+	rte_tel_data_add_dict_u64(d, "loops", cs->loops);
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		struct service_stats *stats = &cs->service_stats[i];
+		struct rte_tel_data *c;
+
+		if (!service_valid(i) || stats->calls == 0)
+			continue;
+
+		c = rte_tel_data_alloc();
+		if (c == NULL)
+			return -ENOMEM;
+		rte_tel_data_start_dict(c);
+		rte_tel_data_add_dict_u64(c, "calls", stats->calls);
+		rte_tel_data_add_dict_u64(c, "idle_calls", stats->idle_calls);
+		rte_tel_data_add_dict_u64(c, "busy_cycles",
+				stats->busy_cycles);
+		rte_tel_data_add_dict_container(d, rte_services[i].spec.name,
+				c, 0);
+	}
+
+	return 0;
+}
+
+/* Telemetry callback handler to return the cycles histograms of the
+ * services run by an lcore, keyed by service name.
+ */
+static int
+handle_service_lcore_hist_request(const char *cmd __rte_unused,
+				  const char *params, struct rte_tel_data *d)
+{
+	struct core_state *cs;
+	uint32_t lcore, i, b;
+
+	if (service_lcore_params(params, &lcore) < 0)
+		return -EINVAL;
+	cs = &lcore_states[lcore];
+
+	rte_tel_data_start_dict(d);
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+		struct service_stats *stats = &cs->service_stats[i];
+		struct rte_tel_data *c;
+
+		if (!service_valid(i) || stats->calls == 0)
+			continue;
+
+		c = rte_tel_data_alloc();
+		if (c == NULL)
+			return -ENOMEM;
+		rte_tel_data_start_array(c, RTE_TEL_U64_VAL);
+		for (b = 0; b < RTE_SERVICE_CYCLES_HIST_BUCKETS; b++)
+			rte_tel_data_add_array_u64(c, stats->cycles_hist[b]);
+		rte_tel_data_add_dict_container(d, rte_services[i].spec.name,
+				c, 0);
+	}
+
+	return 0;
+}
+
+RTE_INIT(service_telemetry)
+{
+	rte_telemetry_register_cmd(EAL_SERVICE_LIST_REQ,
+			handle_service_list_request,
+			"List of registered service ids. Takes no parameters");
+	rte_telemetry_register_cmd(EAL_SERVICE_INFO_REQ,
+			handle_service_info_request,
+			"Returns service statistics. Parameters: int service_id");
+	rte_telemetry_register_cmd(EAL_SERVICE_LCORE_LIST_REQ,
+			handle_service_lcore_list_request,
+			"List of service lcores. Takes no parameters");
+	rte_telemetry_register_cmd(EAL_SERVICE_LCORE_STATS_REQ,
+			handle_service_lcore_stats_request,
+			"Returns per service statistics of an lcore. Parameters: int lcore_id");
+	rte_telemetry_register_cmd(EAL_SERVICE_LCORE_HIST_REQ,
+			handle_service_lcore_hist_request,
+			"Returns per service cycles histograms of an lcore. Parameters: int lcore_id");
+}
+#endif
@@ -30,6 +30,7 @@ extern "C" {
 #include<stdio.h>
 #include <stdint.h>
 
+#include <rte_compat.h>
 #include <rte_config.h>
 #include <rte_lcore.h>
 
@@ -384,6 +385,12 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_CALL_COUNT 1
 
+/**
+ * Returns the count of invocations of this service function which returned
+ * -EAGAIN, meaning the service had no work to do.
+ */
+#define RTE_SERVICE_ATTR_IDLE_CALL_COUNT 2
+
 /**
  * Get an attribute from a service.
  *
@@ -432,6 +439,156 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 int32_t
 rte_service_lcore_attr_reset_all(uint32_t lcore);
 
+/**
+ * Returns the number of invocations of the service on the lcore.
+ */
+#define RTE_SERVICE_LCORE_SERVICE_ATTR_CALL_COUNT 0
+
+/**
+ * Returns the number of invocations of the service on the lcore which
+ * returned -EAGAIN, meaning the service had no work to do.
+ */
+#define RTE_SERVICE_LCORE_SERVICE_ATTR_IDLE_CALL_COUNT 1
+
+/**
+ * Returns the number of cycles spent by the service on the lcore in
+ * invocations which did not return -EAGAIN.
+ */
+#define RTE_SERVICE_LCORE_SERVICE_ATTR_BUSY_CYCLES 2
+
+/** Number of buckets of the per lcore service cycles histogram. */
+#define RTE_SERVICE_CYCLES_HIST_BUCKETS 16
+
+/**
+ * Log2 of the upper bound of the first bucket of the cycles histogram.
+ * Bucket 0 counts the invocations which took less than
+ * 2^RTE_SERVICE_CYCLES_HIST_SHIFT cycles, bucket i counts those which took
+ * from 2^(RTE_SERVICE_CYCLES_HIST_SHIFT + i - 1) to
+ * 2^(RTE_SERVICE_CYCLES_HIST_SHIFT + i) cycles, and the last bucket also
+ * counts all longer invocations.
+ */
+#define RTE_SERVICE_CYCLES_HIST_SHIFT 8
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Get a statistic of a service on an lcore.
+ *
+ * The statistics are collected when statistics are enabled for the service
+ * with *rte_service_set_stats_enable*. Both service cores and application
+ * lcores running the service with *rte_service_run_iter_on_app_lcore* are
+ * accounted. They are reset by *rte_service_lcore_attr_reset_all*.
+ *
+ * @param lcore Id of the lcore.
+ * @param id The service id.
+ * @param attr_id Id of the attribute to be retrieved, one of
+ *        RTE_SERVICE_LCORE_SERVICE_ATTR_*.
+ * @param [out] attr_value Pointer to storage in which to write retrieved value.
+ * @retval 0 Success, the attribute value has been written to *attr_value*.
+ *         -EINVAL Invalid lcore, service id, attr_id or attr_value was NULL.
+ */
+__rte_experimental
+int32_t
+rte_service_lcore_service_attr_get(uint32_t lcore, uint32_t id,
+				   uint32_t attr_id, uint64_t *attr_value);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Get the histogram of the cycles spent per invocation of a service on an
+ * lcore, for the invocations which did not return -EAGAIN. See
+ * RTE_SERVICE_CYCLES_HIST_SHIFT for the bounds of the buckets.
+ *
+ * @param lcore Id of the lcore.
+ * @param id The service id.
+ * @param [out] hist Array in which to write the invocation count of each
+ *        bucket.
+ * @retval 0 Success, the histogram has been written to *hist*.
+ *         -EINVAL Invalid lcore, service id or hist was NULL.
+ */
+__rte_experimental
+int32_t
+rte_service_lcore_service_cycles_hist_get(uint32_t lcore, uint32_t id,
+		uint64_t hist[RTE_SERVICE_CYCLES_HIST_BUCKETS]);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change, or be removed, without prior
+ * notice
+ *
+ * Configuration of the adaptive balancing of services over service lcores.
+ */
+struct rte_service_balance_conf {
+	/** Minimum number of running service lcores. */
+	uint32_t min_lcores;
+	/** Maximum number of running service lcores. */
+	uint32_t max_lcores;
+	/** Latency budget, in us: the maximum time a service should wait
+	 * between two invocations, which is the duration of a loop over
+	 * all the services of its lcore.
+	 */
+	uint32_t latency_budget_us;
+	/** Busy percentage of a service lcore below which its services are
+	 * moved to other service lcores, to stop it.
+	 */
+	uint8_t low_util;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Enable, reconfigure or disable the adaptive balancing of services done
+ * by *rte_service_balance*.
+ *
+ * @param conf The balancing configuration, or NULL to disable balancing.
+ * @retval 0 Success
+ *         -EINVAL Invalid configuration: min_lcores is zero or greater
+ *          than max_lcores, latency_budget_us is zero or low_util is
+ *          greater than 100.
+ *         -ENOMEM Not enough memory for the balancing state.
+ *         -ENOTSUP The service library is not initialized.
+ */
+__rte_experimental
+int32_t
+rte_service_balance_conf_set(const struct rte_service_balance_conf *conf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Balance the services over the service lcores.
+ *
+ * The function measures, since its previous call, the loop duration of
+ * each running service lcore, and the busy cycles per loop of each of its
+ * services, as accounted by the per lcore service statistics.
+ *
+ * When the loop of a service lcore exceeds the latency budget, its
+ * heaviest service is moved to the least loaded running service lcore.
+ * If that would exceed the budget of that lcore too, a stopped service
+ * lcore is started for the service, within max_lcores.
+ *
+ * When no lcore is over budget, the least busy lcore below low_util has
+ * all its services moved to other lcores, if they fit in their budget,
+ * and is stopped, within min_lcores.
+ *
+ * Only the services with statistics enabled, and mapped to a single
+ * lcore, are moved. The service lcores to use must have been added with
+ * *rte_service_lcore_add*.
+ *
+ * This function is meant to be called periodically by a control lcore,
+ * at a period large compared to the latency budget. It must not be called
+ * concurrently with other functions changing the service mappings.
+ *
+ * @retval >=0 The number of services moved.
+ *         -ENOTSUP Balancing is not enabled.
+ */
+__rte_experimental
+int32_t
+rte_service_balance(void);
+
 #ifdef __cplusplus
 }
 #endif
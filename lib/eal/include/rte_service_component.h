@@ -19,6 +19,9 @@ extern "C" {
 
 /**
  * Signature of callback function to run a service.
+ *
+ * The callback should return -EAGAIN when it found no work to do, so that
+ * idle invocations are accounted in the service statistics.
  */
 typedef int32_t (*rte_service_func)(void *args);
 
@@ -5,10 +5,14 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <rte_debug.h>
+#include <rte_log.h>
 #include <rte_malloc.h>
 #include <rte_errno.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_vect.h>
 
 #include <rte_rib.h>
@@ -21,10 +25,24 @@
 
 #endif /* CC_DIR24_8_AVX512_SUPPORT */
 
+#ifdef CC_DIR24_8_AVX2_SUPPORT
+
+#include "dir24_8_avx2.h"
+
+#endif /* CC_DIR24_8_AVX2_SUPPORT */
+
+#ifdef CC_DIR24_8_NEON_SUPPORT
+
+#include "dir24_8_neon.h"
+
+#endif /* CC_DIR24_8_NEON_SUPPORT */
+
 #define DIR24_8_NAMESIZE	64
 
 #define ROUNDUP(x, y)	 RTE_ALIGN_CEIL(x, (1 << (32 - y)))
 
+#define DIR24_8_TXN_MIN_SZ	64U
+
 static inline rte_fib_lookup_fn_t
 get_scalar_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
 {
@@ -85,6 +103,58 @@ get_vector_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
 	return NULL;
 }
 
+static inline rte_fib_lookup_fn_t
+get_vector_fn_avx2(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+#ifdef CC_DIR24_8_AVX2_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_256))
+		return NULL;
+
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return rte_dir24_8_avx2_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return rte_dir24_8_avx2_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return rte_dir24_8_avx2_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return rte_dir24_8_avx2_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(nh_sz);
+#endif
+	return NULL;
+}
+
+static inline rte_fib_lookup_fn_t
+get_vector_fn_neon(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+#ifdef CC_DIR24_8_NEON_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_NEON) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_128))
+		return NULL;
+
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return rte_dir24_8_neon_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return rte_dir24_8_neon_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return rte_dir24_8_neon_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return rte_dir24_8_neon_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(nh_sz);
+#endif
+	return NULL;
+}
+
 rte_fib_lookup_fn_t
 dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type)
 {
@@ -106,6 +176,10 @@ dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type)
 		return dir24_8_lookup_bulk_uni;
 	case RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512:
 		return get_vector_fn(nh_sz);
+	case RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX2:
+		return get_vector_fn_avx2(nh_sz);
+	case RTE_FIB_LOOKUP_DIR24_8_VECTOR_NEON:
+		return get_vector_fn_neon(nh_sz);
 	case RTE_FIB_LOOKUP_DEFAULT:
 		ret_fn = get_vector_fn(nh_sz);
 		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(nh_sz);
@@ -169,13 +243,28 @@ tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 		~(1ULL << (idx & BITMAP_SLAB_BITMASK));
 }
 
+static int
+tbl8_get(struct dir24_8_tbl *dp)
+{
+	int tbl8_idx;
+
+	tbl8_idx = tbl8_get_idx(dp);
+	if ((tbl8_idx == -ENOSPC) && (dp->dq != NULL)) {
+		/* If there are no tbl8 groups try to reclaim one. */
+		if (rte_rcu_qsbr_dq_reclaim(dp->dq, 1,
+				NULL, NULL, NULL) == 0)
+			tbl8_idx = tbl8_get_idx(dp);
+	}
+	return tbl8_idx;
+}
+
 static int
 tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 {
 	int64_t	tbl8_idx;
 	uint8_t	*tbl8_ptr;
 
-	tbl8_idx = tbl8_get_idx(dp);
+	tbl8_idx = tbl8_get(dp);
 	if (tbl8_idx < 0)
 		return tbl8_idx;
 	tbl8_ptr = (uint8_t *)dp->tbl8 +
@@ -186,9 +275,60 @@ tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 		DIR24_8_EXT_ENT, dp->nh_sz,
 		DIR24_8_TBL8_GRP_NUM_ENT);
 	dp->cur_tbl8s++;
+	/* tbl8 must be initialized before it is linked into tbl24 */
+	rte_atomic_thread_fence(__ATOMIC_RELEASE);
 	return tbl8_idx;
 }
 
+static void
+tbl8_cleanup_and_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
+{
+	uint8_t *ptr = (uint8_t *)dp->tbl8 +
+		((tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT) << dp->nh_sz);
+
+	memset(ptr, 0, DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
+	tbl8_free_idx(dp, tbl8_idx);
+	dp->cur_tbl8s--;
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct dir24_8_tbl *dp = p;
+	uint32_t tbl8_idx = *(uint32_t *)data;
+
+	RTE_SET_USED(n);
+	tbl8_cleanup_and_free(dp, tbl8_idx);
+}
+
+static void
+tbl8_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
+{
+	uint32_t idx = tbl8_idx;
+
+	if (dp->v == NULL) {
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(dp->v,
+			RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, &idx) != 0) {
+			/*
+			 * The queue is sized to hold every tbl8,
+			 * so this can only happen on misconfiguration.
+			 * Fall back to the blocking mode.
+			 */
+			RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+			rte_rcu_qsbr_synchronize(dp->v,
+				RTE_QSBR_THRID_INVALID);
+			tbl8_cleanup_and_free(dp, tbl8_idx);
+		}
+	}
+}
+
 static void
 tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 {
@@ -210,8 +350,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint8_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr8[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_2B:
 		ptr16 = &((uint16_t *)dp->tbl8)[tbl8_idx *
@@ -223,8 +361,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint16_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr16[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_4B:
 		ptr32 = &((uint32_t *)dp->tbl8)[tbl8_idx *
@@ -236,8 +372,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint32_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr32[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_8B:
 		ptr64 = &((uint64_t *)dp->tbl8)[tbl8_idx *
@@ -249,12 +383,9 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint64_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr64[i] = 0;
 		break;
 	}
-	tbl8_free_idx(dp, tbl8_idx);
-	dp->cur_tbl8s--;
+	tbl8_free(dp, tbl8_idx);
 }
 
 static int
@@ -281,7 +412,7 @@ install_to_fib(struct dir24_8_tbl *dp, uint32_t ledge, uint32_t redge,
 				 * needs tbl8 for ledge and redge.
 				 */
 				tbl8_idx = tbl8_alloc(dp, tbl24_tmp);
-				tmp_tbl8_idx = tbl8_get_idx(dp);
+				tmp_tbl8_idx = tbl8_get(dp);
 				if (tbl8_idx < 0)
 					return -ENOSPC;
 				else if (tmp_tbl8_idx < 0) {
@@ -402,6 +533,269 @@ modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
 	return 0;
 }
 
+/*
+ * Record a prefix about to be modified, along with its route
+ * so that the modification can be rolled back.
+ */
+static int
+txn_add_prefix(struct dir24_8_tbl *dp, uint32_t ip, uint8_t depth,
+	struct rte_rib_node *node)
+{
+	struct dir24_8_txn_ent *ents;
+	uint32_t sz;
+
+	if (dp->txn_num == dp->txn_sz) {
+		sz = RTE_MAX(dp->txn_sz * 2, DIR24_8_TXN_MIN_SZ);
+		ents = rte_realloc(dp->txn_ents, sz * sizeof(*ents), 0);
+		if (ents == NULL)
+			return -ENOMEM;
+		dp->txn_ents = ents;
+		dp->txn_sz = sz;
+	}
+	dp->txn_ents[dp->txn_num].ip = ip;
+	dp->txn_ents[dp->txn_num].idx = dp->txn_num;
+	dp->txn_ents[dp->txn_num].depth = depth;
+	dp->txn_ents[dp->txn_num].present = (node != NULL);
+	dp->txn_ents[dp->txn_num].nh = 0;
+	if (node != NULL)
+		rte_rib_get_nh(node, &dp->txn_ents[dp->txn_num].nh);
+	dp->txn_num++;
+	return 0;
+}
+
+static int
+txn_prefix_cmp(const struct dir24_8_txn_ent *e1,
+	const struct dir24_8_txn_ent *e2)
+{
+	if (e1->ip != e2->ip)
+		return (e1->ip < e2->ip) ? -1 : 1;
+	return (int)e1->depth - (int)e2->depth;
+}
+
+static int
+txn_ent_cmp(const void *a, const void *b)
+{
+	const struct dir24_8_txn_ent *e1 = a;
+	const struct dir24_8_txn_ent *e2 = b;
+	int ret;
+
+	/* modifications of a prefix are kept in order */
+	ret = txn_prefix_cmp(e1, e2);
+	if (ret != 0)
+		return ret;
+	return (e1->idx < e2->idx) ? -1 : 1;
+}
+
+static inline int
+txn_ent_covers(const struct dir24_8_txn_ent *par,
+	const struct dir24_8_txn_ent *ent)
+{
+	return (par->depth <= ent->depth) &&
+		((ent->ip & rte_rib_depth_to_mask(par->depth)) == par->ip);
+}
+
+/*
+ * Find the most specific route less specific than ip/depth.
+ * Returns its depth or -1 if there is no such route.
+ */
+static int
+get_cover(struct rte_rib *rib, uint32_t ip, uint8_t depth, uint64_t *nh)
+{
+	struct rte_rib_node *node;
+	uint8_t node_depth;
+
+	node = rte_rib_lookup(rib, ip);
+	while (node != NULL) {
+		rte_rib_get_depth(node, &node_depth);
+		if (node_depth < depth) {
+			rte_rib_get_nh(node, nh);
+			return node_depth;
+		}
+		node = rte_rib_lookup_parent(node);
+	}
+	return -1;
+}
+
+static inline int
+has_long_routes(struct rte_rib *rib, uint32_t ip)
+{
+	return rte_rib_get_nxt(rib, ip & DIR24_8_TBL24_MASK, 24, NULL,
+		RTE_RIB_GET_NXT_COVER) != NULL;
+}
+
+/*
+ * Give back the tbl8 of the /24 containing ip, which has no route
+ * longer than 24 left, rewriting its tbl24 entry with the covering route.
+ */
+static void
+txn_release_tbl8(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip)
+{
+	uint64_t tbl24_tmp;
+	uint64_t nh = dp->def_nh;
+
+	ip &= DIR24_8_TBL24_MASK;
+	tbl24_tmp = get_tbl24(dp, ip, dp->nh_sz);
+	if ((tbl24_tmp & DIR24_8_EXT_ENT) != DIR24_8_EXT_ENT)
+		return;
+
+	get_cover(rib, ip, 25, &nh);
+	write_to_fib(get_tbl24_p(dp, ip, dp->nh_sz), nh << 1, dp->nh_sz, 1);
+	tbl8_free(dp, tbl24_tmp >> 1);
+}
+
+int
+dir24_8_txn_begin(struct dir24_8_tbl *dp)
+{
+	if (dp->txn_active)
+		return -EBUSY;
+
+	dp->txn_active = 1;
+	dp->txn_num = 0;
+	return 0;
+}
+
+/*
+ * Write the modified prefixes to the dataplane structure.
+ * Applies as much as possible and returns the first error.
+ */
+static int
+txn_apply(struct dir24_8_tbl *dp, struct rte_rib *rib)
+{
+	struct dir24_8_txn_ent *stack[RTE_FIB_MAXDEPTH + 1];
+	struct dir24_8_txn_ent *ent;
+	struct rte_rib_node *node;
+	uint64_t nh;
+	uint32_t i;
+	int top, ret, err;
+
+	/*
+	 * Deleted routes have already given back their reservations, so
+	 * release their tbl8s before the added routes allocate new ones.
+	 */
+	for (i = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		if ((ent->depth > 24) && !has_long_routes(rib, ent->ip))
+			txn_release_tbl8(dp, rib, ent->ip);
+	}
+
+	/*
+	 * Sort modified prefixes so that every prefix is preceded
+	 * by the modified prefixes covering it.
+	 */
+	qsort(dp->txn_ents, dp->txn_num, sizeof(*dp->txn_ents), txn_ent_cmp);
+
+	for (i = 0, top = -1, err = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		/* prefix modified several times is rebuilt once */
+		if ((i != 0) && (txn_prefix_cmp(ent, ent - 1) == 0))
+			continue;
+		while ((top >= 0) && !txn_ent_covers(stack[top], ent))
+			top--;
+
+		node = rte_rib_lookup_exact(rib, ent->ip, ent->depth);
+		if (node != NULL)
+			rte_rib_get_nh(node, &nh);
+		else {
+			/* its /24 has been rewritten while releasing tbl8 */
+			if ((ent->depth > 24) && !has_long_routes(rib, ent->ip))
+				continue;
+			nh = dp->def_nh;
+			/*
+			 * Removed prefix that is not hidden by a route more
+			 * specific than the closest modified prefix covering
+			 * it is rewritten while rebuilding that prefix.
+			 */
+			ret = get_cover(rib, ent->ip, ent->depth, &nh);
+			if ((top >= 0) && (ret <= (int)stack[top]->depth))
+				continue;
+		}
+
+		ret = modify_fib(dp, rib, ent->ip, ent->depth, nh);
+		if (ret != 0) {
+			if (err == 0)
+				err = ret;
+			continue;
+		}
+		stack[++top] = ent;
+	}
+
+	return err;
+}
+
+/*
+ * Put the routes of the sorted modified prefixes back
+ * as they were before their first modification.
+ */
+static void
+txn_rollback(struct dir24_8_tbl *dp, struct rte_rib *rib)
+{
+	struct dir24_8_txn_ent *ent;
+	struct rte_rib_node *node;
+	uint32_t i;
+
+	/* remove the added routes first to make room in the RIB */
+	for (i = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		if (((i != 0) && (txn_prefix_cmp(ent, ent - 1) == 0)) ||
+				ent->present)
+			continue;
+		if (rte_rib_lookup_exact(rib, ent->ip, ent->depth) == NULL)
+			continue;
+		rte_rib_remove(rib, ent->ip, ent->depth);
+		if ((ent->depth > 24) && !has_long_routes(rib, ent->ip))
+			dp->rsvd_tbl8s--;
+	}
+
+	for (i = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		if (((i != 0) && (txn_prefix_cmp(ent, ent - 1) == 0)) ||
+				!ent->present)
+			continue;
+		node = rte_rib_lookup_exact(rib, ent->ip, ent->depth);
+		if (node == NULL) {
+			if ((ent->depth > 24) && !has_long_routes(rib, ent->ip))
+				dp->rsvd_tbl8s++;
+			node = rte_rib_insert(rib, ent->ip, ent->depth);
+			if (node == NULL)
+				continue;
+		}
+		rte_rib_set_nh(node, ent->nh);
+	}
+}
+
+int
+dir24_8_txn_commit(struct rte_fib *fib)
+{
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	int ret;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (!dp->txn_active)
+		return -EINVAL;
+
+	ret = txn_apply(dp, rib);
+	if (ret != 0) {
+		/*
+		 * Restore the routes as they were before the transaction
+		 * and rebuild the prefixes it modified accordingly.
+		 * Should that fail as well, e.g. because the tbl8s freed
+		 * are still held by the RCU defer queue, the transaction
+		 * stays open for the commit to be retried.
+		 */
+		txn_rollback(dp, rib);
+		if (txn_apply(dp, rib) != 0)
+			return ret;
+	}
+
+	dp->txn_num = 0;
+	dp->txn_active = 0;
+	return ret;
+}
+
 int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op)
@@ -433,6 +827,12 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 			rte_rib_get_nh(node, &node_nh);
 			if (node_nh == next_hop)
 				return 0;
+			if (dp->txn_active) {
+				ret = txn_add_prefix(dp, ip, depth, node);
+				if (ret == 0)
+					rte_rib_set_nh(node, next_hop);
+				return ret;
+			}
 			ret = modify_fib(dp, rib, ip, depth, next_hop);
 			if (ret == 0)
 				rte_rib_set_nh(node, next_hop);
@@ -450,13 +850,17 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 		if (node == NULL)
 			return -rte_errno;
 		rte_rib_set_nh(node, next_hop);
-		parent = rte_rib_lookup_parent(node);
-		if (parent != NULL) {
-			rte_rib_get_nh(parent, &par_nh);
-			if (par_nh == next_hop)
-				return 0;
+		if (dp->txn_active)
+			ret = txn_add_prefix(dp, ip, depth, NULL);
+		else {
+			parent = rte_rib_lookup_parent(node);
+			if (parent != NULL) {
+				rte_rib_get_nh(parent, &par_nh);
+				if (par_nh == next_hop)
+					return 0;
+			}
+			ret = modify_fib(dp, rib, ip, depth, next_hop);
 		}
-		ret = modify_fib(dp, rib, ip, depth, next_hop);
 		if (ret != 0) {
 			rte_rib_remove(rib, ip, depth);
 			return ret;
@@ -468,14 +872,20 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 		if (node == NULL)
 			return -ENOENT;
 
-		parent = rte_rib_lookup_parent(node);
-		if (parent != NULL) {
-			rte_rib_get_nh(parent, &par_nh);
-			rte_rib_get_nh(node, &node_nh);
-			if (par_nh != node_nh)
-				ret = modify_fib(dp, rib, ip, depth, par_nh);
-		} else
-			ret = modify_fib(dp, rib, ip, depth, dp->def_nh);
+		if (dp->txn_active)
+			ret = txn_add_prefix(dp, ip, depth, node);
+		else {
+			parent = rte_rib_lookup_parent(node);
+			if (parent != NULL) {
+				rte_rib_get_nh(parent, &par_nh);
+				rte_rib_get_nh(node, &node_nh);
+				if (par_nh != node_nh)
+					ret = modify_fib(dp, rib, ip, depth,
+						par_nh);
+			} else
+				ret = modify_fib(dp, rib, ip, depth,
+					dp->def_nh);
+		}
 		if (ret == 0) {
 			rte_rib_remove(rib, ip, depth);
 			if (depth > 24) {
@@ -563,7 +973,59 @@ dir24_8_free(void *p)
 {
 	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
 
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
+	rte_free(dp->txn_ents);
 	rte_free(dp->tbl8_idxes);
 	rte_free(dp->tbl8);
 	rte_free(dp);
 }
+
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if ((dp == NULL) || (cfg == NULL) || (cfg->v == NULL))
+		return -EINVAL;
+
+	if (dp->v != NULL)
+		return -EEXIST;
+
+	switch (cfg->mode) {
+	case RTE_FIB_QSBR_MODE_DQ:
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+			"FIB_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = dp->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 group index */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB defer queue creation failed\n");
+			return -rte_errno;
+		}
+		break;
+	case RTE_FIB_QSBR_MODE_SYNC:
+		/* No other things to do. */
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
@@ -23,6 +23,15 @@
 #define BITMAP_SLAB_BIT_SIZE		(1 << BITMAP_SLAB_BIT_SIZE_LOG2)
 #define BITMAP_SLAB_BITMASK		(BITMAP_SLAB_BIT_SIZE - 1)
 
+/* prefix modified within a transaction */
+struct dir24_8_txn_ent {
+	uint32_t	ip;
+	uint32_t	idx;	/**< Order of the modification */
+	uint64_t	nh;	/**< Next hop before the modification */
+	uint8_t		depth;
+	uint8_t		present; /**< Route existed before the modification */
+};
+
 struct dir24_8_tbl {
 	uint32_t	number_tbl8s;	/**< Total number of tbl8s */
 	uint32_t	rsvd_tbl8s;	/**< Number of reserved tbl8s */
@@ -31,6 +40,15 @@ struct dir24_8_tbl {
 	uint64_t	def_nh;		/**< Default next hop */
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint64_t	*tbl8_idxes;	/**< bitmap containing free tbl8 idxes*/
+	/* RCU config. */
+	enum rte_fib_qsbr_mode	rcu_mode;	/**< Blocking, defer queue. */
+	struct rte_rcu_qsbr	*v;		/**< RCU QSBR variable. */
+	struct rte_rcu_qsbr_dq	*dq;		/**< RCU QSBR defer queue. */
+	/* Transaction state. */
+	uint32_t	txn_active;	/**< Transaction is open */
+	uint32_t	txn_num;	/**< Number of modified prefixes */
+	uint32_t	txn_sz;		/**< Size of txn_ents array */
+	struct dir24_8_txn_ent	*txn_ents;	/**< Modified prefixes */
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -248,4 +266,14 @@ int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op);
 
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name);
+
+int
+dir24_8_txn_begin(struct dir24_8_tbl *dp);
+
+int
+dir24_8_txn_commit(struct rte_fib *fib);
+
 #endif /* _DIR24_8_H_ */
@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_fib.h>
+
+#include "dir24_8.h"
+#include "dir24_8_neon.h"
+
+static __rte_always_inline uint32_t
+get_ent(const uint64_t *tbl, uint32_t idx, int size)
+{
+	if (size == sizeof(uint8_t))
+		return ((const uint8_t *)tbl)[idx];
+	else if (size == sizeof(uint16_t))
+		return ((const uint16_t *)tbl)[idx];
+	return ((const uint32_t *)tbl)[idx];
+}
+
+static __rte_always_inline void
+dir24_8_neon_lookup_x4(void *p, const uint32_t *ips,
+	uint64_t *next_hops, int size)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	const uint32x4_t lsb = vdupq_n_u32(1);
+	const uint32x4_t lsbyte_msk = vdupq_n_u32(UINT8_MAX);
+	uint32x4_t ip_vec, idxes, res, msk_ext;
+	uint32_t idx[4], ent[4];
+	int j;
+
+	ip_vec = vld1q_u32(ips);
+	/* get 4 indexes for tbl24[] */
+	idxes = vshrq_n_u32(ip_vec, 8);
+	vst1q_u32(idx, idxes);
+
+	/* no gather in NEON, extract values from tbl24[] lane by lane */
+	for (j = 0; j < 4; j++)
+		ent[j] = get_ent(dp->tbl24, idx[j], size);
+	res = vld1q_u32(ent);
+
+	/* get extended entries indexes */
+	msk_ext = vtstq_u32(res, lsb);
+
+	if (vmaxvq_u32(msk_ext) != 0) {
+		idxes = vshrq_n_u32(res, 1);
+		idxes = vshlq_n_u32(idxes, 8);
+		idxes = vaddq_u32(idxes, vandq_u32(ip_vec, lsbyte_msk));
+		vst1q_u32(idx, idxes);
+		for (j = 0; j < 4; j++) {
+			if (ent[j] & DIR24_8_EXT_ENT)
+				ent[j] = get_ent(dp->tbl8, idx[j], size);
+		}
+		res = vld1q_u32(ent);
+	}
+
+	res = vshrq_n_u32(res, 1);
+	vst1q_u64(next_hops, vmovl_u32(vget_low_u32(res)));
+	vst1q_u64(next_hops + 2, vmovl_u32(vget_high_u32(res)));
+}
+
+static __rte_always_inline void
+dir24_8_neon_lookup_x4_8b(void *p, const uint32_t *ips,
+	uint64_t *next_hops)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	const uint32x4_t lsbyte_msk = vdupq_n_u32(UINT8_MAX);
+	uint32x4_t ip_vec, bytes;
+	uint64x2_t res_lo, res_hi;
+	uint32_t idx[4], byte[4];
+	uint64_t ent[4];
+	int j;
+
+	ip_vec = vld1q_u32(ips);
+	/* get 4 indexes for tbl24[] */
+	vst1q_u32(idx, vshrq_n_u32(ip_vec, 8));
+	bytes = vandq_u32(ip_vec, lsbyte_msk);
+	vst1q_u32(byte, bytes);
+
+	for (j = 0; j < 4; j++)
+		ent[j] = dp->tbl24[idx[j]];
+	for (j = 0; j < 4; j++) {
+		if (ent[j] & DIR24_8_EXT_ENT)
+			ent[j] = dp->tbl8[((ent[j] >> 1) *
+				DIR24_8_TBL8_GRP_NUM_ENT) + byte[j]];
+	}
+
+	res_lo = vshrq_n_u64(vld1q_u64(&ent[0]), 1);
+	res_hi = vshrq_n_u64(vld1q_u64(&ent[2]), 1);
+	vst1q_u64(next_hops, res_lo);
+	vst1q_u64(next_hops + 2, res_hi);
+}
+
+void
+rte_dir24_8_neon_lookup_bulk_1b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 4); i++)
+		dir24_8_neon_lookup_x4(p, ips + i * 4, next_hops + i * 4,
+			sizeof(uint8_t));
+
+	dir24_8_lookup_bulk_1b(p, ips + i * 4, next_hops + i * 4, n - i * 4);
+}
+
+void
+rte_dir24_8_neon_lookup_bulk_2b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 4); i++)
+		dir24_8_neon_lookup_x4(p, ips + i * 4, next_hops + i * 4,
+			sizeof(uint16_t));
+
+	dir24_8_lookup_bulk_2b(p, ips + i * 4, next_hops + i * 4, n - i * 4);
+}
+
+void
+rte_dir24_8_neon_lookup_bulk_4b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 4); i++)
+		dir24_8_neon_lookup_x4(p, ips + i * 4, next_hops + i * 4,
+			sizeof(uint32_t));
+
+	dir24_8_lookup_bulk_4b(p, ips + i * 4, next_hops + i * 4, n - i * 4);
+}
+
+void
+rte_dir24_8_neon_lookup_bulk_8b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 4); i++)
+		dir24_8_neon_lookup_x4_8b(p, ips + i * 4, next_hops + i * 4);
+
+	dir24_8_lookup_bulk_8b(p, ips + i * 4, next_hops + i * 4, n - i * 4);
+}
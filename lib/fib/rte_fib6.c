@@ -335,3 +335,95 @@ rte_fib6_select_lookup(struct rte_fib6 *fib,
 		return -EINVAL;
 	}
 }
+
+int
+rte_fib6_rcu_qsbr_add(struct rte_fib6 *fib, struct rte_fib6_rcu_config *cfg)
+{
+	if ((fib == NULL) || (cfg == NULL))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		return trie_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+int
+rte_fib6_txn_begin(struct rte_fib6 *fib)
+{
+	if (fib == NULL)
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		return trie_txn_begin(fib->dp);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+int
+rte_fib6_txn_commit(struct rte_fib6 *fib)
+{
+	if (fib == NULL)
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		return trie_txn_commit(fib);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+static int
+fib6_modify_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n, int op)
+{
+	unsigned int i;
+	int ret, commit_ret, own_txn;
+
+	/* open a transaction unless the caller already did */
+	own_txn = (rte_fib6_txn_begin(fib) == 0);
+
+	for (i = 0, ret = 0; (i < n) && (ret == 0); i++) {
+		if (depths[i] > RTE_FIB6_MAXDEPTH)
+			ret = -EINVAL;
+		else
+			ret = fib->modify(fib, ips[i], depths[i],
+				(next_hops != NULL) ? next_hops[i] : 0, op);
+	}
+
+	/* a failed commit rolls the whole batch back */
+	if (own_txn) {
+		commit_ret = rte_fib6_txn_commit(fib);
+		if (ret == 0)
+			ret = commit_ret;
+	}
+	return ret;
+}
+
+int
+rte_fib6_add_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n)
+{
+	if ((fib == NULL) || (fib->modify == NULL) || (ips == NULL) ||
+			(depths == NULL) || (next_hops == NULL))
+		return -EINVAL;
+	return fib6_modify_bulk(fib, ips, depths, next_hops, n, RTE_FIB6_ADD);
+}
+
+int
+rte_fib6_delete_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	unsigned int n)
+{
+	if ((fib == NULL) || (fib->modify == NULL) || (ips == NULL) ||
+			(depths == NULL))
+		return -EINVAL;
+	return fib6_modify_bulk(fib, ips, depths, NULL, n, RTE_FIB6_DEL);
+}
@@ -17,6 +17,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,6 +28,9 @@ extern "C" {
 /** Maximum depth value possible for IPv6 FIB. */
 #define RTE_FIB6_MAXDEPTH       128
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_FIB6_RCU_DQ_RECLAIM_MAX	16
+
 struct rte_fib6;
 struct rte_rib6;
 
@@ -49,6 +54,14 @@ enum rte_fib6_op {
 	RTE_FIB6_DEL,
 };
 
+/** RCU reclamation modes */
+enum rte_fib6_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_FIB6_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_FIB6_QSBR_MODE_SYNC
+};
+
 /** Size of nexthop (1 << nh_sz) bits for TRIE based FIB */
 enum rte_fib_trie_nh_sz {
 	RTE_FIB6_TRIE_2B = 1,
@@ -61,7 +74,8 @@ enum rte_fib6_lookup_type {
 	RTE_FIB6_LOOKUP_DEFAULT,
 	/**< Selects the best implementation based on the max simd bitwidth */
 	RTE_FIB6_LOOKUP_TRIE_SCALAR, /**< Scalar lookup function implementation*/
-	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512 /**< Vector implementation using AVX512 */
+	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512, /**< Vector implementation using AVX512 */
+	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX2 /**< Vector implementation using AVX2 */
 };
 
 /** FIB configuration structure */
@@ -80,6 +94,22 @@ struct rte_fib6_conf {
 	};
 };
 
+/** FIB6 RCU QSBR configuration structure. */
+struct rte_fib6_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_FIB6_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_fib6_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: trie.num_tbl8.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_FIB6_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Create FIB
  *
@@ -215,6 +245,146 @@ rte_fib6_get_rib(struct rte_fib6 *fib);
 int
 rte_fib6_select_lookup(struct rte_fib6 *fib, enum rte_fib6_lookup_type type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a FIB6 object.
+ *
+ * Once associated, tbl8 groups released by route updates are not reused
+ * until all the registered readers have reported a quiescent state,
+ * so that lookups may run concurrently with route updates.
+ * Only RTE_FIB6_TRIE type is supported.
+ *
+ * @param fib
+ *   FIB6 object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL for incorrect arguments
+ *   -EEXIST if a QSBR variable is already associated
+ *   -ENOTSUP if the FIB type does not support RCU
+ *   -ENOMEM on defer queue allocation failure
+ */
+__rte_experimental
+int
+rte_fib6_rcu_qsbr_add(struct rte_fib6 *fib, struct rte_fib6_rcu_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Open a route update transaction.
+ *
+ * While the transaction is open rte_fib6_add() and rte_fib6_delete() only
+ * update the RIB, the dataplane structure is left untouched and lookups
+ * keep returning the results they returned before the transaction was
+ * opened. The modifications are applied to the dataplane structure by
+ * rte_fib6_txn_commit(), every affected table entry being written once
+ * regardless of the number of overlapping routes modified.
+ * The tbl8 groups are still reserved by every update, so when they run
+ * short the deletions should be made before the additions.
+ * Only RTE_FIB6_TRIE type is supported.
+ *
+ * @param fib
+ *   FIB object handle
+ * @return
+ *   0 on success
+ *   -EINVAL for incorrect arguments
+ *   -EBUSY if a transaction is already open
+ *   -ENOTSUP if the FIB type does not support transactions
+ */
+__rte_experimental
+int
+rte_fib6_txn_begin(struct rte_fib6 *fib);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Apply the route updates made since rte_fib6_txn_begin() to the
+ * dataplane structure and close the transaction.
+ *
+ * Every table entry is updated atomically, so concurrent lookups return
+ * either the old or the new next hop, but the transaction as a whole
+ * is not published atomically.
+ * If an update can not be applied, the RIB is rolled back to its state
+ * before the transaction, the dataplane structure is rebuilt accordingly
+ * and the transaction is closed, so both keep agreeing. Should the
+ * rebuild fail as well, e.g. because the released tbl8 groups are still
+ * held by the RCU defer queue, the transaction stays open and the commit
+ * must be called again to resynchronize the dataplane structure with the
+ * rolled back RIB.
+ *
+ * @param fib
+ *   FIB object handle
+ * @return
+ *   0 on success
+ *   -EINVAL for incorrect arguments or if no transaction is open
+ *   -ENOTSUP if the FIB type does not support transactions
+ *   -ENOSPC if there are not enough tbl8 groups
+ */
+__rte_experimental
+int
+rte_fib6_txn_commit(struct rte_fib6 *fib);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a batch of routes to the FIB.
+ *
+ * If no transaction is open, the routes are added within a transaction
+ * committed before return, otherwise they become part of the caller's
+ * transaction. Processing stops at the first route that can not be
+ * added, the routes preceding it stay added. If the commit fails, none
+ * of the routes is added.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of prefixes
+ * @param depths
+ *   Array of prefix lengths
+ * @param next_hops
+ *   Array of next hops
+ * @param n
+ *   Number of routes
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib6_add_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete a batch of routes from the FIB.
+ *
+ * Follows the same transaction rules as rte_fib6_add_bulk().
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of prefixes
+ * @param depths
+ *   Array of prefix lengths
+ * @param n
+ *   Number of routes
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib6_delete_bulk(struct rte_fib6 *fib,
+	const uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	unsigned int n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,10 +5,14 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <rte_debug.h>
+#include <rte_log.h>
 #include <rte_malloc.h>
 #include <rte_errno.h>
+#include <rte_rcu_qsbr.h>
 
 #include <rte_rib6.h>
 #include <rte_fib6.h>
@@ -20,7 +24,14 @@
 
 #endif /* CC_TRIE_AVX512_SUPPORT */
 
+#ifdef CC_TRIE_AVX2_SUPPORT
+
+#include "trie_avx2.h"
+
+#endif /* CC_TRIE_AVX2_SUPPORT */
+
 #define TRIE_NAMESIZE		64
+#define TRIE_TXN_MIN_SZ		64U
 
 enum edge {
 	LEDGE,
@@ -65,6 +76,29 @@ get_vector_fn(enum rte_fib_trie_nh_sz nh_sz)
 	return NULL;
 }
 
+static inline rte_fib6_lookup_fn_t
+get_vector_fn_avx2(enum rte_fib_trie_nh_sz nh_sz)
+{
+#ifdef CC_TRIE_AVX2_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_256))
+		return NULL;
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return rte_trie_avx2_lookup_bulk_2b;
+	case RTE_FIB6_TRIE_4B:
+		return rte_trie_avx2_lookup_bulk_4b;
+	case RTE_FIB6_TRIE_8B:
+		return rte_trie_avx2_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(nh_sz);
+#endif
+	return NULL;
+}
+
 rte_fib6_lookup_fn_t
 trie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
 {
@@ -82,8 +116,12 @@ trie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
 		return get_scalar_fn(nh_sz);
 	case RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512:
 		return get_vector_fn(nh_sz);
+	case RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX2:
+		return get_vector_fn_avx2(nh_sz);
 	case RTE_FIB6_LOOKUP_DEFAULT:
 		ret_fn = get_vector_fn(nh_sz);
+		if (ret_fn == NULL)
+			ret_fn = get_vector_fn_avx2(nh_sz);
 		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(nh_sz);
 	default:
 		return NULL;
@@ -157,6 +195,12 @@ tbl8_alloc(struct rte_trie_tbl *dp, uint64_t nh)
 	uint8_t		*tbl8_ptr;
 
 	tbl8_idx = tbl8_get(dp);
+	if ((tbl8_idx == -ENOSPC) && (dp->dq != NULL)) {
+		/* If there are no tbl8 groups try to reclaim one. */
+		if (rte_rcu_qsbr_dq_reclaim(dp->dq, 1,
+				NULL, NULL, NULL) == 0)
+			tbl8_idx = tbl8_get(dp);
+	}
 	if (tbl8_idx < 0)
 		return tbl8_idx;
 	tbl8_ptr = get_tbl_p_by_idx(dp->tbl8,
@@ -164,9 +208,59 @@ tbl8_alloc(struct rte_trie_tbl *dp, uint64_t nh)
 	/*Init tbl8 entries with nexthop from tbl24*/
 	write_to_dp((void *)tbl8_ptr, nh, dp->nh_sz,
 		TRIE_TBL8_GRP_NUM_ENT);
+	/* tbl8 must be initialized before it is linked into the trie */
+	rte_atomic_thread_fence(__ATOMIC_RELEASE);
 	return tbl8_idx;
 }
 
+static void
+tbl8_cleanup_and_free(struct rte_trie_tbl *dp, uint64_t tbl8_idx)
+{
+	uint8_t *ptr = (uint8_t *)dp->tbl8 +
+		((tbl8_idx * TRIE_TBL8_GRP_NUM_ENT) << dp->nh_sz);
+
+	memset(ptr, 0, TRIE_TBL8_GRP_NUM_ENT << dp->nh_sz);
+	tbl8_put(dp, tbl8_idx);
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct rte_trie_tbl *dp = p;
+	uint32_t tbl8_idx = *(uint32_t *)data;
+
+	RTE_SET_USED(n);
+	tbl8_cleanup_and_free(dp, tbl8_idx);
+}
+
+static void
+tbl8_free(struct rte_trie_tbl *dp, uint64_t tbl8_idx)
+{
+	uint32_t idx = tbl8_idx;
+
+	if (dp->v == NULL) {
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB6_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(dp->v,
+			RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB6_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, &idx) != 0) {
+			/*
+			 * The queue is sized to hold every tbl8,
+			 * so this can only happen on misconfiguration.
+			 * Fall back to the blocking mode.
+			 */
+			RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+			rte_rcu_qsbr_synchronize(dp->v,
+				RTE_QSBR_THRID_INVALID);
+			tbl8_cleanup_and_free(dp, tbl8_idx);
+		}
+	}
+}
+
 static void
 tbl8_recycle(struct rte_trie_tbl *dp, void *par, uint64_t tbl8_idx)
 {
@@ -188,8 +282,6 @@ tbl8_recycle(struct rte_trie_tbl *dp, void *par, uint64_t tbl8_idx)
 				return;
 		}
 		write_to_dp(par, nh, dp->nh_sz, 1);
-		for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++)
-			ptr16[i] = 0;
 		break;
 	case RTE_FIB6_TRIE_4B:
 		ptr32 = &((uint32_t *)dp->tbl8)[tbl8_idx *
@@ -202,8 +294,6 @@ tbl8_recycle(struct rte_trie_tbl *dp, void *par, uint64_t tbl8_idx)
 				return;
 		}
 		write_to_dp(par, nh, dp->nh_sz, 1);
-		for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++)
-			ptr32[i] = 0;
 		break;
 	case RTE_FIB6_TRIE_8B:
 		ptr64 = &((uint64_t *)dp->tbl8)[tbl8_idx *
@@ -216,11 +306,9 @@ tbl8_recycle(struct rte_trie_tbl *dp, void *par, uint64_t tbl8_idx)
 				return;
 		}
 		write_to_dp(par, nh, dp->nh_sz, 1);
-		for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++)
-			ptr64[i] = 0;
 		break;
 	}
-	tbl8_put(dp, tbl8_idx);
+	tbl8_free(dp, tbl8_idx);
 }
 
 #define BYTE_SIZE	8
@@ -343,7 +431,13 @@ write_edge(struct rte_trie_tbl *dp, const uint8_t *ip_part, uint64_t next_hop,
 				TRIE_TBL8_GRP_NUM_ENT, dp->nh_sz),
 				next_hop << 1, dp->nh_sz, *ip_part);
 		}
-		tbl8_recycle(dp, &val, tbl8_idx);
+		/*
+		 * Link the tbl8 into its parent before trying to recycle it,
+		 * so that a freed tbl8 is never reachable by readers.
+		 */
+		write_to_dp(ent, val, dp->nh_sz, 1);
+		tbl8_recycle(dp, ent, tbl8_idx);
+		return ret;
 	}
 
 	write_to_dp(ent, val, dp->nh_sz, 1);
@@ -499,19 +593,364 @@ modify_dp(struct rte_trie_tbl *dp, struct rte_rib6 *rib,
 	return 0;
 }
 
+/*
+ * Record a prefix about to be modified, along with its route
+ * so that the modification can be rolled back.
+ */
+static int
+txn_add_prefix(struct rte_trie_tbl *dp,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth,
+	struct rte_rib6_node *node)
+{
+	struct trie_txn_ent *ents;
+	uint32_t sz;
+
+	if (dp->txn_num == dp->txn_sz) {
+		sz = RTE_MAX(dp->txn_sz * 2, TRIE_TXN_MIN_SZ);
+		ents = rte_realloc(dp->txn_ents, sz * sizeof(*ents), 0);
+		if (ents == NULL)
+			return -ENOMEM;
+		dp->txn_ents = ents;
+		dp->txn_sz = sz;
+	}
+	rte_rib6_copy_addr(dp->txn_ents[dp->txn_num].ip, ip);
+	dp->txn_ents[dp->txn_num].idx = dp->txn_num;
+	dp->txn_ents[dp->txn_num].depth = depth;
+	dp->txn_ents[dp->txn_num].present = (node != NULL);
+	dp->txn_ents[dp->txn_num].nh = 0;
+	if (node != NULL)
+		rte_rib6_get_nh(node, &dp->txn_ents[dp->txn_num].nh);
+	dp->txn_num++;
+	return 0;
+}
+
+static int
+txn_prefix_cmp(const struct trie_txn_ent *e1, const struct trie_txn_ent *e2)
+{
+	int ret;
+
+	ret = memcmp(e1->ip, e2->ip, RTE_FIB6_IPV6_ADDR_SIZE);
+	if (ret != 0)
+		return ret;
+	return (int)e1->depth - (int)e2->depth;
+}
+
+static int
+txn_ent_cmp(const void *a, const void *b)
+{
+	const struct trie_txn_ent *e1 = a;
+	const struct trie_txn_ent *e2 = b;
+	int ret;
+
+	/* modifications of a prefix are kept in order */
+	ret = txn_prefix_cmp(e1, e2);
+	if (ret != 0)
+		return ret;
+	return (e1->idx < e2->idx) ? -1 : 1;
+}
+
+static inline int
+txn_ent_covers(const struct trie_txn_ent *par, const struct trie_txn_ent *ent)
+{
+	int i;
+
+	if (par->depth > ent->depth)
+		return 0;
+	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
+		if ((ent->ip[i] & get_msk_part(par->depth, i)) != par->ip[i])
+			return 0;
+	return 1;
+}
+
+/*
+ * Find the most specific route less specific than ip/depth.
+ * Returns its depth or -1 if there is no such route.
+ */
+static int
+get_cover(struct rte_rib6 *rib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t *nh)
+{
+	struct rte_rib6_node *node;
+	uint8_t node_depth;
+
+	node = rte_rib6_lookup(rib, ip);
+	while (node != NULL) {
+		rte_rib6_get_depth(node, &node_depth);
+		if (node_depth < depth) {
+			rte_rib6_get_nh(node, nh);
+			return node_depth;
+		}
+		node = rte_rib6_lookup_parent(node);
+	}
+	return -1;
+}
+
+/*
+ * Find the shortest tbl8 level not shorter than 24 and shorter than depth
+ * that has no route more specific than it around ip.
+ * Returns that level or 0 if every level is still in use.
+ */
+static uint8_t
+get_unused_level(struct rte_rib6 *rib,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	uint8_t ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t level;
+	int i;
+
+	for (level = 24; level < depth; level += 8) {
+		for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
+			ip_masked[i] = ip[i] & get_msk_part(level, i);
+		if (rte_rib6_get_nxt(rib, ip_masked, level, NULL,
+				RTE_RIB6_GET_NXT_COVER) == NULL)
+			return level;
+	}
+	return 0;
+}
+
+static void
+tbl8_free_tree(struct rte_trie_tbl *dp, uint64_t tbl8_idx)
+{
+	uint64_t val;
+	uint32_t i;
+
+	for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++) {
+		val = get_tbl_val_by_idx(dp->tbl8,
+			tbl8_idx * TRIE_TBL8_GRP_NUM_ENT + i, dp->nh_sz);
+		if (is_entry_extended(val))
+			tbl8_free_tree(dp, val >> 1);
+	}
+	tbl8_free(dp, tbl8_idx);
+}
+
+/*
+ * Give back the tbl8s below the given level around ip, which has no route
+ * more specific than the level left, rewriting the entry pointing to them
+ * with the covering route.
+ */
+static void
+txn_release_tbl8(struct rte_trie_tbl *dp, struct rte_rib6 *rib,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t level)
+{
+	uint8_t ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t val, nh = dp->def_nh;
+	void *ent;
+	int i;
+
+	ent = get_tbl24_p(dp, ip, dp->nh_sz);
+	val = get_val_by_p(ent, dp->nh_sz);
+	for (i = TBL24_BYTES; i < level / BYTE_SIZE; i++) {
+		if (!is_entry_extended(val))
+			return;
+		ent = get_tbl_p_by_idx(dp->tbl8, (val >> 1) *
+			TRIE_TBL8_GRP_NUM_ENT + ip[i], dp->nh_sz);
+		val = get_val_by_p(ent, dp->nh_sz);
+	}
+	if (!is_entry_extended(val))
+		return;
+
+	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
+		ip_masked[i] = ip[i] & get_msk_part(level, i);
+	get_cover(rib, ip_masked, level + 1, &nh);
+	write_to_dp(ent, nh << 1, dp->nh_sz, 1);
+	tbl8_free_tree(dp, val >> 1);
+}
+
+int
+trie_txn_begin(struct rte_trie_tbl *dp)
+{
+	if (dp->txn_active)
+		return -EBUSY;
+
+	dp->txn_active = 1;
+	dp->txn_num = 0;
+	return 0;
+}
+
+/*
+ * Number of tbl8s a route not present in the RIB
+ * needs on top of the routes around it.
+ */
+static uint8_t
+get_depth_diff(struct rte_rib6 *rib,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	struct rte_rib6_node *tmp;
+	uint8_t tmp_depth, parent_depth = 24;
+
+	if (depth <= 24)
+		return 0;
+
+	tmp = rte_rib6_get_nxt(rib, ip, RTE_ALIGN_FLOOR(depth, 8), NULL,
+		RTE_RIB6_GET_NXT_COVER);
+	if (tmp != NULL)
+		return 0;
+
+	tmp = rte_rib6_lookup(rib, ip);
+	if (tmp != NULL) {
+		rte_rib6_get_depth(tmp, &tmp_depth);
+		parent_depth = RTE_MAX(tmp_depth, 24);
+	}
+	return (RTE_ALIGN_CEIL(depth, 8) - RTE_ALIGN_CEIL(parent_depth, 8)) >> 3;
+}
+
+/*
+ * Write the modified prefixes to the dataplane structure.
+ * Applies as much as possible and returns the first error.
+ */
+static int
+txn_apply(struct rte_trie_tbl *dp, struct rte_rib6 *rib)
+{
+	struct trie_txn_ent *stack[RTE_FIB6_MAXDEPTH + 1];
+	struct trie_txn_ent *ent;
+	struct rte_rib6_node *node;
+	uint64_t nh;
+	uint32_t i;
+	int top, ret, err;
+	uint8_t level;
+
+	/*
+	 * Deleted routes have already given back their reservations, so
+	 * release their tbl8s before the added routes allocate new ones.
+	 */
+	for (i = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		level = get_unused_level(rib, ent->ip, ent->depth);
+		if (level != 0)
+			txn_release_tbl8(dp, rib, ent->ip, level);
+	}
+
+	/*
+	 * Sort modified prefixes so that every prefix is preceded
+	 * by the modified prefixes covering it.
+	 */
+	qsort(dp->txn_ents, dp->txn_num, sizeof(*dp->txn_ents), txn_ent_cmp);
+
+	for (i = 0, top = -1, err = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		/* prefix modified several times is rebuilt once */
+		if ((i != 0) && (txn_prefix_cmp(ent, ent - 1) == 0))
+			continue;
+		while ((top >= 0) && !txn_ent_covers(stack[top], ent))
+			top--;
+
+		node = rte_rib6_lookup_exact(rib, ent->ip, ent->depth);
+		if (node != NULL)
+			rte_rib6_get_nh(node, &nh);
+		else {
+			/* it has been rewritten while releasing tbl8s */
+			if (get_unused_level(rib, ent->ip, ent->depth) != 0)
+				continue;
+			nh = dp->def_nh;
+			/*
+			 * Removed prefix that is not hidden by a route more
+			 * specific than the closest modified prefix covering
+			 * it is rewritten while rebuilding that prefix.
+			 */
+			ret = get_cover(rib, ent->ip, ent->depth, &nh);
+			if ((top >= 0) && (ret <= (int)stack[top]->depth))
+				continue;
+		}
+
+		ret = modify_dp(dp, rib, ent->ip, ent->depth, nh);
+		if (ret != 0) {
+			if (err == 0)
+				err = ret;
+			continue;
+		}
+		stack[++top] = ent;
+	}
+
+	return err;
+}
+
+/*
+ * Put the routes of the sorted modified prefixes back
+ * as they were before their first modification.
+ */
+static void
+txn_rollback(struct rte_trie_tbl *dp, struct rte_rib6 *rib)
+{
+	struct trie_txn_ent *ent;
+	struct rte_rib6_node *node;
+	uint8_t depth_diff;
+	uint32_t i;
+
+	/* remove the added routes first to make room in the RIB */
+	for (i = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		if (((i != 0) && (txn_prefix_cmp(ent, ent - 1) == 0)) ||
+				ent->present)
+			continue;
+		if (rte_rib6_lookup_exact(rib, ent->ip, ent->depth) == NULL)
+			continue;
+		rte_rib6_remove(rib, ent->ip, ent->depth);
+		dp->rsvd_tbl8s -= get_depth_diff(rib, ent->ip, ent->depth);
+	}
+
+	for (i = 0; i < dp->txn_num; i++) {
+		ent = &dp->txn_ents[i];
+		if (((i != 0) && (txn_prefix_cmp(ent, ent - 1) == 0)) ||
+				!ent->present)
+			continue;
+		node = rte_rib6_lookup_exact(rib, ent->ip, ent->depth);
+		if (node == NULL) {
+			depth_diff = get_depth_diff(rib, ent->ip, ent->depth);
+			node = rte_rib6_insert(rib, ent->ip, ent->depth);
+			if (node == NULL)
+				continue;
+			dp->rsvd_tbl8s += depth_diff;
+		}
+		rte_rib6_set_nh(node, ent->nh);
+	}
+}
+
+int
+trie_txn_commit(struct rte_fib6 *fib)
+{
+	struct rte_trie_tbl *dp;
+	struct rte_rib6 *rib;
+	int ret;
+
+	dp = rte_fib6_get_dp(fib);
+	RTE_ASSERT(dp);
+	rib = rte_fib6_get_rib(fib);
+	RTE_ASSERT(rib);
+
+	if (!dp->txn_active)
+		return -EINVAL;
+
+	ret = txn_apply(dp, rib);
+	if (ret != 0) {
+		/*
+		 * Restore the routes as they were before the transaction
+		 * and rebuild the prefixes it modified accordingly.
+		 * Should that fail as well, e.g. because the tbl8s freed
+		 * are still held by the RCU defer queue, the transaction
+		 * stays open for the commit to be retried.
+		 */
+		txn_rollback(dp, rib);
+		if (txn_apply(dp, rib) != 0)
+			return ret;
+	}
+
+	dp->txn_num = 0;
+	dp->txn_active = 0;
+	return ret;
+}
+
 int
 trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	uint8_t depth, uint64_t next_hop, int op)
 {
 	struct rte_trie_tbl *dp;
 	struct rte_rib6 *rib;
-	struct rte_rib6_node *tmp = NULL;
 	struct rte_rib6_node *node;
 	struct rte_rib6_node *parent;
 	uint8_t	ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
 	int i, ret = 0;
 	uint64_t par_nh, node_nh;
-	uint8_t tmp_depth, depth_diff = 0, parent_depth = 24;
+	uint8_t depth_diff;
 
 	if ((fib == NULL) || (ip == NULL) || (depth > RTE_FIB6_MAXDEPTH))
 		return -EINVAL;
@@ -524,21 +963,6 @@ trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
 		ip_masked[i] = ip[i] & get_msk_part(depth, i);
 
-	if (depth > 24) {
-		tmp = rte_rib6_get_nxt(rib, ip_masked,
-			RTE_ALIGN_FLOOR(depth, 8), NULL,
-			RTE_RIB6_GET_NXT_COVER);
-		if (tmp == NULL) {
-			tmp = rte_rib6_lookup(rib, ip);
-			if (tmp != NULL) {
-				rte_rib6_get_depth(tmp, &tmp_depth);
-				parent_depth = RTE_MAX(tmp_depth, 24);
-			}
-			depth_diff = RTE_ALIGN_CEIL(depth, 8) -
-				RTE_ALIGN_CEIL(parent_depth, 8);
-			depth_diff = depth_diff >> 3;
-		}
-	}
 	node = rte_rib6_lookup_exact(rib, ip_masked, depth);
 	switch (op) {
 	case RTE_FIB6_ADD:
@@ -546,12 +970,20 @@ trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 			rte_rib6_get_nh(node, &node_nh);
 			if (node_nh == next_hop)
 				return 0;
+			if (dp->txn_active) {
+				ret = txn_add_prefix(dp, ip_masked, depth,
+					node);
+				if (ret == 0)
+					rte_rib6_set_nh(node, next_hop);
+				return ret;
+			}
 			ret = modify_dp(dp, rib, ip_masked, depth, next_hop);
 			if (ret == 0)
 				rte_rib6_set_nh(node, next_hop);
 			return 0;
 		}
 
+		depth_diff = get_depth_diff(rib, ip_masked, depth);
 		if ((depth > 24) && (dp->rsvd_tbl8s >=
 				dp->number_tbl8s - depth_diff))
 			return -ENOSPC;
@@ -560,13 +992,17 @@ trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 		if (node == NULL)
 			return -rte_errno;
 		rte_rib6_set_nh(node, next_hop);
-		parent = rte_rib6_lookup_parent(node);
-		if (parent != NULL) {
-			rte_rib6_get_nh(parent, &par_nh);
-			if (par_nh == next_hop)
-				return 0;
+		if (dp->txn_active)
+			ret = txn_add_prefix(dp, ip_masked, depth, NULL);
+		else {
+			parent = rte_rib6_lookup_parent(node);
+			if (parent != NULL) {
+				rte_rib6_get_nh(parent, &par_nh);
+				if (par_nh == next_hop)
+					return 0;
+			}
+			ret = modify_dp(dp, rib, ip_masked, depth, next_hop);
 		}
-		ret = modify_dp(dp, rib, ip_masked, depth, next_hop);
 		if (ret != 0) {
 			rte_rib6_remove(rib, ip_masked, depth);
 			return ret;
@@ -578,21 +1014,26 @@ trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 		if (node == NULL)
 			return -ENOENT;
 
-		parent = rte_rib6_lookup_parent(node);
-		if (parent != NULL) {
-			rte_rib6_get_nh(parent, &par_nh);
-			rte_rib6_get_nh(node, &node_nh);
-			if (par_nh != node_nh)
+		if (dp->txn_active)
+			ret = txn_add_prefix(dp, ip_masked, depth, node);
+		else {
+			parent = rte_rib6_lookup_parent(node);
+			if (parent != NULL) {
+				rte_rib6_get_nh(parent, &par_nh);
+				rte_rib6_get_nh(node, &node_nh);
+				if (par_nh != node_nh)
+					ret = modify_dp(dp, rib, ip_masked,
+						depth, par_nh);
+			} else
 				ret = modify_dp(dp, rib, ip_masked, depth,
-					par_nh);
-		} else
-			ret = modify_dp(dp, rib, ip_masked, depth, dp->def_nh);
+					dp->def_nh);
+		}
 
 		if (ret != 0)
 			return ret;
 		rte_rib6_remove(rib, ip, depth);
 
-		dp->rsvd_tbl8s -= depth_diff;
+		dp->rsvd_tbl8s -= get_depth_diff(rib, ip_masked, depth);
 		return 0;
 	default:
 		break;
@@ -672,7 +1113,59 @@ trie_free(void *p)
 {
 	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
 
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
+	rte_free(dp->txn_ents);
 	rte_free(dp->tbl8_pool);
 	rte_free(dp->tbl8);
 	rte_free(dp);
 }
+
+int
+trie_rcu_qsbr_add(struct rte_trie_tbl *dp, struct rte_fib6_rcu_config *cfg,
+	const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if ((dp == NULL) || (cfg == NULL) || (cfg->v == NULL))
+		return -EINVAL;
+
+	if (dp->v != NULL)
+		return -EEXIST;
+
+	switch (cfg->mode) {
+	case RTE_FIB6_QSBR_MODE_DQ:
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+			"FIB6_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = dp->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 group index */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB6 defer queue creation failed\n");
+			return -rte_errno;
+		}
+		break;
+	case RTE_FIB6_QSBR_MODE_SYNC:
+		/* No other things to do. */
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
@@ -26,6 +26,15 @@
 #define BITMAP_SLAB_BIT_SIZE		(1ULL << BITMAP_SLAB_BIT_SIZE_LOG2)
 #define BITMAP_SLAB_BITMASK		(BITMAP_SLAB_BIT_SIZE - 1)
 
+/* prefix modified within a transaction */
+struct trie_txn_ent {
+	uint8_t		ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint32_t	idx;	/**< Order of the modification */
+	uint64_t	nh;	/**< Next hop before the modification */
+	uint8_t		depth;
+	uint8_t		present; /**< Route existed before the modification */
+};
+
 struct rte_trie_tbl {
 	uint32_t	number_tbl8s;	/**< Total number of tbl8s */
 	uint32_t	rsvd_tbl8s;	/**< Number of reserved tbl8s */
@@ -35,6 +44,15 @@ struct rte_trie_tbl {
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint32_t	*tbl8_pool;	/**< bitmap containing free tbl8 idxes*/
 	uint32_t	tbl8_pool_pos;
+	/* RCU config. */
+	enum rte_fib6_qsbr_mode	rcu_mode;	/**< Blocking, defer queue. */
+	struct rte_rcu_qsbr	*v;		/**< RCU QSBR variable. */
+	struct rte_rcu_qsbr_dq	*dq;		/**< RCU QSBR defer queue. */
+	/* Transaction state. */
+	uint32_t	txn_active;	/**< Transaction is open */
+	uint32_t	txn_num;	/**< Number of modified prefixes */
+	uint32_t	txn_sz;		/**< Size of txn_ents array */
+	struct trie_txn_ent	*txn_ents;	/**< Modified prefixes */
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -139,4 +157,14 @@ int
 trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	uint8_t depth, uint64_t next_hop, int op);
 
+int
+trie_rcu_qsbr_add(struct rte_trie_tbl *dp, struct rte_fib6_rcu_config *cfg,
+	const char *name);
+
+int
+trie_txn_begin(struct rte_trie_tbl *dp);
+
+int
+trie_txn_commit(struct rte_fib6 *fib);
+
 #endif /* _TRIE_H_ */
@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_fib6.h>
+
+#include "trie.h"
+#include "trie_avx2.h"
+
+/* gather i-th byte of 8 ips, every byte in epi32 chunk */
+static __rte_always_inline __m256i
+get_bytes_x8(uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE], int i)
+{
+	return _mm256_setr_epi32(ips[0][i], ips[1][i], ips[2][i], ips[3][i],
+		ips[4][i], ips[5][i], ips[6][i], ips[7][i]);
+}
+
+static __rte_always_inline void
+trie_avx2_lookup_x8(void *p, uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, int size)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i lsb = _mm256_set1_epi32(1);
+	/* used to mask gather values if size is 2 (16 bit next hops) */
+	const __m256i res_msk = _mm256_set1_epi32(UINT16_MAX);
+	__m256i idxes, res, tmp, msk_ext, new_msk;
+	int i = 3;
+
+	idxes = _mm256_setr_epi32(get_tbl24_idx(ips[0]),
+		get_tbl24_idx(ips[1]), get_tbl24_idx(ips[2]),
+		get_tbl24_idx(ips[3]), get_tbl24_idx(ips[4]),
+		get_tbl24_idx(ips[5]), get_tbl24_idx(ips[6]),
+		get_tbl24_idx(ips[7]));
+
+	/**
+	 * lookup in tbl24
+	 * Put it inside branch to make compiler happy with -O0
+	 */
+	if (size == sizeof(uint16_t)) {
+		res = _mm256_i32gather_epi32((const int *)dp->tbl24, idxes, 2);
+		res = _mm256_and_si256(res, res_msk);
+	} else
+		res = _mm256_i32gather_epi32((const int *)dp->tbl24, idxes, 4);
+
+	/* get extended entries indexes */
+	msk_ext = _mm256_cmpeq_epi32(_mm256_and_si256(res, lsb), lsb);
+	tmp = _mm256_srli_epi32(res, 1);
+
+	/* traverse down the trie */
+	while (!_mm256_testz_si256(msk_ext, msk_ext)) {
+		idxes = _mm256_slli_epi32(tmp, 8);
+		idxes = _mm256_add_epi32(idxes, get_bytes_x8(ips, i));
+		if (size == sizeof(uint16_t)) {
+			tmp = _mm256_mask_i32gather_epi32(zero,
+				(const int *)dp->tbl8, idxes, msk_ext, 2);
+			tmp = _mm256_and_si256(tmp, res_msk);
+		} else
+			tmp = _mm256_mask_i32gather_epi32(zero,
+				(const int *)dp->tbl8, idxes, msk_ext, 4);
+		new_msk = _mm256_cmpeq_epi32(_mm256_and_si256(tmp, lsb), lsb);
+		res = _mm256_blendv_epi8(res, tmp,
+			_mm256_xor_si256(msk_ext, new_msk));
+		tmp = _mm256_srli_epi32(tmp, 1);
+		msk_ext = new_msk;
+		i++;
+	}
+
+	res = _mm256_srli_epi32(res, 1);
+	_mm256_storeu_si256((void *)next_hops,
+		_mm256_cvtepu32_epi64(_mm256_castsi256_si128(res)));
+	_mm256_storeu_si256((void *)(next_hops + 4),
+		_mm256_cvtepu32_epi64(_mm256_extracti128_si256(res, 1)));
+}
+
+static __rte_always_inline void
+trie_avx2_lookup_x4x2_8b(void *p, uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i lsb = _mm256_set1_epi64x(1);
+	__m256i idxes_1, res_1, tmp_1, msk_ext_1, new_msk_1;
+	__m256i idxes_2, res_2, tmp_2, msk_ext_2, new_msk_2;
+	__m256i bytes;
+	int i = 3;
+
+	bytes = _mm256_setr_epi32(get_tbl24_idx(ips[0]),
+		get_tbl24_idx(ips[1]), get_tbl24_idx(ips[2]),
+		get_tbl24_idx(ips[3]), get_tbl24_idx(ips[4]),
+		get_tbl24_idx(ips[5]), get_tbl24_idx(ips[6]),
+		get_tbl24_idx(ips[7]));
+
+	/* lookup in tbl24 */
+	res_1 = _mm256_i32gather_epi64((const long long *)dp->tbl24,
+		_mm256_castsi256_si128(bytes), 8);
+	res_2 = _mm256_i32gather_epi64((const long long *)dp->tbl24,
+		_mm256_extracti128_si256(bytes, 1), 8);
+
+	/* get extended entries indexes */
+	msk_ext_1 = _mm256_cmpeq_epi64(_mm256_and_si256(res_1, lsb), lsb);
+	msk_ext_2 = _mm256_cmpeq_epi64(_mm256_and_si256(res_2, lsb), lsb);
+	tmp_1 = _mm256_srli_epi64(res_1, 1);
+	tmp_2 = _mm256_srli_epi64(res_2, 1);
+
+	/* traverse down the trie */
+	while (!_mm256_testz_si256(_mm256_or_si256(msk_ext_1, msk_ext_2),
+			_mm256_or_si256(msk_ext_1, msk_ext_2))) {
+		bytes = _mm256_setr_epi32(ips[0][i], ips[1][i], ips[2][i],
+			ips[3][i], ips[4][i], ips[5][i], ips[6][i], ips[7][i]);
+		idxes_1 = _mm256_slli_epi64(tmp_1, 8);
+		idxes_2 = _mm256_slli_epi64(tmp_2, 8);
+		idxes_1 = _mm256_add_epi64(idxes_1,
+			_mm256_cvtepu32_epi64(_mm256_castsi256_si128(bytes)));
+		idxes_2 = _mm256_add_epi64(idxes_2,
+			_mm256_cvtepu32_epi64(_mm256_extracti128_si256(bytes,
+			1)));
+		tmp_1 = _mm256_mask_i64gather_epi64(zero,
+			(const long long *)dp->tbl8, idxes_1, msk_ext_1, 8);
+		tmp_2 = _mm256_mask_i64gather_epi64(zero,
+			(const long long *)dp->tbl8, idxes_2, msk_ext_2, 8);
+		new_msk_1 = _mm256_cmpeq_epi64(_mm256_and_si256(tmp_1, lsb),
+			lsb);
+		new_msk_2 = _mm256_cmpeq_epi64(_mm256_and_si256(tmp_2, lsb),
+			lsb);
+		res_1 = _mm256_blendv_epi8(res_1, tmp_1,
+			_mm256_xor_si256(msk_ext_1, new_msk_1));
+		res_2 = _mm256_blendv_epi8(res_2, tmp_2,
+			_mm256_xor_si256(msk_ext_2, new_msk_2));
+		tmp_1 = _mm256_srli_epi64(tmp_1, 1);
+		tmp_2 = _mm256_srli_epi64(tmp_2, 1);
+		msk_ext_1 = new_msk_1;
+		msk_ext_2 = new_msk_2;
+		i++;
+	}
+
+	res_1 = _mm256_srli_epi64(res_1, 1);
+	res_2 = _mm256_srli_epi64(res_2, 1);
+	_mm256_storeu_si256((void *)next_hops, res_1);
+	_mm256_storeu_si256((void *)(next_hops + 4), res_2);
+}
+
+void
+rte_trie_avx2_lookup_bulk_2b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++) {
+		trie_avx2_lookup_x8(p, (uint8_t (*)[16])&ips[i * 8][0],
+				next_hops + i * 8, sizeof(uint16_t));
+	}
+	rte_trie_lookup_bulk_2b(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8, n - i * 8);
+}
+
+void
+rte_trie_avx2_lookup_bulk_4b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++) {
+		trie_avx2_lookup_x8(p, (uint8_t (*)[16])&ips[i * 8][0],
+				next_hops + i * 8, sizeof(uint32_t));
+	}
+	rte_trie_lookup_bulk_4b(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8, n - i * 8);
+}
+
+void
+rte_trie_avx2_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++) {
+		trie_avx2_lookup_x4x2_8b(p, (uint8_t (*)[16])&ips[i * 8][0],
+				next_hops + i * 8);
+	}
+	rte_trie_lookup_bulk_8b(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8, n - i * 8);
+}
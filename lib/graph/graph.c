@@ -18,6 +18,7 @@
 static struct graph_head graph_list = STAILQ_HEAD_INITIALIZER(graph_list);
 static rte_spinlock_t graph_lock = RTE_SPINLOCK_INITIALIZER;
 static rte_graph_t graph_id;
+static uint32_t graph_dispatch_seq;
 
 #define GRAPH_ID_CHECK(id) ID_CHECK(id, graph_id)
 
@@ -28,6 +29,18 @@ graph_list_head_get(void)
 	return &graph_list;
 }
 
+struct graph *
+graph_from_id(rte_graph_t id)
+{
+	struct graph *graph;
+
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id)
+			return graph;
+
+	return NULL;
+}
+
 void
 graph_spinlock_lock(void)
 {
@@ -257,6 +270,226 @@ rte_graph_lookup(const char *name)
 	return graph_mem_fixup_secondary(rc);
 }
 
+struct rte_graph *
+rte_graph_lcore_lookup(const char *name, unsigned int lcore_id)
+{
+	char clone_name[RTE_GRAPH_NAMESIZE];
+	struct rte_graph *graph;
+
+	graph = rte_graph_lookup(name);
+	/* No clone for this lcore, the graph is walked as is */
+	if (graph == NULL || graph->dispatch == NULL ||
+	    graph->lcore_id != RTE_MAX_LCORE || lcore_id >= RTE_MAX_LCORE ||
+	    graph->dispatch->wq[lcore_id] == NULL)
+		return graph;
+
+	snprintf(clone_name, sizeof(clone_name), "%s-%u", name, lcore_id);
+	return rte_graph_lookup(clone_name);
+}
+
+static void
+graph_dispatch_free(struct rte_graph_dispatch *dispatch)
+{
+	unsigned int lcore_id;
+
+	if (dispatch == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		rte_ring_free(dispatch->wq[lcore_id]);
+	rte_mempool_free(dispatch->wq_pool);
+	rte_free(dispatch);
+}
+
+static int
+graph_dispatch_create(struct graph *graph, uint32_t wq_size)
+{
+	struct rte_graph_dispatch *dispatch;
+	struct graph_node *graph_node;
+	char name[RTE_RING_NAMESIZE];
+	unsigned int lcore_id;
+	uint32_t nb_lcores = 0;
+	uint32_t nb_wq_nodes;
+	uint32_t seq;
+
+	/* Graph without lcore affinity is walked in run-to-completion model */
+	STAILQ_FOREACH(graph_node, &graph->node_list, next)
+		if (graph_node->node->lcore_id != RTE_MAX_LCORE)
+			break;
+	if (graph_node == NULL)
+		return 0;
+
+	if (wq_size == 0)
+		wq_size = RTE_GRAPH_DISPATCH_WQ_SIZE;
+
+	dispatch = rte_zmalloc_socket(NULL, sizeof(*dispatch),
+				      RTE_CACHE_LINE_SIZE, graph->socket);
+	if (dispatch == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to alloc %s dispatch context",
+			    graph->name);
+
+	/* Create a work queue for each lcore a node is affined to */
+	seq = graph_dispatch_seq++;
+	STAILQ_FOREACH(graph_node, &graph->node_list, next) {
+		lcore_id = graph_node->node->lcore_id;
+		if (lcore_id == RTE_MAX_LCORE || dispatch->wq[lcore_id] != NULL)
+			continue;
+
+		snprintf(name, sizeof(name), "graph_wq_%u_%u", seq, lcore_id);
+		dispatch->wq[lcore_id] = rte_ring_create(name, wq_size,
+				graph->socket, RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (dispatch->wq[lcore_id] == NULL)
+			SET_ERR_JMP(ENOMEM, free, "Failed to create ring %s",
+				    name);
+		nb_lcores++;
+	}
+
+	/* Work queue nodes in flight plus the ones held in lcore caches */
+	nb_wq_nodes = (nb_lcores + 1) *
+		      (wq_size + 2 * RTE_GRAPH_DISPATCH_DEQ_BURST);
+	snprintf(name, sizeof(name), "graph_wq_pool_%u", seq);
+	dispatch->wq_pool = rte_mempool_create(name, nb_wq_nodes,
+			sizeof(struct rte_graph_dispatch_wq_node),
+			RTE_GRAPH_DISPATCH_DEQ_BURST, 0, NULL, NULL, NULL, NULL,
+			graph->socket, 0);
+	if (dispatch->wq_pool == NULL)
+		SET_ERR_JMP(ENOMEM, free, "Failed to create mempool %s", name);
+
+	graph->dispatch = dispatch;
+	return 0;
+free:
+	graph_dispatch_free(dispatch);
+fail:
+	return -rte_errno;
+}
+
+static int
+graph_clone(struct graph *parent, unsigned int lcore_id)
+{
+	struct graph_node *graph_node;
+	struct graph *graph;
+	int rc;
+
+	/* Create graph object */
+	graph = calloc(1, sizeof(*graph));
+	if (graph == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to calloc graph object");
+
+	/* Initialize the graph object */
+	STAILQ_INIT(&graph->node_list);
+	rc = snprintf(graph->name, RTE_GRAPH_NAMESIZE, "%s-%u", parent->name,
+		      lcore_id);
+	if (rc < 0 || rc >= RTE_GRAPH_NAMESIZE)
+		SET_ERR_JMP(E2BIG, free, "Too big name=%s-%u", parent->name,
+			    lcore_id);
+
+	/* Same nodes in the same order, node offsets match in both reels */
+	STAILQ_FOREACH(graph_node, &parent->node_list, next)
+		if (graph_node_add(graph, graph_node->node))
+			goto graph_cleanup;
+
+	/* Update adjacency list of all nodes in the graph */
+	if (graph_adjacency_list_update(graph))
+		goto graph_cleanup;
+
+	/* Initialize graph object */
+	graph->socket = parent->socket;
+	graph->src_node_count = parent->src_node_count;
+	graph->node_count = parent->node_count;
+	graph->id = graph_id;
+	graph->parent_id = parent->id;
+	graph->lcore_id = lcore_id;
+	graph->dispatch = parent->dispatch;
+
+	/* Allocate the Graph fast path memory and populate the data */
+	if (graph_fp_mem_create(graph))
+		goto graph_cleanup;
+
+	/* Call init() of the all the nodes in the graph */
+	if (graph_node_init(graph))
+		goto graph_mem_destroy;
+
+	/* All good, Lets add the graph to the list */
+	graph_id++;
+	STAILQ_INSERT_TAIL(&graph_list, graph, next);
+	return 0;
+
+graph_mem_destroy:
+	graph_fp_mem_destroy(graph);
+graph_cleanup:
+	graph_cleanup(graph);
+free:
+	free(graph);
+fail:
+	return -rte_errno;
+}
+
+static int
+graph_clones_create(struct graph *parent)
+{
+	unsigned int lcore_id;
+
+	if (parent->dispatch == NULL)
+		return 0;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (parent->dispatch->wq[lcore_id] == NULL)
+			continue;
+		if (graph_clone(parent, lcore_id))
+			return -rte_errno;
+	}
+
+	return 0;
+}
+
+static int
+graph_destroy(struct graph *graph)
+{
+	int rc;
+
+	/* Call fini() of the all the nodes in the graph */
+	graph_node_fini(graph);
+	/* Destroy graph fast path memory */
+	rc = graph_fp_mem_destroy(graph);
+	if (rc)
+		SET_ERR_JMP(rc, fail, "Graph %s destroy failed", graph->name);
+
+	graph_cleanup(graph);
+	STAILQ_REMOVE(&graph_list, graph, graph, next);
+	/* Dispatch context and packet tracer are owned by the parent graph */
+	if (graph->parent_id == RTE_GRAPH_ID_INVALID) {
+		graph_dispatch_free(graph->dispatch);
+		graph_pkt_trace_free(graph);
+	}
+	free(graph);
+	graph_id--;
+fail:
+	return rc;
+}
+
+static int
+graph_clones_destroy(struct graph *parent)
+{
+	struct graph *graph, *tmp;
+	int rc;
+
+	if (parent->dispatch == NULL)
+		return 0;
+
+	graph = STAILQ_FIRST(&graph_list);
+	while (graph != NULL) {
+		tmp = STAILQ_NEXT(graph, next);
+		if (graph != parent && graph->dispatch == parent->dispatch) {
+			rc = graph_destroy(graph);
+			if (rc)
+				return rc;
+		}
+		graph = tmp;
+	}
+
+	return 0;
+}
+
 rte_graph_t
 rte_graph_create(const char *name, struct rte_graph_param *prm)
 {
@@ -327,10 +560,17 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph->src_node_count = src_node_count;
 	graph->node_count = graph_nodes_count(graph);
 	graph->id = graph_id;
+	graph->parent_id = RTE_GRAPH_ID_INVALID;
+	graph->lcore_id = RTE_MAX_LCORE;
+
+	/* Create the work queues of the lcores nodes are affined to */
+	if (prm->model == RTE_GRAPH_MODEL_DISPATCH &&
+	    graph_dispatch_create(graph, prm->dispatch_wq_size))
+		goto graph_cleanup;
 
 	/* Allocate the Graph fast path memory and populate the data */
 	if (graph_fp_mem_create(graph))
-		goto graph_cleanup;
+		goto dispatch_free;
 
 	/* Call init() of the all the nodes in the graph */
 	if (graph_node_init(graph))
@@ -340,11 +580,20 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph_id++;
 	STAILQ_INSERT_TAIL(&graph_list, graph, next);
 
+	/* Clone the graph for each lcore of the dispatch model */
+	if (graph_clones_create(graph)) {
+		graph_clones_destroy(graph);
+		graph_destroy(graph);
+		goto fail;
+	}
+
 	graph_spinlock_unlock();
 	return graph->id;
 
 graph_mem_destroy:
 	graph_fp_mem_destroy(graph);
+dispatch_free:
+	graph_dispatch_free(graph->dispatch);
 graph_cleanup:
 	graph_cleanup(graph);
 free:
@@ -366,18 +615,16 @@ rte_graph_destroy(rte_graph_t id)
 	while (graph != NULL) {
 		tmp = STAILQ_NEXT(graph, next);
 		if (graph->id == id) {
-			/* Call fini() of the all the nodes in the graph */
-			graph_node_fini(graph);
-			/* Destroy graph fast path memory */
-			rc = graph_fp_mem_destroy(graph);
-			if (rc)
-				SET_ERR_JMP(rc, done, "Graph %s destroy failed",
-					    graph->name);
-
-			graph_cleanup(graph);
-			STAILQ_REMOVE(&graph_list, graph, graph, next);
-			free(graph);
-			graph_id--;
+			if (graph->parent_id != RTE_GRAPH_ID_INVALID) {
+				rc = -EPERM;
+				SET_ERR_JMP(EPERM, done,
+					    "Graph %s is a clone of graph %u",
+					    graph->name, graph->parent_id);
+			}
+			/* Destroy the per lcore clones along with the graph */
+			rc = graph_clones_destroy(graph);
+			if (rc == 0)
+				rc = graph_destroy(graph);
 			goto done;
 		}
 		graph = tmp;
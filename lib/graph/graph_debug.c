@@ -20,6 +20,10 @@ graph_dump(FILE *f, struct graph *g)
 	fprintf(f, "  mem_sz=%zu\n", g->mem_sz);
 	fprintf(f, "  node_count=%" PRIu32 "\n", g->node_count);
 	fprintf(f, "  src_node_count=%" PRIu32 "\n", g->src_node_count);
+	if (g->dispatch != NULL) {
+		fprintf(f, "  parent_id=%" PRIu32 "\n", g->parent_id);
+		fprintf(f, "  lcore_id=%u\n", g->lcore_id);
+	}
 
 	STAILQ_FOREACH(graph_node, &g->node_list, next)
 		fprintf(f, "     node[%d] <%s>\n", i++, graph_node->node->name);
@@ -56,6 +60,8 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 	fprintf(f, "  cir_mask=0x%" PRIx32 "\n", g->cir_mask);
 	fprintf(f, "  nb_nodes=%" PRId32 "\n", g->nb_nodes);
 	fprintf(f, "  socket=%d\n", g->socket);
+	if (g->dispatch != NULL)
+		fprintf(f, "  lcore_id=%u\n", g->lcore_id);
 	fprintf(f, "  fence=0x%" PRIx64 "\n", g->fence);
 	fprintf(f, "  nodes_start=0x%" PRIx32 "\n", g->nodes_start);
 	fprintf(f, "  cir_start=%p\n", g->cir_start);
@@ -70,6 +76,8 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 		fprintf(f, "       id=0x%" PRIx32 "\n", n->id);
 		fprintf(f, "       offset=0x%" PRIx32 "\n", n->off);
 		fprintf(f, "       nb_edges=%" PRId32 "\n", n->nb_edges);
+		if (g->dispatch != NULL)
+			fprintf(f, "       lcore_id=%u\n", n->lcore_id);
 		fprintf(f, "       realloc_count=%d\n", n->realloc_count);
 		fprintf(f, "       size=%d\n", n->size);
 		fprintf(f, "       idx=%d\n", n->idx);
@@ -0,0 +1,430 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2022 Marvell International Ltd.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_telemetry.h>
+
+#include "graph_private.h"
+
+/* Max records returned by the telemetry command, to fit in its output */
+#define GRAPH_PKT_TRACE_TEL_RECORDS 16
+
+/* Packet tracer, shared by a graph and its per lcore clones */
+struct rte_graph_pkt_trace {
+	uint64_t nb_objs;     /* Objs output by the source nodes. */
+	uint64_t last_seq;    /* Last sequence number, never reset. */
+	uint32_t sample_rate; /* Trace one in every sample_rate objs. */
+	struct rte_graph_pkt_trace_record recs[RTE_GRAPH_PKT_TRACE_RECORDS];
+	rte_node_t nb_source; /* Size of the source array. */
+	uint8_t source[];     /* Source nodes, by node id. */
+} __rte_cache_aligned;
+
+static const struct rte_mbuf_dynfield pkt_trace_seq_desc = {
+	.name = "rte_graph_pkt_trace_seq",
+	.size = sizeof(uint64_t),
+	.align = __alignof__(uint64_t),
+};
+
+static const struct rte_mbuf_dynflag pkt_trace_flag_desc = {
+	.name = "rte_graph_pkt_trace_flag",
+};
+
+static int pkt_trace_seq_offset = -1;
+static uint64_t pkt_trace_flag;
+
+static inline uint64_t *
+pkt_trace_seq(struct rte_mbuf *mbuf)
+{
+	return RTE_MBUF_DYNFIELD(mbuf, pkt_trace_seq_offset, uint64_t *);
+}
+
+static inline int
+pkt_trace_is_source(const struct rte_graph_pkt_trace *trace,
+		    const struct rte_node *node)
+{
+	return node->id < trace->nb_source && trace->source[node->id];
+}
+
+void
+__rte_graph_pkt_trace(struct rte_graph_pkt_trace *trace, struct rte_node *node)
+{
+	struct rte_mbuf **mbufs = (struct rte_mbuf **)node->objs;
+	struct rte_graph_pkt_trace_record *rec;
+	const uint16_t nb_objs = node->idx;
+	uint64_t seq, tsc;
+	rte_edge_t e;
+	uint16_t i, n;
+
+	/* Objs output by the source node will be appended to these streams */
+	if (pkt_trace_is_source(trace, node)) {
+		for (e = 0; e < node->nb_edges; e++)
+			node->nodes[e]->trace_idx = node->nodes[e]->idx;
+		return;
+	}
+
+	if (nb_objs == 0)
+		return;
+
+	tsc = rte_rdtsc();
+	for (i = 0; i < nb_objs; i++) {
+		if (!(mbufs[i]->ol_flags & pkt_trace_flag))
+			continue;
+
+		seq = *pkt_trace_seq(mbufs[i]);
+		rec = &trace->recs[seq % RTE_GRAPH_PKT_TRACE_RECORDS];
+		/* Record reused by a more recent sample */
+		if (rec->seq != seq)
+			continue;
+
+		n = rec->nb_hops;
+		if (n == RTE_GRAPH_PKT_TRACE_MAX_HOPS)
+			continue;
+		rec->hops[n].node = node->id;
+		rec->hops[n].tsc = tsc;
+		rec->nb_hops = n + 1;
+	}
+}
+
+/* Sample the objs a source node appended to the streams of its next nodes */
+void
+__rte_graph_pkt_sample(struct rte_graph_pkt_trace *trace,
+		       struct rte_node *node, uint64_t tsc)
+{
+	struct rte_graph_pkt_trace_record *rec;
+	const uint32_t rate = trace->sample_rate;
+	struct rte_node *next;
+	struct rte_mbuf *mbuf;
+	uint64_t seen, seq;
+	uint16_t i, nb_objs;
+	rte_edge_t e;
+
+	if (!pkt_trace_is_source(trace, node))
+		return;
+
+	for (e = 0; e < node->nb_edges; e++) {
+		next = node->nodes[e];
+		/* Nothing output, or sampled already through another edge */
+		if (next->idx <= next->trace_idx)
+			continue;
+
+		nb_objs = next->idx - next->trace_idx;
+		seen = __atomic_fetch_add(&trace->nb_objs, nb_objs,
+					  __ATOMIC_RELAXED);
+		for (i = next->trace_idx; i < next->idx; i++, seen++) {
+			mbuf = next->objs[i];
+			if (seen % rate != 0) {
+				mbuf->ol_flags &= ~pkt_trace_flag;
+				continue;
+			}
+
+			/* Unique even across restarts, for mbufs in flight */
+			seq = __atomic_add_fetch(&trace->last_seq, 1,
+						 __ATOMIC_RELAXED);
+			rec = &trace->recs[seq % RTE_GRAPH_PKT_TRACE_RECORDS];
+			rec->seq = seq;
+			rec->hops[0].node = node->id;
+			rec->hops[0].tsc = tsc;
+			rec->nb_hops = 1;
+			*pkt_trace_seq(mbuf) = seq;
+			mbuf->ol_flags |= pkt_trace_flag;
+		}
+		next->trace_idx = next->idx;
+	}
+}
+
+static struct rte_graph_pkt_trace *
+graph_pkt_trace_create(struct graph *graph)
+{
+	struct rte_graph_pkt_trace *trace;
+	struct graph_node *graph_node;
+	rte_node_t nb_source;
+
+	nb_source = rte_node_max_count();
+	trace = rte_zmalloc_socket(NULL, sizeof(*trace) + nb_source,
+				   RTE_CACHE_LINE_SIZE, graph->socket);
+	if (trace == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to alloc %s packet tracer",
+			    graph->name);
+
+	/* Objs are sampled once, when output by a source node */
+	trace->nb_source = nb_source;
+	STAILQ_FOREACH(graph_node, &graph->node_list, next)
+		if (graph_node->node->flags & RTE_NODE_SOURCE_F)
+			trace->source[graph_node->node->id] = 1;
+
+	return trace;
+fail:
+	return NULL;
+}
+
+void
+graph_pkt_trace_free(struct graph *graph)
+{
+	rte_free(graph->pkt_trace);
+	graph->pkt_trace = NULL;
+}
+
+static struct graph *
+graph_pkt_trace_parent_get(rte_graph_t id)
+{
+	struct graph *graph;
+
+	graph = graph_from_id(id);
+	if (graph == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Invalid graph id %u", id);
+	if (graph->parent_id != RTE_GRAPH_ID_INVALID)
+		SET_ERR_JMP(EPERM, fail, "Graph %s is a clone of graph %u",
+			    graph->name, graph->parent_id);
+
+	return graph;
+fail:
+	return NULL;
+}
+
+static void
+graph_pkt_trace_set(struct graph *parent, struct rte_graph_pkt_trace *trace)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *graph;
+
+	/* Per lcore clones of the dispatch model share the parent context */
+	STAILQ_FOREACH(graph, graph_head, next)
+		if (graph == parent || (parent->dispatch != NULL &&
+					graph->dispatch == parent->dispatch))
+			graph->graph->pkt_trace = trace;
+}
+
+int
+rte_graph_pkt_trace_enable(rte_graph_t id, uint32_t sample_rate)
+{
+	struct rte_graph_pkt_trace *trace;
+	struct graph *graph;
+	int rc;
+
+	if (!rte_graph_has_stats_feature())
+		return -ENOTSUP;
+
+	if (sample_rate == 0)
+		return -EINVAL;
+
+	graph_spinlock_lock();
+
+	graph = graph_pkt_trace_parent_get(id);
+	if (graph == NULL)
+		goto fail;
+
+	if (pkt_trace_seq_offset < 0) {
+		rc = rte_mbuf_dynfield_register(&pkt_trace_seq_desc);
+		if (rc < 0)
+			SET_ERR_JMP(rte_errno, fail,
+				    "Failed to register mbuf dynfield");
+		pkt_trace_seq_offset = rc;
+	}
+
+	if (pkt_trace_flag == 0) {
+		rc = rte_mbuf_dynflag_register(&pkt_trace_flag_desc);
+		if (rc < 0)
+			SET_ERR_JMP(rte_errno, fail,
+				    "Failed to register mbuf dynflag");
+		pkt_trace_flag = RTE_BIT64(rc);
+	}
+
+	/* Records are kept until the graph is destroyed, start over */
+	trace = graph->pkt_trace;
+	if (trace == NULL) {
+		trace = graph_pkt_trace_create(graph);
+		if (trace == NULL)
+			goto fail;
+		graph->pkt_trace = trace;
+	} else {
+		/* The sequence goes on, sampled mbufs may still be in flight */
+		memset(trace->recs, 0, sizeof(trace->recs));
+	}
+	trace->sample_rate = sample_rate;
+
+	/* Publish the tracer once initialized */
+	rte_smp_wmb();
+	graph_pkt_trace_set(graph, trace);
+
+	graph_spinlock_unlock();
+	return 0;
+fail:
+	graph_spinlock_unlock();
+	return -rte_errno;
+}
+
+int
+rte_graph_pkt_trace_disable(rte_graph_t id)
+{
+	struct graph *graph;
+
+	graph_spinlock_lock();
+
+	graph = graph_pkt_trace_parent_get(id);
+	if (graph == NULL)
+		goto fail;
+
+	graph_pkt_trace_set(graph, NULL);
+
+	graph_spinlock_unlock();
+	return 0;
+fail:
+	graph_spinlock_unlock();
+	return -rte_errno;
+}
+
+static uint32_t
+graph_pkt_trace_copy(const struct rte_graph_pkt_trace *trace,
+		     struct rte_graph_pkt_trace_record *recs, uint32_t nb_recs)
+{
+	const struct rte_graph_pkt_trace_record *rec;
+	uint64_t first, last = 0, seq;
+	uint32_t i, n = 0;
+
+	for (i = 0; i < RTE_GRAPH_PKT_TRACE_RECORDS; i++)
+		last = RTE_MAX(last, trace->recs[i].seq);
+	if (last == 0)
+		return 0;
+
+	nb_recs = RTE_MIN(nb_recs, (uint32_t)RTE_GRAPH_PKT_TRACE_RECORDS);
+	first = last > nb_recs ? last - nb_recs + 1 : 1;
+	for (seq = first; seq <= last; seq++) {
+		rec = &trace->recs[seq % RTE_GRAPH_PKT_TRACE_RECORDS];
+		if (rec->seq != seq)
+			continue;
+		recs[n] = *rec;
+		recs[n].nb_hops = RTE_MIN(recs[n].nb_hops,
+					  RTE_GRAPH_PKT_TRACE_MAX_HOPS);
+		n++;
+	}
+
+	return n;
+}
+
+int
+rte_graph_pkt_trace_records_get(rte_graph_t id,
+				struct rte_graph_pkt_trace_record *recs,
+				uint32_t nb_recs)
+{
+	struct graph *graph;
+	int rc = 0;
+
+	if (recs == NULL)
+		return -EINVAL;
+
+	graph_spinlock_lock();
+
+	graph = graph_pkt_trace_parent_get(id);
+	if (graph == NULL)
+		goto fail;
+
+	if (graph->pkt_trace != NULL)
+		rc = graph_pkt_trace_copy(graph->pkt_trace, recs, nb_recs);
+
+	graph_spinlock_unlock();
+	return rc;
+fail:
+	graph_spinlock_unlock();
+	return -rte_errno;
+}
+
+void
+rte_graph_pkt_trace_dump(FILE *f, rte_graph_t id)
+{
+	struct rte_graph_pkt_trace_record *recs;
+	const struct rte_graph_pkt_trace_hop *hop;
+	int i, n;
+	uint16_t j;
+
+	recs = malloc(sizeof(*recs) * RTE_GRAPH_PKT_TRACE_RECORDS);
+	if (recs == NULL)
+		return;
+
+	n = rte_graph_pkt_trace_records_get(id, recs,
+					    RTE_GRAPH_PKT_TRACE_RECORDS);
+	for (i = 0; i < n; i++) {
+		fprintf(f, "packet seq=%" PRIu64 "\n", recs[i].seq);
+		for (j = 0; j < recs[i].nb_hops; j++) {
+			hop = &recs[i].hops[j];
+			fprintf(f, "  %-32s +%" PRIu64 " cycles\n",
+				rte_node_id_to_name(hop->node),
+				hop->tsc - recs[i].hops[0].tsc);
+		}
+	}
+
+	free(recs);
+}
+
+static int
+graph_handle_pkt_trace(const char *cmd __rte_unused, const char *params,
+		       struct rte_tel_data *d)
+{
+	struct rte_graph_pkt_trace_record *recs;
+	const struct rte_graph_pkt_trace_hop *hop;
+	char str[RTE_TEL_MAX_STRING_LEN];
+	char seq[RTE_TEL_MAX_STRING_LEN];
+	struct rte_tel_data *hops;
+	rte_graph_t id;
+	int i, n, rc = 0;
+	uint16_t j;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	id = rte_graph_from_name(params);
+	if (id == RTE_GRAPH_ID_INVALID)
+		return -EINVAL;
+
+	recs = malloc(sizeof(*recs) * GRAPH_PKT_TRACE_TEL_RECORDS);
+	if (recs == NULL)
+		return -ENOMEM;
+
+	n = rte_graph_pkt_trace_records_get(id, recs,
+					    GRAPH_PKT_TRACE_TEL_RECORDS);
+	if (n < 0) {
+		rc = n;
+		goto free;
+	}
+
+	/* Hops of each packet as "node:+cycles since the first hop" */
+	rte_tel_data_start_dict(d);
+	for (i = 0; i < n; i++) {
+		hops = rte_tel_data_alloc();
+		if (hops == NULL) {
+			rc = -ENOMEM;
+			goto free;
+		}
+
+		rte_tel_data_start_array(hops, RTE_TEL_STRING_VAL);
+		for (j = 0; j < recs[i].nb_hops; j++) {
+			hop = &recs[i].hops[j];
+			snprintf(str, sizeof(str), "%s:+%" PRIu64,
+				 rte_node_id_to_name(hop->node),
+				 hop->tsc - recs[i].hops[0].tsc);
+			rte_tel_data_add_array_string(hops, str);
+		}
+
+		snprintf(seq, sizeof(seq), "%" PRIu64, recs[i].seq);
+		rte_tel_data_add_dict_container(d, seq, hops, 0);
+	}
+
+free:
+	free(recs);
+	return rc;
+}
+
+RTE_INIT(graph_pkt_trace_init_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/pkt_trace", graph_handle_pkt_trace,
+		"Returns the most recent packet traces of a graph. Parameters: graph name");
+}
@@ -56,6 +56,12 @@ graph_header_popluate(struct graph *_graph)
 	graph->nodes_start = _graph->nodes_start;
 	graph->socket = _graph->socket;
 	graph->id = _graph->id;
+	graph->lcore_id = _graph->lcore_id;
+	graph->dispatch = _graph->dispatch;
+	if (graph->dispatch != NULL && graph->lcore_id != RTE_MAX_LCORE)
+		graph->wq = graph->dispatch->wq[graph->lcore_id];
+	else
+		graph->wq = NULL;
 	memcpy(graph->name, _graph->name, RTE_GRAPH_NAMESIZE);
 	graph->fence = RTE_GRAPH_FENCE;
 }
@@ -67,6 +73,7 @@ graph_nodes_populate(struct graph *_graph)
 	struct rte_graph *graph = _graph->graph;
 	struct graph_node *graph_node;
 	rte_edge_t count, nb_edges;
+	unsigned int lcore_id;
 	const char *parent;
 	rte_node_t pid;
 
@@ -84,6 +91,13 @@ graph_nodes_populate(struct graph *_graph)
 		}
 		node->id = graph_node->node->id;
 		node->parent_id = pid;
+		/* Only lcores with a work queue can be handed streams over */
+		lcore_id = graph_node->node->lcore_id;
+		if (_graph->dispatch != NULL && lcore_id != RTE_MAX_LCORE &&
+		    _graph->dispatch->wq[lcore_id] != NULL)
+			node->lcore_id = lcore_id;
+		else
+			node->lcore_id = RTE_MAX_LCORE;
 		nb_edges = graph_node->node->nb_edges;
 		node->nb_edges = nb_edges;
 		off += sizeof(struct rte_node);
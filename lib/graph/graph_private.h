@@ -55,6 +55,7 @@ struct node {
 	rte_node_t id;		      /**< Allocated identifier for the node. */
 	rte_node_t parent_id;	      /**< Parent node identifier. */
 	rte_edge_t nb_edges;	      /**< Number of edges from this node. */
+	unsigned int lcore_id;	      /**< Lcore the node is affined to. */
 	char next_nodes[][RTE_NODE_NAMESIZE]; /**< Names of next nodes. */
 };
 
@@ -100,6 +101,14 @@ struct graph {
 	/**< Memory size of the graph. */
 	int socket;
 	/**< Socket identifier where memory is allocated. */
+	rte_graph_t parent_id;
+	/**< Identifier of the graph this graph is cloned from. */
+	unsigned int lcore_id;
+	/**< Lcore the graph is bound to in dispatch model. */
+	struct rte_graph_dispatch *dispatch;
+	/**< Dispatch model context, shared with the parent graph. */
+	struct rte_graph_pkt_trace *pkt_trace;
+	/**< Packet tracer, shared with the per lcore clones. */
 	STAILQ_HEAD(gnode_list, graph_node) node_list;
 	/**< Nodes in a graph. */
 };
@@ -143,6 +152,19 @@ STAILQ_HEAD(graph_head, graph);
  */
 struct graph_head *graph_list_head_get(void);
 
+/**
+ * @internal
+ *
+ * Get graph object from graph id.
+ *
+ * @param id
+ *   Graph identifier.
+ *
+ * @return
+ *   Pointer to the internal graph object if found, NULL otherwise.
+ */
+struct graph *graph_from_id(rte_graph_t id);
+
 /* Lock functions */
 /**
  * @internal
@@ -344,4 +366,15 @@ void graph_dump(FILE *f, struct graph *g);
  */
 void node_dump(FILE *f, struct node *n);
 
+/* Packet tracer functions */
+/**
+ * @internal
+ *
+ * Free the packet tracer of a graph.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ */
+void graph_pkt_trace_free(struct graph *graph);
+
 #endif /* _RTE_GRAPH_PRIVATE_H_ */
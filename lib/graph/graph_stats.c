@@ -8,6 +8,8 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_string_fns.h>
+#include <rte_telemetry.h>
 
 #include "graph_private.h"
 
@@ -236,6 +238,24 @@ cluster_fini(struct cluster *cluster)
 	free(cluster->graphs);
 }
 
+static int
+cluster_clones_add(struct cluster *cluster, struct graph *parent)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *graph;
+
+	if (parent->dispatch == NULL)
+		return 0;
+
+	/* Per lcore clones of the dispatch model share the parent context */
+	STAILQ_FOREACH(graph, graph_head, next)
+		if (graph->dispatch == parent->dispatch &&
+		    cluster_add(cluster, graph))
+			return -rte_errno;
+
+	return 0;
+}
+
 static int
 expand_pattern_to_cluster(struct cluster *cluster, const char *pattern)
 {
@@ -248,6 +268,8 @@ expand_pattern_to_cluster(struct cluster *cluster, const char *pattern)
 		if (fnmatch(pattern, graph->name, 0) == 0) {
 			if (cluster_add(cluster, graph))
 				goto fail;
+			if (cluster_clones_add(cluster, graph))
+				goto fail;
 			found = true;
 		}
 	}
@@ -334,7 +356,10 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
 	struct rte_node *node;
 	rte_node_t count;
+	unsigned int i;
 
+	memset(stat->hist_objs, 0, sizeof(stat->hist_objs));
+	memset(stat->hist_cycles, 0, sizeof(stat->hist_cycles));
 	for (count = 0; count < cluster->nb_nodes; count++) {
 		node = cluster->nodes[count];
 
@@ -342,6 +367,10 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+		for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+			stat->hist_objs[i] += node->hist_objs[i];
+			stat->hist_cycles[i] += node->hist_cycles[i];
+		}
 	}
 
 	stat->calls = calls;
@@ -403,6 +432,153 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		memset(node->hist_objs, 0, sizeof(node->hist_objs));
+		memset(node->hist_cycles, 0, sizeof(node->hist_cycles));
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+static int
+graph_node_hist_set(rte_graph_t id, bool enable)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *parent, *graph;
+	int rc = 0;
+
+	if (enable && !rte_graph_has_stats_feature())
+		return -ENOTSUP;
+
+	graph_spinlock_lock();
+
+	parent = graph_from_id(id);
+	if (parent == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Invalid graph id %u", id);
+	if (parent->parent_id != RTE_GRAPH_ID_INVALID)
+		SET_ERR_JMP(EPERM, fail, "Graph %s is a clone of graph %u",
+			    parent->name, parent->parent_id);
+
+	/* Per lcore clones of the dispatch model share the parent context */
+	STAILQ_FOREACH(graph, graph_head, next)
+		if (graph == parent || (parent->dispatch != NULL &&
+					graph->dispatch == parent->dispatch))
+			graph->graph->node_hist = enable;
+
+	goto done;
+fail:
+	rc = -rte_errno;
+done:
+	graph_spinlock_unlock();
+	return rc;
+}
+
+int
+rte_graph_node_hist_enable(rte_graph_t id)
+{
+	return graph_node_hist_set(id, true);
+}
+
+int
+rte_graph_node_hist_disable(rte_graph_t id)
+{
+	return graph_node_hist_set(id, false);
+}
+
+static int
+graph_handle_list(const char *cmd __rte_unused,
+		  const char *params __rte_unused, struct rte_tel_data *d)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *graph;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_head, next)
+		rte_tel_data_add_array_string(d, graph->name);
+	graph_spinlock_unlock();
+
+	return 0;
+}
+
+static int
+graph_handle_node_hist(const char *cmd __rte_unused, const char *params,
+		       struct rte_tel_data *d)
+{
+	uint64_t hist_cycles[RTE_GRAPH_HIST_BUCKETS] = {0};
+	uint64_t hist_objs[RTE_GRAPH_HIST_BUCKETS] = {0};
+	struct graph_head *graph_head = graph_list_head_get();
+	struct rte_tel_data *objs, *cycles;
+	char name[RTE_GRAPH_NAMESIZE];
+	struct graph *parent, *graph;
+	struct rte_node *node;
+	const char *node_name;
+	bool found = false;
+	unsigned int i;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	/* Parameters are "<graph name>,<node name>" */
+	node_name = strchr(params, ',');
+	if (node_name == NULL ||
+	    (size_t)(node_name - params) >= RTE_GRAPH_NAMESIZE)
+		return -EINVAL;
+	rte_strlcpy(name, params, node_name - params + 1);
+	node_name++;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(parent, graph_head, next)
+		if (strncmp(parent->name, name, RTE_GRAPH_NAMESIZE) == 0)
+			break;
+
+	/* Aggregate the histograms of the per lcore clones */
+	STAILQ_FOREACH(graph, graph_head, next) {
+		if (parent == NULL)
+			break;
+		if (graph != parent && (parent->dispatch == NULL ||
+					graph->dispatch != parent->dispatch))
+			continue;
+
+		node = graph_node_name_to_ptr(graph->graph, node_name);
+		if (node == NULL)
+			continue;
+
+		for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+			hist_objs[i] += node->hist_objs[i];
+			hist_cycles[i] += node->hist_cycles[i];
+		}
+		found = true;
+	}
+	graph_spinlock_unlock();
+
+	if (!found)
+		return -EINVAL;
+
+	objs = rte_tel_data_alloc();
+	cycles = rte_tel_data_alloc();
+	if (objs == NULL || cycles == NULL) {
+		rte_tel_data_free(objs);
+		rte_tel_data_free(cycles);
+		return -ENOMEM;
+	}
+
+	rte_tel_data_start_array(objs, RTE_TEL_U64_VAL);
+	rte_tel_data_start_array(cycles, RTE_TEL_U64_VAL);
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++) {
+		rte_tel_data_add_array_u64(objs, hist_objs[i]);
+		rte_tel_data_add_array_u64(cycles, hist_cycles[i]);
+	}
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_container(d, "objs_per_call", objs, 0);
+	rte_tel_data_add_dict_container(d, "cycles_per_obj", cycles, 0);
+
+	return 0;
+}
+
+RTE_INIT(graph_stats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/list", graph_handle_list,
+		"Returns list of graphs.");
+	rte_telemetry_register_cmd("/graph/node_hist", graph_handle_node_hist,
+		"Returns the node histograms, aggregated over the per lcore clones. Parameters: graph name, node name");
+}
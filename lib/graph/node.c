@@ -93,6 +93,7 @@ __rte_node_register(const struct rte_node_register *reg)
 	node->fini = reg->fini;
 	node->nb_edges = reg->nb_edges;
 	node->parent_id = reg->parent_id;
+	node->lcore_id = RTE_MAX_LCORE;
 	for (i = 0; i < reg->nb_edges; i++) {
 		if (rte_strscpy(node->next_nodes[i], reg->next_nodes[i],
 				RTE_NODE_NAMESIZE) < 0)
@@ -192,6 +193,49 @@ rte_node_clone(rte_node_t id, const char *name)
 	return RTE_NODE_ID_INVALID;
 }
 
+static bool
+node_in_graph(rte_node_t id)
+{
+	struct graph_node *graph_node;
+	struct graph *graph;
+
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		STAILQ_FOREACH(graph_node, &graph->node_list, next)
+			if (graph_node->node->id == id)
+				return true;
+
+	return false;
+}
+
+int
+rte_node_lcore_affinity_set(rte_node_t id, unsigned int lcore_id)
+{
+	struct node *node;
+
+	NODE_ID_CHECK(id);
+	if (lcore_id > RTE_MAX_LCORE)
+		SET_ERR_JMP(EINVAL, fail, "Invalid lcore %u", lcore_id);
+
+	graph_spinlock_lock();
+	/* The work queues of a graph are created along with the graph */
+	if (node_in_graph(id)) {
+		graph_spinlock_unlock();
+		SET_ERR_JMP(EBUSY, fail, "Node %u is used by a graph", id);
+	}
+
+	STAILQ_FOREACH(node, &node_list, next) {
+		if (node->id == id) {
+			node->lcore_id = lcore_id;
+			graph_spinlock_unlock();
+			return 0;
+		}
+	}
+	graph_spinlock_unlock();
+	rte_errno = ENOENT;
+fail:
+	return -rte_errno;
+}
+
 rte_node_t
 rte_node_from_name(const char *name)
 {
@@ -21,6 +21,11 @@
  * edge update, and edge shrink, etc. The API also allows to create the stats
  * cluster to monitor per graph and per node stats.
  *
+ * A graph is walked either in run-to-completion model, where one lcore
+ * processes every node of the graph, or in dispatch model, where nodes are
+ * affined to lcores and the streams crossing lcores are handed over through
+ * per lcore work queues.
+ *
  */
 
 #include <stdbool.h>
@@ -40,6 +45,10 @@ extern "C" {
 #define RTE_EDGE_ID_INVALID UINT16_MAX   /**< Invalid edge id. */
 #define RTE_GRAPH_ID_INVALID UINT16_MAX  /**< Invalid graph id. */
 #define RTE_GRAPH_FENCE 0xdeadbeef12345678ULL /**< Graph fence data. */
+#define RTE_GRAPH_DISPATCH_WQ_SIZE 256 /**< Default dispatch work queue size. */
+#define RTE_GRAPH_HIST_BUCKETS 16 /**< Number of buckets of node histograms. */
+#define RTE_GRAPH_PKT_TRACE_RECORDS 256 /**< Records kept by packet tracer. */
+#define RTE_GRAPH_PKT_TRACE_MAX_HOPS 16 /**< Max nodes recorded per packet. */
 
 typedef uint32_t rte_graph_off_t;  /**< Graph offset type. */
 typedef uint32_t rte_node_t;       /**< Node id type. */
@@ -74,6 +83,7 @@ struct rte_node;  /**< Node object */
 struct rte_graph; /**< Graph object */
 struct rte_graph_cluster_stats;      /**< Stats for Cluster of graphs */
 struct rte_graph_cluster_node_stats; /**< Node stats within cluster of graphs */
+struct rte_graph_pkt_trace;          /**< Packet tracer of a graph */
 
 /**
  * Node process function.
@@ -154,6 +164,23 @@ typedef void (*rte_node_fini_t)(const struct rte_graph *graph,
 typedef int (*rte_graph_cluster_stats_cb_t)(bool is_first, bool is_last,
 	     void *cookie, const struct rte_graph_cluster_node_stats *stats);
 
+/**
+ * Graph worker models.
+ *
+ * @see struct rte_graph_param::model
+ */
+enum rte_graph_worker_model {
+	RTE_GRAPH_MODEL_RTC = 0,
+	/**< Run-to-completion, the whole graph is walked by a single lcore. */
+	RTE_GRAPH_MODEL_DISPATCH,
+	/**< Dispatch, a graph clone is created for each lcore a node of the
+	 *   graph is affined to and the streams destined to a node are
+	 *   processed by the clone of its lcore.
+	 *
+	 *   @see rte_node_lcore_affinity_set(), rte_graph_lcore_lookup()
+	 */
+};
+
 /**
  * Structure to hold configuration parameters for creating the graph.
  *
@@ -164,6 +191,13 @@ struct rte_graph_param {
 	uint16_t nb_node_patterns;  /**< Number of node patterns. */
 	const char **node_patterns;
 	/**< Array of node patterns based on shell pattern. */
+	enum rte_graph_worker_model model;
+	/**< Graph worker model. Unknown values select run-to-completion. */
+	uint32_t dispatch_wq_size;
+	/**< Number of streams each lcore work queue can hold in dispatch
+	 *   model. 0 value allowed, in that case, RTE_GRAPH_DISPATCH_WQ_SIZE
+	 *   is used.
+	 */
 };
 
 /**
@@ -206,6 +240,11 @@ struct rte_graph_cluster_node_stats {
 
 	uint64_t realloc_count; /**< Realloc count. */
 
+	uint64_t hist_objs[RTE_GRAPH_HIST_BUCKETS];
+	/**< Histogram of objs per call, see rte_graph_node_hist_enable(). */
+	uint64_t hist_cycles[RTE_GRAPH_HIST_BUCKETS];
+	/**< Histogram of cycles per obj, see rte_graph_node_hist_enable(). */
+
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
@@ -216,6 +255,10 @@ struct rte_graph_cluster_node_stats {
  *
  * Create memory reel, detect loops and find isolated nodes.
  *
+ * In dispatch model, a clone of the graph named "name" + "-" + lcore id is
+ * also created for each lcore a node of the graph is affined to. The clones
+ * are destroyed along with the graph.
+ *
  * @param name
  *   Unique name for this graph.
  * @param prm
@@ -224,6 +267,8 @@ struct rte_graph_cluster_node_stats {
  *
  * @return
  *   Unique graph id on success, RTE_GRAPH_ID_INVALID otherwise.
+ *
+ * @see rte_graph_lcore_lookup()
  */
 __rte_experimental
 rte_graph_t rte_graph_create(const char *name, struct rte_graph_param *prm);
@@ -231,7 +276,9 @@ rte_graph_t rte_graph_create(const char *name, struct rte_graph_param *prm);
 /**
  * Destroy Graph.
  *
- * Free Graph memory reel.
+ * Free Graph memory reel. The per lcore clones of a graph created in
+ * dispatch model are destroyed as well, they cannot be destroyed on their
+ * own.
  *
  * @param id
  *   id of the graph to destroy.
@@ -297,6 +344,27 @@ int rte_graph_export(const char *name, FILE *f);
 __rte_experimental
 struct rte_graph *rte_graph_lookup(const char *name);
 
+/**
+ * Get the graph object to walk on a given lcore.
+ *
+ * For a graph created in dispatch model, return the clone of the graph
+ * processing the nodes affined to the lcore if any. Otherwise, return the
+ * graph itself, which processes the source nodes without lcore affinity.
+ *
+ * @param name
+ *   Name of the graph.
+ * @param lcore_id
+ *   Lcore to walk the graph on.
+ *
+ * @return
+ *   Graph pointer on success, NULL otherwise.
+ *
+ * @see rte_graph_walk()
+ */
+__rte_experimental
+struct rte_graph *rte_graph_lcore_lookup(const char *name,
+					 unsigned int lcore_id);
+
 /**
  * Get maximum number of graph available.
  *
@@ -419,6 +487,146 @@ void rte_graph_cluster_stats_get(struct rte_graph_cluster_stats *stat,
 __rte_experimental
 void rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat);
 
+/**
+ * Enable the per node histograms of a graph.
+ *
+ * Each call of a node of the graph then updates two log2 histograms of the
+ * node, one of the number of objs processed per call and one of the number
+ * of cycles spent per obj. Bucket 0 counts zero values, bucket i counts the
+ * values in [2^(i-1), 2^i) and the last bucket counts all larger values.
+ * The histograms are aggregated over the cluster in
+ * rte_graph_cluster_node_stats::hist_objs and
+ * rte_graph_cluster_node_stats::hist_cycles.
+ *
+ * In dispatch model, the histograms of the per lcore clones of the graph are
+ * enabled as well.
+ *
+ * @param id
+ *   Graph id.
+ *
+ * @return
+ *   0 on success, -EINVAL for invalid graph id, -EPERM if the graph is a per
+ *   lcore clone, -ENOTSUP if the stats feature is disabled.
+ *
+ * @see rte_graph_has_stats_feature()
+ */
+__rte_experimental
+int rte_graph_node_hist_enable(rte_graph_t id);
+
+/**
+ * Disable the per node histograms of a graph.
+ *
+ * The histograms collected so far are kept.
+ *
+ * @param id
+ *   Graph id.
+ *
+ * @return
+ *   0 on success, -EINVAL for invalid graph id, -EPERM if the graph is a per
+ *   lcore clone.
+ */
+__rte_experimental
+int rte_graph_node_hist_disable(rte_graph_t id);
+
+/**
+ * Node traversed by a packet sampled by the packet tracer.
+ */
+struct rte_graph_pkt_trace_hop {
+	rte_node_t node; /**< Node identifier. */
+	uint64_t tsc;	 /**< TSC when the node started processing the packet. */
+};
+
+/**
+ * Nodes traversed by a packet sampled by the packet tracer.
+ */
+struct rte_graph_pkt_trace_record {
+	uint64_t seq;	  /**< Sequence number of the sampled packet. */
+	uint16_t nb_hops; /**< Number of nodes recorded. */
+	struct rte_graph_pkt_trace_hop hops[RTE_GRAPH_PKT_TRACE_MAX_HOPS];
+	/**< Nodes in traversal order. */
+};
+
+/**
+ * Enable the packet tracer of a graph.
+ *
+ * One in every sample_rate objs output by the source nodes of the graph is
+ * sampled, once whatever the path it then takes. The source node and the
+ * nodes then traversed by a sampled obj are recorded, up to
+ * RTE_GRAPH_PKT_TRACE_MAX_HOPS, along with the TSC at which each of them
+ * started processing it. The last RTE_GRAPH_PKT_TRACE_RECORDS records are
+ * kept. Sequence numbers keep increasing when the tracer is enabled again.
+ *
+ * The objs walked by the graph must be mbufs: sampled mbufs are marked with
+ * a dynamic flag and carry their sequence number in a dynamic field.
+ *
+ * In dispatch model, the per lcore clones of the graph are traced as well,
+ * sharing the records of the graph.
+ *
+ * @param id
+ *   Graph id.
+ * @param sample_rate
+ *   Trace one in every sample_rate objs, 1 traces all objs.
+ *
+ * @return
+ *   0 on success, -EINVAL for invalid argument, -EPERM if the graph is a per
+ *   lcore clone, -ENOTSUP if the stats feature is disabled, -ENOMEM or
+ *   -ENOSPC on allocation failure.
+ *
+ * @see rte_graph_has_stats_feature()
+ */
+__rte_experimental
+int rte_graph_pkt_trace_enable(rte_graph_t id, uint32_t sample_rate);
+
+/**
+ * Disable the packet tracer of a graph.
+ *
+ * The records collected so far are kept until the graph is destroyed or the
+ * tracer enabled again.
+ *
+ * @param id
+ *   Graph id.
+ *
+ * @return
+ *   0 on success, -EINVAL for invalid graph id, -EPERM if the graph is a per
+ *   lcore clone.
+ */
+__rte_experimental
+int rte_graph_pkt_trace_disable(rte_graph_t id);
+
+/**
+ * Get the most recent records of the packet tracer of a graph.
+ *
+ * The records are read while the graph may be walked, the hops of the packets
+ * still in flight may be incomplete.
+ *
+ * @param id
+ *   Graph id.
+ * @param[out] recs
+ *   Array to store the records, oldest first.
+ * @param nb_recs
+ *   Size of the recs array.
+ *
+ * @return
+ *   Number of records stored in recs, negative errno on failure.
+ */
+__rte_experimental
+int rte_graph_pkt_trace_records_get(rte_graph_t id,
+				    struct rte_graph_pkt_trace_record *recs,
+				    uint32_t nb_recs);
+
+/**
+ * Dump the records of the packet tracer of a graph.
+ *
+ * Each hop is dumped with the cycles elapsed since the first hop.
+ *
+ * @param f
+ *   File pointer to dump the records.
+ * @param id
+ *   Graph id.
+ */
+__rte_experimental
+void rte_graph_pkt_trace_dump(FILE *f, rte_graph_t id);
+
 /**
  * Structure defines the node registration parameters.
  *
@@ -485,6 +693,25 @@ rte_node_t __rte_node_register(const struct rte_node_register *node);
 __rte_experimental
 rte_node_t rte_node_clone(rte_node_t id, const char *name);
 
+/**
+ * Affine a node to an lcore.
+ *
+ * In dispatch model, the streams of the node are processed only by the graph
+ * clone of the given lcore. The affinity is applied to the graphs created
+ * after this call, it has no effect in run-to-completion model.
+ * The affinity of a node cannot be changed while a graph uses it.
+ *
+ * @param id
+ *   Valid node id.
+ * @param lcore_id
+ *   Lcore to affine the node to, RTE_MAX_LCORE to remove the affinity.
+ *
+ * @return
+ *   0 on success, -EBUSY if the node is used by a graph, error otherwise.
+ */
+__rte_experimental
+int rte_node_lcore_affinity_set(rte_node_t id, unsigned int lcore_id);
+
 /**
  * Get node id from node name.
  *
@@ -18,9 +18,13 @@
 
 #include <rte_common.h>
 #include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mempool.h>
+#include <rte_pause.h>
 #include <rte_prefetch.h>
 #include <rte_memcpy.h>
 #include <rte_memory.h>
+#include <rte_ring.h>
 
 #include "rte_graph.h"
 
@@ -41,7 +45,12 @@ struct rte_graph {
 	rte_graph_off_t *cir_start;  /**< Pointer to circular buffer. */
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
 	rte_graph_t id;	/**< Graph identifier. */
+	bool node_hist;	/**< Node histograms are enabled. */
 	int socket;	/**< Socket ID where memory is allocated. */
+	unsigned int lcore_id; /**< Lcore the graph is bound to. */
+	struct rte_ring *wq;   /**< Work queue of the bound lcore. */
+	struct rte_graph_dispatch *dispatch; /**< Dispatch model context. */
+	struct rte_graph_pkt_trace *pkt_trace; /**< Packet tracer if enabled. */
 	char name[RTE_GRAPH_NAMESIZE];	/**< Name of the graph. */
 	uint64_t fence;			/**< Fence. */
 } __rte_cache_aligned;
@@ -59,9 +68,13 @@ struct rte_node {
 	rte_node_t parent_id;	/**< Parent Node identifier. */
 	rte_edge_t nb_edges;	/**< Number of edges from this node. */
 	uint32_t realloc_count;	/**< Number of times realloced. */
+	unsigned int lcore_id;	/**< Lcore the node is affined to. */
 
 	char parent[RTE_NODE_NAMESIZE];	/**< Parent node name. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+	uint64_t hist_objs[RTE_GRAPH_HIST_BUCKETS];   /**< Objs per call. */
+	uint64_t hist_cycles[RTE_GRAPH_HIST_BUCKETS]; /**< Cycles per obj. */
+	uint16_t trace_idx;	/**< Objs before the packet tracer samples. */
 
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
@@ -85,6 +98,32 @@ struct rte_node {
 	struct rte_node *nodes[] __rte_cache_min_aligned; /**< Next nodes. */
 } __rte_cache_aligned;
 
+/**
+ * @internal
+ *
+ * Data structure to hand over a stream to the graph of another lcore in
+ * dispatch model.
+ */
+struct rte_graph_dispatch_wq_node {
+	rte_graph_off_t node_off; /**< Offset of the node in the graph reel. */
+	uint16_t nb_objs;	  /**< Number of objects in the stream. */
+	void *objs[RTE_GRAPH_BURST_SIZE]; /**< Objects of the stream. */
+};
+
+/**
+ * @internal
+ *
+ * Data structure shared by a graph and its per lcore clones in dispatch
+ * model.
+ */
+struct rte_graph_dispatch {
+	struct rte_mempool *wq_pool; /**< Pool of work queue nodes. */
+	struct rte_ring *wq[RTE_MAX_LCORE]; /**< Work queue of each lcore. */
+};
+
+/** Max number of work queue nodes dequeued at once in dispatch model. */
+#define RTE_GRAPH_DISPATCH_DEQ_BURST 32
+
 /**
  * @internal
  *
@@ -118,14 +157,125 @@ __rte_experimental
 void __rte_node_stream_alloc_size(struct rte_graph *graph,
 				  struct rte_node *node, uint16_t req_size);
 
+/**
+ * @internal
+ *
+ * Record the node in the trace of the sampled objs of its pending stream,
+ * called before the node processes it. Called before a source node, note
+ * where the objs it outputs will start in the streams of its next nodes.
+ *
+ * @param trace
+ *   Pointer to the packet tracer of the graph.
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @see rte_graph_pkt_trace_enable()
+ */
+__rte_experimental
+void __rte_graph_pkt_trace(struct rte_graph_pkt_trace *trace,
+			   struct rte_node *node);
+
+/**
+ * @internal
+ *
+ * Sample the objs output by a source node, called after the node processed
+ * its stream. Nothing is done for the other nodes.
+ *
+ * @param trace
+ *   Pointer to the packet tracer of the graph.
+ * @param node
+ *   Pointer to the node object.
+ * @param tsc
+ *   TSC when the node started processing.
+ *
+ * @see rte_graph_pkt_trace_enable()
+ */
+__rte_experimental
+void __rte_graph_pkt_sample(struct rte_graph_pkt_trace *trace,
+			    struct rte_node *node, uint64_t tsc);
+
+/**
+ * @internal
+ *
+ * Update the histograms of a node after a call.
+ *
+ * @param node
+ *   Pointer to the node object.
+ * @param objs
+ *   Number of objs processed by the call.
+ * @param cycles
+ *   Cycles spent in the call.
+ *
+ * @see rte_graph_node_hist_enable()
+ */
+static __rte_always_inline void
+__rte_node_hist_update(struct rte_node *node, uint16_t objs, uint64_t cycles)
+{
+	const int last = RTE_GRAPH_HIST_BUCKETS - 1;
+
+	node->hist_objs[RTE_MIN(rte_fls_u32(objs), last)]++;
+	if (objs != 0)
+		node->hist_cycles[RTE_MIN(rte_fls_u64(cycles / objs), last)]++;
+}
+
+/**
+ * @internal
+ *
+ * Invoke the process function of a node on its pending stream and collect
+ * the stats.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ */
+static __rte_always_inline void
+__rte_node_process(struct rte_graph *graph, struct rte_node *node)
+{
+	struct rte_graph_pkt_trace *trace;
+	uint64_t start, cycles;
+	uint16_t rc;
+	void **objs;
+
+	RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+	objs = node->objs;
+	rte_prefetch0(objs);
+
+	if (rte_graph_has_stats_feature()) {
+		/* Same tracer before and after the call, if it is toggled */
+		trace = graph->pkt_trace;
+		if (unlikely(trace != NULL))
+			__rte_graph_pkt_trace(trace, node);
+		start = rte_rdtsc();
+		rc = node->process(graph, node, objs, node->idx);
+		cycles = rte_rdtsc() - start;
+		node->total_cycles += cycles;
+		node->total_calls++;
+		node->total_objs += rc;
+		if (unlikely(graph->node_hist))
+			__rte_node_hist_update(node, rc, cycles);
+		if (unlikely(trace != NULL))
+			__rte_graph_pkt_sample(trace, node, start);
+	} else {
+		node->process(graph, node, objs, node->idx);
+	}
+	node->idx = 0;
+}
+
+static inline void __rte_graph_dispatch_walk(struct rte_graph *graph);
+
 /**
  * Perform graph walk on the circular buffer and invoke the process function
  * of the nodes and collect the stats.
  *
+ * A graph created in dispatch model processes only the nodes affined to the
+ * lcore it is bound to, or without lcore affinity, and hands over the other
+ * streams to the graph of their lcore.
+ *
  * @param graph
  *   Graph pointer returned from rte_graph_lookup function.
  *
- * @see rte_graph_lookup()
+ * @see rte_graph_lookup(), rte_graph_lcore_lookup()
  */
 __rte_experimental
 static inline void
@@ -135,9 +285,11 @@ rte_graph_walk(struct rte_graph *graph)
 	const rte_node_t mask = graph->cir_mask;
 	uint32_t head = graph->head;
 	struct rte_node *node;
-	uint64_t start;
-	uint16_t rc;
-	void **objs;
+
+	if (unlikely(graph->dispatch != NULL)) {
+		__rte_graph_dispatch_walk(graph);
+		return;
+	}
 
 	/*
 	 * Walk on the source node(s) ((cir_start - head) -> cir_start) and then
@@ -156,20 +308,7 @@ rte_graph_walk(struct rte_graph *graph)
 	 */
 	while (likely(head != graph->tail)) {
 		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
-		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
-		objs = node->objs;
-		rte_prefetch0(objs);
-
-		if (rte_graph_has_stats_feature()) {
-			start = rte_rdtsc();
-			rc = node->process(graph, node, objs, node->idx);
-			node->total_cycles += rte_rdtsc() - start;
-			node->total_calls++;
-			node->total_objs += rc;
-		} else {
-			node->process(graph, node, objs, node->idx);
-		}
-		node->idx = 0;
+		__rte_node_process(graph, node);
 		head = likely((int32_t)head > 0) ? head & mask : head;
 	}
 	graph->tail = 0;
@@ -504,6 +643,137 @@ rte_node_next_stream_move(struct rte_graph *graph, struct rte_node *src,
 	}
 }
 
+/**
+ * @internal
+ *
+ * Move the streams handed over by the other lcores to the nodes of the
+ * graph and set these nodes to pending state in the circular buffer.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+static __rte_always_inline void
+__rte_graph_dispatch_wq_process(struct rte_graph *graph)
+{
+	struct rte_graph_dispatch_wq_node *wq_node;
+	void *wq_nodes[RTE_GRAPH_DISPATCH_DEQ_BURST];
+	struct rte_node *node;
+	unsigned int i, n;
+	uint16_t idx;
+
+	n = rte_ring_sc_dequeue_burst(graph->wq, wq_nodes,
+				      RTE_GRAPH_DISPATCH_DEQ_BURST, NULL);
+	if (n == 0)
+		return;
+
+	for (i = 0; i < n; i++) {
+		wq_node = (struct rte_graph_dispatch_wq_node *)wq_nodes[i];
+		node = (struct rte_node *)RTE_PTR_ADD(graph, wq_node->node_off);
+		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+		idx = node->idx;
+
+		__rte_node_enqueue_prologue(graph, node, idx, wq_node->nb_objs);
+
+		rte_memcpy(&node->objs[idx], wq_node->objs,
+			   wq_node->nb_objs * sizeof(void *));
+		node->idx = idx + wq_node->nb_objs;
+	}
+	rte_mempool_put_bulk(graph->dispatch->wq_pool, wq_nodes, n);
+}
+
+/**
+ * @internal
+ *
+ * Hand over the pending stream of a node to the graph of the lcore the node
+ * is affined to.
+ *
+ * Waits for room in the work queue of the target lcore. Meanwhile, the work
+ * queue of the graph is drained so that two lcores handing over streams to
+ * each other cannot dead lock.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ */
+static __rte_always_inline void
+__rte_graph_dispatch_node_handover(struct rte_graph *graph,
+				   struct rte_node *node)
+{
+	struct rte_graph_dispatch *dispatch = graph->dispatch;
+	struct rte_ring *wq = dispatch->wq[node->lcore_id];
+	struct rte_graph_dispatch_wq_node *wq_node;
+	uint16_t off = 0, nb_objs;
+
+	/* Nodes are only affined to lcores with a work queue in the graph */
+	RTE_ASSERT(wq != NULL);
+	while (off < node->idx) {
+		nb_objs = RTE_MIN(node->idx - off, RTE_GRAPH_BURST_SIZE);
+
+		while (unlikely(rte_mempool_get(dispatch->wq_pool,
+						(void **)&wq_node) < 0)) {
+			if (graph->wq != NULL)
+				__rte_graph_dispatch_wq_process(graph);
+			rte_pause();
+		}
+
+		wq_node->node_off = node->off;
+		wq_node->nb_objs = nb_objs;
+		rte_memcpy(wq_node->objs, &node->objs[off],
+			   nb_objs * sizeof(void *));
+
+		while (unlikely(rte_ring_mp_enqueue(wq, wq_node) < 0)) {
+			if (graph->wq != NULL)
+				__rte_graph_dispatch_wq_process(graph);
+			rte_pause();
+		}
+		off += nb_objs;
+	}
+	node->idx = 0;
+}
+
+/**
+ * @internal
+ *
+ * Perform graph walk in dispatch model.
+ *
+ * The source nodes are processed only by the graph bound to their lcore.
+ * The pending streams of the nodes affined to another lcore are handed over
+ * to the work queue of that lcore, the other ones are processed in place.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+static inline void
+__rte_graph_dispatch_walk(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const rte_node_t mask = graph->cir_mask;
+	const unsigned int lcore_id = graph->lcore_id;
+	uint32_t head = graph->head;
+	struct rte_node *node;
+	bool src;
+
+	/* Pick up the streams handed over by the other lcores */
+	if (graph->wq != NULL)
+		__rte_graph_dispatch_wq_process(graph);
+
+	while (likely(head != graph->tail)) {
+		src = (int32_t)head < 0;
+		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+
+		if (node->lcore_id == lcore_id ||
+		    (node->lcore_id == RTE_MAX_LCORE && !src))
+			__rte_node_process(graph, node);
+		else if (!src)
+			__rte_graph_dispatch_node_handover(graph, node);
+
+		head = likely((int32_t)head > 0) ? head & mask : head;
+	}
+	graph->tail = 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,320 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2017 Intel Corporation
+ */
+
+#ifndef _GRO_TCP_H_
+#define _GRO_TCP_H_
+
+#include <rte_tcp.h>
+
+#define INVALID_ARRAY_INDEX 0xffffffffUL
+
+/*
+ * The max length of a IPv4 or IPv6 packet, which includes the length
+ * of the L3 header, the L4 header and the data payload.
+ */
+#define MAX_IP_PKT_LENGTH UINT16_MAX
+
+/* The maximum TCP header length */
+#define MAX_TCP_HLEN 60
+#define INVALID_TCP_HDRLEN(len) \
+	(((len) < sizeof(struct rte_tcp_hdr)) || ((len) > MAX_TCP_HLEN))
+
+/* Header fields representing a TCP flow, whatever the IP version */
+struct cmn_tcp_key {
+	struct rte_ether_addr eth_saddr;
+	struct rte_ether_addr eth_daddr;
+	uint32_t recv_ack;
+	uint16_t src_port;
+	uint16_t dst_port;
+};
+
+#define ASSIGN_COMMON_TCP_KEY(k1, k2) \
+	do {\
+		rte_ether_addr_copy(&(k1->eth_saddr), &(k2->eth_saddr)); \
+		rte_ether_addr_copy(&(k1->eth_daddr), &(k2->eth_daddr)); \
+		k2->recv_ack = k1->recv_ack; \
+		k2->src_port = k1->src_port; \
+		k2->dst_port = k1->dst_port; \
+	} while (0)
+
+struct gro_tcp_item {
+	/*
+	 * The first MBUF segment of the packet. If the value
+	 * is NULL, it means the item is empty.
+	 */
+	struct rte_mbuf *firstseg;
+	/* The last MBUF segment of the packet */
+	struct rte_mbuf *lastseg;
+	/*
+	 * The time when the first packet is inserted into the table.
+	 * This value won't be updated, even if the packet is merged
+	 * with other packets.
+	 */
+	uint64_t start_time;
+	/*
+	 * next_pkt_idx is used to chain the packets that
+	 * are in the same flow but can't be merged together
+	 * (e.g. caused by packet reordering).
+	 */
+	uint32_t next_pkt_idx;
+	/* TCP sequence number of the packet */
+	uint32_t sent_seq;
+	/* IPv4 ID of the packet, unused for IPv6 */
+	uint16_t ip_id;
+	/* the number of merged packets */
+	uint16_t nb_merged;
+	/* Indicate if IPv4 ID can be ignored, always set for IPv6 */
+	uint8_t is_atomic;
+};
+
+/*
+ * Check if two TCP packets have the same common flow fields.
+ */
+static inline int
+is_same_common_tcp_key(const struct cmn_tcp_key *k1,
+		const struct cmn_tcp_key *k2)
+{
+	return (rte_is_same_ether_addr(&k1->eth_saddr, &k2->eth_saddr) &&
+			rte_is_same_ether_addr(&k1->eth_daddr, &k2->eth_daddr) &&
+			(k1->recv_ack == k2->recv_ack) &&
+			(k1->src_port == k2->src_port) &&
+			(k1->dst_port == k2->dst_port));
+}
+
+/*
+ * Merge two TCP packets without updating checksums.
+ * If cmp is larger than 0, append the new packet to the
+ * original packet. Otherwise, pre-pend the new packet to
+ * the original packet.
+ */
+static inline int
+merge_two_tcp_packets(struct gro_tcp_item *item,
+		struct rte_mbuf *pkt,
+		int cmp,
+		uint32_t sent_seq,
+		uint16_t ip_id,
+		uint16_t l2_offset)
+{
+	struct rte_mbuf *pkt_head, *pkt_tail, *lastseg;
+	uint16_t hdr_len, l2_len;
+
+	if (cmp > 0) {
+		pkt_head = item->firstseg;
+		pkt_tail = pkt;
+	} else {
+		pkt_head = pkt;
+		pkt_tail = item->firstseg;
+	}
+
+	/* check if the IP packet length is greater than the max value */
+	hdr_len = l2_offset + pkt_head->l2_len + pkt_head->l3_len +
+		pkt_head->l4_len;
+	l2_len = l2_offset > 0 ? pkt_head->outer_l2_len : pkt_head->l2_len;
+	if (unlikely(pkt_head->pkt_len - l2_len + pkt_tail->pkt_len -
+				hdr_len > MAX_IP_PKT_LENGTH))
+		return 0;
+
+	/* remove the packet header for the tail packet */
+	rte_pktmbuf_adj(pkt_tail, hdr_len);
+
+	/* chain two packets together */
+	if (cmp > 0) {
+		item->lastseg->next = pkt;
+		item->lastseg = rte_pktmbuf_lastseg(pkt);
+		/* update IP ID to the larger value */
+		item->ip_id = ip_id;
+	} else {
+		lastseg = rte_pktmbuf_lastseg(pkt);
+		lastseg->next = item->firstseg;
+		item->firstseg = pkt;
+		/* update sent_seq to the smaller value */
+		item->sent_seq = sent_seq;
+		item->ip_id = ip_id;
+	}
+	item->nb_merged++;
+
+	/* update MBUF metadata for the merged packet */
+	pkt_head->nb_segs += pkt_tail->nb_segs;
+	pkt_head->pkt_len += pkt_tail->pkt_len;
+
+	return 1;
+}
+
+/*
+ * Check if two TCP packets are neighbors.
+ */
+static inline int
+check_seq_option(struct gro_tcp_item *item,
+		struct rte_tcp_hdr *tcph,
+		uint32_t sent_seq,
+		uint16_t ip_id,
+		uint16_t tcp_hl,
+		uint16_t tcp_dl,
+		uint16_t l2_offset,
+		uint8_t is_atomic)
+{
+	struct rte_mbuf *pkt_orig = item->firstseg;
+	char *iph_orig;
+	struct rte_tcp_hdr *tcph_orig;
+	uint16_t len, tcp_hl_orig;
+
+	iph_orig = (char *)(rte_pktmbuf_mtod(pkt_orig, char *) +
+			l2_offset + pkt_orig->l2_len);
+	tcph_orig = (struct rte_tcp_hdr *)(iph_orig + pkt_orig->l3_len);
+	tcp_hl_orig = pkt_orig->l4_len;
+
+	/* Check if TCP option fields equal */
+	len = RTE_MAX(tcp_hl, tcp_hl_orig) - sizeof(struct rte_tcp_hdr);
+	if ((tcp_hl != tcp_hl_orig) || ((len > 0) &&
+				(memcmp(tcph + 1, tcph_orig + 1,
+					len) != 0)))
+		return 0;
+
+	/* Don't merge packets whose DF bits are different */
+	if (unlikely(item->is_atomic ^ is_atomic))
+		return 0;
+
+	/* check if the two packets are neighbors */
+	len = pkt_orig->pkt_len - l2_offset - pkt_orig->l2_len -
+		pkt_orig->l3_len - tcp_hl_orig;
+	if ((sent_seq == item->sent_seq + len) && (is_atomic ||
+				(ip_id == item->ip_id + 1)))
+		/* append the new packet */
+		return 1;
+	else if ((sent_seq + tcp_dl == item->sent_seq) && (is_atomic ||
+				(ip_id + item->nb_merged == item->ip_id)))
+		/* pre-pend the new packet */
+		return -1;
+
+	return 0;
+}
+
+static inline uint32_t
+find_an_empty_tcp_item(struct gro_tcp_item *items, uint32_t max_item_num)
+{
+	uint32_t i;
+
+	for (i = 0; i < max_item_num; i++)
+		if (items[i].firstseg == NULL)
+			return i;
+	return INVALID_ARRAY_INDEX;
+}
+
+/*
+ * Store a packet in an empty item of a TCP table, after the item
+ * prev_idx of the same flow if it is valid.
+ */
+static inline uint32_t
+insert_new_tcp_item(struct rte_mbuf *pkt,
+		struct gro_tcp_item *items,
+		uint32_t *item_num,
+		uint32_t max_item_num,
+		uint64_t start_time,
+		uint32_t prev_idx,
+		uint32_t sent_seq,
+		uint16_t ip_id,
+		uint8_t is_atomic)
+{
+	uint32_t item_idx;
+
+	item_idx = find_an_empty_tcp_item(items, max_item_num);
+	if (item_idx == INVALID_ARRAY_INDEX)
+		return INVALID_ARRAY_INDEX;
+
+	items[item_idx].firstseg = pkt;
+	items[item_idx].lastseg = rte_pktmbuf_lastseg(pkt);
+	items[item_idx].start_time = start_time;
+	items[item_idx].next_pkt_idx = INVALID_ARRAY_INDEX;
+	items[item_idx].sent_seq = sent_seq;
+	items[item_idx].ip_id = ip_id;
+	items[item_idx].nb_merged = 1;
+	items[item_idx].is_atomic = is_atomic;
+	(*item_num)++;
+
+	/* if the previous packet exists, chain them together. */
+	if (prev_idx != INVALID_ARRAY_INDEX) {
+		items[item_idx].next_pkt_idx =
+			items[prev_idx].next_pkt_idx;
+		items[prev_idx].next_pkt_idx = item_idx;
+	}
+
+	return item_idx;
+}
+
+static inline uint32_t
+delete_tcp_item(struct gro_tcp_item *items, uint32_t item_idx,
+		uint32_t *item_num,
+		uint32_t prev_item_idx)
+{
+	uint32_t next_idx = items[item_idx].next_pkt_idx;
+
+	/* NULL indicates an empty item */
+	items[item_idx].firstseg = NULL;
+	(*item_num)--;
+	if (prev_item_idx != INVALID_ARRAY_INDEX)
+		items[prev_item_idx].next_pkt_idx = next_idx;
+
+	return next_idx;
+}
+
+/*
+ * Check all packets of the flow starting at item_idx and try to merge
+ * the packet with a neighbor. Otherwise store it in the flow.
+ *
+ * Return a positive value if the packet is merged, zero if it is stored
+ * and a negative value if there is no available space in the table.
+ */
+static inline int32_t
+process_tcp_item(struct rte_mbuf *pkt,
+		struct rte_tcp_hdr *tcp_hdr,
+		int32_t tcp_dl,
+		struct gro_tcp_item *items,
+		uint32_t item_idx,
+		uint32_t *item_num,
+		uint32_t max_item_num,
+		uint16_t ip_id,
+		uint8_t is_atomic,
+		uint64_t start_time)
+{
+	uint32_t cur_idx, prev_idx;
+	uint32_t sent_seq;
+	int cmp;
+
+	sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
+	cur_idx = item_idx;
+	prev_idx = cur_idx;
+	do {
+		cmp = check_seq_option(&items[cur_idx], tcp_hdr,
+				sent_seq, ip_id, pkt->l4_len, tcp_dl, 0,
+				is_atomic);
+		if (cmp) {
+			if (merge_two_tcp_packets(&items[cur_idx],
+						pkt, cmp, sent_seq, ip_id, 0))
+				return 1;
+			/*
+			 * Fail to merge the two packets, as the packet
+			 * length is greater than the max value. Store
+			 * the packet into the flow.
+			 */
+			if (insert_new_tcp_item(pkt, items, item_num,
+						max_item_num, start_time,
+						prev_idx, sent_seq, ip_id,
+						is_atomic) ==
+					INVALID_ARRAY_INDEX)
+				return -1;
+			return 0;
+		}
+		prev_idx = cur_idx;
+		cur_idx = items[cur_idx].next_pkt_idx;
+	} while (cur_idx != INVALID_ARRAY_INDEX);
+
+	/* Fail to find a neighbor, so store the packet into the flow. */
+	if (insert_new_tcp_item(pkt, items, item_num, max_item_num,
+				start_time, prev_idx, sent_seq, ip_id,
+				is_atomic) == INVALID_ARRAY_INDEX)
+		return -1;
+
+	return 0;
+}
+#endif
@@ -30,7 +30,7 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 	if (tbl == NULL)
 		return NULL;
 
-	size = sizeof(struct gro_tcp4_item) * entries_num;
+	size = sizeof(struct gro_tcp_item) * entries_num;
 	tbl->items = rte_zmalloc_socket(__func__,
 			size,
 			RTE_CACHE_LINE_SIZE,
@@ -71,18 +71,6 @@ gro_tcp4_tbl_destroy(void *tbl)
 	rte_free(tcp_tbl);
 }
 
-static inline uint32_t
-find_an_empty_item(struct gro_tcp4_tbl *tbl)
-{
-	uint32_t i;
-	uint32_t max_item_num = tbl->max_item_num;
-
-	for (i = 0; i < max_item_num; i++)
-		if (tbl->items[i].firstseg == NULL)
-			return i;
-	return INVALID_ARRAY_INDEX;
-}
-
 static inline uint32_t
 find_an_empty_flow(struct gro_tcp4_tbl *tbl)
 {
@@ -95,56 +83,6 @@ find_an_empty_flow(struct gro_tcp4_tbl *tbl)
 	return INVALID_ARRAY_INDEX;
 }
 
-static inline uint32_t
-insert_new_item(struct gro_tcp4_tbl *tbl,
-		struct rte_mbuf *pkt,
-		uint64_t start_time,
-		uint32_t prev_idx,
-		uint32_t sent_seq,
-		uint16_t ip_id,
-		uint8_t is_atomic)
-{
-	uint32_t item_idx;
-
-	item_idx = find_an_empty_item(tbl);
-	if (item_idx == INVALID_ARRAY_INDEX)
-		return INVALID_ARRAY_INDEX;
-
-	tbl->items[item_idx].firstseg = pkt;
-	tbl->items[item_idx].lastseg = rte_pktmbuf_lastseg(pkt);
-	tbl->items[item_idx].start_time = start_time;
-	tbl->items[item_idx].next_pkt_idx = INVALID_ARRAY_INDEX;
-	tbl->items[item_idx].sent_seq = sent_seq;
-	tbl->items[item_idx].ip_id = ip_id;
-	tbl->items[item_idx].nb_merged = 1;
-	tbl->items[item_idx].is_atomic = is_atomic;
-	tbl->item_num++;
-
-	/* if the previous packet exists, chain them together. */
-	if (prev_idx != INVALID_ARRAY_INDEX) {
-		tbl->items[item_idx].next_pkt_idx =
-			tbl->items[prev_idx].next_pkt_idx;
-		tbl->items[prev_idx].next_pkt_idx = item_idx;
-	}
-
-	return item_idx;
-}
-
-static inline uint32_t
-delete_item(struct gro_tcp4_tbl *tbl, uint32_t item_idx,
-		uint32_t prev_item_idx)
-{
-	uint32_t next_idx = tbl->items[item_idx].next_pkt_idx;
-
-	/* NULL indicates an empty item */
-	tbl->items[item_idx].firstseg = NULL;
-	tbl->item_num--;
-	if (prev_item_idx != INVALID_ARRAY_INDEX)
-		tbl->items[prev_item_idx].next_pkt_idx = next_idx;
-
-	return next_idx;
-}
-
 static inline uint32_t
 insert_new_flow(struct gro_tcp4_tbl *tbl,
 		struct tcp4_flow_key *src,
@@ -159,13 +97,9 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
 
 	dst = &(tbl->flows[flow_idx].key);
 
-	rte_ether_addr_copy(&(src->eth_saddr), &(dst->eth_saddr));
-	rte_ether_addr_copy(&(src->eth_daddr), &(dst->eth_daddr));
+	ASSIGN_COMMON_TCP_KEY((&src->cmn_key), (&dst->cmn_key));
 	dst->ip_src_addr = src->ip_src_addr;
 	dst->ip_dst_addr = src->ip_dst_addr;
-	dst->recv_ack = src->recv_ack;
-	dst->src_port = src->src_port;
-	dst->dst_port = src->dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
 	tbl->flow_num++;
@@ -177,7 +111,7 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
  * update the packet length for the flushed packet.
  */
 static inline void
-update_header(struct gro_tcp4_item *item)
+update_header(struct gro_tcp_item *item)
 {
 	struct rte_ipv4_hdr *ipv4_hdr;
 	struct rte_mbuf *pkt = item->firstseg;
@@ -202,9 +136,8 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	uint8_t is_atomic;
 
 	struct tcp4_flow_key key;
-	uint32_t cur_idx, prev_idx, item_idx;
+	uint32_t item_idx;
 	uint32_t i, max_flow_num, remaining_flow_num;
-	int cmp;
 	uint8_t find;
 
 	/*
@@ -242,13 +175,13 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	ip_id = is_atomic ? 0 : rte_be_to_cpu_16(ipv4_hdr->packet_id);
 	sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
 
-	rte_ether_addr_copy(&(eth_hdr->src_addr), &(key.eth_saddr));
-	rte_ether_addr_copy(&(eth_hdr->dst_addr), &(key.eth_daddr));
+	rte_ether_addr_copy(&(eth_hdr->src_addr), &(key.cmn_key.eth_saddr));
+	rte_ether_addr_copy(&(eth_hdr->dst_addr), &(key.cmn_key.eth_daddr));
 	key.ip_src_addr = ipv4_hdr->src_addr;
 	key.ip_dst_addr = ipv4_hdr->dst_addr;
-	key.src_port = tcp_hdr->src_port;
-	key.dst_port = tcp_hdr->dst_port;
-	key.recv_ack = tcp_hdr->recv_ack;
+	key.cmn_key.src_port = tcp_hdr->src_port;
+	key.cmn_key.dst_port = tcp_hdr->dst_port;
+	key.cmn_key.recv_ack = tcp_hdr->recv_ack;
 
 	/* Search for a matched flow. */
 	max_flow_num = tbl->max_flow_num;
@@ -269,7 +202,8 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	 * packet into the flow.
 	 */
 	if (find == 0) {
-		item_idx = insert_new_item(tbl, pkt, start_time,
+		item_idx = insert_new_tcp_item(pkt, tbl->items,
+				&tbl->item_num, tbl->max_item_num, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, ip_id,
 				is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
@@ -280,7 +214,8 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 			 * Fail to insert a new flow, so delete the
 			 * stored packet.
 			 */
-			delete_item(tbl, item_idx, INVALID_ARRAY_INDEX);
+			delete_tcp_item(tbl->items, item_idx,
+					&tbl->item_num, INVALID_ARRAY_INDEX);
 			return -1;
 		}
 		return 0;
@@ -290,37 +225,9 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	 * Check all packets in the flow and try to find a neighbor for
 	 * the input packet.
 	 */
-	cur_idx = tbl->flows[i].start_index;
-	prev_idx = cur_idx;
-	do {
-		cmp = check_seq_option(&(tbl->items[cur_idx]), tcp_hdr,
-				sent_seq, ip_id, pkt->l4_len, tcp_dl, 0,
-				is_atomic);
-		if (cmp) {
-			if (merge_two_tcp4_packets(&(tbl->items[cur_idx]),
-						pkt, cmp, sent_seq, ip_id, 0))
-				return 1;
-			/*
-			 * Fail to merge the two packets, as the packet
-			 * length is greater than the max value. Store
-			 * the packet into the flow.
-			 */
-			if (insert_new_item(tbl, pkt, start_time, prev_idx,
-						sent_seq, ip_id, is_atomic) ==
-					INVALID_ARRAY_INDEX)
-				return -1;
-			return 0;
-		}
-		prev_idx = cur_idx;
-		cur_idx = tbl->items[cur_idx].next_pkt_idx;
-	} while (cur_idx != INVALID_ARRAY_INDEX);
-
-	/* Fail to find a neighbor, so store the packet into the flow. */
-	if (insert_new_item(tbl, pkt, start_time, prev_idx, sent_seq,
-				ip_id, is_atomic) == INVALID_ARRAY_INDEX)
-		return -1;
-
-	return 0;
+	return process_tcp_item(pkt, tcp_hdr, tcp_dl, tbl->items,
+			tbl->flows[i].start_index, &tbl->item_num,
+			tbl->max_item_num, ip_id, is_atomic, start_time);
 }
 
 uint16_t
@@ -347,7 +254,9 @@ gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
 				 * Delete the packet and get the next
 				 * packet in the flow.
 				 */
-				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
+				j = delete_tcp_item(tbl->items, j,
+						&tbl->item_num,
+						INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
 				if (j == INVALID_ARRAY_INDEX)
 					tbl->flow_num--;
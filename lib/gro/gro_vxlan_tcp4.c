@@ -163,15 +163,10 @@ insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 
 	dst = &(tbl->flows[flow_idx].key);
 
-	rte_ether_addr_copy(&(src->inner_key.eth_saddr),
-			&(dst->inner_key.eth_saddr));
-	rte_ether_addr_copy(&(src->inner_key.eth_daddr),
-			&(dst->inner_key.eth_daddr));
+	ASSIGN_COMMON_TCP_KEY((&src->inner_key.cmn_key),
+			(&dst->inner_key.cmn_key));
 	dst->inner_key.ip_src_addr = src->inner_key.ip_src_addr;
 	dst->inner_key.ip_dst_addr = src->inner_key.ip_dst_addr;
-	dst->inner_key.recv_ack = src->inner_key.recv_ack;
-	dst->inner_key.src_port = src->inner_key.src_port;
-	dst->inner_key.dst_port = src->inner_key.dst_port;
 
 	dst->vxlan_hdr.vx_flags = src->vxlan_hdr.vx_flags;
 	dst->vxlan_hdr.vx_vni = src->vxlan_hdr.vx_vni;
@@ -248,7 +243,7 @@ merge_two_vxlan_tcp4_packets(struct gro_vxlan_tcp4_item *item,
 		uint16_t outer_ip_id,
 		uint16_t ip_id)
 {
-	if (merge_two_tcp4_packets(&item->inner_item, pkt, cmp, sent_seq,
+	if (merge_two_tcp_packets(&item->inner_item, pkt, cmp, sent_seq,
 				ip_id, pkt->outer_l2_len +
 				pkt->outer_l3_len)) {
 		/* Update the outer IPv4 ID to the large value. */
@@ -357,13 +352,15 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
 
-	rte_ether_addr_copy(&(eth_hdr->src_addr), &(key.inner_key.eth_saddr));
-	rte_ether_addr_copy(&(eth_hdr->dst_addr), &(key.inner_key.eth_daddr));
+	rte_ether_addr_copy(&(eth_hdr->src_addr),
+			&(key.inner_key.cmn_key.eth_saddr));
+	rte_ether_addr_copy(&(eth_hdr->dst_addr),
+			&(key.inner_key.cmn_key.eth_daddr));
 	key.inner_key.ip_src_addr = ipv4_hdr->src_addr;
 	key.inner_key.ip_dst_addr = ipv4_hdr->dst_addr;
-	key.inner_key.recv_ack = tcp_hdr->recv_ack;
-	key.inner_key.src_port = tcp_hdr->src_port;
-	key.inner_key.dst_port = tcp_hdr->dst_port;
+	key.inner_key.cmn_key.recv_ack = tcp_hdr->recv_ack;
+	key.inner_key.cmn_key.src_port = tcp_hdr->src_port;
+	key.inner_key.cmn_key.dst_port = tcp_hdr->dst_port;
 
 	key.vxlan_hdr.vx_flags = vxlan_hdr->vx_flags;
 	key.vxlan_hdr.vx_vni = vxlan_hdr->vx_vni;
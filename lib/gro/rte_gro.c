@@ -8,8 +8,10 @@
 
 #include "rte_gro.h"
 #include "gro_tcp4.h"
+#include "gro_tcp6.h"
 #include "gro_udp4.h"
 #include "gro_vxlan_tcp4.h"
+#include "gro_vxlan_tcp6.h"
 #include "gro_vxlan_udp4.h"
 
 typedef void *(*gro_tbl_create_fn)(uint16_t socket_id,
@@ -20,20 +22,32 @@ typedef uint32_t (*gro_tbl_pkt_count_fn)(void *tbl);
 
 static gro_tbl_create_fn tbl_create_fn[RTE_GRO_TYPE_MAX_NUM] = {
 		gro_tcp4_tbl_create, gro_vxlan_tcp4_tbl_create,
-		gro_udp4_tbl_create, gro_vxlan_udp4_tbl_create, NULL};
+		gro_udp4_tbl_create, gro_vxlan_udp4_tbl_create,
+		gro_tcp6_tbl_create, gro_vxlan_tcp6_tbl_create, NULL};
 static gro_tbl_destroy_fn tbl_destroy_fn[RTE_GRO_TYPE_MAX_NUM] = {
 			gro_tcp4_tbl_destroy, gro_vxlan_tcp4_tbl_destroy,
 			gro_udp4_tbl_destroy, gro_vxlan_udp4_tbl_destroy,
+			gro_tcp6_tbl_destroy, gro_vxlan_tcp6_tbl_destroy,
 			NULL};
 static gro_tbl_pkt_count_fn tbl_pkt_count_fn[RTE_GRO_TYPE_MAX_NUM] = {
 			gro_tcp4_tbl_pkt_count, gro_vxlan_tcp4_tbl_pkt_count,
 			gro_udp4_tbl_pkt_count, gro_vxlan_udp4_tbl_pkt_count,
+			gro_tcp6_tbl_pkt_count, gro_vxlan_tcp6_tbl_pkt_count,
 			NULL};
 
+#define GRO_SUPPORTED_TYPES (RTE_GRO_IPV4_VXLAN_TCP_IPV4 | \
+		RTE_GRO_TCP_IPV4 | RTE_GRO_IPV4_VXLAN_UDP_IPV4 | \
+		RTE_GRO_UDP_IPV4 | RTE_GRO_TCP_IPV6 | \
+		RTE_GRO_IPV4_VXLAN_TCP_IPV6)
+
 #define IS_IPV4_TCP_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
 		((ptype & RTE_PTYPE_L4_TCP) == RTE_PTYPE_L4_TCP) && \
 		(RTE_ETH_IS_TUNNEL_PKT(ptype) == 0))
 
+#define IS_IPV6_TCP_PKT(ptype) (RTE_ETH_IS_IPV6_HDR(ptype) && \
+		((ptype & RTE_PTYPE_L4_TCP) == RTE_PTYPE_L4_TCP) && \
+		(RTE_ETH_IS_TUNNEL_PKT(ptype) == 0))
+
 #define IS_IPV4_UDP_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
 		((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
 		(RTE_ETH_IS_TUNNEL_PKT(ptype) == 0))
@@ -51,6 +65,19 @@ static gro_tbl_pkt_count_fn tbl_pkt_count_fn[RTE_GRO_TYPE_MAX_NUM] = {
 		 ((ptype & RTE_PTYPE_INNER_L3_MASK) == \
 		  RTE_PTYPE_INNER_L3_IPV4_EXT_UNKNOWN)))
 
+#define IS_IPV4_VXLAN_TCP6_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
+		((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
+		((ptype & RTE_PTYPE_TUNNEL_VXLAN) == \
+		 RTE_PTYPE_TUNNEL_VXLAN) && \
+		((ptype & RTE_PTYPE_INNER_L4_TCP) == \
+		 RTE_PTYPE_INNER_L4_TCP) && \
+		(((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV6) || \
+		 ((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV6_EXT) || \
+		 ((ptype & RTE_PTYPE_INNER_L3_MASK) == \
+		  RTE_PTYPE_INNER_L3_IPV6_EXT_UNKNOWN)))
+
 #define IS_IPV4_VXLAN_UDP4_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
 		((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
 		((ptype & RTE_PTYPE_TUNNEL_VXLAN) == \
@@ -145,36 +172,41 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 	/* allocate a reassembly table for TCP/IPv4 GRO */
 	struct gro_tcp4_tbl tcp_tbl;
 	struct gro_tcp4_flow tcp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
-	struct gro_tcp4_item tcp_items[RTE_GRO_MAX_BURST_ITEM_NUM] = {{0} };
+	struct gro_tcp_item tcp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+
+	/* allocate a reassembly table for TCP/IPv6 GRO */
+	struct gro_tcp6_tbl tcp6_tbl;
+	struct gro_tcp6_flow tcp6_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_tcp_item tcp6_items[RTE_GRO_MAX_BURST_ITEM_NUM];
 
 	/* allocate a reassembly table for UDP/IPv4 GRO */
 	struct gro_udp4_tbl udp_tbl;
 	struct gro_udp4_flow udp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
-	struct gro_udp4_item udp_items[RTE_GRO_MAX_BURST_ITEM_NUM] = {{0} };
+	struct gro_udp4_item udp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
 
 	/* Allocate a reassembly table for VXLAN TCP GRO */
 	struct gro_vxlan_tcp4_tbl vxlan_tcp_tbl;
 	struct gro_vxlan_tcp4_flow vxlan_tcp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
-	struct gro_vxlan_tcp4_item vxlan_tcp_items[RTE_GRO_MAX_BURST_ITEM_NUM]
-			= {{{0}, 0, 0} };
+	struct gro_vxlan_tcp4_item vxlan_tcp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+
+	/* Allocate a reassembly table for VXLAN TCP/IPv6 GRO */
+	struct gro_vxlan_tcp6_tbl vxlan_tcp6_tbl;
+	struct gro_vxlan_tcp6_flow vxlan_tcp6_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_vxlan_tcp6_item vxlan_tcp6_items[RTE_GRO_MAX_BURST_ITEM_NUM];
 
 	/* Allocate a reassembly table for VXLAN UDP GRO */
 	struct gro_vxlan_udp4_tbl vxlan_udp_tbl;
 	struct gro_vxlan_udp4_flow vxlan_udp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
-	struct gro_vxlan_udp4_item vxlan_udp_items[RTE_GRO_MAX_BURST_ITEM_NUM]
-			= {{{0}} };
+	struct gro_vxlan_udp4_item vxlan_udp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
 
 	struct rte_mbuf *unprocess_pkts[nb_pkts];
 	uint32_t item_num;
 	int32_t ret;
 	uint16_t i, unprocess_num = 0, nb_after_gro = nb_pkts;
 	uint8_t do_tcp4_gro = 0, do_vxlan_tcp_gro = 0, do_udp4_gro = 0,
-		do_vxlan_udp_gro = 0;
+		do_vxlan_udp_gro = 0, do_tcp6_gro = 0, do_vxlan_tcp6_gro = 0;
 
-	if (unlikely((param->gro_types & (RTE_GRO_IPV4_VXLAN_TCP_IPV4 |
-					RTE_GRO_TCP_IPV4 |
-					RTE_GRO_IPV4_VXLAN_UDP_IPV4 |
-					RTE_GRO_UDP_IPV4)) == 0))
+	if (unlikely((param->gro_types & GRO_SUPPORTED_TYPES) == 0))
 		return nb_pkts;
 
 	/* Get the maximum number of packets */
@@ -187,6 +219,8 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 			vxlan_tcp_flows[i].start_index = INVALID_ARRAY_INDEX;
 
 		vxlan_tcp_tbl.flows = vxlan_tcp_flows;
+		memset(vxlan_tcp_items, 0,
+				sizeof(vxlan_tcp_items[0]) * item_num);
 		vxlan_tcp_tbl.items = vxlan_tcp_items;
 		vxlan_tcp_tbl.flow_num = 0;
 		vxlan_tcp_tbl.item_num = 0;
@@ -200,6 +234,8 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 			vxlan_udp_flows[i].start_index = INVALID_ARRAY_INDEX;
 
 		vxlan_udp_tbl.flows = vxlan_udp_flows;
+		memset(vxlan_udp_items, 0,
+				sizeof(vxlan_udp_items[0]) * item_num);
 		vxlan_udp_tbl.items = vxlan_udp_items;
 		vxlan_udp_tbl.flow_num = 0;
 		vxlan_udp_tbl.item_num = 0;
@@ -213,6 +249,7 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 			tcp_flows[i].start_index = INVALID_ARRAY_INDEX;
 
 		tcp_tbl.flows = tcp_flows;
+		memset(tcp_items, 0, sizeof(tcp_items[0]) * item_num);
 		tcp_tbl.items = tcp_items;
 		tcp_tbl.flow_num = 0;
 		tcp_tbl.item_num = 0;
@@ -221,11 +258,41 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 		do_tcp4_gro = 1;
 	}
 
+	if (param->gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV6) {
+		for (i = 0; i < item_num; i++)
+			vxlan_tcp6_flows[i].start_index = INVALID_ARRAY_INDEX;
+
+		vxlan_tcp6_tbl.flows = vxlan_tcp6_flows;
+		memset(vxlan_tcp6_items, 0,
+				sizeof(vxlan_tcp6_items[0]) * item_num);
+		vxlan_tcp6_tbl.items = vxlan_tcp6_items;
+		vxlan_tcp6_tbl.flow_num = 0;
+		vxlan_tcp6_tbl.item_num = 0;
+		vxlan_tcp6_tbl.max_flow_num = item_num;
+		vxlan_tcp6_tbl.max_item_num = item_num;
+		do_vxlan_tcp6_gro = 1;
+	}
+
+	if (param->gro_types & RTE_GRO_TCP_IPV6) {
+		for (i = 0; i < item_num; i++)
+			tcp6_flows[i].start_index = INVALID_ARRAY_INDEX;
+
+		tcp6_tbl.flows = tcp6_flows;
+		memset(tcp6_items, 0, sizeof(tcp6_items[0]) * item_num);
+		tcp6_tbl.items = tcp6_items;
+		tcp6_tbl.flow_num = 0;
+		tcp6_tbl.item_num = 0;
+		tcp6_tbl.max_flow_num = item_num;
+		tcp6_tbl.max_item_num = item_num;
+		do_tcp6_gro = 1;
+	}
+
 	if (param->gro_types & RTE_GRO_UDP_IPV4) {
 		for (i = 0; i < item_num; i++)
 			udp_flows[i].start_index = INVALID_ARRAY_INDEX;
 
 		udp_tbl.flows = udp_flows;
+		memset(udp_items, 0, sizeof(udp_items[0]) * item_num);
 		udp_tbl.items = udp_items;
 		udp_tbl.flow_num = 0;
 		udp_tbl.item_num = 0;
@@ -274,6 +341,23 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 				nb_after_gro--;
 			else if (ret < 0)
 				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV4_VXLAN_TCP6_PKT(pkts[i]->packet_type) &&
+				do_vxlan_tcp6_gro) {
+			ret = gro_vxlan_tcp6_reassemble(pkts[i],
+							&vxlan_tcp6_tbl, 0);
+			if (ret > 0)
+				/* Merge successfully */
+				nb_after_gro--;
+			else if (ret < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV6_TCP_PKT(pkts[i]->packet_type) &&
+				do_tcp6_gro) {
+			ret = gro_tcp6_reassemble(pkts[i], &tcp6_tbl, 0);
+			if (ret > 0)
+				/* merge successfully */
+				nb_after_gro--;
+			else if (ret < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
 		} else
 			unprocess_pkts[unprocess_num++] = pkts[i];
 	}
@@ -302,6 +386,16 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 			i += gro_udp4_tbl_timeout_flush(&udp_tbl, 0,
 					&pkts[i], nb_pkts - i);
 		}
+
+		if (do_vxlan_tcp6_gro) {
+			i += gro_vxlan_tcp6_tbl_timeout_flush(&vxlan_tcp6_tbl,
+					0, &pkts[i], nb_pkts - i);
+		}
+
+		if (do_tcp6_gro) {
+			i += gro_tcp6_tbl_timeout_flush(&tcp6_tbl, 0,
+					&pkts[i], nb_pkts - i);
+		}
 		/* Copy unprocessed packets */
 		if (unprocess_num > 0) {
 			memcpy(&pkts[i], unprocess_pkts,
@@ -322,20 +416,21 @@ rte_gro_reassemble(struct rte_mbuf **pkts,
 	struct rte_mbuf *unprocess_pkts[nb_pkts];
 	struct gro_ctx *gro_ctx = ctx;
 	void *tcp_tbl, *udp_tbl, *vxlan_tcp_tbl, *vxlan_udp_tbl;
+	void *tcp6_tbl, *vxlan_tcp6_tbl;
 	uint64_t current_time;
 	uint16_t i, unprocess_num = 0;
 	uint8_t do_tcp4_gro, do_vxlan_tcp_gro, do_udp4_gro, do_vxlan_udp_gro;
+	uint8_t do_tcp6_gro, do_vxlan_tcp6_gro;
 
-	if (unlikely((gro_ctx->gro_types & (RTE_GRO_IPV4_VXLAN_TCP_IPV4 |
-					RTE_GRO_TCP_IPV4 |
-					RTE_GRO_IPV4_VXLAN_UDP_IPV4 |
-					RTE_GRO_UDP_IPV4)) == 0))
+	if (unlikely((gro_ctx->gro_types & GRO_SUPPORTED_TYPES) == 0))
 		return nb_pkts;
 
 	tcp_tbl = gro_ctx->tbls[RTE_GRO_TCP_IPV4_INDEX];
 	vxlan_tcp_tbl = gro_ctx->tbls[RTE_GRO_IPV4_VXLAN_TCP_IPV4_INDEX];
 	udp_tbl = gro_ctx->tbls[RTE_GRO_UDP_IPV4_INDEX];
 	vxlan_udp_tbl = gro_ctx->tbls[RTE_GRO_IPV4_VXLAN_UDP_IPV4_INDEX];
+	tcp6_tbl = gro_ctx->tbls[RTE_GRO_TCP_IPV6_INDEX];
+	vxlan_tcp6_tbl = gro_ctx->tbls[RTE_GRO_IPV4_VXLAN_TCP_IPV6_INDEX];
 
 	do_tcp4_gro = (gro_ctx->gro_types & RTE_GRO_TCP_IPV4) ==
 		RTE_GRO_TCP_IPV4;
@@ -345,6 +440,10 @@ rte_gro_reassemble(struct rte_mbuf **pkts,
 		RTE_GRO_UDP_IPV4;
 	do_vxlan_udp_gro = (gro_ctx->gro_types & RTE_GRO_IPV4_VXLAN_UDP_IPV4) ==
 		RTE_GRO_IPV4_VXLAN_UDP_IPV4;
+	do_tcp6_gro = (gro_ctx->gro_types & RTE_GRO_TCP_IPV6) ==
+		RTE_GRO_TCP_IPV6;
+	do_vxlan_tcp6_gro = (gro_ctx->gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV6) ==
+		RTE_GRO_IPV4_VXLAN_TCP_IPV6;
 
 	current_time = rte_rdtsc();
 
@@ -369,6 +468,16 @@ rte_gro_reassemble(struct rte_mbuf **pkts,
 			if (gro_udp4_reassemble(pkts[i], udp_tbl,
 						current_time) < 0)
 				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV4_VXLAN_TCP6_PKT(pkts[i]->packet_type) &&
+				do_vxlan_tcp6_gro) {
+			if (gro_vxlan_tcp6_reassemble(pkts[i], vxlan_tcp6_tbl,
+						current_time) < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV6_TCP_PKT(pkts[i]->packet_type) &&
+				do_tcp6_gro) {
+			if (gro_tcp6_reassemble(pkts[i], tcp6_tbl,
+						current_time) < 0)
+				unprocess_pkts[unprocess_num++] = pkts[i];
 		} else
 			unprocess_pkts[unprocess_num++] = pkts[i];
 	}
@@ -424,6 +533,21 @@ rte_gro_timeout_flush(void *ctx,
 				gro_ctx->tbls[RTE_GRO_UDP_IPV4_INDEX],
 				flush_timestamp,
 				&out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV6) && left_nb_out > 0) {
+		num += gro_vxlan_tcp6_tbl_timeout_flush(gro_ctx->tbls[
+				RTE_GRO_IPV4_VXLAN_TCP_IPV6_INDEX],
+				flush_timestamp, &out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_TCP_IPV6) && left_nb_out > 0) {
+		num += gro_tcp6_tbl_timeout_flush(
+				gro_ctx->tbls[RTE_GRO_TCP_IPV6_INDEX],
+				flush_timestamp,
+				&out[num], left_nb_out);
 	}
 
 	return num;
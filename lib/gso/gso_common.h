@@ -21,23 +21,24 @@
 #define IS_IPV4_TCP(flag) (((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4)) == \
 		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4))
 
-#define IS_IPV4_VXLAN_TCP4(flag) (((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | \
-				RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_TUNNEL_MASK)) == \
-		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_OUTER_IPV4 | \
-		 RTE_MBUF_F_TX_TUNNEL_VXLAN))
+#define IS_IPV4_UDP(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4)) == \
+		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4))
 
-#define IS_IPV4_VXLAN_UDP4(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4 | \
-				RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_TUNNEL_MASK)) == \
-		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_OUTER_IPV4 | \
-		 RTE_MBUF_F_TX_TUNNEL_VXLAN))
+#define IS_IPV6_TCP(flag) (((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6)) == \
+		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6))
 
-#define IS_IPV4_GRE_TCP4(flag) (((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | \
-				RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_TUNNEL_MASK)) == \
-		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_OUTER_IPV4 | \
-		 RTE_MBUF_F_TX_TUNNEL_GRE))
+#define IS_IPV6_UDP(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV6)) == \
+		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV6))
 
-#define IS_IPV4_UDP(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4)) == \
-		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4))
+/* Tunneled packets, with an outer IPv4 or IPv6 header */
+#define IS_TUNNEL_PKT(flag) \
+	(((flag) & (RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_OUTER_IPV6)) != 0)
+
+#define IS_TUNNEL_TCP4(flag) (IS_TUNNEL_PKT(flag) && IS_IPV4_TCP(flag))
+
+#define IS_TUNNEL_TCP6(flag) (IS_TUNNEL_PKT(flag) && IS_IPV6_TCP(flag))
+
+#define IS_TUNNEL_UDP4(flag) (IS_TUNNEL_PKT(flag) && IS_IPV4_UDP(flag))
 
 /**
  * Internal function which updates the UDP header of a packet, following
@@ -111,6 +112,73 @@ update_ipv4_header(struct rte_mbuf *pkt, uint16_t l3_offset, uint16_t id)
 	ipv4_hdr->packet_id = rte_cpu_to_be_16(id);
 }
 
+/**
+ * Internal function which updates the IPv6 header of a packet, following
+ * segmentation. This is required to update the header's 'payload_len' field,
+ * to reflect the reduced length of the now-segmented packet.
+ *
+ * @param pkt
+ *  The packet containing the IPv6 header.
+ * @param l3_offset
+ *  The offset of the IPv6 header from the start of the packet.
+ */
+static inline void
+update_ipv6_header(struct rte_mbuf *pkt, uint16_t l3_offset)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+
+	ipv6_hdr = (struct rte_ipv6_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
+			l3_offset);
+	ipv6_hdr->payload_len = rte_cpu_to_be_16(pkt->pkt_len - l3_offset -
+			sizeof(struct rte_ipv6_hdr));
+}
+
+/**
+ * Internal function which updates the outer headers of a tunneled packet,
+ * following segmentation. The outer IPv4 or IPv6 header is updated and, for
+ * VxLAN and Geneve packets, the outer UDP header too.
+ *
+ * @param pkt
+ *  The tunneled packet.
+ * @param outer_id
+ *  The new ID of the packet, if the outer header is an IPv4 one.
+ */
+static inline void
+update_tunnel_outer_headers(struct rte_mbuf *pkt, uint16_t outer_id)
+{
+	uint64_t tunnel = pkt->ol_flags & RTE_MBUF_F_TX_TUNNEL_MASK;
+	uint16_t outer_l3_offset = pkt->outer_l2_len;
+
+	if (pkt->ol_flags & RTE_MBUF_F_TX_OUTER_IPV4)
+		update_ipv4_header(pkt, outer_l3_offset, outer_id);
+	else
+		update_ipv6_header(pkt, outer_l3_offset);
+
+	if (tunnel == RTE_MBUF_F_TX_TUNNEL_VXLAN ||
+			tunnel == RTE_MBUF_F_TX_TUNNEL_GENEVE)
+		update_udp_header(pkt, outer_l3_offset + pkt->outer_l3_len);
+}
+
+/**
+ * Internal function which gets the ID of the outer IPv4 header of a
+ * tunneled packet. Zero is returned if the outer header is an IPv6 one.
+ *
+ * @param pkt
+ *  The tunneled packet.
+ */
+static inline uint16_t
+get_tunnel_outer_id(struct rte_mbuf *pkt)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+
+	if ((pkt->ol_flags & RTE_MBUF_F_TX_OUTER_IPV4) == 0)
+		return 0;
+
+	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
+			pkt->outer_l2_len);
+	return rte_be_to_cpu_16(ipv4_hdr->packet_id);
+}
+
 /**
  * Internal function which divides the input packet into small segments.
  * Each of the newly-created segments is organized as a two-segment MBUF,
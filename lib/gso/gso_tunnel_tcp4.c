@@ -13,19 +13,13 @@ update_tunnel_ipv4_tcp_headers(struct rte_mbuf *pkt, uint8_t ipid_delta,
 	struct rte_tcp_hdr *tcp_hdr;
 	uint32_t sent_seq;
 	uint16_t outer_id, inner_id, tail_idx, i;
-	uint16_t outer_ipv4_offset, inner_ipv4_offset;
-	uint16_t udp_gre_offset, tcp_offset;
-	uint8_t update_udp_hdr;
+	uint16_t inner_ipv4_offset, tcp_offset;
 
-	outer_ipv4_offset = pkt->outer_l2_len;
-	udp_gre_offset = outer_ipv4_offset + pkt->outer_l3_len;
-	inner_ipv4_offset = udp_gre_offset + pkt->l2_len;
+	inner_ipv4_offset = pkt->outer_l2_len + pkt->outer_l3_len + pkt->l2_len;
 	tcp_offset = inner_ipv4_offset + pkt->l3_len;
 
-	/* Outer IPv4 header. */
-	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
-			outer_ipv4_offset);
-	outer_id = rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	/* Outer IPv4 header, if any. */
+	outer_id = get_tunnel_outer_id(pkt);
 
 	/* Inner IPv4 header. */
 	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
@@ -36,13 +30,8 @@ update_tunnel_ipv4_tcp_headers(struct rte_mbuf *pkt, uint8_t ipid_delta,
 	sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
 	tail_idx = nb_segs - 1;
 
-	/* Only update UDP header for VxLAN packets. */
-	update_udp_hdr = (pkt->ol_flags & RTE_MBUF_F_TX_TUNNEL_VXLAN) ? 1 : 0;
-
 	for (i = 0; i < nb_segs; i++) {
-		update_ipv4_header(segs[i], outer_ipv4_offset, outer_id);
-		if (update_udp_hdr)
-			update_udp_header(segs[i], udp_gre_offset);
+		update_tunnel_outer_headers(segs[i], outer_id);
 		update_ipv4_header(segs[i], inner_ipv4_offset, inner_id);
 		update_tcp_header(segs[i], tcp_offset, sent_seq, i < tail_idx);
 		outer_id++;
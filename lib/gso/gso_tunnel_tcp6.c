@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include "gso_common.h"
+#include "gso_tunnel_tcp6.h"
+
+static void
+update_tunnel_ipv6_tcp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct rte_tcp_hdr *tcp_hdr;
+	uint32_t sent_seq;
+	uint16_t outer_id, tail_idx, i;
+	uint16_t inner_ipv6_offset, tcp_offset;
+
+	inner_ipv6_offset = pkt->outer_l2_len + pkt->outer_l3_len + pkt->l2_len;
+	tcp_offset = inner_ipv6_offset + pkt->l3_len;
+
+	/* Outer IPv4 header, if any. */
+	outer_id = get_tunnel_outer_id(pkt);
+
+	tcp_hdr = (struct rte_tcp_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
+			tcp_offset);
+	sent_seq = rte_be_to_cpu_32(tcp_hdr->sent_seq);
+	tail_idx = nb_segs - 1;
+
+	for (i = 0; i < nb_segs; i++) {
+		update_tunnel_outer_headers(segs[i], outer_id);
+		update_ipv6_header(segs[i], inner_ipv6_offset);
+		update_tcp_header(segs[i], tcp_offset, sent_seq, i < tail_idx);
+		outer_id++;
+		sent_seq += (segs[i]->pkt_len - segs[i]->data_len);
+	}
+}
+
+int
+gso_tunnel_tcp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct rte_ipv6_hdr *inner_ipv6_hdr;
+	uint16_t pyld_unit_size, hdr_offset;
+	int ret;
+
+	hdr_offset = pkt->outer_l2_len + pkt->outer_l3_len + pkt->l2_len;
+	inner_ipv6_hdr = (struct rte_ipv6_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
+			hdr_offset);
+	/* Don't process the packet which is an inner IPv6 fragment. */
+	if (unlikely(inner_ipv6_hdr->proto == IPPROTO_FRAGMENT))
+		return 0;
+
+	hdr_offset += pkt->l3_len + pkt->l4_len;
+	/* Don't process the packet without data */
+	if (hdr_offset >= pkt->pkt_len)
+		return 0;
+	pyld_unit_size = gso_size - hdr_offset;
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1)
+		update_tunnel_ipv6_tcp_headers(pkt, pkts_out, ret);
+
+	return ret;
+}
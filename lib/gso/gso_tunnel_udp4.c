@@ -13,18 +13,13 @@ update_tunnel_ipv4_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
 {
 	struct rte_ipv4_hdr *ipv4_hdr;
 	uint16_t outer_id, inner_id, tail_idx, i, length;
-	uint16_t outer_ipv4_offset, inner_ipv4_offset;
-	uint16_t outer_udp_offset;
+	uint16_t inner_ipv4_offset;
 	uint16_t frag_offset = 0, is_mf;
 
-	outer_ipv4_offset = pkt->outer_l2_len;
-	outer_udp_offset = outer_ipv4_offset + pkt->outer_l3_len;
-	inner_ipv4_offset = outer_udp_offset + pkt->l2_len;
+	inner_ipv4_offset = pkt->outer_l2_len + pkt->outer_l3_len + pkt->l2_len;
 
-	/* Outer IPv4 header. */
-	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
-			outer_ipv4_offset);
-	outer_id = rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	/* Outer IPv4 header, if any. */
+	outer_id = get_tunnel_outer_id(pkt);
 
 	/* Inner IPv4 header. */
 	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
@@ -34,8 +29,7 @@ update_tunnel_ipv4_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
 	tail_idx = nb_segs - 1;
 
 	for (i = 0; i < nb_segs; i++) {
-		update_ipv4_header(segs[i], outer_ipv4_offset, outer_id);
-		update_udp_header(segs[i], outer_udp_offset);
+		update_tunnel_outer_headers(segs[i], outer_id);
 		update_ipv4_header(segs[i], inner_ipv4_offset, inner_id);
 		/* For the case inner packet is UDP, we must keep UDP
 		 * datagram boundary, it must be handled as IP fragment.
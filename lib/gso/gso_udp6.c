@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <rte_random.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+/*
+ * Insert a fragment header after the IPv6 header of each output segment,
+ * which is the last part of the header copied in the direct mbuf.
+ */
+static inline void
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	uint16_t l2_hdrlen = pkt->l2_len;
+	uint16_t tail_idx = nb_segs - 1, length, i;
+	uint16_t frag_offset = 0, is_mf;
+	rte_be32_t id = rte_cpu_to_be_32((uint32_t)rte_rand());
+
+	for (i = 0; i < nb_segs; i++) {
+		ipv6_hdr = rte_pktmbuf_mtod_offset(segs[i],
+			struct rte_ipv6_hdr *, l2_hdrlen);
+		frag_hdr = (struct rte_ipv6_fragment_ext *)(ipv6_hdr + 1);
+
+		segs[i]->data_len += RTE_IPV6_FRAG_HDR_SIZE;
+		segs[i]->pkt_len += RTE_IPV6_FRAG_HDR_SIZE;
+		segs[i]->l3_len += RTE_IPV6_FRAG_HDR_SIZE;
+
+		length = segs[i]->pkt_len - l2_hdrlen -
+			sizeof(struct rte_ipv6_hdr);
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(length);
+		ipv6_hdr->proto = IPPROTO_FRAGMENT;
+
+		is_mf = i < tail_idx ? 1 : 0;
+		frag_hdr->next_header = IPPROTO_UDP;
+		frag_hdr->reserved = 0;
+		frag_hdr->frag_data = rte_cpu_to_be_16(
+				RTE_IPV6_SET_FRAG_DATA(frag_offset, is_mf));
+		frag_hdr->id = id;
+		frag_offset += length - RTE_IPV6_FRAG_HDR_SIZE;
+	}
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t pyld_unit_size, hdr_offset;
+	int ret;
+
+	/*
+	 * Don't process the packet with extension headers, the fragment
+	 * header would have to be inserted among them.
+	 */
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			pkt->l2_len);
+	if (unlikely(ipv6_hdr->proto != IPPROTO_UDP ||
+			pkt->l3_len != sizeof(struct rte_ipv6_hdr)))
+		return 0;
+
+	/*
+	 * UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2
+	 * and l3 headers.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len))
+		return 0;
+
+	/* pyld_unit_size must be a multiple of 8 because the fragment
+	 * offset uses 8 bytes as unit. Room is left for the fragment
+	 * header.
+	 */
+	pyld_unit_size = (gso_size - hdr_offset - RTE_IPV6_FRAG_HDR_SIZE) &
+		~7U;
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1)
+		update_ipv6_udp_headers(pkt, pkts_out, ret);
+
+	return ret;
+}
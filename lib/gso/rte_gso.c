@@ -10,9 +10,12 @@
 #include "rte_gso.h"
 #include "gso_common.h"
 #include "gso_tcp4.h"
+#include "gso_tcp6.h"
 #include "gso_tunnel_tcp4.h"
+#include "gso_tunnel_tcp6.h"
 #include "gso_tunnel_udp4.h"
 #include "gso_udp4.h"
+#include "gso_udp6.h"
 
 #define ILLEGAL_UDP_GSO_CTX(ctx) \
 	((((ctx)->gso_types & RTE_ETH_TX_OFFLOAD_UDP_TSO) == 0) || \
@@ -21,9 +24,26 @@
 #define ILLEGAL_TCP_GSO_CTX(ctx) \
 	((((ctx)->gso_types & (RTE_ETH_TX_OFFLOAD_TCP_TSO | \
 		RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO | \
-		RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO)) == 0) || \
+		RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO | \
+		RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO)) == 0) || \
 		(ctx)->gso_size < RTE_GSO_SEG_SIZE_MIN)
 
+/* Get the GSO type required to segment a tunneled packet */
+static inline uint64_t
+gso_tunnel_type(uint64_t ol_flags)
+{
+	switch (ol_flags & RTE_MBUF_F_TX_TUNNEL_MASK) {
+	case RTE_MBUF_F_TX_TUNNEL_VXLAN:
+		return RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO;
+	case RTE_MBUF_F_TX_TUNNEL_GRE:
+		return RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO;
+	case RTE_MBUF_F_TX_TUNNEL_GENEVE:
+		return RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO;
+	default:
+		return 0;
+	}
+}
+
 int
 rte_gso_segment(struct rte_mbuf *pkt,
 		const struct rte_gso_ctx *gso_ctx,
@@ -31,7 +51,7 @@ rte_gso_segment(struct rte_mbuf *pkt,
 		uint16_t nb_pkts_out)
 {
 	struct rte_mempool *direct_pool, *indirect_pool;
-	uint64_t ol_flags;
+	uint64_t ol_flags, tunnel_type;
 	uint16_t gso_size;
 	uint8_t ipid_delta;
 	int ret = 1;
@@ -53,16 +73,22 @@ rte_gso_segment(struct rte_mbuf *pkt,
 	ipid_delta = (gso_ctx->flag != RTE_GSO_FLAG_IPID_FIXED);
 	ol_flags = pkt->ol_flags;
 
-	if ((IS_IPV4_VXLAN_TCP4(pkt->ol_flags) &&
-			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO)) ||
-			((IS_IPV4_GRE_TCP4(pkt->ol_flags) &&
-			 (gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO)))) {
+	tunnel_type = gso_tunnel_type(ol_flags);
+	if ((gso_ctx->gso_types & tunnel_type) == 0)
+		tunnel_type = 0;
+
+	if (tunnel_type != 0 && IS_TUNNEL_TCP4(pkt->ol_flags)) {
 		pkt->ol_flags &= (~RTE_MBUF_F_TX_TCP_SEG);
 		ret = gso_tunnel_tcp4_segment(pkt, gso_size, ipid_delta,
 				direct_pool, indirect_pool,
 				pkts_out, nb_pkts_out);
-	} else if (IS_IPV4_VXLAN_UDP4(pkt->ol_flags) &&
-			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO) &&
+	} else if (tunnel_type != 0 && IS_TUNNEL_TCP6(pkt->ol_flags)) {
+		pkt->ol_flags &= (~RTE_MBUF_F_TX_TCP_SEG);
+		ret = gso_tunnel_tcp6_segment(pkt, gso_size,
+				direct_pool, indirect_pool,
+				pkts_out, nb_pkts_out);
+	} else if (tunnel_type != 0 && IS_TUNNEL_UDP4(pkt->ol_flags) &&
+			tunnel_type != RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO &&
 			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_UDP_TSO)) {
 		pkt->ol_flags &= (~RTE_MBUF_F_TX_UDP_SEG);
 		ret = gso_tunnel_udp4_segment(pkt, gso_size,
@@ -79,6 +105,16 @@ rte_gso_segment(struct rte_mbuf *pkt,
 		pkt->ol_flags &= (~RTE_MBUF_F_TX_UDP_SEG);
 		ret = gso_udp4_segment(pkt, gso_size, direct_pool,
 				indirect_pool, pkts_out, nb_pkts_out);
+	} else if (IS_IPV6_TCP(pkt->ol_flags) &&
+			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_TCP_TSO)) {
+		pkt->ol_flags &= (~RTE_MBUF_F_TX_TCP_SEG);
+		ret = gso_tcp6_segment(pkt, gso_size, direct_pool,
+				indirect_pool, pkts_out, nb_pkts_out);
+	} else if (IS_IPV6_UDP(pkt->ol_flags) &&
+			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_UDP_TSO)) {
+		pkt->ol_flags &= (~RTE_MBUF_F_TX_UDP_SEG);
+		ret = gso_udp6_segment(pkt, gso_size, direct_pool,
+				indirect_pool, pkts_out, nb_pkts_out);
 	} else {
 		/* unsupported packet, skip */
 		RTE_LOG(DEBUG, GSO, "Unsupported packet type\n");
@@ -55,7 +55,7 @@ struct rte_gso_ctx {
 	 * offloading capabilities (i.e. RTE_ETH_TX_OFFLOAD_*_TSO) for
 	 * gso_types.
 	 *
-	 * For example, if applications want to segment TCP/IPv4
+	 * For example, if applications want to segment TCP/IPv4 or TCP/IPv6
 	 * packets, set RTE_ETH_TX_OFFLOAD_TCP_TSO in gso_types.
 	 */
 	uint16_t gso_size;
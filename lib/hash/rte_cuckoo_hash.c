@@ -34,7 +34,8 @@
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_RESIZABLE)
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -154,6 +155,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	uint32_t *tbl_chng_cnt = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int resizable = 0;
+	uint32_t key_entry_size;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -189,6 +192,16 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) &&
+	    (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD |
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY |
+				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: resizable table supports "
+			"a single writer and lock free readers only\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -218,6 +231,9 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		no_free_on_del = 1;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE)
+		resizable = 1;
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (use_local_cache)
 		/*
@@ -327,9 +343,16 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		}
 	}
 
-	const uint32_t key_entry_size =
-		RTE_ALIGN(sizeof(struct rte_hash_key) + params->key_len,
-			  KEY_ALIGNMENT);
+	/* A resizable table keeps the hash of each key after it, to split
+	 * buckets without rehashing the keys.
+	 */
+	if (resizable)
+		key_entry_size = RTE_ALIGN(RTE_ALIGN(sizeof(struct rte_hash_key) +
+				params->key_len, sizeof(hash_sig_t)) +
+				sizeof(hash_sig_t), KEY_ALIGNMENT);
+	else
+		key_entry_size = RTE_ALIGN(sizeof(struct rte_hash_key) +
+				params->key_len, KEY_ALIGNMENT);
 	const uint64_t key_tbl_size = (uint64_t) key_entry_size * num_key_slots;
 
 	k = rte_zmalloc_socket(NULL, key_tbl_size,
@@ -431,6 +454,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resizable = resizable;
+	h->socket_id = params->socket_id;
 
 #if defined(RTE_ARCH_X86)
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
@@ -486,6 +511,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	struct rte_hash_resize *rs;
 
 	if (h == NULL)
 		return;
@@ -516,6 +542,23 @@ rte_hash_free(struct rte_hash *h)
 		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
 		rte_free(h->readwrite_lock);
+	/* There is no resize in progress while one is retired */
+	rs = h->resize != NULL ? h->resize : h->retired;
+	if (rs != NULL) {
+		/* Free what the resize has allocated */
+		rte_ring_free(rs->free_slots);
+		if (h->key_store == rs->old_key_store)
+			rte_free(rs->new_key_store);
+		else
+			rte_free(rs->old_key_store);
+		rte_free(rs->buckets);
+		rte_free(rs->migrated);
+		rte_free(rs);
+	}
+	if (h->expiry != NULL) {
+		rte_free(h->expiry->nodes);
+		rte_free(h->expiry);
+	}
 	rte_ring_free(h->free_slots);
 	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
@@ -610,6 +653,349 @@ __hash_rw_reader_unlock(const struct rte_hash *h)
 		rte_rwlock_read_unlock(h->readwrite_lock);
 }
 
+/*
+ * Writer lock helpers for the add/delete paths, which bulk APIs call with
+ * the writer lock already held for the whole burst (@locked != 0).
+ */
+static inline void
+__hash_rw_writer_lock_opt(const struct rte_hash *h, int locked)
+{
+	if (!locked)
+		__hash_rw_writer_lock(h);
+}
+
+static inline void
+__hash_rw_writer_unlock_opt(const struct rte_hash *h, int locked)
+{
+	if (!locked)
+		__hash_rw_writer_unlock(h);
+}
+
+/*
+ * Resizable table (RTE_HASH_EXTRA_FLAGS_RESIZABLE).
+ *
+ * When an add finds three quarters of the key slots in use, a table twice
+ * as large is allocated and becomes the current one (h->buckets), while
+ * the previous buckets are kept in h->resize. A key found in old bucket B
+ * moves to bucket B or B + old size of the new table, so each old bucket
+ * can be split on its own, using the hash stored next to the key. Every
+ * following add migrates the old buckets of its key, then
+ * RTE_HASH_RESIZE_STEP more, and copies the matching share of the key
+ * store. Readers look in both tables until the migration is over.
+ *
+ * The key store is then switched to the new, larger copy and the old
+ * table is no longer published. Lock free readers may still use the old
+ * key store and buckets, so the resize is moved to h->retired, and they
+ * are freed, and the new key slots are made available, only after a grace
+ * period of the RCU QSBR variable of the table started after that.
+ *
+ * There is a single writer, so the writer side needs no lock.
+ */
+
+/* Hash value of the key stored in a key slot of a resizable table */
+static inline hash_sig_t *
+__hash_resize_key_sig(const struct rte_hash *h, struct rte_hash_key *k)
+{
+	return RTE_PTR_ADD(k, RTE_ALIGN(sizeof(struct rte_hash_key) +
+			h->key_len, sizeof(hash_sig_t)));
+}
+
+/*
+ * Mirror a write to key slot @slot_id of the current key store to the
+ * other key store, when readers may use either of them.
+ */
+static inline void
+__hash_resize_mirror_key(const struct rte_hash *h, uint32_t slot_id)
+{
+	const struct rte_hash_resize *rs =
+			h->resize != NULL ? h->resize : h->retired;
+	struct rte_hash_key *src, *dst;
+
+	if (rs == NULL || slot_id >= rs->copied)
+		return;
+
+	src = RTE_PTR_ADD(h->key_store, slot_id * h->key_entry_size);
+	dst = RTE_PTR_ADD(h->key_store == rs->old_key_store ?
+			rs->new_key_store : rs->old_key_store,
+			slot_id * h->key_entry_size);
+	memcpy(dst->key, src->key, h->key_entry_size - sizeof(*dst));
+	__atomic_store_n(&dst->pdata, src->pdata, __ATOMIC_RELEASE);
+}
+
+/*
+ * Load the current buckets of a resizable table, and the resize in
+ * progress if any. The writer publishes the resize, then the new buckets,
+ * then their bitmask: a bitmask which did not change while loading the
+ * others matches the buckets, or the old buckets are searched as well.
+ */
+static inline const struct rte_hash_resize *
+__hash_resize_snapshot(const struct rte_hash *h,
+		const struct rte_hash_bucket **buckets, uint32_t *bucket_bitmask)
+{
+	const struct rte_hash_resize *rs;
+	uint32_t mask;
+
+	do {
+		mask = __atomic_load_n(&h->bucket_bitmask, __ATOMIC_ACQUIRE);
+		*buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+		rs = __atomic_load_n(&h->resize, __ATOMIC_ACQUIRE);
+	} while (mask != __atomic_load_n(&h->bucket_bitmask,
+			__ATOMIC_ACQUIRE));
+
+	*bucket_bitmask = mask;
+	return rs;
+}
+
+static void
+__hash_resize_start(struct rte_hash *h)
+{
+	char ring_name[RTE_RING_NAMESIZE];
+	struct rte_hash_resize *rs;
+	struct rte_hash_bucket *buckets = NULL;
+	const uint32_t entries = h->entries * 2;
+	const uint32_t num_buckets = h->num_buckets * 2;
+
+	if (h->entries > RTE_HASH_ENTRIES_MAX / 2)
+		return;
+
+	/* Lock free readers may use the old table until a grace period */
+	if (h->readwrite_concur_lf_support && h->hash_rcu_cfg == NULL)
+		return;
+
+	rs = rte_zmalloc_socket(NULL, sizeof(*rs), 0, h->socket_id);
+	if (rs == NULL)
+		goto err;
+
+	rs->migrated = rte_zmalloc_socket(NULL,
+			RTE_ALIGN_CEIL(h->num_buckets, 64) / 8, 0,
+			h->socket_id);
+	buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	rs->new_key_store = rte_zmalloc_socket(NULL,
+			(uint64_t)h->key_entry_size * (entries + 1),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+
+	/* Alternate between two names, the old ring is freed in between */
+	snprintf(ring_name, sizeof(ring_name),
+			strncmp(h->free_slots->name, "HT_", 3) == 0 ?
+			"HTR_%s" : "HT_%s", h->name);
+	rs->free_slots = rte_ring_create_elem(ring_name, sizeof(uint32_t),
+			rte_align32pow2(entries + 1), h->socket_id, 0);
+
+	if (rs->migrated == NULL || buckets == NULL ||
+			rs->new_key_store == NULL || rs->free_slots == NULL)
+		goto err;
+
+	rs->buckets = h->buckets;
+	rs->num_buckets = h->num_buckets;
+	rs->bucket_bitmask = h->bucket_bitmask;
+	rs->old_key_store = h->key_store;
+	rs->num_key_slots = h->entries + 1;
+	rs->entries = entries;
+
+	/* See __hash_resize_snapshot() for the order of these stores */
+	__atomic_store_n(&h->resize, rs, __ATOMIC_RELEASE);
+	__atomic_store_n(&h->buckets, buckets, __ATOMIC_RELEASE);
+	h->num_buckets = num_buckets;
+	__atomic_store_n(&h->bucket_bitmask, num_buckets - 1,
+			__ATOMIC_RELEASE);
+	return;
+
+err:
+	RTE_LOG(DEBUG, HASH, "%s: cannot allocate a larger table\n", h->name);
+	if (rs != NULL) {
+		rte_ring_free(rs->free_slots);
+		rte_free(rs->new_key_store);
+		rte_free(rs->migrated);
+	}
+	rte_free(buckets);
+	rte_free(rs);
+}
+
+/* Split old bucket @bkt_idx into the two new buckets it maps to */
+static void
+__hash_resize_migrate_bucket(const struct rte_hash *h,
+		struct rte_hash_resize *rs, uint32_t bkt_idx)
+{
+	struct rte_hash_bucket *old_bkt = &rs->buckets[bkt_idx];
+	struct rte_hash_bucket *new_bkt;
+	struct rte_hash_key *k;
+	uint32_t i, j, key_idx, new_idx;
+	hash_sig_t sig;
+
+	if (rs->migrated[bkt_idx / 64] & (1ULL << (bkt_idx % 64)))
+		return;
+
+	if (h->readwrite_concur_lf_support) {
+		/* Inform the readers that the table has changed.
+		 * Since there is one writer, load acquire on
+		 * tbl_chng_cnt is not required.
+		 */
+		__atomic_store_n(h->tbl_chng_cnt,
+				 *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+		/* The stores to the buckets should not move above the
+		 * store to tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		key_idx = old_bkt->key_idx[i];
+		if (key_idx == EMPTY_SLOT)
+			continue;
+
+		k = RTE_PTR_ADD(h->key_store, key_idx * h->key_entry_size);
+		sig = *__hash_resize_key_sig(h, k);
+		new_idx = get_prim_bucket_index(h, sig);
+		/* The key is in the old bucket as alternative location */
+		if ((new_idx & rs->bucket_bitmask) != bkt_idx)
+			new_idx = get_alt_bucket_index(h, new_idx,
+					old_bkt->sig_current[i]);
+
+		/* Nothing is added to the two new buckets before the old
+		 * one is split, there is room for all of its entries.
+		 */
+		new_bkt = &h->buckets[new_idx];
+		for (j = 0; new_bkt->key_idx[j] != EMPTY_SLOT; j++)
+			;
+		new_bkt->sig_current[j] = old_bkt->sig_current[i];
+		__atomic_store_n(&new_bkt->key_idx[j], key_idx,
+				__ATOMIC_RELEASE);
+	}
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		old_bkt->sig_current[i] = NULL_SIGNATURE;
+		__atomic_store_n(&old_bkt->key_idx[i], EMPTY_SLOT,
+				__ATOMIC_RELEASE);
+	}
+
+	rs->migrated[bkt_idx / 64] |= 1ULL << (bkt_idx % 64);
+	rs->nb_migrated++;
+}
+
+/* Free the old table and make the new key slots available */
+static void
+__hash_resize_complete(struct rte_hash *h, struct rte_hash_resize *rs)
+{
+	uint32_t slots[LCORE_CACHE_SIZE];
+	uint32_t i, n;
+
+	while ((n = rte_ring_sc_dequeue_burst_elem(h->free_slots, slots,
+			sizeof(uint32_t), RTE_DIM(slots), NULL)) != 0)
+		rte_ring_sp_enqueue_bulk_elem(rs->free_slots, slots,
+				sizeof(uint32_t), n, NULL);
+	for (i = rs->num_key_slots; i <= rs->entries; i++)
+		rte_ring_sp_enqueue_elem(rs->free_slots, &i, sizeof(uint32_t));
+
+	rte_ring_free(h->free_slots);
+	h->free_slots = rs->free_slots;
+	h->entries = rs->entries;
+	h->retired = NULL;
+
+	rte_free(rs->old_key_store);
+	rte_free(rs->buckets);
+	rte_free(rs->migrated);
+	rte_free(rs);
+}
+
+/* Switch to the new key store once all buckets and keys are migrated */
+static void
+__hash_resize_switch(struct rte_hash *h, struct rte_hash_resize *rs)
+{
+	__atomic_store_n(&h->key_store, rs->new_key_store, __ATOMIC_RELEASE);
+	__atomic_store_n(&h->resize, NULL, __ATOMIC_RELEASE);
+	h->retired = rs;
+
+	/* Readers which can still reach the old table started before the
+	 * old table was unpublished, so before the token is taken.
+	 */
+	if (h->readwrite_concur_lf_support)
+		rs->token = rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+	else
+		__hash_resize_complete(h, rs);
+}
+
+/* Migrate the next old buckets and the matching share of the key store */
+static void
+__hash_resize_step(struct rte_hash *h, struct rte_hash_resize *rs,
+		uint32_t num_buckets)
+{
+	uint32_t n;
+
+	for (n = 0; n < num_buckets && rs->next_bucket < rs->num_buckets;
+			rs->next_bucket++) {
+		if (rs->migrated[rs->next_bucket / 64] &
+				(1ULL << (rs->next_bucket % 64)))
+			continue;
+		__hash_resize_migrate_bucket(h, rs, rs->next_bucket);
+		n++;
+	}
+
+	n = RTE_MIN(num_buckets * RTE_HASH_BUCKET_ENTRIES,
+			rs->num_key_slots - rs->copied);
+	memcpy(RTE_PTR_ADD(rs->new_key_store, rs->copied * h->key_entry_size),
+		RTE_PTR_ADD(rs->old_key_store, rs->copied * h->key_entry_size),
+		n * h->key_entry_size);
+	rs->copied += n;
+
+	if (rs->nb_migrated == rs->num_buckets &&
+			rs->copied == rs->num_key_slots)
+		__hash_resize_switch(h, rs);
+}
+
+/* Complete the migration of the resize in progress at once */
+static void
+__hash_resize_finish(struct rte_hash *h, struct rte_hash_resize *rs)
+{
+	__hash_resize_step(h, rs, rs->num_buckets);
+}
+
+/*
+ * Called by writers before any change: free the old table of the retired
+ * resize once readers are done with it. Returns the resize in progress,
+ * if any.
+ */
+static inline struct rte_hash_resize *
+__hash_resize_retire(struct rte_hash *h)
+{
+	struct rte_hash_resize *rs = h->retired;
+
+	if (rs != NULL && rte_rcu_qsbr_check(h->hash_rcu_cfg->v, rs->token,
+			false) == 1)
+		__hash_resize_complete(h, rs);
+	return h->resize;
+}
+
+/*
+ * Called before adding a key of hash @sig: start growing the table if
+ * needed, and migrate the old buckets of the key so that the key is
+ * looked up and added in the new table only.
+ */
+static void
+__hash_resize_prepare_add(struct rte_hash *h, hash_sig_t sig)
+{
+	struct rte_hash_resize *rs = __hash_resize_retire(h);
+	uint32_t prim_bucket_idx;
+
+	if (rs == NULL) {
+		if (h->retired != NULL ||
+				rte_ring_count(h->free_slots) > h->entries / 4)
+			return;
+		__hash_resize_start(h);
+		rs = h->resize;
+		if (rs == NULL)
+			return;
+	}
+
+	prim_bucket_idx = sig & rs->bucket_bitmask;
+	__hash_resize_migrate_bucket(h, rs, prim_bucket_idx);
+	__hash_resize_migrate_bucket(h, rs, (prim_bucket_idx ^
+			get_short_sig(sig)) & rs->bucket_bitmask);
+	__hash_resize_step(h, rs, RTE_HASH_RESIZE_STEP);
+}
+
 void
 rte_hash_reset(struct rte_hash *h)
 {
@@ -621,6 +1007,12 @@ rte_hash_reset(struct rte_hash *h)
 
 	__hash_rw_writer_lock(h);
 
+	/* Readers are not referencing the table, end any resize now */
+	if (h->resize != NULL)
+		__hash_resize_finish(h, h->resize);
+	if (h->retired != NULL)
+		__hash_resize_complete(h, h->retired);
+
 	if (h->dq) {
 		/* Reclaim all the resources */
 		rte_rcu_qsbr_dq_reclaim(h->dq, ~0, NULL, &pending, NULL);
@@ -632,6 +1024,15 @@ rte_hash_reset(struct rte_hash *h)
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
 
+	/* No key left to expire */
+	if (h->expiry != NULL) {
+		memset(h->expiry->nodes, 0, h->expiry->num_nodes *
+				sizeof(struct rte_hash_expiry_node));
+		memset(h->expiry->heads, 0, sizeof(h->expiry->heads));
+		memset(h->expiry->occupied, 0, sizeof(h->expiry->occupied));
+		h->expiry->armed = 0;
+	}
+
 	/* reset the free ring */
 	rte_ring_reset(h->free_slots);
 
@@ -709,6 +1110,9 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 				__atomic_store_n(&k->pdata,
 					data,
 					__ATOMIC_RELEASE);
+				if (h->resizable)
+					__hash_resize_mirror_key(h,
+							bkt->key_idx[i]);
 				/*
 				 * Return index where key is stored,
 				 * subtracting the first dummy index
@@ -731,19 +1135,19 @@ rte_hash_cuckoo_insert_mw(const struct rte_hash *h,
 		struct rte_hash_bucket *sec_bkt,
 		const struct rte_hash_key *key, void *data,
 		uint16_t sig, uint32_t new_idx,
-		int32_t *ret_val)
+		int32_t *ret_val, int locked)
 {
 	unsigned int i;
 	struct rte_hash_bucket *cur_bkt;
 	int32_t ret;
 
-	__hash_rw_writer_lock(h);
+	__hash_rw_writer_lock_opt(h, locked);
 	/* Check if key was inserted after last check but before this
 	 * protected region in case of inserting duplicated keys.
 	 */
 	ret = search_and_update(h, data, key, prim_bkt, sig);
 	if (ret != -1) {
-		__hash_rw_writer_unlock(h);
+		__hash_rw_writer_unlock_opt(h, locked);
 		*ret_val = ret;
 		return 1;
 	}
@@ -751,7 +1155,7 @@ rte_hash_cuckoo_insert_mw(const struct rte_hash *h,
 	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, sig);
 		if (ret != -1) {
-			__hash_rw_writer_unlock(h);
+			__hash_rw_writer_unlock_opt(h, locked);
 			*ret_val = ret;
 			return 1;
 		}
@@ -775,7 +1179,7 @@ rte_hash_cuckoo_insert_mw(const struct rte_hash *h,
 			break;
 		}
 	}
-	__hash_rw_writer_unlock(h);
+	__hash_rw_writer_unlock_opt(h, locked);
 
 	if (i != RTE_HASH_BUCKET_ENTRIES)
 		return 0;
@@ -796,7 +1200,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			const struct rte_hash_key *key, void *data,
 			struct queue_node *leaf, uint32_t leaf_slot,
 			uint16_t sig, uint32_t new_idx,
-			int32_t *ret_val)
+			int32_t *ret_val, int locked)
 {
 	uint32_t prev_alt_bkt_idx;
 	struct rte_hash_bucket *cur_bkt;
@@ -805,11 +1209,11 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	uint32_t prev_slot, curr_slot = leaf_slot;
 	int32_t ret;
 
-	__hash_rw_writer_lock(h);
+	__hash_rw_writer_lock_opt(h, locked);
 
 	/* In case empty slot was gone before entering protected region */
 	if (curr_bkt->key_idx[curr_slot] != EMPTY_SLOT) {
-		__hash_rw_writer_unlock(h);
+		__hash_rw_writer_unlock_opt(h, locked);
 		return -1;
 	}
 
@@ -818,7 +1222,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	 */
 	ret = search_and_update(h, data, key, bkt, sig);
 	if (ret != -1) {
-		__hash_rw_writer_unlock(h);
+		__hash_rw_writer_unlock_opt(h, locked);
 		*ret_val = ret;
 		return 1;
 	}
@@ -826,7 +1230,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	FOR_EACH_BUCKET(cur_bkt, alt_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, sig);
 		if (ret != -1) {
-			__hash_rw_writer_unlock(h);
+			__hash_rw_writer_unlock_opt(h, locked);
 			*ret_val = ret;
 			return 1;
 		}
@@ -847,7 +1251,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			__atomic_store_n(&curr_bkt->key_idx[curr_slot],
 				EMPTY_SLOT,
 				__ATOMIC_RELEASE);
-			__hash_rw_writer_unlock(h);
+			__hash_rw_writer_unlock_opt(h, locked);
 			return -1;
 		}
 
@@ -905,7 +1309,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			 new_idx,
 			 __ATOMIC_RELEASE);
 
-	__hash_rw_writer_unlock(h);
+	__hash_rw_writer_unlock_opt(h, locked);
 
 	return 0;
 
@@ -921,7 +1325,7 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 			struct rte_hash_bucket *sec_bkt,
 			const struct rte_hash_key *key, void *data,
 			uint16_t sig, uint32_t bucket_idx,
-			uint32_t new_idx, int32_t *ret_val)
+			uint32_t new_idx, int32_t *ret_val, int locked)
 {
 	unsigned int i;
 	struct queue_node queue[RTE_HASH_BFS_QUEUE_MAX_LEN];
@@ -947,7 +1351,7 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 				int32_t ret = rte_hash_cuckoo_move_insert_mw(h,
 						bkt, sec_bkt, key, data,
 						tail, i, sig,
-						new_idx, ret_val);
+						new_idx, ret_val, locked);
 				if (likely(ret != -1))
 					return ret;
 			}
@@ -1002,12 +1406,12 @@ alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
-						hash_sig_t sig, void *data)
+						hash_sig_t sig, void *data, int locked)
 {
 	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
-	struct rte_hash_key *new_k, *keys = h->key_store;
+	struct rte_hash_key *new_k, *keys;
 	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
@@ -1017,6 +1421,10 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	int32_t ret_val;
 	struct rte_hash_bucket *last;
 
+	if (h->resizable)
+		__hash_resize_prepare_add((struct rte_hash *)(uintptr_t)h, sig);
+	keys = h->key_store;
+
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
@@ -1026,10 +1434,10 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	rte_prefetch0(sec_bkt);
 
 	/* Check if key is already inserted in primary location */
-	__hash_rw_writer_lock(h);
+	__hash_rw_writer_lock_opt(h, locked);
 	ret = search_and_update(h, data, key, prim_bkt, short_sig);
 	if (ret != -1) {
-		__hash_rw_writer_unlock(h);
+		__hash_rw_writer_unlock_opt(h, locked);
 		return ret;
 	}
 
@@ -1037,12 +1445,12 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, short_sig);
 		if (ret != -1) {
-			__hash_rw_writer_unlock(h);
+			__hash_rw_writer_unlock_opt(h, locked);
 			return ret;
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
+	__hash_rw_writer_unlock_opt(h, locked);
 
 	/* Did not find a match, so get a new slot for storing the new key */
 	if (h->use_local_cache) {
@@ -1052,11 +1460,11 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	slot_id = alloc_slot(h, cached_free_slots);
 	if (slot_id == EMPTY_SLOT) {
 		if (h->dq) {
-			__hash_rw_writer_lock(h);
+			__hash_rw_writer_lock_opt(h, locked);
 			ret = rte_rcu_qsbr_dq_reclaim(h->dq,
 					h->hash_rcu_cfg->max_reclaim_size,
 					NULL, NULL, NULL);
-			__hash_rw_writer_unlock(h);
+			__hash_rw_writer_unlock_opt(h, locked);
 			if (ret == 0)
 				slot_id = alloc_slot(h, cached_free_slots);
 		}
@@ -1074,10 +1482,14 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		__ATOMIC_RELEASE);
 	/* Copy key */
 	memcpy(new_k->key, key, h->key_len);
+	if (h->resizable) {
+		*__hash_resize_key_sig(h, new_k) = sig;
+		__hash_resize_mirror_key(h, slot_id);
+	}
 
 	/* Find an empty slot and insert */
 	ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt, key, data,
-					short_sig, slot_id, &ret_val);
+					short_sig, slot_id, &ret_val, locked);
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
@@ -1085,9 +1497,27 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		return ret_val;
 	}
 
+	if (h->resize != NULL) {
+		/* Moving keys around could fill new buckets which old
+		 * buckets still have to be split into: try the secondary
+		 * bucket, then complete the migration.
+		 */
+		ret = rte_hash_cuckoo_insert_mw(h, sec_bkt, prim_bkt, key,
+				data, short_sig, slot_id, &ret_val, locked);
+		if (ret == 0)
+			return slot_id - 1;
+		else if (ret == 1) {
+			enqueue_slot_back(h, cached_free_slots, slot_id);
+			return ret_val;
+		}
+		__hash_resize_finish((struct rte_hash *)(uintptr_t)h,
+				h->resize);
+	}
+
 	/* Primary bucket full, need to make space for new entry */
 	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
-				short_sig, prim_bucket_idx, slot_id, &ret_val);
+				short_sig, prim_bucket_idx, slot_id, &ret_val,
+				locked);
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
@@ -1097,7 +1527,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Also search secondary bucket to get better occupancy */
 	ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, key, data,
-				short_sig, sec_bucket_idx, slot_id, &ret_val);
+				short_sig, sec_bucket_idx, slot_id, &ret_val,
+				locked);
 
 	if (ret == 0)
 		return slot_id - 1;
@@ -1115,7 +1546,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	/* Now we need to go through the extendable bucket. Protection is needed
 	 * to protect all extendable bucket processes.
 	 */
-	__hash_rw_writer_lock(h);
+	__hash_rw_writer_lock_opt(h, locked);
 	/* We check for duplicates again since could be inserted before the lock */
 	ret = search_and_update(h, data, key, prim_bkt, short_sig);
 	if (ret != -1) {
@@ -1145,7 +1576,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 				__atomic_store_n(&cur_bkt->key_idx[i],
 						 slot_id,
 						 __ATOMIC_RELEASE);
-				__hash_rw_writer_unlock(h);
+				__hash_rw_writer_unlock_opt(h, locked);
 				return slot_id - 1;
 			}
 		}
@@ -1184,11 +1615,11 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	/* Link the new bucket to sec bucket linked list */
 	last = rte_hash_get_last_bkt(sec_bkt);
 	last->next = &h->buckets_ext[ext_bkt_id - 1];
-	__hash_rw_writer_unlock(h);
+	__hash_rw_writer_unlock_opt(h, locked);
 	return slot_id - 1;
 
 failure:
-	__hash_rw_writer_unlock(h);
+	__hash_rw_writer_unlock_opt(h, locked);
 	return ret;
 
 }
@@ -1198,14 +1629,15 @@ rte_hash_add_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, sig, 0);
+	return __rte_hash_add_key_with_hash(h, key, sig, 0, 0);
 }
 
 int32_t
 rte_hash_add_key(const struct rte_hash *h, const void *key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), 0);
+	return __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), 0,
+			0);
 }
 
 int
@@ -1215,7 +1647,7 @@ rte_hash_add_key_with_hash_data(const struct rte_hash *h,
 	int ret;
 
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	ret = __rte_hash_add_key_with_hash(h, key, sig, data);
+	ret = __rte_hash_add_key_with_hash(h, key, sig, data, 0);
 	if (ret >= 0)
 		return 0;
 	else
@@ -1229,7 +1661,8 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
 
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
-	ret = __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), data);
+	ret = __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), data,
+			0);
 	if (ret >= 0)
 		return 0;
 	else
@@ -1405,11 +1838,74 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+/* Search the primary and secondary buckets of a key in a bucket table */
+static inline int32_t
+search_buckets_rs(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		void **data, const struct rte_hash_bucket *buckets,
+		uint32_t bucket_bitmask)
+{
+	uint32_t prim_bucket_idx = sig & bucket_bitmask;
+	uint16_t short_sig = get_short_sig(sig);
+	int32_t ret;
+
+	ret = search_one_bucket_lf(h, key, short_sig, data,
+			&buckets[prim_bucket_idx]);
+	if (ret != -1)
+		return ret;
+	return search_one_bucket_lf(h, key, short_sig, data,
+			&buckets[(prim_bucket_idx ^ short_sig) &
+				bucket_bitmask]);
+}
+
+/* Lookup in a resizable table, in both tables while it is resized */
+static inline int32_t
+__rte_hash_lookup_with_hash_rs(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	const struct rte_hash_resize *rs;
+	const struct rte_hash_bucket *buckets;
+	uint32_t bucket_bitmask;
+	uint32_t cnt_b, cnt_a;
+	int32_t ret;
+
+	do {
+		/* Load the table change counter before the lookup
+		 * starts, as in __rte_hash_lookup_with_hash_lf().
+		 * Migrating a bucket increments it.
+		 */
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
+				__ATOMIC_ACQUIRE);
+
+		rs = __hash_resize_snapshot(h, &buckets, &bucket_bitmask);
+		ret = search_buckets_rs(h, key, sig, data, buckets,
+				bucket_bitmask);
+		if (ret != -1)
+			return ret;
+		if (rs != NULL) {
+			ret = search_buckets_rs(h, key, sig, data,
+					rs->buckets, rs->bucket_bitmask);
+			if (ret != -1)
+				return ret;
+		}
+
+		/* The loads of sig_current in search_one_bucket
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt,
+					__ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+
+	return -ENOENT;
+}
+
 static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resizable)
+		return __rte_hash_lookup_with_hash_rs(h, key, sig, data);
+	else if (h->readwrite_concur_lf_support)
 		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
 		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
@@ -1574,6 +2070,277 @@ rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg)
 	return 0;
 }
 
+/*
+ * Key expiry.
+ *
+ * Armed keys are linked, by key index, in the slots of a hierarchical
+ * timer wheel. Level l has 64 slots of 64^l ticks each: a key is linked
+ * in the lowest level whose span covers its distance to the current tick,
+ * and moved down a level (cascaded) when the current tick reaches the
+ * start of its slot. Keys beyond the span of the wheel are parked in the
+ * last slot of the top level and linked again when cascaded.
+ * The occupancy bitmap of each level lets rte_hash_expire() jump over
+ * the empty slots, so its cost depends on the number of expired keys.
+ */
+static void
+__hash_expiry_link(struct rte_hash_expiry *ex, uint32_t key_idx)
+{
+	struct rte_hash_expiry_node *n = &ex->nodes[key_idx];
+	uint64_t expire = RTE_MAX(n->expire, ex->cur);
+	uint64_t delta = expire - ex->cur;
+	unsigned int level, slot;
+
+	for (level = 0; level < RTE_HASH_EXPIRY_LEVELS - 1; level++)
+		if (delta < 1ULL << (RTE_HASH_EXPIRY_SLOT_BITS * (level + 1)))
+			break;
+	if (delta >= 1ULL << (RTE_HASH_EXPIRY_SLOT_BITS *
+			RTE_HASH_EXPIRY_LEVELS))
+		expire = ex->cur + (1ULL << (RTE_HASH_EXPIRY_SLOT_BITS *
+				RTE_HASH_EXPIRY_LEVELS)) - 1;
+
+	slot = (expire >> (RTE_HASH_EXPIRY_SLOT_BITS * level)) &
+			RTE_HASH_EXPIRY_SLOT_MASK;
+	ex->occupied[level] |= 1ULL << slot;
+	slot += level * RTE_HASH_EXPIRY_SLOTS;
+
+	n->slot = slot + 1;
+	n->prev = 0;
+	n->next = ex->heads[slot];
+	if (n->next != 0)
+		ex->nodes[n->next].prev = key_idx;
+	ex->heads[slot] = key_idx;
+}
+
+static void
+__hash_expiry_unlink(struct rte_hash_expiry *ex, uint32_t key_idx)
+{
+	struct rte_hash_expiry_node *n = &ex->nodes[key_idx];
+	unsigned int slot = n->slot - 1;
+
+	if (n->prev != 0)
+		ex->nodes[n->prev].next = n->next;
+	else
+		ex->heads[slot] = n->next;
+	if (n->next != 0)
+		ex->nodes[n->next].prev = n->prev;
+
+	if (ex->heads[slot] == 0)
+		ex->occupied[slot / RTE_HASH_EXPIRY_SLOTS] &=
+			~(1ULL << (slot & RTE_HASH_EXPIRY_SLOT_MASK));
+	n->slot = 0;
+}
+
+/* Cancel the expiry of a key, if armed. Writer holds the lock. */
+static inline void
+__hash_expiry_cancel(struct rte_hash_expiry *ex, uint32_t key_idx)
+{
+	if (key_idx < ex->num_nodes && ex->nodes[key_idx].slot != 0) {
+		__hash_expiry_unlink(ex, key_idx);
+		ex->armed--;
+	}
+}
+
+/* Move the keys of the slots starting at the current tick a level down */
+static void
+__hash_expiry_cascade(struct rte_hash_expiry *ex)
+{
+	unsigned int level, slot;
+	uint32_t key_idx;
+
+	for (level = 1; level < RTE_HASH_EXPIRY_LEVELS; level++) {
+		if ((ex->cur & ((1ULL << (RTE_HASH_EXPIRY_SLOT_BITS *
+				level)) - 1)) != 0)
+			break;
+		slot = level * RTE_HASH_EXPIRY_SLOTS +
+			((ex->cur >> (RTE_HASH_EXPIRY_SLOT_BITS * level)) &
+			 RTE_HASH_EXPIRY_SLOT_MASK);
+		while ((key_idx = ex->heads[slot]) != 0) {
+			__hash_expiry_unlink(ex, key_idx);
+			__hash_expiry_link(ex, key_idx);
+		}
+	}
+}
+
+/* First tick after the current one where a slot of the wheel is due */
+static uint64_t
+__hash_expiry_next(const struct rte_hash_expiry *ex)
+{
+	uint64_t next = UINT64_MAX;
+	uint64_t period, occupied;
+	unsigned int level, shift;
+
+	for (level = 0; level < RTE_HASH_EXPIRY_LEVELS; level++) {
+		if (ex->occupied[level] == 0)
+			continue;
+		period = ex->cur >> (RTE_HASH_EXPIRY_SLOT_BITS * level);
+		/* Rotate so that bit 0 is the slot after the current one */
+		shift = (period + 1) & RTE_HASH_EXPIRY_SLOT_MASK;
+		occupied = (ex->occupied[level] >> shift) |
+			(ex->occupied[level] << ((64 - shift) & 63));
+		period += rte_bsf64(occupied) + 1;
+		next = RTE_MIN(next,
+			period << (RTE_HASH_EXPIRY_SLOT_BITS * level));
+	}
+	return next;
+}
+
+int
+rte_hash_expiry_enable(struct rte_hash *h,
+		const struct rte_hash_expiry_config *cfg)
+{
+	struct rte_hash_expiry *ex;
+	int ret = 0;
+
+	if (h == NULL || cfg == NULL || cfg->tick == 0)
+		return -EINVAL;
+
+	__hash_rw_writer_lock(h);
+	if (h->expiry != NULL) {
+		ret = -EEXIST;
+		goto exit;
+	}
+
+	ex = rte_zmalloc_socket(NULL, sizeof(*ex), RTE_CACHE_LINE_SIZE,
+			h->socket_id);
+	if (ex == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		ret = -ENOMEM;
+		goto exit;
+	}
+	ex->num_nodes = rte_hash_max_key_id(h) + 1;
+	ex->nodes = rte_zmalloc_socket(NULL,
+			ex->num_nodes * sizeof(struct rte_hash_expiry_node),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	if (ex->nodes == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		rte_free(ex);
+		ret = -ENOMEM;
+		goto exit;
+	}
+	ex->tick = cfg->tick;
+	ex->cur = cfg->now / cfg->tick;
+	h->expiry = ex;
+
+exit:
+	__hash_rw_writer_unlock(h);
+	return ret;
+}
+
+int
+rte_hash_expiry_set(struct rte_hash *h, int32_t position, uint64_t expire)
+{
+	struct rte_hash_expiry *ex;
+	struct rte_hash_expiry_node *nodes;
+	uint32_t key_idx = position + 1;
+	uint32_t num_nodes;
+	int ret = 0;
+
+	if (h == NULL || h->expiry == NULL || position < 0 ||
+			key_idx > (uint32_t)rte_hash_max_key_id(h))
+		return -EINVAL;
+
+	ex = h->expiry;
+	__hash_rw_writer_lock(h);
+
+	/* The key slots of a resizable table grow with it */
+	if (key_idx >= ex->num_nodes) {
+		num_nodes = rte_hash_max_key_id(h) + 1;
+		nodes = rte_realloc_socket(ex->nodes,
+				num_nodes * sizeof(struct rte_hash_expiry_node),
+				RTE_CACHE_LINE_SIZE, h->socket_id);
+		if (nodes == NULL) {
+			ret = -ENOMEM;
+			goto exit;
+		}
+		memset(&nodes[ex->num_nodes], 0, (num_nodes - ex->num_nodes) *
+				sizeof(struct rte_hash_expiry_node));
+		ex->nodes = nodes;
+		ex->num_nodes = num_nodes;
+	}
+
+	__hash_expiry_cancel(ex, key_idx);
+	/* Round up, a key never expires early */
+	ex->nodes[key_idx].expire = expire / ex->tick +
+			(expire % ex->tick != 0);
+	__hash_expiry_link(ex, key_idx);
+	ex->armed++;
+
+exit:
+	__hash_rw_writer_unlock(h);
+	return ret;
+}
+
+int
+rte_hash_expiry_cancel(struct rte_hash *h, int32_t position)
+{
+	struct rte_hash_expiry *ex;
+	uint32_t key_idx = position + 1;
+	int ret = -ENOENT;
+
+	if (h == NULL || h->expiry == NULL || position < 0)
+		return -EINVAL;
+
+	ex = h->expiry;
+	__hash_rw_writer_lock(h);
+	if (key_idx < ex->num_nodes && ex->nodes[key_idx].slot != 0) {
+		__hash_expiry_cancel(ex, key_idx);
+		ret = 0;
+	}
+	__hash_rw_writer_unlock(h);
+	return ret;
+}
+
+int
+rte_hash_expire(struct rte_hash *h, uint64_t now, const void **keys,
+		void **data, int32_t *positions, unsigned int max)
+{
+	struct rte_hash_expiry *ex;
+	struct rte_hash_key *k;
+	uint64_t now_tick;
+	unsigned int slot, n = 0;
+	uint32_t key_idx;
+
+	if (h == NULL || h->expiry == NULL || keys == NULL ||
+			positions == NULL)
+		return -EINVAL;
+
+	ex = h->expiry;
+	now_tick = now / ex->tick;
+
+	__hash_rw_writer_lock(h);
+	while (ex->cur <= now_tick && n < max) {
+		if (ex->armed == 0) {
+			ex->cur = now_tick + 1;
+			ex->cascaded = 0;
+			break;
+		}
+		if (!ex->cascaded) {
+			__hash_expiry_cascade(ex);
+			ex->cascaded = 1;
+		}
+
+		slot = ex->cur & RTE_HASH_EXPIRY_SLOT_MASK;
+		while (n < max && (key_idx = ex->heads[slot]) != 0) {
+			__hash_expiry_unlink(ex, key_idx);
+			ex->armed--;
+			k = (struct rte_hash_key *)((char *)h->key_store +
+					key_idx * h->key_entry_size);
+			keys[n] = k->key;
+			if (data != NULL)
+				data[n] = k->pdata;
+			positions[n++] = key_idx - 1;
+		}
+		if (ex->heads[slot] != 0)
+			break;
+
+		ex->cur = RTE_MIN(__hash_expiry_next(ex), now_tick + 1);
+		ex->cascaded = 0;
+	}
+	__hash_rw_writer_unlock(h);
+
+	return n;
+}
+
 static inline void
 remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt,
 		unsigned int i)
@@ -1674,7 +2441,7 @@ search_and_remove(const struct rte_hash *h, const void *key,
 
 static inline int32_t
 __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
-						hash_sig_t sig)
+						hash_sig_t sig, int locked)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *prev_bkt, *last_bkt;
@@ -1684,13 +2451,17 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	uint16_t short_sig;
 	uint32_t index = EMPTY_SLOT;
 	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+	struct rte_hash_resize *rs = NULL;
+
+	if (h->resizable)
+		rs = __hash_resize_retire((struct rte_hash *)(uintptr_t)h);
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
 
-	__hash_rw_writer_lock(h);
+	__hash_rw_writer_lock_opt(h, locked);
 	/* look for key in primary bucket */
 	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
 	if (ret != -1) {
@@ -1713,7 +2484,24 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
+	/* The key may not have been migrated yet, keys are not moved
+	 * on delete so that deleting while iterating remains safe.
+	 */
+	if (rs != NULL) {
+		prim_bucket_idx = sig & rs->bucket_bitmask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+				rs->bucket_bitmask;
+		ret = search_and_remove(h, key, &rs->buckets[prim_bucket_idx],
+				short_sig, &pos);
+		if (ret == -1)
+			ret = search_and_remove(h, key,
+					&rs->buckets[sec_bucket_idx],
+					short_sig, &pos);
+		if (ret != -1)
+			goto return_key;
+	}
+
+	__hash_rw_writer_unlock_opt(h, locked);
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
@@ -1755,6 +2543,9 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	}
 
 return_key:
+	if (h->expiry != NULL)
+		__hash_expiry_cancel(h->expiry, ret + 1);
+
 	/* Using internal RCU QSBR */
 	if (h->hash_rcu_cfg) {
 		/* Key index where key is stored, adding the first dummy index */
@@ -1773,7 +2564,7 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
 				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
 	}
-	__hash_rw_writer_unlock(h);
+	__hash_rw_writer_unlock_opt(h, locked);
 	return ret;
 }
 
@@ -1782,14 +2573,14 @@ rte_hash_del_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_del_key_with_hash(h, key, sig);
+	return __rte_hash_del_key_with_hash(h, key, sig, 0);
 }
 
 int32_t
 rte_hash_del_key(const struct rte_hash *h, const void *key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
+	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key), 0);
 }
 
 int
@@ -2308,12 +3099,80 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		positions, hit_mask, data);
 }
 
+/*
+ * Bulk lookup in a resizable table. The buckets of a table which is not
+ * being resized are searched with the regular bulk functions, missed keys
+ * are looked up one by one if a resize has started meanwhile.
+ */
+static inline void
+__rte_hash_lookup_bulk_rs(const struct rte_hash *h, const void **keys,
+			const hash_sig_t *prim_hash, int32_t num_keys,
+			int32_t *positions, uint64_t *hit_mask, void *data[])
+{
+	hash_sig_t hash[RTE_HASH_LOOKUP_BULK_MAX];
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_resize *rs;
+	const struct rte_hash_bucket *buckets;
+	uint32_t bucket_bitmask, prim_index;
+	uint64_t hits = 0;
+	int32_t i;
+
+	rs = __hash_resize_snapshot(h, &buckets, &bucket_bitmask);
+
+	for (i = 0; i < num_keys; i++) {
+		hash[i] = (prim_hash != NULL) ? prim_hash[i] :
+				rte_hash_hash(h, keys[i]);
+		sig[i] = get_short_sig(hash[i]);
+		prim_index = hash[i] & bucket_bitmask;
+		primary_bkt[i] = &buckets[prim_index];
+		secondary_bkt[i] = &buckets[(prim_index ^ sig[i]) &
+				bucket_bitmask];
+
+		rte_prefetch0(primary_bkt[i]);
+		rte_prefetch0(secondary_bkt[i]);
+	}
+
+	if (rs == NULL) {
+		if (h->readwrite_concur_lf_support)
+			__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt,
+				sig, num_keys, positions, &hits, data);
+		else
+			__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt,
+				sig, num_keys, positions, &hits, data);
+
+		/* Keys may have left the searched buckets only if a
+		 * resize has published new buckets meanwhile.
+		 */
+		if (__atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE) ==
+				buckets)
+			goto out;
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		if (hits & (1ULL << i))
+			continue;
+		positions[i] = __rte_hash_lookup_with_hash_rs(h, keys[i],
+				hash[i], (data != NULL) ? &data[i] : NULL);
+		if (positions[i] >= 0)
+			hits |= 1ULL << i;
+	}
+
+out:
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
 static inline void
 __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resizable)
+		__rte_hash_lookup_bulk_rs(h, keys, NULL, num_keys, positions,
+					  hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2425,7 +3284,10 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resizable)
+		__rte_hash_lookup_bulk_rs(h, keys, prim_hash, num_keys,
+				positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
@@ -2466,6 +3328,140 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/*
+ * Calculate the signatures of a burst of keys to add/delete and prefetch
+ * both candidate buckets of every key, so that the bucket cache misses of
+ * the whole burst overlap instead of being taken one key at a time.
+ */
+static inline void
+__bulk_write_prefetching_loop(const struct rte_hash *h,
+	const void **keys, int32_t num_keys, hash_sig_t *sig)
+{
+	int32_t i;
+	uint32_t prim_index, sec_index;
+
+	/* Prefetch first keys */
+	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
+		rte_prefetch0(keys[i]);
+
+	/*
+	 * Prefetch rest of the keys, calculate primary and
+	 * secondary bucket and prefetch them
+	 */
+	for (i = 0; i < (num_keys - PREFETCH_OFFSET); i++) {
+		rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+
+		sig[i] = rte_hash_hash(h, keys[i]);
+		prim_index = get_prim_bucket_index(h, sig[i]);
+		sec_index = get_alt_bucket_index(h, prim_index,
+				get_short_sig(sig[i]));
+
+		rte_prefetch0(&h->buckets[prim_index]);
+		rte_prefetch0(&h->buckets[sec_index]);
+	}
+
+	/* Calculate and prefetch rest of the buckets */
+	for (; i < num_keys; i++) {
+		sig[i] = rte_hash_hash(h, keys[i]);
+		prim_index = get_prim_bucket_index(h, sig[i]);
+		sec_index = get_alt_bucket_index(h, prim_index,
+				get_short_sig(sig[i]));
+
+		rte_prefetch0(&h->buckets[prim_index]);
+		rte_prefetch0(&h->buckets[sec_index]);
+	}
+}
+
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void * const *data, uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i, n;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) ||
+			(positions == NULL)), -EINVAL);
+
+	/* The burst size bounds the signature array, always check it */
+	if (num_keys == 0 || num_keys > RTE_HASH_LOOKUP_BULK_MAX)
+		return -EINVAL;
+
+	__bulk_write_prefetching_loop(h, keys, num_keys, sig);
+
+	/* One writer critical section for the whole burst */
+	__hash_rw_writer_lock(h);
+	for (i = 0, n = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_add_key_with_hash(h, keys[i], sig[i],
+				(data == NULL) ? NULL : data[i], 1);
+		n += (positions[i] >= 0);
+	}
+	__hash_rw_writer_unlock(h);
+
+	return n;
+}
+
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i, n;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) ||
+			(positions == NULL)), -EINVAL);
+
+	/* The burst size bounds the signature array, always check it */
+	if (num_keys == 0 || num_keys > RTE_HASH_LOOKUP_BULK_MAX)
+		return -EINVAL;
+
+	__bulk_write_prefetching_loop(h, keys, num_keys, sig);
+
+	/* One writer critical section for the whole burst */
+	__hash_rw_writer_lock(h);
+	for (i = 0, n = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_del_key_with_hash(h, keys[i], sig[i],
+				1);
+		n += (positions[i] >= 0);
+	}
+	__hash_rw_writer_unlock(h);
+
+	return n;
+}
+
+/* Iterate the buckets of the table being resized, after the current ones */
+static int32_t
+__rte_hash_iterate_resize(const struct rte_hash *h, const void **key,
+		void **data, uint32_t *next, uint32_t total_entries_main)
+{
+	const struct rte_hash_resize *rs = h->resize;
+	const uint32_t total_entries = total_entries_main +
+			rs->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	uint32_t bucket_idx, idx, position;
+	struct rte_hash_key *next_key;
+
+	for (; *next < total_entries; (*next)++) {
+		bucket_idx = (*next - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES;
+		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+		position = __atomic_load_n(&rs->buckets[bucket_idx].key_idx[idx],
+				__ATOMIC_ACQUIRE);
+		if (position == EMPTY_SLOT)
+			continue;
+
+		next_key = (struct rte_hash_key *) ((char *)h->key_store +
+					position * h->key_entry_size);
+		/* Return key and data */
+		*key = next_key->key;
+		*data = next_key->pdata;
+
+		/* Increment iterator */
+		(*next)++;
+		return position - 1;
+	}
+
+	return -ENOENT;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -2513,6 +3509,10 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
+	if (h->resize != NULL)
+		return __rte_hash_iterate_resize(h, key, data, next,
+				total_entries_main);
+
 	/* Out of total bound or if ext bucket feature is not enabled */
 	if (*next >= total_entries || !h->ext_table_support)
 		return -ENOENT;
@@ -128,6 +128,15 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/* Number of buckets migrated by each add while a table is resized */
+#define RTE_HASH_RESIZE_STEP		4
+
+/* Timer wheel of the key expiry: 4 levels of 64 slots, covering 2^24 ticks */
+#define RTE_HASH_EXPIRY_SLOT_BITS	6
+#define RTE_HASH_EXPIRY_SLOTS		(1 << RTE_HASH_EXPIRY_SLOT_BITS)
+#define RTE_HASH_EXPIRY_SLOT_MASK	(RTE_HASH_EXPIRY_SLOTS - 1)
+#define RTE_HASH_EXPIRY_LEVELS		4
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -162,6 +171,51 @@ struct rte_hash_bucket {
 	void *next;
 } __rte_cache_aligned;
 
+/* Resize of a table with RTE_HASH_EXTRA_FLAGS_RESIZABLE */
+struct rte_hash_resize {
+	struct rte_hash_bucket *buckets;
+	/**< Buckets of the previous table, emptied during the migration */
+	uint32_t num_buckets;           /**< Number of buckets in old table. */
+	uint32_t bucket_bitmask;        /**< Bitmask of the old table. */
+	uint64_t *migrated;             /**< Bitmap of migrated old buckets. */
+	uint32_t nb_migrated;           /**< Number of migrated old buckets. */
+	uint32_t next_bucket;           /**< Next old bucket to migrate. */
+	void *old_key_store;            /**< Key store of the old table. */
+	void *new_key_store;            /**< Key store of the new table. */
+	uint32_t num_key_slots;         /**< Number of slots in old key store. */
+	uint32_t copied;
+	/**< Number of key slots copied to the new key store. Writes to these
+	 * slots are mirrored to the key store that is not current.
+	 */
+	uint32_t entries;               /**< Total entries after the resize. */
+	struct rte_ring *free_slots;    /**< Free slots ring of new size. */
+	uint64_t token;
+	/**< RCU token taken once the old table is no longer published */
+};
+
+/* Expiry timer of a key, indexed by key index */
+struct rte_hash_expiry_node {
+	uint64_t expire;                /**< Expiry time, in ticks. */
+	uint32_t next;                  /**< Next key index in wheel slot. */
+	uint32_t prev;                  /**< Previous key index in wheel slot. */
+	uint16_t slot;                  /**< Wheel slot plus one, 0 if not armed. */
+};
+
+/* Hierarchical timer wheel driving the expiry of the keys */
+struct rte_hash_expiry {
+	uint64_t tick;                  /**< Caller time units per tick. */
+	uint64_t cur;
+	/**< Next tick to process, all timers of earlier ticks were returned. */
+	uint8_t cascaded;               /**< Timers of tick cur were cascaded. */
+	uint32_t armed;                 /**< Number of armed timers. */
+	uint32_t num_nodes;             /**< Size of the nodes array. */
+	struct rte_hash_expiry_node *nodes;
+	uint64_t occupied[RTE_HASH_EXPIRY_LEVELS];
+	/**< Bitmap of the non-empty slots of each level. */
+	uint32_t heads[RTE_HASH_EXPIRY_LEVELS * RTE_HASH_EXPIRY_SLOTS];
+	/**< First key index of each slot, 0 if empty. */
+};
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
@@ -202,6 +256,8 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t resizable;
+	/**< If the table grows when it fills up */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -231,6 +287,15 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+	struct rte_hash_resize *resize;
+	/**< Resize in progress, NULL if none */
+	struct rte_hash_resize *retired;
+	/**< Resize done, whose old table lock free readers may still use.
+	 * Only the writer accesses it.
+	 */
+	struct rte_hash_expiry *expiry;
+	/**< Key expiry timer wheel, NULL if not enabled */
+	int socket_id;                  /**< NUMA socket of the table. */
 } __rte_cache_aligned;
 
 struct queue_node {
@@ -56,6 +56,21 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to let the table grow when it fills up.
+ * The entries parameter only sets the initial size. Once three quarters
+ * of the key slots are in use, the table doubles: its buckets are migrated
+ * a few at a time by the following add calls, so no single call pays
+ * for rehashing the whole table. Key positions are kept, so the positions
+ * returned by the add APIs stay valid, but they may go beyond the initial
+ * number of entries: rte_hash_max_key_id() returns the current bound.
+ * Cannot be combined with RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD,
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY or RTE_HASH_EXTRA_FLAGS_EXT_TABLE.
+ * With RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, the table grows only
+ * once a QSBR variable is attached with rte_hash_rcu_qsbr_add(), which
+ * tells when the memory of the previous table can be freed.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x40
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -123,6 +138,15 @@ struct rte_hash_rcu_config {
 	/**< Function to call to free the resource (key-data). */
 };
 
+/** Hash table key expiry configuration structure. */
+struct rte_hash_expiry_config {
+	uint64_t tick;
+	/**< Resolution of the expiry times, in the units used by the caller
+	 * for all times (e.g. TSC cycles). Keys expire up to one tick late.
+	 */
+	uint64_t now;			/**< Current time. */
+};
+
 /** @internal A hash table structure. */
 struct rte_hash;
 
@@ -209,6 +233,7 @@ rte_hash_count(const struct rte_hash *h);
 /**
  * Return the maximum key value ID that could possibly be returned by
  * rte_hash_add_key function.
+ * With RTE_HASH_EXTRA_FLAGS_RESIZABLE, this value grows with the table.
  *
  * @param h
  *  Hash table to query from
@@ -382,6 +407,74 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add multiple keys, with associated data, to an existing hash table.
+ * The hash values of all keys are calculated and the candidate buckets
+ * are prefetched for the whole burst before inserting, and the writer
+ * lock (if any) is taken once for the whole burst.
+ * A key that is already present has its data updated.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param data
+ *   A pointer to a list of data to associate with the keys,
+ *   NULL to add the keys without data.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, the same value rte_hash_add_key()
+ *   would have returned: the key position on success, otherwise
+ *   -ENOSPC if there is no space in the hash for this key.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys added or updated.
+ */
+__rte_experimental
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void * const *data, uint32_t num_keys, int32_t *positions);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Remove multiple keys from an existing hash table.
+ * The hash values of all keys are calculated and the candidate buckets
+ * are prefetched for the whole burst before removing, and the writer
+ * lock (if any) is taken once for the whole burst.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ * The same rules as for rte_hash_del_key() apply to the freeing of
+ * the key indexes.
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing, for each key, the same value rte_hash_del_key()
+ *   would have returned: the position the key was stored at,
+ *   or -ENOENT if the key is not found.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys removed.
+ */
+__rte_experimental
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -676,6 +769,110 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
  */
 int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable the expiry of keys for a hash table.
+ * Keys get an optional expiry time with rte_hash_expiry_set(). They are
+ * kept in a hierarchical timer wheel, so that rte_hash_expire() finds the
+ * expired keys at a cost depending on the number of expired keys rather
+ * than on the size of the table.
+ * The expiry APIs are write operations and have the same thread safety
+ * as rte_hash_add_key().
+ *
+ * @param h
+ *   Hash table to enable the expiry for.
+ * @param cfg
+ *   Expiry configuration.
+ * @return
+ *   - 0 if successful.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if the expiry is already enabled.
+ *   - -ENOMEM if there is not enough memory.
+ */
+__rte_experimental
+int
+rte_hash_expiry_enable(struct rte_hash *h,
+		const struct rte_hash_expiry_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the expiry time of a key, replacing the previous one if any.
+ * Deleting the key cancels its expiry.
+ *
+ * @param h
+ *   Hash table the key is stored in.
+ * @param position
+ *   Position of the key, as returned by rte_hash_add_key() or
+ *   rte_hash_lookup().
+ * @param expire
+ *   Time at which the key expires, in the units of
+ *   rte_hash_expiry_config.tick.
+ * @return
+ *   - 0 if successful.
+ *   - -EINVAL if the parameters are invalid or the expiry is not enabled.
+ *   - -ENOMEM if there is not enough memory.
+ */
+__rte_experimental
+int
+rte_hash_expiry_set(struct rte_hash *h, int32_t position, uint64_t expire);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Cancel the expiry of a key, the key then stays until deleted.
+ *
+ * @param h
+ *   Hash table the key is stored in.
+ * @param position
+ *   Position of the key.
+ * @return
+ *   - 0 if successful.
+ *   - -EINVAL if the parameters are invalid or the expiry is not enabled.
+ *   - -ENOENT if no expiry time is set for the key.
+ */
+__rte_experimental
+int
+rte_hash_expiry_cancel(struct rte_hash *h, int32_t position);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the keys which expired at the given time.
+ * At most max keys are returned per call, the others are returned by the
+ * next calls. The expiry time of the returned keys is cleared, the keys are
+ * not removed: the caller is expected to delete them, or to set a new
+ * expiry time to keep them.
+ *
+ * @param h
+ *   Hash table to look for expired keys.
+ * @param now
+ *   Current time, in the units of rte_hash_expiry_config.tick.
+ *   It must not go backwards between calls.
+ * @param keys
+ *   Output containing the expired keys.
+ * @param data
+ *   Output containing the data associated with the expired keys,
+ *   can be NULL.
+ * @param positions
+ *   Output containing the positions of the expired keys.
+ * @param max
+ *   Maximum number of keys to return.
+ * @return
+ *   - -EINVAL if the parameters are invalid or the expiry is not enabled.
+ *   - Number of expired keys returned, less than max only if no other key
+ *     has expired.
+ */
+__rte_experimental
+int
+rte_hash_expire(struct rte_hash *h, uint64_t now, const void **keys,
+		void **data, int32_t *positions, unsigned int max);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,9 @@
  * bloom filter (vBF). For HT setsummary, two subtypes or modes are available,
  * cache and non-cache modes. The table below summarize some properties of
  * the different implementations.
+ * A third type, the count-min sketch (SKETCH), does not associate keys with
+ * sets but estimates how many times each key was added, and reports the
+ * most frequent keys (heavy hitters).
  *
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -52,6 +55,7 @@ extern "C" {
 #include <stdint.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 
 /** The set ID type that stored internally in hash table based set summary. */
 typedef uint16_t member_set_t;
@@ -104,6 +108,7 @@ struct rte_member_parameters;
 enum rte_member_setsum_type {
 	RTE_MEMBER_TYPE_HT = 0,  /**< Hash table based set summary. */
 	RTE_MEMBER_TYPE_VBF,     /**< Vector of bloom filters. */
+	RTE_MEMBER_TYPE_SKETCH,  /**< Count-min sketch. */
 	RTE_MEMBER_NUM_TYPE
 };
 
@@ -166,6 +171,10 @@ struct rte_member_parameters {
 	 *
 	 * vBF setsummary is a vector of bloom filters. It is used when number
 	 * of sets is not big (less than 32 for current implementation).
+	 *
+	 * Sketch setsummary is a count-min sketch. It is used to estimate the
+	 * number of occurrences of keys, and to find the most frequent keys,
+	 * without storing the keys.
 	 */
 	enum rte_member_setsum_type type;
 
@@ -205,6 +214,10 @@ struct rte_member_parameters {
 	 * number of bits we need for each BF. User does not specify the size of
 	 * each BF directly because the optimal size depends on the num_keys
 	 * and false positive rate.
+	 *
+	 * For sketch, num_keys is the number of heavy hitters to track, that
+	 * is the number of most frequent keys reported by
+	 * rte_member_report_heavyhitter(). It can be 0 if not needed.
 	 */
 	uint32_t num_keys;
 
@@ -243,6 +256,12 @@ struct rte_member_parameters {
 	 * to number of entries (num_keys) divided by entry count per bucket
 	 * (RTE_MEMBER_BUCKET_ENTRIES). Thus, the false_positive_rate is not
 	 * directly set by users for HT mode.
+	 *
+	 * For sketch, false_positive_rate is the error rate of the count
+	 * estimates: a count is over-estimated by more than this fraction of
+	 * the total count added to the sketch with a very low probability.
+	 * It sets the number of counters in the sketch, a smaller rate needs
+	 * more memory.
 	 */
 	float false_positive_rate;
 
@@ -253,6 +272,7 @@ struct rte_member_parameters {
 	 * for bucket location.
 	 * For vBF type, these two hashes and their combinations are used as
 	 * hash locations to index the bit array.
+	 * For sketch type, the same is done to index the counters of each row.
 	 */
 	uint32_t prim_hash_seed;
 
@@ -430,11 +450,103 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
  *   eviction, return 1 otherwise. Return 0 for non-cache mode if success,
  *   -ENOSPC for full, and 1 if cuckoo eviction happens.
  *   Always returns 0 for vBF mode.
+ *   For sketch, the count of the key is incremented, the set_id is
+ *   ignored and 0 is returned.
  */
 int
 rte_member_add(const struct rte_member_setsum *setsum, const void *key,
 			member_set_t set_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a key with a weight into the sketch set-summary, for example to
+ * count bytes instead of packets. Only supported by the sketch type.
+ * The sketch is not multi-thread safe, use one sketch per lcore and
+ * rte_member_merge() to combine them.
+ *
+ * @param setsum
+ *   Pointer of a set-summary.
+ * @param key
+ *   Pointer of the key to be added.
+ * @param byte_count
+ *   Value added to the count of the key.
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_member_add_byte_count(const struct rte_member_setsum *setsum,
+			const void *key, uint32_t byte_count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Query the estimated count of a key in the sketch set-summary.
+ * The estimate is never lower than the real count.
+ *
+ * @param setsum
+ *   Pointer of a set-summary.
+ * @param key
+ *   Pointer of the key to be queried.
+ * @param count
+ *   Output the estimated count of the key.
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_member_query_count(const struct rte_member_setsum *setsum,
+			const void *key, uint64_t *count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Report the heavy hitters of the sketch set-summary: the most frequent
+ * keys, up to the num_keys parameter given at creation, sorted by
+ * decreasing count.
+ *
+ * @param setsum
+ *   Pointer of a set-summary.
+ * @param keys
+ *   Output pointers to the heavy hitter keys, which stay valid until
+ *   the next update of the set-summary. User should preallocate an array
+ *   of num_keys entries.
+ * @param counts
+ *   Output the estimated count of each heavy hitter.
+ * @return
+ *   The number of heavy hitters reported, -EINVAL if the parameters are
+ *   invalid.
+ */
+__rte_experimental
+int
+rte_member_report_heavyhitter(const struct rte_member_setsum *setsum,
+			void **keys, uint64_t *counts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Merge a set-summary into another one, so that the result is the same as
+ * if all the keys of src had been added to dst. Typically used to combine
+ * per-lcore sketches. Only supported by the sketch type, both set-summaries
+ * must be created with the same key_len, false_positive_rate and seeds.
+ *
+ * @param dst
+ *   Pointer of the set-summary to merge into.
+ * @param src
+ *   Pointer of the set-summary to merge from, it is not modified.
+ * @return
+ *   0 on success, -EINVAL if the set-summaries cannot be merged.
+ */
+__rte_experimental
+int
+rte_member_merge(const struct rte_member_setsum *dst,
+			const struct rte_member_setsum *src);
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -0,0 +1,333 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_vect.h>
+
+#include "rte_member.h"
+#include "rte_member_sketch.h"
+
+#if defined(RTE_ARCH_X86)
+#include "rte_member_sketch_x86.h"
+#endif
+
+/*
+ * The sketch is a count-min sketch: RTE_MEMBER_SKETCH_ROWS rows of
+ * counters, a key increments one counter in each row and its count is
+ * estimated as the smallest of these counters. Like in vBF, the column
+ * of row i is derived from two hashes: h1 + i * h2.
+ * Counters are updated conservatively: a counter is raised only up to
+ * the new estimate of the key, which reduces the over-estimation caused
+ * by other keys sharing the counter.
+ *
+ * With num_col = e / error_rate counters per row, the estimate exceeds
+ * the real count by more than error_rate * (total count) with a
+ * probability of at most e^-RTE_MEMBER_SKETCH_ROWS.
+ *
+ * The heavy hitters are the top_k keys with the largest estimates seen at
+ * insertion time, kept in a min-heap so that a key only needs to be
+ * compared with the smallest heavy hitter.
+ */
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	struct member_sketch *sk;
+	uint32_t num_col;
+
+	if (params->num_keys > RTE_MEMBER_SKETCH_TOPK_MAX ||
+			!(params->false_positive_rate > 0) ||
+			params->false_positive_rate >= 1) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR, "Membership sketch create with invalid parameters\n");
+		return -EINVAL;
+	}
+
+	num_col = RTE_MIN(ceil(M_E / params->false_positive_rate),
+			(double)RTE_MEMBER_SKETCH_COLS_MAX);
+	/* We round to power of 2 for performance during update */
+	num_col = rte_align32pow2(num_col);
+
+	sk = rte_zmalloc_socket(NULL, sizeof(struct member_sketch),
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (sk == NULL)
+		goto nomem;
+	ss->table = sk;
+
+	sk->num_col = num_col;
+	sk->col_mask = num_col - 1;
+	sk->top_k = params->num_keys;
+	sk->counters = rte_zmalloc_socket(NULL, (size_t)num_col *
+			RTE_MEMBER_SKETCH_ROWS * sizeof(uint64_t),
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (sk->counters == NULL)
+		goto nomem;
+
+	if (sk->top_k != 0) {
+		sk->heap = rte_zmalloc_socket(NULL,
+				sk->top_k * sizeof(uint32_t), 0, ss->socket_id);
+		sk->heap_pos = rte_zmalloc_socket(NULL,
+				sk->top_k * sizeof(uint32_t), 0, ss->socket_id);
+		sk->hh_sig = rte_zmalloc_socket(NULL,
+				sk->top_k * sizeof(uint32_t), 0, ss->socket_id);
+		sk->hh_count = rte_zmalloc_socket(NULL,
+				sk->top_k * sizeof(uint64_t), 0, ss->socket_id);
+		sk->hh_keys = rte_zmalloc_socket(NULL,
+				sk->top_k * ss->key_len, 0, ss->socket_id);
+		if (sk->heap == NULL || sk->heap_pos == NULL ||
+				sk->hh_sig == NULL || sk->hh_count == NULL ||
+				sk->hh_keys == NULL)
+			goto nomem;
+	}
+
+#if defined(RTE_ARCH_X86)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) &&
+			RTE_MEMBER_SKETCH_ROWS == 8 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		sk->sig_cmp_fn = RTE_MEMBER_COMPARE_AVX2;
+	else
+#endif
+		sk->sig_cmp_fn = RTE_MEMBER_COMPARE_SCALAR;
+
+	RTE_MEMBER_LOG(DEBUG, "sketch created, %u rows of %u counters, "
+		"tracking %u heavy hitters\n",
+		RTE_MEMBER_SKETCH_ROWS, num_col, sk->top_k);
+	return 0;
+
+nomem:
+	RTE_MEMBER_LOG(ERR, "memory allocation failed for sketch\n");
+	rte_member_free_sketch(ss);
+	return -ENOMEM;
+}
+
+/*
+ * Store in idx the counter index of the key in each row and return
+ * the smallest counter, that is the estimated count of the key.
+ */
+static inline uint64_t
+sketch_min(const struct rte_member_setsum *ss, uint32_t h1, uint32_t *idx)
+{
+	const struct member_sketch *sk = ss->table;
+	uint32_t h2 = MEMBER_HASH_FUNC(&h1, sizeof(uint32_t),
+						ss->sec_hash_seed);
+	uint64_t min = UINT64_MAX;
+	uint32_t i;
+
+	switch (sk->sig_cmp_fn) {
+#if defined(RTE_ARCH_X86) && defined(__AVX2__)
+	case RTE_MEMBER_COMPARE_AVX2:
+		return sketch_min_avx(sk, h1, h2, idx);
+#endif
+	default:
+		for (i = 0; i < RTE_MEMBER_SKETCH_ROWS; i++) {
+			idx[i] = i * sk->num_col + ((h1 + i * h2) &
+					sk->col_mask);
+			min = RTE_MIN(min, sk->counters[idx[i]]);
+		}
+		return min;
+	}
+}
+
+static inline void *
+hh_key(const struct rte_member_setsum *ss, uint32_t slot)
+{
+	const struct member_sketch *sk = ss->table;
+
+	return sk->hh_keys + (size_t)slot * ss->key_len;
+}
+
+static inline void
+heap_set(struct member_sketch *sk, uint32_t pos, uint32_t slot)
+{
+	sk->heap[pos] = slot;
+	sk->heap_pos[slot] = pos;
+}
+
+static void
+heap_sift_up(struct member_sketch *sk, uint32_t pos)
+{
+	uint32_t slot = sk->heap[pos];
+	uint32_t parent;
+
+	while (pos > 0) {
+		parent = (pos - 1) / 2;
+		if (sk->hh_count[sk->heap[parent]] <= sk->hh_count[slot])
+			break;
+		heap_set(sk, pos, sk->heap[parent]);
+		pos = parent;
+	}
+	heap_set(sk, pos, slot);
+}
+
+static void
+heap_sift_down(struct member_sketch *sk, uint32_t pos)
+{
+	uint32_t slot = sk->heap[pos];
+	uint32_t child;
+
+	while ((child = 2 * pos + 1) < sk->num_hh) {
+		if (child + 1 < sk->num_hh &&
+				sk->hh_count[sk->heap[child + 1]] <
+				sk->hh_count[sk->heap[child]])
+			child++;
+		if (sk->hh_count[slot] <= sk->hh_count[sk->heap[child]])
+			break;
+		heap_set(sk, pos, sk->heap[child]);
+		pos = child;
+	}
+	heap_set(sk, pos, slot);
+}
+
+/* Record the new estimated count of a key in the heavy hitters */
+static void
+hh_update(const struct rte_member_setsum *ss, const void *key, uint32_t sig,
+		uint64_t count)
+{
+	struct member_sketch *sk = ss->table;
+	uint32_t slot;
+
+	/* Most keys are not heavy hitters */
+	if (sk->num_hh == sk->top_k &&
+			(sk->top_k == 0 || count <= sk->hh_count[sk->heap[0]]))
+		return;
+
+	for (slot = 0; slot < sk->num_hh; slot++) {
+		if (sk->hh_sig[slot] == sig &&
+				memcmp(hh_key(ss, slot), key, ss->key_len) == 0) {
+			sk->hh_count[slot] = count;
+			heap_sift_down(sk, sk->heap_pos[slot]);
+			return;
+		}
+	}
+
+	if (sk->num_hh < sk->top_k) {
+		slot = sk->num_hh++;
+		heap_set(sk, slot, slot);
+	} else {
+		/* Evict the smallest heavy hitter */
+		slot = sk->heap[0];
+	}
+	sk->hh_sig[slot] = sig;
+	sk->hh_count[slot] = count;
+	memcpy(hh_key(ss, slot), key, ss->key_len);
+	if (sk->heap_pos[slot] == 0)
+		heap_sift_down(sk, 0);
+	else
+		heap_sift_up(sk, sk->heap_pos[slot]);
+}
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint32_t count)
+{
+	struct member_sketch *sk = ss->table;
+	uint32_t idx[RTE_MEMBER_SKETCH_ROWS];
+	uint32_t h1 = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+	uint64_t est;
+	uint32_t i;
+
+	est = sketch_min(ss, h1, idx) + count;
+	for (i = 0; i < RTE_MEMBER_SKETCH_ROWS; i++)
+		if (sk->counters[idx[i]] < est)
+			sk->counters[idx[i]] = est;
+
+	hh_update(ss, key, h1, est);
+	return 0;
+}
+
+int
+rte_member_query_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint64_t *count)
+{
+	uint32_t idx[RTE_MEMBER_SKETCH_ROWS];
+	uint32_t h1 = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+
+	*count = sketch_min(ss, h1, idx);
+	return 0;
+}
+
+int
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *ss,
+		void **keys, uint64_t *counts)
+{
+	const struct member_sketch *sk = ss->table;
+	uint32_t i, j, slot;
+
+	/* Insertion sort by descending count, the heap is small */
+	for (i = 0; i < sk->num_hh; i++) {
+		slot = sk->heap[i];
+		for (j = i; j > 0 && counts[j - 1] < sk->hh_count[slot]; j--) {
+			counts[j] = counts[j - 1];
+			keys[j] = keys[j - 1];
+		}
+		counts[j] = sk->hh_count[slot];
+		keys[j] = hh_key(ss, slot);
+	}
+	return sk->num_hh;
+}
+
+int
+rte_member_merge_sketch(const struct rte_member_setsum *dst,
+		const struct rte_member_setsum *src)
+{
+	struct member_sketch *dsk = dst->table;
+	const struct member_sketch *ssk = src->table;
+	uint32_t idx[RTE_MEMBER_SKETCH_ROWS];
+	uint64_t n = (uint64_t)dsk->num_col * RTE_MEMBER_SKETCH_ROWS;
+	uint64_t i;
+	uint32_t slot;
+
+	if (dst->key_len != src->key_len ||
+			dst->prim_hash_seed != src->prim_hash_seed ||
+			dst->sec_hash_seed != src->sec_hash_seed ||
+			dsk->num_col != ssk->num_col)
+		return -EINVAL;
+
+	/* Counters of both sketches bound the counts of their own keys */
+	for (i = 0; i < n; i++)
+		dsk->counters[i] += ssk->counters[i];
+
+	/* Refresh the counts of the heavy hitters and restore the heap */
+	for (slot = 0; slot < dsk->num_hh; slot++)
+		dsk->hh_count[slot] = sketch_min(dst, dsk->hh_sig[slot], idx);
+	for (i = dsk->num_hh / 2; i > 0; i--)
+		heap_sift_down(dsk, i - 1);
+
+	for (slot = 0; slot < ssk->num_hh; slot++)
+		hh_update(dst, hh_key(src, slot), ssk->hh_sig[slot],
+			sketch_min(dst, ssk->hh_sig[slot], idx));
+	return 0;
+}
+
+void
+rte_member_free_sketch(struct rte_member_setsum *ss)
+{
+	struct member_sketch *sk = ss->table;
+
+	if (sk == NULL)
+		return;
+	rte_free(sk->counters);
+	rte_free(sk->heap);
+	rte_free(sk->heap_pos);
+	rte_free(sk->hh_sig);
+	rte_free(sk->hh_count);
+	rte_free(sk->hh_keys);
+	rte_free(sk);
+	ss->table = NULL;
+}
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *ss)
+{
+	struct member_sketch *sk = ss->table;
+
+	memset(sk->counters, 0, (size_t)sk->num_col *
+			RTE_MEMBER_SKETCH_ROWS * sizeof(uint64_t));
+	sk->num_hh = 0;
+}
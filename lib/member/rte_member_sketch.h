@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#ifndef _RTE_MEMBER_SKETCH_H_
+#define _RTE_MEMBER_SKETCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of rows in the sketch, each row is indexed by its own hash */
+#define RTE_MEMBER_SKETCH_ROWS 8
+/* Maximum number of counters per row */
+#define RTE_MEMBER_SKETCH_COLS_MAX (1 << 24)
+/* Maximum number of heavy hitters tracked by a sketch */
+#define RTE_MEMBER_SKETCH_TOPK_MAX 1024
+
+struct member_sketch {
+	uint32_t num_col;		/* Number of counters in each row. */
+	uint32_t col_mask;		/* Bit mask to get column in a row. */
+	uint32_t top_k;			/* Number of heavy hitters to track. */
+	uint32_t num_hh;		/* Number of heavy hitters tracked. */
+	/* For runtime selecting AVX2 or scalar counter access. */
+	enum rte_member_sig_compare_function sig_cmp_fn;
+	uint64_t *counters;		/* Rows of counters, one after another. */
+
+	/*
+	 * Heavy hitters are stored in slots, the heap orders the slots by
+	 * ascending count so that the smallest heavy hitter is at the root.
+	 */
+	uint32_t *heap;			/* Slot of each heap position. */
+	uint32_t *heap_pos;		/* Heap position of each slot. */
+	uint32_t *hh_sig;		/* Primary hash of the key in each slot. */
+	uint64_t *hh_count;		/* Count of the key in each slot. */
+	uint8_t *hh_keys;		/* Key in each slot. */
+};
+
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params);
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint32_t count);
+
+int
+rte_member_query_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint64_t *count);
+
+int
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *ss,
+		void **keys, uint64_t *counts);
+
+int
+rte_member_merge_sketch(const struct rte_member_setsum *dst,
+		const struct rte_member_setsum *src);
+
+void
+rte_member_free_sketch(struct rte_member_setsum *ss);
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *ss);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_SKETCH_H_ */
@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#ifndef _RTE_MEMBER_SKETCH_X86_H_
+#define _RTE_MEMBER_SKETCH_X86_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <x86intrin.h>
+
+#if defined(__AVX2__)
+
+/*
+ * Compute the counter index of the key in all the rows at once:
+ * row * num_col + ((h1 + row * h2) & col_mask), and return the smallest
+ * of these counters, loaded with two gathers.
+ */
+static inline uint64_t
+sketch_min_avx(const struct member_sketch *sk, uint32_t h1, uint32_t h2,
+		uint32_t *idx)
+{
+	const __m256i rows = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i cols, lo, hi, min;
+
+	cols = _mm256_add_epi32(_mm256_set1_epi32(h1),
+			_mm256_mullo_epi32(rows, _mm256_set1_epi32(h2)));
+	cols = _mm256_and_si256(cols, _mm256_set1_epi32(sk->col_mask));
+	cols = _mm256_add_epi32(cols,
+			_mm256_mullo_epi32(rows, _mm256_set1_epi32(sk->num_col)));
+	_mm256_storeu_si256((__m256i *)idx, cols);
+
+	lo = _mm256_i32gather_epi64((const long long *)sk->counters,
+			_mm256_castsi256_si128(cols), 8);
+	hi = _mm256_i32gather_epi64((const long long *)sk->counters,
+			_mm256_extracti128_si256(cols, 1), 8);
+
+	/* Counters never reach 2^63, so a signed comparison does */
+	min = _mm256_blendv_epi8(lo, hi, _mm256_cmpgt_epi64(lo, hi));
+	lo = _mm256_permute4x64_epi64(min, _MM_SHUFFLE(1, 0, 3, 2));
+	min = _mm256_blendv_epi8(min, lo, _mm256_cmpgt_epi64(min, lo));
+	lo = _mm256_permute4x64_epi64(min, _MM_SHUFFLE(2, 3, 0, 1));
+	min = _mm256_blendv_epi8(min, lo, _mm256_cmpgt_epi64(min, lo));
+
+	return _mm256_extract_epi64(min, 0);
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_SKETCH_X86_H_ */
@@ -712,6 +712,82 @@ rte_mempool_populate_anon(struct rte_mempool *mp)
 	return 0;
 }
 
+static void
+mempool_shared_cache_free(struct rte_mempool *mp)
+{
+	struct rte_mempool_shared_cache **table;
+	unsigned int socket_id;
+
+	if (!(mp->flags & RTE_MEMPOOL_F_SHARED_CACHE))
+		return;
+
+	table = rte_mempool_shared_cache_table(mp);
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		rte_free(table[socket_id]);
+		table[socket_id] = NULL;
+	}
+}
+
+/*
+ * Allocate a shared cache on each socket having lcores, large enough to
+ * hold a full cache of each of these lcores.
+ */
+static int
+mempool_shared_cache_create(struct rte_mempool *mp)
+{
+	unsigned int nb_lcores[RTE_MAX_NUMA_NODES] = { 0 };
+	struct rte_mempool_shared_cache **table;
+	struct rte_mempool_shared_cache *sc;
+	unsigned int lcore_id, socket_id;
+	uint32_t size;
+
+	table = rte_mempool_shared_cache_table(mp);
+	memset(table, 0, sizeof(*table) * RTE_MAX_NUMA_NODES);
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		socket_id = rte_lcore_to_socket_id(lcore_id);
+		if (socket_id < RTE_MAX_NUMA_NODES)
+			nb_lcores[socket_id]++;
+	}
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		if (nb_lcores[socket_id] == 0)
+			continue;
+
+		size = RTE_MIN(mp->cache_size * nb_lcores[socket_id], mp->size);
+		sc = rte_zmalloc_socket("MEMPOOL_SHARED_CACHE",
+				sizeof(*sc) + sizeof(void *) * size,
+				RTE_CACHE_LINE_SIZE, socket_id);
+		if (sc == NULL) {
+			mempool_shared_cache_free(mp);
+			return -ENOMEM;
+		}
+		rte_spinlock_init(&sc->lock);
+		sc->size = size;
+		table[socket_id] = sc;
+	}
+
+	return 0;
+}
+
+/* number of objects in the shared caches */
+static unsigned int
+mempool_shared_cache_count(const struct rte_mempool *mp)
+{
+	struct rte_mempool_shared_cache **table;
+	unsigned int socket_id, count = 0;
+
+	if (!(mp->flags & RTE_MEMPOOL_F_SHARED_CACHE))
+		return 0;
+
+	table = rte_mempool_shared_cache_table(mp);
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++)
+		if (table[socket_id] != NULL)
+			count += table[socket_id]->len;
+
+	return count;
+}
+
 /* free a mempool */
 void
 rte_mempool_free(struct rte_mempool *mp)
@@ -740,6 +816,7 @@ rte_mempool_free(struct rte_mempool *mp)
 	rte_mempool_trace_free(mp);
 	rte_mempool_free_memchunks(mp);
 	rte_mempool_ops_free(mp);
+	mempool_shared_cache_free(mp);
 	rte_memzone_free(mp->mz);
 }
 
@@ -842,6 +919,12 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		return NULL;
 	}
 
+	/* shared caches are filled by the per-lcore caches */
+	if ((flags & RTE_MEMPOOL_F_SHARED_CACHE) && cache_size == 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
 	/*
 	 * No objects in the pool can be used for IO until it's populated
 	 * with at least some objects with valid IOVA.
@@ -877,6 +960,10 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	mempool_size = RTE_MEMPOOL_HEADER_SIZE(mp, cache_size);
 	mempool_size += private_data_size;
+	/* the shared cache table follows the private data */
+	if (flags & RTE_MEMPOOL_F_SHARED_CACHE)
+		mempool_size += sizeof(struct rte_mempool_shared_cache *) *
+			RTE_MAX_NUMA_NODES;
 	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
@@ -924,6 +1011,13 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 					   cache_size);
 	}
 
+	if ((flags & RTE_MEMPOOL_F_SHARED_CACHE) &&
+			mempool_shared_cache_create(mp) < 0) {
+		RTE_LOG(ERR, MEMPOOL, "Cannot allocate shared caches.\n");
+		rte_errno = ENOMEM;
+		goto exit_unlock;
+	}
+
 	te->data = mp;
 
 	rte_mcfg_tailq_write_lock();
@@ -1009,6 +1103,7 @@ rte_mempool_avail_count(const struct rte_mempool *mp)
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 		count += mp->local_cache[lcore_id].len;
+	count += mempool_shared_cache_count(mp);
 
 	/*
 	 * due to race condition (access to len is not locked), the
@@ -1046,6 +1141,21 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 			lcore_id, cache_count);
 		count += cache_count;
 	}
+	if (mp->flags & RTE_MEMPOOL_F_SHARED_CACHE) {
+		struct rte_mempool_shared_cache **table;
+		unsigned int socket_id;
+
+		table = rte_mempool_shared_cache_table(mp);
+		for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES;
+				socket_id++) {
+			if (table[socket_id] == NULL)
+				continue;
+			cache_count = table[socket_id]->len;
+			fprintf(f, "    shared_cache_count[socket %u]=%"PRIu32
+				"\n", socket_id, cache_count);
+			count += cache_count;
+		}
+	}
 	fprintf(f, "    total_cache_count=%u\n", count);
 	return count;
 }
@@ -1200,6 +1310,23 @@ mempool_audit_cache(const struct rte_mempool *mp)
 			rte_panic("MEMPOOL: invalid cache len\n");
 		}
 	}
+
+	if (mp->flags & RTE_MEMPOOL_F_SHARED_CACHE) {
+		unsigned int socket_id;
+
+		for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES;
+				socket_id++) {
+			const struct rte_mempool_shared_cache *sc;
+
+			sc = rte_mempool_shared_cache_table(mp)[socket_id];
+			if (sc != NULL && sc->len > sc->size) {
+				RTE_LOG(CRIT, MEMPOOL,
+					"badness on shared cache[%u]\n",
+					socket_id);
+				rte_panic("MEMPOOL: invalid shared cache len\n");
+			}
+		}
+	}
 }
 
 /* check the consistency of mempool (size, cookies, ...) */
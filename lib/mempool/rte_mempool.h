@@ -93,6 +93,17 @@ struct rte_mempool_cache {
 	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3]; /**< Cache objects */
 } __rte_cache_aligned;
 
+/**
+ * A structure that stores the objects shared by the per-lcore caches of
+ * the lcores of a socket, when RTE_MEMPOOL_F_SHARED_CACHE is set.
+ */
+struct rte_mempool_shared_cache {
+	rte_spinlock_t lock;  /**< Protects the shared cache objects */
+	uint32_t size;	      /**< Size of the shared cache */
+	uint32_t len;	      /**< Current shared cache count */
+	void *objs[];	      /**< Shared cache objects */
+} __rte_cache_aligned;
+
 /**
  * A structure that stores the size of mempool elements.
  */
@@ -286,6 +297,11 @@ struct rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG	RTE_MEMPOOL_F_NO_IOVA_CONTIG
 /** Internal: no object from the pool can be used for device IO (DMA). */
 #define RTE_MEMPOOL_F_NON_IO		0x0040
+/**
+ * Per-lcore caches flush their surplus objects to a cache shared by the
+ * lcores of their socket, and refill from it, before using the pool.
+ */
+#define RTE_MEMPOOL_F_SHARED_CACHE	0x0080
 
 /**
  * This macro lists all the mempool flags an application may request.
@@ -295,6 +311,7 @@ struct rte_mempool {
 	| RTE_MEMPOOL_F_SP_PUT \
 	| RTE_MEMPOOL_F_SC_GET \
 	| RTE_MEMPOOL_F_NO_IOVA_CONTIG \
+	| RTE_MEMPOOL_F_SHARED_CACHE \
 	)
 /**
  * @internal When debug is enabled, store some statistics.
@@ -1315,6 +1332,146 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal Get the per-socket shared caches, indexed by socket id,
+ * stored after the private data of the mempool.
+ *
+ * @param mp
+ *   A pointer to the mempool structure, with RTE_MEMPOOL_F_SHARED_CACHE.
+ * @return
+ *   The table of RTE_MAX_NUMA_NODES shared caches.
+ */
+static __rte_always_inline struct rte_mempool_shared_cache **
+rte_mempool_shared_cache_table(const struct rte_mempool *mp)
+{
+	return (struct rte_mempool_shared_cache **)RTE_PTR_ADD(mp,
+		RTE_MEMPOOL_HEADER_SIZE(mp, mp->cache_size) +
+		mp->private_data_size);
+}
+
+/**
+ * @internal Get the shared cache of the socket of the calling lcore.
+ *
+ * @param mp
+ *   A pointer to the mempool structure, with RTE_MEMPOOL_F_SHARED_CACHE.
+ * @return
+ *   The shared cache, or NULL if the lcore has no socket.
+ */
+static __rte_always_inline struct rte_mempool_shared_cache *
+rte_mempool_shared_cache_local(struct rte_mempool *mp)
+{
+	unsigned int socket_id = rte_socket_id();
+
+	if (unlikely(socket_id >= RTE_MAX_NUMA_NODES))
+		return NULL;
+	return rte_mempool_shared_cache_table(mp)[socket_id];
+}
+
+/**
+ * @internal Take up to n objects from the top of a shared cache.
+ *
+ * @return
+ *   The number of objects taken.
+ */
+static __rte_always_inline unsigned int
+rte_mempool_shared_cache_pull(struct rte_mempool_shared_cache *sc,
+		void **obj_table, unsigned int n)
+{
+	if (sc == NULL || sc->len == 0)
+		return 0;
+
+	rte_spinlock_lock(&sc->lock);
+	n = RTE_MIN(n, sc->len);
+	sc->len -= n;
+	rte_memcpy(obj_table, &sc->objs[sc->len], sizeof(void *) * n);
+	rte_spinlock_unlock(&sc->lock);
+
+	return n;
+}
+
+/**
+ * @internal Put objects in the shared cache of the socket of the calling
+ * lcore, and the objects which do not fit in the pool.
+ *
+ * @param mp
+ *   A pointer to the mempool structure, with RTE_MEMPOOL_F_SHARED_CACHE.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to put.
+ */
+static __rte_always_inline void
+rte_mempool_shared_cache_enqueue(struct rte_mempool *mp,
+		void * const *obj_table, unsigned int n)
+{
+	struct rte_mempool_shared_cache *sc;
+	unsigned int room;
+
+	sc = rte_mempool_shared_cache_local(mp);
+	if (sc != NULL && sc->len < sc->size) {
+		rte_spinlock_lock(&sc->lock);
+		room = RTE_MIN(n, sc->size - sc->len);
+		rte_memcpy(&sc->objs[sc->len], obj_table,
+				sizeof(void *) * room);
+		sc->len += room;
+		rte_spinlock_unlock(&sc->lock);
+
+		obj_table += room;
+		n -= room;
+	}
+
+	if (n != 0)
+		rte_mempool_ops_enqueue_bulk(mp, obj_table, n);
+}
+
+/**
+ * @internal Get objects from the shared cache of the socket of the calling
+ * lcore, then from the pool. When the pool is empty, the objects are taken
+ * from the shared caches of the other sockets.
+ *
+ * @param mp
+ *   A pointer to the mempool structure, with RTE_MEMPOOL_F_SHARED_CACHE.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to get.
+ * @return
+ *   - 0: Success; n objects supplied.
+ *   - -ENOENT: Not enough objects; no object is retrieved.
+ */
+static __rte_always_inline int
+rte_mempool_shared_cache_dequeue(struct rte_mempool *mp,
+		void **obj_table, unsigned int n)
+{
+	struct rte_mempool_shared_cache **table;
+	struct rte_mempool_shared_cache *local;
+	unsigned int socket_id, got;
+
+	local = rte_mempool_shared_cache_local(mp);
+	got = rte_mempool_shared_cache_pull(local, obj_table, n);
+	if (got == n)
+		return 0;
+
+	if (rte_mempool_ops_dequeue_bulk(mp, &obj_table[got], n - got) == 0)
+		return 0;
+
+	table = rte_mempool_shared_cache_table(mp);
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES && got < n;
+			socket_id++) {
+		if (table[socket_id] == local)
+			continue;
+		got += rte_mempool_shared_cache_pull(table[socket_id],
+				&obj_table[got], n - got);
+	}
+	if (got == n)
+		return 0;
+
+	/* give back the objects taken */
+	if (got != 0)
+		rte_mempool_shared_cache_enqueue(mp, obj_table, got);
+	return -ENOENT;
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1356,8 +1513,14 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	cache->len += n;
 
 	if (cache->len >= cache->flushthresh) {
-		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
-				cache->len - cache->size);
+		if (unlikely(mp->flags & RTE_MEMPOOL_F_SHARED_CACHE))
+			rte_mempool_shared_cache_enqueue(mp,
+					&cache->objs[cache->size],
+					cache->len - cache->size);
+		else
+			rte_mempool_ops_enqueue_bulk(mp,
+					&cache->objs[cache->size],
+					cache->len - cache->size);
 		cache->len = cache->size;
 	}
 
@@ -1472,8 +1635,12 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		uint32_t req = n + (cache->size - cache->len);
 
 		/* How many do we require i.e. number to fill the cache + the request */
-		ret = rte_mempool_ops_dequeue_bulk(mp,
-			&cache->objs[cache->len], req);
+		if (unlikely(mp->flags & RTE_MEMPOOL_F_SHARED_CACHE))
+			ret = rte_mempool_shared_cache_dequeue(mp,
+				&cache->objs[cache->len], req);
+		else
+			ret = rte_mempool_ops_dequeue_bulk(mp,
+				&cache->objs[cache->len], req);
 		if (unlikely(ret < 0)) {
 			/*
 			 * In the off chance that we are buffer constrained,
@@ -1501,7 +1668,10 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 ring_dequeue:
 
 	/* get remaining objects from ring */
-	ret = rte_mempool_ops_dequeue_bulk(mp, obj_table, n);
+	if (unlikely(mp->flags & RTE_MEMPOOL_F_SHARED_CACHE))
+		ret = rte_mempool_shared_cache_dequeue(mp, obj_table, n);
+	else
+		ret = rte_mempool_ops_dequeue_bulk(mp, obj_table, n);
 
 	if (ret < 0) {
 		RTE_MEMPOOL_STAT_ADD(mp, get_fail_bulk, 1);
@@ -4,6 +4,7 @@
 
 #include <errno.h>
 #include <net/if.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -368,6 +369,50 @@ pcapng_vlan_insert(struct rte_mbuf *m, uint16_t ether_type, uint16_t tci)
 	return 0;
 }
 
+/*
+ * Does any segment use an external buffer, whose free callback
+ * may not be callable from the process freeing the capture.
+ */
+static bool
+pcapng_has_extbuf(const struct rte_mbuf *md)
+{
+	for (; md != NULL; md = md->next)
+		if (RTE_MBUF_HAS_EXTBUF(md))
+			return true;
+	return false;
+}
+
+/* Is the VLAN information of the packet only in the mbuf metadata */
+static bool
+pcapng_vlan_offloaded(const struct rte_mbuf *md,
+		      enum rte_pcapng_direction direction)
+{
+	switch (direction) {
+	case RTE_PCAPNG_DIRECTION_IN:
+		return md->ol_flags & (RTE_MBUF_F_RX_VLAN_STRIPPED |
+				       RTE_MBUF_F_RX_QINQ_STRIPPED);
+	case RTE_PCAPNG_DIRECTION_OUT:
+		return md->ol_flags & (RTE_MBUF_F_TX_VLAN |
+				       RTE_MBUF_F_TX_QINQ);
+	default:
+		return false;
+	}
+}
+
+/* Enhanced packet block flags option */
+static uint32_t
+pcapng_direction_flags(enum rte_pcapng_direction direction)
+{
+	switch (direction) {
+	case RTE_PCAPNG_DIRECTION_IN:
+		return PCAPNG_IFB_INBOUND;
+	case RTE_PCAPNG_DIRECTION_OUT:
+		return PCAPNG_IFB_OUTBOUND;
+	default:
+		return 0;
+	}
+}
+
 /*
  *   The mbufs created use the Pcapng standard enhanced packet  block.
  *
@@ -468,17 +513,7 @@ rte_pcapng_copy(uint16_t port_id, uint32_t queue,
 	if (unlikely(opt == NULL))
 		goto fail;
 
-	switch (direction) {
-	case RTE_PCAPNG_DIRECTION_IN:
-		flags = PCAPNG_IFB_INBOUND;
-		break;
-	case RTE_PCAPNG_DIRECTION_OUT:
-		flags = PCAPNG_IFB_OUTBOUND;
-		break;
-	default:
-		flags = 0;
-	}
-
+	flags = pcapng_direction_flags(direction);
 	opt = pcapng_add_option(opt, PCAPNG_EPB_FLAGS,
 				&flags, sizeof(flags));
 
@@ -494,7 +529,7 @@ rte_pcapng_copy(uint16_t port_id, uint32_t queue,
 		goto fail;
 
 	epb->block_type = PCAPNG_ENHANCED_PACKET_BLOCK;
-	epb->block_length = rte_pktmbuf_data_len(mc);
+	epb->block_length = rte_pktmbuf_pkt_len(mc);
 
 	/* Interface index is filled in later during write */
 	mc->port = port_id;
@@ -514,6 +549,103 @@ rte_pcapng_copy(uint16_t port_id, uint32_t queue,
 	return NULL;
 }
 
+/*
+ * Make the same block as rte_pcapng_copy, but with the packet data
+ * referenced by an indirect mbuf chained between the header
+ * and the trailer mbufs.
+ */
+struct rte_mbuf *
+rte_pcapng_clone(uint16_t port_id, uint32_t queue,
+		 struct rte_mbuf *md,
+		 struct rte_mempool *mp,
+		 uint32_t length, uint64_t cycles,
+		 enum rte_pcapng_direction direction)
+{
+	struct pcapng_enhance_packet_block *epb;
+	uint32_t orig_len, data_len, padding, flags;
+	struct pcapng_option *opt;
+	const uint16_t optlen = pcapng_optlen(sizeof(flags)) + pcapng_optlen(sizeof(queue));
+	struct rte_mbuf *mc, *mh, *mt;
+	uint8_t *tail;
+	uint64_t ns;
+
+#ifdef RTE_LIBRTE_ETHDEV_DEBUG
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, NULL);
+#endif
+	orig_len = rte_pktmbuf_pkt_len(md);
+	data_len = RTE_MIN(orig_len, length);
+
+	/*
+	 * Inserting the VLAN tag or truncating a segmented packet
+	 * needs to modify the data, fallback to a copy.
+	 * So does a packet in external buffers: the capture may be freed
+	 * by a secondary process, e.g. dumpcap, which must not call the
+	 * free callback of the primary process.
+	 */
+	if (pcapng_vlan_offloaded(md, direction) ||
+	    (data_len < orig_len && !rte_pktmbuf_is_contiguous(md)) ||
+	    pcapng_has_extbuf(md))
+		return rte_pcapng_copy(port_id, queue, md, mp, length,
+				       cycles, direction);
+
+	mh = rte_pktmbuf_alloc(mp);
+	mt = rte_pktmbuf_alloc(mp);
+	mc = rte_pktmbuf_clone(md, mp);
+	if (unlikely(mh == NULL || mt == NULL || mc == NULL))
+		goto fail;
+
+	if (data_len < orig_len) {
+		mc->data_len = data_len;
+		mc->pkt_len = data_len;
+	}
+
+	/* pad the packet to 32 bit boundary and add options */
+	padding = RTE_ALIGN(data_len, sizeof(uint32_t)) - data_len;
+	tail = (uint8_t *)rte_pktmbuf_append(mt,
+			padding + optlen + sizeof(uint32_t));
+	epb = (struct pcapng_enhance_packet_block *)
+		rte_pktmbuf_append(mh, sizeof(*epb));
+	if (unlikely(tail == NULL || epb == NULL))
+		goto fail;
+
+	memset(tail, 0, padding);
+	flags = pcapng_direction_flags(direction);
+	opt = pcapng_add_option((struct pcapng_option *)(tail + padding),
+				PCAPNG_EPB_FLAGS, &flags, sizeof(flags));
+	opt = pcapng_add_option(opt, PCAPNG_EPB_QUEUE,
+				&queue, sizeof(queue));
+
+	if (unlikely(rte_pktmbuf_chain(mh, mc) != 0))
+		goto fail;
+	mc = NULL;
+	if (unlikely(rte_pktmbuf_chain(mh, mt) != 0))
+		goto fail;
+	mt = NULL;
+
+	epb->block_type = PCAPNG_ENHANCED_PACKET_BLOCK;
+	epb->block_length = rte_pktmbuf_pkt_len(mh);
+
+	/* Interface index is filled in later during write */
+	mh->port = port_id;
+
+	ns = pcapng_tsc_to_ns(cycles);
+	epb->timestamp_hi = ns >> 32;
+	epb->timestamp_lo = (uint32_t)ns;
+	epb->capture_length = data_len;
+	epb->original_length = orig_len;
+
+	/* set trailer of block length */
+	*(uint32_t *)opt = epb->block_length;
+
+	return mh;
+
+fail:
+	rte_pktmbuf_free(mt);
+	rte_pktmbuf_free(mc);
+	rte_pktmbuf_free(mh);
+	return NULL;
+}
+
 /* Count how many segments are in this array of mbufs */
 static unsigned int
 mbuf_burst_segs(struct rte_mbuf *pkts[], unsigned int n)
@@ -547,7 +679,7 @@ rte_pcapng_write_packets(rte_pcapng_t *self,
 		/* sanity check that is really a pcapng mbuf */
 		epb = rte_pktmbuf_mtod(m, struct pcapng_enhance_packet_block *);
 		if (unlikely(epb->block_type != PCAPNG_ENHANCED_PACKET_BLOCK ||
-			     epb->block_length != rte_pktmbuf_data_len(m))) {
+			     epb->block_length != rte_pktmbuf_pkt_len(m))) {
 			rte_errno = EINVAL;
 			return -1;
 		}
@@ -113,6 +113,48 @@ rte_pcapng_copy(uint16_t port_id, uint32_t queue,
 		uint32_t length, uint64_t timestamp,
 		enum rte_pcapng_direction direction);
 
+/**
+ * Format an mbuf for writing to file, without copying the packet data.
+ *
+ * Same as rte_pcapng_copy() except that the packet data is referenced
+ * by an indirect mbuf, chained between two mbufs holding the pcapng
+ * header and trailer. The original mbuf is not freed until the result
+ * is written and freed, and any change made to its data in the meantime
+ * is seen in the capture.
+ * Packets which must be modified to be captured (VLAN offload,
+ * truncation of a segmented packet) and packets using external
+ * buffers are copied.
+ *
+ * @param port_id
+ *   The Ethernet port on which packet was received
+ *   or is going to be transmitted.
+ * @param queue
+ *   The queue on the Ethernet port where packet was received
+ *   or is going to be transmitted.
+ * @param mp
+ *   The mempool from which the header, trailer and indirect mbufs
+ *   are allocated.
+ * @param m
+ *   The mbuf to reference
+ * @param length
+ *   The upper limit on bytes to capture.  Passing UINT32_MAX
+ *   means all data.
+ * @param timestamp
+ *   The timestamp in TSC cycles.
+ * @param direction
+ *   The direction of the packet: receive, transmit or unknown.
+ *
+ * @return
+ *   - The pointer to the new mbuf formatted for pcapng_write
+ *   - NULL if allocation fails.
+ */
+__rte_experimental
+struct rte_mbuf *
+rte_pcapng_clone(uint16_t port_id, uint32_t queue,
+		 struct rte_mbuf *m, struct rte_mempool *mp,
+		 uint32_t length, uint64_t timestamp,
+		 enum rte_pcapng_direction direction);
+
 
 /**
  * Determine optimum mbuf data size.
@@ -186,6 +228,119 @@ rte_pcapng_write_stats(rte_pcapng_t *self, uint16_t port,
 		       uint64_t start_time, uint64_t end_time,
 		       uint64_t ifrecv, uint64_t ifdrop);
 
+/* Opaque handle used for reading a capture file. */
+typedef struct rte_pcapng_reader rte_pcapng_reader_t;
+
+/**
+ * Open an existing capture file for reading.
+ *
+ * The file is mapped in memory and the packets returned by
+ * rte_pcapng_read_packets() point directly to the mapped file data.
+ * The file must not be truncated while it is in use.
+ *
+ * @param fd
+ *   File descriptor of the capture file, it is closed
+ *   by rte_pcapng_reader_close().
+ * @return
+ *   handle to the reader, or NULL in case of error (and rte_errno is set).
+ */
+__rte_experimental
+rte_pcapng_reader_t *
+rte_pcapng_reader_fdopen(int fd);
+
+/**
+ * Close a capture file opened for reading.
+ *
+ * The mbufs returned by the reader remain valid,
+ * the file is unmapped once all of them are freed.
+ *
+ * @param self
+ *  The handle to the capture file
+ */
+__rte_experimental
+void
+rte_pcapng_reader_close(rte_pcapng_reader_t *self);
+
+/**
+ * Read a burst of packets from the capture file.
+ *
+ * No packet data is copied: each packet is attached
+ * to an mbuf of *mp* as an external buffer pointing to the file mapping,
+ * so the mempool may have no data room at all.
+ * The mbufs have no headroom; the changes made to the packet data
+ * are private to the reader, they are not written to the file
+ * but are seen again if the reader is rewound.
+ *
+ * The capture timestamp of the packet, converted to nanoseconds,
+ * is stored in the Rx timestamp dynamic field,
+ * and the mbuf port is the interface id of the packet in the file.
+ *
+ * Packets larger than the maximum mbuf buffer length (64K) are skipped.
+ *
+ * When a replay speed is set by rte_pcapng_reader_set_speed(),
+ * only the packets whose time has come are returned.
+ *
+ * @param self
+ *  The handle to the capture file
+ * @param mp
+ *  The mempool from which the mbufs are allocated.
+ * @param pkts
+ *  The address of an array of *nb_pkts* pointers
+ *  to be filled with the packets read.
+ * @param nb_pkts
+ *  The maximum number of packets to read.
+ * @return
+ *  The number of packets read. It is less than *nb_pkts* at end of file,
+ *  when the next packet is not due yet, or in case of error
+ *  (rte_errno is set, and the rest of a corrupted file is ignored).
+ */
+__rte_experimental
+uint16_t
+rte_pcapng_read_packets(rte_pcapng_reader_t *self, struct rte_mempool *mp,
+			struct rte_mbuf *pkts[], uint16_t nb_pkts);
+
+/**
+ * Set the replay speed of the capture file.
+ *
+ * With a speed of 1, packets are returned following the intervals between
+ * their original timestamps; a speed of 2 replays the capture twice
+ * as fast. The default speed 0 returns packets as fast as possible.
+ * The replay timing restarts from the next packet read.
+ *
+ * @param self
+ *  The handle to the capture file
+ * @param speed
+ *  The replay speed factor, or 0 to disable pacing.
+ * @return
+ *  0 on success, -EINVAL if the speed is negative.
+ */
+__rte_experimental
+int
+rte_pcapng_reader_set_speed(rte_pcapng_reader_t *self, double speed);
+
+/**
+ * Restart reading from the beginning of the capture file,
+ * for example to replay it in a loop.
+ *
+ * @param self
+ *  The handle to the capture file
+ */
+__rte_experimental
+void
+rte_pcapng_reader_rewind(rte_pcapng_reader_t *self);
+
+/**
+ * Check whether all the packets of the capture file were read.
+ *
+ * @param self
+ *  The handle to the capture file
+ * @return
+ *  1 at end of file, 0 otherwise.
+ */
+__rte_experimental
+int
+rte_pcapng_reader_eof(const rte_pcapng_reader_t *self);
+
 #ifdef __cplusplus
 }
 #endif
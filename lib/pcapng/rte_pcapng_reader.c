@@ -0,0 +1,543 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Microsoft Corporation
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_eal.h>
+#include <rte_errno.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_pcapng.h>
+#include <rte_time.h>
+
+#include "pcapng_proto.h"
+
+/*
+ * The file is mapped in memory and the packets are attached to mbufs
+ * as external buffers, so no packet data is copied.
+ *
+ * The mapping is split in segments, each with its own shared info,
+ * so that the 16 bit reference counter of a shared info cannot overflow
+ * (a segment holds at most 4K of the smallest packet blocks).
+ * The reader holds one reference on every segment; the mapping is
+ * released when the reader is closed and all the mbufs are freed.
+ */
+#define PCAPNG_SEG_SHIFT 16
+
+/* if_tsresol is a power of 2 instead of a power of 10 */
+#define PCAPNG_TSRESOL_POW2 0x80
+
+/* Default interface timestamp resolution is microseconds */
+#define PCAPNG_TSRESOL_DEFAULT 6
+
+struct pcapng_map {
+	void *addr;
+	size_t len;
+	uint32_t nb_segs;
+	uint32_t segs_alive;	/* segments with a reference left */
+	struct rte_mbuf_ext_shared_info shinfo[];
+};
+
+/* Conversion of interface timestamps to nanoseconds */
+struct pcapng_reader_if {
+	uint8_t tsresol;
+	int64_t tsoffset;	/* in seconds */
+	uint32_t snaplen;	/* 0 if unlimited */
+};
+
+/* Format of the replay file handle */
+struct rte_pcapng_reader {
+	int fd;
+	struct pcapng_map *map;
+	const uint8_t *data;
+	size_t size;
+	size_t offset;		/* next block to read */
+	bool swap;		/* section is in other byte order */
+
+	uint32_t nb_ifs;
+	uint32_t max_ifs;
+	struct pcapng_reader_if *ifs;
+
+	int ts_offset;		/* Rx timestamp dynamic field */
+	uint64_t ts_flag;
+
+	/* Replay pacing, speed 0 means as fast as possible */
+	double speed;
+	double ns_to_cycles;
+	bool paced;		/* base time of the replay is set */
+	uint64_t base_ns;
+	uint64_t base_cycles;
+};
+
+/* A packet block found in the file */
+struct pcapng_reader_pkt {
+	const uint8_t *data;
+	uint32_t caplen;
+	uint32_t origlen;
+	uint32_t ifid;
+	uint64_t ns;
+	size_t next;		/* offset of the following block */
+};
+
+static inline uint16_t
+pcapng_rd16(const rte_pcapng_reader_t *self, const void *p)
+{
+	uint16_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return self->swap ? rte_bswap16(v) : v;
+}
+
+static inline uint32_t
+pcapng_rd32(const rte_pcapng_reader_t *self, const void *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return self->swap ? rte_bswap32(v) : v;
+}
+
+static inline uint64_t
+pcapng_rd64(const rte_pcapng_reader_t *self, const void *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return self->swap ? rte_bswap64(v) : v;
+}
+
+static void
+pcapng_map_release(struct pcapng_map *map)
+{
+	if (__atomic_sub_fetch(&map->segs_alive, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+
+	munmap(map->addr, map->len);
+	free(map);
+}
+
+/* Called when the last reference on a segment is dropped */
+static void
+pcapng_seg_free(void *addr __rte_unused, void *opaque)
+{
+	pcapng_map_release(opaque);
+}
+
+/* Timestamp of an interface converted to nanoseconds */
+static uint64_t
+pcapng_ts_to_ns(const struct pcapng_reader_if *pif, uint64_t ts)
+{
+	uint8_t res = pif->tsresol;
+	uint64_t ns, frac;
+	unsigned int i;
+
+	if (res & PCAPNG_TSRESOL_POW2) {
+		res &= ~PCAPNG_TSRESOL_POW2;
+		if (res >= 64)
+			return 0;
+		/* Split to avoid overflow: seconds and fraction */
+		ns = (ts >> res) * NSEC_PER_SEC;
+		frac = ts & (RTE_BIT64(res) - 1);
+		if (res <= 32)
+			ns += (frac * NSEC_PER_SEC) >> res;
+		else
+			/* and fraction in 32-bit halves */
+			ns += ((frac >> 32) * NSEC_PER_SEC +
+			       (((frac & UINT32_MAX) * NSEC_PER_SEC) >> 32))
+				>> (res - 32);
+	} else if (res <= 9) {
+		ns = ts;
+		for (i = res; i < 9; i++)
+			ns *= 10;
+	} else {
+		ns = ts;
+		for (i = 9; i < res; i++)
+			ns /= 10;
+	}
+
+	return ns + pif->tsoffset * (int64_t)NSEC_PER_SEC;
+}
+
+/* Record the timestamp settings of a new interface */
+static int
+pcapng_read_interface(rte_pcapng_reader_t *self, const uint8_t *blk,
+		      uint32_t len)
+{
+	struct pcapng_reader_if *pif;
+	const uint8_t *opt, *end;
+	uint16_t code, optlen;
+
+	if (len < sizeof(struct pcapng_interface_block) + sizeof(uint32_t))
+		return -EBADMSG;
+
+	if (self->nb_ifs == self->max_ifs) {
+		uint32_t max = RTE_MAX(self->max_ifs * 2, 8u);
+
+		pif = realloc(self->ifs, max * sizeof(*pif));
+		if (pif == NULL)
+			return -ENOMEM;
+		self->ifs = pif;
+		self->max_ifs = max;
+	}
+
+	pif = &self->ifs[self->nb_ifs++];
+	pif->tsresol = PCAPNG_TSRESOL_DEFAULT;
+	pif->tsoffset = 0;
+	pif->snaplen = pcapng_rd32(self,
+		blk + offsetof(struct pcapng_interface_block, snap_len));
+
+	opt = blk + sizeof(struct pcapng_interface_block);
+	end = blk + len - sizeof(uint32_t);
+	while (opt + sizeof(struct pcapng_option) <= end) {
+		code = pcapng_rd16(self, opt);
+		optlen = pcapng_rd16(self, opt + sizeof(uint16_t));
+		if (code == PCAPNG_OPT_END)
+			break;
+
+		opt += sizeof(struct pcapng_option);
+		if (opt + optlen > end)
+			return -EBADMSG;
+
+		if (code == PCAPNG_IFB_TSRESOL && optlen >= 1)
+			pif->tsresol = opt[0];
+		else if (code == PCAPNG_IFB_TSOFFSET && optlen >= 8)
+			pif->tsoffset = (int64_t)pcapng_rd64(self, opt);
+
+		opt += RTE_ALIGN(optlen, sizeof(uint32_t));
+	}
+
+	return 0;
+}
+
+/* Start of a new section, which may change the byte order */
+static int
+pcapng_read_section(rte_pcapng_reader_t *self, const uint8_t *blk,
+		    size_t avail)
+{
+	uint32_t magic;
+
+	if (avail < sizeof(struct pcapng_section_header))
+		return -EBADMSG;
+
+	memcpy(&magic, blk + offsetof(struct pcapng_section_header,
+				      byte_order_magic), sizeof(magic));
+	if (magic == PCAPNG_BYTE_ORDER_MAGIC)
+		self->swap = false;
+	else if (magic == rte_bswap32(PCAPNG_BYTE_ORDER_MAGIC))
+		self->swap = true;
+	else
+		return -EBADMSG;
+
+	if (pcapng_rd16(self, blk + offsetof(struct pcapng_section_header,
+					     major_version)) != PCAPNG_MAJOR_VERS)
+		return -ENOTSUP;
+
+	/* Interface ids are local to a section */
+	self->nb_ifs = 0;
+	return 0;
+}
+
+/*
+ * Find the next packet block, processing the other blocks on the way.
+ * The packet block itself is not consumed.
+ * Returns 1 if a packet is found, 0 at end of file or a negative errno.
+ */
+static int
+pcapng_next_packet(rte_pcapng_reader_t *self, struct pcapng_reader_pkt *pkt)
+{
+	const struct pcapng_enhance_packet_block *epb;
+	const uint8_t *blk;
+	uint32_t type, len;
+	size_t avail;
+	int ret;
+
+	while (self->size - self->offset >= 3 * sizeof(uint32_t)) {
+		blk = self->data + self->offset;
+		avail = self->size - self->offset;
+
+		type = pcapng_rd32(self, blk);
+		if (type == PCAPNG_SECTION_BLOCK) {
+			ret = pcapng_read_section(self, blk, avail);
+			if (ret < 0)
+				return ret;
+		}
+
+		len = pcapng_rd32(self, blk + sizeof(uint32_t));
+		if (len < 3 * sizeof(uint32_t) || len > avail ||
+		    len % sizeof(uint32_t) != 0)
+			return -EBADMSG;
+
+		switch (type) {
+		case PCAPNG_INTERFACE_BLOCK:
+			ret = pcapng_read_interface(self, blk, len);
+			if (ret < 0)
+				return ret;
+			break;
+
+		case PCAPNG_ENHANCED_PACKET_BLOCK:
+			if (len < sizeof(*epb) + sizeof(uint32_t))
+				return -EBADMSG;
+			epb = (const struct pcapng_enhance_packet_block *)blk;
+			pkt->ifid = pcapng_rd32(self, &epb->interface_id);
+			pkt->caplen = pcapng_rd32(self, &epb->capture_length);
+			pkt->origlen = pcapng_rd32(self, &epb->original_length);
+			if (pkt->ifid >= self->nb_ifs ||
+			    pkt->caplen > len - sizeof(*epb) - sizeof(uint32_t))
+				return -EBADMSG;
+			pkt->data = blk + sizeof(*epb);
+			pkt->ns = pcapng_ts_to_ns(&self->ifs[pkt->ifid],
+				(uint64_t)pcapng_rd32(self, &epb->timestamp_hi) << 32 |
+				pcapng_rd32(self, &epb->timestamp_lo));
+			pkt->next = self->offset + len;
+			return 1;
+
+		case PCAPNG_SIMPLE_PACKET_BLOCK:
+			if (self->nb_ifs == 0)
+				return -EBADMSG;
+			/* No timestamp, snapshot length is in the interface */
+			pkt->ifid = 0;
+			pkt->origlen = pcapng_rd32(self, blk + 2 * sizeof(uint32_t));
+			pkt->caplen = RTE_MIN(pkt->origlen,
+				(uint32_t)(len - sizeof(struct pcapng_simple_packet)
+					   - sizeof(uint32_t)));
+			if (self->ifs[0].snaplen != 0)
+				pkt->caplen = RTE_MIN(pkt->caplen,
+						      self->ifs[0].snaplen);
+			pkt->data = blk + sizeof(struct pcapng_simple_packet);
+			pkt->ns = 0;
+			pkt->next = self->offset + len;
+			return 1;
+
+		default:
+			/* Section header was handled above, others are skipped */
+			break;
+		}
+
+		self->offset += len;
+	}
+
+	return 0;
+}
+
+/* Return true if the packet should not be released yet */
+static inline bool
+pcapng_replay_wait(rte_pcapng_reader_t *self,
+		   const struct pcapng_reader_pkt *pkt, uint64_t now)
+{
+	if (!self->paced) {
+		self->paced = true;
+		self->base_ns = pkt->ns;
+		self->base_cycles = now;
+		return false;
+	}
+
+	/* Packets going back in time are sent right away */
+	if (pkt->ns <= self->base_ns)
+		return false;
+
+	return now - self->base_cycles <
+		(uint64_t)((pkt->ns - self->base_ns) * self->ns_to_cycles);
+}
+
+uint16_t
+rte_pcapng_read_packets(rte_pcapng_reader_t *self, struct rte_mempool *mp,
+			struct rte_mbuf *pkts[], uint16_t nb_pkts)
+{
+	struct pcapng_reader_pkt pkt;
+	struct rte_mbuf_ext_shared_info *shinfo;
+	struct rte_mbuf *m;
+	uint64_t now = 0;
+	uint16_t nb_rx = 0;
+	rte_iova_t iova;
+	int ret;
+
+	if (unlikely(rte_pktmbuf_alloc_bulk(mp, pkts, nb_pkts) != 0)) {
+		rte_errno = ENOBUFS;
+		return 0;
+	}
+
+	if (self->speed > 0)
+		now = rte_get_tsc_cycles();
+
+	while (nb_rx < nb_pkts) {
+		ret = pcapng_next_packet(self, &pkt);
+		if (ret <= 0) {
+			if (ret < 0) {
+				/* Stop reading a corrupted file */
+				self->offset = self->size;
+				rte_errno = -ret;
+			}
+			break;
+		}
+
+		if (self->speed > 0 && pcapng_replay_wait(self, &pkt, now))
+			break;
+
+		self->offset = pkt.next;
+
+		/* Larger packets do not fit in a single mbuf */
+		if (unlikely(pkt.caplen > UINT16_MAX))
+			continue;
+
+		shinfo = &self->map->shinfo[(pkt.data - self->data) >>
+					    PCAPNG_SEG_SHIFT];
+		rte_mbuf_ext_refcnt_update(shinfo, 1);
+
+		if (rte_eal_iova_mode() == RTE_IOVA_VA)
+			iova = (uintptr_t)pkt.data;
+		else
+			iova = RTE_BAD_IOVA;
+
+		m = pkts[nb_rx++];
+		rte_pktmbuf_attach_extbuf(m, (void *)(uintptr_t)pkt.data,
+					  iova, pkt.caplen, shinfo);
+		m->data_len = pkt.caplen;
+		m->pkt_len = pkt.caplen;
+		m->port = pkt.ifid;
+
+		*RTE_MBUF_DYNFIELD(m, self->ts_offset,
+				   rte_mbuf_timestamp_t *) = pkt.ns;
+		m->ol_flags |= self->ts_flag;
+	}
+
+	if (nb_rx < nb_pkts)
+		rte_pktmbuf_free_bulk(pkts + nb_rx, nb_pkts - nb_rx);
+
+	return nb_rx;
+}
+
+int
+rte_pcapng_reader_set_speed(rte_pcapng_reader_t *self, double speed)
+{
+	if (!(speed >= 0))
+		return -EINVAL;
+
+	self->speed = speed;
+	if (speed > 0)
+		self->ns_to_cycles = (double)rte_get_tsc_hz() /
+			(NSEC_PER_SEC * speed);
+	self->paced = false;
+	return 0;
+}
+
+void
+rte_pcapng_reader_rewind(rte_pcapng_reader_t *self)
+{
+	self->offset = 0;
+	self->nb_ifs = 0;
+	self->paced = false;
+}
+
+int
+rte_pcapng_reader_eof(const rte_pcapng_reader_t *self)
+{
+	return self->offset >= self->size;
+}
+
+/* Create new pcapng reader handle */
+rte_pcapng_reader_t *
+rte_pcapng_reader_fdopen(int fd)
+{
+	rte_pcapng_reader_t *self;
+	struct pcapng_map *map;
+	struct stat st;
+	uint32_t i, nb_segs;
+	void *addr;
+	int ret;
+
+	if (fstat(fd, &st) < 0) {
+		rte_errno = errno;
+		return NULL;
+	}
+
+	if (st.st_size < (off_t)sizeof(struct pcapng_section_header)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	self = calloc(1, sizeof(*self));
+	if (self == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	ret = rte_mbuf_dyn_rx_timestamp_register(&self->ts_offset,
+						 &self->ts_flag);
+	if (ret < 0)
+		goto fail;
+
+	nb_segs = RTE_ALIGN_CEIL((size_t)st.st_size,
+				 RTE_BIT64(PCAPNG_SEG_SHIFT)) >> PCAPNG_SEG_SHIFT;
+	map = malloc(sizeof(*map) + nb_segs * sizeof(map->shinfo[0]));
+	if (map == NULL) {
+		rte_errno = ENOMEM;
+		goto fail;
+	}
+
+	/*
+	 * A private writable mapping lets applications modify the packets
+	 * without changing the file.
+	 */
+	addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+		    fd, 0);
+	if (addr == MAP_FAILED) {
+		rte_errno = errno;
+		free(map);
+		goto fail;
+	}
+
+	map->addr = addr;
+	map->len = st.st_size;
+	map->nb_segs = nb_segs;
+	map->segs_alive = nb_segs;
+	for (i = 0; i < nb_segs; i++) {
+		map->shinfo[i].free_cb = pcapng_seg_free;
+		map->shinfo[i].fcb_opaque = map;
+		rte_mbuf_ext_refcnt_set(&map->shinfo[i], 1);
+	}
+
+	self->fd = fd;
+	self->map = map;
+	self->data = addr;
+	self->size = st.st_size;
+
+	/* The file must start with a section header */
+	if (pcapng_rd32(self, self->data) != PCAPNG_SECTION_BLOCK ||
+	    pcapng_read_section(self, self->data, self->size) < 0) {
+		rte_errno = EINVAL;
+		munmap(addr, map->len);
+		free(map);
+		goto fail;
+	}
+
+	return self;
+fail:
+	free(self);
+	return NULL;
+}
+
+void
+rte_pcapng_reader_close(rte_pcapng_reader_t *self)
+{
+	struct pcapng_map *map = self->map;
+	uint32_t i;
+
+	/* Mbufs still using the file keep it mapped */
+	for (i = 0; i < map->nb_segs; i++)
+		if (rte_mbuf_ext_refcnt_update(&map->shinfo[i], -1) == 0)
+			pcapng_map_release(map);
+
+	close(self->fd);
+	free(self->ifs);
+	free(self);
+}
@@ -2,6 +2,8 @@
  * Copyright(c) 2016-2018 Intel Corporation
  */
 
+#include <stdbool.h>
+
 #include <rte_mbuf.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
@@ -45,6 +47,7 @@ struct pdump_request {
 
 	const struct rte_bpf_prm *prm;
 	uint32_t snaplen;
+	struct rte_pdump_sampling sampling;
 };
 
 struct pdump_response {
@@ -60,6 +63,19 @@ static struct pdump_rxtx_cbs {
 	const struct rte_bpf *filter;
 	enum pdump_version ver;
 	uint32_t snaplen;
+	bool zerocopy;
+
+	/*
+	 * Sampling state, only used by the lcore polling the queue.
+	 * The rate limit is a token bucket counting in TSC cycles:
+	 * each captured packet costs rate_cost cycles of credit.
+	 */
+	uint32_t ratio;
+	uint32_t sample_left;
+	uint64_t rate_cost;
+	uint64_t credit;
+	uint64_t credit_max;
+	uint64_t last_refill;
 } rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
@@ -76,12 +92,75 @@ static struct {
 	const struct rte_memzone *mz;
 } *pdump_stats;
 
+/*
+ * Does any segment use an external buffer, whose free callback
+ * may not be callable from the process freeing the capture.
+ */
+static bool
+pdump_has_extbuf(const struct rte_mbuf *m)
+{
+	for (; m != NULL; m = m->next)
+		if (RTE_MBUF_HAS_EXTBUF(m))
+			return true;
+	return false;
+}
+
+/* Reference the data of the mbuf instead of copying it */
+static struct rte_mbuf *
+pdump_clone(struct rte_mbuf *m, struct rte_mempool *mp, uint32_t snaplen)
+{
+	struct rte_mbuf *mc;
+
+	/*
+	 * Only the last segment of a chain could be truncated.
+	 * External buffers are copied, as in rte_pcapng_clone().
+	 */
+	if ((snaplen < rte_pktmbuf_pkt_len(m) &&
+	     !rte_pktmbuf_is_contiguous(m)) || pdump_has_extbuf(m))
+		return rte_pktmbuf_copy(m, mp, 0, snaplen);
+
+	mc = rte_pktmbuf_clone(m, mp);
+	if (mc != NULL && snaplen < rte_pktmbuf_pkt_len(mc)) {
+		mc->data_len = snaplen;
+		mc->pkt_len = snaplen;
+	}
+	return mc;
+}
+
+/* Apply the 1 in N sampling, return true if the packet is skipped */
+static inline bool
+pdump_sample_skip(struct pdump_rxtx_cbs *cbs)
+{
+	if (cbs->ratio <= 1)
+		return false;
+
+	if (--cbs->sample_left != 0)
+		return true;
+
+	cbs->sample_left = cbs->ratio;
+	return false;
+}
+
+/* Take rate limit credit for a packet, return true if none is left */
+static inline bool
+pdump_rate_skip(struct pdump_rxtx_cbs *cbs)
+{
+	if (cbs->rate_cost == 0)
+		return false;
+
+	if (cbs->credit < cbs->rate_cost)
+		return true;
+
+	cbs->credit -= cbs->rate_cost;
+	return false;
+}
+
 /* Create a clone of mbuf to be placed into ring. */
 static void
 pdump_copy(uint16_t port_id, uint16_t queue,
 	   enum rte_pcapng_direction direction,
 	   struct rte_mbuf **pkts, uint16_t nb_pkts,
-	   const struct pdump_rxtx_cbs *cbs,
+	   struct pdump_rxtx_cbs *cbs,
 	   struct rte_pdump_stats *stats)
 {
 	unsigned int i;
@@ -93,6 +172,7 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 	struct rte_mempool *mp;
 	struct rte_mbuf *p;
 	uint64_t rcs[nb_pkts];
+	unsigned int room, sampled = 0, ratelimited = 0, ringfull = 0;
 
 	if (cbs->filter)
 		rte_bpf_exec_burst(cbs->filter, (void **)pkts, rcs, nb_pkts);
@@ -100,6 +180,21 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 	ts = rte_get_tsc_cycles();
 	ring = cbs->ring;
 	mp = cbs->mp;
+
+	if (cbs->rate_cost != 0) {
+		cbs->credit = RTE_MIN(cbs->credit + (ts - cbs->last_refill),
+				      cbs->credit_max);
+		cbs->last_refill = ts;
+	}
+
+	/*
+	 * Packets which cannot be enqueued are dropped before being copied,
+	 * so that an overloaded capture does not slow down the datapath
+	 * more than needed. Other queues may fill the ring meanwhile,
+	 * in which case the enqueue below drops the extra packets.
+	 */
+	room = rte_ring_free_count(ring);
+
 	for (i = 0; i < nb_pkts; i++) {
 		/*
 		 * This uses same BPF return value convention as socket filter
@@ -113,14 +208,35 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 			continue;
 		}
 
+		if (pdump_sample_skip(cbs)) {
+			sampled++;
+			continue;
+		}
+
+		if (pdump_rate_skip(cbs)) {
+			ratelimited++;
+			continue;
+		}
+
+		if (d_pkts == room) {
+			ringfull++;
+			continue;
+		}
+
 		/*
 		 * If using pcapng then want to wrap packets
 		 * otherwise a simple copy.
 		 */
-		if (cbs->ver == V2)
+		if (cbs->ver == V2 && cbs->zerocopy)
+			p = rte_pcapng_clone(port_id, queue,
+					     pkts[i], mp, cbs->snaplen,
+					     ts, direction);
+		else if (cbs->ver == V2)
 			p = rte_pcapng_copy(port_id, queue,
 					    pkts[i], mp, cbs->snaplen,
 					    ts, direction);
+		else if (cbs->zerocopy)
+			p = pdump_clone(pkts[i], mp, cbs->snaplen);
 		else
 			p = rte_pktmbuf_copy(pkts[i], mp, 0, cbs->snaplen);
 
@@ -131,14 +247,21 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 	}
 
 	__atomic_fetch_add(&stats->accepted, d_pkts, __ATOMIC_RELAXED);
+	if (sampled != 0)
+		__atomic_fetch_add(&stats->sampled, sampled, __ATOMIC_RELAXED);
+	if (ratelimited != 0)
+		__atomic_fetch_add(&stats->ratelimited, ratelimited,
+				   __ATOMIC_RELAXED);
 
 	ring_enq = rte_ring_enqueue_burst(ring, (void *)dup_bufs, d_pkts, NULL);
 	if (unlikely(ring_enq < d_pkts)) {
 		unsigned int drops = d_pkts - ring_enq;
 
-		__atomic_fetch_add(&stats->ringfull, drops, __ATOMIC_RELAXED);
+		ringfull += drops;
 		rte_pktmbuf_free_bulk(&dup_bufs[ring_enq], drops);
 	}
+	if (unlikely(ringfull != 0))
+		__atomic_fetch_add(&stats->ringfull, ringfull, __ATOMIC_RELAXED);
 }
 
 static uint16_t
@@ -146,7 +269,7 @@ pdump_rx(uint16_t port, uint16_t queue,
 	struct rte_mbuf **pkts, uint16_t nb_pkts,
 	uint16_t max_pkts __rte_unused, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->rx[port][queue];
 
 	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_IN,
@@ -158,7 +281,7 @@ static uint16_t
 pdump_tx(uint16_t port, uint16_t queue,
 		struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->tx[port][queue];
 
 	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_OUT,
@@ -166,12 +289,38 @@ pdump_tx(uint16_t port, uint16_t queue,
 	return nb_pkts;
 }
 
+static void
+pdump_cbs_init(struct pdump_rxtx_cbs *cbs, const struct pdump_request *p,
+	       const struct rte_bpf *filter)
+{
+	const struct rte_pdump_sampling *sampling = &p->sampling;
+	uint64_t hz = rte_get_tsc_hz();
+
+	cbs->ver = p->ver;
+	cbs->ring = p->ring;
+	cbs->mp = p->mp;
+	cbs->snaplen = p->snaplen;
+	cbs->filter = filter;
+	cbs->zerocopy = !!(p->flags & RTE_PDUMP_FLAG_ZEROCOPY);
+
+	cbs->ratio = sampling->ratio;
+	cbs->sample_left = 1;
+	if (sampling->rate != 0) {
+		cbs->rate_cost = RTE_MAX(hz / sampling->rate, UINT64_C(1));
+		cbs->credit_max = cbs->rate_cost *
+			RTE_MAX(sampling->burst, UINT32_C(1));
+	} else {
+		cbs->rate_cost = 0;
+		cbs->credit_max = 0;
+	}
+	cbs->credit = cbs->credit_max;
+	cbs->last_refill = rte_get_tsc_cycles();
+}
+
 static int
-pdump_register_rx_callbacks(enum pdump_version ver,
+pdump_register_rx_callbacks(const struct pdump_request *p,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
-			    struct rte_ring *ring, struct rte_mempool *mp,
-			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    struct rte_bpf *filter)
 {
 	uint16_t qid;
 
@@ -179,18 +328,14 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 	for (; qid < end_q; qid++) {
 		struct pdump_rxtx_cbs *cbs = &rx_cbs[port][qid];
 
-		if (operation == ENABLE) {
+		if (p->op == ENABLE) {
 			if (cbs->cb) {
 				PDUMP_LOG(ERR,
 					"rx callback for port=%d queue=%d, already exists\n",
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ver = ver;
-			cbs->ring = ring;
-			cbs->mp = mp;
-			cbs->snaplen = snaplen;
-			cbs->filter = filter;
+			pdump_cbs_init(cbs, p, filter);
 
 			cbs->cb = rte_eth_add_first_rx_callback(port, qid,
 								pdump_rx, cbs);
@@ -200,7 +345,7 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 					rte_errno);
 				return rte_errno;
 			}
-		} else if (operation == DISABLE) {
+		} else if (p->op == DISABLE) {
 			int ret;
 
 			if (cbs->cb == NULL) {
@@ -223,12 +368,29 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 	return 0;
 }
 
+/*
+ * With MBUF_FAST_FREE, the driver puts the transmitted mbufs back
+ * in their pool whatever their reference count: the capture
+ * cannot reference them and has to copy them.
+ */
+static bool
+pdump_tx_fast_free(uint16_t port, uint16_t queue)
+{
+	struct rte_eth_conf dev_conf;
+	struct rte_eth_txq_info qinfo;
+
+	if (rte_eth_dev_conf_get(port, &dev_conf) == 0 &&
+	    (dev_conf.txmode.offloads & RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE))
+		return true;
+
+	return rte_eth_tx_queue_info_get(port, queue, &qinfo) == 0 &&
+		(qinfo.conf.offloads & RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE);
+}
+
 static int
-pdump_register_tx_callbacks(enum pdump_version ver,
+pdump_register_tx_callbacks(const struct pdump_request *p,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
-			    struct rte_ring *ring, struct rte_mempool *mp,
-			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    struct rte_bpf *filter)
 {
 
 	uint16_t qid;
@@ -237,18 +399,20 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 	for (; qid < end_q; qid++) {
 		struct pdump_rxtx_cbs *cbs = &tx_cbs[port][qid];
 
-		if (operation == ENABLE) {
+		if (p->op == ENABLE) {
 			if (cbs->cb) {
 				PDUMP_LOG(ERR,
 					"tx callback for port=%d queue=%d, already exists\n",
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ver = ver;
-			cbs->ring = ring;
-			cbs->mp = mp;
-			cbs->snaplen = snaplen;
-			cbs->filter = filter;
+			pdump_cbs_init(cbs, p, filter);
+			if (cbs->zerocopy && pdump_tx_fast_free(port, qid)) {
+				PDUMP_LOG(INFO,
+					"tx queue %u of port %u frees mbufs fast, copying packets\n",
+					qid, port);
+				cbs->zerocopy = false;
+			}
 
 			cbs->cb = rte_eth_add_tx_callback(port, qid, pdump_tx,
 								cbs);
@@ -258,7 +422,7 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 					rte_errno);
 				return rte_errno;
 			}
-		} else if (operation == DISABLE) {
+		} else if (p->op == DISABLE) {
 			int ret;
 
 			if (cbs->cb == NULL) {
@@ -289,9 +453,6 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	int ret = 0;
 	struct rte_bpf *filter = NULL;
 	uint32_t flags;
-	uint16_t operation;
-	struct rte_ring *ring;
-	struct rte_mempool *mp;
 
 	/* Check for possible DPDK version mismatch */
 	if (!(p->ver == V1 || p->ver == V2)) {
@@ -316,11 +477,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 		}
 	}
 
-	flags = p->flags;
-	operation = p->op;
+	flags = p->flags & RTE_PDUMP_FLAG_RXTX;
 	queue = p->queue;
-	ring = p->ring;
-	mp = p->mp;
 
 	ret = rte_eth_dev_get_port_by_name(p->device, &port);
 	if (ret < 0) {
@@ -365,9 +523,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	/* register RX callback */
 	if (flags & RTE_PDUMP_FLAG_RX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_rx_q : queue + 1;
-		ret = pdump_register_rx_callbacks(p->ver, end_q, port, queue,
-						  ring, mp, filter,
-						  operation, p->snaplen);
+		ret = pdump_register_rx_callbacks(p, end_q, port, queue,
+						  filter);
 		if (ret < 0)
 			return ret;
 	}
@@ -375,9 +532,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	/* register TX callback */
 	if (flags & RTE_PDUMP_FLAG_TX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_tx_q : queue + 1;
-		ret = pdump_register_tx_callbacks(p->ver, end_q, port, queue,
-						  ring, mp, filter,
-						  operation, p->snaplen);
+		ret = pdump_register_tx_callbacks(p, end_q, port, queue,
+						  filter);
 		if (ret < 0)
 			return ret;
 	}
@@ -488,7 +644,8 @@ pdump_validate_flags(uint32_t flags)
 	}
 
 	/* mask off the flags we know about */
-	if (flags & ~(RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_PCAPNG)) {
+	if (flags & ~(RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_PCAPNG |
+		      RTE_PDUMP_FLAG_ZEROCOPY)) {
 		PDUMP_LOG(ERR,
 			  "unknown flags: %#x\n", flags);
 		rte_errno = ENOTSUP;
@@ -526,7 +683,8 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 			     uint16_t operation,
 			     struct rte_ring *ring,
 			     struct rte_mempool *mp,
-			     const struct rte_bpf_prm *prm)
+			     const struct rte_bpf_prm *prm,
+			     const struct rte_pdump_sampling *sampling)
 {
 	int ret = -1;
 	struct rte_mp_msg mp_req, *mp_rep;
@@ -538,7 +696,7 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 	memset(req, 0, sizeof(*req));
 
 	req->ver = (flags & RTE_PDUMP_FLAG_PCAPNG) ? V2 : V1;
-	req->flags = flags & RTE_PDUMP_FLAG_RXTX;
+	req->flags = flags & (RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_ZEROCOPY);
 	req->op = operation;
 	req->queue = queue;
 	rte_strscpy(req->device, device, sizeof(req->device));
@@ -548,6 +706,8 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 		req->mp = mp;
 		req->prm = prm;
 		req->snaplen = snaplen;
+		if (sampling != NULL)
+			req->sampling = *sampling;
 	}
 
 	rte_strscpy(mp_req.name, PDUMP_MP, RTE_MP_MAX_NAME_LEN);
@@ -578,7 +738,8 @@ static int
 pdump_enable(uint16_t port, uint16_t queue,
 	     uint32_t flags, uint32_t snaplen,
 	     struct rte_ring *ring, struct rte_mempool *mp,
-	     const struct rte_bpf_prm *prm)
+	     const struct rte_bpf_prm *prm,
+	     const struct rte_pdump_sampling *sampling)
 {
 	int ret;
 	char name[RTE_DEV_NAME_MAX_LEN];
@@ -597,7 +758,7 @@ pdump_enable(uint16_t port, uint16_t queue,
 		snaplen = UINT32_MAX;
 
 	return pdump_prepare_client_request(name, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+					    ENABLE, ring, mp, prm, sampling);
 }
 
 int
@@ -607,7 +768,7 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 		 void *filter __rte_unused)
 {
 	return pdump_enable(port, queue, flags, 0,
-			    ring, mp, NULL);
+			    ring, mp, NULL, NULL);
 }
 
 int
@@ -618,7 +779,19 @@ rte_pdump_enable_bpf(uint16_t port, uint16_t queue,
 		     const struct rte_bpf_prm *prm)
 {
 	return pdump_enable(port, queue, flags, snaplen,
-			    ring, mp, prm);
+			    ring, mp, prm, NULL);
+}
+
+int
+rte_pdump_enable_sampled(uint16_t port, uint16_t queue,
+			 uint32_t flags, uint32_t snaplen,
+			 struct rte_ring *ring,
+			 struct rte_mempool *mp,
+			 const struct rte_bpf_prm *prm,
+			 const struct rte_pdump_sampling *sampling)
+{
+	return pdump_enable(port, queue, flags, snaplen,
+			    ring, mp, prm, sampling);
 }
 
 static int
@@ -626,7 +799,8 @@ pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
 			 uint32_t flags, uint32_t snaplen,
 			 struct rte_ring *ring,
 			 struct rte_mempool *mp,
-			 const struct rte_bpf_prm *prm)
+			 const struct rte_bpf_prm *prm,
+			 const struct rte_pdump_sampling *sampling)
 {
 	int ret;
 
@@ -641,7 +815,7 @@ pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
 		snaplen = UINT32_MAX;
 
 	return pdump_prepare_client_request(device_id, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+					    ENABLE, ring, mp, prm, sampling);
 }
 
 int
@@ -652,7 +826,7 @@ rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
 			     void *filter __rte_unused)
 {
 	return pdump_enable_by_deviceid(device_id, queue, flags, 0,
-					ring, mp, NULL);
+					ring, mp, NULL, NULL);
 }
 
 int
@@ -663,7 +837,19 @@ rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
 				 const struct rte_bpf_prm *prm)
 {
 	return pdump_enable_by_deviceid(device_id, queue, flags, snaplen,
-					ring, mp, prm);
+					ring, mp, prm, NULL);
+}
+
+int
+rte_pdump_enable_sampled_by_deviceid(const char *device_id, uint16_t queue,
+				     uint32_t flags, uint32_t snaplen,
+				     struct rte_ring *ring,
+				     struct rte_mempool *mp,
+				     const struct rte_bpf_prm *prm,
+				     const struct rte_pdump_sampling *sampling)
+{
+	return pdump_enable_by_deviceid(device_id, queue, flags, snaplen,
+					ring, mp, prm, sampling);
 }
 
 int
@@ -680,7 +866,7 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 		return ret;
 
 	ret = pdump_prepare_client_request(name, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+					   DISABLE, NULL, NULL, NULL, NULL);
 
 	return ret;
 }
@@ -696,7 +882,7 @@ rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 		return ret;
 
 	ret = pdump_prepare_client_request(device_id, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+					   DISABLE, NULL, NULL, NULL, NULL);
 
 	return ret;
 }
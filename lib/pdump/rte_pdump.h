@@ -28,6 +28,25 @@ enum {
 	RTE_PDUMP_FLAG_RXTX = (RTE_PDUMP_FLAG_RX|RTE_PDUMP_FLAG_TX),
 
 	RTE_PDUMP_FLAG_PCAPNG = 4, /* format for pcapng */
+	RTE_PDUMP_FLAG_ZEROCOPY = 8, /* reference packet data, no copy */
+};
+
+/**
+ * Sampling of the packets captured on each queue.
+ *
+ * Sampling is applied to the packets accepted by the filter,
+ * in the process doing the capture (primary), so that skipped packets
+ * cost neither a copy nor room in the ring.
+ */
+struct rte_pdump_sampling {
+	/** Capture one packet in every *ratio* packets, 0 or 1 for all. */
+	uint32_t ratio;
+	/** Packets which can be captured at once by the rate limit,
+	 *  0 is the same as 1.
+	 */
+	uint32_t burst;
+	/** Maximum number of packets captured per second, 0 for no limit. */
+	uint64_t rate;
 };
 
 /**
@@ -116,6 +135,54 @@ rte_pdump_enable_bpf(uint16_t port_id, uint16_t queue,
 		     struct rte_mempool *mp,
 		     const struct rte_bpf_prm *prm);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ * Enables sampled packet capturing on given port and queue with filtering.
+ *
+ * With the flag RTE_PDUMP_FLAG_ZEROCOPY, the captured mbufs reference
+ * the packet data instead of copying it, delaying the release of the
+ * original mbufs until the capture mbufs are freed.
+ * Changes made to the packets after they are captured
+ * (for instance by the application after receive) are then seen
+ * in the capture.
+ * The capture process frees mbufs of the pools of the captured process:
+ * as with any mempool shared between processes, the capture process
+ * must not use the same lcore ids as the captured process.
+ * Packets in external buffers, and packets sent on a Tx queue with
+ * RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE, are still copied.
+ *
+ * @param port_id
+ *  The Ethernet port on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction, packet format and copy.
+ * @param snaplen
+ *  The upper limit on bytes to copy.
+ *  Passing UINT32_MAX means capture all the possible data.
+ * @param ring
+ *  The ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  The mempool on to which original packets will be mirrored or duplicated.
+ * @param prm
+ *  Use BPF program to run to filter packets (can be NULL)
+ * @param sampling
+ *  Sampling applied on each queue (can be NULL to capture all packets).
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_sampled(uint16_t port_id, uint16_t queue,
+			 uint32_t flags, uint32_t snaplen,
+			 struct rte_ring *ring,
+			 struct rte_mempool *mp,
+			 const struct rte_bpf_prm *prm,
+			 const struct rte_pdump_sampling *sampling);
+
 /**
  * Disables packet capturing on given port and queue.
  *
@@ -204,6 +271,45 @@ rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
 				 const struct rte_bpf_prm *filter);
 
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ * Enables sampled packet capturing on given device id and queue
+ * with filtering.
+ * device_id can be name or pci address of device.
+ * See rte_pdump_enable_sampled() for the zero copy mode.
+ *
+ * @param device_id
+ *  device id on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction, packet format and copy.
+ * @param snaplen
+ *  The upper limit on bytes to copy.
+ *  Passing UINT32_MAX means capture all the possible data.
+ * @param ring
+ *  The ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  The mempool on to which original packets will be mirrored or duplicated.
+ * @param prm
+ *  Use BPF program to run to filter packets (can be NULL)
+ * @param sampling
+ *  Sampling applied on each queue (can be NULL to capture all packets).
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_sampled_by_deviceid(const char *device_id, uint16_t queue,
+				     uint32_t flags, uint32_t snaplen,
+				     struct rte_ring *ring,
+				     struct rte_mempool *mp,
+				     const struct rte_bpf_prm *prm,
+				     const struct rte_pdump_sampling *sampling);
+
 /**
  * Disables packet capturing on given device_id and queue.
  * device_id can be name or pci address of device.
@@ -236,8 +342,10 @@ struct rte_pdump_stats {
 	uint64_t filtered; /**< Number of packets rejected by filter. */
 	uint64_t nombuf;   /**< Number of mbuf allocation failures. */
 	uint64_t ringfull; /**< Number of missed packets due to ring full. */
+	uint64_t sampled;  /**< Number of packets skipped by sampling. */
+	uint64_t ratelimited; /**< Number of packets over the rate limit. */
 
-	uint64_t reserved[4]; /**< Reserved and pad to cache line */
+	uint64_t reserved[2]; /**< Reserved and pad to cache line */
 };
 
 /**
@@ -2365,7 +2365,7 @@ instr_learner_af_exec(struct rte_swx_pipeline *p)
 	stats->n_pkts_action[action_id] = n_pkts_action + 1;
 
 	/* Thread. */
-	thread_ip_action_call(p, t, action_id);
+	thread_ip_inc(p);
 
 	/* Action */
 	action_func(p);
@@ -9004,12 +9004,17 @@ metarray_free(struct rte_swx_pipeline *p)
 void
 rte_swx_pipeline_free(struct rte_swx_pipeline *p)
 {
-	void *lib;
+	struct instruction *jit_instructions;
+	size_t jit_size;
+	void *lib, *jit;
 
 	if (!p)
 		return;
 
 	lib = p->lib;
+	jit = p->jit;
+	jit_size = p->jit_size;
+	jit_instructions = p->jit_instructions;
 
 	free(p->instruction_data);
 	free(p->instructions);
@@ -9034,6 +9039,14 @@ rte_swx_pipeline_free(struct rte_swx_pipeline *p)
 
 	if (lib)
 		dlclose(lib);
+
+#if defined(RTE_ARCH_X86_64)
+	swx_jit_x86_free(jit, jit_size);
+#else
+	RTE_SET_USED(jit);
+	RTE_SET_USED(jit_size);
+#endif
+	free(jit_instructions);
 }
 
 static int
@@ -12624,6 +12637,153 @@ pipeline_adjust(struct rte_swx_pipeline *p, struct instruction_group_list *igl)
 	instr_jmp_resolve(p->instructions, p->instruction_data, p->n_instructions);
 }
 
+#if defined(RTE_ARCH_X86_64)
+
+static int
+pipeline_jit(struct rte_swx_pipeline *p, struct instruction_group_list *igl)
+{
+	struct swx_jit_func *funcs = NULL;
+	struct swx_jit_jmp *jmp = NULL;
+	struct instruction *instructions = NULL;
+	struct instruction_group *g;
+	struct action *a;
+	uint32_t n_funcs = 0, n_jmp = 0, i;
+	char *jit_env;
+	int status = 0;
+
+	/* The JIT is disabled by setting the RTE_SWX_PIPELINE_JIT environment variable to 0. */
+	jit_env = getenv("RTE_SWX_PIPELINE_JIT");
+	if (jit_env && !strcmp(jit_env, "0"))
+		return -ENOTSUP;
+
+	/* Memory allocation. The pipeline instructions are compacted after the build, so the
+	 * instruction handlers get a copy of them that stays valid for the pipeline lifetime.
+	 */
+	TAILQ_FOREACH(a, &p->actions, node) {
+		n_funcs++;
+		n_jmp += a->n_instructions;
+	}
+
+	TAILQ_FOREACH(g, igl, node) {
+		n_funcs++;
+		n_jmp += g->last_instr_id - g->first_instr_id + 1;
+	}
+
+	funcs = calloc(n_funcs, sizeof(struct swx_jit_func));
+	jmp = calloc(n_jmp, sizeof(struct swx_jit_jmp));
+	instructions = calloc(p->n_instructions, sizeof(struct instruction));
+	if (!funcs || !jmp || !instructions) {
+		status = -ENOMEM;
+		goto free;
+	}
+
+	memcpy(instructions, p->instructions, p->n_instructions * sizeof(struct instruction));
+
+	/* Action functions: all the jumps are near jumps. */
+	n_funcs = 0;
+	n_jmp = 0;
+	TAILQ_FOREACH(a, &p->actions, node) {
+		struct swx_jit_func *f = &funcs[n_funcs++];
+
+		for (i = 0; i < a->n_instructions; i++) {
+			struct instruction *instr = &a->instructions[i];
+
+			if (instruction_is_jmp(instr))
+				jmp[n_jmp + i].dst = instr->jmp.ip - a->instructions;
+		}
+
+		f->instructions = a->instructions;
+		f->jmp = &jmp[n_jmp];
+		f->n_instructions = a->n_instructions;
+		f->is_action = 1;
+
+		n_jmp += a->n_instructions;
+	}
+
+	/* Pipeline functions: one function for each instruction group that contains more than
+	 * one instruction. The jumps outside of the current group are far jumps to the group of
+	 * the jump destination instruction, which is the instruction with the same ID as the
+	 * group once the pipeline instructions are compacted.
+	 */
+	TAILQ_FOREACH(g, igl, node) {
+		struct swx_jit_func *f;
+
+		if (g->first_instr_id == g->last_instr_id)
+			continue;
+
+		f = &funcs[n_funcs++];
+
+		for (i = g->first_instr_id; i <= g->last_instr_id; i++) {
+			struct instruction *instr = &p->instructions[i];
+			struct swx_jit_jmp *j = &jmp[n_jmp + i - g->first_instr_id];
+			struct instruction_group *jmp_g;
+			uint32_t instr_id;
+
+			if (!instruction_is_jmp(instr))
+				continue;
+
+			instr_id = instr->jmp.ip - p->instructions;
+
+			jmp_g = instruction_group_list_group_find(igl, instr_id);
+			if (!jmp_g) {
+				status = -EINVAL;
+				goto free;
+			}
+
+			if (jmp_g == g) {
+				j->dst = instr_id - g->first_instr_id;
+			} else {
+				j->dst = jmp_g->group_id;
+				j->far = 1;
+			}
+		}
+
+		f->instructions = &instructions[g->first_instr_id];
+		f->jmp = &jmp[n_jmp];
+		f->n_instructions = g->last_instr_id - g->first_instr_id + 1;
+
+		n_jmp += f->n_instructions;
+	}
+
+	/* Generate the native code. */
+	status = swx_jit_x86(funcs, n_funcs, &p->jit, &p->jit_size);
+	if (status)
+		goto free;
+
+	p->jit_instructions = instructions;
+	instructions = NULL;
+
+	/* Get the function addresses. */
+	n_funcs = 0;
+	TAILQ_FOREACH(a, &p->actions, node)
+		p->action_funcs[a->id] = funcs[n_funcs++].func;
+
+	TAILQ_FOREACH(g, igl, node) {
+		if (g->first_instr_id == g->last_instr_id)
+			continue;
+
+		g->func = funcs[n_funcs++].func;
+	}
+
+free:
+	free(instructions);
+	free(jmp);
+	free(funcs);
+
+	return status;
+}
+
+#else
+
+static int
+pipeline_jit(struct rte_swx_pipeline *p __rte_unused,
+	     struct instruction_group_list *igl __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+#endif
+
 static int
 pipeline_compile(struct rte_swx_pipeline *p)
 {
@@ -12638,11 +12798,16 @@ pipeline_compile(struct rte_swx_pipeline *p)
 
 	/* Code generation. */
 	status = pipeline_codegen(p, igl);
-	if (status)
-		goto free;
 
 	/* Build and load the shared object library. */
-	status = pipeline_libload(p, igl);
+	if (!status)
+		status = pipeline_libload(p, igl);
+
+	/* Native code generation, when the shared object library cannot be built, e.g. when no C
+	 * compiler is available or the RTE_INSTALL_DIR environment variable is not set.
+	 */
+	if (status)
+		status = pipeline_jit(p, igl);
 	if (status)
 		goto free;
 
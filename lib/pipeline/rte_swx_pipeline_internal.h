@@ -1412,6 +1412,9 @@ struct rte_swx_pipeline {
 	instr_exec_t *instruction_table;
 	struct thread threads[RTE_SWX_PIPELINE_THREADS_MAX];
 	void *lib;
+	void *jit;
+	size_t jit_size;
+	struct instruction *jit_instructions;
 
 	uint32_t n_structs;
 	uint32_t n_ports_in;
@@ -1432,6 +1435,34 @@ struct rte_swx_pipeline {
 	int numa_node;
 };
 
+/*
+ * JIT.
+ */
+struct swx_jit_jmp {
+	/* Position of the jump destination instruction: within the current function for near
+	 * jumps, within the pipeline instruction array for far jumps.
+	 */
+	uint32_t dst;
+	int far;
+};
+
+struct swx_jit_func {
+	/* Input. The instructions are passed as is to the instruction handlers. */
+	const struct instruction *instructions;
+	const struct swx_jit_jmp *jmp;
+	uint32_t n_instructions;
+	int is_action;
+
+	/* Output. */
+	instr_exec_t func;
+};
+
+int
+swx_jit_x86(struct swx_jit_func *funcs, uint32_t n_funcs, void **code, size_t *code_size);
+
+void
+swx_jit_x86_free(void *code, size_t code_size);
+
 /*
  * Instruction.
  */
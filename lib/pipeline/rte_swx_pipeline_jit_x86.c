@@ -0,0 +1,1045 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <rte_common.h>
+
+#include "rte_swx_pipeline_internal.h"
+
+/*
+ * x86-64 registers.
+ */
+enum {
+	RAX = 0,  /* scratch, return value */
+	RCX = 1,  /* scratch */
+	RDX = 2,  /* scratch, 3rd arg */
+	RBX = 3,  /* callee saved */
+	RSP = 4,  /* stack pointer */
+	RBP = 5,  /* frame pointer, callee saved */
+	RSI = 6,  /* scratch, 2nd arg */
+	RDI = 7,  /* scratch, 1st arg */
+	R12 = 12, /* callee saved */
+};
+
+#define IS_EXT_REG(r)	((r) >= 8)
+
+enum {
+	REX_PREFIX = 0x40, /* fixed value 0100 */
+	REX_W = 0x8,       /* 64bit operand size */
+	REX_R = 0x4,       /* extension of the ModRM.reg field */
+	REX_X = 0x2,       /* extension of the SIB.index field */
+	REX_B = 0x1,       /* extension of the ModRM.rm field */
+};
+
+enum {
+	MOD_INDIRECT = 0,
+	MOD_IDISP8 = 1,
+	MOD_IDISP32 = 2,
+	MOD_DIRECT = 3,
+};
+
+/*
+ * The pipeline and the current thread are kept in callee saved registers for the whole
+ * function, so they survive the calls to the instruction handlers.
+ */
+enum {
+	REG_P = RBX,  /* struct rte_swx_pipeline *p */
+	REG_T = R12,  /* struct thread *t */
+	REG_A = RAX,  /* first jump operand, mov source */
+	REG_B = RCX,  /* second jump operand, mov destination structure */
+	REG_C = RDX,  /* mov destination */
+};
+
+/* Second byte of the Jcc rel32 opcode. The inverse condition only differs in bit 0. */
+enum {
+	JCC_B = 0x82,
+	JCC_AE = 0x83,
+	JCC_E = 0x84,
+	JCC_NE = 0x85,
+	JCC_A = 0x87,
+};
+
+/* ModRM.reg opcode extensions. */
+enum {
+	EXT_ADD = 0,
+	EXT_CALL = 2,
+	EXT_BT = 4,
+	EXT_SHL = 4,
+	EXT_SHR = 5,
+	EXT_BTS = 5,
+	EXT_BTR = 6,
+	EXT_CMP = 7,
+};
+
+struct jit_state {
+	size_t sz;
+	int32_t *off;
+	uint8_t *ins;
+};
+
+/*
+ * Instruction handlers called from the generated code. The handler signature is common to
+ * all the instructions that do not yield the thread, so the address of the handler is all
+ * that the generated code needs.
+ */
+typedef void
+(*jit_handler_t)(struct rte_swx_pipeline *p, struct thread *t, const struct instruction *ip);
+
+static const jit_handler_t jit_handlers[] = {
+	[INSTR_TX] = __instr_tx_exec,
+	[INSTR_TX_I] = __instr_tx_i_exec,
+	[INSTR_DROP] = __instr_drop_exec,
+
+	[INSTR_HDR_EXTRACT] = __instr_hdr_extract_exec,
+	[INSTR_HDR_EXTRACT2] = __instr_hdr_extract2_exec,
+	[INSTR_HDR_EXTRACT3] = __instr_hdr_extract3_exec,
+	[INSTR_HDR_EXTRACT4] = __instr_hdr_extract4_exec,
+	[INSTR_HDR_EXTRACT5] = __instr_hdr_extract5_exec,
+	[INSTR_HDR_EXTRACT6] = __instr_hdr_extract6_exec,
+	[INSTR_HDR_EXTRACT7] = __instr_hdr_extract7_exec,
+	[INSTR_HDR_EXTRACT8] = __instr_hdr_extract8_exec,
+
+	[INSTR_HDR_EXTRACT_M] = __instr_hdr_extract_m_exec,
+
+	[INSTR_HDR_LOOKAHEAD] = __instr_hdr_lookahead_exec,
+
+	[INSTR_HDR_EMIT] = __instr_hdr_emit_exec,
+	[INSTR_HDR_EMIT_TX] = __instr_hdr_emit_tx_exec,
+	[INSTR_HDR_EMIT2_TX] = __instr_hdr_emit2_tx_exec,
+	[INSTR_HDR_EMIT3_TX] = __instr_hdr_emit3_tx_exec,
+	[INSTR_HDR_EMIT4_TX] = __instr_hdr_emit4_tx_exec,
+	[INSTR_HDR_EMIT5_TX] = __instr_hdr_emit5_tx_exec,
+	[INSTR_HDR_EMIT6_TX] = __instr_hdr_emit6_tx_exec,
+	[INSTR_HDR_EMIT7_TX] = __instr_hdr_emit7_tx_exec,
+	[INSTR_HDR_EMIT8_TX] = __instr_hdr_emit8_tx_exec,
+
+	[INSTR_HDR_VALIDATE] = __instr_hdr_validate_exec,
+	[INSTR_HDR_INVALIDATE] = __instr_hdr_invalidate_exec,
+
+	[INSTR_MOV] = __instr_mov_exec,
+	[INSTR_MOV_MH] = __instr_mov_mh_exec,
+	[INSTR_MOV_HM] = __instr_mov_hm_exec,
+	[INSTR_MOV_HH] = __instr_mov_hh_exec,
+	[INSTR_MOV_I] = __instr_mov_i_exec,
+
+	[INSTR_DMA_HT] = __instr_dma_ht_exec,
+	[INSTR_DMA_HT2] = __instr_dma_ht2_exec,
+	[INSTR_DMA_HT3] = __instr_dma_ht3_exec,
+	[INSTR_DMA_HT4] = __instr_dma_ht4_exec,
+	[INSTR_DMA_HT5] = __instr_dma_ht5_exec,
+	[INSTR_DMA_HT6] = __instr_dma_ht6_exec,
+	[INSTR_DMA_HT7] = __instr_dma_ht7_exec,
+	[INSTR_DMA_HT8] = __instr_dma_ht8_exec,
+
+	[INSTR_ALU_ADD] = __instr_alu_add_exec,
+	[INSTR_ALU_ADD_MH] = __instr_alu_add_mh_exec,
+	[INSTR_ALU_ADD_HM] = __instr_alu_add_hm_exec,
+	[INSTR_ALU_ADD_HH] = __instr_alu_add_hh_exec,
+	[INSTR_ALU_ADD_MI] = __instr_alu_add_mi_exec,
+	[INSTR_ALU_ADD_HI] = __instr_alu_add_hi_exec,
+
+	[INSTR_ALU_SUB] = __instr_alu_sub_exec,
+	[INSTR_ALU_SUB_MH] = __instr_alu_sub_mh_exec,
+	[INSTR_ALU_SUB_HM] = __instr_alu_sub_hm_exec,
+	[INSTR_ALU_SUB_HH] = __instr_alu_sub_hh_exec,
+	[INSTR_ALU_SUB_MI] = __instr_alu_sub_mi_exec,
+	[INSTR_ALU_SUB_HI] = __instr_alu_sub_hi_exec,
+
+	[INSTR_ALU_CKADD_FIELD] = __instr_alu_ckadd_field_exec,
+	[INSTR_ALU_CKADD_STRUCT20] = __instr_alu_ckadd_struct20_exec,
+	[INSTR_ALU_CKADD_STRUCT] = __instr_alu_ckadd_struct_exec,
+	[INSTR_ALU_CKSUB_FIELD] = __instr_alu_cksub_field_exec,
+
+	[INSTR_ALU_AND] = __instr_alu_and_exec,
+	[INSTR_ALU_AND_MH] = __instr_alu_and_mh_exec,
+	[INSTR_ALU_AND_HM] = __instr_alu_and_hm_exec,
+	[INSTR_ALU_AND_HH] = __instr_alu_and_hh_exec,
+	[INSTR_ALU_AND_I] = __instr_alu_and_i_exec,
+
+	[INSTR_ALU_OR] = __instr_alu_or_exec,
+	[INSTR_ALU_OR_MH] = __instr_alu_or_mh_exec,
+	[INSTR_ALU_OR_HM] = __instr_alu_or_hm_exec,
+	[INSTR_ALU_OR_HH] = __instr_alu_or_hh_exec,
+	[INSTR_ALU_OR_I] = __instr_alu_or_i_exec,
+
+	[INSTR_ALU_XOR] = __instr_alu_xor_exec,
+	[INSTR_ALU_XOR_MH] = __instr_alu_xor_mh_exec,
+	[INSTR_ALU_XOR_HM] = __instr_alu_xor_hm_exec,
+	[INSTR_ALU_XOR_HH] = __instr_alu_xor_hh_exec,
+	[INSTR_ALU_XOR_I] = __instr_alu_xor_i_exec,
+
+	[INSTR_ALU_SHL] = __instr_alu_shl_exec,
+	[INSTR_ALU_SHL_MH] = __instr_alu_shl_mh_exec,
+	[INSTR_ALU_SHL_HM] = __instr_alu_shl_hm_exec,
+	[INSTR_ALU_SHL_HH] = __instr_alu_shl_hh_exec,
+	[INSTR_ALU_SHL_MI] = __instr_alu_shl_mi_exec,
+	[INSTR_ALU_SHL_HI] = __instr_alu_shl_hi_exec,
+
+	[INSTR_ALU_SHR] = __instr_alu_shr_exec,
+	[INSTR_ALU_SHR_MH] = __instr_alu_shr_mh_exec,
+	[INSTR_ALU_SHR_HM] = __instr_alu_shr_hm_exec,
+	[INSTR_ALU_SHR_HH] = __instr_alu_shr_hh_exec,
+	[INSTR_ALU_SHR_MI] = __instr_alu_shr_mi_exec,
+	[INSTR_ALU_SHR_HI] = __instr_alu_shr_hi_exec,
+
+	[INSTR_REGPREFETCH_RH] = __instr_regprefetch_rh_exec,
+	[INSTR_REGPREFETCH_RM] = __instr_regprefetch_rm_exec,
+	[INSTR_REGPREFETCH_RI] = __instr_regprefetch_ri_exec,
+
+	[INSTR_REGRD_HRH] = __instr_regrd_hrh_exec,
+	[INSTR_REGRD_HRM] = __instr_regrd_hrm_exec,
+	[INSTR_REGRD_HRI] = __instr_regrd_hri_exec,
+	[INSTR_REGRD_MRH] = __instr_regrd_mrh_exec,
+	[INSTR_REGRD_MRM] = __instr_regrd_mrm_exec,
+	[INSTR_REGRD_MRI] = __instr_regrd_mri_exec,
+
+	[INSTR_REGWR_RHH] = __instr_regwr_rhh_exec,
+	[INSTR_REGWR_RHM] = __instr_regwr_rhm_exec,
+	[INSTR_REGWR_RHI] = __instr_regwr_rhi_exec,
+	[INSTR_REGWR_RMH] = __instr_regwr_rmh_exec,
+	[INSTR_REGWR_RMM] = __instr_regwr_rmm_exec,
+	[INSTR_REGWR_RMI] = __instr_regwr_rmi_exec,
+	[INSTR_REGWR_RIH] = __instr_regwr_rih_exec,
+	[INSTR_REGWR_RIM] = __instr_regwr_rim_exec,
+	[INSTR_REGWR_RII] = __instr_regwr_rii_exec,
+
+	[INSTR_REGADD_RHH] = __instr_regadd_rhh_exec,
+	[INSTR_REGADD_RHM] = __instr_regadd_rhm_exec,
+	[INSTR_REGADD_RHI] = __instr_regadd_rhi_exec,
+	[INSTR_REGADD_RMH] = __instr_regadd_rmh_exec,
+	[INSTR_REGADD_RMM] = __instr_regadd_rmm_exec,
+	[INSTR_REGADD_RMI] = __instr_regadd_rmi_exec,
+	[INSTR_REGADD_RIH] = __instr_regadd_rih_exec,
+	[INSTR_REGADD_RIM] = __instr_regadd_rim_exec,
+	[INSTR_REGADD_RII] = __instr_regadd_rii_exec,
+
+	[INSTR_METPREFETCH_H] = __instr_metprefetch_h_exec,
+	[INSTR_METPREFETCH_M] = __instr_metprefetch_m_exec,
+	[INSTR_METPREFETCH_I] = __instr_metprefetch_i_exec,
+
+	[INSTR_METER_HHM] = __instr_meter_hhm_exec,
+	[INSTR_METER_HHI] = __instr_meter_hhi_exec,
+	[INSTR_METER_HMM] = __instr_meter_hmm_exec,
+	[INSTR_METER_HMI] = __instr_meter_hmi_exec,
+	[INSTR_METER_MHM] = __instr_meter_mhm_exec,
+	[INSTR_METER_MHI] = __instr_meter_mhi_exec,
+	[INSTR_METER_MMM] = __instr_meter_mmm_exec,
+	[INSTR_METER_MMI] = __instr_meter_mmi_exec,
+	[INSTR_METER_IHM] = __instr_meter_ihm_exec,
+	[INSTR_METER_IHI] = __instr_meter_ihi_exec,
+	[INSTR_METER_IMM] = __instr_meter_imm_exec,
+	[INSTR_METER_IMI] = __instr_meter_imi_exec,
+
+	[INSTR_LEARNER_LEARN] = __instr_learn_exec,
+	[INSTR_LEARNER_FORGET] = __instr_forget_exec,
+};
+
+/*
+ * Jump instructions that compare two operands: the jump condition, the byte order of each
+ * operand and whether the second operand is an immediate value.
+ */
+struct jit_jmp_cmp {
+	uint8_t cc;
+	uint8_t a_nbo;
+	uint8_t b_nbo;
+	uint8_t b_imm;
+};
+
+static const struct jit_jmp_cmp jit_jmp_cmps[] = {
+	[INSTR_JMP_EQ] = {JCC_E, 0, 0, 0},
+	[INSTR_JMP_EQ_MH] = {JCC_E, 0, 1, 0},
+	[INSTR_JMP_EQ_HM] = {JCC_E, 1, 0, 0},
+	[INSTR_JMP_EQ_HH] = {JCC_E, 1, 1, 0},
+	[INSTR_JMP_EQ_I] = {JCC_E, 0, 0, 1},
+
+	[INSTR_JMP_NEQ] = {JCC_NE, 0, 0, 0},
+	[INSTR_JMP_NEQ_MH] = {JCC_NE, 0, 1, 0},
+	[INSTR_JMP_NEQ_HM] = {JCC_NE, 1, 0, 0},
+	[INSTR_JMP_NEQ_HH] = {JCC_NE, 1, 1, 0},
+	[INSTR_JMP_NEQ_I] = {JCC_NE, 0, 0, 1},
+
+	[INSTR_JMP_LT] = {JCC_B, 0, 0, 0},
+	[INSTR_JMP_LT_MH] = {JCC_B, 0, 1, 0},
+	[INSTR_JMP_LT_HM] = {JCC_B, 1, 0, 0},
+	[INSTR_JMP_LT_HH] = {JCC_B, 1, 1, 0},
+	[INSTR_JMP_LT_MI] = {JCC_B, 0, 0, 1},
+	[INSTR_JMP_LT_HI] = {JCC_B, 1, 0, 1},
+
+	[INSTR_JMP_GT] = {JCC_A, 0, 0, 0},
+	[INSTR_JMP_GT_MH] = {JCC_A, 0, 1, 0},
+	[INSTR_JMP_GT_HM] = {JCC_A, 1, 0, 0},
+	[INSTR_JMP_GT_HH] = {JCC_A, 1, 1, 0},
+	[INSTR_JMP_GT_MI] = {JCC_A, 0, 0, 1},
+	[INSTR_JMP_GT_HI] = {JCC_A, 1, 0, 1},
+};
+
+static void
+emit_bytes(struct jit_state *st, const uint8_t ins[], uint32_t sz)
+{
+	uint32_t i;
+
+	if (st->ins != NULL) {
+		for (i = 0; i != sz; i++)
+			st->ins[st->sz + i] = ins[i];
+	}
+	st->sz += sz;
+}
+
+static void
+emit_byte(struct jit_state *st, uint8_t v)
+{
+	emit_bytes(st, &v, sizeof(v));
+}
+
+/*
+ * emit little endian immediate of 1, 4 or 8 bytes
+ */
+static void
+emit_imm(struct jit_state *st, uint64_t imm, uint32_t sz)
+{
+	uint32_t i;
+
+	for (i = 0; i != sz; i++)
+		emit_byte(st, (uint8_t)(imm >> (8 * i)));
+}
+
+/*
+ * emit REX byte
+ */
+static void
+emit_rex(struct jit_state *st, uint32_t w, uint32_t reg, uint32_t rm)
+{
+	uint8_t rex = 0;
+
+	if (w)
+		rex |= REX_W;
+
+	if (IS_EXT_REG(reg))
+		rex |= REX_R;
+
+	if (IS_EXT_REG(rm))
+		rex |= REX_B;
+
+	if (rex != 0)
+		emit_byte(st, REX_PREFIX | rex);
+}
+
+/*
+ * emit MODRegRM byte
+ */
+static void
+emit_modregrm(struct jit_state *st, uint32_t mod, uint32_t reg, uint32_t rm)
+{
+	emit_byte(st, mod << 6 | (reg & 7) << 3 | (rm & 7));
+}
+
+/*
+ * emit MODRegRM byte, SIB byte and displacement for <disp>(%<base>)
+ */
+static void
+emit_mem(struct jit_state *st, uint32_t reg, uint32_t base, int32_t disp)
+{
+	uint32_t mod = (disp == (int8_t)disp) ? MOD_IDISP8 : MOD_IDISP32;
+
+	emit_modregrm(st, mod, reg, base);
+
+	/* RSP and R12 as base register always require the SIB byte. */
+	if ((base & 7) == RSP)
+		emit_modregrm(st, 0, RSP, RSP);
+
+	emit_imm(st, (uint32_t)disp, mod == MOD_IDISP8 ? 1 : 4);
+}
+
+/*
+ * emit mov <disp>(%<base>), %<dreg>
+ */
+static void
+emit_ld(struct jit_state *st, uint32_t w, uint32_t dreg, uint32_t base, int32_t disp)
+{
+	emit_rex(st, w, dreg, base);
+	emit_byte(st, 0x8B);
+	emit_mem(st, dreg, base, disp);
+}
+
+/*
+ * emit mov %<sreg>, <disp>(%<base>)
+ */
+static void
+emit_st(struct jit_state *st, uint32_t sreg, uint32_t base, int32_t disp)
+{
+	emit_rex(st, 1, sreg, base);
+	emit_byte(st, 0x89);
+	emit_mem(st, sreg, base, disp);
+}
+
+/*
+ * emit mov %<sreg>, %<dreg>
+ */
+static void
+emit_mov_reg(struct jit_state *st, uint32_t sreg, uint32_t dreg)
+{
+	emit_rex(st, 1, sreg, dreg);
+	emit_byte(st, 0x89);
+	emit_modregrm(st, MOD_DIRECT, sreg, dreg);
+}
+
+/*
+ * emit movabs $<imm>, %<dreg>
+ */
+static void
+emit_mov_imm64(struct jit_state *st, uint32_t dreg, uint64_t imm)
+{
+	emit_rex(st, 1, 0, dreg);
+	emit_byte(st, 0xB8 | (dreg & 7));
+	emit_imm(st, imm, sizeof(uint64_t));
+}
+
+/*
+ * emit add %<sreg>, %<dreg>
+ */
+static void
+emit_add_reg(struct jit_state *st, uint32_t sreg, uint32_t dreg)
+{
+	emit_rex(st, 1, sreg, dreg);
+	emit_byte(st, 0x01);
+	emit_modregrm(st, MOD_DIRECT, sreg, dreg);
+}
+
+/*
+ * emit add $<imm>, %<dreg>
+ */
+static void
+emit_add_imm(struct jit_state *st, uint32_t dreg, uint32_t imm)
+{
+	emit_rex(st, 1, 0, dreg);
+	emit_byte(st, 0x81);
+	emit_modregrm(st, MOD_DIRECT, EXT_ADD, dreg);
+	emit_imm(st, imm, sizeof(uint32_t));
+}
+
+/*
+ * emit imul $<imm>, %<dreg>, %<dreg>
+ */
+static void
+emit_mul_imm(struct jit_state *st, uint32_t dreg, uint32_t imm)
+{
+	emit_rex(st, 1, dreg, dreg);
+	emit_byte(st, 0x69);
+	emit_modregrm(st, MOD_DIRECT, dreg, dreg);
+	emit_imm(st, imm, sizeof(uint32_t));
+}
+
+/*
+ * emit shl/shr $<imm>, %<dreg>
+ */
+static void
+emit_shift_imm(struct jit_state *st, uint32_t ext, uint32_t dreg, uint8_t imm)
+{
+	emit_rex(st, 1, 0, dreg);
+	emit_byte(st, 0xC1);
+	emit_modregrm(st, MOD_DIRECT, ext, dreg);
+	emit_byte(st, imm);
+}
+
+/*
+ * emit bswap %<dreg>
+ */
+static void
+emit_bswap(struct jit_state *st, uint32_t dreg)
+{
+	emit_rex(st, 1, 0, dreg);
+	emit_byte(st, 0x0F);
+	emit_byte(st, 0xC8 | (dreg & 7));
+}
+
+/*
+ * emit bt $<imm>, %<dreg>
+ */
+static void
+emit_bt_imm(struct jit_state *st, uint32_t dreg, uint8_t imm)
+{
+	emit_rex(st, 1, 0, dreg);
+	emit_byte(st, 0x0F);
+	emit_byte(st, 0xBA);
+	emit_modregrm(st, MOD_DIRECT, EXT_BT, dreg);
+	emit_byte(st, imm);
+}
+
+/*
+ * emit bts/btr $<imm>, <disp>(%<base>)
+ */
+static void
+emit_bt_mem_imm(struct jit_state *st, uint32_t ext, uint32_t base, int32_t disp, uint8_t imm)
+{
+	emit_rex(st, 1, 0, base);
+	emit_byte(st, 0x0F);
+	emit_byte(st, 0xBA);
+	emit_mem(st, ext, base, disp);
+	emit_byte(st, imm);
+}
+
+/*
+ * emit or %<sreg>, %<dreg>
+ */
+static void
+emit_or_reg(struct jit_state *st, uint32_t sreg, uint32_t dreg)
+{
+	emit_rex(st, 1, sreg, dreg);
+	emit_byte(st, 0x09);
+	emit_modregrm(st, MOD_DIRECT, sreg, dreg);
+}
+
+/*
+ * emit cmp %<sreg>, %<dreg>
+ */
+static void
+emit_cmp_reg(struct jit_state *st, uint32_t sreg, uint32_t dreg)
+{
+	emit_rex(st, 1, sreg, dreg);
+	emit_byte(st, 0x39);
+	emit_modregrm(st, MOD_DIRECT, sreg, dreg);
+}
+
+/*
+ * emit cmp/add $<imm>, <disp>(%<base>)
+ */
+static void
+emit_alu_mem_imm(struct jit_state *st, uint32_t w, uint32_t ext, uint32_t base, int32_t disp,
+		 uint32_t imm)
+{
+	emit_rex(st, w, 0, base);
+	emit_byte(st, 0x81);
+	emit_mem(st, ext, base, disp);
+	emit_imm(st, imm, sizeof(uint32_t));
+}
+
+/*
+ * emit test %<reg>, %<reg> (32 bit)
+ */
+static void
+emit_test32(struct jit_state *st, uint32_t reg)
+{
+	emit_rex(st, 0, reg, reg);
+	emit_byte(st, 0x85);
+	emit_modregrm(st, MOD_DIRECT, reg, reg);
+}
+
+static void
+emit_push(struct jit_state *st, uint32_t reg)
+{
+	emit_rex(st, 0, 0, reg);
+	emit_byte(st, 0x50 | (reg & 7));
+}
+
+static void
+emit_pop(struct jit_state *st, uint32_t reg)
+{
+	emit_rex(st, 0, 0, reg);
+	emit_byte(st, 0x58 | (reg & 7));
+}
+
+/*
+ * emit rel32 displacement to the code offset <target>
+ */
+static void
+emit_rel32(struct jit_state *st, int32_t target)
+{
+	int32_t rel = 0;
+
+	/* Code offsets are only final for the code generation run. */
+	if (st->ins != NULL)
+		rel = target - (int32_t)(st->sz + sizeof(int32_t));
+
+	emit_imm(st, (uint32_t)rel, sizeof(int32_t));
+}
+
+/*
+ * emit jmp <target> or j<cc> <target> (<cc> == 0 means unconditional)
+ */
+static void
+emit_jmp(struct jit_state *st, uint8_t cc, int32_t target)
+{
+	if (cc) {
+		emit_byte(st, 0x0F);
+		emit_byte(st, cc);
+	} else
+		emit_byte(st, 0xE9);
+
+	emit_rel32(st, target);
+}
+
+/*
+ * Function prolog: save the callee saved registers and set up the pipeline and thread
+ * registers, i.e. t = &p->threads[p->thread_id].
+ */
+static void
+emit_prolog(struct jit_state *st)
+{
+	emit_push(st, REG_P);
+	emit_push(st, REG_T);
+	emit_push(st, RAX); /* Keep the stack 16 byte aligned for the handler calls. */
+
+	emit_mov_reg(st, RDI, REG_P);
+	emit_ld(st, 0, REG_T, REG_P, offsetof(struct rte_swx_pipeline, thread_id));
+	emit_mul_imm(st, REG_T, sizeof(struct thread));
+	emit_add_imm(st, REG_T, offsetof(struct rte_swx_pipeline, threads));
+	emit_add_reg(st, REG_P, REG_T);
+}
+
+static void
+emit_epilog(struct jit_state *st)
+{
+	emit_pop(st, RCX);
+	emit_pop(st, REG_T);
+	emit_pop(st, REG_P);
+	emit_byte(st, 0xC3);
+}
+
+/*
+ * emit handler(p, t, ip)
+ */
+static void
+emit_call(struct jit_state *st, uintptr_t handler, const struct instruction *ip)
+{
+	emit_mov_reg(st, REG_P, RDI);
+	emit_mov_reg(st, REG_T, RSI);
+	emit_mov_imm64(st, RDX, (uintptr_t)ip);
+	emit_mov_imm64(st, RAX, handler);
+	emit_rex(st, 0, 0, RAX);
+	emit_byte(st, 0xFF);
+	emit_modregrm(st, MOD_DIRECT, EXT_CALL, RAX);
+}
+
+/*
+ * Packet transmitted or dropped: thread_ip_reset(p, t), instr_rx_exec(p) and return.
+ */
+static void
+emit_tx_done(struct jit_state *st)
+{
+	emit_ld(st, 1, RAX, REG_P, offsetof(struct rte_swx_pipeline, instructions));
+	emit_st(st, RAX, REG_T, offsetof(struct thread, ip));
+
+	emit_mov_reg(st, REG_P, RDI);
+	emit_mov_imm64(st, RAX, (uintptr_t)instr_rx_exec);
+	emit_rex(st, 0, 0, RAX);
+	emit_byte(st, 0xFF);
+	emit_modregrm(st, MOD_DIRECT, EXT_CALL, RAX);
+
+	emit_epilog(st);
+}
+
+/*
+ * Extern object or function: call the handler until it reports completion.
+ */
+static void
+emit_extern(struct jit_state *st, uintptr_t handler, const struct instruction *ip)
+{
+	int32_t loop = st->sz;
+
+	emit_call(st, handler, ip);
+	emit_test32(st, RAX);
+	emit_jmp(st, JCC_E, loop);
+}
+
+/*
+ * Load the address of the structure of the instruction operand into <dreg>.
+ */
+static void
+emit_operand_struct(struct jit_state *st, uint32_t dreg, const struct instr_operand *x)
+{
+	emit_ld(st, 1, dreg, REG_T, offsetof(struct thread, structs));
+	emit_ld(st, 1, dreg, dreg, x->struct_id * sizeof(uint8_t *));
+}
+
+/*
+ * Keep the <n_bits> least significant bits of <dreg>.
+ */
+static void
+emit_mask(struct jit_state *st, uint32_t dreg, uint32_t n_bits)
+{
+	if (n_bits < 64) {
+		emit_shift_imm(st, EXT_SHL, dreg, 64 - n_bits);
+		emit_shift_imm(st, EXT_SHR, dreg, 64 - n_bits);
+	}
+}
+
+/*
+ * Load the instruction operand into <dreg> in host byte order.
+ */
+static void
+emit_operand_ld(struct jit_state *st, uint32_t dreg, const struct instr_operand *x, int nbo)
+{
+	emit_operand_struct(st, dreg, x);
+	emit_ld(st, 1, dreg, dreg, x->offset);
+
+	if (nbo) {
+		emit_bswap(st, dreg);
+		if (x->n_bits < 64)
+			emit_shift_imm(st, EXT_SHR, dreg, 64 - x->n_bits);
+		return;
+	}
+
+	emit_mask(st, dreg, x->n_bits);
+}
+
+/*
+ * mov: the source value is aligned and masked to the destination field in REG_A, then
+ * merged into the destination field.
+ */
+static void
+emit_mov_instr(struct jit_state *st, const struct instruction *ip)
+{
+	const struct instr_operand *dst = &ip->mov.dst;
+	const struct instr_operand *src = &ip->mov.src;
+
+	switch (ip->type) {
+	case INSTR_MOV:
+		emit_operand_ld(st, REG_A, src, 0);
+		emit_mask(st, REG_A, dst->n_bits);
+		break;
+
+	case INSTR_MOV_MH:
+		emit_operand_ld(st, REG_A, src, 1);
+		emit_mask(st, REG_A, dst->n_bits);
+		break;
+
+	case INSTR_MOV_HM:
+		emit_operand_ld(st, REG_A, src, 0);
+		emit_bswap(st, REG_A);
+		if (dst->n_bits < 64)
+			emit_shift_imm(st, EXT_SHR, REG_A, 64 - dst->n_bits);
+		break;
+
+	case INSTR_MOV_HH:
+		emit_operand_struct(st, REG_A, src);
+		emit_ld(st, 1, REG_A, REG_A, src->offset);
+		if (src->n_bits < 64)
+			emit_shift_imm(st, EXT_SHL, REG_A, 64 - src->n_bits);
+		if (dst->n_bits < 64)
+			emit_shift_imm(st, EXT_SHR, REG_A, 64 - dst->n_bits);
+		break;
+
+	default: /* INSTR_MOV_I */
+		emit_mov_imm64(st, REG_A, ip->mov.src_val & (UINT64_MAX >> (64 - dst->n_bits)));
+		break;
+	}
+
+	emit_operand_struct(st, REG_B, dst);
+
+	if (dst->n_bits < 64) {
+		emit_ld(st, 1, REG_C, REG_B, dst->offset);
+		emit_shift_imm(st, EXT_SHR, REG_C, dst->n_bits);
+		emit_shift_imm(st, EXT_SHL, REG_C, dst->n_bits);
+		emit_or_reg(st, REG_C, REG_A);
+	}
+
+	emit_st(st, REG_A, REG_B, dst->offset);
+}
+
+/*
+ * Jump to the destination of the <pos> instruction when <cc> holds (<cc> == 0 means
+ * unconditional jump). Near jumps branch within the generated function, far jumps set the
+ * thread instruction pointer and return.
+ */
+static void
+emit_jmp_dst(struct jit_state *st, const struct swx_jit_func *f, const int32_t *off,
+	     uint32_t pos, uint8_t cc)
+{
+	const struct swx_jit_jmp *jmp = &f->jmp[pos];
+	size_t skip = 0;
+
+	if (!jmp->far) {
+		emit_jmp(st, cc, off[jmp->dst]);
+		return;
+	}
+
+	if (cc) {
+		emit_byte(st, 0x0F);
+		emit_byte(st, cc ^ 1);
+		skip = st->sz;
+		emit_imm(st, 0, sizeof(int32_t));
+	}
+
+	emit_ld(st, 1, RAX, REG_P, offsetof(struct rte_swx_pipeline, instructions));
+	emit_add_imm(st, RAX, jmp->dst * sizeof(struct instruction));
+	emit_st(st, RAX, REG_T, offsetof(struct thread, ip));
+	emit_epilog(st);
+
+	if (cc && st->ins != NULL) {
+		int32_t rel = st->sz - (skip + sizeof(int32_t));
+
+		memcpy(&st->ins[skip], &rel, sizeof(rel));
+	}
+}
+
+static int
+emit_jmp_instr(struct jit_state *st, const struct swx_jit_func *f, const int32_t *off,
+	       uint32_t pos)
+{
+	const struct instruction *ip = &f->instructions[pos];
+	const struct jit_jmp_cmp *cmp;
+
+	switch (ip->type) {
+	case INSTR_JMP:
+		emit_jmp_dst(st, f, off, pos, 0);
+		return 0;
+
+	case INSTR_JMP_VALID:
+	case INSTR_JMP_INVALID:
+		emit_ld(st, 1, REG_A, REG_T, offsetof(struct thread, valid_headers));
+		emit_bt_imm(st, REG_A, ip->jmp.header_id);
+		emit_jmp_dst(st, f, off, pos,
+			     (ip->type == INSTR_JMP_VALID) ? JCC_B : JCC_AE);
+		return 0;
+
+	case INSTR_JMP_HIT:
+	case INSTR_JMP_MISS:
+		emit_alu_mem_imm(st, 0, EXT_CMP, REG_T, offsetof(struct thread, hit), 0);
+		emit_jmp_dst(st, f, off, pos,
+			     (ip->type == INSTR_JMP_HIT) ? JCC_NE : JCC_E);
+		return 0;
+
+	case INSTR_JMP_ACTION_HIT:
+	case INSTR_JMP_ACTION_MISS:
+		emit_alu_mem_imm(st, 1, EXT_CMP, REG_T, offsetof(struct thread, action_id),
+				 ip->jmp.action_id);
+		emit_jmp_dst(st, f, off, pos,
+			     (ip->type == INSTR_JMP_ACTION_HIT) ? JCC_E : JCC_NE);
+		return 0;
+
+	default:
+		break;
+	}
+
+	if (ip->type >= RTE_DIM(jit_jmp_cmps) || !jit_jmp_cmps[ip->type].cc)
+		return -ENOTSUP;
+
+	cmp = &jit_jmp_cmps[ip->type];
+
+	emit_operand_ld(st, REG_A, &ip->jmp.a, cmp->a_nbo);
+	if (cmp->b_imm)
+		emit_mov_imm64(st, REG_B, ip->jmp.b_val);
+	else
+		emit_operand_ld(st, REG_B, &ip->jmp.b, cmp->b_nbo);
+	emit_cmp_reg(st, REG_B, REG_A);
+	emit_jmp_dst(st, f, off, pos, cmp->cc);
+
+	return 0;
+}
+
+static int
+instr_does_tx(const struct instruction *ip)
+{
+	switch (ip->type) {
+	case INSTR_TX:
+	case INSTR_TX_I:
+	case INSTR_DROP:
+	case INSTR_HDR_EMIT_TX:
+	case INSTR_HDR_EMIT2_TX:
+	case INSTR_HDR_EMIT3_TX:
+	case INSTR_HDR_EMIT4_TX:
+	case INSTR_HDR_EMIT5_TX:
+	case INSTR_HDR_EMIT6_TX:
+	case INSTR_HDR_EMIT7_TX:
+	case INSTR_HDR_EMIT8_TX:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static int
+instr_is_jmp(const struct instruction *ip)
+{
+	if (ip->type == INSTR_JMP ||
+	    ip->type == INSTR_JMP_VALID ||
+	    ip->type == INSTR_JMP_INVALID ||
+	    ip->type == INSTR_JMP_HIT ||
+	    ip->type == INSTR_JMP_MISS ||
+	    ip->type == INSTR_JMP_ACTION_HIT ||
+	    ip->type == INSTR_JMP_ACTION_MISS)
+		return 1;
+
+	return (ip->type < RTE_DIM(jit_jmp_cmps)) && jit_jmp_cmps[ip->type].cc;
+}
+
+/*
+ * Generate the code of a single function, mirroring the C code generated for the same
+ * function by the pipeline code generator.
+ */
+static int
+emit_func(struct jit_state *st, struct swx_jit_func *f, int32_t *off)
+{
+	const struct instruction *last;
+	uint32_t i;
+	int rc;
+
+	/* Align the function start. */
+	while (st->sz & (RTE_CACHE_LINE_MIN_SIZE / 4 - 1))
+		emit_byte(st, 0xCC);
+
+	if (st->ins != NULL)
+		f->func = (instr_exec_t)(uintptr_t)&st->ins[st->sz];
+
+	emit_prolog(st);
+
+	for (i = 0; i != f->n_instructions; i++) {
+		const struct instruction *ip = &f->instructions[i];
+
+		off[i] = st->sz;
+
+		if (instr_does_tx(ip)) {
+			emit_call(st, (uintptr_t)jit_handlers[ip->type], ip);
+			emit_tx_done(st);
+			continue;
+		}
+
+		if (instr_is_jmp(ip)) {
+			rc = emit_jmp_instr(st, f, off, i);
+			if (rc)
+				return rc;
+			continue;
+		}
+
+		switch (ip->type) {
+		case INSTR_EXTERN_OBJ:
+			emit_extern(st, (uintptr_t)__instr_extern_obj_exec, ip);
+			break;
+
+		case INSTR_EXTERN_FUNC:
+			emit_extern(st, (uintptr_t)__instr_extern_func_exec, ip);
+			break;
+
+		case INSTR_RETURN:
+			emit_epilog(st);
+			break;
+
+		case INSTR_MOV:
+		case INSTR_MOV_MH:
+		case INSTR_MOV_HM:
+		case INSTR_MOV_HH:
+		case INSTR_MOV_I:
+			emit_mov_instr(st, ip);
+			break;
+
+		case INSTR_HDR_VALIDATE:
+		case INSTR_HDR_INVALIDATE:
+			emit_bt_mem_imm(st,
+					(ip->type == INSTR_HDR_VALIDATE) ? EXT_BTS : EXT_BTR,
+					REG_T,
+					offsetof(struct thread, valid_headers),
+					ip->valid.header_id);
+			break;
+
+		default:
+			if (ip->type >= RTE_DIM(jit_handlers) || !jit_handlers[ip->type])
+				return -ENOTSUP;
+
+			emit_call(st, (uintptr_t)jit_handlers[ip->type], ip);
+			break;
+		}
+	}
+
+	/* Pipeline functions advance the thread to the next instruction, unless the last
+	 * instruction already decided the next instruction unconditionally.
+	 */
+	last = &f->instructions[f->n_instructions - 1];
+	if (!f->is_action && !instr_does_tx(last) && last->type != INSTR_JMP)
+		emit_alu_mem_imm(st, 1, EXT_ADD, REG_T, offsetof(struct thread, ip),
+				 sizeof(struct instruction));
+
+	emit_epilog(st);
+
+	return 0;
+}
+
+static int
+emit(struct jit_state *st, struct swx_jit_func *funcs, uint32_t n_funcs)
+{
+	int32_t *off = st->off;
+	uint32_t i;
+	int rc;
+
+	st->sz = 0;
+
+	for (i = 0; i != n_funcs; i++) {
+		rc = emit_func(st, &funcs[i], off);
+		if (rc)
+			return rc;
+
+		off += funcs[i].n_instructions;
+	}
+
+	return 0;
+}
+
+int
+swx_jit_x86(struct swx_jit_func *funcs, uint32_t n_funcs, void **code, size_t *code_size)
+{
+	struct jit_state st;
+	uint32_t n_instructions = 0, i;
+	size_t sz;
+	int rc;
+
+	for (i = 0; i != n_funcs; i++) {
+		if (!funcs[i].n_instructions)
+			return -EINVAL;
+
+		n_instructions += funcs[i].n_instructions;
+	}
+
+	memset(&st, 0, sizeof(st));
+	st.off = calloc(n_instructions + 1, sizeof(st.off[0]));
+	if (st.off == NULL)
+		return -ENOMEM;
+
+	/* Dry run, used to calculate the code size and the jump destination offsets. All the
+	 * jumps are encoded with 32-bit displacement, so the code size does not depend on them.
+	 */
+	rc = emit(&st, funcs, n_funcs);
+	sz = st.sz;
+
+	if (rc == 0) {
+		/* allocate memory needed */
+		st.ins = mmap(NULL, sz, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (st.ins == MAP_FAILED) {
+			st.ins = NULL;
+			rc = -ENOMEM;
+		} else
+			/* generate code */
+			rc = emit(&st, funcs, n_funcs);
+	}
+
+	if (rc == 0 && st.sz != sz)
+		rc = -EINVAL;
+
+	if (rc == 0 && mprotect(st.ins, sz, PROT_READ | PROT_EXEC) != 0)
+		rc = -ENOMEM;
+
+	if (rc != 0) {
+		if (st.ins != NULL)
+			munmap(st.ins, sz);
+
+		for (i = 0; i != n_funcs; i++)
+			funcs[i].func = NULL;
+	} else {
+		*code = st.ins;
+		*code_size = sz;
+	}
+
+	free(st.off);
+	return rc;
+}
+
+void
+swx_jit_x86_free(void *code, size_t code_size)
+{
+	if (code != NULL)
+		munmap(code, code_size);
+}
@@ -0,0 +1,163 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <rte_errno.h>
+#include <rte_mbuf.h>
+#include <rte_malloc.h>
+#include <rte_pcapng.h>
+
+#include "rte_port_pcapng.h"
+
+/*
+ * Port PCAPNG Reader
+ */
+#ifdef RTE_PORT_STATS_COLLECT
+
+#define RTE_PORT_PCAPNG_READER_STATS_PKTS_IN_ADD(port, val) \
+	do { port->stats.n_pkts_in += val; } while (0)
+#define RTE_PORT_PCAPNG_READER_STATS_PKTS_DROP_ADD(port, val) \
+	do { port->stats.n_pkts_drop += val; } while (0)
+
+#else
+
+#define RTE_PORT_PCAPNG_READER_STATS_PKTS_IN_ADD(port, val)
+#define RTE_PORT_PCAPNG_READER_STATS_PKTS_DROP_ADD(port, val)
+
+#endif
+
+struct rte_port_pcapng_reader {
+	struct rte_port_in_stats stats;
+
+	rte_pcapng_reader_t *reader;
+	struct rte_mempool *mempool;
+	uint32_t n_loops;
+	uint32_t loop;
+};
+
+static void *
+rte_port_pcapng_reader_create(void *params, int socket_id)
+{
+	struct rte_port_pcapng_reader_params *conf =
+			params;
+	struct rte_port_pcapng_reader *port;
+	int fd;
+
+	/* Check input parameters */
+	if (conf == NULL) {
+		RTE_LOG(ERR, PORT, "%s: params is NULL\n", __func__);
+		return NULL;
+	}
+	if (conf->mempool == NULL) {
+		RTE_LOG(ERR, PORT, "%s: Invalid mempool\n", __func__);
+		return NULL;
+	}
+	if (conf->file_name == NULL) {
+		RTE_LOG(ERR, PORT, "%s: Invalid file name\n", __func__);
+		return NULL;
+	}
+	if (!(conf->speed >= 0)) {
+		RTE_LOG(ERR, PORT, "%s: Invalid speed\n", __func__);
+		return NULL;
+	}
+
+	/* Memory allocation */
+	port = rte_zmalloc_socket("PORT", sizeof(*port),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (port == NULL) {
+		RTE_LOG(ERR, PORT, "%s: Failed to allocate port\n", __func__);
+		return NULL;
+	}
+
+	/* Initialization */
+	fd = open(conf->file_name, O_RDONLY);
+	if (fd < 0) {
+		RTE_LOG(ERR, PORT, "%s: Cannot open %s: %s\n", __func__,
+			conf->file_name, strerror(errno));
+		rte_free(port);
+		return NULL;
+	}
+
+	/* The reader owns the file descriptor from now on */
+	port->reader = rte_pcapng_reader_fdopen(fd);
+	if (port->reader == NULL) {
+		RTE_LOG(ERR, PORT, "%s: Cannot read %s: %s\n", __func__,
+			conf->file_name, rte_strerror(rte_errno));
+		rte_free(port);
+		return NULL;
+	}
+
+	rte_pcapng_reader_set_speed(port->reader, conf->speed);
+	port->mempool = conf->mempool;
+	port->n_loops = conf->n_loops;
+
+	return port;
+}
+
+static int
+rte_port_pcapng_reader_rx(void *port, struct rte_mbuf **pkts, uint32_t n_pkts)
+{
+	struct rte_port_pcapng_reader *p = port;
+	uint32_t n_rx;
+
+	n_rx = rte_pcapng_read_packets(p->reader, p->mempool, pkts, n_pkts);
+
+	/* Restart from the beginning of the file for the next loop */
+	if (n_rx < n_pkts && rte_pcapng_reader_eof(p->reader) &&
+	    (p->n_loops == 0 || p->loop + 1 < p->n_loops)) {
+		p->loop++;
+		rte_pcapng_reader_rewind(p->reader);
+	}
+
+	RTE_PORT_PCAPNG_READER_STATS_PKTS_IN_ADD(p, n_rx);
+
+	return n_rx;
+}
+
+static int
+rte_port_pcapng_reader_free(void *port)
+{
+	struct rte_port_pcapng_reader *p =
+			port;
+
+	if (p == NULL) {
+		RTE_LOG(ERR, PORT, "%s: port is NULL\n", __func__);
+		return -EINVAL;
+	}
+
+	/* The file stays mapped until the packets read are freed */
+	rte_pcapng_reader_close(p->reader);
+	rte_free(p);
+
+	return 0;
+}
+
+static int rte_port_pcapng_reader_stats_read(void *port,
+		struct rte_port_in_stats *stats, int clear)
+{
+	struct rte_port_pcapng_reader *p =
+			port;
+
+	if (stats != NULL)
+		memcpy(stats, &p->stats, sizeof(p->stats));
+
+	if (clear)
+		memset(&p->stats, 0, sizeof(p->stats));
+
+	return 0;
+}
+
+/*
+ * Summary of port operations
+ */
+struct rte_port_in_ops rte_port_pcapng_reader_ops = {
+	.f_create = rte_port_pcapng_reader_create,
+	.f_free = rte_port_pcapng_reader_free,
+	.f_rx = rte_port_pcapng_reader_rx,
+	.f_stats = rte_port_pcapng_reader_stats_read,
+};
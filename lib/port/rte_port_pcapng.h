@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#ifndef __INCLUDE_RTE_PORT_PCAPNG_H__
+#define __INCLUDE_RTE_PORT_PCAPNG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE Port PCAPNG
+ *
+ * pcapng_reader: input port replaying the packets of a pcapng capture file,
+ * at their original pace or scaled by a speed-up factor
+ *
+ ***/
+
+#include <stdint.h>
+
+#include "rte_port.h"
+
+/** pcapng_reader port parameters */
+struct rte_port_pcapng_reader_params {
+	/** Buffer pool the packets are attached to. The packet data is not
+	 *  copied, so the pool buffers may have no data room.
+	 */
+	struct rte_mempool *mempool;
+
+	/** The full path of the pcapng file to replay */
+	const char *file_name;
+
+	/** Replay speed factor: 1 follows the original timestamps,
+	 *  2 replays twice as fast. If this value is 0, the packets are
+	 *  read as fast as possible.
+	 */
+	double speed;
+
+	/** The number of times the file is replayed. If this value is 0,
+	 *  the file is replayed in an infinite loop.
+	 */
+	uint32_t n_loops;
+};
+
+/** pcapng_reader port operations */
+extern struct rte_port_in_ops rte_port_pcapng_reader_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
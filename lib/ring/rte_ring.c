@@ -36,7 +36,8 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* mask of all valid flag values to ring_create() */
 #define RING_F_MASK (RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ | \
 		     RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ |	       \
-		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ)
+		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ |	       \
+		     RING_F_MT_TICKET)
 
 /* true if x is a power of 2 */
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
@@ -78,6 +79,45 @@ rte_ring_get_memsize(unsigned int count)
 	return rte_ring_get_memsize_elem(sizeof(void *), count);
 }
 
+/*
+ * return the size of memory occupied by a ring created with given flags,
+ * ticket sync mode keeps a sequence number for each slot after the elements.
+ */
+static ssize_t
+get_memsize(unsigned int esize, unsigned int count, unsigned int flags)
+{
+	ssize_t sz;
+
+	sz = rte_ring_get_memsize_elem(esize, count);
+	if (sz >= 0 && (flags & RING_F_MT_TICKET) != 0)
+		sz = RTE_ALIGN(sz + (ssize_t)count * sizeof(uint32_t),
+			RTE_CACHE_LINE_SIZE);
+	return sz;
+}
+
+/*
+ * internal helper function to reset ticket sync mode state:
+ * all slots are free, so each slot sequence equals its position
+ * in the first lap.
+ */
+static void
+reset_ticket(struct rte_ring *r)
+{
+	uint32_t i;
+	uint32_t *seq;
+
+	r->tkt_prod.head = 0;
+	r->tkt_prod.tail = 0;
+	r->tkt_prod.credits = r->capacity;
+	r->tkt_cons.head = 0;
+	r->tkt_cons.tail = 0;
+	r->tkt_cons.credits = 0;
+
+	seq = __rte_ring_ticket_seq(r, r->tkt_prod.esize);
+	for (i = 0; i != r->size; i++)
+		seq[i] = i;
+}
+
 /*
  * internal helper function to reset prod/cons head-tail values.
  */
@@ -105,6 +145,9 @@ reset_headtail(void *p)
 	case RTE_RING_SYNC_MT_HTS:
 		ht_hts->ht.raw = 0;
 		break;
+	case RTE_RING_SYNC_MT_TICKET:
+		/* handled by reset_ticket() */
+		break;
 	default:
 		/* unknown sync mode */
 		RTE_ASSERT(0);
@@ -114,6 +157,11 @@ reset_headtail(void *p)
 void
 rte_ring_reset(struct rte_ring *r)
 {
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_TICKET) {
+		reset_ticket(r);
+		return;
+	}
+
 	reset_headtail(&r->prod);
 	reset_headtail(&r->cons);
 }
@@ -132,6 +180,15 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	static const uint32_t cons_st_flags =
 		(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ);
 
+	/* ticket mode always covers both producer and consumer */
+	if (flags & RING_F_MT_TICKET) {
+		if (flags & (prod_st_flags | cons_st_flags))
+			return -EINVAL;
+		*prod_st = RTE_RING_SYNC_MT_TICKET;
+		*cons_st = RTE_RING_SYNC_MT_TICKET;
+		return 0;
+	}
+
 	switch (flags & prod_st_flags) {
 	case 0:
 		*prod_st = RTE_RING_SYNC_MT;
@@ -169,9 +226,9 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	return 0;
 }
 
-int
-rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
-	unsigned int flags)
+static int
+ring_init(struct rte_ring *r, const char *name, unsigned int count,
+	unsigned int esize, unsigned int flags)
 {
 	int ret;
 
@@ -193,6 +250,11 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
 		offsetof(struct rte_ring_rts_headtail, tail.val.pos));
 
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, sync_type) !=
+		offsetof(struct rte_ring_ticket_headtail, sync_type));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
+		offsetof(struct rte_ring_ticket_headtail, tail));
+
 	/* future proof flags, only allow supported values */
 	if (flags & ~RING_F_MASK) {
 		RTE_LOG(ERR, RING,
@@ -232,9 +294,29 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	if (flags & RING_F_MC_RTS_DEQ)
 		rte_ring_set_cons_htd_max(r, r->capacity / HTD_MAX_DEF);
 
+	if (flags & RING_F_MT_TICKET) {
+		r->tkt_prod.esize = esize;
+		r->tkt_cons.esize = esize;
+		reset_ticket(r);
+	}
+
 	return 0;
 }
 
+int
+rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
+	unsigned int flags)
+{
+	/* slot sequences can't be placed without knowing the element size */
+	if (flags & RING_F_MT_TICKET) {
+		RTE_LOG(ERR, RING,
+			"Ticket sync mode requires rte_ring_create_elem()\n");
+		return -EINVAL;
+	}
+
+	return ring_init(r, name, count, sizeof(void *), flags);
+}
+
 /* create the ring for a given element size */
 struct rte_ring *
 rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
@@ -248,6 +330,7 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 	int mz_flags = 0;
 	struct rte_ring_list* ring_list = NULL;
 	const unsigned int requested_count = count;
+	enum rte_ring_sync_type prod_st, cons_st;
 	int ret;
 
 	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
@@ -256,12 +339,20 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 	if (flags & RING_F_EXACT_SZ)
 		count = rte_align32pow2(count + 1);
 
-	ring_size = rte_ring_get_memsize_elem(esize, count);
+	ring_size = get_memsize(esize, count, flags);
 	if (ring_size < 0) {
 		rte_errno = -ring_size;
 		return NULL;
 	}
 
+	/* reject conflicting sync modes before reserving any memory */
+	ret = get_sync_type(flags, &prod_st, &cons_st);
+	if (ret != 0) {
+		RTE_LOG(ERR, RING, "Invalid sync mode flags %#x\n", flags);
+		rte_errno = -ret;
+		return NULL;
+	}
+
 	ret = snprintf(mz_name, sizeof(mz_name), "%s%s",
 		RTE_RING_MZ_PREFIX, name);
 	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
@@ -287,7 +378,7 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 		r = mz->addr;
 		/* no need to check return value here, we already checked the
 		 * arguments above */
-		rte_ring_init(r, name, requested_count, flags);
+		ring_init(r, name, requested_count, esize, flags);
 
 		te->data = (void *) r;
 		r->memzone = mz;
@@ -115,6 +115,9 @@ ssize_t rte_ring_get_memsize(unsigned int count);
  *     ring space will be wasted.
  *     Without this flag set, the ring size requested must be a power of 2,
  *     and the usable space will be that size - 1.
+ *   RING_F_MT_TICKET is not supported here, as the ring element size is
+ *   required to lay out the per-slot sequence numbers; use
+ *   rte_ring_create() or rte_ring_create_elem() for that mode.
  * @return
  *   0 on success, or a negative value on error.
  */
@@ -169,6 +172,11 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_MT_TICKET: If this flag is set, the default behavior when
+ *     using ``rte_ring_enqueue()``, ``rte_ring_enqueue_bulk()``,
+ *     ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()`` is
+ *     "multi-producer/multi-consumer ticket mode". It cannot be combined
+ *     with any of the producer or consumer flags above.
  *   - RING_F_EXACT_SZ: If this flag is set, the ring will hold exactly the
  *     requested number of entries, and the requested size will be rounded up
  *     to the next power of two, but the usable space will be exactly that
@@ -58,6 +58,7 @@ enum rte_ring_sync_type {
 	RTE_RING_SYNC_ST,     /**< single thread only */
 	RTE_RING_SYNC_MT_RTS, /**< multi-thread relaxed tail sync */
 	RTE_RING_SYNC_MT_HTS, /**< multi-thread head/tail sync */
+	RTE_RING_SYNC_MT_TICKET, /**< multi-thread per-slot ticket sync */
 };
 
 /**
@@ -107,6 +108,14 @@ struct rte_ring_hts_headtail {
 	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
 };
 
+struct rte_ring_ticket_headtail {
+	volatile uint32_t head;  /**< next position (ticket) to hand out */
+	volatile uint32_t tail;  /**< number of completed operations */
+	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
+	int32_t credits;  /**< number of slots that can still be claimed */
+	uint32_t esize;   /**< element size, locates the slot sequences */
+};
+
 /**
  * An RTE ring structure.
  *
@@ -135,6 +144,7 @@ struct rte_ring {
 		struct rte_ring_headtail prod;
 		struct rte_ring_hts_headtail hts_prod;
 		struct rte_ring_rts_headtail rts_prod;
+		struct rte_ring_ticket_headtail tkt_prod;
 	}  __rte_cache_aligned;
 
 	char pad1 __rte_cache_aligned; /**< empty cache line */
@@ -145,6 +155,7 @@ struct rte_ring {
 		struct rte_ring_headtail cons;
 		struct rte_ring_hts_headtail hts_cons;
 		struct rte_ring_rts_headtail rts_cons;
+		struct rte_ring_ticket_headtail tkt_cons;
 	}  __rte_cache_aligned;
 
 	char pad2 __rte_cache_aligned; /**< empty cache line */
@@ -169,6 +180,14 @@ struct rte_ring {
 #define RING_F_MP_HTS_ENQ 0x0020 /**< The default enqueue is "MP HTS". */
 #define RING_F_MC_HTS_DEQ 0x0040 /**< The default dequeue is "MC HTS". */
 
+/**
+ * The default enqueue is "MP ticket" and the default dequeue is "MC ticket".
+ * Ticket sync mode couples producer and consumer through per-slot sequence
+ * numbers, so it always applies to both sides of the ring and cannot be
+ * combined with any other sync mode flag.
+ */
+#define RING_F_MT_TICKET 0x0080
+
 #ifdef __cplusplus
 }
 #endif
@@ -92,6 +92,11 @@ ssize_t rte_ring_get_memsize_elem(unsigned int esize, unsigned int count);
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_MT_TICKET: If this flag is set, the default behavior when
+ *     using ``rte_ring_enqueue()``, ``rte_ring_enqueue_bulk()``,
+ *     ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()`` is
+ *     "multi-producer/multi-consumer ticket mode". It cannot be combined
+ *     with any of the producer or consumer flags above.
  * @return
  *   On success, the pointer to the new allocated ring. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
@@ -167,6 +172,7 @@ rte_ring_sp_enqueue_bulk_elem(struct rte_ring *r, const void *obj_table,
 
 #include <rte_ring_hts.h>
 #include <rte_ring_rts.h>
+#include <rte_ring_ticket.h>
 
 /**
  * Enqueue several objects on a ring.
@@ -208,6 +214,9 @@ rte_ring_enqueue_bulk_elem(struct rte_ring *r, const void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mp_hts_enqueue_bulk_elem(r, obj_table, esize, n,
 			free_space);
+	case RTE_RING_SYNC_MT_TICKET:
+		return __rte_ring_do_ticket_enqueue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_FIXED, free_space);
 	}
 
 	/* valid ring should never reach this point */
@@ -390,6 +399,9 @@ rte_ring_dequeue_bulk_elem(struct rte_ring *r, void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mc_hts_dequeue_bulk_elem(r, obj_table, esize,
 			n, available);
+	case RTE_RING_SYNC_MT_TICKET:
+		return __rte_ring_do_ticket_dequeue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_FIXED, available);
 	}
 
 	/* valid ring should never reach this point */
@@ -576,6 +588,9 @@ rte_ring_enqueue_burst_elem(struct rte_ring *r, const void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mp_hts_enqueue_burst_elem(r, obj_table, esize,
 			n, free_space);
+	case RTE_RING_SYNC_MT_TICKET:
+		return __rte_ring_do_ticket_enqueue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_VARIABLE, free_space);
 	}
 
 	/* valid ring should never reach this point */
@@ -686,6 +701,9 @@ rte_ring_dequeue_burst_elem(struct rte_ring *r, void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mc_hts_dequeue_burst_elem(r, obj_table, esize,
 			n, available);
+	case RTE_RING_SYNC_MT_TICKET:
+		return __rte_ring_do_ticket_dequeue_elem(r, obj_table, esize, n,
+			RTE_RING_QUEUE_VARIABLE, available);
 	}
 
 	/* valid ring should never reach this point */
@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2022 Intel Corporation
+ */
+
+#ifndef _RTE_RING_TICKET_ELEM_PVT_H_
+#define _RTE_RING_TICKET_ELEM_PVT_H_
+
+/**
+ * @file rte_ring_ticket_elem_pvt.h
+ * It is not recommended to include this file directly,
+ * include <rte_ring.h> instead.
+ * Contains internal helper functions for ticket sync (TICKET) ring mode.
+ * For more information please refer to <rte_ring_ticket.h>.
+ */
+
+/**
+ * @internal returns pointer to the array of per-slot sequence numbers,
+ * stored right after the ring elements.
+ */
+static __rte_always_inline uint32_t *
+__rte_ring_ticket_seq(struct rte_ring *r, uint32_t esize)
+{
+	return (uint32_t *)((uintptr_t)&r[1] + (uintptr_t)r->size * esize);
+}
+
+/**
+ * @internal claims up to *num* slots from the *credits* counter.
+ * Never retries: one fetch-sub takes the credits, any excess is returned
+ * with one fetch-add.
+ */
+static __rte_always_inline uint32_t
+__rte_ring_ticket_claim(int32_t *credits, uint32_t num,
+	enum rte_ring_queue_behavior behavior, uint32_t *entries)
+{
+	int32_t c;
+	uint32_t n;
+
+	/* don't touch the counter when it can't satisfy a bulk request */
+	c = __atomic_load_n(credits, __ATOMIC_RELAXED);
+	if (c <= 0 || (behavior == RTE_RING_QUEUE_FIXED &&
+			(uint32_t)c < num)) {
+		*entries = RTE_MAX(c, 0);
+		return 0;
+	}
+
+	c = __atomic_fetch_sub(credits, num, __ATOMIC_RELAXED);
+	*entries = RTE_MAX(c, 0);
+
+	if (c >= (int32_t)num)
+		n = num;
+	else if (c <= 0 || behavior == RTE_RING_QUEUE_FIXED)
+		n = 0;
+	else
+		n = c;
+
+	if (n != num)
+		__atomic_fetch_add(credits, num - n, __ATOMIC_RELAXED);
+	return n;
+}
+
+/**
+ * @internal waits till each of *num* slots starting at *pos* reaches
+ * the sequence number expected by the caller.
+ */
+static __rte_always_inline void
+__rte_ring_ticket_wait(const struct rte_ring *r, uint32_t *seq, uint32_t pos,
+	uint32_t ofs, uint32_t num)
+{
+	uint32_t i;
+
+	for (i = 0; i != num; i++)
+		rte_wait_until_equal_32(&seq[(pos + i) & r->mask],
+			pos + i + ofs, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @internal hands *num* slots starting at *pos* over to the other side.
+ */
+static __rte_always_inline void
+__rte_ring_ticket_publish(const struct rte_ring *r, uint32_t *seq,
+	uint32_t pos, uint32_t ofs, uint32_t num)
+{
+	uint32_t i;
+
+	/* make sure the slot contents are visible before the new sequence */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	for (i = 0; i != num; i++)
+		__atomic_store_n(&seq[(pos + i) & r->mask], pos + i + ofs,
+			__ATOMIC_RELAXED);
+}
+
+/**
+ * @internal Enqueue several objects on the ticket ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Enqueue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Enqueue as many items as possible from ring
+ * @param free_space
+ *   returns the amount of space after the enqueue operation has finished
+ * @return
+ *   Actual number of objects enqueued.
+ *   If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_ticket_enqueue_elem(struct rte_ring *r, const void *obj_table,
+	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *free_space)
+{
+	uint32_t free, head;
+	uint32_t *seq;
+
+	n = __rte_ring_ticket_claim(&r->tkt_prod.credits, n, behavior, &free);
+
+	if (n != 0) {
+		seq = __rte_ring_ticket_seq(r, esize);
+		head = __atomic_fetch_add(&r->tkt_prod.head, n,
+			__ATOMIC_RELAXED);
+
+		/* wait for consumers still reading our slots to finish */
+		__rte_ring_ticket_wait(r, seq, head, 0, n);
+		__rte_ring_enqueue_elems(r, head, obj_table, esize, n);
+		__rte_ring_ticket_publish(r, seq, head, 1, n);
+
+		__atomic_fetch_add(&r->tkt_prod.tail, n, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&r->tkt_cons.credits, n, __ATOMIC_RELAXED);
+	}
+
+	if (free_space != NULL)
+		*free_space = free - n;
+	return n;
+}
+
+/**
+ * @internal Dequeue several objects from the ticket ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to pull from the ring.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Dequeue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Dequeue as many items as possible from ring
+ * @param available
+ *   returns the number of remaining ring entries after the dequeue has finished
+ * @return
+ *   - Actual number of objects dequeued.
+ *     If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_ticket_dequeue_elem(struct rte_ring *r, void *obj_table,
+	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *available)
+{
+	uint32_t entries, head;
+	uint32_t *seq;
+
+	n = __rte_ring_ticket_claim(&r->tkt_cons.credits, n, behavior,
+		&entries);
+
+	if (n != 0) {
+		seq = __rte_ring_ticket_seq(r, esize);
+		head = __atomic_fetch_add(&r->tkt_cons.head, n,
+			__ATOMIC_RELAXED);
+
+		/* wait for producers still writing our slots to finish */
+		__rte_ring_ticket_wait(r, seq, head, 1, n);
+		__rte_ring_dequeue_elems(r, head, obj_table, esize, n);
+		__rte_ring_ticket_publish(r, seq, head, r->size, n);
+
+		__atomic_fetch_add(&r->tkt_cons.tail, n, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&r->tkt_prod.credits, n, __ATOMIC_RELAXED);
+	}
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+#endif /* _RTE_RING_TICKET_ELEM_PVT_H_ */
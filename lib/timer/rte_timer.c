@@ -19,9 +19,33 @@
 #include <rte_random.h>
 #include <rte_pause.h>
 #include <rte_memzone.h>
+#include <rte_malloc.h>
 
 #include "rte_timer.h"
 
+/*
+ * Hierarchical timer wheel, which may replace the skiplist of a timer data
+ * instance. Each level has 64 slots, so that a 64-bit word tracks the
+ * non-empty slots of a level. A slot of level n holds the timers expiring
+ * within a range of 64^n ticks, which are moved to the lower levels when
+ * this range is reached.
+ */
+#define TIMER_WHEEL_BITS	6
+#define TIMER_WHEEL_SLOTS	(1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS	6
+/* Timers expiring later are kept in the last level until they get closer */
+#define TIMER_WHEEL_MAX_DELTA \
+	((UINT64_C(1) << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1)
+
+struct timer_wheel {
+	uint64_t cur_tick;              /**< next tick to expire */
+	unsigned int tick_shift;        /**< log2 of the tick in timer cycles */
+	uint32_t nb_pending;            /**< number of timers in the wheel */
+	uint64_t occupied[TIMER_WHEEL_LEVELS]; /**< bitmaps of non-empty slots */
+	struct rte_timer *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} __rte_cache_aligned;
+
 /**
  * Per-lcore info for timers.
  */
@@ -41,6 +65,9 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timer wheel of this lcore, NULL if timers are in the skiplist */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -109,12 +136,59 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 	return -ENOSPC;
 }
 
+int
+rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t tick_cycles)
+{
+	struct rte_timer_data *data;
+	struct timer_wheel *wheels;
+	unsigned int lcore_id, tick_shift;
+	uint64_t cur_time;
+	uint32_t id;
+	int ret;
+
+	if (tick_cycles == 0)
+		return -EINVAL;
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret < 0)
+		return ret;
+
+	wheels = rte_zmalloc("timer_wheel", sizeof(*wheels) * RTE_MAX_LCORE,
+			RTE_CACHE_LINE_SIZE);
+	if (wheels == NULL) {
+		rte_timer_data_dealloc(id);
+		return -ENOMEM;
+	}
+
+	data = &rte_timer_data_arr[id];
+	tick_shift = rte_fls_u64(tick_cycles) - 1;
+	cur_time = rte_get_timer_cycles();
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheels[lcore_id].tick_shift = tick_shift;
+		wheels[lcore_id].cur_tick = cur_time >> tick_shift;
+		data->priv_timer[lcore_id].wheel = &wheels[lcore_id];
+	}
+
+	if (id_ptr)
+		*id_ptr = id;
+
+	return 0;
+}
+
 int
 rte_timer_data_dealloc(uint32_t id)
 {
 	struct rte_timer_data *timer_data;
+	unsigned int lcore_id;
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	/* the wheels of all lcores are allocated at once */
+	if (timer_data->priv_timer[0].wheel != NULL) {
+		rte_free(timer_data->priv_timer[0].wheel);
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			timer_data->priv_timer[lcore_id].wheel = NULL;
+	}
+
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -171,6 +245,7 @@ rte_timer_subsystem_init(void)
 					&data->priv_timer[lcore_id].list_lock);
 				data->priv_timer[lcore_id].prev_lcore =
 					lcore_id;
+				data->priv_timer[lcore_id].wheel = NULL;
 			}
 		}
 	}
@@ -383,6 +458,174 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+/*
+ * In a timer wheel, sl_next[0] links a timer to the next one of its slot
+ * and sl_next[1] holds the address of the pointer to the timer, or NULL
+ * once the timer was taken out of the wheel to expire.
+ */
+static inline struct rte_timer **
+timer_wheel_pprev(const struct rte_timer *tim)
+{
+	return (struct rte_timer **)(void *)tim->sl_next[1];
+}
+
+static inline void
+timer_wheel_set_pprev(struct rte_timer *tim, struct rte_timer **pprev)
+{
+	tim->sl_next[1] = (struct rte_timer *)(void *)pprev;
+}
+
+/* add a timer in the slot of its expiry tick, in O(1) */
+static void
+timer_wheel_add(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	uint64_t tick_mask = (UINT64_C(1) << wheel->tick_shift) - 1;
+	uint64_t expire_tick, delta;
+	unsigned int level, slot;
+	struct rte_timer **head;
+
+	/* round up, a timer must not expire early */
+	expire_tick = (tim->expire >> wheel->tick_shift) +
+		((tim->expire & tick_mask) != 0);
+	if (expire_tick < wheel->cur_tick)
+		expire_tick = wheel->cur_tick;
+
+	delta = expire_tick - wheel->cur_tick;
+	if (delta > TIMER_WHEEL_MAX_DELTA) {
+		delta = TIMER_WHEEL_MAX_DELTA;
+		expire_tick = wheel->cur_tick + delta;
+	}
+
+	level = delta < TIMER_WHEEL_SLOTS ? 0 :
+		(rte_fls_u64(delta) - 1) / TIMER_WHEEL_BITS;
+	slot = (expire_tick >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+	head = &wheel->slots[level][slot];
+
+	tim->sl_next[0] = *head;
+	if (*head != NULL)
+		timer_wheel_set_pprev(*head, &tim->sl_next[0]);
+	timer_wheel_set_pprev(tim, head);
+	*head = tim;
+	wheel->occupied[level] |= UINT64_C(1) << slot;
+	wheel->nb_pending++;
+}
+
+/* remove a timer from the wheel, in O(1) */
+static void
+timer_wheel_del(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = timer_wheel_pprev(tim);
+	struct rte_timer *next = tim->sl_next[0];
+	uintptr_t idx;
+
+	/* the timer already expired, it is on a run list */
+	if (pprev == NULL)
+		return;
+
+	*pprev = next;
+	if (next != NULL)
+		timer_wheel_set_pprev(next, pprev);
+	timer_wheel_set_pprev(tim, NULL);
+	wheel->nb_pending--;
+
+	/* the timer was the last one of its slot */
+	idx = ((uintptr_t)pprev - (uintptr_t)&wheel->slots[0][0]) /
+		sizeof(*pprev);
+	if (next == NULL && idx < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+		wheel->occupied[idx / TIMER_WHEEL_SLOTS] &=
+			~(UINT64_C(1) << (idx % TIMER_WHEEL_SLOTS));
+}
+
+/* take all the timers of a slot */
+static inline struct rte_timer *
+timer_wheel_take_slot(struct timer_wheel *wheel, unsigned int level,
+		      unsigned int slot)
+{
+	struct rte_timer *tim = wheel->slots[level][slot];
+
+	wheel->slots[level][slot] = NULL;
+	wheel->occupied[level] &= ~(UINT64_C(1) << slot);
+	return tim;
+}
+
+/*
+ * The current tick starts a new range of the upper levels: move the timers
+ * of the slots of this range to the lower levels.
+ */
+static void
+timer_wheel_cascade(struct timer_wheel *wheel)
+{
+	struct rte_timer *tim, *next_tim;
+	unsigned int level, slot;
+
+	for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+		slot = (wheel->cur_tick >> (level * TIMER_WHEEL_BITS)) &
+			TIMER_WHEEL_MASK;
+		for (tim = timer_wheel_take_slot(wheel, level, slot);
+		     tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			wheel->nb_pending--;
+			timer_wheel_add(wheel, tim);
+		}
+		if (slot != 0)
+			break;
+	}
+}
+
+/*
+ * Take out of the wheel the timers which expired at now_tick and return
+ * them linked by sl_next[0]. Empty slots are skipped with the bitmaps and
+ * whole ranges are skipped when the lower levels are empty.
+ */
+static struct rte_timer *
+timer_wheel_expire(struct timer_wheel *wheel, uint64_t now_tick)
+{
+	struct rte_timer *run_first_tim = NULL, **run_last = &run_first_tim;
+	struct rte_timer *tim;
+	unsigned int level, slot, shift;
+	uint64_t bits, tick;
+
+	while (wheel->cur_tick <= now_tick) {
+		if ((wheel->cur_tick & TIMER_WHEEL_MASK) == 0)
+			timer_wheel_cascade(wheel);
+
+		slot = wheel->cur_tick & TIMER_WHEEL_MASK;
+		bits = wheel->occupied[0] >> slot;
+		if (bits == 0) {
+			/* nothing before the next range of a non-empty level */
+			for (level = 0; level < TIMER_WHEEL_LEVELS; level++)
+				if (wheel->occupied[level] != 0)
+					break;
+			if (level == TIMER_WHEEL_LEVELS) {
+				wheel->cur_tick = now_tick + 1;
+				break;
+			}
+			shift = RTE_MAX(level, 1u) * TIMER_WHEEL_BITS;
+			tick = ((wheel->cur_tick >> shift) + 1) << shift;
+			wheel->cur_tick = RTE_MIN(tick, now_tick + 1);
+			continue;
+		}
+
+		slot += rte_bsf64(bits);
+		tick = (wheel->cur_tick & ~(uint64_t)TIMER_WHEEL_MASK) + slot;
+		if (tick > now_tick) {
+			wheel->cur_tick = now_tick + 1;
+			break;
+		}
+
+		tim = timer_wheel_take_slot(wheel, 0, slot);
+		*run_last = tim;
+		for ( ; tim != NULL; tim = tim->sl_next[0]) {
+			timer_wheel_set_pprev(tim, NULL);
+			wheel->nb_pending--;
+			run_last = &tim->sl_next[0];
+		}
+		wheel->cur_tick = tick + 1;
+	}
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -395,6 +638,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		timer_wheel_add(priv_timer[tim_lcore].wheel, tim);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -420,26 +668,14 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 			pending_head.sl_next[0]->expire;
 }
 
-/*
- * del from list, lock if needed
- * timer must be in config state
- * timer must be in a list
- */
+/* del from the skiplist of prev_owner, with the lock held */
 static void
-timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
-	  int local_is_locked, struct priv_timer *priv_timer)
+timer_skiplist_del(struct rte_timer *tim, unsigned int prev_owner,
+		   struct priv_timer *priv_timer)
 {
-	unsigned lcore_id = rte_lcore_id();
-	unsigned prev_owner = prev_status.owner;
 	int i;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
-	/* if timer needs is pending another core, we need to lock the
-	 * list; if it is on local core, we need to lock if we are not
-	 * called from rte_timer_manage() */
-	if (prev_owner != lcore_id || !local_is_locked)
-		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
-
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -459,6 +695,30 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 			priv_timer[prev_owner].curr_skiplist_depth --;
 		else
 			break;
+}
+
+/*
+ * del from list, lock if needed
+ * timer must be in config state
+ * timer must be in a list
+ */
+static void
+timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
+	  int local_is_locked, struct priv_timer *priv_timer)
+{
+	unsigned lcore_id = rte_lcore_id();
+	unsigned prev_owner = prev_status.owner;
+
+	/* if timer needs is pending another core, we need to lock the
+	 * list; if it is on local core, we need to lock if we are not
+	 * called from rte_timer_manage() */
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	if (priv_timer[prev_owner].wheel != NULL)
+		timer_wheel_del(priv_timer[prev_owner].wheel, tim);
+	else
+		timer_skiplist_del(tim, prev_owner, priv_timer);
 
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
@@ -651,66 +911,97 @@ rte_timer_pending(struct rte_timer *tim)
 				__ATOMIC_RELAXED) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/* detach the timers of the skiplist which expired, with the lock held */
+static struct rte_timer *
+timer_skiplist_expire(unsigned int lcore_id, uint64_t cur_time,
+		      struct priv_timer *priv_timer)
 {
-	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim;
-	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *privp = &priv_timer[lcore_id];
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
-
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
-
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
-	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
-	cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-	/* on 64-bit the value cached in the pending_head.expired will be
-	 * updated atomically, so we can consult that for a quick check here
-	 * outside the lock */
-	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
-#endif
+	struct rte_timer *tim;
+	int i;
 
-	/* browse ordered list, add expired timers in 'expired' list */
-	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
-
-	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
-		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
-	}
+	/* if nothing to do just return */
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time)
+		return NULL;
 
 	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
+	tim = privp->pending_head.sl_next[0];
 
 	/* break the existing list at current time point */
 	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
+	for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+		if (prev[i] == &privp->pending_head)
 			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
+		privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
 		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
+			privp->curr_skiplist_depth--;
+		prev[i]->sl_next[i] = NULL;
+	}
+
+	/* update the next to expire timer value */
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
+
+	return tim;
+}
+
+/*
+ * Take the expired timers of an lcore, from its skiplist or its timer
+ * wheel, and return the ones moved to the running state linked by
+ * sl_next[0].
+ */
+static struct rte_timer *
+timer_get_run_list(unsigned int lcore_id, struct priv_timer *priv_timer)
+{
+	struct priv_timer *privp = &priv_timer[lcore_id];
+	struct timer_wheel *wheel = privp->wheel;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim, **pprev;
+	uint64_t cur_time;
+	int ret;
+
+	if (wheel != NULL) {
+		/* optimize for the case where the wheel is empty */
+		if (wheel->nb_pending == 0)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
+#ifdef RTE_ARCH_64
+		/* the current tick is updated atomically on 64-bit */
+		if (likely((cur_time >> wheel->tick_shift) < wheel->cur_tick))
+			return NULL;
+#endif
+	} else {
+		/* optimize for the case where per-cpu list is empty */
+		if (privp->pending_head.sl_next[0] == NULL)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
+#ifdef RTE_ARCH_64
+		/* on 64-bit the value cached in the pending_head.expired will
+		 * be updated atomically, so we can consult that for a quick
+		 * check here outside the lock
+		 */
+		if (likely(privp->pending_head.expire > cur_time))
+			return NULL;
+#endif
 	}
 
+	/* browse ordered list, add expired timers in 'expired' list */
+	rte_spinlock_lock(&privp->list_lock);
+
+	if (wheel != NULL)
+		run_first_tim = timer_wheel_expire(wheel,
+				cur_time >> wheel->tick_shift);
+	else
+		run_first_tim = timer_skiplist_expire(lcore_id, cur_time,
+				priv_timer);
+
 	/* transition run-list from PENDING to RUNNING */
-	run_first_tim = tim;
 	pprev = &run_first_tim;
 
-	for ( ; tim != NULL; tim = next_tim) {
+	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
 		next_tim = tim->sl_next[0];
 
 		ret = timer_set_running_state(tim);
@@ -724,12 +1015,26 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 		}
 	}
 
-	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
+	rte_spinlock_unlock(&privp->list_lock);
 
-	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+	run_first_tim = timer_get_run_list(lcore_id, priv_timer);
 
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
@@ -798,16 +1103,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
 	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
-	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
 
@@ -822,75 +1123,9 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	}
 
 	for (i = 0; i < nb_poll_lcores; i++) {
-		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
-
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		tim = timer_get_run_list(poll_lcores[i], data->priv_timer);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -970,6 +1205,31 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* stop all the timers of a wheel, with its lock held */
+static void
+timer_wheel_stop_all(struct timer_wheel *wheel, rte_timer_stop_all_cb_t f,
+		     void *f_arg, struct rte_timer_data *timer_data)
+{
+	struct rte_timer *tim, *next_tim;
+	unsigned int level, slot;
+
+	for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+		for (slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+			for (tim = wheel->slots[level][slot];
+			     tim != NULL;
+			     tim = next_tim) {
+				next_tim = tim->sl_next[0];
+
+				/* Call timer_stop with lock held */
+				__rte_timer_stop(tim, 1, timer_data);
+
+				if (f)
+					f(tim, f_arg);
+			}
+		}
+	}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -990,6 +1250,13 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 
 		rte_spinlock_lock(&priv_timer->list_lock);
 
+		if (priv_timer->wheel != NULL) {
+			timer_wheel_stop_all(priv_timer->wheel, f, f_arg,
+					     timer_data);
+			rte_spinlock_unlock(&priv_timer->list_lock);
+			continue;
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
@@ -146,6 +146,34 @@ struct rte_timer
  */
 int rte_timer_data_alloc(uint32_t *id_ptr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance tracking its pending timers in a
+ * hierarchical timer wheel instead of a skiplist.
+ *
+ * Starting and stopping a timer is done in constant time, and expired timers
+ * are collected in batches, at the cost of the resolution: a timer expires in
+ * the first tick following its expiry time, and timers expiring in the same
+ * tick are run in no particular order. It is intended for large numbers of
+ * timers, managed with the rte_timer_alt_*() functions.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param tick_cycles
+ *   Resolution of the timers in timer cycles, rounded down to a power of 2.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: tick_cycles is zero
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ *   - -ENOMEM: timer wheel allocation failed
+ */
+__rte_experimental
+int rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t tick_cycles);
+
 /**
  * Deallocate a timer data instance.
  *